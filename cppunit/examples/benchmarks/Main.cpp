@@ -0,0 +1,143 @@
+#include <cppunit/extensions/Benchmark.h>
+#include <cppunit/extensions/BenchmarkResultFile.h>
+#include <cppunit/portability/Stream.h>
+#include <stdexcept>
+#include <stdio.h>
+#include "OverheadBenchmarks.h"
+
+
+/* Notes:
+
+  Measures the overhead of CppUnit itself. The report lists the benchmarks
+  always in the same order and format, so that the reports of two revisions
+  can be diffed. To compare two revisions statistically, save the results
+  of each one and compare the files with BenchmarkCompare:
+
+    overhead before.json
+    (change and rebuild)
+    overhead after.json
+    BenchmarkCompare before.json after.json
+ */
+
+
+/// A benchmark of the suite, with the sizes it is run with.
+struct OverheadBenchmark
+{
+  const char *m_name;
+  void (OverheadBenchmarks::*m_method)( CPPUNIT_NS::BenchmarkState &state );
+  long m_firstSize;
+  long m_lastSize;
+  int m_rangeMultiplier;
+};
+
+
+static const OverheadBenchmark overheadBenchmarks[] =
+{
+  { "TestCase::run (empty)", &OverheadBenchmarks::benchmarkRunEmptyTest, 0, 0, 8 },
+  { "CPPUNIT_ASSERT", &OverheadBenchmarks::benchmarkAssert, 0, 0, 8 },
+  { "CPPUNIT_ASSERT_EQUAL (int)", &OverheadBenchmarks::benchmarkAssertEqualInt, 0, 0, 8 },
+  { "CPPUNIT_ASSERT_EQUAL (string)", &OverheadBenchmarks::benchmarkAssertEqualString, 0, 0, 8 },
+  { "ProtectorChain::protect", &OverheadBenchmarks::benchmarkProtectorChain, 1, 8, 2 },
+  { "TestResult listener dispatch", &OverheadBenchmarks::benchmarkListenerDispatch, 1, 16, 2 },
+  { "TestFactoryRegistry::makeTest", &OverheadBenchmarks::benchmarkRegistry, 100, 10000, 10 },
+  { "TestPath resolution", &OverheadBenchmarks::benchmarkTestPath, 8, 512, 4 },
+  { "XmlOutputter::write", &OverheadBenchmarks::benchmarkXmlOutputter, 1000, 100000, 10 },
+};
+
+
+void
+printUsage( const std::string &applicationName )
+{
+  CPPUNIT_NS::stdCOut() << "Usage:\n"
+             << applicationName << " [results-filename]\n\n"
+"Runs the benchmarks of the overhead of CppUnit and prints a report.\n"
+"If a filename is given, the results are also saved in this file, to be\n"
+"compared with the results of another revision by BenchmarkCompare.\n\n";
+}
+
+
+/*! Main
+ *
+ * Usage:
+ *
+ * overhead [results-filename]
+ *
+ * Writes one line for each benchmarked size, with the median and minimum time
+ * of an iteration in nanoseconds, then the complexity fitted on the sizes.
+ */
+int
+main( int argc,
+      const char *argv[] )
+{
+  std::string applicationName( argv[0] );
+  if ( argc > 2  ||  (argc == 2  &&  argv[1][0] == '-') )
+  {
+    printUsage( applicationName );
+    return 2;
+  }
+
+  CPPUNIT_NS::BenchmarkResultFile results;
+  results.setRevision( CPPUNIT_NS::BenchmarkResultFile::detectRevision() );
+
+  CPPUNIT_NS::OStream &stream = CPPUNIT_NS::stdCOut();
+  stream << "CppUnit framework overhead";
+  if ( !results.revision().empty() )
+    stream << " (" << results.revision() << ")";
+  stream << "\n\n";
+
+  char line[ 160 ];
+  sprintf( line, "%-30s %8s %14s %14s\n",
+           "Benchmark", "Size", "Median (ns)", "Minimum (ns)" );
+  stream << line;
+
+  OverheadBenchmarks benchmarks;
+  CPPUNIT_NS::BenchmarkEnvironment environment;
+  int benchmarkCount = sizeof(overheadBenchmarks) / sizeof(overheadBenchmarks[0]);
+  for ( int index =0; index < benchmarkCount; ++index )
+  {
+    const OverheadBenchmark &benchmark = overheadBenchmarks[ index ];
+    CPPUNIT_NS::BenchmarkRunner runner( benchmark.m_firstSize,
+                                        benchmark.m_lastSize );
+    runner.setRangeMultiplier( benchmark.m_rangeMultiplier );
+    CPPUNIT_NS::BenchmarkMethod<OverheadBenchmarks> method( &benchmarks,
+                                                            benchmark.m_method );
+    CPPUNIT_NS::BenchmarkResult result = runner.run( method );
+    results.addResult( benchmark.m_name, result );
+    environment = result.environment();
+
+    for ( int sizeIndex =0; sizeIndex < result.sizeCount(); ++sizeIndex )
+    {
+      sprintf( line, "%-30s %8ld %14.1f %14.1f\n",
+               sizeIndex == 0 ? benchmark.m_name : "",
+               result.sizeAt( sizeIndex ),
+               result.medianAt( sizeIndex ) * 1e9,
+               result.minimumAt( sizeIndex ) * 1e9 );
+      stream << line;
+    }
+    if ( result.hasComplexity() )
+      stream << "    " << result.complexitySummary() << "\n";
+  }
+
+  for ( int warningIndex =0;
+        warningIndex < environment.warningCount();
+        ++warningIndex )
+  {
+    stream << "\nWarning: " << environment.warningAt( warningIndex );
+  }
+  stream << "\n";
+
+  if ( argc == 2 )
+  {
+    try
+    {
+      results.save( argv[1] );
+    }
+    catch ( std::runtime_error &e )
+    {
+      stream << e.what() << "\n";
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,224 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/extensions/TestSuiteFactory.h>
+#include <cppunit/portability/Stream.h>
+#include <cppunit/Protector.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestFailure.h>
+#include <cppunit/TestListener.h>
+#include <cppunit/TestPath.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/XmlOutputter.h>
+#include "OverheadBenchmarks.h"
+
+
+/// Value read by the assertions, volatile so that they are not folded.
+static volatile int expectedValue = 42;
+
+/// Largest number of listeners of benchmarkListenerDispatch().
+static const int maximumListenerCount = 16;
+
+
+/// Fixture with empty tests, run and registered by the benchmarks.
+class EmptyFixture : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( EmptyFixture );
+  CPPUNIT_TEST( testFirst );
+  CPPUNIT_TEST( testSecond );
+  CPPUNIT_TEST( testThird );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testFirst() {}
+  void testSecond() {}
+  void testThird() {}
+};
+
+
+/// Test case with an empty body, named by the benchmarks.
+class EmptyTest : public CPPUNIT_NS::TestCase
+{
+public:
+  EmptyTest( const std::string &name )
+      : CPPUNIT_NS::TestCase( name )
+  {
+  }
+
+  void runTest()
+  {
+  }
+};
+
+
+/// Functor protected by benchmarkProtectorChain().
+class EmptyFunctor : public CPPUNIT_NS::Functor
+{
+public:
+  bool operator()() const
+  {
+    return true;
+  }
+};
+
+
+/// Protector that only calls the protected functor.
+class PassThroughProtector : public CPPUNIT_NS::Protector
+{
+public:
+  bool protect( const CPPUNIT_NS::Functor &functor,
+                const CPPUNIT_NS::ProtectorContext & )
+  {
+    return functor();
+  }
+};
+
+
+/// Returns \a prefix followed by \a index.
+static std::string
+indexedName( const std::string &prefix,
+             long index )
+{
+  CPPUNIT_NS::OStringStream name;
+  name << prefix << index;
+  return name.str();
+}
+
+
+void
+OverheadBenchmarks::benchmarkRunEmptyTest( CPPUNIT_NS::BenchmarkState &state )
+{
+  CPPUNIT_NS::TestCaller<EmptyFixture> test( "testFirst",
+                                             &EmptyFixture::testFirst );
+  CPPUNIT_NS::TestResult result;
+  while ( state.keepRunning() )
+    test.run( &result );
+}
+
+
+void
+OverheadBenchmarks::benchmarkAssert( CPPUNIT_NS::BenchmarkState &state )
+{
+  while ( state.keepRunning() )
+    CPPUNIT_ASSERT( expectedValue == 42 );
+}
+
+
+void
+OverheadBenchmarks::benchmarkAssertEqualInt( CPPUNIT_NS::BenchmarkState &state )
+{
+  while ( state.keepRunning() )
+    CPPUNIT_ASSERT_EQUAL( 42, int(expectedValue) );
+}
+
+
+void
+OverheadBenchmarks::benchmarkAssertEqualString( CPPUNIT_NS::BenchmarkState &state )
+{
+  std::string expected( "expected value" );
+  std::string actual( expected );
+  while ( state.keepRunning() )
+    CPPUNIT_ASSERT_EQUAL( expected, actual );
+}
+
+
+void
+OverheadBenchmarks::benchmarkProtectorChain( CPPUNIT_NS::BenchmarkState &state )
+{
+  // TestResult already contains the default protector.
+  CPPUNIT_NS::TestResult result;
+  for ( long count =1; count < state.size(); ++count )
+    result.pushProtector( new PassThroughProtector() );
+
+  EmptyTest test( "protected" );
+  EmptyFunctor functor;
+  while ( state.keepRunning() )
+    result.protect( functor, &test );
+}
+
+
+void
+OverheadBenchmarks::benchmarkListenerDispatch( CPPUNIT_NS::BenchmarkState &state )
+{
+  CPPUNIT_NS::TestListener listeners[ maximumListenerCount ];
+  CPPUNIT_NS::TestResult result;
+  for ( long index =0; index < state.size()  &&  index < maximumListenerCount; ++index )
+    result.addListener( &listeners[ index ] );
+
+  EmptyTest test( "dispatched" );
+  while ( state.keepRunning() )
+  {
+    result.startTest( &test );
+    result.endTest( &test );
+  }
+}
+
+
+void
+OverheadBenchmarks::benchmarkRegistry( CPPUNIT_NS::BenchmarkState &state )
+{
+  CppUnitVector<CPPUNIT_NS::TestFactory *> factories;
+  for ( long index =0; index < state.size(); ++index )
+    factories.push_back( new CPPUNIT_NS::TestSuiteFactory<EmptyFixture>() );
+
+  state.setItemsProcessed( state.size() );
+  while ( state.keepRunning() )
+  {
+    CPPUNIT_NS::TestFactoryRegistry registry( "Benchmark" );
+    for ( long index =0; index < state.size(); ++index )
+      registry.registerFactory( factories[ index ] );
+    delete registry.makeTest();
+  }
+
+  for ( long index =0; index < state.size(); ++index )
+    delete factories[ index ];
+}
+
+
+void
+OverheadBenchmarks::benchmarkTestPath( CPPUNIT_NS::BenchmarkState &state )
+{
+  CPPUNIT_NS::TestSuite root( "All" );
+  for ( long index =0; index < state.size(); ++index )
+  {
+    CPPUNIT_NS::TestSuite *suite = new CPPUNIT_NS::TestSuite(
+        indexedName( "Suite", index ) );
+    for ( int testIndex =0; testIndex < 4; ++testIndex )
+      suite->addTest( new EmptyTest( indexedName( "test", testIndex ) ) );
+    root.addTest( suite );
+  }
+
+  // The last test of the last suite: all the suites are searched.
+  std::string path = "/All/" + indexedName( "Suite", state.size() -1 ) + "/test3";
+  while ( state.keepRunning() )
+    CPPUNIT_NS::TestPath resolved( &root, path );
+}
+
+
+void
+OverheadBenchmarks::benchmarkXmlOutputter( CPPUNIT_NS::BenchmarkState &state )
+{
+  CPPUNIT_NS::TestSuite suite( "All" );
+  CPPUNIT_NS::TestResultCollector collector;
+  for ( long index =0; index < state.size(); ++index )
+  {
+    EmptyTest *test = new EmptyTest( indexedName( "Fixture::test", index ) );
+    suite.addTest( test );
+    collector.startTest( test );
+    if ( index % 100 == 99 )
+    {
+      CPPUNIT_NS::Exception *failure = new CPPUNIT_NS::Exception(
+          CPPUNIT_NS::Message( "assertion failed", "Expression: false" ),
+          CPPUNIT_NS::SourceLine( "OverheadBenchmarks.cpp", 42 ) );
+      collector.addFailure( CPPUNIT_NS::TestFailure( test, failure, false ) );
+    }
+  }
+
+  state.setItemsProcessed( state.size() );
+  while ( state.keepRunning() )
+  {
+    CPPUNIT_NS::OStringStream stream;
+    CPPUNIT_NS::XmlOutputter outputter( &collector, stream );
+    outputter.write();
+  }
+}
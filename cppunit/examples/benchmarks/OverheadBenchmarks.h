@@ -0,0 +1,46 @@
+#ifndef OVERHEADBENCHMARKS_H
+#define OVERHEADBENCHMARKS_H
+
+#include <cppunit/extensions/Benchmark.h>
+
+
+/*! \brief Benchmarks of the overhead of CppUnit itself.
+ *
+ * Each benchmark measures the cost of one framework operation, with test
+ * bodies, listeners and protectors that do nothing, so that a change of the
+ * framework that slows down every test run shows up.
+ */
+class OverheadBenchmarks
+{
+public:
+  /// TestCase::run() of a test with an empty body and no listener.
+  void benchmarkRunEmptyTest( CPPUNIT_NS::BenchmarkState &state );
+
+  /// A passing CPPUNIT_ASSERT().
+  void benchmarkAssert( CPPUNIT_NS::BenchmarkState &state );
+
+  /// A passing CPPUNIT_ASSERT_EQUAL() on int.
+  void benchmarkAssertEqualInt( CPPUNIT_NS::BenchmarkState &state );
+
+  /// A passing CPPUNIT_ASSERT_EQUAL() on std::string.
+  void benchmarkAssertEqualString( CPPUNIT_NS::BenchmarkState &state );
+
+  /// TestResult::protect() through a chain of size() protectors.
+  void benchmarkProtectorChain( CPPUNIT_NS::BenchmarkState &state );
+
+  /// startTest() and endTest() dispatched to size() listeners.
+  void benchmarkListenerDispatch( CPPUNIT_NS::BenchmarkState &state );
+
+  /// Registration and makeTest() of a registry of size() fixtures.
+  void benchmarkRegistry( CPPUNIT_NS::BenchmarkState &state );
+
+  /// Resolution of a TestPath in a suite of size() fixtures.
+  void benchmarkTestPath( CPPUNIT_NS::BenchmarkState &state );
+
+  /// XmlOutputter::write() of size() test results, 1% of them failed.
+  void benchmarkXmlOutputter( CPPUNIT_NS::BenchmarkState &state );
+};
+
+
+
+#endif  // OVERHEADBENCHMARKS_H
@@ -0,0 +1,161 @@
+#include "ToolsSuite.h"
+#include "AllocationCounterTest.h"
+#include <cppunit/tools/ThreadGroup.h>
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( AllocationCounterTest, 
+                                       toolsSuiteName() );
+
+
+/// Allocates from the worker threads.
+class AllocationCounterTestTask : public CPPUNIT_NS::ThreadTask
+{
+public:
+  void run( int threadIndex )
+  {
+    // The first index runs in the calling thread.
+    if ( threadIndex == 0 )
+      return;
+    for ( int count =0; count < 100; ++count )
+    {
+      int * volatile allocated = new int( count );
+      delete allocated;
+    }
+  }
+};
+
+
+/// Counts the allocations of each worker thread with its own counter.
+class AllocationCounterTestCountingTask : public CPPUNIT_NS::ThreadTask
+{
+public:
+  AllocationCounterTestCountingTask( int threadCount )
+      : m_counts( threadCount, -1 )
+  {
+  }
+
+  void run( int threadIndex )
+  {
+    CPPUNIT_NS::AllocationCounter counter;
+    for ( int count =0; count < 100; ++count )
+    {
+      // Keeps the compiler from removing the allocation.
+      int * volatile allocated = new int( count );
+      delete allocated;
+    }
+    m_counts[ threadIndex ] = counter.allocationCount();
+  }
+
+  CppUnitVector<int> m_counts;
+};
+
+
+AllocationCounterTest::AllocationCounterTest()
+{
+}
+
+
+AllocationCounterTest::~AllocationCounterTest()
+{
+}
+
+
+void 
+AllocationCounterTest::setUp()
+{
+  m_allocated.reserve( 10 );
+}
+
+
+void 
+AllocationCounterTest::tearDown()
+{
+  for ( unsigned int index =0; index < m_allocated.size(); ++index )
+    delete m_allocated[ index ];
+  m_allocated.clear();
+}
+
+
+void 
+AllocationCounterTest::testIsInstalled()
+{
+  // CppUnitTestMain.cpp uses CPPUNIT_INSTALL_ALLOCATION_COUNTER.
+  CPPUNIT_ASSERT( CPPUNIT_NS::AllocationCounter::isInstalled() );
+}
+
+
+void 
+AllocationCounterTest::testCountsAllocations()
+{
+  // The counts are read before asserting: assertions allocate memory.
+  CPPUNIT_NS::AllocationCounter counter;
+  int initialCount = counter.allocationCount();
+  m_allocated.push_back( new int( 1 ) );
+  m_allocated.push_back( new int( 2 ) );
+  int finalCount = counter.allocationCount();
+
+  CPPUNIT_ASSERT_EQUAL( 0, initialCount );
+  CPPUNIT_ASSERT_EQUAL( 2, finalCount );
+}
+
+
+void 
+AllocationCounterTest::testStopsWhenDestroyed()
+{
+  int firstCount;
+  {
+    CPPUNIT_NS::AllocationCounter counter;
+    m_allocated.push_back( new int( 1 ) );
+    firstCount = counter.allocationCount();
+  }
+  m_allocated.push_back( new int( 2 ) );
+
+  CPPUNIT_NS::AllocationCounter counter;
+  int secondCount = counter.allocationCount();
+  CPPUNIT_ASSERT_EQUAL( 1, firstCount );
+  CPPUNIT_ASSERT_EQUAL( 0, secondCount );
+}
+
+
+void 
+AllocationCounterTest::testIgnoresOtherThreads()
+{
+  CPPUNIT_NS::AllocationCounter counter;
+  AllocationCounterTestTask task;
+  CPPUNIT_NS::ThreadGroup::run( task, 4 );
+
+  // ThreadGroup itself allocates the workers in this thread.
+  int threadGroupAllocations = counter.allocationCount();
+  CPPUNIT_ASSERT( threadGroupAllocations < 100 );
+}
+
+
+void 
+AllocationCounterTest::testCountsPerThread()
+{
+#if defined(CPPUNIT_HAVE_THREAD_LOCAL)
+  AllocationCounterTestCountingTask task( 4 );
+  CPPUNIT_NS::ThreadGroup::run( task, 4 );
+
+  for ( int index =0; index < 4; ++index )
+    CPPUNIT_ASSERT_EQUAL( 100, task.m_counts[ index ] );
+#endif
+}
+
+
+void 
+AllocationCounterTest::testNestedCounter()
+{
+  CPPUNIT_NS::AllocationCounter outerCounter;
+  int innerCount;
+  {
+    CPPUNIT_NS::AllocationCounter innerCounter;
+    m_allocated.push_back( new int( 1 ) );
+    innerCount = innerCounter.allocationCount();
+  }
+  m_allocated.push_back( new int( 2 ) );
+  int outerCount = outerCounter.allocationCount();
+
+  CPPUNIT_ASSERT_EQUAL( 1, innerCount );
+  CPPUNIT_ASSERT_EQUAL( 1, outerCount );
+}
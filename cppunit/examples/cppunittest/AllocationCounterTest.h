@@ -0,0 +1,46 @@
+#ifndef ALLOCATIONCOUNTERTEST_H
+#define ALLOCATIONCOUNTERTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/tools/AllocationCounter.h>
+
+
+/*! \class AllocationCounterTest
+ * \brief Unit test for AllocationCounter.
+ */
+class AllocationCounterTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( AllocationCounterTest );
+  CPPUNIT_TEST( testIsInstalled );
+  CPPUNIT_TEST( testCountsAllocations );
+  CPPUNIT_TEST( testStopsWhenDestroyed );
+  CPPUNIT_TEST( testIgnoresOtherThreads );
+  CPPUNIT_TEST( testCountsPerThread );
+  CPPUNIT_TEST( testNestedCounter );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  AllocationCounterTest();
+  virtual ~AllocationCounterTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testIsInstalled();
+  void testCountsAllocations();
+  void testStopsWhenDestroyed();
+  void testIgnoresOtherThreads();
+  void testCountsPerThread();
+  void testNestedCounter();
+
+private:
+  AllocationCounterTest( const AllocationCounterTest &copy );
+  void operator =( const AllocationCounterTest &copy );
+
+private:
+  CppUnitVector<int *> m_allocated;
+};
+
+
+
+#endif  // ALLOCATIONCOUNTERTEST_H
@@ -0,0 +1,107 @@
+#include "CoreSuite.h"
+#include "AssertionTrapTest.h"
+#include <cppunit/AssertionTrap.h>
+#include <cppunit/Exception.h>
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( AssertionTrapTest,
+                                       coreSuiteName() );
+
+
+/// Raises a failure from a nested call, as a failed assertion does.
+static void 
+raiseAssertionTrapTestFailure( const std::string &description )
+{
+  CPPUNIT_NS::AssertionTrap::raise( 
+      new CPPUNIT_NS::Exception( CPPUNIT_NS::Message( description ),
+                                 CPPUNIT_NS::SourceLine( "test.cpp", 7 ) ) );
+}
+
+
+AssertionTrapTest::AssertionTrapTest()
+{
+}
+
+
+AssertionTrapTest::~AssertionTrapTest()
+{
+}
+
+
+void 
+AssertionTrapTest::testTrapIsInnermost()
+{
+  CPPUNIT_NS::AssertionTrap *outer = CPPUNIT_NS::AssertionTrap::current();
+  {
+    CPPUNIT_NS::AssertionTrap trap;
+    CPPUNIT_ASSERT( &trap == CPPUNIT_NS::AssertionTrap::current() );
+    {
+      CPPUNIT_NS::AssertionTrap inner;
+      CPPUNIT_ASSERT( &inner == CPPUNIT_NS::AssertionTrap::current() );
+    }
+    CPPUNIT_ASSERT( &trap == CPPUNIT_NS::AssertionTrap::current() );
+  }
+  CPPUNIT_ASSERT( outer == CPPUNIT_NS::AssertionTrap::current() );
+}
+
+
+void 
+AssertionTrapTest::testNoFailureIfNoJump()
+{
+  CPPUNIT_NS::AssertionTrap trap;
+  CPPUNIT_ASSERT( setjmp( trap.jumpBuffer() ) == 0 );
+  CPPUNIT_ASSERT( trap.failure() == NULL );
+}
+
+
+void 
+AssertionTrapTest::testRaiseJumpsToTrap()
+{
+  CPPUNIT_NS::AssertionTrap trap;
+  if ( setjmp( trap.jumpBuffer() ) == 0 )
+  {
+    raiseAssertionTrapTestFailure( "failed" );
+    CPPUNIT_FAIL( "raise() returned" );
+  }
+
+  CPPUNIT_ASSERT( trap.failure() != NULL );
+  CPPUNIT_ASSERT_EQUAL( std::string( "failed" ), 
+                        trap.failure()->message().shortDescription() );
+  CPPUNIT_ASSERT_EQUAL( 7, trap.failure()->sourceLine().lineNumber() );
+}
+
+
+void 
+AssertionTrapTest::testRaiseJumpsToInnermostTrap()
+{
+  CPPUNIT_NS::AssertionTrap outer;
+  if ( setjmp( outer.jumpBuffer() ) != 0 )
+    CPPUNIT_FAIL( "jumped to the outer trap" );
+
+  {
+    CPPUNIT_NS::AssertionTrap inner;
+    if ( setjmp( inner.jumpBuffer() ) == 0 )
+      raiseAssertionTrapTestFailure( "inner" );
+
+    CPPUNIT_ASSERT_EQUAL( std::string( "inner" ), 
+                          inner.failure()->message().shortDescription() );
+  }
+
+  CPPUNIT_ASSERT( &outer == CPPUNIT_NS::AssertionTrap::current() );
+  CPPUNIT_ASSERT( outer.failure() == NULL );
+}
+
+
+void 
+AssertionTrapTest::testRaiseAgainReplacesFailure()
+{
+  CPPUNIT_NS::AssertionTrap trap;
+  if ( setjmp( trap.jumpBuffer() ) == 0 )
+    raiseAssertionTrapTestFailure( "first" );
+
+  if ( setjmp( trap.jumpBuffer() ) == 0 )
+    raiseAssertionTrapTestFailure( "second" );
+
+  CPPUNIT_ASSERT_EQUAL( std::string( "second" ), 
+                        trap.failure()->message().shortDescription() );
+}
@@ -0,0 +1,34 @@
+#ifndef ASSERTIONTRAPTEST_H
+#define ASSERTIONTRAPTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+/// Unit tests for AssertionTrap
+class AssertionTrapTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( AssertionTrapTest );
+  CPPUNIT_TEST( testTrapIsInnermost );
+  CPPUNIT_TEST( testNoFailureIfNoJump );
+  CPPUNIT_TEST( testRaiseJumpsToTrap );
+  CPPUNIT_TEST( testRaiseJumpsToInnermostTrap );
+  CPPUNIT_TEST( testRaiseAgainReplacesFailure );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  AssertionTrapTest();
+  virtual ~AssertionTrapTest();
+
+  void testTrapIsInnermost();
+  void testNoFailureIfNoJump();
+  void testRaiseJumpsToTrap();
+  void testRaiseJumpsToInnermostTrap();
+  void testRaiseAgainReplacesFailure();
+
+private:
+  AssertionTrapTest( const AssertionTrapTest &other );
+  void operator =( const AssertionTrapTest &other );
+};
+
+
+#endif  // ASSERTIONTRAPTEST_H
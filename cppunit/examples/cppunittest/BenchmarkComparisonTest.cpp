@@ -0,0 +1,189 @@
+#include "ExtensionSuite.h"
+#include "BenchmarkComparisonTest.h"
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( BenchmarkComparisonTest,
+                                       extensionSuiteName() );
+
+
+/// Returns \a count samples spread around \a median, by steps of 0.1%.
+static CppUnitVector<double>
+makeComparisonSamples( double median,
+                       int count )
+{
+  CppUnitVector<double> samples;
+  for ( int index =0; index < count; ++index )
+    samples.push_back( median * (1 + 0.001 * (index - count / 2)) );
+  return samples;
+}
+
+
+/// Returns a result of one size with 5 samples around \a median.
+static CPPUNIT_NS::BenchmarkResult
+makeComparisonResult( double median )
+{
+  CPPUNIT_NS::BenchmarkResult result;
+  CppUnitVector<double> samples = makeComparisonSamples( median, 5 );
+  for ( unsigned int index =0; index < samples.size(); ++index )
+    result.addSample( 1, 1, samples[ index ] );
+  return result;
+}
+
+
+BenchmarkComparisonTest::BenchmarkComparisonTest()
+{
+}
+
+
+BenchmarkComparisonTest::~BenchmarkComparisonTest()
+{
+}
+
+
+void 
+BenchmarkComparisonTest::setUp()
+{
+}
+
+
+void 
+BenchmarkComparisonTest::tearDown()
+{
+}
+
+
+void 
+BenchmarkComparisonTest::compareFiles( CPPUNIT_NS::BenchmarkComparison &comparison )
+{
+  CPPUNIT_NS::BenchmarkResultFile baseline;
+  baseline.addResult( "slower", makeComparisonResult( 1.0 ) );
+  baseline.addResult( "faster", makeComparisonResult( 1.0 ) );
+  baseline.addResult( "same", makeComparisonResult( 1.0 ) );
+  baseline.addResult( "removed", makeComparisonResult( 1.0 ) );
+
+  CPPUNIT_NS::BenchmarkResultFile contender;
+  contender.addResult( "added", makeComparisonResult( 1.0 ) );
+  contender.addResult( "same", makeComparisonResult( 1.0 ) );
+  contender.addResult( "faster", makeComparisonResult( 0.5 ) );
+  contender.addResult( "slower", makeComparisonResult( 1.02 ) );
+  comparison.compare( baseline, contender );
+}
+
+
+void 
+BenchmarkComparisonTest::testMannWhitneyExact()
+{
+  CppUnitVector<double> low = makeComparisonSamples( 1.0, 5 );
+  CppUnitVector<double> high = makeComparisonSamples( 2.0, 5 );
+  // Only 2 of the 252 orderings of the samples are as extreme.
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 2.0 / 252, 
+      CPPUNIT_NS::BenchmarkComparison::mannWhitneyPValue( low, high ), 1e-12 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 2.0 / 252, 
+      CPPUNIT_NS::BenchmarkComparison::mannWhitneyPValue( high, low ), 1e-12 );
+
+  CppUnitVector<double> odd;
+  CppUnitVector<double> even;
+  for ( int value =1; value <= 10; value += 2 )
+  {
+    odd.push_back( value );
+    even.push_back( value +1 );
+  }
+  // U = 10 for a mean of 12.5: P(U <= 10) = 87/252.
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 174.0 / 252, 
+      CPPUNIT_NS::BenchmarkComparison::mannWhitneyPValue( odd, even ), 1e-12 );
+}
+
+
+void 
+BenchmarkComparisonTest::testMannWhitneyNormal()
+{
+  CppUnitVector<double> low = makeComparisonSamples( 1.0, 30 );
+  CppUnitVector<double> high = makeComparisonSamples( 2.0, 30 );
+  CPPUNIT_ASSERT( CPPUNIT_NS::BenchmarkComparison::mannWhitneyPValue( low, high ) 
+                  < 1e-6 );
+
+  CppUnitVector<double> interleaved;
+  for ( unsigned int index =0; index < low.size(); ++index )
+    interleaved.push_back( low[ index ] + 0.0005 );
+  CPPUNIT_ASSERT( CPPUNIT_NS::BenchmarkComparison::mannWhitneyPValue( low, interleaved ) 
+                  > 0.5 );
+}
+
+
+void 
+BenchmarkComparisonTest::testMannWhitneyTies()
+{
+  CppUnitVector<double> ones( 3, 1.0 );
+  CPPUNIT_ASSERT_EQUAL( 1.0, 
+      CPPUNIT_NS::BenchmarkComparison::mannWhitneyPValue( ones, ones ) );
+
+  CppUnitVector<double> low( 10, 1.0 );
+  CppUnitVector<double> high( 10, 2.0 );
+  CPPUNIT_ASSERT( CPPUNIT_NS::BenchmarkComparison::mannWhitneyPValue( low, high ) 
+                  < 0.001 );
+}
+
+
+void 
+BenchmarkComparisonTest::testMannWhitneyEmpty()
+{
+  CppUnitVector<double> empty;
+  CppUnitVector<double> samples = makeComparisonSamples( 1.0, 5 );
+  CPPUNIT_ASSERT_EQUAL( 1.0, 
+      CPPUNIT_NS::BenchmarkComparison::mannWhitneyPValue( empty, samples ) );
+}
+
+
+void 
+BenchmarkComparisonTest::testCompare()
+{
+  CPPUNIT_NS::BenchmarkComparison comparison( 0.05, 0.01 );
+  compareFiles( comparison );
+
+  CPPUNIT_ASSERT_EQUAL( 5, comparison.rowCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "slower" ), comparison.nameAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( 1L, comparison.sizeAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::changeRegressed, comparison.changeAt( 0 ) );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.02, comparison.relativeChangeAt( 0 ), 1e-9 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.02, comparison.contenderMedianAt( 0 ), 1e-9 );
+  CPPUNIT_ASSERT( comparison.pValueAt( 0 ) < 0.01 );
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::changeImproved, comparison.changeAt( 1 ) );
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::changeUnchanged, comparison.changeAt( 2 ) );
+  CPPUNIT_ASSERT_EQUAL( std::string( "removed" ), comparison.nameAt( 3 ) );
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::changeNotCompared, comparison.changeAt( 3 ) );
+  CPPUNIT_ASSERT_EQUAL( std::string( "added" ), comparison.nameAt( 4 ) );
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::changeNotCompared, comparison.changeAt( 4 ) );
+
+  CPPUNIT_ASSERT_EQUAL( 2, comparison.count( CPPUNIT_NS::changeNotCompared ) );
+  CPPUNIT_ASSERT( comparison.hasRegression() );
+}
+
+
+void 
+BenchmarkComparisonTest::testMinimumChange()
+{
+  // The 2% slow down is significant but smaller than the default 5%.
+  CPPUNIT_NS::BenchmarkComparison comparison;
+  compareFiles( comparison );
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::changeUnchanged, comparison.changeAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::changeImproved, comparison.changeAt( 1 ) );
+  CPPUNIT_ASSERT( !comparison.hasRegression() );
+}
+
+
+void 
+BenchmarkComparisonTest::testWrite()
+{
+  CPPUNIT_NS::BenchmarkComparison comparison( 0.05, 0.01 );
+  compareFiles( comparison );
+  CPPUNIT_NS::OStringStream stream;
+  comparison.write( stream );
+  std::string text = stream.str();
+
+  CPPUNIT_ASSERT( text.find( "slower n=1: 1 s -> 1.02 s (+2.0%, p=0.00794) regressed\n" ) 
+                  != std::string::npos );
+  CPPUNIT_ASSERT( text.find( "added n=1: 0 s -> 1 s not compared\n" ) 
+                  != std::string::npos );
+  CPPUNIT_ASSERT( text.find( "1 improved, 1 regressed, 1 unchanged, 2 not compared\n" ) 
+                  != std::string::npos );
+}
@@ -0,0 +1,47 @@
+#ifndef BENCHMARKCOMPARISONTEST_H
+#define BENCHMARKCOMPARISONTEST_H
+
+#include <cppunit/extensions/BenchmarkComparison.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+
+/*! \class BenchmarkComparisonTest
+ * \brief Unit test for BenchmarkComparison.
+ */
+class BenchmarkComparisonTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( BenchmarkComparisonTest );
+  CPPUNIT_TEST( testMannWhitneyExact );
+  CPPUNIT_TEST( testMannWhitneyNormal );
+  CPPUNIT_TEST( testMannWhitneyTies );
+  CPPUNIT_TEST( testMannWhitneyEmpty );
+  CPPUNIT_TEST( testCompare );
+  CPPUNIT_TEST( testMinimumChange );
+  CPPUNIT_TEST( testWrite );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  BenchmarkComparisonTest();
+  virtual ~BenchmarkComparisonTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testMannWhitneyExact();
+  void testMannWhitneyNormal();
+  void testMannWhitneyTies();
+  void testMannWhitneyEmpty();
+  void testCompare();
+  void testMinimumChange();
+  void testWrite();
+
+private:
+  BenchmarkComparisonTest( const BenchmarkComparisonTest &copy );
+  void operator =( const BenchmarkComparisonTest &copy );
+
+  void compareFiles( CPPUNIT_NS::BenchmarkComparison &comparison );
+};
+
+
+
+#endif  // BENCHMARKCOMPARISONTEST_H
@@ -0,0 +1,200 @@
+#include "ExtensionSuite.h"
+#include "BenchmarkEnvironmentTest.h"
+#include <cppunit/extensions/BenchmarkEnvironment.h>
+#include <stdio.h>
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( BenchmarkEnvironmentTest,
+                                       extensionSuiteName() );
+
+
+BenchmarkEnvironmentTest::BenchmarkEnvironmentTest()
+{
+}
+
+
+BenchmarkEnvironmentTest::~BenchmarkEnvironmentTest()
+{
+}
+
+
+void 
+BenchmarkEnvironmentTest::setUp()
+{
+}
+
+
+void 
+BenchmarkEnvironmentTest::tearDown()
+{
+}
+
+
+void 
+BenchmarkEnvironmentTest::testSetFact()
+{
+  CPPUNIT_NS::BenchmarkEnvironment environment;
+  environment.setFact( "governor", "powersave" );
+  environment.setFact( "turbo", "off" );
+  environment.setFact( "governor", "performance" );
+
+  CPPUNIT_ASSERT_EQUAL( 2, environment.factCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "governor" ), environment.factNameAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( std::string( "performance" ), 
+                        environment.factValueAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( std::string( "off" ), environment.fact( "turbo" ) );
+  CPPUNIT_ASSERT_EQUAL( std::string(), environment.fact( "loadAverage" ) );
+}
+
+
+void 
+BenchmarkEnvironmentTest::testCheckFacts()
+{
+  CPPUNIT_NS::BenchmarkEnvironment environment;
+  environment.setFact( "governor", "powersave" );
+  environment.setFact( "turbo", "on" );
+  environment.setFact( "loadAverage", "3.5" );
+  environment.checkFacts();
+
+  CPPUNIT_ASSERT_EQUAL( 3, environment.warningCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "CPU frequency governor is <powersave>: "
+                                     "the frequency changes with the load, "
+                                     "use <performance>." ),
+                        environment.warningAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( std::string( "Load average is 3.5: other processes "
+                                     "compete with the benchmark for the "
+                                     "processors." ),
+                        environment.warningAt( 2 ) );
+}
+
+
+void 
+BenchmarkEnvironmentTest::testQuietFacts()
+{
+  CPPUNIT_NS::BenchmarkEnvironment environment;
+  environment.setFact( "governor", "performance" );
+  environment.setFact( "turbo", "off" );
+  environment.setFact( "loadAverage", "0.2" );
+  environment.checkFacts();
+
+  CPPUNIT_ASSERT_EQUAL( 0, environment.warningCount() );
+}
+
+
+void 
+BenchmarkEnvironmentTest::testDetect()
+{
+  CPPUNIT_NS::BenchmarkEnvironment environment = 
+      CPPUNIT_NS::BenchmarkEnvironment::detect();
+
+  CPPUNIT_ASSERT( !environment.fact( "processors" ).empty() );
+  std::string turbo = environment.fact( "turbo" );
+  CPPUNIT_ASSERT( turbo.empty()  ||  turbo == "on"  ||  turbo == "off" );
+}
+
+
+void 
+BenchmarkEnvironmentTest::testReadFirstLine()
+{
+  const char *fileName = "benchmarkenvironmenttest.txt";
+  FILE *file = fopen( fileName, "w" );
+  CPPUNIT_ASSERT( file != NULL );
+  fputs( "performance\r\nsecond line\n", file );
+  fclose( file );
+
+  std::string line = CPPUNIT_NS::BenchmarkEnvironment::readFirstLine( fileName );
+  remove( fileName );
+
+  CPPUNIT_ASSERT_EQUAL( std::string( "performance" ), line );
+  CPPUNIT_ASSERT_EQUAL( std::string(), 
+                        CPPUNIT_NS::BenchmarkEnvironment::readFirstLine( fileName ) );
+}
+
+
+void 
+BenchmarkEnvironmentTest::testParseCpuList()
+{
+  CppUnitVector<int> cpus;
+  CPPUNIT_ASSERT( CPPUNIT_NS::BenchmarkControls::parseCpuList( "0-2, 6,8-8", 
+                                                               cpus ) );
+  CPPUNIT_ASSERT_EQUAL( 5, int(cpus.size()) );
+  CPPUNIT_ASSERT_EQUAL( 2, cpus[2] );
+  CPPUNIT_ASSERT_EQUAL( 6, cpus[3] );
+  CPPUNIT_ASSERT_EQUAL( std::string( "0,1,2,6,8" ), 
+                        CPPUNIT_NS::BenchmarkControls::cpuListToString( cpus ) );
+}
+
+
+void 
+BenchmarkEnvironmentTest::testParseInvalidCpuList()
+{
+  CppUnitVector<int> cpus( 1, 7 );
+  CPPUNIT_ASSERT( !CPPUNIT_NS::BenchmarkControls::parseCpuList( "", cpus ) );
+  CPPUNIT_ASSERT( !CPPUNIT_NS::BenchmarkControls::parseCpuList( "3-1", cpus ) );
+  CPPUNIT_ASSERT( !CPPUNIT_NS::BenchmarkControls::parseCpuList( "1,x", cpus ) );
+  CPPUNIT_ASSERT( !CPPUNIT_NS::BenchmarkControls::parseCpuList( "1-", cpus ) );
+  CPPUNIT_ASSERT( !CPPUNIT_NS::BenchmarkControls::parseCpuList( "-1", cpus ) );
+  // Not modified on failure.
+  CPPUNIT_ASSERT_EQUAL( 1, int(cpus.size()) );
+  CPPUNIT_ASSERT_EQUAL( 7, cpus[0] );
+}
+
+
+void 
+BenchmarkEnvironmentTest::testThreadControlWithoutControls()
+{
+  CPPUNIT_NS::BenchmarkControls controls;
+  CPPUNIT_NS::BenchmarkThreadControl control( controls );
+  CPPUNIT_NS::BenchmarkEnvironment environment;
+  control.addFacts( environment );
+
+  CPPUNIT_ASSERT_EQUAL( -1, control.cpu() );
+  CPPUNIT_ASSERT( !control.isPriorityRaised() );
+  CPPUNIT_ASSERT_EQUAL( 0, environment.factCount() );
+  CPPUNIT_ASSERT_EQUAL( 0, environment.warningCount() );
+}
+
+
+void 
+BenchmarkEnvironmentTest::testPinToUnknownCpu()
+{
+  CppUnitVector<int> cpus;
+  cpus.push_back( 0 );
+  cpus.push_back( 999999 );
+  CPPUNIT_NS::BenchmarkControls controls;
+  controls.setCpus( cpus );
+
+  CPPUNIT_NS::BenchmarkThreadControl control( controls, 1 );
+  CPPUNIT_NS::BenchmarkEnvironment environment;
+  control.addFacts( environment );
+
+  CPPUNIT_ASSERT_EQUAL( -1, control.cpu() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "0,999999" ), environment.fact( "cpus" ) );
+  CPPUNIT_ASSERT_EQUAL( 1, environment.warningCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "Could not pin the benchmark thread to "
+                                     "CPU 999999." ),
+                        environment.warningAt( 0 ) );
+}
+
+
+void 
+BenchmarkEnvironmentTest::testRaisePriority()
+{
+  CPPUNIT_NS::BenchmarkControls controls;
+  controls.setRaisePriority( true );
+  CPPUNIT_NS::BenchmarkThreadControl control( controls );
+  CPPUNIT_NS::BenchmarkEnvironment environment;
+  control.addFacts( environment );
+
+  // Raising the priority depends on the privileges of the process.
+  if ( control.isPriorityRaised() )
+  {
+    CPPUNIT_ASSERT_EQUAL( std::string( "raised" ), environment.fact( "priority" ) );
+    CPPUNIT_ASSERT_EQUAL( 0, environment.warningCount() );
+  }
+  else
+  {
+    CPPUNIT_ASSERT_EQUAL( std::string( "normal" ), environment.fact( "priority" ) );
+    CPPUNIT_ASSERT_EQUAL( 1, environment.warningCount() );
+  }
+}
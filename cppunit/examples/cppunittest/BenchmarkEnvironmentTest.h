@@ -0,0 +1,51 @@
+#ifndef BENCHMARKENVIRONMENTTEST_H
+#define BENCHMARKENVIRONMENTTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+/*! \class BenchmarkEnvironmentTest
+ * \brief Unit test for BenchmarkEnvironment, BenchmarkControls and 
+ *        BenchmarkThreadControl.
+ */
+class BenchmarkEnvironmentTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( BenchmarkEnvironmentTest );
+  CPPUNIT_TEST( testSetFact );
+  CPPUNIT_TEST( testCheckFacts );
+  CPPUNIT_TEST( testQuietFacts );
+  CPPUNIT_TEST( testDetect );
+  CPPUNIT_TEST( testReadFirstLine );
+  CPPUNIT_TEST( testParseCpuList );
+  CPPUNIT_TEST( testParseInvalidCpuList );
+  CPPUNIT_TEST( testThreadControlWithoutControls );
+  CPPUNIT_TEST( testPinToUnknownCpu );
+  CPPUNIT_TEST( testRaisePriority );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  BenchmarkEnvironmentTest();
+  virtual ~BenchmarkEnvironmentTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testSetFact();
+  void testCheckFacts();
+  void testQuietFacts();
+  void testDetect();
+  void testReadFirstLine();
+  void testParseCpuList();
+  void testParseInvalidCpuList();
+  void testThreadControlWithoutControls();
+  void testPinToUnknownCpu();
+  void testRaisePriority();
+
+private:
+  BenchmarkEnvironmentTest( const BenchmarkEnvironmentTest &copy );
+  void operator =( const BenchmarkEnvironmentTest &copy );
+};
+
+
+
+#endif  // BENCHMARKENVIRONMENTTEST_H
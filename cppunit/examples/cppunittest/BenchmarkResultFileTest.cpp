@@ -0,0 +1,182 @@
+#include "ExtensionSuite.h"
+#include "BenchmarkResultFileTest.h"
+#include <cppunit/TestSuite.h>
+#include <cppunit/extensions/BenchmarkReport.h>
+#include <cppunit/extensions/BenchmarkResultFile.h>
+#include <stdexcept>
+#include <stdio.h>
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( BenchmarkResultFileTest,
+                                       extensionSuiteName() );
+
+
+/// Returns a result with two sizes and an environment.
+static CPPUNIT_NS::BenchmarkResult
+makeResultFileTestResult()
+{
+  CPPUNIT_NS::BenchmarkResult result;
+  result.addSample( 1024, 10, 1e-4, 4096, 1024 );
+  result.addSample( 1024, 10, 2e-4, 4096, 1024 );
+  result.addSample( 8192, 1, 3e-4 );
+
+  CPPUNIT_NS::BenchmarkEnvironment environment;
+  environment.setFact( "governor", "powersave" );
+  environment.setFact( "quoted", "a \"b\"\\c\n" );
+  environment.addWarning( "CPU frequency governor is <powersave>." );
+  result.setEnvironment( environment );
+  return result;
+}
+
+
+BenchmarkResultFileTest::BenchmarkResultFileTest()
+{
+}
+
+
+BenchmarkResultFileTest::~BenchmarkResultFileTest()
+{
+}
+
+
+void 
+BenchmarkResultFileTest::setUp()
+{
+}
+
+
+void 
+BenchmarkResultFileTest::tearDown()
+{
+}
+
+
+void 
+BenchmarkResultFileTest::testAddResult()
+{
+  CPPUNIT_NS::BenchmarkResultFile file;
+  CPPUNIT_NS::BenchmarkResult result;
+  result.addSample( 1, 1, 1.0 );
+  file.addResult( "first", CPPUNIT_NS::BenchmarkResult() );
+  file.addResult( "second", CPPUNIT_NS::BenchmarkResult() );
+  file.addResult( "first", result );
+
+  CPPUNIT_ASSERT_EQUAL( 2, file.resultCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "first" ), file.nameAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( 1, file.resultAt( 0 ).sizeCount() );
+  CPPUNIT_ASSERT( file.findResult( "second" ) == &file.resultAt( 1 ) );
+  CPPUNIT_ASSERT( file.findResult( "third" ) == NULL );
+  CPPUNIT_ASSERT_EQUAL( std::string(), file.revision() );
+}
+
+
+void 
+BenchmarkResultFileTest::testAddReport()
+{
+  CPPUNIT_NS::TestSuite second( "second" );
+  CPPUNIT_NS::TestSuite first( "first" );
+  CPPUNIT_NS::BenchmarkReport report;
+  report.setResult( &second, CPPUNIT_NS::BenchmarkResult() );
+  report.setResult( &first, makeResultFileTestResult() );
+
+  CPPUNIT_NS::BenchmarkResultFile file;
+  file.addReport( report );
+  CPPUNIT_ASSERT_EQUAL( 2, file.resultCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "first" ), file.nameAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( std::string( "second" ), file.nameAt( 1 ) );
+  CPPUNIT_ASSERT_EQUAL( 2, file.resultAt( 0 ).sizeCount() );
+}
+
+
+void 
+BenchmarkResultFileTest::testWriteRead()
+{
+  CPPUNIT_NS::BenchmarkResultFile file;
+  file.setRevision( "8f3c2a1" );
+  file.addResult( "SortTest::benchmarkSort", makeResultFileTestResult() );
+  file.addResult( "empty", CPPUNIT_NS::BenchmarkResult() );
+  CPPUNIT_NS::OStringStream stream;
+  file.write( stream );
+
+  CPPUNIT_NS::BenchmarkResultFile readFile;
+  readFile.read( stream.str() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "8f3c2a1" ), readFile.revision() );
+  CPPUNIT_ASSERT_EQUAL( 2, readFile.resultCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "empty" ), readFile.nameAt( 1 ) );
+  CPPUNIT_ASSERT_EQUAL( 0, readFile.resultAt( 1 ).sizeCount() );
+
+  const CPPUNIT_NS::BenchmarkResult &result = readFile.resultAt( 0 );
+  CPPUNIT_ASSERT_EQUAL( 2, result.sizeCount() );
+  CPPUNIT_ASSERT_EQUAL( 1024L, result.sizeAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( 10L, result.iterationCountAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( 2, int(result.samplesAt( 0 ).size()) );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 2e-5, result.samplesAt( 0 )[1], 1e-15 );
+  CPPUNIT_ASSERT_EQUAL( 4096L, result.bytesPerIterationAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( 1024L, result.itemsPerIterationAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( 0L, result.bytesPerIterationAt( 1 ) );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 3e-4, result.medianAt( 1 ), 1e-15 );
+
+  const CPPUNIT_NS::BenchmarkEnvironment &environment = result.environment();
+  CPPUNIT_ASSERT_EQUAL( 2, environment.factCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "a \"b\"\\c\n" ), 
+                        environment.fact( "quoted" ) );
+  CPPUNIT_ASSERT_EQUAL( 1, environment.warningCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "CPU frequency governor is <powersave>." ), 
+                        environment.warningAt( 0 ) );
+}
+
+
+void 
+BenchmarkResultFileTest::testReadSkipsUnknownMembers()
+{
+  CPPUNIT_NS::BenchmarkResultFile file;
+  file.read( "{ \"format\" : \"cppunit-benchmark\", \"version\": 1,\n"
+             "  \"host\": { \"ok\": true, \"list\": [ null, false, -1.5e3 ] },\n"
+             "  \"benchmarks\": [ { \"name\": \"a\\u00e9\", \"threads\": [],\n"
+             "    \"sizes\": [ { \"size\": 8, \"samples\": [ 1, 2, 3 ] } ] } ] }\n" );
+
+  CPPUNIT_ASSERT_EQUAL( 1, file.resultCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "a\xc3\xa9" ), file.nameAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( 8L, file.resultAt( 0 ).sizeAt( 0 ) );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 2.0, file.resultAt( 0 ).medianAt( 0 ), 1e-15 );
+}
+
+
+void 
+BenchmarkResultFileTest::testReadInvalidText()
+{
+  CPPUNIT_NS::BenchmarkResultFile file;
+  file.addResult( "kept", CPPUNIT_NS::BenchmarkResult() );
+
+  CPPUNIT_ASSERT_THROW( file.read( "" ), std::runtime_error );
+  CPPUNIT_ASSERT_THROW( file.read( "{\"format\":\"cppunit-benchmark\"" ), 
+                        std::runtime_error );
+  CPPUNIT_ASSERT_THROW( file.read( "{\"format\":\"cppunit-benchmark\"} x" ), 
+                        std::runtime_error );
+  CPPUNIT_ASSERT_THROW( file.read( "{\"format\":\"other\"}" ), 
+                        std::runtime_error );
+  CPPUNIT_ASSERT_THROW( file.read( "{\"format\":\"cppunit-benchmark\","
+                                   "\"version\":2}" ), 
+                        std::runtime_error );
+  CPPUNIT_ASSERT_EQUAL( 1, file.resultCount() );
+}
+
+
+void 
+BenchmarkResultFileTest::testSaveLoad()
+{
+  std::string fileName = "BenchmarkResultFileTest.json";
+  CPPUNIT_NS::BenchmarkResultFile file;
+  file.addResult( "saved", makeResultFileTestResult() );
+  file.save( fileName );
+
+  CPPUNIT_NS::BenchmarkResultFile loadedFile;
+  loadedFile.load( fileName );
+  remove( fileName.c_str() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "saved" ), loadedFile.nameAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( 2, loadedFile.resultAt( 0 ).sizeCount() );
+
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_ASSERT_THROW( loadedFile.load( fileName ), std::runtime_error );
+#endif
+}
@@ -0,0 +1,44 @@
+#ifndef BENCHMARKRESULTFILETEST_H
+#define BENCHMARKRESULTFILETEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+/*! \class BenchmarkResultFileTest
+ * \brief Unit test for BenchmarkResultFile.
+ */
+class BenchmarkResultFileTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( BenchmarkResultFileTest );
+  CPPUNIT_TEST( testAddResult );
+  CPPUNIT_TEST( testAddReport );
+  CPPUNIT_TEST( testWriteRead );
+  CPPUNIT_TEST( testReadSkipsUnknownMembers );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testReadInvalidText );
+#endif
+  CPPUNIT_TEST( testSaveLoad );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  BenchmarkResultFileTest();
+  virtual ~BenchmarkResultFileTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testAddResult();
+  void testAddReport();
+  void testWriteRead();
+  void testReadSkipsUnknownMembers();
+  void testReadInvalidText();
+  void testSaveLoad();
+
+private:
+  BenchmarkResultFileTest( const BenchmarkResultFileTest &copy );
+  void operator =( const BenchmarkResultFileTest &copy );
+};
+
+
+
+#endif  // BENCHMARKRESULTFILETEST_H
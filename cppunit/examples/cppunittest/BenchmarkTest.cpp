@@ -0,0 +1,659 @@
+#include "ExtensionSuite.h"
+#include "BenchmarkTest.h"
+#include <cppunit/TestFailure.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/extensions/BenchmarkReport.h>
+#include <cppunit/tools/Clock.h>
+#include <cppunit/tools/ThreadGroup.h>
+#include <cppunit/tools/XmlDocument.h>
+#include <cppunit/tools/XmlElement.h>
+#include <math.h>
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( BenchmarkTest,
+                                       extensionSuiteName() );
+
+
+/// Benchmark whose iterations take n^2 nanoseconds, measured manually.
+class BenchmarkTestQuadratic : public CPPUNIT_NS::BenchmarkFunction
+{
+public:
+  void run( CPPUNIT_NS::BenchmarkState &state )
+  {
+    double size = state.size();
+    while ( state.keepRunning() )
+      state.setIterationTime( size * size * 1e-9 );
+  }
+};
+
+
+/// Benchmark that processes 4 bytes per unit of size in 1 ms per iteration.
+class BenchmarkTestBytes : public CPPUNIT_NS::BenchmarkFunction
+{
+public:
+  void run( CPPUNIT_NS::BenchmarkState &state )
+  {
+    state.setBytesProcessed( 4 * state.size() );
+    state.setItemsProcessed( state.size() );
+    while ( state.keepRunning() )
+      state.setIterationTime( 0.001 );
+  }
+};
+
+
+/// Benchmark that does not run its loop.
+class BenchmarkTestNoLoop : public CPPUNIT_NS::BenchmarkFunction
+{
+public:
+  void run( CPPUNIT_NS::BenchmarkState & )
+  {
+  }
+};
+
+
+/// Benchmark whose iterations slow down linearly with the number of threads.
+class BenchmarkTestContended : public CPPUNIT_NS::BenchmarkFunction
+{
+public:
+  BenchmarkTestContended()
+  {
+    for ( int index =0; index < 4; ++index )
+      m_threadIndexes[ index ] = 0;
+  }
+
+  void run( CPPUNIT_NS::BenchmarkState &state )
+  {
+    int threadIndex = state.threadIndex();
+    double iterationTime = 0.001 * state.threadCount();
+    while ( state.keepRunning() )
+      state.setIterationTime( iterationTime );
+
+    m_mutex.lock();
+    m_threadIndexes[ threadIndex ] |= 1 << (state.threadCount() -1);
+    m_mutex.unlock();
+  }
+
+  /// Bit i of entry k is set if thread k ran the benchmark on i+1 threads.
+  int m_threadIndexes[4];
+  CPPUNIT_NS::ThreadMutex m_mutex;
+};
+
+
+/// Records the order in which the benchmarks are measured.
+class BenchmarkTestRecorder : public CPPUNIT_NS::BenchmarkFunction
+{
+public:
+  BenchmarkTestRecorder( char name,
+                         double iterationTime,
+                         std::string &order )
+      : m_name( name )
+      , m_iterationTime( iterationTime )
+      , m_order( order )
+  {
+  }
+
+  void run( CPPUNIT_NS::BenchmarkState &state )
+  {
+    m_order += m_name;
+    while ( state.keepRunning() )
+      state.setIterationTime( m_iterationTime );
+  }
+
+private:
+  char m_name;
+  double m_iterationTime;
+  std::string &m_order;
+};
+
+
+/// Fixture declared with the CPPUNIT_BENCHMARK macros.
+class BenchmarkTestFixture : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( BenchmarkTestFixture );
+  CPPUNIT_BENCHMARK_COMPLEXITY( benchmarkLinear, 1024, 16384, 
+                                CPPUNIT_NS::complexityLinearithmic );
+  CPPUNIT_BENCHMARK_COMPLEXITY( benchmarkQuadratic, 1024, 16384, 
+                                CPPUNIT_NS::complexityLinear );
+  CPPUNIT_BENCHMARK( benchmarkConstant );
+  CPPUNIT_BENCHMARK_THREADS( benchmarkThreads, 2 );
+  CPPUNIT_TEST_SUITE_END();
+public:
+  void benchmarkLinear( CPPUNIT_NS::BenchmarkState &state )
+  {
+    while ( state.keepRunning() )
+      state.setIterationTime( state.size() * 1e-7 );
+  }
+
+  void benchmarkQuadratic( CPPUNIT_NS::BenchmarkState &state )
+  {
+    BenchmarkTestQuadratic().run( state );
+  }
+
+  void benchmarkConstant( CPPUNIT_NS::BenchmarkState &state )
+  {
+    while ( state.keepRunning() )
+      state.setIterationTime( 0.001 );
+  }
+
+  void benchmarkThreads( CPPUNIT_NS::BenchmarkState &state )
+  {
+    benchmarkConstant( state );
+  }
+};
+
+
+/// Adds one sample of time f(n) for each size from 2^10 to 2^22.
+static void
+addBenchmarkTestSamples( CPPUNIT_NS::BenchmarkResult &result,
+                         CPPUNIT_NS::BenchmarkComplexity complexity,
+                         double coefficient )
+{
+  for ( long size = 1 << 10; size <= 1 << 22; size *= 4 )
+  {
+    double seconds = coefficient * 
+        CPPUNIT_NS::BenchmarkResult::complexityFunction( complexity, size );
+    result.addSample( size, 1, seconds );
+  }
+  result.fitComplexity();
+}
+
+
+BenchmarkTest::BenchmarkTest()
+{
+}
+
+
+BenchmarkTest::~BenchmarkTest()
+{
+}
+
+
+void 
+BenchmarkTest::setUp()
+{
+}
+
+
+void 
+BenchmarkTest::tearDown()
+{
+}
+
+
+void 
+BenchmarkTest::testStateIterations()
+{
+  CPPUNIT_NS::BenchmarkState state( 100, 3 );
+  CPPUNIT_ASSERT_EQUAL( 100L, state.size() );
+  CPPUNIT_ASSERT_EQUAL( 3L, state.iterationCount() );
+
+  int iterationCount = 0;
+  while ( state.keepRunning() )
+    ++iterationCount;
+
+  CPPUNIT_ASSERT_EQUAL( 3, iterationCount );
+  CPPUNIT_ASSERT( state.isFinished() );
+  CPPUNIT_ASSERT( !state.keepRunning() );
+  CPPUNIT_ASSERT( state.elapsedSeconds() >= 0 );
+}
+
+
+void 
+BenchmarkTest::testPauseTiming()
+{
+  CPPUNIT_NS::BenchmarkState state( 0, 1 );
+  while ( state.keepRunning() )
+  {
+    state.pauseTiming();
+    double pauseStart = CPPUNIT_NS::Clock::now();
+    while ( CPPUNIT_NS::Clock::now() - pauseStart < 0.05 )
+      ;
+    state.resumeTiming();
+  }
+
+  CPPUNIT_ASSERT( state.elapsedSeconds() < 0.05 );
+}
+
+
+void 
+BenchmarkTest::testManualIterationTime()
+{
+  CPPUNIT_NS::BenchmarkState state( 0, 4 );
+  while ( state.keepRunning() )
+    state.setIterationTime( 0.25 );
+
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0, state.elapsedSeconds(), 1e-12 );
+}
+
+
+void 
+BenchmarkTest::testSizes()
+{
+  CPPUNIT_NS::BenchmarkRunner runner( 1 << 10, 1 << 24 );
+  CppUnitVector<long> sizes = runner.sizes();
+  static const long expected[] = { 1024, 8192, 65536, 524288, 4194304, 16777216 };
+  CPPUNIT_ASSERT_EQUAL( 6, int(sizes.size()) );
+  for ( int index =0; index < 6; ++index )
+    CPPUNIT_ASSERT_EQUAL( expected[ index ], sizes[ index ] );
+
+  runner.setRange( 1, 5 );
+  runner.setRangeMultiplier( 2 );
+  sizes = runner.sizes();
+  CPPUNIT_ASSERT_EQUAL( 4, int(sizes.size()) );
+  CPPUNIT_ASSERT_EQUAL( 4L, sizes[2] );
+  CPPUNIT_ASSERT_EQUAL( 5L, sizes[3] );
+
+  runner.setRange( 7, 0 );
+  sizes = runner.sizes();
+  CPPUNIT_ASSERT_EQUAL( 1, int(sizes.size()) );
+  CPPUNIT_ASSERT_EQUAL( 7L, sizes[0] );
+}
+
+
+void 
+BenchmarkTest::testSampleStatistics()
+{
+  CPPUNIT_NS::BenchmarkResult result;
+  result.addSample( 10, 2, 6 );
+  result.addSample( 10, 2, 2 );
+  result.addSample( 10, 2, 4 );
+  result.addSample( 20, 1, 1 );
+  result.addSample( 20, 1, 2 );
+
+  CPPUNIT_ASSERT_EQUAL( 2, result.sizeCount() );
+  CPPUNIT_ASSERT_EQUAL( 10L, result.sizeAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( 2L, result.iterationCountAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( 3, int(result.samplesAt( 0 ).size()) );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0, result.minimumAt( 0 ), 1e-12 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 2.0, result.medianAt( 0 ), 1e-12 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 3.0, result.maximumAt( 0 ), 1e-12 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.5, result.medianAt( 1 ), 1e-12 );
+}
+
+
+void 
+BenchmarkTest::testFitConstant()
+{
+  CPPUNIT_NS::BenchmarkResult result;
+  addBenchmarkTestSamples( result, CPPUNIT_NS::complexityConstant, 1e-6 );
+
+  CPPUNIT_ASSERT( result.hasComplexity() );
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::complexityConstant, result.complexity() );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 1e-6, result.coefficient(), 1e-15 );
+  CPPUNIT_ASSERT( result.rms() < 1e-9 );
+  CPPUNIT_ASSERT_EQUAL( std::string( "O(1)" ), 
+                        result.complexitySummary().substr( 0, 4 ) );
+}
+
+
+void 
+BenchmarkTest::testFitLinearithmic()
+{
+  CPPUNIT_NS::BenchmarkResult result;
+  addBenchmarkTestSamples( result, CPPUNIT_NS::complexityLinearithmic, 2e-9 );
+
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::complexityLinearithmic, result.complexity() );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 2e-9, result.coefficient(), 1e-18 );
+  CPPUNIT_ASSERT_EQUAL( std::string( "O(n log n), 2e-09 * n log n s (rms 0%)" ), 
+                        result.complexitySummary() );
+}
+
+
+void 
+BenchmarkTest::testFitQuadratic()
+{
+  CPPUNIT_NS::BenchmarkResult result;
+  addBenchmarkTestSamples( result, CPPUNIT_NS::complexityQuadratic, 3e-12 );
+
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::complexityQuadratic, result.complexity() );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 3e-12, result.coefficient(), 1e-21 );
+}
+
+
+void 
+BenchmarkTest::testFitNeedsThreeSizes()
+{
+  CPPUNIT_NS::BenchmarkResult result;
+  result.addSample( 10, 1, 1 );
+  result.addSample( 20, 1, 2 );
+  result.fitComplexity();
+
+  CPPUNIT_ASSERT( !result.hasComplexity() );
+  CPPUNIT_ASSERT_THROW( CPPUNIT_ASSERT_COMPLEXITY( result, 
+                                                   CPPUNIT_NS::complexityCubic ),
+                        CPPUNIT_NS::Exception );
+}
+
+
+void 
+BenchmarkTest::testAssertComplexity()
+{
+  CPPUNIT_NS::BenchmarkResult result;
+  addBenchmarkTestSamples( result, CPPUNIT_NS::complexityLinear, 1e-9 );
+
+  CPPUNIT_ASSERT_COMPLEXITY( result, CPPUNIT_NS::complexityLinear );
+  CPPUNIT_ASSERT_COMPLEXITY( result, CPPUNIT_NS::complexityLinearithmic );
+}
+
+
+void 
+BenchmarkTest::testAssertComplexityFails()
+{
+  CPPUNIT_NS::BenchmarkResult result;
+  addBenchmarkTestSamples( result, CPPUNIT_NS::complexityQuadratic, 1e-12 );
+
+  try
+  {
+    CPPUNIT_ASSERT_COMPLEXITY( result, CPPUNIT_NS::complexityLinearithmic );
+  }
+  catch ( CPPUNIT_NS::Exception &e )
+  {
+    CPPUNIT_NS::Message message = e.message();
+    CPPUNIT_ASSERT_EQUAL( std::string( "complexity bound exceeded" ), 
+                          message.shortDescription() );
+    CPPUNIT_ASSERT_EQUAL( std::string( "Expected: O(n log n) or better" ), 
+                          message.detailAt( 0 ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "Actual  : O(n^2), 1e-12 * n^2 s" ), 
+                          message.detailAt( 1 ).substr( 0, 31 ) );
+    // One median time for each of the 7 sizes.
+    CPPUNIT_ASSERT_EQUAL( 9, message.detailCount() );
+    CPPUNIT_ASSERT_EQUAL( std::string( "n=1024: 1.04858e-06 s" ), 
+                          message.detailAt( 2 ) );
+    return;
+  }
+  CPPUNIT_FAIL( "complexity bound not checked" );
+}
+
+
+void 
+BenchmarkTest::testRunnerCalibratesIterations()
+{
+  CPPUNIT_NS::BenchmarkRunner runner( 1024, 16384 );
+  runner.setSampleCount( 3 );
+  BenchmarkTestQuadratic benchmark;
+  CPPUNIT_NS::BenchmarkResult result = runner.run( benchmark );
+
+  CPPUNIT_ASSERT_EQUAL( 3, result.sizeCount() );
+  CPPUNIT_ASSERT_EQUAL( 16384L, result.sizeAt( 2 ) );
+  // 1024^2 ns is about 1 ms: 10 iterations last the minimum time of 10 ms.
+  CPPUNIT_ASSERT_EQUAL( 10L, result.iterationCountAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( 1L, result.iterationCountAt( 2 ) );
+  CPPUNIT_ASSERT_EQUAL( 3, int(result.samplesAt( 0 ).size()) );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 1024.0 * 1024 * 1e-9, result.medianAt( 0 ), 1e-12 );
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::complexityQuadratic, result.complexity() );
+}
+
+
+void 
+BenchmarkTest::testRunnerRequiresLoop()
+{
+  CPPUNIT_NS::BenchmarkRunner runner( 1, 10 );
+  BenchmarkTestNoLoop benchmark;
+  CPPUNIT_ASSERT_THROW( runner.run( benchmark ), CPPUNIT_NS::Exception );
+}
+
+
+void 
+BenchmarkTest::testThreadCounts()
+{
+  CppUnitVector<int> threadCounts = CPPUNIT_NS::BenchmarkRunner::threadCounts( 6 );
+  CPPUNIT_ASSERT_EQUAL( 4, int(threadCounts.size()) );
+  CPPUNIT_ASSERT_EQUAL( 1, threadCounts[0] );
+  CPPUNIT_ASSERT_EQUAL( 4, threadCounts[2] );
+  CPPUNIT_ASSERT_EQUAL( 6, threadCounts[3] );
+
+  threadCounts = CPPUNIT_NS::BenchmarkRunner::threadCounts( 8 );
+  CPPUNIT_ASSERT_EQUAL( 4, int(threadCounts.size()) );
+  CPPUNIT_ASSERT_EQUAL( 8, threadCounts[3] );
+
+  threadCounts = CPPUNIT_NS::BenchmarkRunner::threadCounts( 0 );
+  CPPUNIT_ASSERT_EQUAL( 1, int(threadCounts.size()) );
+  CPPUNIT_ASSERT_EQUAL( 1, threadCounts[0] );
+}
+
+
+void 
+BenchmarkTest::testThreadSampleStatistics()
+{
+  CPPUNIT_NS::BenchmarkResult result;
+  CppUnitVector<double> threadSeconds;
+  threadSeconds.push_back( 1.0 );
+  result.addThreadSample( 1, 100, threadSeconds );
+  threadSeconds.push_back( 0.5 );
+  result.addThreadSample( 2, 100, threadSeconds );
+
+  CPPUNIT_ASSERT_EQUAL( 2, result.threadPointCount() );
+  CPPUNIT_ASSERT_EQUAL( 2, result.threadCountAt( 1 ) );
+  CPPUNIT_ASSERT_EQUAL( 100L, result.threadIterationCountAt( 1 ) );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 100.0, result.throughputAt( 0 ), 1e-9 );
+  // 200 iterations in the 1 second of the slowest thread.
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 200.0, result.throughputAt( 1 ), 1e-9 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0, result.threadDeviationAt( 0 ), 1e-9 );
+  // Threads at 100 and 200 iterations per second.
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0 / 3, result.threadDeviationAt( 1 ), 1e-9 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0, result.efficiencyAt( 1 ), 1e-9 );
+}
+
+
+void 
+BenchmarkTest::testRunThreads()
+{
+  CPPUNIT_NS::BenchmarkRunner runner;
+  runner.setSampleCount( 2 );
+  BenchmarkTestContended benchmark;
+  CPPUNIT_NS::BenchmarkResult result = runner.runThreads( benchmark, 4 );
+
+  CPPUNIT_ASSERT_EQUAL( 0, result.sizeCount() );
+  CPPUNIT_ASSERT_EQUAL( 3, result.threadPointCount() );
+  CPPUNIT_ASSERT_EQUAL( 4, result.threadCountAt( 2 ) );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 1000.0, result.throughputAt( 0 ), 1e-6 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 1000.0, result.throughputAt( 2 ), 1e-6 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.5, result.efficiencyAt( 1 ), 1e-9 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.25, result.efficiencyAt( 2 ), 1e-9 );
+
+  // Thread 0 ran on 1, 2 and 4 threads, thread 3 only on 4 threads.
+  CPPUNIT_ASSERT_EQUAL( 1 | 2 | 8, benchmark.m_threadIndexes[0] );
+  CPPUNIT_ASSERT_EQUAL( 2 | 8, benchmark.m_threadIndexes[1] );
+  CPPUNIT_ASSERT_EQUAL( 8, benchmark.m_threadIndexes[3] );
+}
+
+
+void 
+BenchmarkTest::testRunInterleaved()
+{
+  std::string order;
+  BenchmarkTestRecorder first( 'a', 0.01, order );
+  BenchmarkTestRecorder second( 'b', 0.02, order );
+  CppUnitVector<CPPUNIT_NS::BenchmarkFunction *> benchmarks;
+  benchmarks.push_back( &first );
+  benchmarks.push_back( &second );
+
+  CPPUNIT_NS::BenchmarkRunner runner( 5 );
+  runner.setSampleCount( 3 );
+  CppUnitVector<CPPUNIT_NS::BenchmarkResult> results = 
+      runner.runInterleaved( benchmarks );
+
+  // One calibration each, then rounds starting with a different benchmark.
+  CPPUNIT_ASSERT_EQUAL( std::string( "ab" "ab" "ba" "ab" ), order );
+  CPPUNIT_ASSERT_EQUAL( 2, int(results.size()) );
+  CPPUNIT_ASSERT_EQUAL( 3, int(results[1].samplesAt( 0 ).size()) );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.01, results[0].medianAt( 0 ), 1e-12 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.02, results[1].medianAt( 0 ), 1e-12 );
+  CPPUNIT_ASSERT_EQUAL( std::string( "2" ), 
+                        results[0].environment().fact( "interleaved" ) );
+}
+
+
+void 
+BenchmarkTest::testResultRecordsEnvironment()
+{
+  CPPUNIT_NS::BenchmarkControls controls;
+  controls.setCpus( CppUnitVector<int>( 1, 999999 ) );
+  CPPUNIT_NS::BenchmarkRunner runner( 1024 );
+  runner.setControls( controls );
+  runner.setSampleCount( 1 );
+  BenchmarkTestQuadratic benchmark;
+  CPPUNIT_NS::BenchmarkResult result = runner.run( benchmark );
+
+  const CPPUNIT_NS::BenchmarkEnvironment &environment = result.environment();
+  CPPUNIT_ASSERT( !environment.fact( "processors" ).empty() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "999999" ), environment.fact( "cpus" ) );
+  std::string lastWarning = environment.warningAt( environment.warningCount() -1 );
+  CPPUNIT_ASSERT_EQUAL( std::string( "Could not pin the benchmark thread to "
+                                     "CPU 999999." ),
+                        lastWarning );
+}
+
+
+void 
+BenchmarkTest::testCacheEvictor()
+{
+  CPPUNIT_NS::BenchmarkCacheEvictor evictor( 1 << 16 );
+  CPPUNIT_ASSERT_EQUAL( 1L << 16, evictor.byteCount() );
+  // One byte of value 1 is read in each line of 64 bytes.
+  CPPUNIT_ASSERT_EQUAL( 1024, evictor.evict() );
+  CPPUNIT_ASSERT( CPPUNIT_NS::BenchmarkCacheEvictor::lastLevelCacheSize() >= 0 );
+
+  CPPUNIT_NS::BenchmarkState state( 0, 2 );
+  state.setCacheEvictor( &evictor );
+  int count = 0;
+  while ( state.keepRunning() )
+    ++count;
+  CPPUNIT_ASSERT_EQUAL( 2, count );
+}
+
+
+void 
+BenchmarkTest::testRunColdCache()
+{
+  CPPUNIT_NS::BenchmarkRunner runner( 1024 );
+  runner.setSampleCount( 1 );
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::cacheWarm, runner.cacheState() );
+  runner.setCacheState( CPPUNIT_NS::cacheCold, 1 << 16 );
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::cacheCold, runner.cacheState() );
+
+  BenchmarkTestBytes benchmark;
+  CPPUNIT_NS::BenchmarkResult result = runner.run( benchmark );
+  CPPUNIT_ASSERT_EQUAL( std::string( "65536" ), 
+                        result.environment().fact( "cacheEviction" ) );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.001, result.medianAt( 0 ), 1e-12 );
+
+  runner.setCacheState( CPPUNIT_NS::cacheWarm );
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::cacheWarm, runner.cacheState() );
+  CPPUNIT_ASSERT_EQUAL( std::string(), 
+                        runner.run( benchmark ).environment().fact( "cacheEviction" ) );
+}
+
+
+void 
+BenchmarkTest::testProcessedThroughput()
+{
+  CPPUNIT_NS::BenchmarkResult result;
+  result.addSample( 1, 10, 1.0 );
+  CPPUNIT_ASSERT_EQUAL( 0.0, result.bytesPerSecondAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( 0.0, result.itemsPerSecondAt( 0 ) );
+
+  result.addSample( 2, 10, 1.0, 100, 4 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 1000.0, result.bytesPerSecondAt( 1 ), 1e-9 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 40.0, result.itemsPerSecondAt( 1 ), 1e-9 );
+
+  CppUnitVector<double> threadSeconds( 2, 0.5 );
+  result.addThreadSample( 2, 100, threadSeconds, 10, 1 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 4000.0, result.threadBytesPerSecondAt( 0 ), 1e-9 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 400.0, result.threadItemsPerSecondAt( 0 ), 1e-9 );
+
+  CPPUNIT_NS::BenchmarkRunner runner( 1024 );
+  runner.setSampleCount( 1 );
+  BenchmarkTestBytes benchmark;
+  CPPUNIT_NS::BenchmarkResult runResult = runner.run( benchmark );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 4096 / 0.001, runResult.bytesPerSecondAt( 0 ), 1e-3 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 1024 / 0.001, runResult.itemsPerSecondAt( 0 ), 1e-3 );
+}
+
+
+void 
+BenchmarkTest::testRateToString()
+{
+  CPPUNIT_ASSERT_EQUAL( std::string( "1.25 GB/s" ), 
+                        CPPUNIT_NS::BenchmarkResult::rateToString( 1.25e9, "B" ) );
+  CPPUNIT_ASSERT_EQUAL( std::string( "2 kitems/s" ), 
+                        CPPUNIT_NS::BenchmarkResult::rateToString( 2000, "items" ) );
+  CPPUNIT_ASSERT_EQUAL( std::string( "12 B/s" ), 
+                        CPPUNIT_NS::BenchmarkResult::rateToString( 12, "B" ) );
+}
+
+
+void 
+BenchmarkTest::testBenchmarkTestCaller()
+{
+  CPPUNIT_NS::TestSuite *suite = BenchmarkTestFixture::suite();
+  CPPUNIT_NS::Test *linearTest = suite->getChildTestAt( 0 );
+  CPPUNIT_NS::Test *constantTest = suite->getChildTestAt( 2 );
+  CPPUNIT_NS::Test *threadsTest = suite->getChildTestAt( 3 );
+  CPPUNIT_NS::TestResult controller;
+  CPPUNIT_NS::TestResultCollector result;
+  controller.addListener( &result );
+  suite->run( &controller );
+
+  CPPUNIT_ASSERT_EQUAL( 4, result.runTests() );
+  CPPUNIT_ASSERT_EQUAL( 1, result.testFailures() );
+  CPPUNIT_NS::TestFailure *failure = result.failures()[0];
+  CPPUNIT_ASSERT_EQUAL( std::string( "BenchmarkTestFixture::benchmarkQuadratic" ),
+                        failure->failedTestName() );
+
+  CPPUNIT_NS::BenchmarkReport &report = CPPUNIT_NS::BenchmarkReport::getReport();
+  const CPPUNIT_NS::BenchmarkResult *linear = report.findResult( linearTest );
+  CPPUNIT_ASSERT( linear != NULL );
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::complexityLinear, linear->complexity() );
+  const CPPUNIT_NS::BenchmarkResult *constant = report.findResult( constantTest );
+  CPPUNIT_ASSERT( constant != NULL );
+  CPPUNIT_ASSERT_EQUAL( 1, constant->sizeCount() );
+  CPPUNIT_ASSERT_EQUAL( 0L, constant->sizeAt( 0 ) );
+  CPPUNIT_ASSERT( !constant->hasComplexity() );
+  const CPPUNIT_NS::BenchmarkResult *threads = report.findResult( threadsTest );
+  CPPUNIT_ASSERT( threads != NULL );
+  CPPUNIT_ASSERT_EQUAL( 2, threads->threadPointCount() );
+
+  delete suite;
+  CPPUNIT_ASSERT( report.findResult( linearTest ) == NULL );
+}
+
+
+void 
+BenchmarkTest::testXmlOutputterHook()
+{
+  CPPUNIT_NS::TestSuite test( "benchmark" );
+  CPPUNIT_NS::TestSuite other( "other" );
+  CPPUNIT_NS::BenchmarkResult benchmarkResult;
+  addBenchmarkTestSamples( benchmarkResult, CPPUNIT_NS::complexityLinear, 1e-9 );
+  CppUnitVector<double> threadSeconds( 2, 0.5 );
+  benchmarkResult.addThreadSample( 2, 100, threadSeconds, 10 );
+  CPPUNIT_NS::BenchmarkReport report;
+  report.setResult( &test, benchmarkResult );
+
+  CPPUNIT_NS::BenchmarkXmlOutputterHook hook( report );
+  CPPUNIT_NS::XmlDocument document;
+  CPPUNIT_NS::XmlElement *testElement = new CPPUNIT_NS::XmlElement( "Test" );
+  CPPUNIT_NS::XmlElement *otherElement = new CPPUNIT_NS::XmlElement( "Test" );
+  document.rootElement().addElement( testElement );
+  document.rootElement().addElement( otherElement );
+  hook.failTestAdded( &document, testElement, &test, NULL );
+  hook.successfulTestAdded( &document, otherElement, &other );
+
+  CPPUNIT_ASSERT_EQUAL( 0, otherElement->elementCount() );
+  CPPUNIT_NS::XmlElement *benchmarkElement = testElement->elementFor( "Benchmark" );
+  CPPUNIT_ASSERT_EQUAL( 8, benchmarkElement->elementCount() );
+  std::string xml = benchmarkElement->toString();
+  CPPUNIT_ASSERT( xml.find( "complexity=\"O(n)\"" ) != std::string::npos );
+  CPPUNIT_ASSERT( xml.find( "coefficient=\"1e-09\"" ) != std::string::npos );
+  CPPUNIT_ASSERT( xml.find( "value=\"4194304\"" ) != std::string::npos );
+  CPPUNIT_ASSERT_EQUAL( std::string( "Size" ), 
+                        benchmarkElement->elementAt( 6 )->name() );
+  CPPUNIT_ASSERT( benchmarkElement->elementAt( 7 )->toString().find( 
+                      "<Threads count=\"2\" iterations=\"100\" "
+                      "throughput=\"400\" deviation=\"0\" efficiency=\"1\" "
+                      "bytesPerSecond=\"4000\"" ) 
+                  != std::string::npos );
+  CPPUNIT_ASSERT( xml.find( "itemsPerSecond" ) == std::string::npos );
+}
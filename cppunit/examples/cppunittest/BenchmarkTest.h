@@ -0,0 +1,85 @@
+#ifndef BENCHMARKTEST_H
+#define BENCHMARKTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+/*! \class BenchmarkTest
+ * \brief Unit test for BenchmarkRunner, the complexity fitting and 
+ *        BenchmarkTestCaller.
+ */
+class BenchmarkTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( BenchmarkTest );
+  CPPUNIT_TEST( testStateIterations );
+  CPPUNIT_TEST( testPauseTiming );
+  CPPUNIT_TEST( testManualIterationTime );
+  CPPUNIT_TEST( testSizes );
+  CPPUNIT_TEST( testSampleStatistics );
+  CPPUNIT_TEST( testFitConstant );
+  CPPUNIT_TEST( testFitLinearithmic );
+  CPPUNIT_TEST( testFitQuadratic );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testFitNeedsThreeSizes );
+#endif
+  CPPUNIT_TEST( testAssertComplexity );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testAssertComplexityFails );
+#endif
+  CPPUNIT_TEST( testRunnerCalibratesIterations );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testRunnerRequiresLoop );
+#endif
+  CPPUNIT_TEST( testThreadCounts );
+  CPPUNIT_TEST( testThreadSampleStatistics );
+  CPPUNIT_TEST( testRunThreads );
+  CPPUNIT_TEST( testRunInterleaved );
+  CPPUNIT_TEST( testResultRecordsEnvironment );
+  CPPUNIT_TEST( testCacheEvictor );
+  CPPUNIT_TEST( testRunColdCache );
+  CPPUNIT_TEST( testProcessedThroughput );
+  CPPUNIT_TEST( testRateToString );
+  CPPUNIT_TEST( testBenchmarkTestCaller );
+  CPPUNIT_TEST( testXmlOutputterHook );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  BenchmarkTest();
+  virtual ~BenchmarkTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testStateIterations();
+  void testPauseTiming();
+  void testManualIterationTime();
+  void testSizes();
+  void testSampleStatistics();
+  void testFitConstant();
+  void testFitLinearithmic();
+  void testFitQuadratic();
+  void testFitNeedsThreeSizes();
+  void testAssertComplexity();
+  void testAssertComplexityFails();
+  void testRunnerCalibratesIterations();
+  void testRunnerRequiresLoop();
+  void testThreadCounts();
+  void testThreadSampleStatistics();
+  void testRunThreads();
+  void testRunInterleaved();
+  void testResultRecordsEnvironment();
+  void testCacheEvictor();
+  void testRunColdCache();
+  void testProcessedThroughput();
+  void testRateToString();
+  void testBenchmarkTestCaller();
+  void testXmlOutputterHook();
+
+private:
+  BenchmarkTest( const BenchmarkTest &copy );
+  void operator =( const BenchmarkTest &copy );
+};
+
+
+
+#endif  // BENCHMARKTEST_H
@@ -0,0 +1,142 @@
+#include <cppunit/XmlOutputterHook.h>
+#include "CoreSuite.h"
+#include "CallbackProfileTest.h"
+#include "MockTestListener.h"
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( CallbackProfileTest,
+                                       coreSuiteName() );
+
+
+/// Hook profiled by testAddHookTime().
+class ProfiledHook : public CPPUNIT_NS::XmlOutputterHook
+{
+};
+
+
+CallbackProfileTest::CallbackProfileTest()
+{
+}
+
+
+CallbackProfileTest::~CallbackProfileTest()
+{
+}
+
+
+void 
+CallbackProfileTest::setUp()
+{
+  m_profile = new CPPUNIT_NS::CallbackProfile();
+}
+
+
+void 
+CallbackProfileTest::tearDown()
+{
+  delete m_profile;
+}
+
+
+void 
+CallbackProfileTest::testConstructor()
+{
+  CPPUNIT_ASSERT_EQUAL( 0, m_profile->entryCount() );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0, m_profile->totalSeconds(), 1e-12 );
+}
+
+
+void 
+CallbackProfileTest::testAddListenerTime()
+{
+  MockTestListener listener( "listener" );
+  m_profile->addListenerTime( &listener, "startTest", 0.25 );
+  m_profile->addListenerTime( &listener, "endTest", 0.5 );
+  m_profile->addListenerTime( &listener, "startTest", 0.75 );
+
+  CPPUNIT_ASSERT_EQUAL( 2, m_profile->entryCount() );
+#if CPPUNIT_HAVE_RTTI
+  CPPUNIT_ASSERT_EQUAL( std::string("MockTestListener"), 
+                        m_profile->callbackNameAt( 0 ) );
+#endif
+  CPPUNIT_ASSERT_EQUAL( std::string("startTest"), m_profile->eventAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( 2L, m_profile->callCountAt( 0 ) );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0, m_profile->totalSecondsAt( 0 ), 1e-12 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.5, m_profile->secondsPerCallAt( 0 ), 1e-12 );
+  CPPUNIT_ASSERT_EQUAL( std::string("endTest"), m_profile->eventAt( 1 ) );
+  CPPUNIT_ASSERT_EQUAL( 1L, m_profile->callCountAt( 1 ) );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.5, m_profile->totalSeconds(), 1e-12 );
+}
+
+
+void 
+CallbackProfileTest::testListenersOfSameClass()
+{
+  MockTestListener listener1( "listener1" );
+  MockTestListener listener2( "listener2" );
+  m_profile->addListenerTime( &listener1, "startTest", 0.25 );
+  m_profile->addListenerTime( &listener2, "startTest", 0.5 );
+
+  CPPUNIT_ASSERT_EQUAL( 2, m_profile->entryCount() );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.25, m_profile->totalSecondsAt( 0 ), 1e-12 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.5, m_profile->totalSecondsAt( 1 ), 1e-12 );
+}
+
+
+void 
+CallbackProfileTest::testAddHookTime()
+{
+  ProfiledHook hook;
+  m_profile->addHookTime( &hook, "successfulTestAdded", 0.125 );
+  m_profile->addHookTime( &hook, "successfulTestAdded", 0.125 );
+
+  CPPUNIT_ASSERT_EQUAL( 1, m_profile->entryCount() );
+#if CPPUNIT_HAVE_RTTI
+  CPPUNIT_ASSERT_EQUAL( std::string("ProfiledHook"), 
+                        m_profile->callbackNameAt( 0 ) );
+#endif
+  CPPUNIT_ASSERT_EQUAL( std::string("successfulTestAdded"), 
+                        m_profile->eventAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( 2L, m_profile->callCountAt( 0 ) );
+}
+
+
+void 
+CallbackProfileTest::testReset()
+{
+  MockTestListener listener( "listener" );
+  m_profile->addListenerTime( &listener, "startTest", 0.25 );
+  m_profile->reset();
+  CPPUNIT_ASSERT_EQUAL( 0, m_profile->entryCount() );
+
+  m_profile->addListenerTime( &listener, "startTest", 0.5 );
+  CPPUNIT_ASSERT_EQUAL( 1L, m_profile->callCountAt( 0 ) );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.5, m_profile->totalSeconds(), 1e-12 );
+}
+
+
+void 
+CallbackProfileTest::testWrite()
+{
+  MockTestListener listener( "listener" );
+  m_profile->addListenerTime( &listener, "startTest", 0.001 );
+  m_profile->addListenerTime( &listener, "endTest", 0.003 );
+  m_profile->addListenerTime( &listener, "endTest", 0.003 );
+  m_profile->addListenerTime( &listener, "addFailure", 0.002 );
+
+  CPPUNIT_NS::OStringStream stream;
+  m_profile->write( stream, 2 );
+  std::string report = stream.str();
+
+  CPPUNIT_ASSERT_EQUAL( 0, int(report.find( "Listener and hook profile: "
+                                            "9.000 ms in 4 calls\n" )) );
+  std::string::size_type endTest = report.find( "       6.000         2       "
+                                                "3000.000  " );
+  std::string::size_type addFailure = report.find( "       2.000         1       "
+                                                   "2000.000  " );
+  CPPUNIT_ASSERT( endTest != std::string::npos );
+  CPPUNIT_ASSERT( addFailure != std::string::npos );
+  CPPUNIT_ASSERT( endTest < addFailure );
+  CPPUNIT_ASSERT( report.find( "::endTest\n" ) != std::string::npos );
+  CPPUNIT_ASSERT( report.find( "::startTest" ) == std::string::npos );
+}
@@ -0,0 +1,46 @@
+#ifndef CALLBACKPROFILETEST_H
+#define CALLBACKPROFILETEST_H
+
+#include <cppunit/CallbackProfile.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+
+/*! \class CallbackProfileTest
+ * \brief Unit test for CallbackProfile.
+ */
+class CallbackProfileTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( CallbackProfileTest );
+  CPPUNIT_TEST( testConstructor );
+  CPPUNIT_TEST( testAddListenerTime );
+  CPPUNIT_TEST( testListenersOfSameClass );
+  CPPUNIT_TEST( testAddHookTime );
+  CPPUNIT_TEST( testReset );
+  CPPUNIT_TEST( testWrite );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  CallbackProfileTest();
+  virtual ~CallbackProfileTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testConstructor();
+  void testAddListenerTime();
+  void testListenersOfSameClass();
+  void testAddHookTime();
+  void testReset();
+  void testWrite();
+
+private:
+  CallbackProfileTest( const CallbackProfileTest &copy );
+  void operator =( const CallbackProfileTest &copy );
+
+private:
+  CPPUNIT_NS::CallbackProfile *m_profile;
+};
+
+
+
+#endif  // CALLBACKPROFILETEST_H
@@ -0,0 +1,263 @@
+#include "CoreSuite.h"
+#include "CommandLineRunnerTest.h"
+#include <cppunit/CommandLineRunner.h>
+#include <cppunit/extensions/TestSetUp.h>
+#include <cppunit/tools/Clock.h>
+#include <stdio.h>
+
+#if defined(CPPUNIT_HAVE_FORK)  &&  defined(CPPUNIT_HAVE_SYS_WAIT_H)
+#include <unistd.h>
+#endif
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( CommandLineRunnerTest,
+                                       coreSuiteName() );
+
+
+/// Tests run by the runner, in a registry of their own.
+class CommandLineRunnerTestSample : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( CommandLineRunnerTestSample );
+  CPPUNIT_TEST( testPass1 );
+  CPPUNIT_TEST( testPass2 );
+  CPPUNIT_TEST( testPass3 );
+  CPPUNIT_TEST( testFail );
+  CPPUNIT_TEST_SUITE_END();
+public:
+  void testPass1() {}
+  void testPass2() {}
+  void testPass3() {}
+  void testFail() { CPPUNIT_FAIL( "sample failure" ); }
+};
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( CommandLineRunnerTestSample,
+                                       "CommandLineRunnerTest" );
+
+
+#if defined(CPPUNIT_HAVE_FORK)  &&  defined(CPPUNIT_HAVE_SYS_WAIT_H)
+/// Tests losing the worker process that runs them.
+class CommandLineRunnerTestCrashSample : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( CommandLineRunnerTestCrashSample );
+  CPPUNIT_TEST( testCrash );
+  CPPUNIT_TEST( testHang );
+  CPPUNIT_TEST( testPass );
+  CPPUNIT_TEST_SUITE_END();
+public:
+  void testCrash() { ::_exit( 3 ); }
+  void testHang() 
+  { 
+    CPPUNIT_NS::Clock::sleepUntil( CPPUNIT_NS::Clock::now() + 30 ); 
+  }
+  void testPass() {}
+};
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( CommandLineRunnerTestCrashSample,
+                                       "CommandLineRunnerTestCrash" );
+
+
+/// Set by the setUp() of CommandLineRunnerTestSetUpSample.
+static bool commandLineRunnerTestIsSetUp = false;
+
+/// Tests that only pass within the setUp() and tearDown() of their suite.
+class CommandLineRunnerTestSetUpSample : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( CommandLineRunnerTestSetUpSample );
+  CPPUNIT_TEST( testIsSetUp1 );
+  CPPUNIT_TEST( testIsSetUp2 );
+  CPPUNIT_TEST_SUITE_END();
+public:
+  void testIsSetUp1() { CPPUNIT_ASSERT( commandLineRunnerTestIsSetUp ); }
+  void testIsSetUp2() { CPPUNIT_ASSERT( commandLineRunnerTestIsSetUp ); }
+};
+
+
+/// Decorates CommandLineRunnerTestSetUpSample with a TestSetUp.
+class CommandLineRunnerTestSetUp : public CPPUNIT_NS::TestSetUp
+{
+public:
+  CommandLineRunnerTestSetUp()
+      : CPPUNIT_NS::TestSetUp( CommandLineRunnerTestSetUpSample::suite() )
+  {
+  }
+
+  /// Used by the registration, as the suite() of a fixture.
+  static CPPUNIT_NS::Test *suite()
+  {
+    return new CommandLineRunnerTestSetUp();
+  }
+
+protected:
+  void setUp() { commandLineRunnerTestIsSetUp = true; }
+  void tearDown() { commandLineRunnerTestIsSetUp = false; }
+};
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( CommandLineRunnerTestSetUp,
+                                       "CommandLineRunnerTestSetUp" );
+#endif
+
+
+CommandLineRunnerTest::CommandLineRunnerTest()
+    : m_xmlFileName( "CommandLineRunnerTest.xml" )
+{
+}
+
+
+CommandLineRunnerTest::~CommandLineRunnerTest()
+{
+}
+
+
+void 
+CommandLineRunnerTest::setUp()
+{
+  m_registryName = "CommandLineRunnerTest";
+  m_output = "";
+}
+
+
+void 
+CommandLineRunnerTest::tearDown()
+{
+  ::remove( m_xmlFileName.c_str() );
+}
+
+
+int 
+CommandLineRunnerTest::run( const std::string &option1,
+                            const std::string &option2,
+                            const std::string &option3,
+                            const std::string &option4 )
+{
+  CppUnitVector<const char *> arguments;
+  arguments.push_back( "runner" );
+  arguments.push_back( "-n" );
+  arguments.push_back( "-x" );
+  arguments.push_back( m_xmlFileName.c_str() );
+  if ( !option1.empty() )
+    arguments.push_back( option1.c_str() );
+  if ( !option2.empty() )
+    arguments.push_back( option2.c_str() );
+  if ( !option3.empty() )
+    arguments.push_back( option3.c_str() );
+  if ( !option4.empty() )
+    arguments.push_back( option4.c_str() );
+  arguments.push_back( NULL );
+
+  CPPUNIT_NS::CommandLineRunner runner( m_registryName );
+  int returnCode = runner.main( arguments.size() -1, &arguments[0] );
+
+  m_output = "";
+  FILE *file = fopen( m_xmlFileName.c_str(), "rb" );
+  CPPUNIT_ASSERT( file != NULL );
+  char buffer[ 4096 ];
+  size_t count;
+  while ( (count = fread( buffer, 1, sizeof(buffer), file )) > 0 )
+    m_output.append( buffer, count );
+  fclose( file );
+  return returnCode;
+}
+
+
+int 
+CommandLineRunnerTest::countInOutput( const std::string &text ) const
+{
+  int count = 0;
+  std::string::size_type position = m_output.find( text );
+  while ( position != std::string::npos )
+  {
+    ++count;
+    position = m_output.find( text, position + text.length() );
+  }
+  return count;
+}
+
+
+void 
+CommandLineRunnerTest::testRunsRegistry()
+{
+  CPPUNIT_ASSERT_EQUAL( int(CPPUNIT_NS::CommandLineRunner::failureReturnCode), 
+                        run() );
+  CPPUNIT_ASSERT_EQUAL( 3, countInOutput( "<Test " ) );
+  CPPUNIT_ASSERT_EQUAL( 1, countInOutput( "<FailedTest " ) );
+  CPPUNIT_ASSERT_EQUAL( 1, countInOutput( "sample failure" ) );
+}
+
+
+void 
+CommandLineRunnerTest::testTestPath()
+{
+  CPPUNIT_ASSERT_EQUAL( int(CPPUNIT_NS::CommandLineRunner::successReturnCode), 
+                        run( ":CommandLineRunnerTestSample/"
+                             "CommandLineRunnerTestSample::testPass2" ) );
+  CPPUNIT_ASSERT_EQUAL( 1, countInOutput( "<Test " ) );
+  CPPUNIT_ASSERT_EQUAL( 0, countInOutput( "<FailedTest " ) );
+}
+
+
+void 
+CommandLineRunnerTest::testParallel()
+{
+  CPPUNIT_ASSERT_EQUAL( int(CPPUNIT_NS::CommandLineRunner::failureReturnCode), 
+                        run( "-P", "2" ) );
+  CPPUNIT_ASSERT_EQUAL( 3, countInOutput( "<Test " ) );
+  CPPUNIT_ASSERT_EQUAL( 1, countInOutput( "<FailedTest " ) );
+}
+
+
+void 
+CommandLineRunnerTest::testShards()
+{
+  run( "-S", "0/2" );
+  int firstShardCount = countInOutput( "<Test " ) + countInOutput( "<FailedTest " );
+  run( "-S", "1/2" );
+  int secondShardCount = countInOutput( "<Test " ) + countInOutput( "<FailedTest " );
+
+  CPPUNIT_ASSERT_EQUAL( 2, firstShardCount );
+  CPPUNIT_ASSERT_EQUAL( 2, secondShardCount );
+}
+
+
+void 
+CommandLineRunnerTest::testProcesses()
+{
+#if defined(CPPUNIT_HAVE_FORK)  &&  defined(CPPUNIT_HAVE_SYS_WAIT_H)
+  CPPUNIT_ASSERT_EQUAL( int(CPPUNIT_NS::CommandLineRunner::failureReturnCode), 
+                        run( "-N", "2" ) );
+  CPPUNIT_ASSERT_EQUAL( 3, countInOutput( "<Test " ) );
+  CPPUNIT_ASSERT_EQUAL( 1, countInOutput( "<FailedTest " ) );
+  CPPUNIT_ASSERT_EQUAL( 1, countInOutput( "sample failure" ) );
+#endif
+}
+
+
+void 
+CommandLineRunnerTest::testProcessesReplaceLostWorkers()
+{
+#if defined(CPPUNIT_HAVE_FORK)  &&  defined(CPPUNIT_HAVE_SYS_WAIT_H)
+  // Each attempt of the crashing and hanging tests costs the only worker.
+  m_registryName = "CommandLineRunnerTestCrash";
+  double startTime = CPPUNIT_NS::Clock::now();
+  CPPUNIT_ASSERT_EQUAL( int(CPPUNIT_NS::CommandLineRunner::failureReturnCode), 
+                        run( "-N", "1", "-O", "0.3" ) );
+  CPPUNIT_ASSERT( CPPUNIT_NS::Clock::now() - startTime < 10 );
+  CPPUNIT_ASSERT_EQUAL( 1, countInOutput( "<Test " ) );
+  CPPUNIT_ASSERT_EQUAL( 2, countInOutput( "<FailedTest " ) );
+  CPPUNIT_ASSERT_EQUAL( 1, countInOutput( "connection to the worker lost (3 attempts)" ) );
+  CPPUNIT_ASSERT_EQUAL( 1, countInOutput( "test timed out on the worker (3 attempts)" ) );
+#endif
+}
+
+
+void 
+CommandLineRunnerTest::testProcessesRunDecoratorsWhole()
+{
+#if defined(CPPUNIT_HAVE_FORK)  &&  defined(CPPUNIT_HAVE_SYS_WAIT_H)
+  m_registryName = "CommandLineRunnerTestSetUp";
+  CPPUNIT_ASSERT_EQUAL( int(CPPUNIT_NS::CommandLineRunner::successReturnCode), 
+                        run( "-N", "2" ) );
+  CPPUNIT_ASSERT_EQUAL( 2, countInOutput( "<Test " ) );
+  CPPUNIT_ASSERT_EQUAL( 0, countInOutput( "<FailedTest " ) );
+  CPPUNIT_ASSERT_EQUAL( 1, countInOutput( "testIsSetUp2" ) );
+#endif
+}
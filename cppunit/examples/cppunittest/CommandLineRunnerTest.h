@@ -0,0 +1,66 @@
+#ifndef COMMANDLINERUNNERTEST_H
+#define COMMANDLINERUNNERTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/portability/CppUnitVector.h>
+#include <string>
+
+
+/*! \class CommandLineRunnerTest
+ * \brief Unit test for class CommandLineRunner.
+ *
+ * The runner runs the tests of a registry of its own, and writes their
+ * results in an XML file.
+ */
+class CommandLineRunnerTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( CommandLineRunnerTest );
+  CPPUNIT_TEST( testRunsRegistry );
+  CPPUNIT_TEST( testTestPath );
+  CPPUNIT_TEST( testParallel );
+  CPPUNIT_TEST( testShards );
+  CPPUNIT_TEST( testProcesses );
+  CPPUNIT_TEST( testProcessesReplaceLostWorkers );
+  CPPUNIT_TEST( testProcessesRunDecoratorsWhole );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  CommandLineRunnerTest();
+  virtual ~CommandLineRunnerTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testRunsRegistry();
+  void testTestPath();
+  void testParallel();
+  void testShards();
+  void testProcesses();
+  void testProcessesReplaceLostWorkers();
+  void testProcessesRunDecoratorsWhole();
+
+private:
+  CommandLineRunnerTest( const CommandLineRunnerTest &copy );
+  void operator =( const CommandLineRunnerTest &copy );
+
+  /*! Runs the sample tests of the registry m_registryName with the
+   *  specified options.
+   * \return Exit code of the runner.
+   */
+  int run( const std::string &option1 = "",
+           const std::string &option2 = "",
+           const std::string &option3 = "",
+           const std::string &option4 = "" );
+
+  /// Returns the number of occurrences of \a text in the XML output.
+  int countInOutput( const std::string &text ) const;
+
+private:
+  std::string m_registryName;
+  std::string m_xmlFileName;
+  std::string m_output;
+};
+
+
+
+#endif  // COMMANDLINERUNNERTEST_H
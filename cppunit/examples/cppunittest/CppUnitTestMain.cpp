@@ -6,10 +6,15 @@
 #include <cppunit/BriefTestProgressListener.h>
 #include <cppunit/XmlOutputter.h>
 #include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/tools/AllocationCounter.h>
 #include <stdexcept>
 #include <fstream>
 
 
+// Counts allocations for AllocationCounterTest and OrthodoxMoveTest.
+CPPUNIT_INSTALL_ALLOCATION_COUNTER()
+
+
 int 
 main( int argc, char* argv[] )
 {
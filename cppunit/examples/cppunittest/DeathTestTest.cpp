@@ -0,0 +1,216 @@
+#include "ExtensionSuite.h"
+#include "DeathTestTest.h"
+
+#if defined(CPPUNIT_HAVE_FORK)  &&  defined(CPPUNIT_HAVE_SYS_WAIT_H)  &&  \
+    defined(CPPUNIT_HAVE_UNISTD_H)
+
+#include <cppunit/extensions/DeathTest.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( DeathTestTest,
+                                       extensionSuiteName() );
+
+
+/// Prints a message on the standard error and aborts, as invariant checks do.
+static void 
+abortDeathTestTest( const char *message )
+{
+  fprintf( stderr, "%s\n", message );
+  abort();
+}
+
+
+DeathTestTest::DeathTestTest()
+{
+}
+
+
+DeathTestTest::~DeathTestTest()
+{
+}
+
+
+void 
+DeathTestTest::setUp()
+{
+  m_defaultTimeout = CPPUNIT_NS::DeathTest::defaultTimeout();
+}
+
+
+void 
+DeathTestTest::tearDown()
+{
+  CPPUNIT_NS::DeathTest::setDefaultTimeout( m_defaultTimeout );
+}
+
+
+void 
+DeathTestTest::testAbortDies()
+{
+  CPPUNIT_ASSERT_DEATH( abort(), "" );
+}
+
+
+void 
+DeathTestTest::testNonZeroExitDies()
+{
+  CPPUNIT_ASSERT_DEATH( exit( 3 ), "" );
+}
+
+
+void 
+DeathTestTest::testStandardErrorIsMatched()
+{
+  CPPUNIT_ASSERT_DEATH( abortDeathTestTest( "invariant 42 broken" ), 
+                        "invariant [0-9]+ broken" );
+}
+
+
+void 
+DeathTestTest::testOutcomeOfSignal()
+{
+  CPPUNIT_NS::DeathTest deathTest;
+  if ( deathTest.spawnChild() )
+  {
+    fprintf( stderr, "terminated" );
+    kill( getpid(), SIGTERM );
+    deathTest.exitChild( CPPUNIT_NS::DeathTest::returned );
+  }
+  deathTest.wait();
+
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::DeathTest::signaled, deathTest.outcome() );
+  CPPUNIT_ASSERT( deathTest.died() );
+  CPPUNIT_ASSERT_EQUAL( int(SIGTERM), deathTest.signalNumber() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "terminated" ), deathTest.errorOutput() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "killed by signal 15" ), 
+                        deathTest.describeOutcome() );
+}
+
+
+void 
+DeathTestTest::testOutcomeOfReturn()
+{
+  CPPUNIT_NS::DeathTest deathTest;
+  if ( deathTest.spawnChild() )
+    deathTest.exitChild( CPPUNIT_NS::DeathTest::returned );
+  deathTest.wait();
+
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::DeathTest::returned, deathTest.outcome() );
+  CPPUNIT_ASSERT( !deathTest.died() );
+}
+
+
+void 
+DeathTestTest::testOutcomeOfTimeout()
+{
+  CPPUNIT_NS::DeathTest deathTest;
+  deathTest.setTimeout( 0.2 );
+  if ( deathTest.spawnChild() )
+  {
+    fprintf( stderr, "hanging" );
+    fflush( stderr );
+    while ( true )
+      pause();
+  }
+  deathTest.wait();
+
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::DeathTest::timedOut, deathTest.outcome() );
+  CPPUNIT_ASSERT( !deathTest.died() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "hanging" ), deathTest.errorOutput() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "timed out after 0.2 seconds" ), 
+                        deathTest.describeOutcome() );
+}
+
+
+void 
+DeathTestTest::testReturnFails()
+{
+  CPPUNIT_ASSERT_ASSERTION_FAIL( CPPUNIT_ASSERT_DEATH( (void)0, "" ) );
+}
+
+
+void 
+DeathTestTest::testExceptionFails()
+{
+  CPPUNIT_ASSERT_ASSERTION_FAIL( 
+      CPPUNIT_ASSERT_DEATH( throw std::runtime_error( "failed" ), "" ) );
+}
+
+
+void 
+DeathTestTest::testFailedAssertionFails()
+{
+  CPPUNIT_ASSERT_ASSERTION_FAIL( 
+      CPPUNIT_ASSERT_DEATH( CPPUNIT_FAIL( "failed" ), "" ) );
+}
+
+
+void 
+DeathTestTest::testZeroExitFails()
+{
+  CPPUNIT_ASSERT_ASSERTION_FAIL( CPPUNIT_ASSERT_DEATH( exit( 0 ), "" ) );
+}
+
+
+void 
+DeathTestTest::testStandardErrorMismatchFails()
+{
+  CPPUNIT_ASSERT_ASSERTION_FAIL( 
+      CPPUNIT_ASSERT_DEATH( abortDeathTestTest( "invariant broken" ), 
+                            "unknown order" ) );
+}
+
+
+void 
+DeathTestTest::testHangFails()
+{
+  CPPUNIT_NS::DeathTest::setDefaultTimeout( 0.2 );
+  CPPUNIT_ASSERT_ASSERTION_FAIL( CPPUNIT_ASSERT_DEATH( pause(), "" ) );
+}
+
+
+void 
+DeathTestTest::testExitCode()
+{
+  CPPUNIT_ASSERT_EXIT( _exit( 0 ), 0, "" );
+  CPPUNIT_ASSERT_EXIT( exit( 3 ), 3, "" );
+}
+
+
+void 
+DeathTestTest::testWrongExitCodeFails()
+{
+  CPPUNIT_ASSERT_ASSERTION_FAIL( CPPUNIT_ASSERT_EXIT( exit( 3 ), 2, "" ) );
+}
+
+
+void 
+DeathTestTest::testKilledIsNotExit()
+{
+  CPPUNIT_ASSERT_ASSERTION_FAIL( CPPUNIT_ASSERT_EXIT( abort(), 0, "" ) );
+}
+
+
+void 
+DeathTestTest::testMatches()
+{
+  CPPUNIT_ASSERT( CPPUNIT_NS::DeathTest::matches( "any text", "" ) );
+  CPPUNIT_ASSERT( CPPUNIT_NS::DeathTest::matches( "error: bad order 12", 
+                                                  "order [0-9]+$" ) );
+  CPPUNIT_ASSERT( !CPPUNIT_NS::DeathTest::matches( "error: bad order", 
+                                                   "^order" ) );
+}
+
+
+void 
+DeathTestTest::testInvalidPatternThrow()
+{
+  CPPUNIT_NS::DeathTest::matches( "text", "(" );
+}
+
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef DEATHTESTTEST_H
+#define DEATHTESTTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdexcept>
+
+#if defined(CPPUNIT_HAVE_FORK)  &&  defined(CPPUNIT_HAVE_SYS_WAIT_H)  &&  \
+    defined(CPPUNIT_HAVE_UNISTD_H)
+
+
+/// Unit tests for DeathTest, CPPUNIT_ASSERT_DEATH and CPPUNIT_ASSERT_EXIT.
+class DeathTestTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( DeathTestTest );
+  CPPUNIT_TEST( testAbortDies );
+  CPPUNIT_TEST( testNonZeroExitDies );
+  CPPUNIT_TEST( testStandardErrorIsMatched );
+  CPPUNIT_TEST( testOutcomeOfSignal );
+  CPPUNIT_TEST( testOutcomeOfReturn );
+  CPPUNIT_TEST( testOutcomeOfTimeout );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testReturnFails );
+  CPPUNIT_TEST( testExceptionFails );
+  CPPUNIT_TEST( testFailedAssertionFails );
+  CPPUNIT_TEST( testZeroExitFails );
+  CPPUNIT_TEST( testStandardErrorMismatchFails );
+  CPPUNIT_TEST( testHangFails );
+#endif
+  CPPUNIT_TEST( testExitCode );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testWrongExitCodeFails );
+  CPPUNIT_TEST( testKilledIsNotExit );
+#endif
+  CPPUNIT_TEST( testMatches );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST_EXCEPTION( testInvalidPatternThrow, std::invalid_argument );
+#endif
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  DeathTestTest();
+  virtual ~DeathTestTest();
+
+  void setUp();
+  void tearDown();
+
+  void testAbortDies();
+  void testNonZeroExitDies();
+  void testStandardErrorIsMatched();
+  void testOutcomeOfSignal();
+  void testOutcomeOfReturn();
+  void testOutcomeOfTimeout();
+  void testReturnFails();
+  void testExceptionFails();
+  void testFailedAssertionFails();
+  void testZeroExitFails();
+  void testStandardErrorMismatchFails();
+  void testHangFails();
+  void testExitCode();
+  void testWrongExitCodeFails();
+  void testKilledIsNotExit();
+  void testMatches();
+  void testInvalidPatternThrow();
+
+private:
+  DeathTestTest( const DeathTestTest &other );
+  void operator =( const DeathTestTest &other );
+
+private:
+  double m_defaultTimeout;
+};
+
+
+#endif
+
+#endif  // DEATHTESTTEST_H
@@ -0,0 +1,279 @@
+#include "ExtensionSuite.h"
+#include "DifferentialTestTest.h"
+#include <cppunit/Exception.h>
+#include <cppunit/extensions/DifferentialTest.h>
+#include <stdexcept>
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( DifferentialTestTest,
+                                       extensionSuiteName() );
+
+
+typedef std::vector<int> DifferentialValues;
+
+
+static DifferentialValues
+generateDifferentialValues( CPPUNIT_NS::Random &random )
+{
+  DifferentialValues values( random.nextInt( 0, 20 ) );
+  for ( unsigned int index =0; index < values.size(); ++index )
+    values[index] = random.nextInt( -1000, 1000 );
+  return values;
+}
+
+
+static long
+sumReference( const DifferentialValues &values )
+{
+  long sum = 0;
+  for ( unsigned int index =0; index < values.size(); ++index )
+    sum += values[index];
+  return sum;
+}
+
+
+static long
+sumUnrolled( const DifferentialValues &values )
+{
+  long sum1 = 0;
+  long sum2 = 0;
+  unsigned int index = 0;
+  for ( ; index +1 < values.size(); index += 2 )
+  {
+    sum1 += values[index];
+    sum2 += values[index +1];
+  }
+  if ( index < values.size() )
+    sum1 += values[index];
+  return sum1 + sum2;
+}
+
+
+/// Forgets the last element when the size is odd.
+static long
+sumUnrolledBroken( const DifferentialValues &values )
+{
+  long sum = 0;
+  for ( unsigned int index =0; index +1 < values.size(); index += 2 )
+    sum += values[index] + values[index +1];
+  return sum;
+}
+
+
+static long
+sumThrowing( const DifferentialValues &values )
+{
+  if ( values.size() > 3 )
+    throw std::runtime_error( "too many values" );
+  return sumReference( values );
+}
+
+
+static double
+averageReference( const DifferentialValues &values )
+{
+  return values.empty() ? 0 : double( sumReference( values ) ) / values.size();
+}
+
+
+static double
+averageApproximate( const DifferentialValues &values )
+{
+  return averageReference( values ) + 1e-9;
+}
+
+
+DifferentialTestTest::DifferentialTestTest()
+{
+}
+
+
+DifferentialTestTest::~DifferentialTestTest()
+{
+}
+
+
+void 
+DifferentialTestTest::setUp()
+{
+}
+
+
+void 
+DifferentialTestTest::tearDown()
+{
+}
+
+
+void 
+DifferentialTestTest::testMatchingCandidates()
+{
+  CPPUNIT_NS::DifferentialTest<DifferentialValues, long> differential( 
+      &generateDifferentialValues, &sumReference );
+  differential.addCandidate( "reference", &sumReference );
+  differential.addCandidate( "unrolled", &sumUnrolled );
+  differential.setCaseCount( 500 );
+  differential.setThreadCount( 4 );
+  differential.setBatchSize( 64 );
+  CPPUNIT_ASSERT_DIFFERENTIAL( differential );
+}
+
+
+void 
+DifferentialTestTest::testMismatchIsReported()
+{
+  CPPUNIT_NS::DifferentialTest<DifferentialValues, long> differential( 
+      &generateDifferentialValues, &sumReference );
+  differential.addCandidate( "unrolled", &sumUnrolled );
+  differential.addCandidate( "broken", &sumUnrolledBroken );
+  differential.setSeed( 1234 );
+  try
+  {
+    differential.check( CPPUNIT_SOURCELINE() );
+  }
+  catch ( CPPUNIT_NS::Exception &e )
+  {
+    CPPUNIT_NS::Message message = e.message();
+    CPPUNIT_ASSERT_EQUAL( std::string( "differential test failed" ), 
+                          message.shortDescription() );
+    CPPUNIT_ASSERT_EQUAL( std::string( "Candidate <broken> differs from the reference" ), 
+                          message.detailAt(0) );
+    std::string details = message.details();
+    CPPUNIT_ASSERT( details.find( "Seed: 1234, case " ) != std::string::npos );
+    CPPUNIT_ASSERT( details.find( "CPPUNIT_SEED=1234" ) != std::string::npos );
+    CPPUNIT_ASSERT( e.sourceLine().isValid() );
+    return;
+  }
+  CPPUNIT_FAIL( "mismatch not reported" );
+}
+
+
+void 
+DifferentialTestTest::testMismatchIsMinimized()
+{
+  CPPUNIT_NS::DifferentialTest<DifferentialValues, long> differential( 
+      &generateDifferentialValues, &sumReference );
+  differential.addCandidate( "broken", &sumUnrolledBroken );
+
+  DifferentialValues input;
+  input.push_back( 17 );
+  input.push_back( -4 );
+  input.push_back( 250 );
+  DifferentialValues minimized = differential.minimize( input, 0 );
+  CPPUNIT_ASSERT_EQUAL( 1, int(minimized.size()) );
+  CPPUNIT_ASSERT_EQUAL( 1, minimized[0] );
+  CPPUNIT_ASSERT_EQUAL( std::string( "[1]" ), 
+                        CPPUNIT_NS::TestValueTraits<DifferentialValues>::toString( minimized ) );
+}
+
+
+void 
+DifferentialTestTest::testSeedReplaysMismatch()
+{
+  std::string details[2];
+  for ( int run =0; run < 2; ++run )
+  {
+    CPPUNIT_NS::DifferentialTest<DifferentialValues, long> differential( 
+        &generateDifferentialValues, &sumReference );
+    differential.addCandidate( "broken", &sumUnrolledBroken );
+    differential.setSeed( 99 );
+    differential.setThreadCount( run == 0 ? 1 : 4 );
+    try
+    {
+      differential.check();
+    }
+    catch ( CPPUNIT_NS::Exception &e )
+    {
+      details[run] = e.message().details();
+    }
+  }
+
+  CPPUNIT_ASSERT( !details[0].empty() );
+  CPPUNIT_ASSERT_EQUAL( details[0], details[1] );
+}
+
+
+void 
+DifferentialTestTest::testThrowingCandidateIsMismatch()
+{
+  CPPUNIT_NS::DifferentialTest<DifferentialValues, long> differential( 
+      &generateDifferentialValues, &sumReference );
+  differential.addCandidate( "throwing", &sumThrowing );
+  try
+  {
+    differential.check();
+  }
+  catch ( CPPUNIT_NS::Exception &e )
+  {
+    std::string details = e.message().details();
+    CPPUNIT_ASSERT( details.find( "exception thrown: too many values" ) != 
+                    std::string::npos );
+    CPPUNIT_ASSERT( details.find( "Input: [0, 0, 0, 0]" ) != std::string::npos );
+    return;
+  }
+  CPPUNIT_FAIL( "mismatch not reported" );
+}
+
+
+void 
+DifferentialTestTest::testTolerance()
+{
+  CPPUNIT_NS::DifferentialTest<DifferentialValues, double> differential( 
+      &generateDifferentialValues, &averageReference );
+  differential.addCandidate( "approximate", &averageApproximate );
+  differential.setCaseCount( 100 );
+  differential.setTolerance( 1e-6 );
+  CPPUNIT_ASSERT_DIFFERENTIAL( differential );
+
+  differential.setTolerance( 0 );
+  CPPUNIT_ASSERT_THROW( differential.check(), CPPUNIT_NS::Exception );
+}
+
+
+void 
+DifferentialTestTest::testShrinkIntegers()
+{
+  CppUnitVector<int> candidates;
+  CPPUNIT_NS::TestValueTraits<int>::shrink( 0, candidates );
+  CPPUNIT_ASSERT( candidates.empty() );
+
+  CPPUNIT_NS::TestValueTraits<int>::shrink( -10, candidates );
+  CPPUNIT_ASSERT_EQUAL( 3, int(candidates.size()) );
+  CPPUNIT_ASSERT_EQUAL( 0, candidates[0] );
+  CPPUNIT_ASSERT_EQUAL( -5, candidates[1] );
+  CPPUNIT_ASSERT_EQUAL( -9, candidates[2] );
+
+  CppUnitVector<double> doubles;
+  CPPUNIT_NS::TestValueTraits<double>::shrink( 2.5, doubles );
+  CPPUNIT_ASSERT_EQUAL( 2, int(doubles.size()) );
+  CPPUNIT_ASSERT_EQUAL( 0.0, doubles[0] );
+  CPPUNIT_ASSERT_EQUAL( 2.0, doubles[1] );
+}
+
+
+void 
+DifferentialTestTest::testShrinkVectors()
+{
+  DifferentialValues values;
+  values.push_back( 3 );
+  values.push_back( 8 );
+
+  CppUnitVector<DifferentialValues> candidates;
+  CPPUNIT_NS::TestValueTraits<DifferentialValues>::shrink( values, candidates );
+  CPPUNIT_ASSERT_EQUAL( std::string( "[]" ), 
+                        CPPUNIT_NS::TestValueTraits<DifferentialValues>::toString( candidates[0] ) );
+  CPPUNIT_ASSERT_EQUAL( std::string( "[3]" ), 
+                        CPPUNIT_NS::TestValueTraits<DifferentialValues>::toString( candidates[1] ) );
+  CPPUNIT_ASSERT_EQUAL( std::string( "[8]" ), 
+                        CPPUNIT_NS::TestValueTraits<DifferentialValues>::toString( candidates[2] ) );
+  CPPUNIT_ASSERT_EQUAL( std::string( "[0, 8]" ), 
+                        CPPUNIT_NS::TestValueTraits<DifferentialValues>::toString( candidates[5] ) );
+
+  CppUnitVector<std::string> strings;
+  CPPUNIT_NS::TestValueTraits<std::string>::shrink( "abc", strings );
+  CPPUNIT_ASSERT_EQUAL( std::string( "" ), strings[0] );
+  CPPUNIT_ASSERT_EQUAL( std::string( "a" ), strings[1] );
+  CPPUNIT_ASSERT_EQUAL( std::string( "bc" ), strings[2] );
+  CPPUNIT_ASSERT_EQUAL( std::string( "bc" ), strings[3] );
+  CPPUNIT_ASSERT_EQUAL( std::string( "ac" ), strings[4] );
+}
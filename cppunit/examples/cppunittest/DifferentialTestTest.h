@@ -0,0 +1,50 @@
+#ifndef DIFFERENTIALTESTTEST_H
+#define DIFFERENTIALTESTTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+/*! \class DifferentialTestTest
+ * \brief Unit test for DifferentialTest and TestValueTraits.
+ */
+class DifferentialTestTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( DifferentialTestTest );
+  CPPUNIT_TEST( testMatchingCandidates );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testMismatchIsReported );
+#endif
+  CPPUNIT_TEST( testMismatchIsMinimized );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testSeedReplaysMismatch );
+  CPPUNIT_TEST( testThrowingCandidateIsMismatch );
+  CPPUNIT_TEST( testTolerance );
+#endif
+  CPPUNIT_TEST( testShrinkIntegers );
+  CPPUNIT_TEST( testShrinkVectors );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  DifferentialTestTest();
+  virtual ~DifferentialTestTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testMatchingCandidates();
+  void testMismatchIsReported();
+  void testMismatchIsMinimized();
+  void testSeedReplaysMismatch();
+  void testThrowingCandidateIsMismatch();
+  void testTolerance();
+  void testShrinkIntegers();
+  void testShrinkVectors();
+
+private:
+  DifferentialTestTest( const DifferentialTestTest &copy );
+  void operator =( const DifferentialTestTest &copy );
+};
+
+
+
+#endif  // DIFFERENTIALTESTTEST_H
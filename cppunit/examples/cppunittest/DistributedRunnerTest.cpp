@@ -0,0 +1,443 @@
+#include "ExtensionSuite.h"
+#include "DistributedRunnerTest.h"
+#include <cppunit/TestCase.h>
+#include <cppunit/TestFailure.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/extensions/DistributedRunner.h>
+#include <cppunit/tools/Clock.h>
+#include <cppunit/tools/StringTools.h>
+#include <stdexcept>
+#include <stdio.h>
+
+#if defined(CPPUNIT_HAVE_FORK)  &&  defined(CPPUNIT_HAVE_SYS_WAIT_H)  &&  \
+    defined(CPPUNIT_HAVE_SYS_SOCKET_H)  &&  defined(CPPUNIT_HAVE_POLL)
+
+#include <iostream>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( DistributedRunnerTest,
+                                       extensionSuiteName() );
+
+
+/// Marker file of the test that crashes its worker once.
+static const char *distributedCrashMarker = "DistributedRunnerTest.crashed";
+
+
+/// Test case run by the workers, behaving as specified.
+class DistributedRunnerTestCase : public CPPUNIT_NS::TestCase
+{
+public:
+  enum Behavior
+  {
+    pass,
+    fail,
+    error,
+    crash,
+    crashOnce,
+    nap,
+    sleep
+  };
+
+  DistributedRunnerTestCase( const std::string &name,
+                             Behavior behavior )
+      : CPPUNIT_NS::TestCase( name )
+      , m_behavior( behavior )
+  {
+  }
+
+  void runTest()
+  {
+    switch ( m_behavior )
+    {
+    case fail:
+      CPPUNIT_ASSERT_EQUAL_MESSAGE( "distributed", 1, 2 );
+      break;
+    case error:
+      throw std::runtime_error( "thrown by a worker" );
+    case crash:
+      ::_exit( 3 );
+    case crashOnce:
+      if ( ::access( distributedCrashMarker, F_OK ) != 0 )
+      {
+        FILE *marker = fopen( distributedCrashMarker, "w" );
+        fclose( marker );
+        ::_exit( 3 );
+      }
+      break;
+    case nap:
+      CPPUNIT_NS::Clock::sleepUntil( CPPUNIT_NS::Clock::now() + 0.05 );
+      break;
+    case sleep:
+      CPPUNIT_NS::Clock::sleepUntil( CPPUNIT_NS::Clock::now() + 1 );
+      break;
+    default:
+      break;
+    }
+  }
+
+private:
+  Behavior m_behavior;
+};
+
+
+/// Launcher starting a worker in place of each lost one.
+class DistributedRunnerTestLauncher : public CPPUNIT_NS::DistributedWorkerLauncher
+{
+public:
+  DistributedRunnerTestLauncher( DistributedRunnerTest &test,
+                                 CPPUNIT_NS::DistributedCoordinator &coordinator )
+      : m_test( test )
+      , m_coordinator( coordinator )
+      , m_superviseCount( 0 )
+      , m_replacedCount( 0 )
+  {
+  }
+
+  void superviseWorkers()
+  {
+    ++m_superviseCount;
+    if ( m_replacedCount < int(m_lostIds.size()) )
+    {
+      ++m_replacedCount;
+      m_test.startWorker( m_coordinator, m_test.m_suite );
+    }
+  }
+
+  void workerLost( int processId )
+  {
+    m_lostIds.push_back( processId );
+  }
+
+  DistributedRunnerTest &m_test;
+  CPPUNIT_NS::DistributedCoordinator &m_coordinator;
+  int m_superviseCount;
+  int m_replacedCount;
+  CppUnitVector<int> m_lostIds;
+};
+
+
+DistributedRunnerTest::DistributedRunnerTest()
+{
+}
+
+
+DistributedRunnerTest::~DistributedRunnerTest()
+{
+}
+
+
+void 
+DistributedRunnerTest::setUp()
+{
+  m_suite = new CPPUNIT_NS::TestSuite( "suite" );
+  ::remove( distributedCrashMarker );
+}
+
+
+void 
+DistributedRunnerTest::tearDown()
+{
+  // Kills the workers left by a failed test.
+  for ( unsigned int index =0; index < m_workerIds.size(); ++index )
+    ::kill( m_workerIds[ index ], SIGKILL );
+  waitWorkers();
+  ::remove( distributedCrashMarker );
+  delete m_suite;
+}
+
+
+void 
+DistributedRunnerTest::addTest( const std::string &name,
+                                int behavior )
+{
+  m_suite->addTest( new DistributedRunnerTestCase( name, 
+      DistributedRunnerTestCase::Behavior( behavior ) ) );
+}
+
+
+void 
+DistributedRunnerTest::startWorker( CPPUNIT_NS::DistributedCoordinator &coordinator,
+                                    CPPUNIT_NS::Test *tests )
+{
+  std::cout.flush();
+  fflush( NULL );
+  pid_t workerId = ::fork();
+  CPPUNIT_ASSERT( workerId >= 0 );
+  if ( workerId > 0 )
+  {
+    m_workerIds.push_back( workerId );
+    return;
+  }
+
+  // Worker process: never returns to the test runner.
+  coordinator.releaseSockets();
+  int exitCode = 0;
+  try
+  {
+    CPPUNIT_NS::DistributedWorker worker;
+    worker.addTest( tests );
+    CPPUNIT_NS::TestResult controller;
+    worker.run( "127.0.0.1", coordinator.port(), controller );
+  }
+  catch ( std::runtime_error & )
+  {
+    exitCode = 1;
+  }
+  ::_exit( exitCode );
+}
+
+
+int 
+DistributedRunnerTest::waitWorkers()
+{
+  int failedCount = 0;
+  for ( unsigned int index =0; index < m_workerIds.size(); ++index )
+  {
+    int status = 0;
+    ::waitpid( m_workerIds[ index ], &status, 0 );
+    if ( !WIFEXITED( status )  ||  WEXITSTATUS( status ) != 0 )
+      ++failedCount;
+  }
+  m_workerIds.clear();
+  return failedCount;
+}
+
+
+void 
+DistributedRunnerTest::testPicksFreePort()
+{
+  CPPUNIT_NS::DistributedCoordinator coordinator( 0 );
+  CPPUNIT_ASSERT( coordinator.port() > 0 );
+  CPPUNIT_NS::DistributedCoordinator other( 0 );
+  CPPUNIT_ASSERT( other.port() != coordinator.port() );
+}
+
+
+void 
+DistributedRunnerTest::testResultsAreCollected()
+{
+  addTest( "pass", DistributedRunnerTestCase::pass );
+  addTest( "fail", DistributedRunnerTestCase::fail );
+  addTest( "error", DistributedRunnerTestCase::error );
+  CPPUNIT_NS::DistributedCoordinator coordinator( 0 );
+  coordinator.addTest( m_suite );
+  coordinator.setWorkerWaitTimeout( 10 );
+  CPPUNIT_ASSERT_EQUAL( 3, coordinator.testCount() );
+  startWorker( coordinator, m_suite );
+
+  CPPUNIT_NS::TestResult controller;
+  CPPUNIT_NS::TestResultCollector result;
+  controller.addListener( &result );
+  coordinator.run( controller );
+  CPPUNIT_ASSERT_EQUAL( 0, waitWorkers() );
+
+  CPPUNIT_ASSERT_EQUAL( 1, coordinator.workerCount() );
+  CPPUNIT_ASSERT_EQUAL( 3, result.runTests() );
+  CPPUNIT_ASSERT_EQUAL( 1, result.testFailures() );
+  CPPUNIT_ASSERT_EQUAL( 1, result.testErrors() );
+
+  CPPUNIT_NS::TestFailure *failure = result.failures()[0];
+  CPPUNIT_ASSERT_EQUAL( std::string( "fail" ), failure->failedTestName() );
+  CPPUNIT_ASSERT( !failure->isError() );
+  CPPUNIT_ASSERT_EQUAL( std::string( __FILE__ ), failure->sourceLine().fileName() );
+  CPPUNIT_ASSERT( failure->sourceLine().lineNumber() > 0 );
+  CPPUNIT_ASSERT_EQUAL( std::string( "equality assertion failed" ), 
+                        failure->thrownException()->message().shortDescription() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "Expected: 1" ), 
+                        failure->thrownException()->message().detailAt( 0 ) );
+
+  CPPUNIT_NS::TestFailure *errorFailure = result.failures()[1];
+  CPPUNIT_ASSERT_EQUAL( std::string( "error" ), errorFailure->failedTestName() );
+  CPPUNIT_ASSERT( errorFailure->isError() );
+  CPPUNIT_ASSERT( errorFailure->thrownException()->what() != std::string() );
+}
+
+
+void 
+DistributedRunnerTest::testTestsAreSpreadOnWorkers()
+{
+  // Long enough for every worker to connect before the run ends.
+  for ( int index =0; index < 12; ++index )
+    addTest( "test" + CPPUNIT_NS::StringTools::toString( index ), 
+             DistributedRunnerTestCase::nap );
+  CPPUNIT_NS::DistributedCoordinator coordinator( 0 );
+  coordinator.addTest( m_suite );
+  coordinator.setWorkerWaitTimeout( 10 );
+  startWorker( coordinator, m_suite );
+  startWorker( coordinator, m_suite );
+  startWorker( coordinator, m_suite );
+
+  CPPUNIT_NS::TestResult controller;
+  CPPUNIT_NS::TestResultCollector result;
+  controller.addListener( &result );
+  coordinator.run( controller );
+  CPPUNIT_ASSERT_EQUAL( 0, waitWorkers() );
+
+  CPPUNIT_ASSERT_EQUAL( 12, result.runTests() );
+  CPPUNIT_ASSERT( result.wasSuccessful() );
+  CPPUNIT_ASSERT_EQUAL( 3, coordinator.workerCount() );
+  CPPUNIT_ASSERT_EQUAL( 0, coordinator.reassignedCount() );
+}
+
+
+void 
+DistributedRunnerTest::testTestOfLostWorkerIsReassigned()
+{
+  addTest( "crashOnce", DistributedRunnerTestCase::crashOnce );
+  addTest( "pass", DistributedRunnerTestCase::pass );
+  CPPUNIT_NS::DistributedCoordinator coordinator( 0 );
+  coordinator.addTest( m_suite );
+  coordinator.setWorkerWaitTimeout( 10 );
+  startWorker( coordinator, m_suite );
+  startWorker( coordinator, m_suite );
+
+  CPPUNIT_NS::TestResult controller;
+  CPPUNIT_NS::TestResultCollector result;
+  controller.addListener( &result );
+  coordinator.run( controller );
+
+  CPPUNIT_ASSERT_EQUAL( 1, waitWorkers() );
+  CPPUNIT_ASSERT_EQUAL( 2, result.runTests() );
+  CPPUNIT_ASSERT( result.wasSuccessful() );
+  CPPUNIT_ASSERT_EQUAL( 1, coordinator.reassignedCount() );
+}
+
+
+void 
+DistributedRunnerTest::testMaximumAttempts()
+{
+  // Whichever worker runs the crashing test, both are needed.
+  addTest( "pass", DistributedRunnerTestCase::pass );
+  addTest( "crash", DistributedRunnerTestCase::crash );
+  CPPUNIT_NS::DistributedCoordinator coordinator( 0 );
+  coordinator.addTest( m_suite );
+  coordinator.setMaximumAttempts( 2 );
+  coordinator.setWorkerWaitTimeout( 10 );
+  startWorker( coordinator, m_suite );
+  startWorker( coordinator, m_suite );
+
+  CPPUNIT_NS::TestResult controller;
+  CPPUNIT_NS::TestResultCollector result;
+  controller.addListener( &result );
+  coordinator.run( controller );
+
+  CPPUNIT_ASSERT_EQUAL( 2, waitWorkers() );
+  CPPUNIT_ASSERT_EQUAL( 2, result.runTests() );
+  CPPUNIT_ASSERT_EQUAL( 1, result.testErrors() );
+  CPPUNIT_ASSERT_EQUAL( 1, coordinator.reassignedCount() );
+
+  CPPUNIT_NS::TestFailure *failure = result.failures()[0];
+  CPPUNIT_ASSERT_EQUAL( std::string( "crash" ), failure->failedTestName() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "connection to the worker lost (2 attempts)" ), 
+                        failure->thrownException()->message().detailAt( 0 ) );
+}
+
+
+void 
+DistributedRunnerTest::testTestTimeout()
+{
+  addTest( "sleep", DistributedRunnerTestCase::sleep );
+  CPPUNIT_NS::DistributedCoordinator coordinator( 0 );
+  coordinator.addTest( m_suite );
+  coordinator.setTestTimeout( 0.2 );
+  coordinator.setMaximumAttempts( 1 );
+  coordinator.setWorkerWaitTimeout( 10 );
+  startWorker( coordinator, m_suite );
+
+  CPPUNIT_NS::TestResult controller;
+  CPPUNIT_NS::TestResultCollector result;
+  controller.addListener( &result );
+  double startTime = CPPUNIT_NS::Clock::now();
+  coordinator.run( controller );
+  CPPUNIT_ASSERT( CPPUNIT_NS::Clock::now() - startTime < 0.9 );
+
+  // The worker is told why it has to stop.
+  CPPUNIT_ASSERT_EQUAL( 1, waitWorkers() );
+  CPPUNIT_ASSERT_EQUAL( 1, result.testErrors() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "test timed out on the worker (1 attempts)" ), 
+                        result.failures()[0]->thrownException()->message().detailAt( 0 ) );
+}
+
+
+void 
+DistributedRunnerTest::testWorkerWithOtherTestsIsRejected()
+{
+  addTest( "pass", DistributedRunnerTestCase::pass );
+  CPPUNIT_NS::TestSuite otherSuite( "other" );
+  otherSuite.addTest( new DistributedRunnerTestCase( "pass", 
+                                                     DistributedRunnerTestCase::pass ) );
+  otherSuite.addTest( new DistributedRunnerTestCase( "other", 
+                                                     DistributedRunnerTestCase::pass ) );
+  CPPUNIT_NS::DistributedCoordinator coordinator( 0 );
+  coordinator.addTest( m_suite );
+  coordinator.setWorkerWaitTimeout( 0.5 );
+  startWorker( coordinator, &otherSuite );
+
+  CPPUNIT_NS::TestResult controller;
+  CPPUNIT_NS::TestResultCollector result;
+  controller.addListener( &result );
+  coordinator.run( controller );
+
+  CPPUNIT_ASSERT_EQUAL( 1, waitWorkers() );
+  CPPUNIT_ASSERT_EQUAL( 0, coordinator.workerCount() );
+  CPPUNIT_ASSERT_EQUAL( 1, result.testErrors() );
+}
+
+
+void 
+DistributedRunnerTest::testNoWorkerTimeout()
+{
+  addTest( "pass", DistributedRunnerTestCase::pass );
+  addTest( "fail", DistributedRunnerTestCase::fail );
+  CPPUNIT_NS::DistributedCoordinator coordinator( 0 );
+  coordinator.addTest( m_suite );
+  coordinator.setWorkerWaitTimeout( 0.2 );
+
+  CPPUNIT_NS::TestResult controller;
+  CPPUNIT_NS::TestResultCollector result;
+  controller.addListener( &result );
+  coordinator.run( controller );
+
+  CPPUNIT_ASSERT_EQUAL( 2, result.runTests() );
+  CPPUNIT_ASSERT_EQUAL( 2, result.testErrors() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "test not run by a worker" ), 
+                        result.failures()[1]->thrownException()->message().shortDescription() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "no worker connected" ), 
+                        result.failures()[1]->thrownException()->message().detailAt( 0 ) );
+}
+
+
+
+void 
+DistributedRunnerTest::testLauncherReplacesLostWorker()
+{
+  addTest( "crashOnce", DistributedRunnerTestCase::crashOnce );
+  addTest( "pass", DistributedRunnerTestCase::pass );
+  CPPUNIT_NS::DistributedCoordinator coordinator( 0 );
+  coordinator.addTest( m_suite );
+  coordinator.setWorkerWaitTimeout( 10 );
+  DistributedRunnerTestLauncher launcher( *this, coordinator );
+  coordinator.setWorkerLauncher( &launcher );
+  startWorker( coordinator, m_suite );
+  int crashedWorkerId = m_workerIds[0];
+
+  CPPUNIT_NS::TestResult controller;
+  CPPUNIT_NS::TestResultCollector result;
+  controller.addListener( &result );
+  double startTime = CPPUNIT_NS::Clock::now();
+  coordinator.run( controller );
+  CPPUNIT_ASSERT( CPPUNIT_NS::Clock::now() - startTime < 5 );
+
+  CPPUNIT_ASSERT_EQUAL( 1, waitWorkers() );
+  CPPUNIT_ASSERT_EQUAL( 2, result.runTests() );
+  CPPUNIT_ASSERT( result.wasSuccessful() );
+  CPPUNIT_ASSERT( launcher.m_superviseCount > 0 );
+  CPPUNIT_ASSERT_EQUAL( 1, int(launcher.m_lostIds.size()) );
+  CPPUNIT_ASSERT_EQUAL( crashedWorkerId, launcher.m_lostIds[0] );
+}
+
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef DISTRIBUTEDRUNNERTEST_H
+#define DISTRIBUTEDRUNNERTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestSuite.h>
+
+#if defined(CPPUNIT_HAVE_FORK)  &&  defined(CPPUNIT_HAVE_SYS_WAIT_H)  &&  \
+    defined(CPPUNIT_HAVE_SYS_SOCKET_H)  &&  defined(CPPUNIT_HAVE_POLL)
+
+#include <cppunit/portability/CppUnitVector.h>
+
+CPPUNIT_NS_BEGIN
+class DistributedCoordinator;
+CPPUNIT_NS_END
+
+
+/*! \class DistributedRunnerTest
+ * \brief Unit test for DistributedCoordinator and DistributedWorker.
+ *
+ * The workers are forked processes connecting to the coordinator on the
+ * loopback interface.
+ */
+class DistributedRunnerTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( DistributedRunnerTest );
+  CPPUNIT_TEST( testPicksFreePort );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testResultsAreCollected );
+#endif
+  CPPUNIT_TEST( testTestsAreSpreadOnWorkers );
+  CPPUNIT_TEST( testTestOfLostWorkerIsReassigned );
+  CPPUNIT_TEST( testMaximumAttempts );
+  CPPUNIT_TEST( testTestTimeout );
+  CPPUNIT_TEST( testWorkerWithOtherTestsIsRejected );
+  CPPUNIT_TEST( testNoWorkerTimeout );
+  CPPUNIT_TEST( testLauncherReplacesLostWorker );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  DistributedRunnerTest();
+  virtual ~DistributedRunnerTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testPicksFreePort();
+  void testResultsAreCollected();
+  void testTestsAreSpreadOnWorkers();
+  void testTestOfLostWorkerIsReassigned();
+  void testMaximumAttempts();
+  void testTestTimeout();
+  void testWorkerWithOtherTestsIsRejected();
+  void testNoWorkerTimeout();
+  void testLauncherReplacesLostWorker();
+
+private:
+  friend class DistributedRunnerTestLauncher;
+
+  DistributedRunnerTest( const DistributedRunnerTest &copy );
+  void operator =( const DistributedRunnerTest &copy );
+
+  /// Adds a test case behaving as specified to the suite.
+  void addTest( const std::string &name,
+                int behavior );
+
+  /// Forks a worker process running the tests of \a tests.
+  void startWorker( CPPUNIT_NS::DistributedCoordinator &coordinator,
+                    CPPUNIT_NS::Test *tests );
+
+  /// Waits for the workers, returns the number that exited with an error.
+  int waitWorkers();
+
+private:
+  CPPUNIT_NS::TestSuite *m_suite;
+  CppUnitVector<int> m_workerIds;
+};
+
+
+#endif
+
+#endif  // DISTRIBUTEDRUNNERTEST_H
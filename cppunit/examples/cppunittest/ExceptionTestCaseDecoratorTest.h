@@ -17,7 +17,9 @@
 class ExceptionTestCaseDecoratorTest : public CPPUNIT_NS::TestFixture
 {
   CPPUNIT_TEST_SUITE( ExceptionTestCaseDecoratorTest );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST( testNoExceptionThrownFailed );
+#endif
   CPPUNIT_TEST( testExceptionThrownPass );
   CPPUNIT_TEST_SUITE_END();
 
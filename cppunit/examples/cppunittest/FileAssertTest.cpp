@@ -0,0 +1,233 @@
+#include "ExtensionSuite.h"
+#include "FileAssertTest.h"
+#include <stdio.h>
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( FileAssertTest,
+                                       extensionSuiteName() );
+
+
+/// Files compared by the tests.
+static const char *fileAssertTestExpected = "fileasserttest-expected.txt";
+static const char *fileAssertTestActual = "fileasserttest-actual.txt";
+
+
+/// Writes \a content to the file \a path.
+static void
+writeFileAssertTestFile( const char *path, 
+                         const std::string &content )
+{
+  FILE *file = fopen( path, "wb" );
+  CPPUNIT_ASSERT( file != NULL );
+  fwrite( content.data(), 1, content.size(), file );
+  fclose( file );
+}
+
+
+FileAssertTest::FileAssertTest()
+{
+}
+
+
+FileAssertTest::~FileAssertTest()
+{
+}
+
+
+void 
+FileAssertTest::setUp()
+{
+}
+
+
+void 
+FileAssertTest::tearDown()
+{
+  remove( fileAssertTestExpected );
+  remove( fileAssertTestActual );
+}
+
+
+void 
+FileAssertTest::writeFiles( const std::string &expected, 
+                            const std::string &actual )
+{
+  writeFileAssertTestFile( fileAssertTestExpected, expected );
+  writeFileAssertTestFile( fileAssertTestActual, actual );
+}
+
+
+std::string 
+FileAssertTest::compareBytes( size_t chunkSize )
+{
+  CPPUNIT_NS::Message failure;
+  CPPUNIT_ASSERT( !CPPUNIT_NS::FileComparator( chunkSize ).compareBytes( 
+                      fileAssertTestExpected, fileAssertTestActual, failure ) );
+  CPPUNIT_ASSERT_EQUAL( std::string("files differ"), failure.shortDescription() );
+  return failure.details();
+}
+
+
+std::string 
+FileAssertTest::compareLines( size_t chunkSize )
+{
+  CPPUNIT_NS::Message failure;
+  CPPUNIT_ASSERT( !CPPUNIT_NS::FileComparator( chunkSize ).compareLines( 
+                      fileAssertTestExpected, fileAssertTestActual, failure ) );
+  CPPUNIT_ASSERT_EQUAL( std::string("files differ"), failure.shortDescription() );
+  return failure.details();
+}
+
+
+void 
+FileAssertTest::testEqualFiles()
+{
+  std::string content;
+  for ( int index =0; index < 1000; ++index )
+    content += "row,of,values\n";
+  writeFiles( content, content );
+
+  CPPUNIT_NS::Message failure;
+  for ( size_t chunkSize = 1; chunkSize < 100000; chunkSize *= 7 )
+  {
+    CPPUNIT_NS::FileComparator comparator( chunkSize );
+    CPPUNIT_ASSERT( comparator.compareBytes( fileAssertTestExpected, 
+                                             fileAssertTestActual, 
+                                             failure ) );
+    CPPUNIT_ASSERT( comparator.compareLines( fileAssertTestExpected, 
+                                             fileAssertTestActual, 
+                                             failure ) );
+  }
+}
+
+
+void 
+FileAssertTest::testEmptyFiles()
+{
+  writeFiles( "", "" );
+
+  CPPUNIT_NS::Message failure;
+  CPPUNIT_ASSERT( CPPUNIT_NS::FileComparator().compareBytes( 
+                      fileAssertTestExpected, fileAssertTestActual, failure ) );
+}
+
+
+void 
+FileAssertTest::testSizeMismatchFailsWithoutReading()
+{
+  writeFiles( "abc", "abcd" );
+
+  std::string details = compareBytes( 8 );
+  CPPUNIT_ASSERT( details.find( "Expected 3 bytes, actual 4 bytes" ) != 
+                  std::string::npos );
+  CPPUNIT_ASSERT( details.find( "First difference" ) == std::string::npos );
+}
+
+
+void 
+FileAssertTest::testByteDifference()
+{
+  std::string expected( "0123456789abcdefghijklmnopqrstuvwxyz0123456789" );
+  std::string actual( expected );
+  actual[ 20 ] = '\n';
+  writeFiles( expected, actual );
+
+  std::string details = compareBytes( 64 );
+  CPPUNIT_ASSERT( details.find( "First difference at byte 20" ) != 
+                  std::string::npos );
+  CPPUNIT_ASSERT( details.find( "Expected: \"456789abcdefghijklmnopqrstuvwxyz\"" ) != 
+                  std::string::npos );
+  CPPUNIT_ASSERT( details.find( "Actual:   \"456789abcdefghij\\nlmnopqrstuvwxyz\"" ) != 
+                  std::string::npos );
+
+  // Only the previous and the current chunks are kept in memory.
+  details = compareBytes( 8 );
+  CPPUNIT_ASSERT( details.find( "First difference at byte 20" ) != 
+                  std::string::npos );
+  CPPUNIT_ASSERT( details.find( "Expected: \"89abcdefghijklmn\"" ) != 
+                  std::string::npos );
+}
+
+
+void 
+FileAssertTest::testLineDifference()
+{
+  writeFiles( "one\ntwo\nthree\nfour\nfive\n", 
+              "one\ntwo\nthree\nfOur\nfive\n" );
+
+  std::string details = compareLines( 64 );
+  CPPUNIT_ASSERT( details.find( "First difference at line 4, column 2 (byte 15)" ) != 
+                  std::string::npos );
+  CPPUNIT_ASSERT( details.find( "Line 2: two" ) != std::string::npos );
+  CPPUNIT_ASSERT( details.find( "Line 3: three" ) != std::string::npos );
+  CPPUNIT_ASSERT( details.find( "Line 1:" ) == std::string::npos );
+  CPPUNIT_ASSERT( details.find( "Expected line 4: four" ) != std::string::npos );
+  CPPUNIT_ASSERT( details.find( "Actual   line 4: fOur" ) != std::string::npos );
+
+  details = compareLines( 8 );
+  CPPUNIT_ASSERT( details.find( "First difference at line 4, column 2 (byte 15)" ) != 
+                  std::string::npos );
+  CPPUNIT_ASSERT( details.find( "Line 3: three" ) != std::string::npos );
+}
+
+
+void 
+FileAssertTest::testLineDifferenceAfterShorterFile()
+{
+  writeFiles( "one\ntwo\nthree\n", "one\ntwo\n" );
+
+  std::string details = compareLines( 64 );
+  CPPUNIT_ASSERT( details.find( "Expected 14 bytes, actual 8 bytes" ) != 
+                  std::string::npos );
+  CPPUNIT_ASSERT( details.find( "First difference at line 3, column 1" ) != 
+                  std::string::npos );
+  CPPUNIT_ASSERT( details.find( "Line 2: two" ) != std::string::npos );
+  CPPUNIT_ASSERT( details.find( "Expected line 3: three" ) != std::string::npos );
+
+  // The previous chunk ends exactly at the start of line 2.
+  details = compareLines( 4 );
+  CPPUNIT_ASSERT( details.find( "First difference at line 3, column 1" ) != 
+                  std::string::npos );
+  CPPUNIT_ASSERT( details.find( "Line 2: two" ) != std::string::npos );
+}
+
+
+void 
+FileAssertTest::testLongLinesAreTruncated()
+{
+  std::string expected( 1000, 'a' );
+  std::string actual( expected );
+  actual[ 900 ] = 'b';
+  writeFiles( expected, actual );
+
+  std::string details = compareLines( 4096 );
+  CPPUNIT_ASSERT( details.find( "line 1, column 901" ) != std::string::npos );
+  CPPUNIT_ASSERT( details.find( std::string( 120, 'a' ) + "..." ) != 
+                  std::string::npos );
+  CPPUNIT_ASSERT( details.size() < 1000 );
+}
+
+
+void 
+FileAssertTest::testMissingFile()
+{
+  writeFileAssertTestFile( fileAssertTestExpected, "content" );
+
+  std::string details = compareBytes( 8 );
+  CPPUNIT_ASSERT( details.find( fileAssertTestActual ) != std::string::npos );
+}
+
+
+void 
+FileAssertTest::testFilesEqualMacros()
+{
+  writeFiles( "same\n", "same\n" );
+  CPPUNIT_ASSERT_FILES_EQUAL( fileAssertTestExpected, fileAssertTestActual );
+  CPPUNIT_ASSERT_FILE_LINES_EQUAL( fileAssertTestExpected, fileAssertTestActual );
+
+  writeFiles( "same\n", "diff\n" );
+  CPPUNIT_ASSERT_ASSERTION_FAIL( 
+      CPPUNIT_ASSERT_FILES_EQUAL( fileAssertTestExpected, fileAssertTestActual ) );
+  CPPUNIT_ASSERT_ASSERTION_FAIL( 
+      CPPUNIT_ASSERT_FILE_LINES_EQUAL( fileAssertTestExpected, fileAssertTestActual ) );
+}
@@ -0,0 +1,58 @@
+#ifndef FILEASSERTTEST_H
+#define FILEASSERTTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/FileAssert.h>
+
+
+/*! \class FileAssertTest
+ * \brief Unit test for FileComparator and CPPUNIT_ASSERT_FILES_EQUAL.
+ */
+class FileAssertTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( FileAssertTest );
+  CPPUNIT_TEST( testEqualFiles );
+  CPPUNIT_TEST( testEmptyFiles );
+  CPPUNIT_TEST( testSizeMismatchFailsWithoutReading );
+  CPPUNIT_TEST( testByteDifference );
+  CPPUNIT_TEST( testLineDifference );
+  CPPUNIT_TEST( testLineDifferenceAfterShorterFile );
+  CPPUNIT_TEST( testLongLinesAreTruncated );
+  CPPUNIT_TEST( testMissingFile );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testFilesEqualMacros );
+#endif
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  FileAssertTest();
+  virtual ~FileAssertTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testEqualFiles();
+  void testEmptyFiles();
+  void testSizeMismatchFailsWithoutReading();
+  void testByteDifference();
+  void testLineDifference();
+  void testLineDifferenceAfterShorterFile();
+  void testLongLinesAreTruncated();
+  void testMissingFile();
+  void testFilesEqualMacros();
+
+private:
+  FileAssertTest( const FileAssertTest &copy );
+  void operator =( const FileAssertTest &copy );
+
+  void writeFiles( const std::string &expected, 
+                   const std::string &actual );
+
+  std::string compareBytes( size_t chunkSize );
+
+  std::string compareLines( size_t chunkSize );
+};
+
+
+
+#endif  // FILEASSERTTEST_H
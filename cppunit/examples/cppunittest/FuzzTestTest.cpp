@@ -0,0 +1,329 @@
+#include "ExtensionSuite.h"
+#include "FuzzTestTest.h"
+#include <cppunit/TestFailure.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestListener.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/extensions/DeathTest.h>
+#include <cppunit/tools/MappedFile.h>
+#include <stdexcept>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( FuzzTestTest,
+                                       extensionSuiteName() );
+
+
+/// Corpus directory used by the tests.
+static const char *fuzzTestTestCorpus = "fuzztesttest-corpus";
+
+
+/// Fuzz target that fails on inputs starting with "bug" or "err".
+class FuzzTestTestFixture : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( FuzzTestTestFixture );
+  CPPUNIT_FUZZ_TEST_CORPUS( testParse, fuzzTestTestCorpus );
+  CPPUNIT_TEST_SUITE_END();
+public:
+  void testParse( const unsigned char *data, size_t size )
+  {
+    std::string input( (const char *)data, size );
+    CPPUNIT_ASSERT_MESSAGE( "bug found", input.substr( 0, 3 ) != "bug" );
+    if ( input.substr( 0, 3 ) == "err" )
+      throw std::runtime_error( "parse error" );
+  }
+};
+
+
+/// Checks that each failure is reported while its test is running.
+class FuzzTestTestListener : public CPPUNIT_NS::TestListener
+{
+public:
+  FuzzTestTestListener()
+      : m_startCount( 0 )
+      , m_runningTest( NULL )
+      , m_isConsistent( true )
+  {
+  }
+
+  void startTest( CPPUNIT_NS::Test *test )
+  {
+    ++m_startCount;
+    if ( m_runningTest != NULL )
+      m_isConsistent = false;
+    m_runningTest = test;
+  }
+
+  void addFailure( const CPPUNIT_NS::TestFailure &failure )
+  {
+    if ( failure.failedTest() != m_runningTest )
+      m_isConsistent = false;
+  }
+
+  void endTest( CPPUNIT_NS::Test *test )
+  {
+    if ( test != m_runningTest )
+      m_isConsistent = false;
+    m_runningTest = NULL;
+  }
+
+  int m_startCount;
+  CPPUNIT_NS::Test *m_runningTest;
+  bool m_isConsistent;
+};
+
+
+/// Runs an input in a pending input, then crashes.
+static void
+crashFuzzTestTest( const CPPUNIT_NS::FuzzTest &test, 
+                   const std::string &input )
+{
+  CPPUNIT_NS::FuzzPendingInput pendingInput( test );
+  pendingInput.start( (const unsigned char *)input.data(), input.size() );
+  abort();
+}
+
+
+FuzzTestTest::FuzzTestTest()
+{
+}
+
+
+FuzzTestTest::~FuzzTestTest()
+{
+}
+
+
+void 
+FuzzTestTest::setUp()
+{
+}
+
+
+void 
+FuzzTestTest::tearDown()
+{
+  for ( unsigned int index =0; index < m_savedPaths.size(); ++index )
+    remove( m_savedPaths[ index ].c_str() );
+  remove( fuzzTestTestCorpus );
+  m_savedPaths.clear();
+}
+
+
+void 
+FuzzTestTest::saveInput( const std::string &input )
+{
+  CPPUNIT_NS::FuzzTestCaller<FuzzTestTestFixture> test( 
+      "FuzzTestTestFixture::testParse",
+      &FuzzTestTestFixture::testParse,
+      fuzzTestTestCorpus );
+  m_savedPaths.push_back( test.saveInput( (const unsigned char *)input.data(), 
+                                          input.size() ) );
+}
+
+
+void 
+FuzzTestTest::testDefaultCorpusDirectory()
+{
+  std::string directory = 
+      CPPUNIT_NS::FuzzTest::defaultCorpusDirectory( "ParserTest::testParse" );
+  std::string expectedEnd( "/ParserTest.testParse" );
+  CPPUNIT_ASSERT( directory.size() > expectedEnd.size() );
+  CPPUNIT_ASSERT_EQUAL( expectedEnd, 
+                        directory.substr( directory.size() - expectedEnd.size() ) );
+}
+
+
+void 
+FuzzTestTest::testMissingCorpusIsEmpty()
+{
+  CPPUNIT_NS::FuzzTestCaller<FuzzTestTestFixture> test( 
+      "FuzzTestTestFixture::testParse",
+      &FuzzTestTestFixture::testParse,
+      fuzzTestTestCorpus );
+  CPPUNIT_ASSERT_EQUAL( 0, test.getChildTestCount() );
+
+  CPPUNIT_NS::TestResult controller;
+  CPPUNIT_NS::TestResultCollector result;
+  controller.addListener( &result );
+  test.run( &controller );
+  CPPUNIT_ASSERT_EQUAL( 0, result.runTests() );
+}
+
+
+void 
+FuzzTestTest::testSaveInput()
+{
+  saveInput( std::string( "\0\1\2", 3 ) );
+  saveInput( std::string( "\0\1\2", 3 ) );
+  saveInput( "other" );
+
+  CPPUNIT_ASSERT_EQUAL( m_savedPaths[0], m_savedPaths[1] );
+  CPPUNIT_ASSERT( m_savedPaths[0] != m_savedPaths[2] );
+  std::string prefix = std::string( fuzzTestTestCorpus ) + "/crash-";
+  CPPUNIT_ASSERT_EQUAL( prefix, m_savedPaths[0].substr( 0, prefix.size() ) );
+
+  CPPUNIT_NS::MappedFile file( m_savedPaths[0] );
+  CPPUNIT_ASSERT( std::string( "\0\1\2", 3 ) == 
+                  std::string( (const char *)file.data(), file.size() ) );
+}
+
+
+void 
+FuzzTestTest::testReplayCorpus()
+{
+  saveInput( "ok" );
+  saveInput( "bug" );
+  saveInput( "err" );
+  saveInput( "fine" );
+
+  CPPUNIT_NS::FuzzTestCaller<FuzzTestTestFixture> test( 
+      "FuzzTestTestFixture::testParse",
+      &FuzzTestTestFixture::testParse,
+      fuzzTestTestCorpus );
+  test.setThreadCount( 3 );
+  CPPUNIT_ASSERT_EQUAL( 4, test.getChildTestCount() );
+  CPPUNIT_ASSERT_EQUAL( 4, test.countTestCases() );
+
+  CPPUNIT_NS::TestResult controller;
+  CPPUNIT_NS::TestResultCollector result;
+  controller.addListener( &result );
+  test.run( &controller );
+
+  CPPUNIT_ASSERT_EQUAL( 4, result.runTests() );
+  CPPUNIT_ASSERT_EQUAL( 2, result.testFailuresTotal() );
+  CPPUNIT_ASSERT_EQUAL( 1, result.testErrors() );
+  CPPUNIT_ASSERT_EQUAL( 1, result.testFailures() );
+  for ( int index =0; index < 2; ++index )
+  {
+    CPPUNIT_NS::TestFailure *failure = result.failures()[ index ];
+    std::string prefix( "FuzzTestTestFixture::testParse[crash-" );
+    CPPUNIT_ASSERT_EQUAL( prefix, failure->failedTestName().substr( 0, prefix.size() ) );
+    std::string details = failure->thrownException()->message().details();
+    if ( failure->isError() )
+      CPPUNIT_ASSERT( details.find( "parse error" ) != std::string::npos );
+    else
+      CPPUNIT_ASSERT( details.find( "bug found" ) != std::string::npos );
+  }
+}
+
+
+void 
+FuzzTestTest::testRunInputAlone()
+{
+  saveInput( "bug" );
+
+  CPPUNIT_NS::FuzzTestCaller<FuzzTestTestFixture> test( 
+      "FuzzTestTestFixture::testParse",
+      &FuzzTestTestFixture::testParse,
+      fuzzTestTestCorpus );
+  CPPUNIT_ASSERT_EQUAL( 1, test.getChildTestCount() );
+
+  CPPUNIT_NS::TestResult controller;
+  CPPUNIT_NS::TestResultCollector result;
+  controller.addListener( &result );
+  test.getChildTestAt( 0 )->run( &controller );
+
+  CPPUNIT_ASSERT_EQUAL( 1, result.runTests() );
+  CPPUNIT_ASSERT_EQUAL( 1, result.testFailures() );
+}
+
+
+void 
+FuzzTestTest::testInputsAreReportedOneByOne()
+{
+  saveInput( "ok" );
+  saveInput( "bug" );
+  saveInput( "fine" );
+
+  CPPUNIT_NS::FuzzTestCaller<FuzzTestTestFixture> test( 
+      "FuzzTestTestFixture::testParse",
+      &FuzzTestTestFixture::testParse,
+      fuzzTestTestCorpus );
+  test.setThreadCount( 1 );
+
+  CPPUNIT_NS::TestResult controller;
+  FuzzTestTestListener listener;
+  controller.addListener( &listener );
+  test.run( &controller );
+
+  CPPUNIT_ASSERT_EQUAL( 3, listener.m_startCount );
+  CPPUNIT_ASSERT( listener.m_isConsistent );
+}
+
+
+void 
+FuzzTestTest::testFinishedPendingInputIsNotSaved()
+{
+  CPPUNIT_NS::FuzzTestCaller<FuzzTestTestFixture> test( 
+      "FuzzTestTestFixture::testParse",
+      &FuzzTestTestFixture::testParse,
+      fuzzTestTestCorpus );
+  std::string path;
+  {
+    CPPUNIT_NS::FuzzPendingInput pendingInput( test );
+    path = pendingInput.path();
+    pendingInput.start( (const unsigned char *)"bug", 3 );
+    pendingInput.finish();
+    // The input of a live process is not saved.
+    pendingInput.start( (const unsigned char *)"bug", 3 );
+    CPPUNIT_ASSERT_EQUAL( 0, CPPUNIT_NS::FuzzPendingInput::recover( test ) );
+  }
+  CPPUNIT_ASSERT( fopen( path.c_str(), "rb" ) == NULL );
+  test.loadCorpus();
+  CPPUNIT_ASSERT_EQUAL( 0, test.getChildTestCount() );
+}
+
+
+void 
+FuzzTestTest::testCrashingInputIsSaved()
+{
+#if defined(CPPUNIT_HAVE_FORK)  &&  defined(CPPUNIT_HAVE_SYS_WAIT_H)  &&  \
+    defined(CPPUNIT_HAVE_UNISTD_H)  &&  defined(CPPUNIT_HAVE_MMAP)
+  CPPUNIT_NS::FuzzTestCaller<FuzzTestTestFixture> test( 
+      "FuzzTestTestFixture::testParse",
+      &FuzzTestTestFixture::testParse,
+      fuzzTestTestCorpus );
+  CPPUNIT_ASSERT_DEATH( crashFuzzTestTest( test, "segfault" ), "" );
+
+  test.loadCorpus();
+  CPPUNIT_ASSERT_EQUAL( 1, test.getChildTestCount() );
+  m_savedPaths.push_back( test.getInputPathAt( 0 ) );
+  CPPUNIT_NS::MappedFile file( test.getInputPathAt( 0 ) );
+  CPPUNIT_ASSERT( std::string( "segfault" ) == 
+                  std::string( (const char *)file.data(), file.size() ) );
+#endif
+}
+
+
+void 
+FuzzTestTest::testFuzzTestsAreListed()
+{
+  int count = CPPUNIT_NS::FuzzTest::getFuzzTests().size();
+  {
+    CPPUNIT_NS::FuzzTestCaller<FuzzTestTestFixture> test( 
+        "FuzzTestTestFixture::testParse",
+        &FuzzTestTestFixture::testParse,
+        fuzzTestTestCorpus );
+    CPPUNIT_ASSERT_EQUAL( count +1, int(CPPUNIT_NS::FuzzTest::getFuzzTests().size()) );
+    CPPUNIT_ASSERT( CPPUNIT_NS::FuzzTest::getFuzzTests().back() == &test );
+  }
+  CPPUNIT_ASSERT_EQUAL( count, int(CPPUNIT_NS::FuzzTest::getFuzzTests().size()) );
+}
+
+
+void 
+FuzzTestTest::testFuzzTestMacro()
+{
+  saveInput( "ok" );
+
+  CPPUNIT_NS::TestSuite *suite = FuzzTestTestFixture::suite();
+  CPPUNIT_NS::Test *test = suite->getChildTestAt( 0 );
+  CPPUNIT_ASSERT_EQUAL( std::string( "FuzzTestTestFixture::testParse" ), 
+                        test->getName() );
+  CPPUNIT_ASSERT_EQUAL( std::string( fuzzTestTestCorpus ), 
+                        test->getProperty( "fuzz-corpus" ) );
+  CPPUNIT_ASSERT_EQUAL( 1, test->getChildTestCount() );
+  delete suite;
+}
@@ -0,0 +1,59 @@
+#ifndef FUZZTESTTEST_H
+#define FUZZTESTTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+/*! \class FuzzTestTest
+ * \brief Unit test for FuzzTest and FuzzTestCaller.
+ */
+class FuzzTestTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( FuzzTestTest );
+  CPPUNIT_TEST( testDefaultCorpusDirectory );
+  CPPUNIT_TEST( testMissingCorpusIsEmpty );
+  CPPUNIT_TEST( testSaveInput );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testReplayCorpus );
+  CPPUNIT_TEST( testRunInputAlone );
+  CPPUNIT_TEST( testInputsAreReportedOneByOne );
+  CPPUNIT_TEST( testFinishedPendingInputIsNotSaved );
+  CPPUNIT_TEST( testCrashingInputIsSaved );
+#endif
+  CPPUNIT_TEST( testFuzzTestsAreListed );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testFuzzTestMacro );
+#endif
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  FuzzTestTest();
+  virtual ~FuzzTestTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testDefaultCorpusDirectory();
+  void testMissingCorpusIsEmpty();
+  void testSaveInput();
+  void testReplayCorpus();
+  void testRunInputAlone();
+  void testInputsAreReportedOneByOne();
+  void testFinishedPendingInputIsNotSaved();
+  void testCrashingInputIsSaved();
+  void testFuzzTestsAreListed();
+  void testFuzzTestMacro();
+
+private:
+  FuzzTestTest( const FuzzTestTest &copy );
+  void operator =( const FuzzTestTest &copy );
+
+  void saveInput( const std::string &input );
+
+private:
+  CppUnitVector<std::string> m_savedPaths;
+};
+
+
+
+#endif  // FUZZTESTTEST_H
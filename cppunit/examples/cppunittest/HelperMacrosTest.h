@@ -10,11 +10,15 @@ class HelperMacrosTest : public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST_SUITE( HelperMacrosTest );
   CPPUNIT_TEST( testNoSubclassing );
   CPPUNIT_TEST( testSubclassing );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST( testFail );
   CPPUNIT_TEST( testFailToFail );
+#endif
   CPPUNIT_TEST( testException );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST( testExceptionNotCaught );
   CPPUNIT_TEST( testCustomTests );
+#endif
   CPPUNIT_TEST( testAddTest );
   CPPUNIT_TEST_SUITE_END();
 
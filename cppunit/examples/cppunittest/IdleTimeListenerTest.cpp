@@ -0,0 +1,157 @@
+#include <cppunit/TestCase.h>
+#include <cppunit/tools/Clock.h>
+#include "CoreSuite.h"
+#include "IdleTimeListenerTest.h"
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( IdleTimeListenerTest,
+                                       coreSuiteName() );
+
+
+IdleTimeListenerTest::IdleTimeListenerTest()
+{
+}
+
+
+IdleTimeListenerTest::~IdleTimeListenerTest()
+{
+}
+
+
+void 
+IdleTimeListenerTest::setUp()
+{
+  m_listener = new CPPUNIT_NS::IdleTimeListener();
+  m_test = new CPPUNIT_NS::TestCase( "waiter" );
+}
+
+
+void 
+IdleTimeListenerTest::tearDown()
+{
+  delete m_test;
+  delete m_listener;
+}
+
+
+void 
+IdleTimeListenerTest::runSleepingTest()
+{
+  m_listener->startTest( m_test );
+  CPPUNIT_NS::Clock::sleepUntil( CPPUNIT_NS::Clock::now() + 0.02 );
+  m_listener->endTest( m_test );
+}
+
+
+void 
+IdleTimeListenerTest::testConstructor()
+{
+  CPPUNIT_ASSERT_EQUAL( 0, m_listener->testCount() );
+  CPPUNIT_ASSERT_EQUAL( 0, m_listener->count( CPPUNIT_NS::idleSleepBound ) );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0, m_listener->totalIdleSeconds(), 1e-12 );
+}
+
+
+void 
+IdleTimeListenerTest::testClassifyCpuBound()
+{
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::idleCpuBound,
+                        m_listener->classify( 1.0, 0.9, 0, 0 ) );
+  // Idle time below the minimum, whatever the ratio.
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::idleCpuBound,
+                        m_listener->classify( 0.0005, 0, 0, 3 ) );
+}
+
+
+void 
+IdleTimeListenerTest::testClassifySleepBound()
+{
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::idleSleepBound,
+                        m_listener->classify( 1.0, 0.1, 0, 0 ) );
+  // Waited on disk I/O for less than half of the idle time.
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::idleSleepBound,
+                        m_listener->classify( 1.0, 0.1, 0.2, 10 ) );
+
+  CPPUNIT_NS::IdleTimeListener strict( 0.95 );
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::idleSleepBound,
+                        strict.classify( 1.0, 0.9, 0, 0 ) );
+}
+
+
+void 
+IdleTimeListenerTest::testClassifyIoBound()
+{
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::idleIoBound,
+                        m_listener->classify( 1.0, 0.1, 0.6, 0 ) );
+  // Without delay accounting, block operations are the evidence.
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::idleIoBound,
+                        m_listener->classify( 1.0, 0.1, 0, 4 ) );
+}
+
+
+void 
+IdleTimeListenerTest::testSleepingTest()
+{
+  runSleepingTest();
+
+  CPPUNIT_ASSERT_EQUAL( 1, m_listener->testCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string("waiter"), m_listener->testNameAt( 0 ) );
+  CPPUNIT_ASSERT( m_listener->wallSecondsAt( 0 ) >= 0.015 );
+  CPPUNIT_ASSERT( m_listener->cpuSecondsAt( 0 ) < m_listener->wallSecondsAt( 0 ) );
+  CPPUNIT_ASSERT( m_listener->idleSecondsAt( 0 ) >= 0.01 );
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::idleSleepBound, m_listener->kindAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( 1, m_listener->count( CPPUNIT_NS::idleSleepBound ) );
+}
+
+
+void 
+IdleTimeListenerTest::testBusyTest()
+{
+  // Lenient ratio: the busy thread may be preempted on a loaded machine.
+  CPPUNIT_NS::IdleTimeListener listener( 0.3, 0.005 );
+  listener.startTest( m_test );
+  double endTime = CPPUNIT_NS::Clock::now() + 0.02;
+  volatile long iterationCount = 0;
+  while ( CPPUNIT_NS::Clock::now() < endTime )
+    ++iterationCount;
+  listener.endTest( m_test );
+
+  CPPUNIT_ASSERT_EQUAL( 1, listener.testCount() );
+  CPPUNIT_ASSERT( listener.cpuSecondsAt( 0 ) > 0 );
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::idleCpuBound, listener.kindAt( 0 ) );
+}
+
+
+void 
+IdleTimeListenerTest::testEndWithoutStart()
+{
+  m_listener->endTest( m_test );
+
+  CPPUNIT_ASSERT_EQUAL( 0, m_listener->testCount() );
+}
+
+
+void 
+IdleTimeListenerTest::testReset()
+{
+  runSleepingTest();
+  m_listener->reset();
+
+  CPPUNIT_ASSERT_EQUAL( 0, m_listener->testCount() );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0, m_listener->totalIdleSeconds(), 1e-12 );
+}
+
+
+void 
+IdleTimeListenerTest::testWrite()
+{
+  runSleepingTest();
+
+  CPPUNIT_NS::OStringStream stream;
+  m_listener->write( stream );
+  std::string text = stream.str();
+
+  CPPUNIT_ASSERT( text.find( "0 CPU-bound, 1 sleep-bound, 0 I/O-bound" ) !=
+                  std::string::npos );
+  CPPUNIT_ASSERT( text.find( "sleep-bound  waiter" ) != std::string::npos );
+}
@@ -0,0 +1,56 @@
+#ifndef IDLETIMELISTENERTEST_H
+#define IDLETIMELISTENERTEST_H
+
+#include <cppunit/IdleTimeListener.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+
+/*! \class IdleTimeListenerTest
+ * \brief Unit test for IdleTimeListener.
+ */
+class IdleTimeListenerTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( IdleTimeListenerTest );
+  CPPUNIT_TEST( testConstructor );
+  CPPUNIT_TEST( testClassifyCpuBound );
+  CPPUNIT_TEST( testClassifySleepBound );
+  CPPUNIT_TEST( testClassifyIoBound );
+  CPPUNIT_TEST( testSleepingTest );
+  CPPUNIT_TEST( testBusyTest );
+  CPPUNIT_TEST( testEndWithoutStart );
+  CPPUNIT_TEST( testReset );
+  CPPUNIT_TEST( testWrite );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  IdleTimeListenerTest();
+  virtual ~IdleTimeListenerTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testConstructor();
+  void testClassifyCpuBound();
+  void testClassifySleepBound();
+  void testClassifyIoBound();
+  void testSleepingTest();
+  void testBusyTest();
+  void testEndWithoutStart();
+  void testReset();
+  void testWrite();
+
+private:
+  IdleTimeListenerTest( const IdleTimeListenerTest &copy );
+  void operator =( const IdleTimeListenerTest &copy );
+
+  /// Runs a test that sleeps for 20 ms through the listener.
+  void runSleepingTest();
+
+private:
+  CPPUNIT_NS::IdleTimeListener *m_listener;
+  CPPUNIT_NS::TestCase *m_test;
+};
+
+
+
+#endif  // IDLETIMELISTENERTEST_H
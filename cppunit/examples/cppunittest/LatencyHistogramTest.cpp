@@ -0,0 +1,160 @@
+#include "ToolsSuite.h"
+#include "LatencyHistogramTest.h"
+#include <cppunit/tools/LatencyHistogram.h>
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( LatencyHistogramTest, 
+                                       toolsSuiteName() );
+
+
+LatencyHistogramTest::LatencyHistogramTest()
+{
+}
+
+
+LatencyHistogramTest::~LatencyHistogramTest()
+{
+}
+
+
+void 
+LatencyHistogramTest::setUp()
+{
+}
+
+
+void 
+LatencyHistogramTest::tearDown()
+{
+}
+
+
+void 
+LatencyHistogramTest::testEmpty()
+{
+  CPPUNIT_NS::LatencyHistogram histogram;
+  CPPUNIT_ASSERT_EQUAL( 0, int(histogram.totalCount()) );
+  CPPUNIT_ASSERT_EQUAL( 0.0, histogram.minimum() );
+  CPPUNIT_ASSERT_EQUAL( 0.0, histogram.maximum() );
+  CPPUNIT_ASSERT_EQUAL( 0.0, histogram.mean() );
+  CPPUNIT_ASSERT_EQUAL( 0.0, histogram.valueAtPercentile( 99 ) );
+}
+
+
+void 
+LatencyHistogramTest::testRecord()
+{
+  CPPUNIT_NS::LatencyHistogram histogram;
+  histogram.record( 0.002 );
+  histogram.record( 0.001 );
+  histogram.record( 0.003 );
+  histogram.record( -1 );
+
+  CPPUNIT_ASSERT_EQUAL( 4, int(histogram.totalCount()) );
+  CPPUNIT_ASSERT_EQUAL( 0.0, histogram.minimum() );
+  CPPUNIT_ASSERT_EQUAL( 0.003, histogram.maximum() );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0015, histogram.mean(), 1e-12 );
+}
+
+
+void 
+LatencyHistogramTest::testPercentiles()
+{
+  CPPUNIT_NS::LatencyHistogram histogram;
+  for ( int index =1; index <= 1000; ++index )
+    histogram.record( index * 1e-6 );   // 1us to 1ms
+
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 500e-6, histogram.valueAtPercentile( 50 ), 
+                                500e-6 / 128 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 990e-6, histogram.valueAtPercentile( 99 ), 
+                                990e-6 / 128 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 1e-6, histogram.valueAtPercentile( 0 ), 
+                                1e-6 / 128 );
+  CPPUNIT_ASSERT_EQUAL( 1000e-6, histogram.valueAtPercentile( 100 ) );
+}
+
+
+void 
+LatencyHistogramTest::testRelativeError()
+{
+  const double values[] = { 3e-9, 127e-9, 1.5e-6, 42e-6, 0.0173, 2.5, 3600 };
+  for ( unsigned int index =0; index < sizeof(values)/sizeof(values[0]); ++index )
+  {
+    CPPUNIT_NS::LatencyHistogram histogram( 10 );
+    histogram.record( values[ index ] );
+    histogram.record( values[ index ] * 4 );  // the maximum must not clamp p50
+    double p50 = histogram.valueAtPercentile( 50 );
+    CPPUNIT_ASSERT( p50 >= values[ index ] );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( values[ index ], p50, 
+                                  values[ index ] / 1024 + 1e-9 );
+  }
+}
+
+
+void 
+LatencyHistogramTest::testBucketBoundsAreContiguous()
+{
+  CPPUNIT_NS::LatencyHistogram histogram( 3 );
+  CPPUNIT_ASSERT_EQUAL( 0.0, histogram.getBucketLowerBoundAt( 0 ) );
+  for ( int index =1; index < histogram.getBucketCount(); ++index )
+  {
+    double upperBound = histogram.getBucketUpperBoundAt( index -1 );
+    double lowerBound = histogram.getBucketLowerBoundAt( index );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( upperBound, lowerBound, upperBound * 1e-12 );
+
+    histogram.reset();
+    histogram.record( lowerBound * 1.000001 );
+    CPPUNIT_ASSERT_EQUAL( 1, int(histogram.getBucketCountAt( index )) );
+  }
+}
+
+
+void 
+LatencyHistogramTest::testHugeLatencyIsClamped()
+{
+  CPPUNIT_NS::LatencyHistogram histogram;
+  histogram.record( 1e9 );
+  int lastBucket = histogram.getBucketCount() -1;
+  CPPUNIT_ASSERT_EQUAL( 1, int(histogram.getBucketCountAt( lastBucket )) );
+  CPPUNIT_ASSERT_EQUAL( 1e9, histogram.maximum() );
+}
+
+
+void 
+LatencyHistogramTest::testMerge()
+{
+  CPPUNIT_NS::LatencyHistogram histogram;
+  histogram.record( 0.002 );
+  CPPUNIT_NS::LatencyHistogram other;
+  other.record( 0.001 );
+  other.record( 0.004 );
+
+  histogram.merge( other );
+  histogram.merge( CPPUNIT_NS::LatencyHistogram() );
+  CPPUNIT_ASSERT_EQUAL( 3, int(histogram.totalCount()) );
+  CPPUNIT_ASSERT_EQUAL( 0.001, histogram.minimum() );
+  CPPUNIT_ASSERT_EQUAL( 0.004, histogram.maximum() );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.007 / 3, histogram.mean(), 1e-12 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.002, histogram.valueAtPercentile( 50 ), 
+                                0.002 / 128 );
+}
+
+
+void 
+LatencyHistogramTest::testMergeDifferentPrecisionThrow()
+{
+  CPPUNIT_NS::LatencyHistogram histogram( 7 );
+  histogram.merge( CPPUNIT_NS::LatencyHistogram( 8 ) );
+}
+
+
+void 
+LatencyHistogramTest::testReset()
+{
+  CPPUNIT_NS::LatencyHistogram histogram;
+  histogram.record( 0.5 );
+  histogram.reset();
+  CPPUNIT_ASSERT_EQUAL( 0, int(histogram.totalCount()) );
+  CPPUNIT_ASSERT_EQUAL( 0.0, histogram.maximum() );
+  CPPUNIT_ASSERT_EQUAL( 0.0, histogram.valueAtPercentile( 50 ) );
+}
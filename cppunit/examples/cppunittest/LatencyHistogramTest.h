@@ -0,0 +1,51 @@
+#ifndef LATENCYHISTOGRAMTEST_H
+#define LATENCYHISTOGRAMTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdexcept>
+
+
+/*! \class LatencyHistogramTest
+ * \brief Unit test for class LatencyHistogram.
+ */
+class LatencyHistogramTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( LatencyHistogramTest );
+  CPPUNIT_TEST( testEmpty );
+  CPPUNIT_TEST( testRecord );
+  CPPUNIT_TEST( testPercentiles );
+  CPPUNIT_TEST( testRelativeError );
+  CPPUNIT_TEST( testBucketBoundsAreContiguous );
+  CPPUNIT_TEST( testHugeLatencyIsClamped );
+  CPPUNIT_TEST( testMerge );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST_EXCEPTION( testMergeDifferentPrecisionThrow, std::invalid_argument );
+#endif
+  CPPUNIT_TEST( testReset );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  LatencyHistogramTest();
+  virtual ~LatencyHistogramTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testEmpty();
+  void testRecord();
+  void testPercentiles();
+  void testRelativeError();
+  void testBucketBoundsAreContiguous();
+  void testHugeLatencyIsClamped();
+  void testMerge();
+  void testMergeDifferentPrecisionThrow();
+  void testReset();
+
+private:
+  LatencyHistogramTest( const LatencyHistogramTest &copy );
+  void operator =( const LatencyHistogramTest &copy );
+};
+
+
+
+#endif  // LATENCYHISTOGRAMTEST_H
@@ -0,0 +1,174 @@
+#include <cppunit/Exception.h>
+#include <cppunit/TestFailure.h>
+#include <cppunit/tools/Clock.h>
+#include <cppunit/tools/MappedFile.h>
+#include <cppunit/tools/ThreadGroup.h>
+#include "CoreSuite.h"
+#include "LiveMetricsListenerTest.h"
+#include <stdio.h>
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( LiveMetricsListenerTest,
+                                       coreSuiteName() );
+
+
+LiveMetricsListenerTest::LiveMetricsListenerTest()
+    : m_path( "livemetricslistenertest.tmp" )
+    , m_textFilePath( "livemetricslistenertest.prom" )
+{
+}
+
+
+LiveMetricsListenerTest::~LiveMetricsListenerTest()
+{
+}
+
+
+void 
+LiveMetricsListenerTest::setUp()
+{
+  remove( m_path.c_str() );
+  m_segment = new CPPUNIT_NS::LiveMetricsSegment( m_path, true );
+  m_test = new CPPUNIT_NS::TestCase( "soak" );
+}
+
+
+void 
+LiveMetricsListenerTest::tearDown()
+{
+  delete m_test;
+  delete m_segment;
+  remove( m_path.c_str() );
+  remove( m_textFilePath.c_str() );
+}
+
+
+std::string 
+LiveMetricsListenerTest::readTextFile() const
+{
+  CPPUNIT_NS::MappedFile file( m_textFilePath );
+  return std::string( (const char *)file.data(), file.size() );
+}
+
+
+void 
+LiveMetricsListenerTest::testRun()
+{
+  CPPUNIT_NS::LiveMetricsListener listener( *m_segment, 3 );
+  listener.startTestRun( m_test, NULL );
+  CPPUNIT_ASSERT( m_segment->readWorker( 3 ).m_running );
+  CPPUNIT_ASSERT( m_segment->readWorker( 3 ).m_processId != 0 );
+
+  listener.startTest( m_test );
+  CPPUNIT_ASSERT_EQUAL( std::string("soak"), 
+                        m_segment->readWorker( 3 ).m_currentTest );
+  CPPUNIT_NS::TestFailure failure( m_test, new CPPUNIT_NS::Exception(), false );
+  listener.addFailure( failure );
+  CPPUNIT_NS::TestFailure error( m_test, new CPPUNIT_NS::Exception(), true );
+  listener.addFailure( error );
+  listener.endTest( m_test );
+  listener.endTestRun( m_test, NULL );
+
+  CPPUNIT_NS::LiveWorkerMetrics metrics = m_segment->readWorker( 3 );
+  CPPUNIT_ASSERT( !metrics.m_running );
+  CPPUNIT_ASSERT_EQUAL( 1L, metrics.m_startedCount );
+  CPPUNIT_ASSERT_EQUAL( 1L, metrics.m_finishedCount );
+  CPPUNIT_ASSERT_EQUAL( 1L, metrics.m_failureCount );
+  CPPUNIT_ASSERT_EQUAL( 1L, metrics.m_errorCount );
+  CPPUNIT_ASSERT_EQUAL( std::string(""), metrics.m_currentTest );
+  CPPUNIT_ASSERT( metrics.m_updateTime >= metrics.m_startTime );
+  CPPUNIT_ASSERT_EQUAL( 1L, listener.metrics().m_finishedCount );
+}
+
+
+void 
+LiveMetricsListenerTest::testStartTestWithoutRun()
+{
+  CPPUNIT_NS::LiveMetricsListener listener( *m_segment, 0 );
+  listener.startTest( m_test );
+
+  CPPUNIT_NS::LiveWorkerMetrics metrics = m_segment->readWorker( 0 );
+  CPPUNIT_ASSERT( metrics.m_running );
+  CPPUNIT_ASSERT( metrics.m_processId != 0 );
+  CPPUNIT_ASSERT_EQUAL( 1L, metrics.m_startedCount );
+}
+
+
+void 
+LiveMetricsListenerTest::testTextFile()
+{
+  CPPUNIT_NS::LiveMetricsListener listener( *m_segment, 1, m_textFilePath, 3600 );
+  listener.startTestRun( m_test, NULL );
+  CPPUNIT_ASSERT( readTextFile().find( "cppunit_worker_running{worker=\"1\"} 1\n" ) !=
+                  std::string::npos );
+
+  // Within the render interval: the file is not written again.
+  listener.startTest( m_test );
+  listener.endTest( m_test );
+  CPPUNIT_ASSERT( readTextFile().find( "cppunit_tests_finished_total{worker=\"1\"} 0\n" ) !=
+                  std::string::npos );
+
+  listener.endTestRun( m_test, NULL );
+  std::string text = readTextFile();
+  CPPUNIT_ASSERT( text.find( "cppunit_tests_finished_total{worker=\"1\"} 1\n" ) !=
+                  std::string::npos );
+  CPPUNIT_ASSERT( text.find( "cppunit_worker_running{worker=\"1\"} 0\n" ) !=
+                  std::string::npos );
+}
+
+
+void 
+LiveMetricsListenerTest::testTextFileRenderedDuringTest()
+{
+  if ( !CPPUNIT_NS::ThreadGroup::isConcurrent() )
+    return;
+
+  CPPUNIT_NS::LiveMetricsListener listener( *m_segment, 2, m_textFilePath, 0.05 );
+  listener.startTestRun( m_test, NULL );
+  listener.startTest( m_test );
+
+  // The renderer thread writes the file while the test runs.
+  const std::string started( "cppunit_current_test{worker=\"2\",test=\"soak\"} 1\n" );
+  double deadline = CPPUNIT_NS::Clock::now() + 5;
+  while ( readTextFile().find( started ) == std::string::npos  &&
+          CPPUNIT_NS::Clock::now() < deadline )
+    CPPUNIT_NS::Clock::sleepUntil( CPPUNIT_NS::Clock::now() + 0.01 );
+  CPPUNIT_ASSERT( readTextFile().find( started ) != std::string::npos );
+
+  listener.endTest( m_test );
+  listener.endTestRun( m_test, NULL );
+  CPPUNIT_ASSERT( readTextFile().find( "cppunit_worker_running{worker=\"2\"} 0\n" ) !=
+                  std::string::npos );
+}
+
+
+void 
+LiveMetricsListenerTest::testUnwritableTextFile()
+{
+  CPPUNIT_NS::LiveMetricsListener listener( *m_segment, 0, 
+                                            "missing-directory/metrics.prom", 0 );
+  listener.startTestRun( m_test, NULL );
+  listener.startTest( m_test );
+  listener.endTest( m_test );
+  listener.endTestRun( m_test, NULL );
+
+  CPPUNIT_ASSERT_EQUAL( 1L, m_segment->readWorker( 0 ).m_finishedCount );
+}
+
+
+void 
+LiveMetricsListenerTest::testResidentBytes()
+{
+#if defined(__linux__)
+  CPPUNIT_ASSERT( CPPUNIT_NS::LiveMetricsListener::residentBytes() > 0 );
+#else
+  CPPUNIT_ASSERT( CPPUNIT_NS::LiveMetricsListener::residentBytes() >= 0 );
+#endif
+}
+
+
+void 
+LiveMetricsListenerTest::testInvalidWorkerIndexThrow()
+{
+  CPPUNIT_NS::LiveMetricsListener listener( *m_segment, -1 );
+}
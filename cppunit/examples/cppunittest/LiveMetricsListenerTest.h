@@ -0,0 +1,58 @@
+#ifndef LIVEMETRICSLISTENERTEST_H
+#define LIVEMETRICSLISTENERTEST_H
+
+#include <cppunit/LiveMetricsListener.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdexcept>
+
+
+/*! \class LiveMetricsListenerTest
+ * \brief Unit test for LiveMetricsListener.
+ */
+class LiveMetricsListenerTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( LiveMetricsListenerTest );
+  CPPUNIT_TEST( testRun );
+  CPPUNIT_TEST( testStartTestWithoutRun );
+  CPPUNIT_TEST( testTextFile );
+  CPPUNIT_TEST( testTextFileRenderedDuringTest );
+  CPPUNIT_TEST( testUnwritableTextFile );
+  CPPUNIT_TEST( testResidentBytes );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST_EXCEPTION( testInvalidWorkerIndexThrow, std::invalid_argument );
+#endif
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  LiveMetricsListenerTest();
+  virtual ~LiveMetricsListenerTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testRun();
+  void testStartTestWithoutRun();
+  void testTextFile();
+  void testTextFileRenderedDuringTest();
+  void testUnwritableTextFile();
+  void testResidentBytes();
+  void testInvalidWorkerIndexThrow();
+
+private:
+  LiveMetricsListenerTest( const LiveMetricsListenerTest &copy );
+  void operator =( const LiveMetricsListenerTest &copy );
+
+  /// Returns the content of the Prometheus text file.
+  std::string readTextFile() const;
+
+private:
+  std::string m_path;
+  std::string m_textFilePath;
+  CPPUNIT_NS::LiveMetricsSegment *m_segment;
+  CPPUNIT_NS::TestCase *m_test;
+};
+
+
+
+#endif  // LIVEMETRICSLISTENERTEST_H
@@ -0,0 +1,201 @@
+#include "ToolsSuite.h"
+#include "LiveMetricsSegmentTest.h"
+#include <cppunit/tools/LiveMetricsSegment.h>
+#include <cppunit/tools/MappedFile.h>
+#include <stdio.h>
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( LiveMetricsSegmentTest, 
+                                       toolsSuiteName() );
+
+
+LiveMetricsSegmentTest::LiveMetricsSegmentTest()
+    : m_path( "livemetricssegmenttest.tmp" )
+    , m_textFilePath( "livemetricssegmenttest.prom" )
+{
+}
+
+
+LiveMetricsSegmentTest::~LiveMetricsSegmentTest()
+{
+}
+
+
+void 
+LiveMetricsSegmentTest::setUp()
+{
+  remove( m_path.c_str() );
+}
+
+
+void 
+LiveMetricsSegmentTest::tearDown()
+{
+  remove( m_path.c_str() );
+  remove( m_textFilePath.c_str() );
+}
+
+
+void 
+LiveMetricsSegmentTest::testCreate()
+{
+  CPPUNIT_NS::LiveMetricsSegment segment( m_path, true );
+
+  CPPUNIT_ASSERT_EQUAL( 0, segment.usedSlotCount() );
+  CPPUNIT_ASSERT_EQUAL( 0L, segment.readWorker( 0 ).m_processId );
+  CPPUNIT_ASSERT_EQUAL( std::string(""), segment.readWorker( 0 ).m_currentTest );
+}
+
+
+void 
+LiveMetricsSegmentTest::testWriteAndRead()
+{
+  CPPUNIT_NS::LiveMetricsSegment writer( m_path, true );
+  CPPUNIT_NS::LiveWorkerMetrics metrics;
+  metrics.m_processId = 1234;
+  metrics.m_running = true;
+  metrics.m_startedCount = 10;
+  metrics.m_finishedCount = 9;
+  metrics.m_failureCount = 2;
+  metrics.m_errorCount = 1;
+  metrics.m_residentBytes = 4096;
+  metrics.m_startTime = 100;
+  metrics.m_updateTime = 103;
+  metrics.m_currentTest = "Suite::testSlow";
+  writer.writeWorker( 5, metrics );
+
+  // A second mapping of the file, as cppunit-top does.
+  CPPUNIT_NS::LiveMetricsSegment reader( m_path, false );
+  CPPUNIT_NS::LiveWorkerMetrics read = reader.readWorker( 5 );
+  CPPUNIT_ASSERT_EQUAL( 1, reader.usedSlotCount() );
+  CPPUNIT_ASSERT_EQUAL( 1234L, read.m_processId );
+  CPPUNIT_ASSERT( read.m_running );
+  CPPUNIT_ASSERT_EQUAL( 10L, read.m_startedCount );
+  CPPUNIT_ASSERT_EQUAL( 9L, read.m_finishedCount );
+  CPPUNIT_ASSERT_EQUAL( 2L, read.m_failureCount );
+  CPPUNIT_ASSERT_EQUAL( 1L, read.m_errorCount );
+  CPPUNIT_ASSERT_EQUAL( 4096L, read.m_residentBytes );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 100.0, read.m_startTime, 1e-12 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 103.0, read.m_updateTime, 1e-12 );
+  CPPUNIT_ASSERT_EQUAL( std::string("Suite::testSlow"), read.m_currentTest );
+
+  metrics.m_finishedCount = 10;
+  writer.writeWorker( 5, metrics );
+  CPPUNIT_ASSERT_EQUAL( 10L, reader.readWorker( 5 ).m_finishedCount );
+}
+
+
+void 
+LiveMetricsSegmentTest::testLongTestName()
+{
+  CPPUNIT_NS::LiveMetricsSegment segment( m_path, true );
+  CPPUNIT_NS::LiveWorkerMetrics metrics;
+  metrics.m_processId = 1;
+  metrics.m_currentTest = std::string( 300, 'x' );
+  segment.writeWorker( 0, metrics );
+
+  CPPUNIT_ASSERT_EQUAL( std::string( 255, 'x' ), 
+                        segment.readWorker( 0 ).m_currentTest );
+}
+
+
+void 
+LiveMetricsSegmentTest::testTestsPerSecond()
+{
+  CPPUNIT_NS::LiveWorkerMetrics metrics;
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0, metrics.testsPerSecond(), 1e-12 );
+
+  metrics.m_startTime = 10;
+  metrics.m_updateTime = 14;
+  metrics.m_finishedCount = 10;
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 2.5, metrics.testsPerSecond(), 1e-12 );
+}
+
+
+void 
+LiveMetricsSegmentTest::testWritePrometheus()
+{
+  CPPUNIT_NS::LiveMetricsSegment segment( m_path, true );
+  CPPUNIT_NS::LiveWorkerMetrics metrics;
+  metrics.m_processId = 42;
+  metrics.m_running = true;
+  metrics.m_startedCount = 3;
+  metrics.m_finishedCount = 2;
+  metrics.m_startTime = 10;
+  metrics.m_updateTime = 14;
+  metrics.m_currentTest = "Suite::\"quoted\"";
+  segment.writeWorker( 2, metrics );
+
+  CPPUNIT_NS::OStringStream stream;
+  segment.writePrometheus( stream );
+  std::string text = stream.str();
+
+  CPPUNIT_ASSERT( text.find( "# TYPE cppunit_tests_started_total counter\n" ) != 
+                  std::string::npos );
+  CPPUNIT_ASSERT( text.find( "cppunit_tests_started_total{worker=\"2\"} 3\n" ) != 
+                  std::string::npos );
+  CPPUNIT_ASSERT( text.find( "cppunit_tests_per_second{worker=\"2\"} 0.5\n" ) != 
+                  std::string::npos );
+  CPPUNIT_ASSERT( text.find( "cppunit_worker_running{worker=\"2\"} 1\n" ) != 
+                  std::string::npos );
+  CPPUNIT_ASSERT( text.find( "cppunit_current_test{worker=\"2\","
+                             "test=\"Suite::\\\"quoted\\\"\"} 1\n" ) != 
+                  std::string::npos );
+  // Unused slots are not written.
+  CPPUNIT_ASSERT( text.find( "worker=\"0\"" ) == std::string::npos );
+}
+
+
+void 
+LiveMetricsSegmentTest::testWritePrometheusFile()
+{
+  CPPUNIT_NS::LiveMetricsSegment segment( m_path, true );
+  CPPUNIT_NS::LiveWorkerMetrics metrics;
+  metrics.m_processId = 42;
+  metrics.m_failureCount = 7;
+  segment.writeWorker( 0, metrics );
+  segment.writePrometheusFile( m_textFilePath );
+
+  CPPUNIT_NS::MappedFile file( m_textFilePath );
+  std::string text( (const char *)file.data(), file.size() );
+  CPPUNIT_ASSERT( text.find( "cppunit_test_failures_total{worker=\"0\"} 7\n" ) != 
+                  std::string::npos );
+}
+
+
+void 
+LiveMetricsSegmentTest::testMissingFileThrow()
+{
+  CPPUNIT_NS::LiveMetricsSegment segment( m_path, false );
+}
+
+
+void 
+LiveMetricsSegmentTest::testNotASegmentThrow()
+{
+  FILE *file = fopen( m_path.c_str(), "wb" );
+  CPPUNIT_ASSERT( file != NULL );
+  fputs( "not a segment", file );
+  fclose( file );
+
+  CPPUNIT_NS::LiveMetricsSegment segment( m_path, true );
+}
+
+
+void 
+LiveMetricsSegmentTest::testReadOnlyWriteThrow()
+{
+  {
+    CPPUNIT_NS::LiveMetricsSegment writer( m_path, true );
+  }
+  CPPUNIT_NS::LiveMetricsSegment reader( m_path, false );
+  reader.writeWorker( 0, CPPUNIT_NS::LiveWorkerMetrics() );
+}
+
+
+void 
+LiveMetricsSegmentTest::testInvalidWorkerIndexThrow()
+{
+  CPPUNIT_NS::LiveMetricsSegment segment( m_path, true );
+  segment.readWorker( CPPUNIT_NS::LiveMetricsSegment::slotCount );
+}
@@ -0,0 +1,58 @@
+#ifndef LIVEMETRICSSEGMENTTEST_H
+#define LIVEMETRICSSEGMENTTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdexcept>
+#include <string>
+
+
+/*! \class LiveMetricsSegmentTest
+ * \brief Unit test for class LiveMetricsSegment.
+ */
+class LiveMetricsSegmentTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( LiveMetricsSegmentTest );
+  CPPUNIT_TEST( testCreate );
+  CPPUNIT_TEST( testWriteAndRead );
+  CPPUNIT_TEST( testLongTestName );
+  CPPUNIT_TEST( testTestsPerSecond );
+  CPPUNIT_TEST( testWritePrometheus );
+  CPPUNIT_TEST( testWritePrometheusFile );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST_EXCEPTION( testMissingFileThrow, std::runtime_error );
+  CPPUNIT_TEST_EXCEPTION( testNotASegmentThrow, std::runtime_error );
+  CPPUNIT_TEST_EXCEPTION( testReadOnlyWriteThrow, std::runtime_error );
+  CPPUNIT_TEST_EXCEPTION( testInvalidWorkerIndexThrow, std::invalid_argument );
+#endif
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  LiveMetricsSegmentTest();
+  virtual ~LiveMetricsSegmentTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testCreate();
+  void testWriteAndRead();
+  void testLongTestName();
+  void testTestsPerSecond();
+  void testWritePrometheus();
+  void testWritePrometheusFile();
+  void testMissingFileThrow();
+  void testNotASegmentThrow();
+  void testReadOnlyWriteThrow();
+  void testInvalidWorkerIndexThrow();
+
+private:
+  LiveMetricsSegmentTest( const LiveMetricsSegmentTest &copy );
+  void operator =( const LiveMetricsSegmentTest &copy );
+
+private:
+  std::string m_path;
+  std::string m_textFilePath;
+};
+
+
+
+#endif  // LIVEMETRICSSEGMENTTEST_H
@@ -0,0 +1,238 @@
+#include "ExtensionSuite.h"
+#include "LoadDriverTest.h"
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/extensions/LatencyReport.h>
+#include <cppunit/tools/Clock.h>
+#include <cppunit/tools/ThreadGroup.h>
+#include <cppunit/tools/XmlDocument.h>
+#include <cppunit/tools/XmlElement.h>
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( LoadDriverTest,
+                                       extensionSuiteName() );
+
+
+/// Counts the requests, optionally sleeping or failing.
+class LoadDriverTestRequest : public CPPUNIT_NS::LoadRequest
+{
+public:
+  LoadDriverTestRequest( double serviceTime = 0,
+                         int failEvery = 0 )
+      : m_serviceTime( serviceTime )
+      , m_failEvery( failEvery )
+      , m_count( 0 )
+  {
+  }
+
+  void send( int )
+  {
+    m_mutex.lock();
+    int count = ++m_count;
+    m_mutex.unlock();
+
+    if ( m_serviceTime > 0 )
+      CPPUNIT_NS::Clock::sleepUntil( CPPUNIT_NS::Clock::now() + m_serviceTime );
+    if ( m_failEvery > 0  &&  count % m_failEvery == 0 )
+      CPPUNIT_FAIL( "request failed" );
+  }
+
+  double m_serviceTime;
+  int m_failEvery;
+  int m_count;
+  CPPUNIT_NS::ThreadMutex m_mutex;
+};
+
+
+/// Fixture declared with CPPUNIT_LOAD_TEST.
+class LoadDriverTestFixture : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( LoadDriverTestFixture );
+  CPPUNIT_LOAD_TEST( testLoad, CPPUNIT_NS::LoadProfile( 10000, 0.005, 2 ) );
+  CPPUNIT_TEST_SUITE_END();
+public:
+  LoadDriverTestFixture()
+      : m_requestCount( 0 )
+  {
+  }
+
+  void request()
+  {
+    m_mutex.lock();
+    ++m_requestCount;
+    m_mutex.unlock();
+  }
+
+  void testLoad( CPPUNIT_NS::LoadDriver &load )
+  {
+    CPPUNIT_NS::LoadRequestMethod<LoadDriverTestFixture> request( 
+        this, &LoadDriverTestFixture::request );
+    load.run( request );
+    CPPUNIT_ASSERT_EQUAL( 50, m_requestCount );
+    CPPUNIT_ASSERT_P99_BELOW( load.latencies(), 10.0 );
+  }
+
+  int m_requestCount;
+  CPPUNIT_NS::ThreadMutex m_mutex;
+};
+
+
+LoadDriverTest::LoadDriverTest()
+{
+}
+
+
+LoadDriverTest::~LoadDriverTest()
+{
+}
+
+
+void 
+LoadDriverTest::setUp()
+{
+}
+
+
+void 
+LoadDriverTest::tearDown()
+{
+}
+
+
+void 
+LoadDriverTest::testProfile()
+{
+  CPPUNIT_NS::LoadProfile profile( 1000, 2.5, 0 );
+  CPPUNIT_ASSERT_EQUAL( 1000.0, profile.requestsPerSecond() );
+  CPPUNIT_ASSERT_EQUAL( 2.5, profile.durationSeconds() );
+  CPPUNIT_ASSERT_EQUAL( 1, profile.threadCount() );
+  CPPUNIT_ASSERT_EQUAL( 2500, profile.requestCount() );
+  CPPUNIT_ASSERT_EQUAL( 0, CPPUNIT_NS::LoadProfile( 0, 1 ).requestCount() );
+}
+
+
+void 
+LoadDriverTest::testAllRequestsAreSent()
+{
+  LoadDriverTestRequest request;
+  CPPUNIT_NS::LoadDriver load( CPPUNIT_NS::LoadProfile( 20000, 0.005, 3 ) );
+  load.run( request );
+
+  CPPUNIT_ASSERT_EQUAL( 100, request.m_count );
+  CPPUNIT_ASSERT_EQUAL( 100, int(load.latencies().totalCount()) );
+  CPPUNIT_ASSERT( load.achievedRequestsPerSecond() > 0 );
+}
+
+
+void 
+LoadDriverTest::testLatencyIncludesQueueingDelay()
+{
+  // Requests are due every millisecond but take 5 ms: the last request
+  // waits for the 9 previous ones.
+  LoadDriverTestRequest request( 0.005 );
+  CPPUNIT_NS::LoadDriver load( CPPUNIT_NS::LoadProfile( 1000, 0.010, 1 ) );
+  load.run( request );
+
+  CPPUNIT_ASSERT_EQUAL( 10, int(load.latencies().totalCount()) );
+  CPPUNIT_ASSERT( load.latencies().minimum() >= 0.005 );
+  CPPUNIT_ASSERT( load.latencies().maximum() >= 0.040 );
+}
+
+
+void 
+LoadDriverTest::testFailedRequestsFailRun()
+{
+  LoadDriverTestRequest request( 0, 10 );
+  CPPUNIT_NS::LoadDriver load( CPPUNIT_NS::LoadProfile( 20000, 0.002, 2 ) );
+  try
+  {
+    load.run( request );
+  }
+  catch ( CPPUNIT_NS::Exception &e )
+  {
+    CPPUNIT_ASSERT_EQUAL( std::string( "4 of 40 requests failed" ),
+                          e.message().detailAt( 0 ) );
+    CPPUNIT_ASSERT_EQUAL( 40, int(load.latencies().totalCount()) );
+    return;
+  }
+  CPPUNIT_FAIL( "failed requests not reported" );
+}
+
+
+void 
+LoadDriverTest::testPercentileAssertion()
+{
+  CPPUNIT_NS::LatencyHistogram latencies;
+  for ( int index =1; index <= 100; ++index )
+    latencies.record( index * 1e-3 );
+
+  CPPUNIT_ASSERT_P99_BELOW( latencies, 0.1 );
+  CPPUNIT_ASSERT_PERCENTILE_BELOW( latencies, 50, 0.051 );
+}
+
+
+void 
+LoadDriverTest::testPercentileAssertionFail()
+{
+  CPPUNIT_NS::LatencyHistogram latencies;
+  for ( int index =1; index <= 100; ++index )
+    latencies.record( index * 1e-3 );
+
+  CPPUNIT_ASSERT_P99_BELOW( latencies, 0.05 );
+}
+
+
+void 
+LoadDriverTest::testLoadTestCallerReportsLatencies()
+{
+  CPPUNIT_NS::TestSuite *suite = LoadDriverTestFixture::suite();
+  CPPUNIT_NS::Test *test = suite->getChildTestAt( 0 );
+  CPPUNIT_NS::TestResult controller;
+  CPPUNIT_NS::TestResultCollector result;
+  controller.addListener( &result );
+  suite->run( &controller );
+
+  CPPUNIT_ASSERT( result.wasSuccessful() );
+  const CPPUNIT_NS::LatencyHistogram *latencies = 
+      CPPUNIT_NS::LatencyReport::getReport().findLatencies( test );
+  CPPUNIT_ASSERT( latencies != NULL );
+  CPPUNIT_ASSERT_EQUAL( 50, int(latencies->totalCount()) );
+
+  delete suite;
+  CPPUNIT_ASSERT( CPPUNIT_NS::LatencyReport::getReport().findLatencies( test ) == NULL );
+}
+
+
+void 
+LoadDriverTest::testXmlOutputterHook()
+{
+  CPPUNIT_NS::TestSuite test( "load" );
+  CPPUNIT_NS::TestSuite other( "other" );
+  CPPUNIT_NS::LatencyHistogram latencies;
+  latencies.record( 0.001 );
+  latencies.record( 0.002 );
+  CPPUNIT_NS::LatencyReport report;
+  report.setLatencies( &test, latencies );
+
+  CPPUNIT_NS::LatencyXmlOutputterHook hook( report );
+  CPPUNIT_NS::XmlDocument document;
+  CPPUNIT_NS::XmlElement *testElement = new CPPUNIT_NS::XmlElement( "Test" );
+  CPPUNIT_NS::XmlElement *otherElement = new CPPUNIT_NS::XmlElement( "Test" );
+  document.rootElement().addElement( testElement );
+  document.rootElement().addElement( otherElement );
+  hook.successfulTestAdded( &document, testElement, &test );
+  hook.failTestAdded( &document, otherElement, &other, NULL );
+
+  CPPUNIT_ASSERT_EQUAL( 0, otherElement->elementCount() );
+  CPPUNIT_NS::XmlElement *latencyElement = testElement->elementFor( "Latency" );
+  // 5 percentiles and 2 non empty buckets.
+  CPPUNIT_ASSERT_EQUAL( 7, latencyElement->elementCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "Percentile" ), 
+                        latencyElement->elementAt( 0 )->name() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "Bucket" ), 
+                        latencyElement->elementAt( 6 )->name() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "1" ), 
+                        latencyElement->elementAt( 6 )->content() );
+  CPPUNIT_ASSERT( latencyElement->toString().find( "count=\"2\"" ) 
+                  != std::string::npos );
+}
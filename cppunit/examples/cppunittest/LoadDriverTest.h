@@ -0,0 +1,50 @@
+#ifndef LOADDRIVERTEST_H
+#define LOADDRIVERTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+/*! \class LoadDriverTest
+ * \brief Unit test for LoadDriver, LoadTestCaller and LatencyReport.
+ */
+class LoadDriverTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( LoadDriverTest );
+  CPPUNIT_TEST( testProfile );
+  CPPUNIT_TEST( testAllRequestsAreSent );
+  CPPUNIT_TEST( testLatencyIncludesQueueingDelay );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testFailedRequestsFailRun );
+#endif
+  CPPUNIT_TEST( testPercentileAssertion );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST_FAIL( testPercentileAssertionFail );
+#endif
+  CPPUNIT_TEST( testLoadTestCallerReportsLatencies );
+  CPPUNIT_TEST( testXmlOutputterHook );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  LoadDriverTest();
+  virtual ~LoadDriverTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testProfile();
+  void testAllRequestsAreSent();
+  void testLatencyIncludesQueueingDelay();
+  void testFailedRequestsFailRun();
+  void testPercentileAssertion();
+  void testPercentileAssertionFail();
+  void testLoadTestCallerReportsLatencies();
+  void testXmlOutputterHook();
+
+private:
+  LoadDriverTest( const LoadDriverTest &copy );
+  void operator =( const LoadDriverTest &copy );
+};
+
+
+
+#endif  // LOADDRIVERTEST_H
@@ -0,0 +1,72 @@
+#include "ToolsSuite.h"
+#include "MappedFileTest.h"
+#include <cppunit/tools/MappedFile.h>
+#include <stdio.h>
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( MappedFileTest, 
+                                       toolsSuiteName() );
+
+
+MappedFileTest::MappedFileTest()
+    : m_path( "mappedfiletest.tmp" )
+{
+}
+
+
+MappedFileTest::~MappedFileTest()
+{
+}
+
+
+void 
+MappedFileTest::setUp()
+{
+}
+
+
+void 
+MappedFileTest::tearDown()
+{
+  remove( m_path.c_str() );
+}
+
+
+void 
+MappedFileTest::writeFile( const std::string &content )
+{
+  FILE *file = fopen( m_path.c_str(), "wb" );
+  CPPUNIT_ASSERT( file != NULL );
+  fwrite( content.data(), 1, content.size(), file );
+  fclose( file );
+}
+
+
+void 
+MappedFileTest::testMapFile()
+{
+  std::string content( "abc\0def", 7 );
+  writeFile( content );
+
+  CPPUNIT_NS::MappedFile file( m_path );
+  CPPUNIT_ASSERT_EQUAL( 7, int(file.size()) );
+  CPPUNIT_ASSERT( content == std::string( (const char *)file.data(), file.size() ) );
+}
+
+
+void 
+MappedFileTest::testEmptyFile()
+{
+  writeFile( "" );
+
+  CPPUNIT_NS::MappedFile file( m_path );
+  CPPUNIT_ASSERT_EQUAL( 0, int(file.size()) );
+  CPPUNIT_ASSERT( file.data() != NULL );
+}
+
+
+void 
+MappedFileTest::testMissingFile()
+{
+  CPPUNIT_NS::MappedFile file( "mappedfiletest-missing.tmp" );
+}
@@ -0,0 +1,44 @@
+#ifndef MAPPEDFILETEST_H
+#define MAPPEDFILETEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdexcept>
+
+
+/*! \class MappedFileTest
+ * \brief Unit test for class MappedFile.
+ */
+class MappedFileTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( MappedFileTest );
+  CPPUNIT_TEST( testMapFile );
+  CPPUNIT_TEST( testEmptyFile );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST_EXCEPTION( testMissingFile, std::runtime_error );
+#endif
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  MappedFileTest();
+  virtual ~MappedFileTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testMapFile();
+  void testEmptyFile();
+  void testMissingFile();
+
+private:
+  MappedFileTest( const MappedFileTest &copy );
+  void operator =( const MappedFileTest &copy );
+
+  void writeFile( const std::string &content );
+
+private:
+  std::string m_path;
+};
+
+
+
+#endif  // MAPPEDFILETEST_H
@@ -11,8 +11,10 @@ class MessageTest : public CPPUNIT_NS::TestFixture
 {
   CPPUNIT_TEST_SUITE( MessageTest );
   CPPUNIT_TEST( testDefaultConstructor );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST_EXCEPTION( testDetailAtThrowIfBadIndex, std::invalid_argument );
   CPPUNIT_TEST_EXCEPTION( testDetailAtThrowIfBadIndex2, std::invalid_argument );
+#endif
   CPPUNIT_TEST( testAddDetail );
   CPPUNIT_TEST( testAddDetail2 );
   CPPUNIT_TEST( testAddDetail3 );
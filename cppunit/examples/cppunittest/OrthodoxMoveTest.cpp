@@ -0,0 +1,89 @@
+#include "ExtensionSuite.h"
+#include "OrthodoxMoveTest.h"
+#include <cppunit/extensions/OrthodoxMove.h>
+#include <cppunit/TestResult.h>
+
+#if CPPUNIT_HAVE_RVALUE_REFERENCES
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( OrthodoxMoveTest,
+                                       extensionSuiteName() );
+
+OrthodoxMoveTest::OrthodoxMoveTest()
+{
+}
+
+
+OrthodoxMoveTest::~OrthodoxMoveTest()
+{
+}
+
+
+void 
+OrthodoxMoveTest::setUp()
+{
+  m_testListener = new MockTestListener( "mock-listener" );
+  m_result = new CPPUNIT_NS::TestResult();
+  m_result->addListener( m_testListener );
+}
+
+
+void 
+OrthodoxMoveTest::tearDown()
+{
+  delete m_result;
+  delete m_testListener;
+}
+
+
+void 
+OrthodoxMoveTest::testValue()
+{
+  CPPUNIT_NS::OrthodoxMove<Value> test;
+  m_testListener->setExpectNoFailure();
+  test.run( m_result );
+  m_testListener->verify();
+}
+
+
+void 
+OrthodoxMoveTest::testValueThrowingMove()
+{
+  CPPUNIT_NS::OrthodoxMove<ValueThrowingMove> test;
+  m_testListener->setExpectFailure();
+  test.run( m_result );
+  m_testListener->verify();
+}
+
+
+void 
+OrthodoxMoveTest::testValueThrowingSwap()
+{
+  CPPUNIT_NS::OrthodoxMove<ValueThrowingSwap> test;
+  m_testListener->setExpectFailure();
+  test.run( m_result );
+  m_testListener->verify();
+}
+
+
+void 
+OrthodoxMoveTest::testValueBadMove()
+{
+  CPPUNIT_NS::OrthodoxMove<ValueBadMove> test;
+  m_testListener->setExpectFailure();
+  test.run( m_result );
+  m_testListener->verify();
+}
+
+
+void 
+OrthodoxMoveTest::testValueCopyingMove()
+{
+  CPPUNIT_ASSERT( CPPUNIT_NS::AllocationCounter::isInstalled() );
+
+  CPPUNIT_NS::OrthodoxMove<ValueCopyingMove> test;
+  m_testListener->setExpectFailure();
+  test.run( m_result );
+  m_testListener->verify();
+}
+
+#endif  // CPPUNIT_HAVE_RVALUE_REFERENCES
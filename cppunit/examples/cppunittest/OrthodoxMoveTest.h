@@ -0,0 +1,162 @@
+#ifndef ORTHODOXMOVETEST_H
+#define ORTHODOXMOVETEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "MockTestListener.h"
+
+#if CPPUNIT_HAVE_RVALUE_REFERENCES
+
+#include <utility>
+#include <vector>
+
+
+class OrthodoxMoveTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( OrthodoxMoveTest );
+  CPPUNIT_TEST( testValue );
+  CPPUNIT_TEST( testValueThrowingMove );
+  CPPUNIT_TEST( testValueThrowingSwap );
+  CPPUNIT_TEST( testValueBadMove );
+  CPPUNIT_TEST( testValueCopyingMove );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  OrthodoxMoveTest();
+  virtual ~OrthodoxMoveTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testValue();
+  void testValueThrowingMove();
+  void testValueThrowingSwap();
+  void testValueBadMove();
+  void testValueCopyingMove();
+
+private:
+  /// Value type owning heap memory, with noexcept moves.
+  class Value
+  {
+  public:
+    Value() {}
+
+    Value( int size ) : m_values( size, size ) {}
+
+    bool operator ==( const Value &other ) const
+    {
+      return m_values == other.m_values;
+    }
+
+    bool operator !=( const Value &other ) const
+    {
+      return !( *this == other );
+    }
+
+    Value operator !() const
+    {
+      return Value( m_values.empty() ? 16 : 0 );
+    }
+
+  protected:
+    std::vector<int> m_values;
+  };
+
+
+  class ValueThrowingMove : public Value
+  {
+  public:
+    ValueThrowingMove( int size =0 ) : Value( size ) {}
+
+    ValueThrowingMove( const ValueThrowingMove &other ) = default;
+
+    ValueThrowingMove( ValueThrowingMove &&other )
+        : Value( std::move( other ) )
+    {
+    }
+
+    ValueThrowingMove &operator =( const ValueThrowingMove &other ) = default;
+
+    ValueThrowingMove &operator =( ValueThrowingMove &&other ) = default;
+
+    ValueThrowingMove operator !() const
+    {
+      return ValueThrowingMove( m_values.empty() ? 16 : 0 );
+    }
+  };
+
+
+  class ValueThrowingSwap : public Value
+  {
+  public:
+    ValueThrowingSwap( int size =0 ) : Value( size ) {}
+
+    ValueThrowingSwap operator !() const
+    {
+      return ValueThrowingSwap( m_values.empty() ? 16 : 0 );
+    }
+
+    friend void swap( ValueThrowingSwap &first, ValueThrowingSwap &second )
+    {
+      first.m_values.swap( second.m_values );
+    }
+  };
+
+
+  class ValueBadMove : public Value
+  {
+  public:
+    ValueBadMove( int size =0 ) : Value( size ) {}
+
+    ValueBadMove( const ValueBadMove &other ) = default;
+
+    ValueBadMove( ValueBadMove &&other ) noexcept
+    {
+      other.m_values.clear();
+    }
+
+    ValueBadMove &operator =( const ValueBadMove &other ) = default;
+
+    ValueBadMove &operator =( ValueBadMove &&other ) = default;
+
+    ValueBadMove operator !() const
+    {
+      return ValueBadMove( m_values.empty() ? 16 : 0 );
+    }
+  };
+
+
+  class ValueCopyingMove : public Value
+  {
+  public:
+    ValueCopyingMove( int size =0 ) : Value( size ) {}
+
+    ValueCopyingMove( const ValueCopyingMove &other ) = default;
+
+    ValueCopyingMove( ValueCopyingMove &&other ) noexcept
+        : Value( other )
+    {
+    }
+
+    ValueCopyingMove &operator =( const ValueCopyingMove &other ) = default;
+
+    ValueCopyingMove &operator =( ValueCopyingMove &&other ) = default;
+
+    ValueCopyingMove operator !() const
+    {
+      return ValueCopyingMove( m_values.empty() ? 16 : 0 );
+    }
+  };
+
+
+  OrthodoxMoveTest( const OrthodoxMoveTest &copy );
+  void operator =( const OrthodoxMoveTest &copy );
+
+private:
+  CPPUNIT_NS::TestResult *m_result;
+  MockTestListener *m_testListener;
+};
+
+
+#endif  // CPPUNIT_HAVE_RVALUE_REFERENCES
+
+#endif  // ORTHODOXMOVETEST_H
@@ -0,0 +1,347 @@
+#include "ExtensionSuite.h"
+#include "PropertyTest.h"
+#include <cppunit/Exception.h>
+#include <cppunit/TestFailure.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/extensions/PropertyGenerator.h>
+#include <stdexcept>
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( PropertyTest,
+                                       extensionSuiteName() );
+
+
+/// Fails for integers greater or equal to 1000.
+class PropertyTestSmallInteger : public CPPUNIT_NS::PropertyFunction
+{
+public:
+  PropertyTestSmallInteger( int maximum )
+      : m_maximum( maximum )
+  {
+  }
+
+  void check( CPPUNIT_NS::PropertyCase &property )
+  {
+    int value = CPPUNIT_NS::IntegerGenerator<int>( -m_maximum, m_maximum ).draw( property );
+    CPPUNIT_ASSERT( value < 1000 );
+  }
+
+  int m_maximum;
+};
+
+
+/// Fails for vectors whose sum is 100 or more.
+class PropertyTestSmallSum : public CPPUNIT_NS::PropertyFunction
+{
+public:
+  void check( CPPUNIT_NS::PropertyCase &property )
+  {
+    CPPUNIT_NS::VectorGenerator<CPPUNIT_NS::IntegerGenerator<int> > values( 
+        CPPUNIT_NS::IntegerGenerator<int>( 0, 1000 ), 20 );
+    std::vector<int> drawn = values.draw( property );
+    int sum = 0;
+    for ( unsigned int index =0; index < drawn.size(); ++index )
+      sum += drawn[index];
+    CPPUNIT_ASSERT_MESSAGE( "sum too large", sum < 100 );
+  }
+};
+
+
+/// Throws for strings containing 'z'.
+class PropertyTestThrowing : public CPPUNIT_NS::PropertyFunction
+{
+public:
+  void check( CPPUNIT_NS::PropertyCase &property )
+  {
+    std::string text = CPPUNIT_NS::StringGenerator( 10 ).draw( property );
+    if ( text.find( 'z' ) != std::string::npos )
+      throw std::runtime_error( "z found" );
+  }
+};
+
+
+/// Fixture declared with CPPUNIT_PROPERTY.
+class PropertyTestFixture : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( PropertyTestFixture );
+  CPPUNIT_PROPERTY( testReverseTwiceIsIdentity );
+  CPPUNIT_PROPERTY_CASES( testArrayIsSmall, 1000 );
+  CPPUNIT_TEST_SUITE_END();
+public:
+  void testReverseTwiceIsIdentity( CPPUNIT_NS::PropertyCase &property )
+  {
+    std::string text = CPPUNIT_NS::StringGenerator( 30 ).draw( property );
+    std::string reversed( text.rbegin(), text.rend() );
+    CPPUNIT_ASSERT_EQUAL( text, std::string( reversed.rbegin(), reversed.rend() ) );
+  }
+
+  void testArrayIsSmall( CPPUNIT_NS::PropertyCase &property )
+  {
+    CPPUNIT_NS::ArrayGenerator<CPPUNIT_NS::IntegerGenerator<int> > values( 
+        CPPUNIT_NS::IntegerGenerator<int>( 0, 9 ), 10 );
+    CPPUNIT_NS::PropertyArray<int> drawn = values.draw( property );
+    CPPUNIT_ASSERT( drawn.size() < 5 );
+  }
+};
+
+
+PropertyTest::PropertyTest()
+{
+}
+
+
+PropertyTest::~PropertyTest()
+{
+}
+
+
+void 
+PropertyTest::setUp()
+{
+}
+
+
+void 
+PropertyTest::tearDown()
+{
+}
+
+
+void 
+PropertyTest::testArenaAllocate()
+{
+  CPPUNIT_NS::PropertyArena arena( 64 );
+  char *first = static_cast<char *>( arena.allocate( 3 ) );
+  char *second = static_cast<char *>( arena.allocate( 8 ) );
+  CPPUNIT_ASSERT_EQUAL( 16, int(second - first) );
+  CPPUNIT_ASSERT_EQUAL( 32, int(arena.allocatedSize()) );
+
+  arena.allocate( 100 );
+  CPPUNIT_ASSERT_EQUAL( 144, int(arena.allocatedSize()) );
+  CPPUNIT_ASSERT_EQUAL( 64 + 112, int(arena.capacity()) );
+}
+
+
+void 
+PropertyTest::testArenaReuseMemory()
+{
+  CPPUNIT_NS::PropertyArena arena( 64 );
+  void *first = arena.allocate( 40 );
+  arena.allocate( 40 );
+  size_t capacity = arena.capacity();
+
+  arena.reset();
+  CPPUNIT_ASSERT_EQUAL( 0, int(arena.allocatedSize()) );
+  CPPUNIT_ASSERT( first == arena.allocate( 40 ) );
+  arena.allocate( 40 );
+  CPPUNIT_ASSERT_EQUAL( capacity, arena.capacity() );
+}
+
+
+void 
+PropertyTest::testReplayChoices()
+{
+  CPPUNIT_NS::PropertyCase property;
+  property.startGeneration( 42 );
+  unsigned long first = property.drawChoice( 1000 );
+  bool second = property.drawBoolean( 0.5 );
+  CPPUNIT_ASSERT( first <= 1000 );
+  CPPUNIT_ASSERT_EQUAL( 2, int(property.choices().size()) );
+
+  CPPUNIT_NS::PropertyCase::Choices choices( property.choices() );
+  property.startReplay( choices );
+  CPPUNIT_ASSERT_EQUAL( first, property.drawChoice( 1000 ) );
+  CPPUNIT_ASSERT_EQUAL( second, property.drawBoolean( 0.5 ) );
+  // Exhausted choices are 0, and choices are clamped to the maximum.
+  CPPUNIT_ASSERT_EQUAL( 0UL, property.drawChoice( 7 ) );
+
+  choices[0] = 50;
+  property.startReplay( choices );
+  CPPUNIT_ASSERT_EQUAL( 10UL, property.drawChoice( 10 ) );
+  CPPUNIT_ASSERT_EQUAL( 10UL, property.choices()[0] );
+}
+
+
+void 
+PropertyTest::testIntegerGenerator()
+{
+  CPPUNIT_NS::IntegerGenerator<int> signedValues( -5, 3 );
+  CPPUNIT_NS::IntegerGenerator<unsigned int> unsignedValues( 10, 20 );
+  CPPUNIT_NS::IntegerGenerator<int> negativeValues( -20, -10 );
+  CPPUNIT_NS::PropertyCase property;
+  bool seen[9] = { false, false, false, false, false, false, false, false, false };
+  for ( int index =0; index < 1000; ++index )
+  {
+    property.startGeneration( index );
+    int value = signedValues.generate( property );
+    CPPUNIT_ASSERT( value >= -5  &&  value <= 3 );
+    seen[ value + 5 ] = true;
+
+    unsigned int unsignedValue = unsignedValues.generate( property );
+    CPPUNIT_ASSERT( unsignedValue >= 10  &&  unsignedValue <= 20 );
+    int negativeValue = negativeValues.generate( property );
+    CPPUNIT_ASSERT( negativeValue >= -20  &&  negativeValue <= -10 );
+  }
+  for ( int seenIndex =0; seenIndex < 9; ++seenIndex )
+    CPPUNIT_ASSERT( seen[ seenIndex ] );
+}
+
+
+void 
+PropertyTest::testWideIntegerGenerator()
+{
+#if defined(ULLONG_MAX)
+  const long long maximum = 1000LL * 1000 * 1000 * 1000;
+  CPPUNIT_NS::IntegerGenerator<long long> values( -maximum, maximum );
+  CPPUNIT_NS::PropertyCase property;
+  bool seenWide = false;
+  for ( int index =0; index < 100; ++index )
+  {
+    property.startGeneration( index );
+    long long value = values.generate( property );
+    CPPUNIT_ASSERT( value >= -maximum  &&  value <= maximum );
+    if ( value > 0xffffffffLL  ||  value < -0xffffffffLL )
+      seenWide = true;
+  }
+  CPPUNIT_ASSERT( seenWide );
+
+  property.startReplay( CPPUNIT_NS::PropertyCase::Choices() );
+  CPPUNIT_ASSERT( values.generate( property ) == 0 );
+#endif
+}
+
+
+void 
+PropertyTest::testGeneratorsShrinkToOrigin()
+{
+  CPPUNIT_NS::PropertyCase property;
+  property.startReplay( CPPUNIT_NS::PropertyCase::Choices() );
+  CPPUNIT_ASSERT_EQUAL( 0, CPPUNIT_NS::IntegerGenerator<int>( -5, 5 ).generate( property ) );
+  CPPUNIT_ASSERT_EQUAL( 10, CPPUNIT_NS::IntegerGenerator<int>( 10, 20 ).generate( property ) );
+  CPPUNIT_ASSERT_EQUAL( -10, CPPUNIT_NS::IntegerGenerator<int>( -20, -10 ).generate( property ) );
+  CPPUNIT_ASSERT_EQUAL( 1.5, CPPUNIT_NS::FloatingPointGenerator<double>( 1.5, 2 ).generate( property ) );
+  CPPUNIT_ASSERT_EQUAL( false, CPPUNIT_NS::BooleanGenerator().generate( property ) );
+  CPPUNIT_ASSERT_EQUAL( std::string(), CPPUNIT_NS::StringGenerator( 10 ).generate( property ) );
+}
+
+
+void 
+PropertyTest::testPassingProperty()
+{
+  PropertyTestSmallInteger property( 999 );
+  CPPUNIT_NS::PropertyRunner runner( 10000 );
+  runner.setThreadCount( 4 );
+  runner.run( property );
+}
+
+
+void 
+PropertyTest::testIntegerCounterexampleIsShrunk()
+{
+  PropertyTestSmallInteger property( 100000 );
+  CPPUNIT_NS::PropertyRunner runner( 1000 );
+  runner.setSeed( 7 );
+  try
+  {
+    runner.run( property );
+  }
+  catch ( CPPUNIT_NS::Exception &e )
+  {
+    CPPUNIT_NS::Message message = e.message();
+    CPPUNIT_ASSERT_EQUAL( std::string( "property falsified" ), 
+                          message.shortDescription() );
+    CPPUNIT_ASSERT_EQUAL( std::string( "Drawn: 1000" ), message.detailAt( 1 ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "Failure: assertion failed" ), 
+                          message.detailAt( 2 ) );
+    CPPUNIT_ASSERT( message.details().find( "CPPUNIT_SEED=7" ) != std::string::npos );
+    CPPUNIT_ASSERT( e.sourceLine().isValid() );
+    return;
+  }
+  CPPUNIT_FAIL( "property not falsified" );
+}
+
+
+void 
+PropertyTest::testVectorCounterexampleIsShrunk()
+{
+  PropertyTestSmallSum property;
+  CPPUNIT_NS::PropertyRunner runner( 1000 );
+  runner.setSeed( 3 );
+  try
+  {
+    runner.run( property );
+  }
+  catch ( CPPUNIT_NS::Exception &e )
+  {
+    CPPUNIT_ASSERT_EQUAL( std::string( "Drawn: [100]" ), e.message().detailAt( 1 ) );
+    CPPUNIT_ASSERT( e.message().details().find( "sum too large" ) != std::string::npos );
+    return;
+  }
+  CPPUNIT_FAIL( "property not falsified" );
+}
+
+
+void 
+PropertyTest::testSeedReplaysFailure()
+{
+  std::string details[2];
+  for ( int run =0; run < 2; ++run )
+  {
+    PropertyTestSmallSum property;
+    CPPUNIT_NS::PropertyRunner runner( 1000 );
+    runner.setSeed( 123 );
+    runner.setThreadCount( run == 0 ? 1 : 4 );
+    runner.setBatchSize( 16 );
+    try
+    {
+      runner.run( property );
+    }
+    catch ( CPPUNIT_NS::Exception &e )
+    {
+      details[run] = e.message().details();
+    }
+  }
+
+  CPPUNIT_ASSERT( !details[0].empty() );
+  CPPUNIT_ASSERT_EQUAL( details[0], details[1] );
+}
+
+
+void 
+PropertyTest::testStdExceptionFailsProperty()
+{
+  PropertyTestThrowing property;
+  CPPUNIT_NS::PropertyRunner runner( 1000 );
+  try
+  {
+    runner.run( property );
+  }
+  catch ( CPPUNIT_NS::Exception &e )
+  {
+    CPPUNIT_ASSERT_EQUAL( std::string( "Drawn: \"z\"" ), e.message().detailAt( 1 ) );
+    CPPUNIT_ASSERT( e.message().details().find( "z found" ) != std::string::npos );
+    return;
+  }
+  CPPUNIT_FAIL( "property not falsified" );
+}
+
+
+void 
+PropertyTest::testPropertyTestCaller()
+{
+  CPPUNIT_NS::TestSuite *suite = PropertyTestFixture::suite();
+  CPPUNIT_NS::TestResult controller;
+  CPPUNIT_NS::TestResultCollector result;
+  controller.addListener( &result );
+  suite->run( &controller );
+
+  CPPUNIT_ASSERT_EQUAL( 2, result.runTests() );
+  CPPUNIT_ASSERT_EQUAL( 1, result.testFailures() );
+  CPPUNIT_NS::TestFailure *failure = result.failures()[0];
+  CPPUNIT_ASSERT_EQUAL( std::string( "PropertyTestFixture::testArrayIsSmall" ),
+                        failure->failedTestName() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "Drawn: [0, 0, 0, 0, 0]" ), 
+                        failure->thrownException()->message().detailAt( 1 ) );
+  delete suite;
+}
@@ -0,0 +1,56 @@
+#ifndef PROPERTYTEST_H
+#define PROPERTYTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+/*! \class PropertyTest
+ * \brief Unit test for PropertyRunner, PropertyGenerator and PropertyArena.
+ */
+class PropertyTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( PropertyTest );
+  CPPUNIT_TEST( testArenaAllocate );
+  CPPUNIT_TEST( testArenaReuseMemory );
+  CPPUNIT_TEST( testReplayChoices );
+  CPPUNIT_TEST( testIntegerGenerator );
+  CPPUNIT_TEST( testWideIntegerGenerator );
+  CPPUNIT_TEST( testGeneratorsShrinkToOrigin );
+  CPPUNIT_TEST( testPassingProperty );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testIntegerCounterexampleIsShrunk );
+  CPPUNIT_TEST( testVectorCounterexampleIsShrunk );
+  CPPUNIT_TEST( testSeedReplaysFailure );
+  CPPUNIT_TEST( testStdExceptionFailsProperty );
+  CPPUNIT_TEST( testPropertyTestCaller );
+#endif
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  PropertyTest();
+  virtual ~PropertyTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testArenaAllocate();
+  void testArenaReuseMemory();
+  void testReplayChoices();
+  void testIntegerGenerator();
+  void testWideIntegerGenerator();
+  void testGeneratorsShrinkToOrigin();
+  void testPassingProperty();
+  void testIntegerCounterexampleIsShrunk();
+  void testVectorCounterexampleIsShrunk();
+  void testSeedReplaysFailure();
+  void testStdExceptionFailsProperty();
+  void testPropertyTestCaller();
+
+private:
+  PropertyTest( const PropertyTest &copy );
+  void operator =( const PropertyTest &copy );
+};
+
+
+
+#endif  // PROPERTYTEST_H
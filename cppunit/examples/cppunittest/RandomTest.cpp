@@ -0,0 +1,126 @@
+#include "ToolsSuite.h"
+#include "RandomTest.h"
+#include <cppunit/tools/Random.h>
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( RandomTest, 
+                                       toolsSuiteName() );
+
+
+RandomTest::RandomTest()
+{
+}
+
+
+RandomTest::~RandomTest()
+{
+}
+
+
+void 
+RandomTest::setUp()
+{
+}
+
+
+void 
+RandomTest::tearDown()
+{
+}
+
+
+void 
+RandomTest::testSameSeedSameSequence()
+{
+  CPPUNIT_NS::Random random1( 42 );
+  CPPUNIT_NS::Random random2( 42 );
+  for ( int index =0; index < 100; ++index )
+    CPPUNIT_ASSERT_EQUAL( random1.nextUInt32(), random2.nextUInt32() );
+
+  unsigned int first = random1.nextUInt32();
+  random1.seed( 42 );
+  random2.seed( 42 );
+  CPPUNIT_ASSERT_EQUAL( random2.nextUInt32(), random1.nextUInt32() );
+  CPPUNIT_ASSERT( first != 0 );
+}
+
+
+void 
+RandomTest::testDifferentSeedsDiffer()
+{
+  CPPUNIT_NS::Random random1( 1 );
+  CPPUNIT_NS::Random random2( 2 );
+  int sameCount = 0;
+  for ( int index =0; index < 100; ++index )
+  {
+    if ( random1.nextUInt32() == random2.nextUInt32() )
+      ++sameCount;
+  }
+  CPPUNIT_ASSERT( sameCount < 2 );
+}
+
+
+void 
+RandomTest::testNextIntRange()
+{
+  CPPUNIT_NS::Random random( 7 );
+  bool seen[7] = { false, false, false, false, false, false, false };
+  for ( int index =0; index < 1000; ++index )
+  {
+    int value = random.nextInt( -3, 3 );
+    CPPUNIT_ASSERT( value >= -3  &&  value <= 3 );
+    seen[ value + 3 ] = true;
+  }
+  for ( int valueIndex =0; valueIndex < 7; ++valueIndex )
+    CPPUNIT_ASSERT( seen[ valueIndex ] );
+
+  CPPUNIT_ASSERT_EQUAL( 5, random.nextInt( 5, 5 ) );
+}
+
+
+void 
+RandomTest::testNextIntFullRange()
+{
+  CPPUNIT_NS::Random random( 3 );
+  bool negativeSeen = false;
+  bool positiveSeen = false;
+  for ( int index =0; index < 100; ++index )
+  {
+    int value = random.nextInt( -2147483647 -1, 2147483647 );
+    negativeSeen = negativeSeen  ||  value < 0;
+    positiveSeen = positiveSeen  ||  value > 0;
+  }
+  CPPUNIT_ASSERT( negativeSeen );
+  CPPUNIT_ASSERT( positiveSeen );
+}
+
+
+void 
+RandomTest::testNextDoubleRange()
+{
+  CPPUNIT_NS::Random random( 11 );
+  double sum = 0;
+  for ( int index =0; index < 10000; ++index )
+  {
+    double value = random.nextDouble();
+    CPPUNIT_ASSERT( value >= 0  &&  value < 1 );
+    sum += value;
+  }
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.5, sum / 10000, 0.02 );
+
+  double scaled = random.nextDouble( 10, 20 );
+  CPPUNIT_ASSERT( scaled >= 10  &&  scaled < 20 );
+}
+
+
+void 
+RandomTest::testMix()
+{
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::Random::mix( 5, 1 ), 
+                        CPPUNIT_NS::Random::mix( 5, 1 ) );
+  CPPUNIT_ASSERT( CPPUNIT_NS::Random::mix( 5, 1 ) != 
+                  CPPUNIT_NS::Random::mix( 5, 2 ) );
+  CPPUNIT_ASSERT( CPPUNIT_NS::Random::mix( 5, 1 ) != 
+                  CPPUNIT_NS::Random::mix( 6, 1 ) );
+  CPPUNIT_ASSERT( CPPUNIT_NS::Random::mix( 0, 0 ) != 0 );
+}
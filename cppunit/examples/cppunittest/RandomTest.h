@@ -0,0 +1,42 @@
+#ifndef RANDOMTEST_H
+#define RANDOMTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+/*! \class RandomTest
+ * \brief Unit test for class Random.
+ */
+class RandomTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( RandomTest );
+  CPPUNIT_TEST( testSameSeedSameSequence );
+  CPPUNIT_TEST( testDifferentSeedsDiffer );
+  CPPUNIT_TEST( testNextIntRange );
+  CPPUNIT_TEST( testNextIntFullRange );
+  CPPUNIT_TEST( testNextDoubleRange );
+  CPPUNIT_TEST( testMix );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  RandomTest();
+  virtual ~RandomTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testSameSeedSameSequence();
+  void testDifferentSeedsDiffer();
+  void testNextIntRange();
+  void testNextIntFullRange();
+  void testNextDoubleRange();
+  void testMix();
+
+private:
+  RandomTest( const RandomTest &copy );
+  void operator =( const RandomTest &copy );
+};
+
+
+
+#endif  // RANDOMTEST_H
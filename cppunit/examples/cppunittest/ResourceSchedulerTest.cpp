@@ -0,0 +1,272 @@
+#include "ExtensionSuite.h"
+#include "ResourceSchedulerTest.h"
+#include "MockTestCase.h"
+#include <cppunit/extensions/ResourceScheduler.h>
+#include <cppunit/extensions/TestSetUp.h>
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( ResourceSchedulerTest,
+                                       extensionSuiteName() );
+
+
+/// Fixture used to check that suite properties are kept on the built suite.
+class ResourceSchedulerTestFixture : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( ResourceSchedulerTestFixture );
+  CPPUNIT_TEST_SUITE_PROPERTY( "resources", "exclusive:port-8080,cpu:2" );
+  CPPUNIT_TEST( test );
+  CPPUNIT_TEST_SUITE_END();
+public:
+  void test() {}
+};
+
+
+ResourceSchedulerTest::ResourceSchedulerTest()
+{
+}
+
+
+ResourceSchedulerTest::~ResourceSchedulerTest()
+{
+}
+
+
+void 
+ResourceSchedulerTest::setUp()
+{
+  m_suite = new CPPUNIT_NS::TestSuite( "suite" );
+}
+
+
+void 
+ResourceSchedulerTest::tearDown()
+{
+  delete m_suite;
+}
+
+
+CPPUNIT_NS::Test *
+ResourceSchedulerTest::addTest( const std::string &name,
+                                const std::string &resources )
+{
+  MockTestCase *test = new MockTestCase( name );
+  if ( !resources.empty() )
+    test->setProperty( "resources", resources );
+  m_suite->addTest( test );
+  return test;
+}
+
+
+void 
+ResourceSchedulerTest::testParseResources()
+{
+  CPPUNIT_NS::TestResources none = CPPUNIT_NS::TestResources::parse( "" );
+  CPPUNIT_ASSERT_EQUAL( 1, none.cpuWeight() );
+  CPPUNIT_ASSERT_EQUAL( 0, int(none.exclusiveResources().size()) );
+
+  CPPUNIT_NS::TestResources resources = CPPUNIT_NS::TestResources::parse( 
+      "exclusive:port-8080, cpu:4 ,exclusive:scratch" );
+  CPPUNIT_ASSERT_EQUAL( 4, resources.cpuWeight() );
+  CPPUNIT_ASSERT_EQUAL( 2, int(resources.exclusiveResources().size()) );
+  CPPUNIT_ASSERT( resources.usesExclusiveResource( "port-8080" ) );
+  CPPUNIT_ASSERT( resources.usesExclusiveResource( "scratch" ) );
+  CPPUNIT_ASSERT( !resources.usesExclusiveResource( "port" ) );
+}
+
+
+void 
+ResourceSchedulerTest::testParseUnknownKindThrow()
+{
+  CPPUNIT_NS::TestResources::parse( "shared:port-8080" );
+}
+
+
+void 
+ResourceSchedulerTest::testParseBadCpuWeightThrow()
+{
+  CPPUNIT_NS::TestResources::parse( "cpu:0" );
+}
+
+
+void 
+ResourceSchedulerTest::testMergeResources()
+{
+  CPPUNIT_NS::TestResources resources = 
+      CPPUNIT_NS::TestResources::parse( "exclusive:a,cpu:2" );
+  resources.merge( CPPUNIT_NS::TestResources::parse( "exclusive:b" ) );
+  CPPUNIT_ASSERT_EQUAL( 2, resources.cpuWeight() );
+  CPPUNIT_ASSERT( resources.usesExclusiveResource( "a" ) );
+  CPPUNIT_ASSERT( resources.usesExclusiveResource( "b" ) );
+
+  resources.merge( CPPUNIT_NS::TestResources::parse( "cpu:3,exclusive:a" ) );
+  CPPUNIT_ASSERT_EQUAL( 3, resources.cpuWeight() );
+  CPPUNIT_ASSERT_EQUAL( 2, int(resources.exclusiveResources().size()) );
+}
+
+
+void 
+ResourceSchedulerTest::testConflicts()
+{
+  CPPUNIT_NS::TestResources a = CPPUNIT_NS::TestResources::parse( "exclusive:a" );
+  CPPUNIT_NS::TestResources ab = CPPUNIT_NS::TestResources::parse( "exclusive:a,exclusive:b" );
+  CPPUNIT_NS::TestResources c = CPPUNIT_NS::TestResources::parse( "exclusive:c,cpu:8" );
+  CPPUNIT_ASSERT( a.conflictsWith( ab ) );
+  CPPUNIT_ASSERT( ab.conflictsWith( a ) );
+  CPPUNIT_ASSERT( !a.conflictsWith( c ) );
+  CPPUNIT_ASSERT( !c.conflictsWith( CPPUNIT_NS::TestResources() ) );
+}
+
+
+void 
+ResourceSchedulerTest::testSuitePropertyIsKept()
+{
+  CPPUNIT_NS::TestSuite *suite = ResourceSchedulerTestFixture::suite();
+  m_suite->addTest( suite );
+  CPPUNIT_ASSERT_EQUAL( std::string( "exclusive:port-8080,cpu:2" ), 
+                        suite->getProperty( "resources" ) );
+
+  CPPUNIT_NS::ResourceScheduler scheduler( 4 );
+  scheduler.addTest( m_suite );
+  CPPUNIT_ASSERT_EQUAL( 1, scheduler.getTestCount() );
+  CPPUNIT_ASSERT_EQUAL( 2, scheduler.getResourcesAt( 0 ).cpuWeight() );
+  CPPUNIT_ASSERT( scheduler.getResourcesAt( 0 ).usesExclusiveResource( "port-8080" ) );
+}
+
+
+void 
+ResourceSchedulerTest::testIndependentTestsShareBatch()
+{
+  addTest( "test1", "" );
+  addTest( "test2", "" );
+  addTest( "test3", "exclusive:a" );
+
+  CPPUNIT_NS::ResourceScheduler scheduler( 4 );
+  scheduler.addTest( m_suite );
+  CPPUNIT_ASSERT_EQUAL( 3, scheduler.getTestCount() );
+  CPPUNIT_ASSERT_EQUAL( 1, scheduler.getBatchCount() );
+  CPPUNIT_ASSERT_EQUAL( 3, int(scheduler.getBatchAt( 0 ).size()) );
+}
+
+
+void 
+ResourceSchedulerTest::testCpuWeightLimitsBatch()
+{
+  CPPUNIT_NS::Test *test1 = addTest( "test1", "cpu:3" );
+  CPPUNIT_NS::Test *test2 = addTest( "test2", "cpu:2" );
+  CPPUNIT_NS::Test *test3 = addTest( "test3", "" );
+
+  CPPUNIT_NS::ResourceScheduler scheduler( 4 );
+  scheduler.addTest( m_suite );
+  CPPUNIT_ASSERT_EQUAL( 2, scheduler.getBatchCount() );
+  CPPUNIT_ASSERT_EQUAL( 2, int(scheduler.getBatchAt( 0 ).size()) );
+  CPPUNIT_ASSERT( test1 == scheduler.getBatchAt( 0 )[0] );
+  CPPUNIT_ASSERT( test3 == scheduler.getBatchAt( 0 )[1] );
+  CPPUNIT_ASSERT_EQUAL( 1, int(scheduler.getBatchAt( 1 ).size()) );
+  CPPUNIT_ASSERT( test2 == scheduler.getBatchAt( 1 )[0] );
+}
+
+
+void 
+ResourceSchedulerTest::testOversizedTestGetsOwnBatch()
+{
+  addTest( "test1", "" );
+  CPPUNIT_NS::Test *test2 = addTest( "test2", "cpu:16" );
+
+  CPPUNIT_NS::ResourceScheduler scheduler( 4 );
+  scheduler.addTest( m_suite );
+  CPPUNIT_ASSERT_EQUAL( 2, scheduler.getBatchCount() );
+  CPPUNIT_ASSERT_EQUAL( 1, int(scheduler.getBatchAt( 1 ).size()) );
+  CPPUNIT_ASSERT( test2 == scheduler.getBatchAt( 1 )[0] );
+}
+
+
+void 
+ResourceSchedulerTest::testExclusiveResourcesAreSerialized()
+{
+  CPPUNIT_NS::Test *test1 = addTest( "test1", "exclusive:port-8080" );
+  CPPUNIT_NS::Test *test2 = addTest( "test2", "exclusive:port-8080" );
+  CPPUNIT_NS::Test *test3 = addTest( "test3", "exclusive:scratch" );
+
+  CPPUNIT_NS::ResourceScheduler scheduler( 8 );
+  scheduler.addTest( m_suite );
+  CPPUNIT_ASSERT_EQUAL( 2, scheduler.getBatchCount() );
+  CPPUNIT_ASSERT( test1 == scheduler.getBatchAt( 0 )[0] );
+  CPPUNIT_ASSERT( test3 == scheduler.getBatchAt( 0 )[1] );
+  CPPUNIT_ASSERT( test2 == scheduler.getBatchAt( 1 )[0] );
+}
+
+
+void 
+ResourceSchedulerTest::testResourcesAreInherited()
+{
+  CPPUNIT_NS::TestSuite *subSuite = new CPPUNIT_NS::TestSuite( "sub" );
+  subSuite->setProperty( "resources", "exclusive:db,cpu:2" );
+  MockTestCase *test1 = new MockTestCase( "test1" );
+  MockTestCase *test2 = new MockTestCase( "test2" );
+  test2->setProperty( "resources", "cpu:1,exclusive:port" );
+  subSuite->addTest( test1 );
+  subSuite->addTest( test2 );
+  m_suite->addTest( subSuite );
+
+  CPPUNIT_NS::ResourceScheduler scheduler( 8 );
+  scheduler.addTest( m_suite );
+  CPPUNIT_ASSERT_EQUAL( 2, scheduler.getTestCount() );
+  CPPUNIT_ASSERT_EQUAL( 2, scheduler.getResourcesAt( 0 ).cpuWeight() );
+  CPPUNIT_ASSERT( scheduler.getResourcesAt( 0 ).usesExclusiveResource( "db" ) );
+  CPPUNIT_ASSERT_EQUAL( 1, scheduler.getResourcesAt( 1 ).cpuWeight() );
+  CPPUNIT_ASSERT( scheduler.getResourcesAt( 1 ).usesExclusiveResource( "db" ) );
+  CPPUNIT_ASSERT( scheduler.getResourcesAt( 1 ).usesExclusiveResource( "port" ) );
+  CPPUNIT_ASSERT_EQUAL( 2, scheduler.getBatchCount() );
+}
+
+
+void 
+ResourceSchedulerTest::testDecoratorIsScheduledAsAWhole()
+{
+  CPPUNIT_NS::TestSuite *subSuite = new CPPUNIT_NS::TestSuite( "sub" );
+  MockTestCase *test1 = new MockTestCase( "test1" );
+  test1->setProperty( "resources", "exclusive:db" );
+  MockTestCase *test2 = new MockTestCase( "test2" );
+  test2->setProperty( "resources", "exclusive:port,cpu:3" );
+  subSuite->addTest( test1 );
+  subSuite->addTest( test2 );
+  CPPUNIT_NS::TestSetUp *setUp = new CPPUNIT_NS::TestSetUp( subSuite );
+  m_suite->addTest( setUp );
+  CPPUNIT_NS::Test *test3 = addTest( "test3", "exclusive:port" );
+
+  CPPUNIT_NS::ResourceScheduler scheduler( 8 );
+  scheduler.addTest( m_suite );
+  CPPUNIT_ASSERT_EQUAL( 2, scheduler.getTestCount() );
+  CPPUNIT_ASSERT( setUp == scheduler.getTestAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( 3, scheduler.getResourcesAt( 0 ).cpuWeight() );
+  CPPUNIT_ASSERT( scheduler.getResourcesAt( 0 ).usesExclusiveResource( "db" ) );
+  CPPUNIT_ASSERT( scheduler.getResourcesAt( 0 ).usesExclusiveResource( "port" ) );
+  CPPUNIT_ASSERT( test3 == scheduler.getTestAt( 1 ) );
+  CPPUNIT_ASSERT_EQUAL( 2, scheduler.getBatchCount() );
+}
+
+
+void 
+ResourceSchedulerTest::testShardsKeepConflictingTestsTogether()
+{
+  CPPUNIT_NS::Test *test1 = addTest( "test1", "exclusive:a" );
+  CPPUNIT_NS::Test *test2 = addTest( "test2", "exclusive:b" );
+  CPPUNIT_NS::Test *test3 = addTest( "test3", "exclusive:a,exclusive:c" );
+  CPPUNIT_NS::Test *test4 = addTest( "test4", "exclusive:c" );
+  CPPUNIT_NS::Test *test5 = addTest( "test5", "" );
+
+  CPPUNIT_NS::ResourceScheduler scheduler( 8 );
+  scheduler.addTest( m_suite );
+  CppUnitVector<CPPUNIT_NS::ResourceScheduler::Tests> shards = 
+      scheduler.makeShards( 2 );
+
+  CPPUNIT_ASSERT_EQUAL( 2, int(shards.size()) );
+  // test1, test3 and test4 are transitively linked by resources a and c.
+  CPPUNIT_ASSERT_EQUAL( 3, int(shards[0].size()) );
+  CPPUNIT_ASSERT( test1 == shards[0][0] );
+  CPPUNIT_ASSERT( test3 == shards[0][1] );
+  CPPUNIT_ASSERT( test4 == shards[0][2] );
+  CPPUNIT_ASSERT_EQUAL( 2, int(shards[1].size()) );
+  CPPUNIT_ASSERT( test2 == shards[1][0] );
+  CPPUNIT_ASSERT( test5 == shards[1][1] );
+}
@@ -0,0 +1,68 @@
+#ifndef RESOURCESCHEDULERTEST_H
+#define RESOURCESCHEDULERTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdexcept>
+
+
+/*! \class ResourceSchedulerTest
+ * \brief Unit test for class ResourceScheduler and TestResources.
+ */
+class ResourceSchedulerTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( ResourceSchedulerTest );
+  CPPUNIT_TEST( testParseResources );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST_EXCEPTION( testParseUnknownKindThrow, std::invalid_argument );
+  CPPUNIT_TEST_EXCEPTION( testParseBadCpuWeightThrow, std::invalid_argument );
+#endif
+  CPPUNIT_TEST( testMergeResources );
+  CPPUNIT_TEST( testConflicts );
+  CPPUNIT_TEST( testSuitePropertyIsKept );
+  CPPUNIT_TEST( testIndependentTestsShareBatch );
+  CPPUNIT_TEST( testCpuWeightLimitsBatch );
+  CPPUNIT_TEST( testOversizedTestGetsOwnBatch );
+  CPPUNIT_TEST( testExclusiveResourcesAreSerialized );
+  CPPUNIT_TEST( testResourcesAreInherited );
+  CPPUNIT_TEST( testDecoratorIsScheduledAsAWhole );
+  CPPUNIT_TEST( testShardsKeepConflictingTestsTogether );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  ResourceSchedulerTest();
+  virtual ~ResourceSchedulerTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testParseResources();
+  void testParseUnknownKindThrow();
+  void testParseBadCpuWeightThrow();
+  void testMergeResources();
+  void testConflicts();
+
+  void testSuitePropertyIsKept();
+
+  void testIndependentTestsShareBatch();
+  void testCpuWeightLimitsBatch();
+  void testOversizedTestGetsOwnBatch();
+  void testExclusiveResourcesAreSerialized();
+  void testResourcesAreInherited();
+  void testDecoratorIsScheduledAsAWhole();
+
+  void testShardsKeepConflictingTestsTogether();
+
+private:
+  ResourceSchedulerTest( const ResourceSchedulerTest &copy );
+  void operator =( const ResourceSchedulerTest &copy );
+
+  CPPUNIT_NS::Test *addTest( const std::string &name,
+                             const std::string &resources );
+
+private:
+  CPPUNIT_NS::TestSuite *m_suite;
+};
+
+
+
+#endif  // RESOURCESCHEDULERTEST_H
@@ -0,0 +1,137 @@
+#include "CoreSuite.h"
+#include "ScopedTraceTest.h"
+#include <cppunit/Exception.h>
+#include <cppunit/ScopedTrace.h>
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( ScopedTraceTest,
+                                       coreSuiteName() );
+
+
+/// Returns the message of a failed assertion.
+static CPPUNIT_NS::Message 
+scopedTraceTestFailure()
+{
+  try
+  {
+    CPPUNIT_NS::Asserter::fail( CPPUNIT_NS::Message( "failed" ) );
+  }
+  catch ( CPPUNIT_NS::Exception &e )
+  {
+    return e.message();
+  }
+  return CPPUNIT_NS::Message();
+}
+
+
+/// Trace context with a constant description.
+class ScopedTraceTestContext : public CPPUNIT_NS::TraceContext
+{
+public:
+  std::string describe() const
+  {
+    return "loading orders.csv";
+  }
+};
+
+
+ScopedTraceTest::ScopedTraceTest()
+{
+}
+
+
+ScopedTraceTest::~ScopedTraceTest()
+{
+}
+
+
+void 
+ScopedTraceTest::testNoTrace()
+{
+  CPPUNIT_ASSERT( CPPUNIT_NS::TraceContext::current() == NULL );
+  CPPUNIT_ASSERT_EQUAL( 0, scopedTraceTestFailure().detailCount() );
+}
+
+
+void 
+ScopedTraceTest::testTraceIsAddedToFailure()
+{
+  CPPUNIT_NS::Message failure;
+  for ( int index = 0; index < 4; ++index )
+  {
+    CPPUNIT_SCOPED_TRACE( index );
+    if ( index == 2 )
+      failure = scopedTraceTestFailure();
+  }
+
+  CPPUNIT_ASSERT_EQUAL( 1, failure.detailCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "Trace: index = 2" ), 
+                        failure.detailAt( 0 ) );
+}
+
+
+void 
+ScopedTraceTest::testOutermostTraceFirst()
+{
+  int row = 2;
+  CPPUNIT_SCOPED_TRACE( row );
+  std::string column( "price" );
+  CPPUNIT_SCOPED_TRACE( column );
+
+  CPPUNIT_NS::Message failure = scopedTraceTestFailure();
+  CPPUNIT_ASSERT_EQUAL( 2, failure.detailCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "Trace: row = 2" ), 
+                        failure.detailAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( std::string( "Trace: column = price" ), 
+                        failure.detailAt( 1 ) );
+}
+
+
+void 
+ScopedTraceTest::testTraceEndsWithScope()
+{
+  {
+    CPPUNIT_SCOPED_TRACE( 1 + 2 );
+    CPPUNIT_ASSERT_EQUAL( std::string( "Trace: 1 + 2 = 3" ), 
+                          scopedTraceTestFailure().detailAt( 0 ) );
+  }
+
+  CPPUNIT_ASSERT( CPPUNIT_NS::TraceContext::current() == NULL );
+  CPPUNIT_ASSERT_EQUAL( 0, scopedTraceTestFailure().detailCount() );
+}
+
+
+void 
+ScopedTraceTest::testValueIsCopied()
+{
+  int count = 1;
+  CPPUNIT_SCOPED_TRACE( count );
+  count = 5;
+
+  CPPUNIT_ASSERT_EQUAL( std::string( "Trace: count = 1" ), 
+                        scopedTraceTestFailure().detailAt( 0 ) );
+}
+
+
+void 
+ScopedTraceTest::testCustomContext()
+{
+  ScopedTraceTestContext context;
+  CPPUNIT_ASSERT( &context == CPPUNIT_NS::TraceContext::current() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "Trace: loading orders.csv" ), 
+                        scopedTraceTestFailure().detailAt( 0 ) );
+}
+
+
+void 
+ScopedTraceTest::testUnwindTo()
+{
+  ScopedTraceTestContext outer;
+  ScopedTraceTestContext *inner = new ScopedTraceTestContext();
+
+  CPPUNIT_NS::TraceContext::unwindTo( &outer );
+  CPPUNIT_ASSERT( &outer == CPPUNIT_NS::TraceContext::current() );
+  // Destroying a context no longer in the stack leaves the stack unchanged.
+  delete inner;
+  CPPUNIT_ASSERT( &outer == CPPUNIT_NS::TraceContext::current() );
+}
@@ -0,0 +1,40 @@
+#ifndef SCOPEDTRACETEST_H
+#define SCOPEDTRACETEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+/// Unit tests for TraceContext and CPPUNIT_SCOPED_TRACE.
+class ScopedTraceTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( ScopedTraceTest );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testNoTrace );
+  CPPUNIT_TEST( testTraceIsAddedToFailure );
+  CPPUNIT_TEST( testOutermostTraceFirst );
+  CPPUNIT_TEST( testTraceEndsWithScope );
+  CPPUNIT_TEST( testValueIsCopied );
+  CPPUNIT_TEST( testCustomContext );
+#endif
+  CPPUNIT_TEST( testUnwindTo );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  ScopedTraceTest();
+  virtual ~ScopedTraceTest();
+
+  void testNoTrace();
+  void testTraceIsAddedToFailure();
+  void testOutermostTraceFirst();
+  void testTraceEndsWithScope();
+  void testValueIsCopied();
+  void testCustomContext();
+  void testUnwindTo();
+
+private:
+  ScopedTraceTest( const ScopedTraceTest &other );
+  void operator =( const ScopedTraceTest &other );
+};
+
+
+#endif  // SCOPEDTRACETEST_H
@@ -0,0 +1,301 @@
+#include "ExtensionSuite.h"
+#include "SnapshotTest.h"
+#include <cppunit/tools/MappedFile.h>
+#include <cppunit/tools/ThreadGroup.h>
+#include <stdio.h>
+
+#if defined(CPPUNIT_HAVE_SYS_STAT_H)
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( SnapshotTest,
+                                       extensionSuiteName() );
+
+
+/// Directory of the snapshots written by the tests.
+static const char *snapshotTestDirectory = "snapshottest-dir";
+
+
+/// Updates the same snapshot from several threads.
+class SnapshotUpdateTask : public CPPUNIT_NS::ThreadTask
+{
+public:
+  SnapshotUpdateTask( const CPPUNIT_NS::SnapshotStore &store )
+      : m_store( store )
+  {
+  }
+
+  void run( int threadIndex )
+  {
+    std::string content( 10000, char('a' + threadIndex) );
+    for ( int count =0; count < 20; ++count )
+      m_store.write( "concurrent.txt", content.data(), content.size() );
+  }
+
+private:
+  const CPPUNIT_NS::SnapshotStore &m_store;
+};
+
+
+SnapshotTest::SnapshotTest()
+    : m_store( NULL )
+{
+}
+
+
+SnapshotTest::~SnapshotTest()
+{
+}
+
+
+void 
+SnapshotTest::setUp()
+{
+  m_store = new CPPUNIT_NS::SnapshotStore( snapshotTestDirectory );
+  m_store->setUpdateMode( false );
+
+  CPPUNIT_NS::SnapshotStore &defaultStore = CPPUNIT_NS::SnapshotStore::getStore();
+  m_defaultDirectory = defaultStore.directory();
+  m_defaultUpdateMode = defaultStore.isUpdateMode();
+}
+
+
+void 
+SnapshotTest::tearDown()
+{
+  static const char *names[] = { 
+    "missing.txt", "text.txt", "long.txt", "binary.bin", "concurrent.txt", 
+    "macro.txt", "directory.txt", "sub/nested/created.txt", "sub/nested", "sub", NULL
+  };
+  for ( const char **name = names; *name != NULL; ++name )
+    remove( m_store->pathFor( *name ).c_str() );
+  remove( snapshotTestDirectory );
+
+  delete m_store;
+  CPPUNIT_NS::SnapshotStore &defaultStore = CPPUNIT_NS::SnapshotStore::getStore();
+  defaultStore.setDirectory( m_defaultDirectory );
+  defaultStore.setUpdateMode( m_defaultUpdateMode );
+}
+
+
+void 
+SnapshotTest::writeSnapshot( const std::string &name, 
+                             const std::string &content )
+{
+  m_store->write( name, content.data(), content.size() );
+}
+
+
+std::string 
+SnapshotTest::readSnapshot( const std::string &name ) const
+{
+  CPPUNIT_NS::MappedFile file( m_store->pathFor( name ) );
+  return std::string( (const char *)file.data(), file.size() );
+}
+
+
+CPPUNIT_NS::Message 
+SnapshotTest::checkSnapshot( const std::string &name, 
+                             const std::string &content )
+{
+  CPPUNIT_NS::Message failure;
+  CPPUNIT_ASSERT( !m_store->check( name, content.data(), content.size(), failure ) );
+  return failure;
+}
+
+
+void 
+SnapshotTest::testFindFirstDifference()
+{
+  std::string expected( 10000, 'x' );
+  std::string actual( expected );
+  const unsigned char *expectedData = (const unsigned char *)expected.data();
+
+  CPPUNIT_ASSERT_EQUAL( size_t(10000), 
+      CPPUNIT_NS::SnapshotStore::findFirstDifference( 
+          expectedData, (const unsigned char *)actual.data(), actual.size() ) );
+
+  actual[ 0 ] = 'y';
+  CPPUNIT_ASSERT_EQUAL( size_t(0), 
+      CPPUNIT_NS::SnapshotStore::findFirstDifference( 
+          expectedData, (const unsigned char *)actual.data(), actual.size() ) );
+
+  actual[ 0 ] = 'x';
+  actual[ 9999 ] = 'y';
+  actual[ 5000 ] = 'y';
+  CPPUNIT_ASSERT_EQUAL( size_t(5000), 
+      CPPUNIT_NS::SnapshotStore::findFirstDifference( 
+          expectedData, (const unsigned char *)actual.data(), actual.size() ) );
+
+  CPPUNIT_ASSERT_EQUAL( size_t(0), 
+      CPPUNIT_NS::SnapshotStore::findFirstDifference( 
+          expectedData, (const unsigned char *)actual.data(), 0 ) );
+}
+
+
+void 
+SnapshotTest::testMissingSnapshotFails()
+{
+  CPPUNIT_NS::Message failure = checkSnapshot( "missing.txt", "data" );
+
+  CPPUNIT_ASSERT_EQUAL( std::string("snapshot not found"), 
+                        failure.shortDescription() );
+  CPPUNIT_ASSERT_EQUAL( "Snapshot: " + m_store->pathFor( "missing.txt" ), 
+                        failure.detailAt( 0 ) );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_ASSERT_THROW( readSnapshot( "missing.txt" ), std::runtime_error );
+#endif
+}
+
+
+void 
+SnapshotTest::testUnreadableSnapshotThrows()
+{
+#if defined(CPPUNIT_HAVE_SYS_STAT_H)  &&  defined(CPPUNIT_HAVE_MMAP)
+  // A directory exists but can not be read as a snapshot.
+  ::mkdir( snapshotTestDirectory, 0777 );
+  ::mkdir( m_store->pathFor( "directory.txt" ).c_str(), 0777 );
+  m_store->setUpdateMode( true );
+
+  CPPUNIT_ASSERT_THROW( checkSnapshot( "directory.txt", "data" ), 
+                        std::runtime_error );
+#endif
+}
+
+
+void 
+SnapshotTest::testUpdateModeWritesSnapshot()
+{
+  m_store->setUpdateMode( true );
+  std::string content( "created\n" );
+  CPPUNIT_NS::Message failure;
+  CPPUNIT_ASSERT( m_store->check( "sub/nested/created.txt", 
+                                  content.data(), 
+                                  content.size(), 
+                                  failure ) );
+
+  CPPUNIT_ASSERT_EQUAL( content, readSnapshot( "sub/nested/created.txt" ) );
+}
+
+
+void 
+SnapshotTest::testMatchingSnapshot()
+{
+  writeSnapshot( "text.txt", "line 1\nline 2\n" );
+  std::string content( "line 1\nline 2\n" );
+  CPPUNIT_NS::Message failure;
+  CPPUNIT_ASSERT( m_store->check( "text.txt", 
+                                  content.data(), 
+                                  content.size(), 
+                                  failure ) );
+
+  std::string empty;
+  writeSnapshot( "text.txt", empty );
+  CPPUNIT_ASSERT( m_store->check( "text.txt", empty.data(), 0, failure ) );
+}
+
+
+void 
+SnapshotTest::testTextMismatchShowsContext()
+{
+  writeSnapshot( "text.txt", "one\ntwo\nthree\nfour\nfive\nsix\nseven\n" );
+  CPPUNIT_NS::Message failure = 
+      checkSnapshot( "text.txt", "one\ntwo\nthree\nfour\nFIVE\nsix\nseven\n" );
+
+  CPPUNIT_ASSERT_EQUAL( std::string("snapshot mismatch"), 
+                        failure.shortDescription() );
+  std::string details = failure.details();
+  CPPUNIT_ASSERT( details.find( "Expected 34 bytes, actual 34 bytes" ) != 
+                  std::string::npos );
+  CPPUNIT_ASSERT( details.find( "First difference at byte 19, line 5, column 1" ) != 
+                  std::string::npos );
+  CPPUNIT_ASSERT( details.find( "Expected line 3: three" ) != std::string::npos );
+  CPPUNIT_ASSERT( details.find( "Expected line 5: five" ) != std::string::npos );
+  CPPUNIT_ASSERT( details.find( "Actual   line 5: FIVE" ) != std::string::npos );
+  CPPUNIT_ASSERT( details.find( "Actual   line 7: seven" ) != std::string::npos );
+  CPPUNIT_ASSERT( details.find( "line 2:" ) == std::string::npos );
+  CPPUNIT_ASSERT( details.find( "--update-snapshots" ) != std::string::npos );
+}
+
+
+void 
+SnapshotTest::testLongLinesAreTruncated()
+{
+  std::string expected( 1000, 'a' );
+  std::string actual( expected );
+  actual[ 500 ] = 'b';
+  writeSnapshot( "long.txt", expected );
+  CPPUNIT_NS::Message failure = checkSnapshot( "long.txt", actual + "tail" );
+
+  std::string details = failure.details();
+  CPPUNIT_ASSERT( details.find( "Expected 1000 bytes, actual 1004 bytes" ) != 
+                  std::string::npos );
+  CPPUNIT_ASSERT( details.find( "line 1, column 501" ) != std::string::npos );
+  CPPUNIT_ASSERT( details.find( std::string( 120, 'a' ) + "..." ) != 
+                  std::string::npos );
+  CPPUNIT_ASSERT( details.size() < 1000 );
+}
+
+
+void 
+SnapshotTest::testBinaryMismatchShowsDump()
+{
+  std::string expected( "\x00\x01\x02\x03" "abcdefghijklmnopqrstuvwxyz", 30 );
+  std::string actual( expected );
+  actual[ 20 ] = '\x7f';
+  writeSnapshot( "binary.bin", expected );
+  CPPUNIT_NS::Message failure = checkSnapshot( "binary.bin", actual );
+
+  std::string details = failure.details();
+  CPPUNIT_ASSERT( details.find( "First difference at byte 20" ) != 
+                  std::string::npos );
+  CPPUNIT_ASSERT( details.find( "Expected at 0x10: 6d 6e 6f 70 71 72" ) != 
+                  std::string::npos );
+  CPPUNIT_ASSERT( details.find( "Actual   at 0x10: 6d 6e 6f 70 7f 72" ) != 
+                  std::string::npos );
+  CPPUNIT_ASSERT( details.find( "line" ) == std::string::npos );
+}
+
+
+void 
+SnapshotTest::testUpdateModeReplacesSnapshot()
+{
+  writeSnapshot( "text.txt", "old\n" );
+  m_store->setUpdateMode( true );
+  std::string content( "new\n" );
+  CPPUNIT_NS::Message failure;
+  CPPUNIT_ASSERT( m_store->check( "text.txt", 
+                                  content.data(), 
+                                  content.size(), 
+                                  failure ) );
+
+  CPPUNIT_ASSERT_EQUAL( content, readSnapshot( "text.txt" ) );
+}
+
+
+void 
+SnapshotTest::testConcurrentUpdates()
+{
+  SnapshotUpdateTask task( *m_store );
+  CPPUNIT_NS::ThreadGroup::run( task, 4 );
+
+  std::string content = readSnapshot( "concurrent.txt" );
+  CPPUNIT_ASSERT_EQUAL( size_t(10000), content.size() );
+  CPPUNIT_ASSERT_EQUAL( std::string( 10000, content[0] ), content );
+}
+
+
+void 
+SnapshotTest::testSnapshotMacro()
+{
+  CPPUNIT_NS::SnapshotStore::getStore().setDirectory( snapshotTestDirectory );
+  CPPUNIT_NS::SnapshotStore::getStore().setUpdateMode( false );
+  writeSnapshot( "macro.txt", "expected" );
+
+  CPPUNIT_ASSERT_MATCHES_SNAPSHOT( "macro.txt", std::string( "expected" ) );
+  CPPUNIT_ASSERT_MATCHES_SNAPSHOT_BUFFER( "macro.txt", "expected", 8 );
+  CPPUNIT_ASSERT_ASSERTION_FAIL( 
+      CPPUNIT_ASSERT_MATCHES_SNAPSHOT( "macro.txt", std::string( "actual" ) ) );
+}
@@ -0,0 +1,70 @@
+#ifndef SNAPSHOTTEST_H
+#define SNAPSHOTTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/Snapshot.h>
+
+
+/*! \class SnapshotTest
+ * \brief Unit test for SnapshotStore and CPPUNIT_ASSERT_MATCHES_SNAPSHOT.
+ */
+class SnapshotTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( SnapshotTest );
+  CPPUNIT_TEST( testFindFirstDifference );
+  CPPUNIT_TEST( testMissingSnapshotFails );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testUnreadableSnapshotThrows );
+#endif
+  CPPUNIT_TEST( testUpdateModeWritesSnapshot );
+  CPPUNIT_TEST( testMatchingSnapshot );
+  CPPUNIT_TEST( testTextMismatchShowsContext );
+  CPPUNIT_TEST( testLongLinesAreTruncated );
+  CPPUNIT_TEST( testBinaryMismatchShowsDump );
+  CPPUNIT_TEST( testUpdateModeReplacesSnapshot );
+  CPPUNIT_TEST( testConcurrentUpdates );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testSnapshotMacro );
+#endif
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  SnapshotTest();
+  virtual ~SnapshotTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testFindFirstDifference();
+  void testMissingSnapshotFails();
+  void testUnreadableSnapshotThrows();
+  void testUpdateModeWritesSnapshot();
+  void testMatchingSnapshot();
+  void testTextMismatchShowsContext();
+  void testLongLinesAreTruncated();
+  void testBinaryMismatchShowsDump();
+  void testUpdateModeReplacesSnapshot();
+  void testConcurrentUpdates();
+  void testSnapshotMacro();
+
+private:
+  SnapshotTest( const SnapshotTest &copy );
+  void operator =( const SnapshotTest &copy );
+
+  void writeSnapshot( const std::string &name, 
+                      const std::string &content );
+
+  std::string readSnapshot( const std::string &name ) const;
+
+  CPPUNIT_NS::Message checkSnapshot( const std::string &name, 
+                                     const std::string &content );
+
+private:
+  CPPUNIT_NS::SnapshotStore *m_store;
+  std::string m_defaultDirectory;
+  bool m_defaultUpdateMode;
+};
+
+
+
+#endif  // SNAPSHOTTEST_H
@@ -0,0 +1,203 @@
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/extensions/TestSuiteFactory.h>
+#include <cppunit/tools/Clock.h>
+#include <stdexcept>
+#include "ExtensionSuite.h"
+#include "StartupProfileTest.h"
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( StartupProfileTest,
+                                       extensionSuiteName() );
+
+
+/// Fixture made by the registries of testRegistryMakeTest().
+class StartupFixture : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( StartupFixture );
+  CPPUNIT_TEST( testNothing );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testNothing()
+  {
+  }
+};
+
+
+/// Factory that fails to make its suite.
+class StartupThrowingFactory : public CPPUNIT_NS::TestFactory
+{
+public:
+  CPPUNIT_NS::Test *makeTest()
+  {
+    throw std::runtime_error( "fixture failed" );
+  }
+};
+
+
+StartupProfileTest::StartupProfileTest()
+{
+}
+
+
+StartupProfileTest::~StartupProfileTest()
+{
+}
+
+
+void 
+StartupProfileTest::setUp()
+{
+  m_profile = new CPPUNIT_NS::StartupProfile();
+  m_profile->setEnabled( true );
+}
+
+
+void 
+StartupProfileTest::tearDown()
+{
+  delete m_profile;
+  CPPUNIT_NS::StartupProfile::getProfile().setEnabled( false );
+  CPPUNIT_NS::StartupProfile::getProfile().reset();
+}
+
+
+void 
+StartupProfileTest::testConstructor()
+{
+  CPPUNIT_NS::StartupProfile profile;
+  CPPUNIT_ASSERT( !profile.isEnabled() );
+  CPPUNIT_ASSERT_EQUAL( 0, profile.phaseCount() );
+  CPPUNIT_ASSERT_EQUAL( 0, profile.factoryCount() );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0, profile.totalSeconds(), 1e-12 );
+}
+
+
+void 
+StartupProfileTest::testDisabledIgnoresTimes()
+{
+  m_profile->setEnabled( false );
+  m_profile->addPhaseTime( "load plug-in", 1.0 );
+  m_profile->enterFactory();
+  m_profile->exitFactory( "All Tests", "Fixture" );
+
+  CPPUNIT_ASSERT_EQUAL( 0, m_profile->phaseCount() );
+  CPPUNIT_ASSERT_EQUAL( 0, m_profile->factoryCount() );
+}
+
+
+void 
+StartupProfileTest::testAddPhaseTime()
+{
+  m_profile->addPhaseTime( "load plug-in a.so", 0.25 );
+  m_profile->addPhaseTime( "make tests", 0.5 );
+  m_profile->addPhaseTime( "load plug-in a.so", 0.125 );
+
+  CPPUNIT_ASSERT_EQUAL( 2, m_profile->phaseCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string("load plug-in a.so"), 
+                        m_profile->phaseNameAt( 0 ) );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.375, m_profile->phaseSecondsAt( 0 ), 1e-12 );
+  CPPUNIT_ASSERT_EQUAL( std::string("make tests"), m_profile->phaseNameAt( 1 ) );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.875, m_profile->totalSeconds(), 1e-12 );
+}
+
+
+void 
+StartupProfileTest::testNestedFactories()
+{
+  m_profile->enterFactory();
+  m_profile->enterFactory();
+  CPPUNIT_NS::Clock::sleepUntil( CPPUNIT_NS::Clock::now() + 0.02 );
+  m_profile->exitFactory( "Nested", "SlowFixture" );
+  m_profile->exitFactory( "All Tests", "Nested" );
+
+  CPPUNIT_ASSERT_EQUAL( 2, m_profile->factoryCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string("Nested"), m_profile->factoryRegistryAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( std::string("SlowFixture"), m_profile->factorySuiteAt( 0 ) );
+  CPPUNIT_ASSERT( m_profile->factorySecondsAt( 0 ) >= 0.019 );
+  // The time of the nested registry excludes the time of its fixture.
+  CPPUNIT_ASSERT_EQUAL( std::string("Nested"), m_profile->factorySuiteAt( 1 ) );
+  CPPUNIT_ASSERT( m_profile->factorySecondsAt( 1 ) < 0.019 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( m_profile->factorySecondsAt( 0 ), 
+                                m_profile->registrySeconds( "Nested" ), 
+                                1e-12 );
+}
+
+
+void 
+StartupProfileTest::testRegistryMakeTest()
+{
+  CPPUNIT_NS::StartupProfile &profile = CPPUNIT_NS::StartupProfile::getProfile();
+  profile.reset();
+  profile.setEnabled( true );
+
+  CPPUNIT_NS::TestSuiteFactory<StartupFixture> fixtureFactory;
+  CPPUNIT_NS::TestFactoryRegistry nested( "StartupNested" );
+  nested.registerFactory( &fixtureFactory );
+  CPPUNIT_NS::TestFactoryRegistry registry( "StartupRoot" );
+  registry.registerFactory( &nested );
+  delete registry.makeTest();
+
+  CPPUNIT_ASSERT_EQUAL( 2, profile.factoryCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string("StartupNested"), profile.factoryRegistryAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( std::string("StartupFixture"), profile.factorySuiteAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( std::string("StartupRoot"), profile.factoryRegistryAt( 1 ) );
+  CPPUNIT_ASSERT_EQUAL( std::string("StartupNested"), profile.factorySuiteAt( 1 ) );
+}
+
+
+void 
+StartupProfileTest::testThrowingFactoryIsAbandoned()
+{
+  CPPUNIT_NS::StartupProfile &profile = CPPUNIT_NS::StartupProfile::getProfile();
+  profile.reset();
+  profile.setEnabled( true );
+
+  StartupThrowingFactory throwingFactory;
+  CPPUNIT_NS::TestFactoryRegistry nested( "StartupThrowing" );
+  nested.registerFactory( &throwingFactory );
+  CPPUNIT_NS::TestFactoryRegistry registry( "StartupRoot" );
+  registry.registerFactory( &nested );
+
+  CPPUNIT_ASSERT_THROW( registry.makeTest(), std::runtime_error );
+  CPPUNIT_ASSERT( !profile.isTimingFactory() );
+  CPPUNIT_ASSERT_EQUAL( 0, profile.factoryCount() );
+}
+
+
+void 
+StartupProfileTest::testReset()
+{
+  m_profile->addPhaseTime( "make tests", 0.5 );
+  m_profile->enterFactory();
+  m_profile->exitFactory( "All Tests", "Fixture" );
+  m_profile->reset();
+
+  CPPUNIT_ASSERT( m_profile->isEnabled() );
+  CPPUNIT_ASSERT_EQUAL( 0, m_profile->phaseCount() );
+  CPPUNIT_ASSERT_EQUAL( 0, m_profile->factoryCount() );
+}
+
+
+void 
+StartupProfileTest::testWrite()
+{
+  m_profile->addPhaseTime( "load plug-in a.so", 0.002 );
+  m_profile->addPhaseTime( "make tests", 0.001 );
+  m_profile->enterFactory();
+  m_profile->exitFactory( "All Tests", "FastFixture" );
+  m_profile->enterFactory();
+  CPPUNIT_NS::Clock::sleepUntil( CPPUNIT_NS::Clock::now() + 0.01 );
+  m_profile->exitFactory( "All Tests", "SlowFixture" );
+
+  CPPUNIT_NS::OStringStream stream;
+  m_profile->write( stream, 1 );
+  std::string report = stream.str();
+
+  CPPUNIT_ASSERT_EQUAL( 0, int(report.find( "Startup profile: 3.000 ms\n" )) );
+  CPPUNIT_ASSERT( report.find( "       2.000  load plug-in a.so\n" ) != 
+                  std::string::npos );
+  CPPUNIT_ASSERT( report.find( "         2  All Tests\n" ) != std::string::npos );
+  CPPUNIT_ASSERT( report.find( "All Tests / SlowFixture\n" ) != std::string::npos );
+  CPPUNIT_ASSERT( report.find( "FastFixture" ) == std::string::npos );
+}
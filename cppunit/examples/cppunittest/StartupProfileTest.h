@@ -0,0 +1,52 @@
+#ifndef STARTUPPROFILETEST_H
+#define STARTUPPROFILETEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/StartupProfile.h>
+
+
+/*! \class StartupProfileTest
+ * \brief Unit test for StartupProfile.
+ */
+class StartupProfileTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( StartupProfileTest );
+  CPPUNIT_TEST( testConstructor );
+  CPPUNIT_TEST( testDisabledIgnoresTimes );
+  CPPUNIT_TEST( testAddPhaseTime );
+  CPPUNIT_TEST( testNestedFactories );
+  CPPUNIT_TEST( testRegistryMakeTest );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testThrowingFactoryIsAbandoned );
+#endif
+  CPPUNIT_TEST( testReset );
+  CPPUNIT_TEST( testWrite );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  StartupProfileTest();
+  virtual ~StartupProfileTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testConstructor();
+  void testDisabledIgnoresTimes();
+  void testAddPhaseTime();
+  void testNestedFactories();
+  void testRegistryMakeTest();
+  void testThrowingFactoryIsAbandoned();
+  void testReset();
+  void testWrite();
+
+private:
+  StartupProfileTest( const StartupProfileTest &copy );
+  void operator =( const StartupProfileTest &copy );
+
+private:
+  CPPUNIT_NS::StartupProfile *m_profile;
+};
+
+
+
+#endif  // STARTUPPROFILETEST_H
@@ -231,3 +231,13 @@ StringToolsTest::testWrapNotNeededEmptyLinesOneNeeded()
   CPPUNIT_ASSERT_EQUAL( expected, actual );
 }
 
+
+
+void 
+StringToolsTest::testTrim()
+{
+  CPPUNIT_ASSERT_EQUAL( std::string( "" ), CPPUNIT_NS::StringTools::trim( "" ) );
+  CPPUNIT_ASSERT_EQUAL( std::string( "" ), CPPUNIT_NS::StringTools::trim( " \t\n " ) );
+  CPPUNIT_ASSERT_EQUAL( std::string( "a b" ), CPPUNIT_NS::StringTools::trim( "a b" ) );
+  CPPUNIT_ASSERT_EQUAL( std::string( "a b" ), CPPUNIT_NS::StringTools::trim( "  a b\t" ) );
+}
@@ -26,6 +26,7 @@ class StringToolsTest : public CPPUNIT_NS::TestCase
   CPPUNIT_TEST( testWrapLimitTwoNeeded );
   CPPUNIT_TEST( testWrapOneNeededTwoNeeded );
   CPPUNIT_TEST( testWrapNotNeededEmptyLinesOneNeeded );
+  CPPUNIT_TEST( testTrim );
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -59,6 +60,8 @@ public:
   void testWrapOneNeededTwoNeeded();
   void testWrapNotNeededEmptyLinesOneNeeded();
 
+  void testTrim();
+
 private:
   /// Prevents the use of the copy constructor.
   StringToolsTest( const StringToolsTest &other );
@@ -7,18 +7,22 @@
 class TestAssertTest : public CPPUNIT_NS::TestFixture
 {
   CPPUNIT_TEST_SUITE( TestAssertTest );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST( testAssertThrow );
   CPPUNIT_TEST( testAssertNoThrow );
   CPPUNIT_TEST( testAssertAssertionFail );
   CPPUNIT_TEST( testAssertAssertionPass );
   CPPUNIT_TEST( testAssert );
   CPPUNIT_TEST( testAssertEqual );
+#endif
   CPPUNIT_TEST( testAssertMessageTrue );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST( testAssertMessageFalse );
   CPPUNIT_TEST( testAssertDoubleEquals );
   CPPUNIT_TEST( testAssertDoubleEqualsPrecision );
   CPPUNIT_TEST( testAssertDoubleNonFinite );
   CPPUNIT_TEST( testFail );
+#endif
   CPPUNIT_TEST_SUITE_END();
 
 public:
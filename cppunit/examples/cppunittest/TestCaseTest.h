@@ -15,17 +15,23 @@
 class TestCaseTest : public CPPUNIT_NS::TestFixture
 {
   CPPUNIT_TEST_SUITE( TestCaseTest );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST( testSetUpFailure );
   CPPUNIT_TEST( testRunTestFailure );
   CPPUNIT_TEST( testTearDownFailure );
   CPPUNIT_TEST( testFailAll );
+#endif
   CPPUNIT_TEST( testNoFailure );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST( testTwoRun );
+#endif
   CPPUNIT_TEST( testCountTestCases );
   CPPUNIT_TEST( testDefaultConstructor );
   CPPUNIT_TEST( testConstructorWithName );
   CPPUNIT_TEST( testGetChildTestCount );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST_EXCEPTION( testGetChildTestAtThrow, std::out_of_range );
+#endif
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -15,25 +15,37 @@ class TestPathTest : public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST_SUITE( TestPathTest );
   CPPUNIT_TEST( testDefaultConstructor );
   CPPUNIT_TEST( testAddTest );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST_EXCEPTION( testGetTestAtThrow1, std::out_of_range );
   CPPUNIT_TEST_EXCEPTION( testGetTestAtThrow2, std::out_of_range );
+#endif
   CPPUNIT_TEST( testGetChildTest );
   CPPUNIT_TEST( testGetChildTestManyTests );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST_EXCEPTION( testGetChildTestThrowIfNotValid, std::out_of_range );
+#endif
   CPPUNIT_TEST( testAddPath );
   CPPUNIT_TEST( testAddInvalidPath );
   CPPUNIT_TEST( testRemoveTests );
   CPPUNIT_TEST( testRemoveTest );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST_EXCEPTION( testRemoveTestThrow1, std::out_of_range );
   CPPUNIT_TEST_EXCEPTION( testRemoveTestThrow2, std::out_of_range );
+#endif
   CPPUNIT_TEST( testUp );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST_EXCEPTION( testUpThrow, std::out_of_range );
+#endif
   CPPUNIT_TEST( testInsert );
   CPPUNIT_TEST( testInsertAtEnd );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST_EXCEPTION( testInsertThrow1, std::out_of_range );
   CPPUNIT_TEST_EXCEPTION( testInsertThrow2, std::out_of_range );
+#endif
   CPPUNIT_TEST( testInsertPath );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST_EXCEPTION( testInsertPathThrow, std::out_of_range );
+#endif
   CPPUNIT_TEST( testInsertPathDontThrowIfInvalid );
   CPPUNIT_TEST( testRootConstructor );
   CPPUNIT_TEST( testPathSliceConstructorCopyUntilEnd );
@@ -49,12 +61,18 @@ class TestPathTest : public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST( testPathStringConstructorRoot );
   CPPUNIT_TEST( testPathStringConstructorEmptyIsRoot );
   CPPUNIT_TEST( testPathStringConstructorHierarchy );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST_EXCEPTION( testPathStringConstructorBadRootThrow, std::invalid_argument );
+#endif
   CPPUNIT_TEST( testPathStringConstructorRelativeRoot );
   CPPUNIT_TEST( testPathStringConstructorRelativeRoot2 );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST_EXCEPTION( testPathStringConstructorThrow1, std::invalid_argument );
+#endif
   CPPUNIT_TEST( testPathStringConstructorRelativeHierarchy );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST_EXCEPTION( testPathStringConstructorBadRelativeHierarchyThrow, std::invalid_argument );
+#endif
   CPPUNIT_TEST_SUITE_END();
 
 public:
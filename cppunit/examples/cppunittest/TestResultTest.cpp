@@ -1,3 +1,4 @@
+#include <cppunit/CallbackProfile.h>
 #include "CoreSuite.h"
 #include "MockFunctor.h"
 #include "MockProtector.h"
@@ -266,3 +267,30 @@ TestResultTest::testProtectChainPushTwoTrap()
   m_listener1->verify();
   functor.verify();
 }
+
+
+void 
+TestResultTest::testProfile()
+{
+  CPPUNIT_ASSERT( m_result->profile() == NULL );
+  CPPUNIT_NS::CallbackProfile profile;
+  m_result->setProfile( &profile );
+  CPPUNIT_ASSERT( m_result->profile() == &profile );
+  m_listener1->setExpectStartTest( m_dummyTest );
+  m_listener1->setExpectedStartTestCall( 2 );
+  m_listener1->setExpectEndTest( m_dummyTest );
+  m_result->addListener( m_listener1 );
+
+  m_result->startTest( m_dummyTest );
+  m_result->endTest( m_dummyTest );
+
+  CPPUNIT_ASSERT_EQUAL( 2, profile.entryCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string("startTest"), profile.eventAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( std::string("endTest"), profile.eventAt( 1 ) );
+  CPPUNIT_ASSERT_EQUAL( 1L, profile.callCountAt( 1 ) );
+
+  m_result->setProfile( NULL );
+  m_result->startTest( m_dummyTest );
+  CPPUNIT_ASSERT_EQUAL( 1L, profile.callCountAt( 0 ) );
+  m_listener1->verify();
+}
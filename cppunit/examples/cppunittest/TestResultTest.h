@@ -21,10 +21,15 @@ class TestResultTest : public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST( testTwoListener );
   CPPUNIT_TEST( testDefaultProtectSucceed );
   CPPUNIT_TEST( testDefaultProtectFail );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST( testDefaultProtectFailIfThrow );
+#endif
   CPPUNIT_TEST( testProtectChainPushOneTrap );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST( testProtectChainPushOnePassThrough );
+#endif
   CPPUNIT_TEST( testProtectChainPushTwoTrap );
+  CPPUNIT_TEST( testProfile );
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -56,6 +61,8 @@ public:
 
   void testProtectChainPushTwoTrap();
 
+  void testProfile();
+
 private:
   TestResultTest( const TestResultTest &copy );
   void operator =( const TestResultTest &copy );
@@ -18,8 +18,10 @@ class TestSuiteTest : public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST( testDeleteContents );
   CPPUNIT_TEST( testGetChildTestCount );
   CPPUNIT_TEST( testGetChildTestAt );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST_EXCEPTION( testGetChildTestAtThrow1, std::out_of_range );
   CPPUNIT_TEST_EXCEPTION( testGetChildTestAtThrow2, std::out_of_range );
+#endif
   CPPUNIT_TEST_SUITE_END();
 
 public:
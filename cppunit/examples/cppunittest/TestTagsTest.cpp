@@ -0,0 +1,413 @@
+#include "ExtensionSuite.h"
+#include "TestTagsTest.h"
+#include "MockTestCase.h"
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/extensions/ResourceScheduler.h>
+#include <cppunit/extensions/TestSetUp.h>
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( TestTagsTest,
+                                       extensionSuiteName() );
+
+
+/// Fixture used to check the tags declared with the helper macros.
+class TestTagsTestFixture : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( TestTagsTestFixture );
+  CPPUNIT_TEST_SUITE_TAGS( "db" );
+  CPPUNIT_TEST_TAGS( testSlow, "slow, perf" );
+  CPPUNIT_TEST_TAGS( testPerf, "perf" );
+  CPPUNIT_TEST( testUntagged );
+  CPPUNIT_TEST_SUITE_END();
+public:
+  void testSlow() {}
+  void testPerf() {}
+  void testUntagged() {}
+};
+
+
+/// Decorator counting the calls to setUp().
+class TestTagsTestSetUp : public CPPUNIT_NS::TestSetUp
+{
+public:
+  TestTagsTestSetUp( CPPUNIT_NS::Test *test )
+      : CPPUNIT_NS::TestSetUp( test )
+      , m_setUpCount( 0 )
+  {
+  }
+
+  int m_setUpCount;
+
+protected:
+  void setUp()
+  {
+    ++m_setUpCount;
+  }
+};
+
+
+TestTagsTest::TestTagsTest()
+{
+}
+
+
+TestTagsTest::~TestTagsTest()
+{
+}
+
+
+void 
+TestTagsTest::setUp()
+{
+  m_suite = new CPPUNIT_NS::TestSuite( "suite" );
+  m_dictionary = new CPPUNIT_NS::TagDictionary();
+}
+
+
+void 
+TestTagsTest::tearDown()
+{
+  delete m_dictionary;
+  delete m_suite;
+}
+
+
+CPPUNIT_NS::Test *
+TestTagsTest::addTest( const std::string &name,
+                       const std::string &tags )
+{
+  MockTestCase *test = new MockTestCase( name );
+  if ( !tags.empty() )
+    test->setProperty( "tags", tags );
+  m_suite->addTest( test );
+  return test;
+}
+
+
+bool 
+TestTagsTest::matches( const std::string &expression,
+                       const std::string &tags )
+{
+  return CPPUNIT_NS::TagExpression( expression ).matches( 
+      m_dictionary->parse( tags ), *m_dictionary );
+}
+
+
+void 
+TestTagsTest::testTagSet()
+{
+  CPPUNIT_NS::TagSet tags;
+  CPPUNIT_ASSERT( tags.isEmpty() );
+  CPPUNIT_ASSERT_EQUAL( 0, tags.count() );
+  CPPUNIT_ASSERT( !tags.contains( -1 ) );
+
+  tags.insert( 3 );
+  tags.insert( 130 );
+  CPPUNIT_ASSERT( !tags.isEmpty() );
+  CPPUNIT_ASSERT_EQUAL( 2, tags.count() );
+  CPPUNIT_ASSERT( tags.contains( 3 ) );
+  CPPUNIT_ASSERT( tags.contains( 130 ) );
+  CPPUNIT_ASSERT( !tags.contains( 4 ) );
+  CPPUNIT_ASSERT( !tags.contains( 1000 ) );
+
+  CPPUNIT_NS::TagSet other;
+  other.insert( 3 );
+  other.insert( 7 );
+  CPPUNIT_NS::TagSet merged( tags );
+  merged.merge( other );
+  CPPUNIT_ASSERT_EQUAL( 3, merged.count() );
+  CPPUNIT_ASSERT( merged.contains( 7 ) );
+
+  tags.intersect( other );
+  CPPUNIT_ASSERT_EQUAL( 1, tags.count() );
+  CPPUNIT_ASSERT( tags.contains( 3 ) );
+}
+
+
+void 
+TestTagsTest::testTagSetComplement()
+{
+  CPPUNIT_NS::TagSet tags;
+  tags.insert( 1 );
+  tags.insert( 65 );
+  tags.complement( 70 );
+  CPPUNIT_ASSERT_EQUAL( 68, tags.count() );
+  CPPUNIT_ASSERT( tags.contains( 0 ) );
+  CPPUNIT_ASSERT( !tags.contains( 1 ) );
+  CPPUNIT_ASSERT( !tags.contains( 65 ) );
+  CPPUNIT_ASSERT( tags.contains( 69 ) );
+  CPPUNIT_ASSERT( !tags.contains( 70 ) );
+}
+
+
+void 
+TestTagsTest::testTagSetEquality()
+{
+  CPPUNIT_NS::TagSet tags;
+  CPPUNIT_NS::TagSet other;
+  CPPUNIT_ASSERT( tags == other );
+
+  other.insert( 100 );
+  CPPUNIT_ASSERT( !(tags == other) );
+
+  other.intersect( tags );
+  CPPUNIT_ASSERT( tags == other );
+}
+
+
+void 
+TestTagsTest::testDictionaryIntern()
+{
+  CPPUNIT_ASSERT_EQUAL( 0, m_dictionary->intern( "slow" ) );
+  CPPUNIT_ASSERT_EQUAL( 1, m_dictionary->intern( " db " ) );
+  CPPUNIT_ASSERT_EQUAL( 0, m_dictionary->intern( "slow" ) );
+  CPPUNIT_ASSERT_EQUAL( 2, m_dictionary->getTagCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "db" ), m_dictionary->getTagAt( 1 ) );
+  CPPUNIT_ASSERT_EQUAL( 1, m_dictionary->find( "db" ) );
+  CPPUNIT_ASSERT_EQUAL( -1, m_dictionary->find( "perf" ) );
+
+  CPPUNIT_NS::TagSet tags = m_dictionary->parse( "perf, slow,," );
+  CPPUNIT_ASSERT_EQUAL( 2, tags.count() );
+  CPPUNIT_ASSERT( tags.contains( 0 ) );
+  CPPUNIT_ASSERT( tags.contains( 2 ) );
+}
+
+
+void 
+TestTagsTest::testDictionaryInvalidTagThrow()
+{
+  m_dictionary->intern( "slow db" );
+}
+
+
+void 
+TestTagsTest::testExpressionMatches()
+{
+  CPPUNIT_ASSERT( matches( "perf", "perf" ) );
+  CPPUNIT_ASSERT( !matches( "perf", "slow" ) );
+  CPPUNIT_ASSERT( matches( "perf & !slow", "perf,db" ) );
+  CPPUNIT_ASSERT( !matches( "perf & !slow", "perf,slow" ) );
+  CPPUNIT_ASSERT( matches( "perf | slow", "slow" ) );
+  CPPUNIT_ASSERT( matches( "!(perf | slow)", "db" ) );
+  CPPUNIT_ASSERT( matches( "!!perf", "perf" ) );
+}
+
+
+void 
+TestTagsTest::testExpressionPrecedence()
+{
+  // '&' binds tighter than '|'.
+  CPPUNIT_ASSERT( matches( "db | perf & slow", "db" ) );
+  CPPUNIT_ASSERT( !matches( "(db | perf) & slow", "db" ) );
+  CPPUNIT_ASSERT( matches( "perf&slow|db", "db" ) );
+}
+
+
+void 
+TestTagsTest::testExpressionUnknownTag()
+{
+  CPPUNIT_ASSERT( !matches( "unknown", "perf" ) );
+  CPPUNIT_ASSERT( matches( "!unknown", "perf" ) );
+}
+
+
+void 
+TestTagsTest::testExpressionMissingParenthesisThrow()
+{
+  CPPUNIT_NS::TagExpression expression( "(perf | slow" );
+}
+
+
+void 
+TestTagsTest::testExpressionMissingTagThrow()
+{
+  CPPUNIT_NS::TagExpression expression( "perf & " );
+}
+
+
+void 
+TestTagsTest::testExpressionTrailingCharactersThrow()
+{
+  CPPUNIT_NS::TagExpression expression( "perf slow" );
+}
+
+
+void 
+TestTagsTest::testIndexInheritsSuiteTags()
+{
+  CPPUNIT_NS::TestSuite *subSuite = new CPPUNIT_NS::TestSuite( "sub" );
+  subSuite->setProperty( "tags", "db" );
+  MockTestCase *test1 = new MockTestCase( "test1" );
+  test1->setProperty( "tags", "slow" );
+  subSuite->addTest( test1 );
+  m_suite->addTest( subSuite );
+  addTest( "test2", "perf" );
+
+  CPPUNIT_NS::TaggedTestIndex index( *m_dictionary );
+  index.addTest( m_suite );
+  CPPUNIT_ASSERT_EQUAL( 2, index.getTestCount() );
+  CPPUNIT_ASSERT( test1 == index.getTestAt( 0 ) );
+
+  CPPUNIT_NS::TagSet expected = m_dictionary->parse( "db,slow" );
+  CPPUNIT_ASSERT( expected == index.getTagsAt( 0 ) );
+  expected = m_dictionary->parse( "perf" );
+  CPPUNIT_ASSERT( expected == index.getTagsAt( 1 ) );
+}
+
+
+void 
+TestTagsTest::testIndexSelect()
+{
+  addTest( "test0", "perf" );
+  addTest( "test1", "perf,slow" );
+  addTest( "test2", "" );
+  addTest( "test3", "slow" );
+
+  CPPUNIT_NS::TaggedTestIndex index( *m_dictionary );
+  index.addTest( m_suite );
+
+  CPPUNIT_NS::TagSet selected = index.select( 
+      CPPUNIT_NS::TagExpression( "perf & !slow" ) );
+  CPPUNIT_ASSERT_EQUAL( 1, selected.count() );
+  CPPUNIT_ASSERT( selected.contains( 0 ) );
+
+  selected = index.select( CPPUNIT_NS::TagExpression( "!perf" ) );
+  CPPUNIT_ASSERT_EQUAL( 2, selected.count() );
+  CPPUNIT_ASSERT( selected.contains( 2 ) );
+  CPPUNIT_ASSERT( selected.contains( 3 ) );
+
+  selected = index.select( CPPUNIT_NS::TagExpression( "unknown | slow" ) );
+  CPPUNIT_ASSERT_EQUAL( 2, selected.count() );
+}
+
+
+void 
+TestTagsTest::testIndexSelectManyTests()
+{
+  for ( int testIndex =0; testIndex < 200; ++testIndex )
+    addTest( "test", testIndex % 3 == 0 ? "odd-one" : "" );
+
+  CPPUNIT_NS::TaggedTestIndex index( *m_dictionary );
+  index.addTest( m_suite );
+
+  CPPUNIT_NS::TagExpression expression( "!odd-one" );
+  CPPUNIT_NS::TagSet selected = index.select( expression );
+  CPPUNIT_ASSERT_EQUAL( 133, selected.count() );
+  for ( int checkIndex =0; checkIndex < 200; ++checkIndex )
+  {
+    CPPUNIT_ASSERT_EQUAL( expression.matches( index.getTagsAt( checkIndex ), 
+                                              *m_dictionary ),
+                          selected.contains( checkIndex ) );
+  }
+}
+
+
+void 
+TestTagsTest::testHelperMacroTags()
+{
+  CPPUNIT_NS::TestSuite *suite = TestTagsTestFixture::suite();
+  m_suite->addTest( suite );
+
+  CPPUNIT_NS::TaggedTestIndex index;
+  index.addTest( suite );
+  CPPUNIT_ASSERT_EQUAL( 3, index.getTestCount() );
+
+  CPPUNIT_NS::TestSelection selection;
+  CPPUNIT_ASSERT_EQUAL( 1, index.select( 
+      CPPUNIT_NS::TagExpression( "db & perf & !slow" ), selection ) );
+  CPPUNIT_ASSERT_EQUAL( 1, selection.getChildTestCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "TestTagsTestFixture::testPerf" ),
+                        selection.getChildTestAt( 0 )->getName() );
+
+  CPPUNIT_NS::TagSet all = index.select( CPPUNIT_NS::TagExpression( "db" ) );
+  CPPUNIT_ASSERT_EQUAL( 3, all.count() );
+}
+
+
+void 
+TestTagsTest::testSelectKeepsWholeSuites()
+{
+  CPPUNIT_NS::TestSuite *subSuite = new CPPUNIT_NS::TestSuite( "sub" );
+  subSuite->setProperty( "tags", "db" );
+  subSuite->addTest( new MockTestCase( "test1" ) );
+  subSuite->addTest( new MockTestCase( "test2" ) );
+  m_suite->addTest( subSuite );
+  addTest( "test3", "" );
+
+  CPPUNIT_NS::TaggedTestIndex index( *m_dictionary );
+  index.addTest( m_suite );
+  CPPUNIT_NS::TestSelection selection;
+  CPPUNIT_ASSERT_EQUAL( 2, index.select( CPPUNIT_NS::TagExpression( "db" ), 
+                                         selection ) );
+  CPPUNIT_ASSERT_EQUAL( 1, selection.getChildTestCount() );
+  CPPUNIT_ASSERT( subSuite == selection.getChildTestAt( 0 ) );
+}
+
+
+void 
+TestTagsTest::testSelectKeepsDecorators()
+{
+  CPPUNIT_NS::TestSuite *subSuite = new CPPUNIT_NS::TestSuite( "sub" );
+  MockTestCase *test1 = new MockTestCase( "test1" );
+  test1->setProperty( "tags", "fast" );
+  test1->setExpectedRunTestCall( 1 );
+  subSuite->addTest( test1 );
+  MockTestCase *test2 = new MockTestCase( "test2" );
+  test2->setExpectedRunTestCall( 0 );
+  subSuite->addTest( test2 );
+  TestTagsTestSetUp *setUp = new TestTagsTestSetUp( subSuite );
+  m_suite->addTest( setUp );
+
+  CPPUNIT_NS::TaggedTestIndex index( *m_dictionary );
+  index.addTest( m_suite );
+  CPPUNIT_NS::TestSelection selection;
+  CPPUNIT_ASSERT_EQUAL( 1, index.select( CPPUNIT_NS::TagExpression( "fast" ),
+                                         selection ) );
+  CPPUNIT_ASSERT_EQUAL( 1, selection.getChildTestCount() );
+  CPPUNIT_NS::Test *filter = selection.getChildTestAt( 0 );
+  CPPUNIT_ASSERT_EQUAL( setUp->getName(), filter->getName() );
+  CPPUNIT_ASSERT( !filter->canRunChildTestsSeparately() );
+  CPPUNIT_ASSERT( setUp == filter->getChildTestAt( 0 ) );
+  CPPUNIT_ASSERT( selection.isExcluded( test2 ) );
+  CPPUNIT_ASSERT( !selection.isExcluded( test1 ) );
+  CPPUNIT_ASSERT_EQUAL( 1, selection.countTestCases() );
+
+  // The parallel runs keep the filter whole.
+  CPPUNIT_NS::ResourceScheduler scheduler( 2 );
+  scheduler.addTest( &selection );
+  CPPUNIT_ASSERT_EQUAL( 1, scheduler.getTestCount() );
+  CPPUNIT_ASSERT( filter == scheduler.getTestAt( 0 ) );
+
+  CPPUNIT_NS::TestResult result;
+  CPPUNIT_NS::TestResultCollector collector;
+  result.addListener( &collector );
+  selection.run( &result );
+  CPPUNIT_ASSERT_EQUAL( 1, setUp->m_setUpCount );
+  CPPUNIT_ASSERT_EQUAL( 1, collector.runTests() );
+  test1->verify();
+  test2->verify();
+
+  // The tests run without the selection are not filtered.
+  CPPUNIT_ASSERT_EQUAL( 2, setUp->countTestCases() );
+  test1->setExpectedRunTestCall( 2 );
+  test2->setExpectedRunTestCall( 1 );
+  setUp->run( &result );
+  CPPUNIT_ASSERT_EQUAL( 3, collector.runTests() );
+  test1->verify();
+  test2->verify();
+}
+
+
+void 
+TestTagsTest::testSelectionDoesNotOwnTests()
+{
+  CPPUNIT_NS::Test *test = addTest( "test", "" );
+  {
+    CPPUNIT_NS::TestSelection selection( "selection" );
+    selection.addTest( test );
+    CPPUNIT_ASSERT_EQUAL( std::string( "selection" ), selection.getName() );
+    CPPUNIT_ASSERT_EQUAL( 1, selection.countTestCases() );
+  }
+  CPPUNIT_ASSERT_EQUAL( std::string( "test" ), test->getName() );
+}
@@ -0,0 +1,85 @@
+#ifndef TESTTAGSTEST_H
+#define TESTTAGSTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestTags.h>
+#include <stdexcept>
+
+
+/*! \class TestTagsTest
+ * \brief Unit test for TagSet, TagDictionary, TagExpression and TaggedTestIndex.
+ */
+class TestTagsTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( TestTagsTest );
+  CPPUNIT_TEST( testTagSet );
+  CPPUNIT_TEST( testTagSetComplement );
+  CPPUNIT_TEST( testTagSetEquality );
+  CPPUNIT_TEST( testDictionaryIntern );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST_EXCEPTION( testDictionaryInvalidTagThrow, std::invalid_argument );
+#endif
+  CPPUNIT_TEST( testExpressionMatches );
+  CPPUNIT_TEST( testExpressionPrecedence );
+  CPPUNIT_TEST( testExpressionUnknownTag );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST_EXCEPTION( testExpressionMissingParenthesisThrow, std::invalid_argument );
+  CPPUNIT_TEST_EXCEPTION( testExpressionMissingTagThrow, std::invalid_argument );
+  CPPUNIT_TEST_EXCEPTION( testExpressionTrailingCharactersThrow, std::invalid_argument );
+#endif
+  CPPUNIT_TEST( testIndexInheritsSuiteTags );
+  CPPUNIT_TEST( testIndexSelect );
+  CPPUNIT_TEST( testIndexSelectManyTests );
+  CPPUNIT_TEST( testHelperMacroTags );
+  CPPUNIT_TEST( testSelectKeepsWholeSuites );
+  CPPUNIT_TEST( testSelectKeepsDecorators );
+  CPPUNIT_TEST( testSelectionDoesNotOwnTests );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  TestTagsTest();
+  virtual ~TestTagsTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testTagSet();
+  void testTagSetComplement();
+  void testTagSetEquality();
+
+  void testDictionaryIntern();
+  void testDictionaryInvalidTagThrow();
+
+  void testExpressionMatches();
+  void testExpressionPrecedence();
+  void testExpressionUnknownTag();
+  void testExpressionMissingParenthesisThrow();
+  void testExpressionMissingTagThrow();
+  void testExpressionTrailingCharactersThrow();
+
+  void testIndexInheritsSuiteTags();
+  void testIndexSelect();
+  void testIndexSelectManyTests();
+  void testHelperMacroTags();
+  void testSelectKeepsWholeSuites();
+  void testSelectKeepsDecorators();
+  void testSelectionDoesNotOwnTests();
+
+private:
+  TestTagsTest( const TestTagsTest &copy );
+  void operator =( const TestTagsTest &copy );
+
+  CPPUNIT_NS::Test *addTest( const std::string &name,
+                             const std::string &tags );
+
+  bool matches( const std::string &expression,
+                const std::string &tags );
+
+private:
+  CPPUNIT_NS::TestSuite *m_suite;
+  CPPUNIT_NS::TagDictionary *m_dictionary;
+};
+
+
+
+#endif  // TESTTAGSTEST_H
@@ -131,3 +131,19 @@ TestTest::testResolveTestPath()
   CPPUNIT_ASSERT( m_suite == path2.getTestAt(0) );
   CPPUNIT_ASSERT( m_test2 == path2.getTestAt(1) );
 }
+
+
+void 
+TestTest::testProperties()
+{
+  CPPUNIT_ASSERT( !m_test1->hasProperty( "key" ) );
+  CPPUNIT_ASSERT_EQUAL( std::string(""), m_test1->getProperty( "key" ) );
+
+  m_test1->setProperty( "key", "value" );
+  CPPUNIT_ASSERT( m_test1->hasProperty( "key" ) );
+  CPPUNIT_ASSERT_EQUAL( std::string("value"), m_test1->getProperty( "key" ) );
+
+  m_test1->setProperty( "key", "other value" );
+  CPPUNIT_ASSERT_EQUAL( std::string("other value"), m_test1->getProperty( "key" ) );
+  CPPUNIT_ASSERT( !m_test2->hasProperty( "key" ) );
+}
@@ -21,8 +21,11 @@ class TestTest : public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST( testFindTestPathName );
   CPPUNIT_TEST( testFindTestPathNameFail );
   CPPUNIT_TEST( testFindTest );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST_EXCEPTION( testFindTestThrow, std::invalid_argument );
+#endif
   CPPUNIT_TEST( testResolveTestPath );
+  CPPUNIT_TEST( testProperties );
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -49,6 +52,8 @@ public:
 
   void testResolveTestPath();
 
+  void testProperties();
+
 private:
   /// Prevents the use of the copy constructor.
   TestTest( const TestTest &copy );
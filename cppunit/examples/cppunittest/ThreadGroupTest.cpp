@@ -0,0 +1,301 @@
+#include "ToolsSuite.h"
+#include "ThreadGroupTest.h"
+#include <cppunit/AssertionTrap.h>
+#include <cppunit/tools/ThreadGroup.h>
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( ThreadGroupTest, 
+                                       toolsSuiteName() );
+
+
+/// Records which thread indexes were run.
+class ThreadGroupTestRecordTask : public CPPUNIT_NS::ThreadTask
+{
+public:
+  ThreadGroupTestRecordTask()
+      : m_counter( 0 )
+  {
+    for ( int index =0; index < 8; ++index )
+      m_runCounts[ index ] = 0;
+  }
+
+  void run( int threadIndex )
+  {
+    ++m_runCounts[ threadIndex ];
+    for ( int count =0; count < 1000; ++count )
+    {
+      m_mutex.lock();
+      ++m_counter;
+      m_mutex.unlock();
+    }
+  }
+
+  int m_runCounts[8];
+  int m_counter;
+  CPPUNIT_NS::ThreadMutex m_mutex;
+};
+
+
+/// Fails in the thread of index 2.
+class ThreadGroupTestFailingTask : public CPPUNIT_NS::ThreadTask
+{
+public:
+  ThreadGroupTestFailingTask( bool useStdException )
+      : m_useStdException( useStdException )
+  {
+  }
+
+  void run( int threadIndex )
+  {
+    if ( threadIndex != 2 )
+      return;
+    if ( m_useStdException )
+      throw std::logic_error( "failed in thread 2" );
+    CPPUNIT_FAIL( "failed in thread 2" );
+  }
+
+  bool m_useStdException;
+};
+
+
+/// Exception derived from Exception, thrown by the thread of index 1.
+class ThreadGroupTestException : public CPPUNIT_NS::Exception
+{
+public:
+  ThreadGroupTestException( int code )
+      : CPPUNIT_NS::Exception( CPPUNIT_NS::Message( "derived" ) )
+      , m_code( code )
+  {
+  }
+
+  CPPUNIT_NS::Exception *clone() const
+  {
+    return new ThreadGroupTestException( *this );
+  }
+
+  void throwCopy() const
+  {
+    throw ThreadGroupTestException( *this );
+  }
+
+  int m_code;
+};
+
+
+class ThreadGroupTestDerivedFailingTask : public CPPUNIT_NS::ThreadTask
+{
+public:
+  void run( int threadIndex )
+  {
+    if ( threadIndex == 1 )
+      throw ThreadGroupTestException( 42 );
+  }
+};
+
+
+/// Fails in any thread.
+class ThreadGroupTestBackgroundFailingTask : public CPPUNIT_NS::ThreadTask
+{
+public:
+  void run( int )
+  {
+    throw std::logic_error( "failed in background" );
+  }
+};
+
+
+/// Checks that no thread leaves the barrier before all arrived, twice.
+class ThreadGroupTestBarrierTask : public CPPUNIT_NS::ThreadTask
+{
+public:
+  ThreadGroupTestBarrierTask( int threadCount )
+      : m_threadCount( threadCount )
+      , m_barrier( threadCount )
+      , m_arrivedCount( 0 )
+      , m_earlyCount( 0 )
+  {
+  }
+
+  void run( int )
+  {
+    for ( int round =1; round <= 2; ++round )
+    {
+      m_mutex.lock();
+      ++m_arrivedCount;
+      m_mutex.unlock();
+
+      m_barrier.wait();
+
+      m_mutex.lock();
+      if ( m_arrivedCount < round * m_threadCount )
+        ++m_earlyCount;
+      m_mutex.unlock();
+
+      m_barrier.wait();
+    }
+  }
+
+  int m_threadCount;
+  CPPUNIT_NS::ThreadBarrier m_barrier;
+  CPPUNIT_NS::ThreadMutex m_mutex;
+  int m_arrivedCount;
+  int m_earlyCount;
+};
+
+
+ThreadGroupTest::ThreadGroupTest()
+{
+}
+
+
+ThreadGroupTest::~ThreadGroupTest()
+{
+}
+
+
+void 
+ThreadGroupTest::setUp()
+{
+}
+
+
+void 
+ThreadGroupTest::tearDown()
+{
+}
+
+
+void 
+ThreadGroupTest::testRunAllThreadIndexes()
+{
+  ThreadGroupTestRecordTask task;
+  CPPUNIT_NS::ThreadGroup::run( task, 8 );
+  for ( int index =0; index < 8; ++index )
+    CPPUNIT_ASSERT_EQUAL( 1, task.m_runCounts[ index ] );
+}
+
+
+void 
+ThreadGroupTest::testMutex()
+{
+  ThreadGroupTestRecordTask task;
+  CPPUNIT_NS::ThreadGroup::run( task, 4 );
+  CPPUNIT_ASSERT_EQUAL( 4000, task.m_counter );
+}
+
+
+void 
+ThreadGroupTest::testExceptionIsRethrown()
+{
+  ThreadGroupTestFailingTask task( false );
+  try
+  {
+    CPPUNIT_NS::ThreadGroup::run( task, 4 );
+  }
+  catch ( CPPUNIT_NS::Exception &e )
+  {
+    CPPUNIT_ASSERT_EQUAL( std::string( "failed in thread 2" ), 
+                          e.message().detailAt( 0 ) );
+    return;
+  }
+  CPPUNIT_FAIL( "exception not rethrown" );
+}
+
+
+void 
+ThreadGroupTest::testDerivedExceptionIsRethrown()
+{
+  ThreadGroupTestDerivedFailingTask task;
+  try
+  {
+    CPPUNIT_NS::ThreadGroup::run( task, 4 );
+  }
+  catch ( ThreadGroupTestException &e )
+  {
+    CPPUNIT_ASSERT_EQUAL( 42, e.m_code );
+    return;
+  }
+  CPPUNIT_FAIL( "derived exception not rethrown" );
+}
+
+
+void 
+ThreadGroupTest::testStdExceptionIsRethrown()
+{
+  ThreadGroupTestFailingTask task( true );
+  CPPUNIT_NS::ThreadGroup::run( task, 4 );
+}
+
+
+void 
+ThreadGroupTest::testFailedAssertionIsRaised()
+{
+#if defined(CPPUNIT_NO_EXCEPTIONS)
+  // The failure of thread 2 jumps to the trap of this thread.
+  ThreadGroupTestFailingTask task( false );
+  std::string detail;
+  {
+    CPPUNIT_NS::AssertionTrap trap;
+    if ( setjmp( trap.jumpBuffer() ) == 0 )
+      CPPUNIT_NS::ThreadGroup::run( task, 4 );
+    else
+      detail = trap.failure()->message().detailAt( 0 );
+  }
+  CPPUNIT_ASSERT_EQUAL( std::string( "failed in thread 2" ), detail );
+#endif
+}
+
+
+void 
+ThreadGroupTest::testProcessorCount()
+{
+  CPPUNIT_ASSERT( CPPUNIT_NS::ThreadGroup::processorCount() >= 1 );
+}
+
+
+void 
+ThreadGroupTest::testBarrier()
+{
+  if ( !CPPUNIT_NS::ThreadGroup::isConcurrent() )
+    return;
+
+  ThreadGroupTestBarrierTask task( 4 );
+  CPPUNIT_NS::ThreadGroup::run( task, 4 );
+
+  CPPUNIT_ASSERT_EQUAL( 8, task.m_arrivedCount );
+  CPPUNIT_ASSERT_EQUAL( 0, task.m_earlyCount );
+}
+
+
+void 
+ThreadGroupTest::testBackgroundThread()
+{
+  ThreadGroupTestRecordTask task;
+  CPPUNIT_NS::BackgroundThread thread;
+  CPPUNIT_ASSERT( !thread.isRunning() );
+  if ( !thread.start( task ) )
+  {
+    CPPUNIT_ASSERT( !CPPUNIT_NS::ThreadGroup::isConcurrent() );
+    return;
+  }
+
+  CPPUNIT_ASSERT( thread.isRunning() );
+  CPPUNIT_ASSERT( !thread.start( task ) );
+  thread.join();
+  CPPUNIT_ASSERT( !thread.isRunning() );
+  CPPUNIT_ASSERT_EQUAL( 1, task.m_runCounts[0] );
+  CPPUNIT_ASSERT_EQUAL( 1000, task.m_counter );
+}
+
+
+void 
+ThreadGroupTest::testBackgroundThreadRethrows()
+{
+  ThreadGroupTestBackgroundFailingTask task;
+  CPPUNIT_NS::BackgroundThread thread;
+  if ( !thread.start( task ) )
+    return;
+
+  CPPUNIT_ASSERT_THROW( thread.join(), std::runtime_error );
+  CPPUNIT_ASSERT( !thread.isRunning() );
+}
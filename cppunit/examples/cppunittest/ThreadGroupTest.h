@@ -0,0 +1,56 @@
+#ifndef THREADGROUPTEST_H
+#define THREADGROUPTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdexcept>
+
+
+/*! \class ThreadGroupTest
+ * \brief Unit test for class ThreadGroup, ThreadMutex and ThreadBarrier.
+ */
+class ThreadGroupTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( ThreadGroupTest );
+  CPPUNIT_TEST( testRunAllThreadIndexes );
+  CPPUNIT_TEST( testMutex );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testExceptionIsRethrown );
+  CPPUNIT_TEST( testDerivedExceptionIsRethrown );
+  CPPUNIT_TEST_EXCEPTION( testStdExceptionIsRethrown, std::runtime_error );
+#else
+  CPPUNIT_TEST( testFailedAssertionIsRaised );
+#endif
+  CPPUNIT_TEST( testProcessorCount );
+  CPPUNIT_TEST( testBarrier );
+  CPPUNIT_TEST( testBackgroundThread );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testBackgroundThreadRethrows );
+#endif
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  ThreadGroupTest();
+  virtual ~ThreadGroupTest();
+
+  virtual void setUp();
+  virtual void tearDown();
+
+  void testRunAllThreadIndexes();
+  void testMutex();
+  void testExceptionIsRethrown();
+  void testDerivedExceptionIsRethrown();
+  void testStdExceptionIsRethrown();
+  void testFailedAssertionIsRaised();
+  void testProcessorCount();
+  void testBarrier();
+  void testBackgroundThread();
+  void testBackgroundThreadRethrows();
+
+private:
+  ThreadGroupTest( const ThreadGroupTest &copy );
+  void operator =( const ThreadGroupTest &copy );
+};
+
+
+
+#endif  // THREADGROUPTEST_H
@@ -0,0 +1,282 @@
+#include "ExtensionSuite.h"
+#include "UnorderedAssertTest.h"
+#include <cppunit/Exception.h>
+#include <cppunit/extensions/UnorderedAssert.h>
+#include <list>
+#include <set>
+#include <vector>
+
+
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( UnorderedAssertTest,
+                                       extensionSuiteName() );
+
+
+/// Element without operator <<, hashed and printed by its traits.
+struct UnorderedAssertTestOrder
+{
+  UnorderedAssertTestOrder( int id )
+      : m_id( id )
+  {
+  }
+
+  int m_id;
+};
+
+
+CPPUNIT_NS_BEGIN
+
+template<>
+struct assertion_traits<UnorderedAssertTestOrder>
+{
+  static bool equal( const UnorderedAssertTestOrder &x, 
+                     const UnorderedAssertTestOrder &y )
+  {
+    return x.m_id == y.m_id;
+  }
+
+  static std::string toString( const UnorderedAssertTestOrder &order )
+  {
+    return "order " + assertion_traits<int>::toString( order.m_id );
+  }
+};
+
+
+template<>
+struct hash_traits<UnorderedAssertTestOrder>
+{
+  static size_t hash( const UnorderedAssertTestOrder &order )
+  {
+    // Collides on purpose: equality still decides.
+    return size_t(order.m_id % 2);
+  }
+};
+
+CPPUNIT_NS_END
+
+
+/// Returns the message of a failed unordered comparison of two vectors.
+static CPPUNIT_NS::Message 
+unorderedAssertTestFailure( const std::vector<int> &expected,
+                            const std::vector<int> &actual,
+                            const std::string &message = "" )
+{
+  try
+  {
+    CPPUNIT_NS::assertUnorderedEqual( expected, actual, 
+                                      CPPUNIT_NS::SourceLine(), message );
+  }
+  catch ( CPPUNIT_NS::Exception &e )
+  {
+    return e.message();
+  }
+  CPPUNIT_FAIL( "the assertion did not fail" );
+  return CPPUNIT_NS::Message();
+}
+
+
+/// Makes a vector from the first count integers of values.
+static std::vector<int> 
+makeUnorderedAssertTestVector( const int *values,
+                               int count )
+{
+  return std::vector<int>( values, values + count );
+}
+
+
+UnorderedAssertTest::UnorderedAssertTest()
+{
+}
+
+
+UnorderedAssertTest::~UnorderedAssertTest()
+{
+}
+
+
+void 
+UnorderedAssertTest::testSameElementsInOtherOrder()
+{
+  const int expected[] = { 1, 2, 3, 2 };
+  const int actual[] = { 2, 3, 2, 1 };
+  CPPUNIT_ASSERT_UNORDERED_EQUAL( makeUnorderedAssertTestVector( expected, 4 ),
+                                  makeUnorderedAssertTestVector( actual, 4 ) );
+}
+
+
+void 
+UnorderedAssertTest::testDifferentCollectionTypes()
+{
+  std::vector<std::string> expected;
+  expected.push_back( "bid" );
+  expected.push_back( "ask" );
+  std::set<std::string> actual;
+  actual.insert( "ask" );
+  actual.insert( "bid" );
+  CPPUNIT_ASSERT_UNORDERED_EQUAL( expected, actual );
+
+  std::list<std::string> other( actual.begin(), actual.end() );
+  other.push_back( "trade" );
+  CPPUNIT_ASSERT_ASSERTION_FAIL( CPPUNIT_ASSERT_UNORDERED_EQUAL( expected, other ) );
+}
+
+
+void 
+UnorderedAssertTest::testRanges()
+{
+  const double expected[] = { 1.5, 0.0, -2 };
+  std::vector<double> actual;
+  actual.push_back( -2 );
+  actual.push_back( 1.5 );
+  actual.push_back( -0.0 );
+  CPPUNIT_ASSERT_UNORDERED_RANGES_EQUAL( expected, expected + 3, 
+                                         actual.begin(), actual.end() );
+}
+
+
+void 
+UnorderedAssertTest::testEmpty()
+{
+  std::vector<int> empty;
+  CPPUNIT_ASSERT_UNORDERED_EQUAL( empty, empty );
+  CPPUNIT_ASSERT_ASSERTION_FAIL( 
+      CPPUNIT_ASSERT_UNORDERED_EQUAL( empty, std::vector<int>( 1, 3 ) ) );
+}
+
+
+void 
+UnorderedAssertTest::testMissingAndUnexpected()
+{
+  const int expected[] = { 4, 12, 7, 9 };
+  const int actual[] = { 9, 21, 4, 7 };
+  CPPUNIT_NS::Message failure = unorderedAssertTestFailure( 
+                                  makeUnorderedAssertTestVector( expected, 4 ),
+                                  makeUnorderedAssertTestVector( actual, 4 ) );
+
+  CPPUNIT_ASSERT_EQUAL( std::string( "unordered equality assertion failed" ), 
+                        failure.shortDescription() );
+  CPPUNIT_ASSERT_EQUAL( 4, failure.detailCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "Expected: 4 elements" ), 
+                        failure.detailAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( std::string( "Actual  : 4 elements" ), 
+                        failure.detailAt( 1 ) );
+  CPPUNIT_ASSERT_EQUAL( std::string( "Missing (1): 12" ), failure.detailAt( 2 ) );
+  CPPUNIT_ASSERT_EQUAL( std::string( "Unexpected (1): 21" ), 
+                        failure.detailAt( 3 ) );
+}
+
+
+void 
+UnorderedAssertTest::testDuplicatesAreCounted()
+{
+  const int expected[] = { 5, 5, 5, 6 };
+  const int actual[] = { 5, 6, 6, 6 };
+  CPPUNIT_NS::Message failure = unorderedAssertTestFailure( 
+                                  makeUnorderedAssertTestVector( expected, 4 ),
+                                  makeUnorderedAssertTestVector( actual, 4 ) );
+
+  CPPUNIT_ASSERT_EQUAL( std::string( "Missing (2): 5 (x2)" ), 
+                        failure.detailAt( 2 ) );
+  CPPUNIT_ASSERT_EQUAL( std::string( "Unexpected (2): 6 (x2)" ), 
+                        failure.detailAt( 3 ) );
+}
+
+
+void 
+UnorderedAssertTest::testUnexpectedDuplicatesAreCounted()
+{
+  const int expected[] = { 1 };
+  const int actual[] = { 1, 7, 7, 7, 8 };
+  CPPUNIT_NS::Message failure = unorderedAssertTestFailure( 
+                                  makeUnorderedAssertTestVector( expected, 1 ),
+                                  makeUnorderedAssertTestVector( actual, 5 ) );
+
+  CPPUNIT_ASSERT_EQUAL( 3, failure.detailCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "Unexpected (4): 7 (x3), 8" ), 
+                        failure.detailAt( 2 ) );
+}
+
+
+void 
+UnorderedAssertTest::testShownElementsAreBounded()
+{
+  std::vector<int> expected;
+  for ( int value = 0; value < 100; ++value )
+    expected.push_back( value );
+  std::vector<int> actual( expected.begin(), expected.begin() + 50 );
+
+  CPPUNIT_NS::Message failure = unorderedAssertTestFailure( expected, actual );
+  CPPUNIT_ASSERT_EQUAL( 3, failure.detailCount() );
+  CPPUNIT_ASSERT_EQUAL( 
+      std::string( "Missing (50): 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, ..." ), 
+      failure.detailAt( 2 ) );
+}
+
+
+void 
+UnorderedAssertTest::testUserMessage()
+{
+  CPPUNIT_NS::Message failure = unorderedAssertTestFailure( 
+                                  std::vector<int>( 1, 1 ),
+                                  std::vector<int>( 1, 2 ),
+                                  "fills of the day" );
+  CPPUNIT_ASSERT_EQUAL( std::string( "fills of the day" ), 
+                        failure.detailAt( failure.detailCount() -1 ) );
+}
+
+
+void 
+UnorderedAssertTest::testDefaultHash()
+{
+  std::vector<const char *> expected;
+  expected.push_back( "a" );
+  expected.push_back( "b" );
+  std::vector<const char *> actual;
+  actual.push_back( expected[1] );
+  actual.push_back( expected[0] );
+  CPPUNIT_ASSERT_UNORDERED_EQUAL( expected, actual );
+}
+
+
+void 
+UnorderedAssertTest::testCustomHash()
+{
+  std::vector<UnorderedAssertTestOrder> expected;
+  std::vector<UnorderedAssertTestOrder> actual;
+  for ( int id = 0; id < 6; ++id )
+  {
+    expected.push_back( UnorderedAssertTestOrder( id ) );
+    actual.push_back( UnorderedAssertTestOrder( 5 - id ) );
+  }
+  CPPUNIT_ASSERT_UNORDERED_EQUAL( expected, actual );
+
+  actual[0] = UnorderedAssertTestOrder( 8 );
+  try
+  {
+    CPPUNIT_ASSERT_UNORDERED_EQUAL( expected, actual );
+  }
+  catch ( CPPUNIT_NS::Exception &e )
+  {
+    CPPUNIT_ASSERT_EQUAL( std::string( "Missing (1): order 5" ), 
+                          e.message().detailAt( 2 ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "Unexpected (1): order 8" ), 
+                          e.message().detailAt( 3 ) );
+    return;
+  }
+  CPPUNIT_FAIL( "the assertion did not fail" );
+}
+
+
+void 
+UnorderedAssertTest::testHashOfZeros()
+{
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::hash_traits<double>::hash( 0.0 ), 
+                        CPPUNIT_NS::hash_traits<double>::hash( -0.0 ) );
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::hash_traits<float>::hash( 0.0f ), 
+                        CPPUNIT_NS::hash_traits<float>::hash( -0.0f ) );
+  CPPUNIT_ASSERT_EQUAL( CPPUNIT_NS::hash_traits<long double>::hash( 0.0L ), 
+                        CPPUNIT_NS::hash_traits<long double>::hash( -0.0L ) );
+  CPPUNIT_ASSERT_UNORDERED_EQUAL( std::vector<float>( 1, 0.0f ), 
+                                  std::vector<float>( 1, -0.0f ) );
+  CPPUNIT_ASSERT( CPPUNIT_NS::hash_traits<int>::hash( 1 ) != 
+                  CPPUNIT_NS::hash_traits<int>::hash( 2 ) );
+}
@@ -0,0 +1,54 @@
+#ifndef UNORDEREDASSERTTEST_H
+#define UNORDEREDASSERTTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+
+/// Unit tests for CPPUNIT_ASSERT_UNORDERED_EQUAL and UnorderedDifferences.
+class UnorderedAssertTest : public CPPUNIT_NS::TestFixture
+{
+  CPPUNIT_TEST_SUITE( UnorderedAssertTest );
+  CPPUNIT_TEST( testSameElementsInOtherOrder );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testDifferentCollectionTypes );
+#endif
+  CPPUNIT_TEST( testRanges );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testEmpty );
+  CPPUNIT_TEST( testMissingAndUnexpected );
+  CPPUNIT_TEST( testDuplicatesAreCounted );
+  CPPUNIT_TEST( testUnexpectedDuplicatesAreCounted );
+  CPPUNIT_TEST( testShownElementsAreBounded );
+  CPPUNIT_TEST( testUserMessage );
+#endif
+  CPPUNIT_TEST( testDefaultHash );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST( testCustomHash );
+#endif
+  CPPUNIT_TEST( testHashOfZeros );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  UnorderedAssertTest();
+  virtual ~UnorderedAssertTest();
+
+  void testSameElementsInOtherOrder();
+  void testDifferentCollectionTypes();
+  void testRanges();
+  void testEmpty();
+  void testMissingAndUnexpected();
+  void testDuplicatesAreCounted();
+  void testUnexpectedDuplicatesAreCounted();
+  void testShownElementsAreBounded();
+  void testUserMessage();
+  void testDefaultHash();
+  void testCustomHash();
+  void testHashOfZeros();
+
+private:
+  UnorderedAssertTest( const UnorderedAssertTest &other );
+  void operator =( const UnorderedAssertTest &other );
+};
+
+
+#endif  // UNORDEREDASSERTTEST_H
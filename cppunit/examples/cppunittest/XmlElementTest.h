@@ -16,10 +16,14 @@ class XmlElementTest : public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST( testSetStringContent );
   CPPUNIT_TEST( testSetNumericContent );
   CPPUNIT_TEST( testElementCount );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST_EXCEPTION( testElementAtNegativeIndexThrow, std::invalid_argument );
   CPPUNIT_TEST_EXCEPTION( testElementAtTooLargeIndexThrow, std::invalid_argument );
+#endif
   CPPUNIT_TEST( testElementAt );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
   CPPUNIT_TEST_EXCEPTION( testElementForThrow, std::invalid_argument );
+#endif
   CPPUNIT_TEST( testElementFor );
 
   CPPUNIT_TEST( testEmptyNodeToString );
@@ -1,4 +1,5 @@
 #include <cppunit/config/SourcePrefix.h>
+#include <cppunit/CallbackProfile.h>
 #include <cppunit/XmlOutputter.h>
 #include <cppunit/TestFailure.h>
 #include <cppunit/XmlOutputter.h>
@@ -303,6 +304,34 @@ XmlOutputterTest::testHook()
 }
 
 
+void 
+XmlOutputterTest::testHookProfile()
+{
+  int begin =0, end =0, statistics =0, successful =0, failed =0;
+  MockHook hook( begin, end, statistics, successful, failed );
+
+  addTest( "test1" );
+  addTest( "test2" );
+  addTestFailure( "testfail1", "assertion failed" );
+
+  CPPUNIT_NS::CallbackProfile profile;
+  CPPUNIT_NS::OStringStream stream;
+  CPPUNIT_NS::XmlOutputter outputter( m_result, stream );
+  outputter.addHook( &hook );
+  outputter.setProfile( &profile );
+  outputter.write();
+
+  CPPUNIT_ASSERT_EQUAL( 5, profile.entryCount() );
+  CPPUNIT_ASSERT_EQUAL( std::string("beginDocument"), profile.eventAt( 0 ) );
+  CPPUNIT_ASSERT_EQUAL( std::string("failTestAdded"), profile.eventAt( 1 ) );
+  CPPUNIT_ASSERT_EQUAL( 1L, profile.callCountAt( 1 ) );
+  CPPUNIT_ASSERT_EQUAL( std::string("successfulTestAdded"), profile.eventAt( 2 ) );
+  CPPUNIT_ASSERT_EQUAL( 2L, profile.callCountAt( 2 ) );
+  CPPUNIT_ASSERT_EQUAL( std::string("statisticsAdded"), profile.eventAt( 3 ) );
+  CPPUNIT_ASSERT_EQUAL( std::string("endDocument"), profile.eventAt( 4 ) );
+}
+
+
 void 
 XmlOutputterTest::addTest( std::string testName )
 {
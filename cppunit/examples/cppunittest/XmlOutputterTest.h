@@ -20,6 +20,7 @@ class XmlOutputterTest : public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST( testWriteXmlResultWithOneSuccess );
   CPPUNIT_TEST( testWriteXmlResultWithThreeFailureTwoErrorsAndTwoSuccess );
   CPPUNIT_TEST( testHook );
+  CPPUNIT_TEST( testHookProfile );
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -39,6 +40,7 @@ public:
   void testWriteXmlResultWithThreeFailureTwoErrorsAndTwoSuccess();
 
   void testHook();
+  void testHookProfile();
 
 private:
   class MockHook;
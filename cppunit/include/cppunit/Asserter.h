@@ -45,6 +45,9 @@ class Message;
 struct Asserter
 {
   /*! \brief Throws a Exception with the specified message and location.
+   *
+   * If CPPUNIT_NO_EXCEPTIONS is defined, the Exception is raised to the
+   * innermost AssertionTrap instead.
    */
   static void CPPUNIT_API fail( const Message &message, 
                                 const SourceLine &sourceLine = SourceLine() );
@@ -0,0 +1,96 @@
+#ifndef CPPUNIT_ASSERTIONTRAP_H
+#define CPPUNIT_ASSERTIONTRAP_H
+
+#include <cppunit/Portability.h>
+#include <setjmp.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+class Exception;
+class TraceContext;
+
+
+/*! \brief Point a failed assertion jumps back to when exceptions are disabled.
+ * \ingroup CreatingNewAssertions
+ *
+ * When the library is configured with \c --disable-exceptions
+ * (CPPUNIT_NO_EXCEPTIONS is defined), a failed assertion does not throw an
+ * Exception: Asserter::fail() records the failure in the innermost trap of
+ * the calling thread and returns to it with longjmp(). DefaultProtector sets
+ * a trap around each call to setUp(), the test method and tearDown(), so the
+ * tests and the code they test can be built with \c -fno-exceptions. A passing
+ * assertion only costs the test of its condition.
+ *
+ * The trap is set by calling setjmp() in the function that constructed it:
+ * \code
+ * AssertionTrap trap;
+ * if ( setjmp( trap.jumpBuffer() ) == 0 )
+ *   callCodeThatMayFailAnAssertion();
+ * else
+ *   report( *trap.failure() );
+ * \endcode
+ *
+ * The destructors of the objects of the functions longjmp() returns through
+ * are not called: a test that fails an assertion while it owns resources
+ * leaks them, and the code following the assertion in its helper functions
+ * is not run. In this configuration CPPUNIT_ASSERT_THROW(),
+ * CPPUNIT_ASSERT_NO_THROW() and CPPUNIT_TEST_EXCEPTION() are not available,
+ * and an exception thrown by a test is not caught.
+ *
+ * Traps are stacked per thread: tests run on several threads each return to
+ * their own trap. ThreadGroup and BackgroundThread run each task under a trap
+ * of its own, and raise its failure to the trap of the thread that waits for
+ * it. The trace contexts (CPPUNIT_SCOPED_TRACE()) made after the trap are
+ * removed when a failure jumps to it.
+ *
+ * The extensions that catch the failures of the code they call, to report
+ * them their own way, do not see the failed assertions: the fuzz tests, the
+ * property tests, DifferentialTest and LoadDriver end the test on the first
+ * one, without shrinking or counting it.
+ */
+class CPPUNIT_API AssertionTrap
+{
+public:
+  /// Makes this trap the innermost trap of the calling thread.
+  AssertionTrap();
+
+  /// Makes the previous trap the innermost one, and deletes the failure.
+  ~AssertionTrap();
+
+  /// Returns the buffer setjmp() saves the calling context in.
+  jmp_buf &jumpBuffer();
+
+  /// Returns the failure that jumped to this trap, or \c NULL.
+  const Exception *failure() const;
+
+  /// Returns the innermost trap of the calling thread, or \c NULL.
+  static AssertionTrap *current();
+
+  /*! \brief Records a failure in the innermost trap and jumps to it.
+   *
+   * If the calling thread has no trap, the failure is printed to the
+   * standard error and the process is aborted.
+   * \param failure Failure, owned by the trap.
+   */
+  static void raise( Exception *failure );
+
+private:
+  /// Prevents the use of the copy constructor.
+  AssertionTrap( const AssertionTrap &copy );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const AssertionTrap &copy );
+
+private:
+  jmp_buf m_jumpBuffer;
+  Exception *m_failure;
+  AssertionTrap *m_previous;
+  TraceContext *m_traceContext;
+};
+
+
+CPPUNIT_NS_END
+
+#endif // CPPUNIT_ASSERTIONTRAP_H
@@ -0,0 +1,143 @@
+#ifndef CPPUNIT_CALLBACKPROFILE_H
+#define CPPUNIT_CALLBACKPROFILE_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/portability/CppUnitMap.h>
+#include <cppunit/portability/CppUnitVector.h>
+#include <cppunit/portability/Stream.h>
+#include <string>
+#include <utility>
+
+
+CPPUNIT_NS_BEGIN
+
+
+class TestListener;
+class XmlOutputterHook;
+
+
+/*! \brief Time spent in each TestListener and XmlOutputterHook callback.
+ * \ingroup TrackingTestExecution
+ *
+ * When a profile is set with TestResult::setProfile() or
+ * XmlOutputter::setProfile(), each callback of a listener or of a hook is
+ * timed. The profile accumulates, for each listener or hook and each event,
+ * the number of calls and the time spent in them. It is used to find the
+ * listener of a plug-in that slows down the whole run:
+ *
+ * \code
+ * CppUnit::CallbackProfile profile;
+ * controller.setProfile( &profile );
+ * runner.run( controller );
+ * profile.write( CppUnit::stdCOut() );
+ * \endcode
+ *
+ * The profile is not synchronized: TestResult records the listener calls
+ * while it holds its synchronization object.
+ */
+class CPPUNIT_API CallbackProfile
+{
+public:
+  /// Constructs an empty profile.
+  CallbackProfile();
+
+  /// Destructor.
+  virtual ~CallbackProfile();
+
+  /*! \brief Records a call of a listener.
+   * \param listener Listener that was called.
+   * \param event Name of the called method ("startTest").
+   * \param seconds Time spent in the call.
+   */
+  void addListenerTime( TestListener *listener,
+                        const std::string &event,
+                        double seconds );
+
+  /*! \brief Records a call of a hook.
+   * \param hook Hook that was called.
+   * \param event Name of the called method ("successfulTestAdded").
+   * \param seconds Time spent in the call.
+   */
+  void addHookTime( XmlOutputterHook *hook,
+                    const std::string &event,
+                    double seconds );
+
+  /// Removes all the recorded calls.
+  void reset();
+
+  /// Returns the number of (callback, event) entries, in order of first call.
+  int entryCount() const;
+
+  /// Returns the class name of the listener or hook of an entry.
+  std::string callbackNameAt( int index ) const;
+
+  std::string eventAt( int index ) const;
+
+  long callCountAt( int index ) const;
+
+  /// Returns the total time spent in the calls of an entry, in seconds.
+  double totalSecondsAt( int index ) const;
+
+  /// Returns the mean time of a call of an entry, in seconds.
+  double secondsPerCallAt( int index ) const;
+
+  /// Returns the time spent in all the callbacks, in seconds.
+  double totalSeconds() const;
+
+  /*! \brief Writes the entries that took the most time.
+   * \param stream Stream to write to.
+   * \param maximumEntryCount Largest number of entries written, in order of
+   *                          decreasing total time.
+   */
+  void write( OStream &stream,
+              int maximumEntryCount = 10 ) const;
+
+private:
+  /*! \brief Adds the time of a call to an existing entry.
+   * \return \c false if there is no entry for \a callback and \a event.
+   */
+  bool addTime( const void *callback,
+                const std::string &event,
+                double seconds );
+
+  /// Adds an entry with the time of its first call.
+  void addEntry( const void *callback,
+                 const std::string &callbackName,
+                 const std::string &event,
+                 double seconds );
+
+  struct Entry
+  {
+    std::string m_callbackName;
+    std::string m_event;
+    long m_callCount;
+    double m_totalSeconds;
+  };
+
+  typedef std::pair<const void *, std::string> EntryKey;
+  typedef CppUnitMap<EntryKey, int, std::less<EntryKey> > EntryIndexes;
+
+  CppUnitVector<Entry> m_entries;
+  EntryIndexes m_indexes;
+
+  /// Prevents the use of the copy constructor.
+  CallbackProfile( const CallbackProfile &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const CallbackProfile &other );
+};
+
+
+CPPUNIT_NS_END
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_CALLBACKPROFILE_H
@@ -0,0 +1,221 @@
+#ifndef CPPUNIT_COMMANDLINEPARSER_H
+#define CPPUNIT_COMMANDLINEPARSER_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/extensions/BenchmarkEnvironment.h>
+#include <cppunit/portability/CppUnitDeque.h>
+#include <cppunit/plugin/PlugInParameters.h>
+#include <cppunit/tools/LiveMetricsSegment.h>
+#include <string>
+#include <stdexcept>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! Exception thrown on error while parsing command line.
+ */
+class CPPUNIT_API CommandLineParserException : public std::runtime_error
+{
+public:
+  CommandLineParserException( std::string message )
+    : std::runtime_error( message )
+  {
+  }
+};
+
+
+struct CPPUNIT_API CommandLinePlugInInfo
+{
+  std::string m_fileName;
+  PlugInParameters m_parameters;
+};
+
+
+/*! \brief Parses the command line of a test runner (see CommandLineRunner).
+ * \ingroup ExecutingTest
+
+-c --compiler
+-x --xml [filename]
+-s --xsl stylesheet
+-e --encoding encoding
+-b --brief-progress
+-n --no-progress
+-t --text
+-o --cout
+-w --wait
+-g --tags expression
+-u --update-snapshots
+-a --benchmark-cpus cpu-list
+-r --raise-priority
+-j --benchmark-results filename
+-k --benchmark-baseline filename
+-p --profile-listeners
+-i --startup-profile
+-d --idle-time
+-m --live-metrics filename
+-l --metrics-worker index
+-f --metrics-textfile filename
+-C --coordinator port
+-W --worker host:port
+-O --test-timeout seconds
+-A --worker-wait seconds
+-P --parallel threads
+-N --processes count
+-S --shard index/count
+-T --timing
+-h --help
+filename[="options"]
+:testpath
+
+ */
+class CPPUNIT_API CommandLineParser
+{
+public:
+  /*! Constructs a CommandLineParser object.
+   */
+  CommandLineParser( int argc, 
+                     const char *argv[] );
+
+  /// Destructor.
+  virtual ~CommandLineParser();
+
+  /*! Parses the command line.
+   * \exception CommandLineParserException if an error occurs.
+   */
+  void parse();
+
+  bool useCompilerOutputter() const;
+  bool useXmlOutputter() const;
+  std::string getXmlFileName() const;
+  std::string getXmlStyleSheet() const;
+  std::string getEncoding() const;
+  bool useBriefTestProgress() const;
+  bool noTestProgress() const;
+  bool useTextOutputter() const;
+  bool useCoutStream() const;
+  bool waitBeforeExit() const;
+  std::string getTestPath() const;
+  std::string getTagExpression() const;
+  bool updateSnapshots() const;
+  const CppUnitVector<int> &getBenchmarkCpus() const;
+  bool raiseBenchmarkPriority() const;
+  std::string getBenchmarkResultsFileName() const;
+  std::string getBenchmarkBaselineFileName() const;
+  bool profileListeners() const;
+  bool profileStartup() const;
+  bool measureIdleTime() const;
+  std::string getLiveMetricsFileName() const;
+  int getMetricsWorkerIndex() const;
+  std::string getMetricsTextFileName() const;
+  int getCoordinatorPort() const;
+  std::string getWorkerHost() const;
+  int getWorkerPort() const;
+  double getTestTimeout() const;
+  double getWorkerWaitTimeout() const;
+  int getThreadCount() const;
+  int getProcessCount() const;
+  int getShardIndex() const;
+  int getShardCount() const;
+  bool reportTiming() const;
+  bool showHelp() const;
+  int getPlugInCount() const;
+  CommandLinePlugInInfo getPlugInAt( int index ) const;
+
+protected:
+  /// Prevents the use of the copy constructor.
+  CommandLineParser( const CommandLineParser &copy );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const CommandLineParser &copy );
+
+  void readNonOptionCommands();
+
+  bool hasNextArgument() const;
+
+  std::string getNextArgument();
+
+  std::string getCurrentArgument() const;
+
+  bool argumentStartsWith( const std::string &expected ) const;
+
+  void getNextOption();
+
+  bool isOption( const std::string &shortName,
+                 const std::string &longName );
+
+  std::string getNextParameter();
+
+  std::string getNextOptionalParameter();
+
+  /// Returns the TCP port \a port, or fails if it is not one.
+  int parsePort( const std::string &port );
+
+  /// Returns the number \a value, or fails if it is not a positive one.
+  int parsePositive( const std::string &value );
+
+  /// Returns the time \a value, or fails if it is not a number of seconds.
+  double parseSeconds( const std::string &value );
+
+  void fail( std::string message );
+
+protected:
+  bool m_useCompiler;
+  bool m_useXml;
+  std::string m_xmlFileName;
+  std::string m_xsl;
+  std::string m_encoding;
+  bool m_briefProgress;
+  bool m_noProgress;
+  bool m_useText;
+  bool m_useCout;
+  bool m_waitBeforeExit;
+  std::string m_testPath;
+  std::string m_tagExpression;
+  bool m_updateSnapshots;
+  CppUnitVector<int> m_benchmarkCpus;
+  bool m_raiseBenchmarkPriority;
+  std::string m_benchmarkResultsFileName;
+  std::string m_benchmarkBaselineFileName;
+  bool m_profileListeners;
+  bool m_profileStartup;
+  bool m_measureIdleTime;
+  std::string m_liveMetricsFileName;
+  int m_metricsWorkerIndex;
+  std::string m_metricsTextFileName;
+  int m_coordinatorPort;
+  std::string m_workerHost;
+  int m_workerPort;
+  double m_testTimeout;
+  double m_workerWaitTimeout;
+  int m_threadCount;
+  int m_processCount;
+  int m_shardIndex;
+  int m_shardCount;
+  bool m_reportTiming;
+  bool m_showHelp;
+
+  typedef CppUnitDeque<CommandLinePlugInInfo> PlugIns;
+  PlugIns m_plugIns;
+
+  typedef CppUnitDeque<std::string> Arguments;
+  Arguments m_arguments;
+  unsigned int m_currentArgument;
+
+  std::string m_option;
+};
+
+
+CPPUNIT_NS_END
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_COMMANDLINEPARSER_H
@@ -0,0 +1,150 @@
+#ifndef CPPUNIT_COMMANDLINERUNNER_H
+#define CPPUNIT_COMMANDLINERUNNER_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/portability/Stream.h>
+#include <string>
+
+CPPUNIT_NS_BEGIN
+
+
+class CommandLineParser;
+class PlugInManager;
+class Test;
+class TestResult;
+
+
+/*! \brief Runs the tests of a registry as specified by a command line.
+ * \ingroup ExecutingTest
+ *
+ * This is the runner of DllPlugInTester, usable by any test executable: the
+ * tests are the ones of a TestFactoryRegistry (the default one unless
+ * specified), to which the tests of the plug-ins given on the command line
+ * are added. The command line selects the tests (test path, tags, shard),
+ * how they are run (sequentially, on threads, in worker processes or on
+ * remote workers), the progress listeners, the outputters and the reports
+ * (timing, idle time, profiles, benchmarks). Run with \c --help for the
+ * list of options.
+ *
+ * Statically linked test executables can use cppunit_main() as their
+ * main():
+ * \code
+ * #include <cppunit/CommandLineRunner.h>
+ *
+ * int main( int argc, char *argv[] )
+ * {
+ *   return cppunit_main( argc, argv );
+ * }
+ * \endcode
+ *
+ * In parallel mode (\c --parallel), the tests are run on threads, in the
+ * batches of a ResourceScheduler: tests sharing an exclusive resource are
+ * never run at the same time. The listeners are called with the lock of the
+ * TestResult held. In process mode (\c --processes), the tests are run by
+ * forked worker processes (DistributedWorker): a test that crashes its
+ * process is reported as an error instead of ending the run, and the
+ * crashed worker is replaced. A worker running a test for longer than the
+ * test timeout (\c --test-timeout) is killed.
+ */
+class CPPUNIT_API CommandLineRunner
+{
+public:
+  /// Exit codes of main().
+  enum ReturnCode
+  {
+    successReturnCode = 0,        ///< All the tests passed.
+    failureReturnCode = 1,        ///< A test failed, or the run failed.
+    badCommandLineReturnCode = 2  ///< The command line is invalid.
+  };
+
+  /*! Constructs a CommandLineRunner object.
+   * \param registryName Name of the TestFactoryRegistry whose tests are run.
+   */
+  CommandLineRunner( const std::string &registryName = "All Tests" );
+
+  /// Destructor.
+  virtual ~CommandLineRunner();
+
+  /*! \brief Parses the command line and runs the tests.
+   *
+   * Prints the usage if the command line is invalid or if it is \c --help.
+   * \return Exit code of the application (see ReturnCode).
+   */
+  int main( int argc,
+            const char *argv[] );
+
+  /*! \brief Runs the tests as specified by a parsed command line.
+   * \return \c true if the run succeed, \c false if a test failed or if a
+   *         test path was not resolved.
+   * \exception DynamicLibraryManagerException if a plug-in can not be loaded.
+   */
+  bool run( const CommandLineParser &parser );
+
+  /// Prints the synopsis of the command line to the standard output.
+  static void printShortUsage( const std::string &applicationName );
+
+  /// Prints the synopsis and the options to the standard output.
+  static void printUsage( const std::string &applicationName );
+
+private:
+  /*! \brief Selects the tests to run and runs them in the specified mode.
+   * \exception std::invalid_argument if the tests can not be selected.
+   * \exception std::runtime_error if the run could not be done.
+   */
+  void runSelectedTests( const CommandLineParser &parser,
+                         Test *root,
+                         TestResult &controller );
+
+  /*! \brief Runs \a test on the workers forked for the run.
+   * \exception std::runtime_error if the workers can not be forked.
+   */
+  void runInProcesses( const CommandLineParser &parser,
+                       Test *test,
+                       TestResult &controller );
+
+  /*! \brief Saves the benchmark results and compares them to the baseline.
+   * \return \c false if a benchmark regressed or if a file could not be
+   *         read or written, \c true otherwise.
+   */
+  bool processBenchmarkResults( const CommandLineParser &parser,
+                                OStream &stream );
+
+  /// Prevents the use of the copy constructor.
+  CommandLineRunner( const CommandLineRunner &copy );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const CommandLineRunner &copy );
+
+private:
+  std::string m_registryName;
+  /// Plug-ins loaded by run(), whose listeners the workers also register.
+  PlugInManager *m_plugInManager;
+};
+
+
+CPPUNIT_NS_END
+
+
+/*! \brief Runs the tests of the default registry as specified by the
+ *         command line.
+ * \ingroup ExecutingTest
+ *
+ * Equivalent to CommandLineRunner().main( argc, argv ).
+ * \return Exit code of the application: 0 if all the tests passed, 1 if a
+ *         test failed, 2 if the command line is invalid.
+ */
+CPPUNIT_API int cppunit_main( int argc,
+                              char *argv[] );
+
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_COMMANDLINERUNNER_H
@@ -76,6 +76,14 @@ public:
   /// Clones the exception.
   virtual Exception *clone() const;
 
+  /*! \brief Throws a copy of the exception.
+   *
+   * Used to throw again, with its own type, an exception kept with clone(),
+   * for example in another thread. A subclass that overrides clone()
+   * overrides this method too.
+   */
+  virtual void throwCopy() const;
+
 protected:
   // VC++ does not recognize call to parent class when prefixed
   // with a namespace. This is a workaround.
@@ -0,0 +1,177 @@
+#ifndef CPPUNIT_IDLETIMELISTENER_H
+#define CPPUNIT_IDLETIMELISTENER_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/TestListener.h>
+#include <cppunit/portability/CppUnitMap.h>
+#include <cppunit/portability/CppUnitVector.h>
+#include <cppunit/portability/Stream.h>
+#include <string>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief What a test spent its wall time on.
+ * \ingroup TrackingTestExecution
+ */
+enum IdleTimeKind
+{
+  idleCpuBound = 0,   ///< Running most of the time.
+  idleSleepBound,     ///< Waiting on timers, locks or sockets.
+  idleIoBound         ///< Waiting on disk I/O.
+};
+
+
+/*! \brief TestListener that finds the tests that spend their time waiting.
+ * \ingroup TrackingTestExecution
+ *
+ * For each test, the listener records the wall time, the CPU time of the
+ * thread running the test (CLOCK_THREAD_CPUTIME_ID), its voluntary context
+ * switches and block I/O operations (getrusage()), and the time it waited
+ * on disk I/O (the delay accounting of /proc/thread-self/stat, only
+ * maintained by Linux kernels booted with delayacct).
+ *
+ * The time the test did not run is its idle time. A test is CPU-bound if it
+ * ran most of its wall time, I/O-bound if it was idle waiting on disk I/O,
+ * and sleep-bound otherwise: it waited on a timer, a lock, a condition or a
+ * socket, which the kernel does not tell apart. Sleep-bound tests are the
+ * ones to convert to a virtual clock, and the ones a parallel scheduler can
+ * run more of than there are processors.
+ *
+ * Only the thread running the test is measured: a test that waits for
+ * worker threads it started is reported as sleep-bound.
+ *
+ * \code
+ * CppUnit::IdleTimeListener idleTime;
+ * controller.addListener( &idleTime );
+ * runner.run( controller );
+ * idleTime.write( CppUnit::stdCOut() );
+ * \endcode
+ */
+class CPPUNIT_API IdleTimeListener : public TestListener
+{
+public:
+  /*! Constructs a IdleTimeListener object.
+   * \param cpuBoundRatio Smallest ratio of the CPU time to the wall time of
+   *                      a CPU-bound test.
+   * \param minimumIdleSeconds Idle time below which a test is CPU-bound,
+   *                           whatever its ratio.
+   */
+  IdleTimeListener( double cpuBoundRatio = 0.8,
+                    double minimumIdleSeconds = 0.001 );
+
+  /// Destructor.
+  virtual ~IdleTimeListener();
+
+  void startTest( Test *test );
+
+  void endTest( Test *test );
+
+  /// Removes the recorded tests.
+  void reset();
+
+  /// Returns the number of recorded tests, in order of completion.
+  int testCount() const;
+
+  std::string testNameAt( int index ) const;
+
+  double wallSecondsAt( int index ) const;
+
+  /// Returns the CPU time of the thread that ran the test.
+  double cpuSecondsAt( int index ) const;
+
+  /// Returns the wall time the test did not run.
+  double idleSecondsAt( int index ) const;
+
+  long voluntarySwitchesAt( int index ) const;
+
+  /// Returns the time the test waited on disk I/O, 0 if it is not known.
+  double ioWaitSecondsAt( int index ) const;
+
+  /// Returns the number of block input and output operations.
+  long blockOperationsAt( int index ) const;
+
+  IdleTimeKind kindAt( int index ) const;
+
+  /// Returns the number of tests of the specified kind.
+  int count( IdleTimeKind kind ) const;
+
+  /// Returns the idle time of all the tests.
+  double totalIdleSeconds() const;
+
+  /*! \brief Classifies a test from its measures.
+   *
+   * A test is CPU-bound if its idle time is below the minimum or if its CPU
+   * time is at least the CPU-bound ratio of its wall time. Otherwise it is
+   * I/O-bound if it waited on disk I/O for half of its idle time, or if it
+   * did block operations when the I/O wait is not known, and sleep-bound
+   * if not.
+   */
+  IdleTimeKind classify( double wallSeconds,
+                         double cpuSeconds,
+                         double ioWaitSeconds,
+                         long blockOperations ) const;
+
+  /*! \brief Writes the number of tests of each kind and the worst sleepers.
+   * \param stream Stream to write to.
+   * \param maximumTestCount Largest number of tests written, in order of
+   *                         decreasing idle time. CPU-bound tests are not
+   *                         written.
+   */
+  void write( OStream &stream,
+              int maximumTestCount = 10 ) const;
+
+  /// Returns the name of a kind ("sleep-bound").
+  static std::string kindName( IdleTimeKind kind );
+
+private:
+  /// Prevents the use of the copy constructor.
+  IdleTimeListener( const IdleTimeListener &copy );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const IdleTimeListener &copy );
+
+private:
+  /// Counters of the thread running a test.
+  struct Counters
+  {
+    double m_wallSeconds;
+    double m_cpuSeconds;
+    double m_ioWaitSeconds;
+    long m_voluntarySwitches;
+    long m_blockOperations;
+  };
+
+  struct Record
+  {
+    std::string m_testName;
+    Counters m_counters;
+    IdleTimeKind m_kind;
+  };
+
+  /// Reads the counters of the calling thread.
+  static Counters readCounters();
+
+  typedef CppUnitMap<Test *, Counters, std::less<Test *> > StartCounters;
+
+  double m_cpuBoundRatio;
+  double m_minimumIdleSeconds;
+  StartCounters m_startCounters;
+  CppUnitVector<Record> m_records;
+};
+
+
+CPPUNIT_NS_END
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_IDLETIMELISTENER_H
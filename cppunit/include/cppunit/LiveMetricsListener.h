@@ -0,0 +1,130 @@
+#ifndef CPPUNIT_LIVEMETRICSLISTENER_H
+#define CPPUNIT_LIVEMETRICSLISTENER_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/TestListener.h>
+#include <cppunit/tools/LiveMetricsSegment.h>
+#include <cppunit/tools/ThreadGroup.h>
+#include <string>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief TestListener that publishes the progress of a run in a
+ *         LiveMetricsSegment.
+ * \ingroup TrackingTestExecution
+ *
+ * The listener updates the slot of its worker when a test starts, fails or
+ * ends: tests started and finished, failures, errors, current test and
+ * resident set size of the process. The run can then be watched from
+ * outside the process, by cppunit-top or by the Prometheus node exporter,
+ * without any network service.
+ *
+ * If a text file name is given, the metrics of all the workers of the
+ * segment are written to it in the Prometheus text format at the start of
+ * the run, then once per render interval by a BackgroundThread, so that a
+ * long test does not hold the file back, and at the end of the run. If
+ * threads are not available, the file is written at the end of a test
+ * instead, at most once per render interval. If the file can not be written,
+ * the listener stops writing it but keeps updating the segment.
+ *
+ * \code
+ * CppUnit::LiveMetricsSegment segment( "/dev/shm/cppunit-soak", true );
+ * CppUnit::LiveMetricsListener metrics( segment, shardIndex,
+ *     "/var/lib/node_exporter/textfile/cppunit.prom" );
+ * controller.addListener( &metrics );
+ * \endcode
+ */
+class CPPUNIT_API LiveMetricsListener : public TestListener
+                                      , private ThreadTask
+{
+public:
+  /*! Constructs a LiveMetricsListener object.
+   * \param segment Segment to publish to, mapped for writing.
+   * \param workerIndex Index of the slot of this worker in the segment. Each
+   *                    worker running concurrently must use its own slot.
+   * \param textFileName Name of the Prometheus text file to write. No file
+   *                     is written if empty.
+   * \param renderIntervalSeconds Smallest time between two writes of the
+   *                              text file.
+   * \exception std::invalid_argument if \a workerIndex is out of range.
+   */
+  LiveMetricsListener( LiveMetricsSegment &segment,
+                       int workerIndex,
+                       const std::string &textFileName = "",
+                       double renderIntervalSeconds = 10 );
+
+  /// Destructor.
+  virtual ~LiveMetricsListener();
+
+  void startTestRun( Test *test,
+                     TestResult *eventManager );
+
+  void startTest( Test *test );
+
+  void addFailure( const TestFailure &failure );
+
+  void endTest( Test *test );
+
+  void endTestRun( Test *test,
+                   TestResult *eventManager );
+
+  /// Returns the metrics last published.
+  const LiveWorkerMetrics &metrics() const;
+
+  /// Returns the resident set size of the process, 0 if unknown.
+  static long residentBytes();
+
+private:
+  /// Prevents the use of the copy constructor.
+  LiveMetricsListener( const LiveMetricsListener &copy );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const LiveMetricsListener &copy );
+
+  /// Clears the counters and marks the worker as running.
+  void startRun();
+
+  /// Writes the metrics to the segment.
+  void publish();
+
+  /// Writes the text file if \a force or if the render interval elapsed.
+  void render( bool force );
+
+  /// Starts the thread writing the text file, if there is one.
+  void startRenderer();
+
+  /// Stops the thread writing the text file.
+  void stopRenderer();
+
+  /// Writes the text file once per render interval until stopRenderer().
+  void run( int threadIndex );
+
+private:
+  LiveMetricsSegment &m_segment;
+  int m_workerIndex;
+  std::string m_textFileName;
+  double m_renderIntervalSeconds;
+  double m_lastRenderTime;
+  LiveWorkerMetrics m_metrics;
+  /// Protects the text file name, the last render time and the stop flag.
+  ThreadMutex m_renderMutex;
+  BackgroundThread m_renderer;
+  bool m_rendererStopped;
+};
+
+
+CPPUNIT_NS_END
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_LIVEMETRICSLISTENER_H
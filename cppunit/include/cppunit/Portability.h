@@ -87,6 +87,32 @@
 #endif
 #endif
 
+/* Define to 1 if the compiler supports rvalue references, std::move() and
+   noexcept (C++11). Used by OrthodoxMove. */
+#if !defined(CPPUNIT_HAVE_RVALUE_REFERENCES)
+# if __cplusplus >= 201103L  ||  ( defined(_MSC_VER)  &&  _MSC_VER >= 1900 )
+#  define CPPUNIT_HAVE_RVALUE_REFERENCES 1
+# else
+#  define CPPUNIT_HAVE_RVALUE_REFERENCES 0
+# endif
+#endif
+
+/* Storage class of the variables that have one instance per thread.
+   CPPUNIT_HAVE_THREAD_LOCAL is defined to 1 if the compiler supports it,
+   otherwise CPPUNIT_THREAD_LOCAL is empty and such variables are shared
+   by all threads. */
+#if !defined(CPPUNIT_THREAD_LOCAL)
+# if defined(__GNUC__)
+#  define CPPUNIT_THREAD_LOCAL __thread
+#  define CPPUNIT_HAVE_THREAD_LOCAL 1
+# elif defined(_MSC_VER)
+#  define CPPUNIT_THREAD_LOCAL __declspec(thread)
+#  define CPPUNIT_HAVE_THREAD_LOCAL 1
+# else
+#  define CPPUNIT_THREAD_LOCAL
+# endif
+#endif
+
 // If CPPUNIT_HAVE_CPP_CAST is defined, then c++ style cast will be used,
 // otherwise, C style cast are used.
 #if defined( CPPUNIT_HAVE_CPP_CAST )
@@ -95,11 +121,16 @@
 
 # define CPPUNIT_STATIC_CAST( TargetType, pointer ) \
     static_cast<TargetType>( pointer )
+
+# define CPPUNIT_REINTERPRET_CAST( TargetType, pointer ) \
+    reinterpret_cast<TargetType>( pointer )
 #else // defined( CPPUNIT_HAVE_CPP_CAST )
 # define CPPUNIT_CONST_CAST( TargetType, pointer ) \
     ((TargetType)( pointer ))
 # define CPPUNIT_STATIC_CAST( TargetType, pointer ) \
     ((TargetType)( pointer ))
+# define CPPUNIT_REINTERPRET_CAST( TargetType, pointer ) \
+    ((TargetType)( pointer ))
 #endif // defined( CPPUNIT_HAVE_CPP_CAST )
 
 // If CPPUNIT_NO_STD_NAMESPACE is defined then STL are in the global space.
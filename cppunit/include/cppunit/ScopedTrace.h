@@ -0,0 +1,143 @@
+#ifndef CPPUNIT_SCOPEDTRACE_H
+#define CPPUNIT_SCOPEDTRACE_H
+
+#include <cppunit/Portability.h>
+#include <cppunit/TestAssert.h>
+#include <string>
+
+
+CPPUNIT_NS_BEGIN
+
+
+class Message;
+
+
+/*! \brief Context added to the message of the assertions failing in its scope.
+ * \ingroup Assertions
+ *
+ * Trace contexts are stacked per thread while they exist. When an assertion
+ * fails, Asserter::fail() adds the description of each context of the
+ * thread, from the outermost to the innermost, to the details of the
+ * failure message. Nothing is formatted while the assertions pass: the
+ * cost of a context is to link it in, and out of, the stack.
+ *
+ * Subclass it to describe a context, or use CPPUNIT_SCOPED_TRACE().
+ */
+class CPPUNIT_API TraceContext
+{
+public:
+  /// Makes this context the innermost one of the calling thread.
+  TraceContext();
+
+  /// Removes this context from the stack of the calling thread.
+  virtual ~TraceContext();
+
+  /// Returns the description added to the failure message.
+  virtual std::string describe() const =0;
+
+  /// Adds the description of the contexts of the calling thread to \a message.
+  static void addDetails( Message &message );
+
+  /// Returns the innermost context of the calling thread, or \c NULL.
+  static TraceContext *current();
+
+  /*! \brief Removes the contexts inner to \a context from the stack.
+   *
+   * Used when longjmp() returned through the scopes of the contexts without
+   * destroying them (see AssertionTrap).
+   */
+  static void unwindTo( TraceContext *context );
+
+protected:
+  /// Links the copy in the stack, as CPPUNIT_SCOPED_TRACE() may copy it.
+  TraceContext( const TraceContext &copy );
+
+private:
+  /// Prevents the use of the copy operator.
+  void operator =( const TraceContext &copy );
+
+private:
+  TraceContext *m_previous;
+};
+
+
+/*! \brief Trace context describing a value, formatted on failure only.
+ * \ingroup Assertions
+ *
+ * The value is copied, and converted to a string by assertion_traits only
+ * when an assertion fails.
+ * \see CPPUNIT_SCOPED_TRACE.
+ */
+template<class ValueType>
+class ScopedTrace : public TraceContext
+{
+public:
+  /*! Constructs a ScopedTrace object.
+   * \param label Name of the value. Must outlive the trace (a literal).
+   * \param value Value described on failure.
+   */
+  ScopedTrace( const char *label,
+               const ValueType &value )
+      : m_label( label )
+      , m_value( value )
+  {
+  }
+
+  std::string describe() const
+  {
+    return std::string( m_label ) + " = " +
+           assertion_traits<ValueType>::toString( m_value );
+  }
+
+private:
+  const char *m_label;
+  ValueType m_value;
+};
+
+
+/*! \brief (Implementation) Makes the ScopedTrace of a value.
+ * \ingroup Assertions
+ * \sa CPPUNIT_SCOPED_TRACE.
+ */
+template<class ValueType>
+ScopedTrace<ValueType> makeScopedTrace( const char *label,
+                                        const ValueType &value )
+{
+  return ScopedTrace<ValueType>( label, value );
+}
+
+
+/*! \brief Adds a value to the message of the assertions failing in the scope.
+ * \ingroup Assertions
+ *
+ * The expression and its value are added to the details of the failure
+ * message of the assertions that fail until the end of the enclosing block,
+ * including in the functions called from it. The value is copied when the
+ * trace is made, and formatted only if an assertion fails: tracing the
+ * indexes of nested loops costs a few instructions per iteration.
+ *
+ * \code
+ * for ( int row = 0; row < table.rowCount(); ++row )
+ * {
+ *   CPPUNIT_SCOPED_TRACE( row );
+ *   for ( int column = 0; column < table.columnCount(); ++column )
+ *   {
+ *     CPPUNIT_SCOPED_TRACE( column );
+ *     CPPUNIT_ASSERT( table.cell( row, column ).isValid() );
+ *   }
+ * }
+ * \endcode
+ * A failure is then reported with the details "Trace: row = 2" and
+ * "Trace: column = 5".
+ *
+ * The value is converted to a string by assertion_traits: specialize them
+ * for the types that do not support operator <<.
+ */
+#define CPPUNIT_SCOPED_TRACE( value )                                          \
+  const CPPUNIT_NS::TraceContext &CPPUNIT_MAKE_UNIQUE_NAME( cpputTrace_ ) =    \
+      CPPUNIT_NS::makeScopedTrace( #value, (value) )
+
+
+CPPUNIT_NS_END
+
+#endif  // CPPUNIT_SCOPEDTRACE_H
@@ -2,6 +2,13 @@
 #define CPPUNIT_TEST_H
 
 #include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/portability/CppUnitVector.h>
 #include <string>
 
 CPPUNIT_NS_BEGIN
@@ -56,6 +63,17 @@ public:
    */
   virtual Test *getChildTestAt( int index ) const;
 
+  /*! \brief Tests if the child tests can be run without this test.
+   *
+   * Runners that select or schedule the test cases of a hierarchy (see
+   * TestSelection and ResourceScheduler) run the child tests directly, unless
+   * this method returns \c false: the test is then run as a whole, by its
+   * run() method. A TestDecorator returns \c false, as it decorates the run of
+   * its child tests (TestSetUp, RepeatedTest...).
+   * \return \c true by default.
+   */
+  virtual bool canRunChildTestsSeparately() const;
+
   /*! \brief Returns the test name.
    * 
    * Each test has a name.  This name may be used to find the
@@ -96,6 +114,33 @@ public:
    */
   virtual TestPath resolveTestPath( const std::string &testPath ) const;
 
+  /*! \brief Sets the value of a property of the test.
+   *
+   * Properties are free form key/value pairs attached to the test. The
+   * properties declared with CPPUNIT_TEST_SUITE_PROPERTY() are set on the
+   * fixture suite, so that they remain available once the suite has been
+   * built (see ResourceScheduler for an example of usage).
+   *
+   * \param key Key of the property. If a property with the same key already
+   *            exists, its value is replaced.
+   * \param value Value of the property.
+   */
+  void setProperty( const std::string &key,
+                    const std::string &value );
+
+  /*! \brief Returns the value of a property of the test.
+   * \param key Key of the property.
+   * \return Value of the property, or an empty string if the test does not
+   *         have a property named \a key.
+   */
+  std::string getProperty( const std::string &key ) const;
+
+  /*! \brief Tests if the test has the specified property.
+   * \param key Key of the property.
+   * \return \c true if a property named \a key was set, \c false otherwise.
+   */
+  bool hasProperty( const std::string &key ) const;
+
 protected:
   /*! Throws an exception if the specified index is invalid.
    * \param index Zero base index of a child test.
@@ -108,10 +153,22 @@ protected:
    * \return Pointer on the test. Never \c NULL.
    */
   virtual Test *doGetChildTestAt( int index ) const =0;
+
+private:
+  // Notes: we use a vector here instead of a map to work-around the
+  // shared std::map in dll bug in VC6.
+  typedef std::pair<std::string,std::string> Property;
+  typedef CppUnitVector<Property> Properties;
+
+  Properties m_properties;
 };
 
 
 CPPUNIT_NS_END
 
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
 #endif // CPPUNIT_TEST_H
 
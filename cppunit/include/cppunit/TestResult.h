@@ -15,6 +15,7 @@
 CPPUNIT_NS_BEGIN
 
 
+class CallbackProfile;
 class Exception;
 class Functor;
 class Protector;
@@ -124,6 +125,16 @@ public:
   /// Removes the last protector from the protector chain.
   virtual void popProtector();
 
+  /*! \brief Sets the profile that records the time spent in each listener.
+   * \param profile Profile each listener call is timed into, \c NULL (the
+   *                default) to not time the calls. Not owned, must be valid
+   *                until it is replaced.
+   */
+  virtual void setProfile( CallbackProfile *profile );
+
+  /// Returns the profile set by setProfile(), \c NULL if there is none.
+  CallbackProfile *profile() const;
+
 protected:
   /*! \brief Called to add a failure to the list of failures.
    */
@@ -137,6 +148,7 @@ protected:
   TestListeners m_listeners;
   ProtectorChain *m_protectorChain;
   bool m_stop;
+  CallbackProfile *m_profile;
 
 private: 
   TestResult( const TestResult &other );
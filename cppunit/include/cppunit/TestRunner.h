@@ -94,6 +94,22 @@ public:
   virtual void run( TestResult &controller,
                     const std::string &testPath = "" );
 
+  /*! \brief Runs the tests matching a tag expression.
+   *
+   * Only the test cases of the test specified by \a testPath whose tags match
+   * \a tagExpression are run. The decorators of the selected tests are kept
+   * (see TaggedTestIndex::select()). See TagExpression for the expression
+   * syntax.
+   * \param controller Event manager and controller used for testing
+   * \param tagExpression Expression the tags of the tests must match.
+   * \param testPath Test path string. See Test::resolveTestPath() for detail.
+   * \exception std::invalid_argument if no test matching \a testPath is found,
+   *                                  or if \a tagExpression is malformed.
+   */
+  virtual void runTagged( TestResult &controller,
+                          const std::string &tagExpression,
+                          const std::string &testPath = "" );
+
 protected:
   /*! \brief (INTERNAL) Mutating test suite.
    */
@@ -17,6 +17,7 @@
 CPPUNIT_NS_BEGIN
 
 
+class CallbackProfile;
 class Test;
 class TestFailure;
 class TestResultCollector;
@@ -85,6 +86,14 @@ public:
    */
   virtual void setStandalone( bool standalone );
 
+  /*! \brief Sets the profile that records the time spent in each hook.
+   * \param profile Profile each hook call is timed into, \c NULL (the
+   *                default) to not time the calls. Not owned, must be valid
+   *                until it is replaced.
+   * \see CallbackProfile.
+   */
+  virtual void setProfile( CallbackProfile *profile );
+
   typedef CppUnitMap<Test *,TestFailure*, std::less<Test*> > FailedTests;
 
   /*! \brief Sets the root element and adds its children.
@@ -145,6 +154,7 @@ protected:
   std::string m_styleSheet;
   XmlDocument *m_xml;
   Hooks m_hooks;
+  CallbackProfile *m_profile;
 
 private:
   /// Prevents the use of the copy constructor.
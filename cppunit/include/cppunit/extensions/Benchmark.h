@@ -0,0 +1,687 @@
+#ifndef CPPUNIT_EXTENSIONS_BENCHMARK_H
+#define CPPUNIT_EXTENSIONS_BENCHMARK_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/SourceLine.h>
+#include <cppunit/extensions/BenchmarkEnvironment.h>
+#include <cppunit/portability/CppUnitVector.h>
+#include <string>
+
+
+CPPUNIT_NS_BEGIN
+
+
+class ThreadBarrier;
+
+
+/*! \brief Complexity classes fitted to the timings of a benchmark.
+ * \ingroup WritingTestFixture
+ *
+ * Ordered from the cheapest to the most expensive.
+ */
+enum BenchmarkComplexity
+{
+  complexityConstant = 0,   ///< O(1)
+  complexityLogarithmic,    ///< O(log n)
+  complexityLinear,         ///< O(n)
+  complexityLinearithmic,   ///< O(n log n)
+  complexityQuadratic,      ///< O(n^2)
+  complexityCubic,          ///< O(n^3)
+  complexityAny             ///< No bound (not a fitted class).
+};
+
+
+/*! \brief State of the caches when an iteration of a benchmark starts.
+ * \ingroup WritingTestFixture
+ */
+enum BenchmarkCacheState
+{
+  cacheWarm = 0,  ///< The data of the previous iterations is still cached.
+  cacheCold       ///< The caches are evicted before each iteration.
+};
+
+
+/*! \brief Evicts the processor caches by reading a large buffer.
+ * \ingroup WritingTestFixture
+ *
+ * The buffer should be larger than the last level cache: reading it replaces
+ * the cached lines of the benchmarked data. By default, its size is twice
+ * the size of the largest cache reported by the host.
+ */
+class CPPUNIT_API BenchmarkCacheEvictor
+{
+public:
+  /*! Constructs a BenchmarkCacheEvictor object.
+   * \param byteCount Size of the buffer, 0 to use twice the size of the last
+   *                  level cache (64 MB if it is not known).
+   */
+  BenchmarkCacheEvictor( long byteCount = 0 );
+
+  /// Destructor.
+  virtual ~BenchmarkCacheEvictor();
+
+  /// Returns the size of the buffer.
+  long byteCount() const;
+
+  /*! \brief Reads each cache line of the buffer.
+   *
+   * Only reads, so that several threads can evict at the same time.
+   * \return Checksum of the buffer, so that the reads are not optimized away.
+   */
+  int evict() const;
+
+  /*! \brief Returns the size of the largest cache of the first processor.
+   *
+   * Read from /sys/devices/system/cpu/cpu0/cache.
+   * \return Size in bytes, 0 if it is not known.
+   */
+  static long lastLevelCacheSize();
+
+private:
+  /// Prevents the use of the copy constructor.
+  BenchmarkCacheEvictor( const BenchmarkCacheEvictor &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const BenchmarkCacheEvictor &other );
+
+private:
+  CppUnitVector<char> m_buffer;
+};
+
+
+/*! \brief Controls the iterations of one benchmark measurement.
+ * \ingroup WritingTestFixture
+ *
+ * The benchmark body runs the measured code in a loop controlled by
+ * keepRunning(). The timing starts on the first call to keepRunning(), so
+ * that the set up done before the loop is not measured, and stops when it
+ * returns \c false.
+ *
+ * When the benchmark is run on several threads (see 
+ * BenchmarkRunner::runThreads()), each thread has its own BenchmarkState:
+ * the variables declared before the loop are local to the thread, and
+ * threadIndex() selects the part of the fixture a thread works on. The first
+ * call to keepRunning() waits for all the threads, so that they start their
+ * loop together.
+ *
+ * The amount of data processed by an iteration can be given with
+ * setBytesProcessed() and setItemsProcessed(): the results then also report
+ * the throughput of the benchmark, in bytes and items per second.
+ *
+ * \code
+ * void benchmarkSort( CppUnit::BenchmarkState &state )
+ * {
+ *   std::vector<int> values = makeRandomValues( state.size() );
+ *   state.setItemsProcessed( state.size() );
+ *   while ( state.keepRunning() )
+ *   {
+ *     state.pauseTiming();
+ *     std::vector<int> sorted( values );
+ *     state.resumeTiming();
+ *     std::sort( sorted.begin(), sorted.end() );
+ *   }
+ * }
+ * \endcode
+ */
+class CPPUNIT_API BenchmarkState
+{
+public:
+  /*! Constructs a BenchmarkState object.
+   * \param size Size of the problem, given to the benchmark body.
+   * \param iterationCount Number of iterations to run.
+   * \param threadIndex Zero based index of the thread running the benchmark.
+   * \param threadCount Number of threads running the benchmark.
+   * \param startBarrier Barrier waited for before the timing starts, 
+   *                     \c NULL if the benchmark runs on a single thread.
+   */
+  BenchmarkState( long size,
+                  long iterationCount,
+                  int threadIndex = 0,
+                  int threadCount = 1,
+                  ThreadBarrier *startBarrier = NULL );
+
+  /// Destructor.
+  virtual ~BenchmarkState();
+
+  /// Returns the size of the problem to benchmark.
+  long size() const;
+
+  /// Returns the number of iterations to run.
+  long iterationCount() const;
+
+  /// Returns the zero based index of the thread running the benchmark.
+  int threadIndex() const;
+
+  /// Returns the number of threads running the benchmark.
+  int threadCount() const;
+
+  /*! \brief Tests if another iteration must be run.
+   *
+   * Returns \c true iterationCount() times. If a cache evictor is set, the
+   * caches are evicted before each iteration, outside of the timing.
+   */
+  bool keepRunning();
+
+  /*! \brief Waits for the other threads, then starts the timing.
+   *
+   * Called by the first keepRunning(). Does nothing if already started.
+   */
+  void start();
+
+  /// Stops the timing, to exclude the preparation of an iteration.
+  void pauseTiming();
+
+  /// Restarts the timing stopped by pauseTiming().
+  void resumeTiming();
+
+  /*! \brief Sets the time taken by the current iteration.
+   *
+   * Used when the measured operation does not run in the calling thread
+   * (an asynchronous request, a kernel on a co-processor...). Once called,
+   * the measurement is the sum of the iteration times instead of the time
+   * spent in the loop.
+   */
+  void setIterationTime( double seconds );
+
+  /*! \brief Sets the evictor run before each iteration.
+   * \param evictor Cache evictor, \c NULL to keep the caches warm (the
+   *                default). Not owned by the state.
+   */
+  void setCacheEvictor( const BenchmarkCacheEvictor *evictor );
+
+  /// Sets the number of bytes processed by one iteration.
+  void setBytesProcessed( long byteCount );
+
+  /// Returns the number of bytes processed by one iteration, 0 if not set.
+  long bytesProcessed() const;
+
+  /// Sets the number of items processed by one iteration.
+  void setItemsProcessed( long itemCount );
+
+  /// Returns the number of items processed by one iteration, 0 if not set.
+  long itemsProcessed() const;
+
+  /// Tests if keepRunning() was called until it returned \c false.
+  bool isFinished() const;
+
+  /// Returns the measured time, in seconds.
+  double elapsedSeconds() const;
+
+private:
+  long m_size;
+  long m_iterationCount;
+  long m_remainingCount;
+  int m_threadIndex;
+  int m_threadCount;
+  ThreadBarrier *m_startBarrier;
+  bool m_started;
+  bool m_finished;
+  bool m_timing;
+  double m_startTime;
+  double m_elapsedSeconds;
+  bool m_useManualTime;
+  double m_manualSeconds;
+  const BenchmarkCacheEvictor *m_cacheEvictor;
+  long m_bytesProcessed;
+  long m_itemsProcessed;
+};
+
+
+/*! \brief Benchmark body run by a BenchmarkRunner.
+ * \ingroup WritingTestFixture
+ */
+class CPPUNIT_API BenchmarkFunction
+{
+public:
+  virtual ~BenchmarkFunction() {}
+
+  virtual void run( BenchmarkState &state ) =0;
+};
+
+
+/*! \brief BenchmarkFunction that calls a method of a fixture.
+ * \ingroup WritingTestFixture
+ */
+template<class Fixture>
+class BenchmarkMethod : public BenchmarkFunction
+{
+public:
+  typedef void (Fixture::*Method)( BenchmarkState &state );
+
+  BenchmarkMethod( Fixture *fixture,
+                   Method method )
+      : m_fixture( fixture )
+      , m_method( method )
+  {
+  }
+
+  void run( BenchmarkState &state )
+  {
+    (m_fixture->*m_method)( state );
+  }
+
+private:
+  Fixture *m_fixture;
+  Method m_method;
+};
+
+
+/*! \brief Timings of a benchmark, for each benchmarked size.
+ * \ingroup WritingTestFixture
+ *
+ * Each sample is the mean time of one iteration, in seconds, over one
+ * measurement. fitComplexity() fits the median sample of each size to
+ * <tt>coefficient * f(n)</tt> for each complexity class \c f, with least
+ * squares, and keeps the class with the lowest normalized root mean square
+ * error.
+ *
+ * A benchmark run on an increasing number of threads records instead one
+ * point of its scaling curve for each thread count: the aggregate throughput,
+ * the deviation of the throughput of the threads and the scaling efficiency.
+ *
+ * If the benchmark set the amount of data processed by an iteration, the
+ * throughput is also reported in bytes and items per second.
+ *
+ * The result also records the environment the benchmark was run in.
+ */
+class CPPUNIT_API BenchmarkResult
+{
+public:
+  /// Constructs an empty result.
+  BenchmarkResult();
+
+  /// Destructor.
+  virtual ~BenchmarkResult();
+
+  /*! \brief Adds a measurement.
+   * \param size Benchmarked size.
+   * \param iterationCount Number of iterations of the measurement.
+   * \param seconds Measured time of all the iterations.
+   * \param bytesPerIteration Number of bytes processed by one iteration.
+   * \param itemsPerIteration Number of items processed by one iteration.
+   */
+  void addSample( long size,
+                  long iterationCount,
+                  double seconds,
+                  long bytesPerIteration = 0,
+                  long itemsPerIteration = 0 );
+
+  /// Returns the number of benchmarked sizes.
+  int sizeCount() const;
+
+  /// Returns the benchmarked size of the specified index.
+  long sizeAt( int index ) const;
+
+  /// Returns the number of iterations of the last sample of the specified size.
+  long iterationCountAt( int index ) const;
+
+  /// Returns the samples of the specified size, in seconds per iteration.
+  const CppUnitVector<double> &samplesAt( int index ) const;
+
+  /// Returns the median sample of the specified size.
+  double medianAt( int index ) const;
+
+  /// Returns the smallest sample of the specified size.
+  double minimumAt( int index ) const;
+
+  /// Returns the largest sample of the specified size.
+  double maximumAt( int index ) const;
+
+  /// Returns the number of bytes processed by one iteration of a size.
+  long bytesPerIterationAt( int index ) const;
+
+  /// Returns the number of items processed by one iteration of a size.
+  long itemsPerIterationAt( int index ) const;
+
+  /*! \brief Returns the number of bytes processed per second for a size,
+   *         at the median time.
+   * \return Bytes per second, 0 if the benchmark did not set them.
+   */
+  double bytesPerSecondAt( int index ) const;
+
+  /*! \brief Returns the number of items processed per second for a size,
+   *         at the median time.
+   * \return Items per second, 0 if the benchmark did not set them.
+   */
+  double itemsPerSecondAt( int index ) const;
+
+  /*! \brief Fits the timings to the complexity classes.
+   *
+   * Needs at least three sizes. Called by BenchmarkRunner::run().
+   */
+  void fitComplexity();
+
+  /// Tests if fitComplexity() found a complexity class.
+  bool hasComplexity() const;
+
+  /// Returns the best fitting complexity class.
+  BenchmarkComplexity complexity() const;
+
+  /// Returns the coefficient of the best fitting complexity class, in seconds.
+  double coefficient() const;
+
+  /*! \brief Returns the root mean square error of the best fit, relative to
+   *         the mean median time.
+   */
+  double rms() const;
+
+  /// Returns a one line summary of the fit ("O(n log n), 2.1e-09 * n log n").
+  std::string complexitySummary() const;
+
+  /// Returns the name of a complexity class ("O(n log n)").
+  static std::string complexityName( BenchmarkComplexity complexity );
+
+  /// Returns f(n) for a complexity class. Logarithms are in base 2.
+  static double complexityFunction( BenchmarkComplexity complexity,
+                                    double size );
+
+  /*! \brief Returns a rate with a decimal prefix ("1.25 GB/s").
+   * \param perSecond Rate, in units per second.
+   * \param unit Unit of the rate ("B", "items").
+   */
+  static std::string rateToString( double perSecond,
+                                   const std::string &unit );
+
+  /*! \brief Adds a measurement run on several threads.
+   * \param threadCount Number of threads that ran the benchmark.
+   * \param iterationCount Number of iterations run by each thread.
+   * \param threadSeconds Measured time of each thread.
+   * \param bytesPerIteration Number of bytes processed by one iteration.
+   * \param itemsPerIteration Number of items processed by one iteration.
+   */
+  void addThreadSample( int threadCount,
+                        long iterationCount,
+                        const CppUnitVector<double> &threadSeconds,
+                        long bytesPerIteration = 0,
+                        long itemsPerIteration = 0 );
+
+  /// Returns the number of benchmarked thread counts.
+  int threadPointCount() const;
+
+  /// Returns the thread count of the specified point.
+  int threadCountAt( int index ) const;
+
+  /// Returns the number of iterations run by each thread for a point.
+  long threadIterationCountAt( int index ) const;
+
+  /*! \brief Returns the median aggregate throughput of a point, in 
+   *         iterations per second.
+   *
+   * The aggregate throughput of a sample is the number of iterations run by
+   * all the threads divided by the time of the slowest thread.
+   */
+  double throughputAt( int index ) const;
+
+  /*! \brief Returns the median relative standard deviation of the throughput
+   *         of the threads of a point.
+   *
+   * 0 if all the threads progressed at the same rate.
+   */
+  double threadDeviationAt( int index ) const;
+
+  /*! \brief Returns the scaling efficiency of a point.
+   *
+   * Throughput per thread relative to the throughput per thread of the first
+   * point: 1 for a perfect linear scaling.
+   */
+  double efficiencyAt( int index ) const;
+
+  /// Returns the aggregate number of bytes processed per second for a point.
+  double threadBytesPerSecondAt( int index ) const;
+
+  /// Returns the aggregate number of items processed per second for a point.
+  double threadItemsPerSecondAt( int index ) const;
+
+  /// Sets the environment the benchmark was run in.
+  void setEnvironment( const BenchmarkEnvironment &environment );
+
+  const BenchmarkEnvironment &environment() const;
+
+private:
+  struct Series
+  {
+    Series()
+        : m_size( 0 )
+        , m_iterationCount( 0 )
+        , m_bytesPerIteration( 0 )
+        , m_itemsPerIteration( 0 )
+    {
+    }
+
+    long m_size;
+    long m_iterationCount;
+    long m_bytesPerIteration;
+    long m_itemsPerIteration;
+    CppUnitVector<double> m_samples;
+  };
+
+  struct ThreadSeries
+  {
+    ThreadSeries()
+        : m_threadCount( 0 )
+        , m_iterationCount( 0 )
+        , m_bytesPerIteration( 0 )
+        , m_itemsPerIteration( 0 )
+    {
+    }
+
+    int m_threadCount;
+    long m_iterationCount;
+    long m_bytesPerIteration;
+    long m_itemsPerIteration;
+    CppUnitVector<double> m_throughputs;
+    CppUnitVector<double> m_deviations;
+  };
+
+  CppUnitVector<Series> m_series;
+  CppUnitVector<ThreadSeries> m_threadSeries;
+  BenchmarkEnvironment m_environment;
+  bool m_hasComplexity;
+  BenchmarkComplexity m_complexity;
+  double m_coefficient;
+  double m_rms;
+};
+
+
+/*! \brief Runs a benchmark over a range of sizes.
+ * \ingroup WritingTestFixture
+ *
+ * The sizes go from the first size to the last one, multiplied by the range
+ * multiplier at each step (the last size is always included). For each size,
+ * the number of iterations is first increased until a measurement lasts the
+ * minimum time (these measurements also warm up the caches), then the
+ * samples are taken with that number of iterations.
+ *
+ * By default, the caches stay warm: an iteration finds in the caches the
+ * data of the previous one. With setCacheState( cacheCold ), the caches are
+ * evicted before each iteration, outside of the timing, to measure the cost
+ * of the first access to the data. The evictions are then included in the
+ * time used to calibrate the number of iterations, so that they do not make
+ * the measurements last too long.
+ *
+ * The benchmark threads are pinned and their priority raised as specified
+ * by the BenchmarkControls. The environment of the host is detected before
+ * each run and recorded in the result.
+ *
+ * \code
+ * CppUnit::BenchmarkRunner runner( 1 << 10, 1 << 24 );
+ * CppUnit::BenchmarkResult result = runner.run( benchmark );
+ * CPPUNIT_ASSERT_COMPLEXITY( result, CppUnit::complexityLinearithmic );
+ * \endcode
+ */
+class CPPUNIT_API BenchmarkRunner
+{
+public:
+  /*! Constructs a BenchmarkRunner object.
+   * \param firstSize First benchmarked size.
+   * \param lastSize Last benchmarked size. If not greater than \a firstSize,
+   *                 only \a firstSize is benchmarked.
+   */
+  BenchmarkRunner( long firstSize = 0,
+                   long lastSize = 0 );
+
+  /// Destructor.
+  virtual ~BenchmarkRunner();
+
+  void setRange( long firstSize,
+                 long lastSize );
+
+  /// Sets the factor between two successive sizes (8 by default).
+  void setRangeMultiplier( int multiplier );
+
+  int rangeMultiplier() const;
+
+  /// Sets the minimum duration of a sample, in seconds (0.01 by default).
+  void setMinimumTime( double seconds );
+
+  double minimumTime() const;
+
+  /// Sets the number of samples taken for each size (5 by default).
+  void setSampleCount( int sampleCount );
+
+  int sampleCount() const;
+
+  /*! \brief Sets the controls applied to the benchmark threads.
+   *
+   * BenchmarkControls::getControls() by default. The controls must outlive
+   * the runner.
+   */
+  void setControls( const BenchmarkControls &controls );
+
+  const BenchmarkControls &controls() const;
+
+  /*! \brief Sets the state of the caches at the start of each iteration.
+   * \param cacheState \c cacheWarm (the default) or \c cacheCold.
+   * \param evictionByteCount Size of the buffer read to evict the caches,
+   *                          0 for the default size of
+   *                          BenchmarkCacheEvictor.
+   */
+  void setCacheState( BenchmarkCacheState cacheState,
+                      long evictionByteCount = 0 );
+
+  BenchmarkCacheState cacheState() const;
+
+  /// Returns the benchmarked sizes.
+  CppUnitVector<long> sizes() const;
+
+  /*! \brief Runs the benchmark for each size.
+   * \return Samples of each size, with their fitted complexity.
+   * \exception Exception if the benchmark did not run its loop until
+   *            keepRunning() returned \c false.
+   */
+  BenchmarkResult run( BenchmarkFunction &benchmark ) const;
+
+  /*! \brief Runs the benchmark on an increasing number of threads.
+   *
+   * The benchmark is run with the first size on 1, 2, 4... threads, up to
+   * \a maximumThreadCount. The number of iterations of each thread is the
+   * one calibrated on a single thread.
+   * \return Scaling curve of the benchmark.
+   * \exception Exception if the benchmark did not run its loop until
+   *            keepRunning() returned \c false.
+   */
+  BenchmarkResult runThreads( BenchmarkFunction &benchmark,
+                              int maximumThreadCount ) const;
+
+  /*! \brief Runs benchmarks to compare, with interleaved samples.
+   *
+   * Each size is calibrated for each benchmark. The samples are then taken
+   * in rounds: each round takes one sample of every benchmark, starting with
+   * a different benchmark at each round, so that a drift of the host (a
+   * frequency change, another process) affects all of them alike.
+   * \return Result of each benchmark, in the order of \a benchmarks.
+   * \exception Exception if a benchmark did not run its loop until
+   *            keepRunning() returned \c false.
+   */
+  CppUnitVector<BenchmarkResult> runInterleaved( 
+      const CppUnitVector<BenchmarkFunction *> &benchmarks ) const;
+
+  /// Returns the thread counts benchmarked by runThreads().
+  static CppUnitVector<int> threadCounts( int maximumThreadCount );
+
+private:
+  /// Returns the environment of the host and the controls applied by \a control.
+  BenchmarkEnvironment detectEnvironment( 
+      const BenchmarkThreadControl &control ) const;
+
+  /// Returns the number of iterations of a sample that lasts long enough.
+  long calibrate( BenchmarkFunction &benchmark,
+                  long size ) const;
+
+  /// Runs one measurement of \a iterationCount iterations and adds it to \a result.
+  void sample( BenchmarkFunction &benchmark,
+               long size,
+               long iterationCount,
+               BenchmarkResult &result ) const;
+
+  /// Runs the benchmark with \a state, returns the measured time.
+  double measure( BenchmarkFunction &benchmark,
+                  BenchmarkState &state ) const;
+
+  /*! \brief Runs one measurement on \a threadCount threads and adds it to
+   *         \a result.
+   * \return \c false if a thread could not be pinned to its processor.
+   */
+  bool measureThreads( BenchmarkFunction &benchmark,
+                       long size,
+                       long iterationCount,
+                       int threadCount,
+                       BenchmarkResult &result ) const;
+
+  /// Prevents the use of the copy constructor.
+  BenchmarkRunner( const BenchmarkRunner &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const BenchmarkRunner &other );
+
+private:
+  long m_firstSize;
+  long m_lastSize;
+  int m_rangeMultiplier;
+  double m_minimumTime;
+  int m_sampleCount;
+  const BenchmarkControls *m_controls;
+  BenchmarkCacheEvictor *m_cacheEvictor;
+};
+
+
+/*! \brief (Implementation) Asserts that a benchmark has at most the
+ *         specified complexity.
+ * \ingroup Assertions
+ * \sa CPPUNIT_ASSERT_COMPLEXITY.
+ */
+void CPPUNIT_API assertComplexity( const BenchmarkResult &result,
+                                   BenchmarkComplexity maximumComplexity,
+                                   SourceLine sourceLine,
+                                   const std::string &message = "" );
+
+
+/*! \brief Asserts that the fitted complexity of a benchmark is at most the
+ *         specified complexity class.
+ * \ingroup Assertions
+ *
+ * The failure reports the fitted class, its coefficient and the median time
+ * of each size.
+ * \code
+ * CPPUNIT_ASSERT_COMPLEXITY( result, CppUnit::complexityLinearithmic );
+ * \endcode
+ */
+#define CPPUNIT_ASSERT_COMPLEXITY( result, maximumComplexity )     \
+  ( CPPUNIT_NS::assertComplexity( (result),                       \
+                                  (maximumComplexity),            \
+                                  CPPUNIT_SOURCELINE() ) )
+
+
+CPPUNIT_NS_END
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_EXTENSIONS_BENCHMARK_H
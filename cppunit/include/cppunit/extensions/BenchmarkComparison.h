@@ -0,0 +1,145 @@
+#ifndef CPPUNIT_EXTENSIONS_BENCHMARKCOMPARISON_H
+#define CPPUNIT_EXTENSIONS_BENCHMARKCOMPARISON_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/extensions/BenchmarkResultFile.h>
+#include <cppunit/portability/CppUnitVector.h>
+#include <cppunit/portability/Stream.h>
+#include <string>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief Classification of a benchmark compared to its baseline.
+ * \ingroup WritingTestResult
+ */
+enum BenchmarkChange
+{
+  changeUnchanged = 0,  ///< No significant difference.
+  changeImproved,       ///< Significantly faster than the baseline.
+  changeRegressed,      ///< Significantly slower than the baseline.
+  changeNotCompared     ///< Only in one of the files, or not enough samples.
+};
+
+
+/*! \brief Compares the benchmarks of two result files.
+ * \ingroup WritingTestResult
+ *
+ * Each size of each benchmark found in both files is compared. The samples
+ * of the baseline and of the contender are compared with a two-sided
+ * Mann-Whitney U test, which does not assume that the timings are normally
+ * distributed. A size is improved or regressed if the difference is
+ * significant and if its median time changed by at least the minimum change;
+ * it is unchanged otherwise.
+ *
+ * \code
+ * CppUnit::BenchmarkResultFile baseline;
+ * baseline.load( "baseline.json" );
+ * CppUnit::BenchmarkResultFile contender;
+ * contender.load( "contender.json" );
+ * CppUnit::BenchmarkComparison comparison;
+ * comparison.compare( baseline, contender );
+ * comparison.write( CppUnit::stdCOut() );
+ * return comparison.hasRegression() ? 1 : 0;
+ * \endcode
+ */
+class CPPUNIT_API BenchmarkComparison
+{
+public:
+  /*! Constructs a BenchmarkComparison object.
+   * \param significanceLevel Largest p-value of a significant difference.
+   * \param minimumChange Smallest relative change of the median time that is
+   *                      reported (0.05 for 5%).
+   */
+  BenchmarkComparison( double significanceLevel = 0.05,
+                       double minimumChange = 0.05 );
+
+  /// Destructor.
+  virtual ~BenchmarkComparison();
+
+  /*! \brief Compares two result files, replacing the previous comparison.
+   *
+   * There is one row for each size of each benchmark of both files, in the
+   * order of the baseline then of the benchmarks only in the contender.
+   */
+  void compare( const BenchmarkResultFile &baseline,
+                const BenchmarkResultFile &contender );
+
+  int rowCount() const;
+
+  std::string nameAt( int index ) const;
+
+  long sizeAt( int index ) const;
+
+  /// Returns the median time of the baseline, in seconds per iteration.
+  double baselineMedianAt( int index ) const;
+
+  /// Returns the median time of the contender, in seconds per iteration.
+  double contenderMedianAt( int index ) const;
+
+  /// Returns the relative change of the median time (0.1 if 10% slower).
+  double relativeChangeAt( int index ) const;
+
+  /// Returns the p-value of the Mann-Whitney U test.
+  double pValueAt( int index ) const;
+
+  BenchmarkChange changeAt( int index ) const;
+
+  /// Returns the number of rows with the specified change.
+  int count( BenchmarkChange change ) const;
+
+  /// Tests if a benchmark regressed.
+  bool hasRegression() const;
+
+  /// Writes one line per row and a summary.
+  void write( OStream &stream ) const;
+
+  /// Returns the name of a change ("regressed").
+  static std::string changeName( BenchmarkChange change );
+
+  /*! \brief Returns the two-sided p-value of the Mann-Whitney U test.
+   *
+   * The exact distribution of U is used for small samples without ties, the
+   * normal approximation (with tie and continuity corrections) otherwise.
+   * \return Probability of a difference at least as large if both samples
+   *         come from the same distribution, 1 if a sample is empty.
+   */
+  static double mannWhitneyPValue( const CppUnitVector<double> &first,
+                                   const CppUnitVector<double> &second );
+
+private:
+  struct Row
+  {
+    std::string m_name;
+    long m_size;
+    double m_baselineMedian;
+    double m_contenderMedian;
+    double m_pValue;
+    BenchmarkChange m_change;
+  };
+
+  void addRow( const std::string &name,
+               long size,
+               const CppUnitVector<double> &baselineSamples,
+               const CppUnitVector<double> &contenderSamples );
+
+  CppUnitVector<Row> m_rows;
+  double m_significanceLevel;
+  double m_minimumChange;
+};
+
+
+CPPUNIT_NS_END
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_EXTENSIONS_BENCHMARKCOMPARISON_H
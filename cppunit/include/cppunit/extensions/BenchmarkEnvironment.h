@@ -0,0 +1,208 @@
+#ifndef CPPUNIT_EXTENSIONS_BENCHMARKENVIRONMENT_H
+#define CPPUNIT_EXTENSIONS_BENCHMARKENVIRONMENT_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/portability/CppUnitVector.h>
+#include <string>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief Facts about the host a benchmark was run on.
+ * \ingroup WritingTestFixture
+ *
+ * Benchmark results are only comparable if they were measured in the same
+ * conditions. detect() records the facts that most affect the timings:
+ * - \c processors: number of online processors,
+ * - \c processorModel: model name of the processors,
+ * - \c governor: CPU frequency governor of the first processor,
+ * - \c turbo: \c on or \c off,
+ * - \c loadAverage: load average over the last minute.
+ *
+ * The BenchmarkRunner adds the controls it applied (\c cpus, \c priority).
+ * Facts that cannot be detected on the host are not recorded.
+ *
+ * checkFacts() adds a warning for each fact that makes the timings noisy.
+ */
+class CPPUNIT_API BenchmarkEnvironment
+{
+public:
+  /// Constructs an environment without facts.
+  BenchmarkEnvironment();
+
+  /// Destructor.
+  virtual ~BenchmarkEnvironment();
+
+  /// Returns the facts of the host, with their warnings.
+  static BenchmarkEnvironment detect();
+
+  /// Sets the value of a fact, replacing any previous value.
+  void setFact( const std::string &name,
+                const std::string &value );
+
+  /// Returns the value of a fact, an empty string if it is not recorded.
+  std::string fact( const std::string &name ) const;
+
+  int factCount() const;
+
+  std::string factNameAt( int index ) const;
+
+  std::string factValueAt( int index ) const;
+
+  void addWarning( const std::string &warning );
+
+  int warningCount() const;
+
+  std::string warningAt( int index ) const;
+
+  /*! \brief Adds the warnings implied by the facts.
+   *
+   * Warns if the governor is not \c performance, if turbo is \c on and if
+   * the load average is greater than 1 (other processes are running).
+   */
+  void checkFacts();
+
+  /*! \brief Returns the first line of a file, without its end of line.
+   *
+   * Used to read the files of /proc and /sys.
+   * \return First line of the file, an empty string if it cannot be read.
+   */
+  static std::string readFirstLine( const std::string &fileName );
+
+private:
+  CppUnitVector<std::string> m_factNames;
+  CppUnitVector<std::string> m_factValues;
+  CppUnitVector<std::string> m_warnings;
+};
+
+
+/*! \brief Noise reduction controls applied to the benchmark threads.
+ * \ingroup WritingTestFixture
+ *
+ * By default, the BenchmarkRunner uses the controls returned by
+ * getControls(), which DllPlugInTester sets from its command line.
+ *
+ * \code
+ * CppUnitVector<int> cpus;
+ * CppUnit::BenchmarkControls::parseCpuList( "2-3", cpus );
+ * CppUnit::BenchmarkControls::getControls().setCpus( cpus );
+ * CppUnit::BenchmarkControls::getControls().setRaisePriority( true );
+ * \endcode
+ */
+class CPPUNIT_API BenchmarkControls
+{
+public:
+  /// Constructs controls that do not change the benchmark threads.
+  BenchmarkControls();
+
+  /// Destructor.
+  virtual ~BenchmarkControls();
+
+  /// Returns the controls used by default.
+  static BenchmarkControls &getControls();
+
+  /*! \brief Sets the processors the benchmark threads are pinned to.
+   *
+   * Thread \c i is pinned to the processor <tt>cpus[i % cpus.size()]</tt>.
+   * Empty by default: the threads are not pinned.
+   */
+  void setCpus( const CppUnitVector<int> &cpus );
+
+  const CppUnitVector<int> &cpus() const;
+
+  /// Tests if the benchmark threads are pinned.
+  bool pinsThreads() const;
+
+  /*! \brief Sets if the scheduling priority of the benchmark threads is
+   *         raised.
+   *
+   * Usually needs privileges (CAP_SYS_NICE on Linux). If the priority can
+   * not be raised, the benchmark runs with its current priority and a
+   * warning is recorded in its environment.
+   */
+  void setRaisePriority( bool raisePriority );
+
+  bool raisesPriority() const;
+
+  /*! \brief Parses a list of processors such as "0-3,6".
+   * \param text List of processor indexes and ranges separated by commas.
+   * \param cpus Receives the processor indexes.
+   * \return \c true if \a text is a valid list, \c false otherwise.
+   */
+  static bool parseCpuList( const std::string &text,
+                            CppUnitVector<int> &cpus );
+
+  /// Returns a list of processors as a comma separated list.
+  static std::string cpuListToString( const CppUnitVector<int> &cpus );
+
+private:
+  CppUnitVector<int> m_cpus;
+  bool m_raisePriority;
+};
+
+
+/*! \brief Applies BenchmarkControls to the calling thread while it exists.
+ * \ingroup WritingTestFixture
+ *
+ * The previous processor affinity and priority of the thread are restored
+ * on destruction. Pinning uses sched_setaffinity() and the priority
+ * setpriority(), which apply to the calling thread on Linux. They do
+ * nothing if not available.
+ */
+class CPPUNIT_API BenchmarkThreadControl
+{
+public:
+  /*! Applies the controls to the calling thread.
+   * \param controls Controls to apply.
+   * \param threadIndex Index of the thread, selects its processor.
+   */
+  BenchmarkThreadControl( const BenchmarkControls &controls,
+                          int threadIndex = 0 );
+
+  /// Restores the previous affinity and priority.
+  virtual ~BenchmarkThreadControl();
+
+  /// Returns the processor the thread is pinned to, -1 if not pinned.
+  int cpu() const;
+
+  /// Tests if the priority was raised.
+  bool isPriorityRaised() const;
+
+  /*! \brief Records the applied controls in an environment.
+   *
+   * Sets the \c priority fact and adds a warning for each control that
+   * could not be applied.
+   */
+  void addFacts( BenchmarkEnvironment &environment ) const;
+
+private:
+  /// Prevents the use of the copy constructor.
+  BenchmarkThreadControl( const BenchmarkThreadControl &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const BenchmarkThreadControl &other );
+
+private:
+  const BenchmarkControls &m_controls;
+  int m_cpu;
+  int m_requestedCpu;
+  void *m_previousAffinity;
+  bool m_priorityRaised;
+  int m_previousPriority;
+};
+
+
+CPPUNIT_NS_END
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_EXTENSIONS_BENCHMARKENVIRONMENT_H
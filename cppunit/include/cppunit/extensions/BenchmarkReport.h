@@ -0,0 +1,137 @@
+#ifndef CPPUNIT_EXTENSIONS_BENCHMARKREPORT_H
+#define CPPUNIT_EXTENSIONS_BENCHMARKREPORT_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/XmlOutputterHook.h>
+#include <cppunit/extensions/Benchmark.h>
+#include <cppunit/portability/CppUnitMap.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+class Test;
+
+
+/*! \brief Results of the benchmark tests.
+ * \ingroup WritingTestFixture
+ *
+ * Benchmark tests (see CPPUNIT_BENCHMARK) store their results in the report
+ * shared by all the tests. BenchmarkXmlOutputterHook adds them to the XML
+ * output.
+ */
+class CPPUNIT_API BenchmarkReport
+{
+public:
+  /// Constructs an empty report.
+  BenchmarkReport();
+
+  /// Destructor.
+  virtual ~BenchmarkReport();
+
+  /// Returns the report shared by all the tests.
+  static BenchmarkReport &getReport();
+
+  /// Stores the result of the specified test.
+  void setResult( Test *test,
+                  const BenchmarkResult &result );
+
+  /// Removes the result of the specified test.
+  void removeResult( Test *test );
+
+  /*! \brief Returns the result of the specified test.
+   * \return Benchmark result, \c NULL if \a test did not store any.
+   */
+  const BenchmarkResult *findResult( Test *test ) const;
+
+  /// Returns the tests that stored a result.
+  CppUnitVector<Test *> tests() const;
+
+private:
+  /// Prevents the use of the copy constructor.
+  BenchmarkReport( const BenchmarkReport &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const BenchmarkReport &other );
+
+private:
+  typedef CppUnitMap<Test *, BenchmarkResult, std::less<Test *> > Results;
+  Results m_results;
+};
+
+
+/*! \brief Adds the timings of the benchmark tests to the XML output.
+ * \ingroup WritingTestResult
+ *
+ * A \<Benchmark\> element is added to the element of each test that stored a
+ * result. The complexity attributes are only written if it was fitted.
+ * Times are in seconds per iteration:
+ * \code
+ * <Benchmark complexity="O(n log n)" coefficient="2.1e-09" rms="0.031">
+ *   <Size value="1024" iterations="4096" min="2.1e-05" median="2.2e-05" max="2.6e-05"/>
+ *   ...
+ * </Benchmark>
+ * \endcode
+ * The \c bytesPerSecond and \c itemsPerSecond attributes are added to the
+ * \<Size\> and \<Threads\> elements if the benchmark set the amount of
+ * data processed by an iteration.
+ *
+ * A benchmark run on several threads has one element for each thread count.
+ * Throughputs are in iterations per second:
+ * \code
+ * <Benchmark>
+ *   <Threads count="4" iterations="100000" throughput="3.1e+07" deviation="0.02" efficiency="0.94"/>
+ *   ...
+ * </Benchmark>
+ * \endcode
+ * The environment of the benchmark ends the element:
+ * \code
+ * <Environment>
+ *   <Fact name="governor">powersave</Fact>
+ *   ...
+ *   <Warning>CPU frequency governor is &lt;powersave&gt;...</Warning>
+ * </Environment>
+ * \endcode
+ */
+class CPPUNIT_API BenchmarkXmlOutputterHook : public XmlOutputterHook
+{
+public:
+  /*! Constructs a BenchmarkXmlOutputterHook object.
+   * \param report Report that contains the benchmark results.
+   */
+  BenchmarkXmlOutputterHook( const BenchmarkReport &report =
+                                 BenchmarkReport::getReport() );
+
+  virtual ~BenchmarkXmlOutputterHook();
+
+  void failTestAdded( XmlDocument *document,
+                      XmlElement *testElement,
+                      Test *test,
+                      TestFailure *failure );
+
+  void successfulTestAdded( XmlDocument *document,
+                            XmlElement *testElement,
+                            Test *test );
+
+private:
+  void addResult( XmlElement *testElement,
+                  Test *test );
+
+private:
+  const BenchmarkReport &m_report;
+};
+
+
+CPPUNIT_NS_END
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_EXTENSIONS_BENCHMARKREPORT_H
@@ -0,0 +1,116 @@
+#ifndef CPPUNIT_EXTENSIONS_BENCHMARKRESULTFILE_H
+#define CPPUNIT_EXTENSIONS_BENCHMARKRESULTFILE_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/extensions/Benchmark.h>
+#include <cppunit/portability/CppUnitVector.h>
+#include <cppunit/portability/Stream.h>
+#include <string>
+
+
+CPPUNIT_NS_BEGIN
+
+
+class BenchmarkReport;
+
+
+/*! \brief Named benchmark results saved to and loaded from a JSON file.
+ * \ingroup WritingTestResult
+ *
+ * The file keeps the samples of each benchmarked size, so that two runs can
+ * be compared statistically (see BenchmarkComparison), the environment of
+ * each benchmark and the revision of the benchmarked sources:
+ * \code
+ * {"format":"cppunit-benchmark","version":1,"revision":"8f3c2a1...",
+ *  "benchmarks":[{"name":"SortTest::benchmarkSort",
+ *    "environment":{"facts":{"processors":"8",...},"warnings":[...]},
+ *    "sizes":[{"size":1024,"iterations":4096,"bytesPerIteration":0,
+ *              "itemsPerIteration":1024,"samples":[2.1e-05,...]},...]},...]}
+ * \endcode
+ * Samples are in seconds per iteration. The scaling curves of
+ * BenchmarkRunner::runThreads() are not saved.
+ */
+class CPPUNIT_API BenchmarkResultFile
+{
+public:
+  /// Constructs an empty file, without revision.
+  BenchmarkResultFile();
+
+  /// Destructor.
+  virtual ~BenchmarkResultFile();
+
+  /*! \brief Adds the result of a benchmark.
+   * \param name Name of the benchmark, usually the name of its test.
+   * \param result Result to add. Replaces the result of the same name.
+   */
+  void addResult( const std::string &name,
+                  const BenchmarkResult &result );
+
+  /// Adds the results of all the tests of a report, named after the tests.
+  void addReport( const BenchmarkReport &report );
+
+  int resultCount() const;
+
+  std::string nameAt( int index ) const;
+
+  const BenchmarkResult &resultAt( int index ) const;
+
+  /*! \brief Returns the result of the specified benchmark.
+   * \return Benchmark result, \c NULL if there is none with this name.
+   */
+  const BenchmarkResult *findResult( const std::string &name ) const;
+
+  /// Sets the revision of the benchmarked sources.
+  void setRevision( const std::string &revision );
+
+  /// Returns the revision, an empty string if it is not known.
+  std::string revision() const;
+
+  /*! \brief Returns the git revision of the current directory.
+   *
+   * The CPPUNIT_BENCHMARK_REVISION environment variable is used if set.
+   * Otherwise the commit checked out in the .git directory of the current
+   * directory (or of one of its parents) is returned.
+   * \return Revision, an empty string if it is not found.
+   */
+  static std::string detectRevision();
+
+  /// Writes the results as JSON.
+  void write( OStream &stream ) const;
+
+  /*! \brief Reads results written by write(), replacing the current ones.
+   * \exception std::runtime_error if \a text is not a valid result file.
+   */
+  void read( const std::string &text );
+
+  /*! \brief Writes the results to a file.
+   * \exception std::runtime_error if the file can not be written.
+   */
+  void save( const std::string &fileName ) const;
+
+  /*! \brief Reads the results from a file, replacing the current ones.
+   * \exception std::runtime_error if the file can not be read or is not a
+   *            valid result file.
+   */
+  void load( const std::string &fileName );
+
+private:
+  CppUnitVector<std::string> m_names;
+  CppUnitVector<BenchmarkResult> m_results;
+  std::string m_revision;
+};
+
+
+CPPUNIT_NS_END
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_EXTENSIONS_BENCHMARKRESULTFILE_H
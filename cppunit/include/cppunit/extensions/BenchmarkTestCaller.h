@@ -0,0 +1,114 @@
+#ifndef CPPUNIT_EXTENSIONS_BENCHMARKTESTCALLER_H
+#define CPPUNIT_EXTENSIONS_BENCHMARKTESTCALLER_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/Benchmark.h>
+#include <cppunit/extensions/BenchmarkReport.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief Test case that runs a benchmark method of a fixture.
+ * \ingroup WritingTestFixture
+ *
+ * The method is run by a BenchmarkRunner over the range of sizes given on
+ * construction. The result is stored in the BenchmarkReport for this test.
+ * If a maximum complexity is given, the test fails if the fitted complexity
+ * is worse. If a maximum thread count is given, the method is instead run
+ * with the first size on an increasing number of threads.
+ *
+ * Usually created by CPPUNIT_BENCHMARK, CPPUNIT_BENCHMARK_RANGE,
+ * CPPUNIT_BENCHMARK_COMPLEXITY, CPPUNIT_BENCHMARK_THREADS or
+ * CPPUNIT_BENCHMARK_COLD.
+ */
+template <class Fixture>
+class BenchmarkTestCaller : public TestCase
+{
+  typedef void (Fixture::*BenchmarkTestMethod)( BenchmarkState &state );
+
+public:
+  /*! Constructs a BenchmarkTestCaller. The fixture is owned by the caller.
+   * \param name Name of the test.
+   * \param test Method run by the BenchmarkRunner.
+   * \param fixture Fixture to invoke the test method on.
+   * \param firstSize First benchmarked size.
+   * \param lastSize Last benchmarked size.
+   * \param maximumComplexity Worst accepted complexity, complexityAny to
+   *                          only report the fitted complexity.
+   * \param maximumThreadCount Largest number of threads the method is run
+   *                           on, 0 to run it on a single thread.
+   * \param cacheState State of the caches at the start of each iteration.
+   */
+  BenchmarkTestCaller( std::string name,
+                       BenchmarkTestMethod test,
+                       Fixture *fixture,
+                       long firstSize,
+                       long lastSize,
+                       BenchmarkComplexity maximumComplexity = complexityAny,
+                       int maximumThreadCount = 0,
+                       BenchmarkCacheState cacheState = cacheWarm )
+      : TestCase( name )
+      , m_fixture( fixture )
+      , m_test( test )
+      , m_firstSize( firstSize )
+      , m_lastSize( lastSize )
+      , m_maximumComplexity( maximumComplexity )
+      , m_maximumThreadCount( maximumThreadCount )
+      , m_cacheState( cacheState )
+  {
+  }
+
+  ~BenchmarkTestCaller()
+  {
+    BenchmarkReport::getReport().removeResult( this );
+    delete m_fixture;
+  }
+
+  void runTest()
+  {
+    BenchmarkRunner runner( m_firstSize, m_lastSize );
+    runner.setCacheState( m_cacheState );
+    BenchmarkMethod<Fixture> benchmark( m_fixture, m_test );
+    BenchmarkResult result = m_maximumThreadCount > 0 
+        ? runner.runThreads( benchmark, m_maximumThreadCount ) 
+        : runner.run( benchmark );
+    BenchmarkReport::getReport().setResult( this, result );
+
+    if ( m_maximumComplexity != complexityAny )
+      assertComplexity( result, m_maximumComplexity, SourceLine() );
+  }
+
+  void setUp()
+  {
+    m_fixture->setUp();
+  }
+
+  void tearDown()
+  {
+    m_fixture->tearDown();
+  }
+
+  std::string toString() const
+  {
+    return "BenchmarkTestCaller " + getName();
+  }
+
+private:
+  BenchmarkTestCaller( const BenchmarkTestCaller &other );
+  BenchmarkTestCaller &operator =( const BenchmarkTestCaller &other );
+
+private:
+  Fixture *m_fixture;
+  BenchmarkTestMethod m_test;
+  long m_firstSize;
+  long m_lastSize;
+  BenchmarkComplexity m_maximumComplexity;
+  int m_maximumThreadCount;
+  BenchmarkCacheState m_cacheState;
+};
+
+
+CPPUNIT_NS_END
+
+#endif  // CPPUNIT_EXTENSIONS_BENCHMARKTESTCALLER_H
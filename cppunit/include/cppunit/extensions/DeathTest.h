@@ -0,0 +1,286 @@
+#ifndef CPPUNIT_EXTENSIONS_DEATHTEST_H
+#define CPPUNIT_EXTENSIONS_DEATHTEST_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/AssertionTrap.h>
+#include <cppunit/SourceLine.h>
+#include <string>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief Runs a statement in a child process and reports how it ended.
+ * \ingroup Assertions
+ *
+ * Used by CPPUNIT_ASSERT_DEATH() and CPPUNIT_ASSERT_EXIT() to check that a
+ * statement aborts, is killed by a signal or exits: spawnChild() forks the
+ * test process, the child runs the statement with its standard error
+ * redirected to a pipe, and wait() collects that output and the status of
+ * the child.
+ *
+ * The child is a copy-on-write copy of the test process, so forking costs a
+ * fraction of a millisecond for a test executable of usual size, whatever
+ * the statement does. Processes sharing the memory of the test
+ * (\c vfork(), \c CLONE_VM) can only call exec() or _exit(), and can not run
+ * the statement. The standard streams are flushed before forking, so that
+ * the child does not write the output buffered by the parent again.
+ *
+ * If the statement returns, throws an exception or fails an assertion, the
+ * child reports it to the parent through a pipe and ends with _exit(): the
+ * rest of the test run is never executed by the child.
+ *
+ * A child that runs longer than timeout() (60 seconds by default) is killed
+ * with SIGKILL, and its outcome is \c timedOut: a statement that hangs fails
+ * the assertion instead of blocking the test run.
+ *
+ * Requires fork(): spawnChild() throws std::runtime_error on platforms
+ * without it.
+ */
+class CPPUNIT_API DeathTest
+{
+public:
+  /// How the child process ended.
+  enum Outcome
+  {
+    running = 0,  ///< wait() was not called.
+    returned,     ///< The statement returned.
+    threw,        ///< The statement threw an exception or failed an assertion.
+    exited,       ///< The process exited with exitCode().
+    signaled,     ///< The process was killed by signalNumber().
+    timedOut      ///< The process ran longer than timeout() and was killed.
+  };
+
+  /// Constructs a DeathTest object.
+  DeathTest();
+
+  /*! \brief Destructor.
+   *
+   * In the child, ends the process: the statement left the block of the
+   * death test (\c return, \c break). In the parent, waits for the child if
+   * wait() was not called.
+   */
+  virtual ~DeathTest();
+
+  /*! \brief Sets the longest time wait() waits for the child.
+   * \param seconds Time after which the child is killed. 0 waits forever.
+   */
+  void setTimeout( double seconds );
+
+  /// Returns the longest time wait() waits for the child.
+  double timeout() const;
+
+  /*! \brief Sets the timeout of the death tests constructed afterward.
+   *
+   * Used by CPPUNIT_ASSERT_DEATH() and CPPUNIT_ASSERT_EXIT(), which construct
+   * their DeathTest. Not thread-safe: set it before running the tests.
+   * \param seconds Timeout, 0 to wait forever. 60 seconds by default.
+   */
+  static void setDefaultTimeout( double seconds );
+
+  /// Returns the timeout of the death tests constructed afterward.
+  static double defaultTimeout();
+
+  /*! \brief Forks the child process that runs the statement.
+   * \return \c true in the child, \c false in the parent.
+   * \exception std::runtime_error if the process can not be forked.
+   */
+  bool spawnChild();
+
+  /*! \brief Returns the trap of the failed assertions of the statement.
+   *
+   * Only used in the child, when CPPUNIT_NO_EXCEPTIONS is defined.
+   */
+  AssertionTrap &childTrap();
+
+  /*! \brief Ends the child, telling the parent how the statement ended.
+   * \param outcome \c returned or \c threw.
+   */
+  void exitChild( Outcome outcome );
+
+  /*! \brief Waits for the child, collecting its standard error and its
+   *         status.
+   *
+   * Kills the child if it has not ended after timeout().
+   */
+  void wait();
+
+  /// Returns how the child ended.
+  Outcome outcome() const;
+
+  /// Returns \c true if the child exited with a non-zero code or was killed.
+  bool died() const;
+
+  /// Returns the exit code of the child, if outcome() is \c exited.
+  int exitCode() const;
+
+  /// Returns the signal that killed the child, if outcome() is \c signaled.
+  int signalNumber() const;
+
+  /// Returns what the child wrote on its standard error.
+  const std::string &errorOutput() const;
+
+  /*! \brief Returns how the child ended, for example "killed by signal 6"
+   *         or "timed out after 60 seconds".
+   */
+  std::string describeOutcome() const;
+
+  /*! \brief Tests if a text matches a regular expression.
+   *
+   * \a pattern is a POSIX extended regular expression, searched in \a text.
+   * It is searched as a plain string on platforms without regex.h. An empty
+   * pattern matches any text.
+   * \exception std::invalid_argument if \a pattern is not a valid regular
+   *            expression.
+   */
+  static bool matches( const std::string &text,
+                       const std::string &pattern );
+
+private:
+  /// Prevents the use of the copy constructor.
+  DeathTest( const DeathTest &copy );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const DeathTest &copy );
+
+private:
+  bool m_isChild;
+  int m_childId;
+  int m_errorDescriptor;
+  int m_outcomeDescriptor;
+  Outcome m_outcome;
+  int m_status;
+  double m_timeout;
+  std::string m_errorOutput;
+  AssertionTrap *m_childTrap;
+};
+
+
+/*! \brief (Implementation) Asserts that the child of a DeathTest died.
+ * \ingroup Assertions
+ * \sa CPPUNIT_ASSERT_DEATH.
+ */
+void CPPUNIT_API assertDeath( DeathTest &deathTest,
+                              const std::string &statement,
+                              const std::string &pattern,
+                              SourceLine sourceLine,
+                              const std::string &message = "" );
+
+/*! \brief (Implementation) Asserts that the child of a DeathTest exited with
+ *         the specified code.
+ * \ingroup Assertions
+ * \sa CPPUNIT_ASSERT_EXIT.
+ */
+void CPPUNIT_API assertExit( DeathTest &deathTest,
+                             const std::string &statement,
+                             int exitCode,
+                             const std::string &pattern,
+                             SourceLine sourceLine,
+                             const std::string &message = "" );
+
+
+#if defined(CPPUNIT_NO_EXCEPTIONS)
+/// \internal Runs the statement in the child of a DeathTest.
+# define CPPUNIT_DEATH_TEST_RUN_( deathTest, statement )                     \
+    if ( (deathTest).spawnChild() )                                          \
+    {                                                                        \
+      if ( setjmp( (deathTest).childTrap().jumpBuffer() ) == 0 )             \
+      {                                                                      \
+        statement;                                                           \
+        (deathTest).exitChild( CPPUNIT_NS::DeathTest::returned );            \
+      }                                                                      \
+      (deathTest).exitChild( CPPUNIT_NS::DeathTest::threw );                 \
+    }
+#else
+/// \internal Runs the statement in the child of a DeathTest.
+# define CPPUNIT_DEATH_TEST_RUN_( deathTest, statement )                     \
+    if ( (deathTest).spawnChild() )                                          \
+    {                                                                        \
+      try                                                                    \
+      {                                                                      \
+        statement;                                                           \
+      }                                                                      \
+      catch ( ... )                                                          \
+      {                                                                      \
+        (deathTest).exitChild( CPPUNIT_NS::DeathTest::threw );               \
+      }                                                                      \
+      (deathTest).exitChild( CPPUNIT_NS::DeathTest::returned );              \
+    }
+#endif
+
+
+/*! \brief Asserts that a statement makes the process die.
+ * \ingroup Assertions
+ *
+ * The statement is run in a forked child process (see DeathTest). The
+ * assertion passes if the child is killed by a signal (abort(), failed
+ * assert(), crash) or exits with a non-zero code, and if its standard error
+ * matches \a pattern, a POSIX extended regular expression. It fails if the
+ * statement returns, throws an exception or fails an assertion.
+ *
+ * \code
+ * CPPUNIT_ASSERT_DEATH( book.cancel( unknownOrderId ),
+ *                       "invariant .* unknown order" );
+ * \endcode
+ */
+#define CPPUNIT_ASSERT_DEATH( statement, pattern )                           \
+  do {                                                                       \
+    CPPUNIT_NS::DeathTest cpputDeathTest_;                                   \
+    CPPUNIT_DEATH_TEST_RUN_( cpputDeathTest_, statement )                    \
+    CPPUNIT_NS::assertDeath( cpputDeathTest_,                                \
+                             #statement,                                     \
+                             (pattern),                                      \
+                             CPPUNIT_SOURCELINE() );                         \
+  } while ( false )
+
+/** Asserts that a statement makes the process die, setting a user message
+ * in case of failure.
+ * \ingroup Assertions
+ * \see CPPUNIT_ASSERT_DEATH
+ */
+#define CPPUNIT_ASSERT_DEATH_MESSAGE( message, statement, pattern )          \
+  do {                                                                       \
+    CPPUNIT_NS::DeathTest cpputDeathTest_;                                   \
+    CPPUNIT_DEATH_TEST_RUN_( cpputDeathTest_, statement )                    \
+    CPPUNIT_NS::assertDeath( cpputDeathTest_,                                \
+                             #statement,                                     \
+                             (pattern),                                      \
+                             CPPUNIT_SOURCELINE(),                           \
+                             (message) );                                    \
+  } while ( false )
+
+/*! \brief Asserts that a statement makes the process exit with a code.
+ * \ingroup Assertions
+ *
+ * Same as CPPUNIT_ASSERT_DEATH(), but the child must end by calling exit()
+ * or _exit() with \a exitCode, which may be 0.
+ *
+ * \code
+ * CPPUNIT_ASSERT_EXIT( parseArguments( 1, badArguments ), 2, "usage:" );
+ * \endcode
+ */
+#define CPPUNIT_ASSERT_EXIT( statement, exitCode, pattern )                  \
+  do {                                                                       \
+    CPPUNIT_NS::DeathTest cpputDeathTest_;                                   \
+    CPPUNIT_DEATH_TEST_RUN_( cpputDeathTest_, statement )                    \
+    CPPUNIT_NS::assertExit( cpputDeathTest_,                                 \
+                            #statement,                                      \
+                            (exitCode),                                      \
+                            (pattern),                                       \
+                            CPPUNIT_SOURCELINE() );                          \
+  } while ( false )
+
+
+CPPUNIT_NS_END
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_EXTENSIONS_DEATHTEST_H
@@ -0,0 +1,313 @@
+#ifndef CPPUNIT_EXTENSIONS_DIFFERENTIALTEST_H
+#define CPPUNIT_EXTENSIONS_DIFFERENTIALTEST_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/Message.h>
+#include <cppunit/SourceLine.h>
+#include <cppunit/extensions/TestValueTraits.h>
+#include <cppunit/portability/CppUnitVector.h>
+#include <cppunit/tools/Random.h>
+#include <exception>
+#include <string>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief (Implementation) Runs the cases of a DifferentialTest.
+ * \ingroup WritingTestFixture
+ *
+ * Cases are run by batches of batchSize() cases. The cases of a batch are
+ * distributed over threadCount() threads. Case \c k of a run seeded with 
+ * \c seed generates its input from a Random seeded with 
+ * Random::mix( seed, k ), so the result of a run does not depend on the 
+ * number of threads.
+ *
+ * The run stops at the end of the first batch that contains a mismatch. The
+ * mismatch of the smallest case index is reported: it is the one that is 
+ * found again when the run is replayed with the same seed.
+ */
+class CPPUNIT_API DifferentialTestBase
+{
+public:
+  /*! Constructs a DifferentialTestBase object.
+   *
+   * The seed defaults to Random::defaultSeed(), the number of threads to
+   * ThreadGroup::processorCount().
+   */
+  DifferentialTestBase();
+
+  /// Destructor.
+  virtual ~DifferentialTestBase();
+
+  /// Sets the number of generated inputs (default is 1000).
+  void setCaseCount( int caseCount );
+
+  int caseCount() const;
+
+  void setThreadCount( int threadCount );
+
+  int threadCount() const;
+
+  /// Sets the number of cases run between two checks for mismatches.
+  void setBatchSize( int batchSize );
+
+  int batchSize() const;
+
+  void setSeed( unsigned int seed );
+
+  unsigned int seed() const;
+
+  /// Sets the tolerance used to compare floating point outputs (default is 0).
+  void setTolerance( double tolerance );
+
+  double tolerance() const;
+
+  /*! \brief Compares the candidates to the reference on all the cases.
+   *
+   * If a candidate output differs from the reference output, the input is
+   * minimized, then the mismatch is reported with the seed that replays it.
+   * \param sourceLine Location reported in the failure.
+   * \exception Exception if a mismatch was found.
+   */
+  void check( const SourceLine &sourceLine = SourceLine() );
+
+  /*! \brief Runs a single case.
+   *
+   * Called concurrently by the threads running a batch.
+   * \param caseSeed Seed of the generator of the case input.
+   * \return Index of the first candidate whose output differs from the 
+   *         reference, -1 if all the candidates match.
+   */
+  virtual int findMismatch( unsigned int caseSeed ) const =0;
+
+protected:
+  /*! \brief Adds the details of a mismatch to \a message.
+   *
+   * Called in the calling thread of check(). The input may be minimized
+   * before being described.
+   */
+  virtual void describeMismatch( unsigned int caseSeed,
+                                 int candidateIndex,
+                                 Message &message ) const =0;
+
+  /// Returns the name of the specified candidate.
+  virtual std::string candidateName( int candidateIndex ) const =0;
+
+private:
+  /// Prevents the use of the copy constructor.
+  DifferentialTestBase( const DifferentialTestBase &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const DifferentialTestBase &other );
+
+private:
+  int m_caseCount;
+  int m_threadCount;
+  int m_batchSize;
+  unsigned int m_seed;
+  double m_tolerance;
+};
+
+
+/*! \brief Checks optimized implementations against a reference implementation.
+ * \ingroup WritingTestFixture
+ *
+ * Inputs are produced by a generator function, then passed to the reference
+ * function and to each candidate. The outputs are compared with 
+ * TestValueTraits<Output>::isEqual(), using tolerance() for floating points.
+ *
+ * When a candidate output differs, the input is minimized: the candidates
+ * provided by TestValueTraits<Input>::shrink() are tried in turn, and the 
+ * first one on which the candidate still differs replaces the input, until 
+ * no candidate fails. The failure reports the minimized input, the expected 
+ * and actual outputs, and the seed to set in the \c CPPUNIT_SEED environment
+ * variable to replay the run.
+ *
+ * A candidate that throws an exception is reported as a mismatch. An 
+ * exception thrown by the generator or the reference function aborts the 
+ * check. All the functions are called concurrently and must be thread-safe.
+ *
+ * \code
+ * std::vector<int> generateValues( CppUnit::Random &random );
+ * long sumReference( const std::vector<int> &values );
+ * long sumUnrolled( const std::vector<int> &values );
+ *
+ * void SumTest::testUnrolledSum()
+ * {
+ *   CppUnit::DifferentialTest<std::vector<int>, long> differential( 
+ *       &generateValues, &sumReference );
+ *   differential.addCandidate( "unrolled", &sumUnrolled );
+ *   CPPUNIT_ASSERT_DIFFERENTIAL( differential );
+ * }
+ * \endcode
+ *
+ * \see DifferentialTestBase, TestValueTraits.
+ */
+template<class Input, class Output>
+class DifferentialTest : public DifferentialTestBase
+{
+public:
+  typedef Input (*Generator)( Random &random );
+  typedef Output (*Function)( const Input &input );
+
+  /*! Constructs a DifferentialTest object.
+   * \param generator Function that generates an input.
+   * \param reference Reference implementation.
+   */
+  DifferentialTest( Generator generator,
+                    Function reference )
+      : m_generator( generator )
+      , m_reference( reference )
+      , m_maximumShrinkSteps( 1000 )
+  {
+  }
+
+  /// Adds an implementation to compare to the reference.
+  void addCandidate( const std::string &name,
+                     Function candidate )
+  {
+    m_names.push_back( name );
+    m_candidates.push_back( candidate );
+  }
+
+  int candidateCount() const
+  {
+    return m_candidates.size();
+  }
+
+  /// Sets the maximum number of successful shrinking steps (default is 1000).
+  void setMaximumShrinkSteps( int maximumShrinkSteps )
+  {
+    m_maximumShrinkSteps = maximumShrinkSteps;
+  }
+
+  int findMismatch( unsigned int caseSeed ) const
+  {
+    Random random( caseSeed );
+    Input input = m_generator( random );
+    Output expected = m_reference( input );
+    for ( int candidateIndex =0; candidateIndex < candidateCount(); ++candidateIndex )
+    {
+      if ( mismatches( input, expected, candidateIndex ) )
+        return candidateIndex;
+    }
+    return -1;
+  }
+
+  /*! \brief Minimizes an input on which a candidate differs from the reference.
+   * \return Minimized input. The candidate still differs on it.
+   */
+  Input minimize( const Input &input,
+                  int candidateIndex ) const
+  {
+    Input minimized( input );
+    for ( int step =0; step < m_maximumShrinkSteps; ++step )
+    {
+      CppUnitVector<Input> candidates;
+      TestValueTraits<Input>::shrink( minimized, candidates );
+
+      bool shrunk = false;
+      for ( unsigned int index =0; index < candidates.size()  &&  !shrunk; ++index )
+      {
+        const Input &candidate = candidates[index];
+        if ( mismatches( candidate, m_reference( candidate ), candidateIndex ) )
+        {
+          minimized = candidate;
+          shrunk = true;
+        }
+      }
+
+      if ( !shrunk )
+        break;
+    }
+    return minimized;
+  }
+
+protected:
+  void describeMismatch( unsigned int caseSeed,
+                         int candidateIndex,
+                         Message &message ) const
+  {
+    Random random( caseSeed );
+    Input input = m_generator( random );
+    Input minimized = minimize( input, candidateIndex );
+
+    message.addDetail( "Input: " + TestValueTraits<Input>::toString( minimized ) );
+    if ( !TestValueTraits<Input>::isEqual( minimized, input, 0 ) )
+      message.addDetail( "Original input: " + 
+                         TestValueTraits<Input>::toString( input ) );
+    message.addDetail( "Expected: " + 
+                       TestValueTraits<Output>::toString( m_reference( minimized ) ) );
+    message.addDetail( "Actual  : " + actualOutput( minimized, candidateIndex ) );
+  }
+
+  std::string candidateName( int candidateIndex ) const
+  {
+    return m_names[ candidateIndex ];
+  }
+
+private:
+  bool mismatches( const Input &input,
+                   const Output &expected,
+                   int candidateIndex ) const
+  {
+    try
+    {
+      Output actual = m_candidates[ candidateIndex ]( input );
+      return !TestValueTraits<Output>::isEqual( expected, actual, tolerance() );
+    }
+    catch ( ... )
+    {
+      return true;
+    }
+  }
+
+  std::string actualOutput( const Input &input,
+                            int candidateIndex ) const
+  {
+    try
+    {
+      return TestValueTraits<Output>::toString( 
+          m_candidates[ candidateIndex ]( input ) );
+    }
+    catch ( std::exception &e )
+    {
+      return std::string( "exception thrown: " ) + e.what();
+    }
+    catch ( ... )
+    {
+      return "unknown exception thrown";
+    }
+  }
+
+private:
+  Generator m_generator;
+  Function m_reference;
+  CppUnitVector<std::string> m_names;
+  CppUnitVector<Function> m_candidates;
+  int m_maximumShrinkSteps;
+};
+
+
+/*! \brief Asserts that the candidates of a DifferentialTest match the reference.
+ * \ingroup Assertions
+ * \see DifferentialTest.
+ */
+#define CPPUNIT_ASSERT_DIFFERENTIAL( differential ) \
+  ( (differential).check( CPPUNIT_SOURCELINE() ) )
+
+
+CPPUNIT_NS_END
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_EXTENSIONS_DIFFERENTIALTEST_H
@@ -0,0 +1,314 @@
+#ifndef CPPUNIT_EXTENSIONS_DISTRIBUTEDRUNNER_H
+#define CPPUNIT_EXTENSIONS_DISTRIBUTEDRUNNER_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/portability/CppUnitDeque.h>
+#include <cppunit/portability/CppUnitVector.h>
+#include <string>
+
+CPPUNIT_NS_BEGIN
+
+
+class DistributedConnection;
+class Exception;
+class Test;
+class TestResult;
+
+
+/*! \brief Starts the workers of a DistributedCoordinator and replaces the
+ *         lost ones.
+ * \ingroup ExecutingTest
+ *
+ * The coordinator calls superviseWorkers() about every 100 milliseconds
+ * while tests are left to run, and workerLost() when it gives up on a
+ * worker. A launcher that starts the workers as local processes can kill
+ * a worker stuck in a test that timed out, and start another one in place
+ * of a worker that crashed.
+ *
+ * \see DistributedCoordinator::setWorkerLauncher().
+ */
+class CPPUNIT_API DistributedWorkerLauncher
+{
+public:
+  virtual ~DistributedWorkerLauncher() {}
+
+  /// Called regularly during the run while tests are left to run.
+  virtual void superviseWorkers() =0;
+
+  /*! \brief Called when the coordinator closed the connection of a worker.
+   * \param processId Identifier of the process of the worker, as sent by
+   *                  the worker, or 0 if it is unknown.
+   */
+  virtual void workerLost( int processId ) =0;
+};
+
+
+/*! \brief Serves the test cases of a test to worker processes over TCP.
+ * \ingroup ExecutingTest
+ *
+ * The coordinator and its workers load the same test plug-ins and flatten
+ * the same test into the same list of test cases. A test whose child tests
+ * can not run separately (see Test::canRunChildTestsSeparately(): TestSetUp,
+ * RepeatedTest...) is kept whole, with its decorators. The coordinator
+ * assigns the tests one at a time to the workers that connect to it
+ * (DistributedWorker), and the workers stream back the test cases they
+ * start and their failures. Once a test is done, its events are replayed in
+ * the TestResult given to run(): a TestResultCollector and the usual
+ * outputters see the whole run as if it was local.
+ *
+ * A worker is lost when its connection closes, or when it runs a test for
+ * longer than the test timeout. Its test is assigned again to another
+ * worker, at most the maximum number of attempts. A test that is still not
+ * done is reported as an error. The events of a test are only replayed once
+ * it is done, so a lost worker leaves no partial result.
+ *
+ * The protocol is text based, one tab separated record per line. It is not
+ * authenticated: only run the coordinator on a trusted network.
+ *
+ * The coordinator does not start the workers. A DistributedWorkerLauncher
+ * (see setWorkerLauncher()) can start them, and replace the lost ones.
+ *
+ * Sockets require POSIX: on other systems, the constructor throws.
+ *
+ * \code
+ * CppUnit::DistributedCoordinator coordinator( 7357 );
+ * coordinator.addTest( CppUnit::TestFactoryRegistry::getRegistry().makeTest() );
+ * coordinator.run( controller );
+ * \endcode
+ */
+class CPPUNIT_API DistributedCoordinator
+{
+public:
+  /*! \brief Listens for workers on the specified port, on all interfaces.
+   * \param port TCP port to listen on. 0 picks a free port (see port()).
+   * \exception std::runtime_error if the port can not be listened on.
+   */
+  DistributedCoordinator( int port );
+
+  /// Destructor. Closes the connections.
+  virtual ~DistributedCoordinator();
+
+  /// Returns the port the coordinator listens on.
+  int port() const;
+
+  /*! \brief Sets the longest time a worker may run a test.
+   * \param seconds Time after which the worker is considered lost. 0 (the
+   *                default) waits forever.
+   */
+  void setTestTimeout( double seconds );
+
+  /*! \brief Sets the number of workers a test is assigned to before it is
+   *         reported as an error (3 by default).
+   */
+  void setMaximumAttempts( int attempts );
+
+  /*! \brief Sets the longest time run() waits while no worker is connected.
+   * \param seconds Time after which the remaining tests are reported as
+   *                errors. 0 (the default) waits forever.
+   */
+  void setWorkerWaitTimeout( double seconds );
+
+  /*! \brief Sets the launcher told about the lost workers during run().
+   * \param launcher Launcher, not owned. \c NULL (the default) for none.
+   */
+  void setWorkerLauncher( DistributedWorkerLauncher *launcher );
+
+  /*! \brief Adds the test cases of the specified test, in enumeration order.
+   *
+   * A test whose child tests can not run separately is added whole. The
+   * workers must add the same test. The test is not owned.
+   */
+  void addTest( Test *test );
+
+  /// Returns the number of tests to assign to the workers.
+  int testCount() const;
+
+  /*! \brief Runs the tests on the workers.
+   *
+   * Returns once every test is done or reported as an error, or once
+   * \a controller is stopped. The workers are then told to quit.
+   * \param controller Result the events of the tests are replayed in, with
+   *                   startTestRun() and endTestRun() around the run.
+   */
+  void run( TestResult &controller );
+
+  /// Returns the number of workers that connected during run().
+  int workerCount() const;
+
+  /// Returns the number of times a test was assigned again after a loss.
+  int reassignedCount() const;
+
+  /*! \brief Closes the sockets without telling the workers.
+   *
+   * Called by a process forked during run(), such as a worker started by
+   * a DistributedWorkerLauncher, so that it does not keep the connections
+   * of the coordinator open.
+   */
+  void releaseSockets();
+
+private:
+  friend class DistributedCoordinatorRun;
+
+  /*! Event received for the test a worker runs: a test case started, or a
+   *  failure if m_exception is not \c NULL.
+   */
+  struct PendingEvent
+  {
+    /// Index of the test case in the test, -1 for the test itself.
+    int m_testCaseIndex;
+    Exception *m_exception;
+    bool m_isError;
+  };
+
+  struct Worker
+  {
+    DistributedConnection *m_connection;
+    bool m_greeted;
+    int m_processId;
+    int m_testIndex;
+    double m_assignTime;
+    CppUnitVector<PendingEvent> m_events;
+  };
+
+  /// Serves the tests. Called within the run of \a controller.
+  void serve( TestResult &controller );
+
+  void acceptWorker();
+
+  /// Handles the records received from a worker. \c false if it is lost.
+  bool readWorker( Worker &worker,
+                   TestResult &controller );
+
+  /// Handles one record. \c false if the worker broke the protocol.
+  bool handleRecord( Worker &worker,
+                     const CppUnitVector<std::string> &fields,
+                     TestResult &controller );
+
+  /// Sends the next test to run to an idle worker.
+  void assignTest( Worker &worker );
+
+  /// Closes the connection of a worker and assigns its test again.
+  void loseWorker( int workerIndex,
+                   TestResult &controller,
+                   const std::string &reason );
+
+  /// Replays the events of a test in \a controller.
+  void reportTest( int testIndex,
+                   CppUnitVector<PendingEvent> &events,
+                   TestResult &controller );
+
+  /// Reports a test that could not be run as an error.
+  void reportError( int testIndex,
+                    const std::string &reason,
+                    TestResult &controller );
+
+  void closeWorkers();
+
+  static void deleteEvents( CppUnitVector<PendingEvent> &events );
+
+  /// Prevents the use of the copy constructor.
+  DistributedCoordinator( const DistributedCoordinator &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const DistributedCoordinator &other );
+
+private:
+  int m_listenSocket;
+  int m_port;
+  double m_testTimeout;
+  int m_maximumAttempts;
+  double m_workerWaitTimeout;
+  DistributedWorkerLauncher *m_launcher;
+  CppUnitVector<Test *> m_tests;
+  CppUnitVector<int> m_attempts;
+  CppUnitDeque<int> m_queue;
+  int m_doneCount;
+  CppUnitVector<Worker> m_workers;
+  int m_workerCount;
+  int m_reassignedCount;
+};
+
+
+/*! \brief Runs the tests assigned by a DistributedCoordinator.
+ * \ingroup ExecutingTest
+ *
+ * The worker adds the same test as the coordinator, connects to it, and
+ * runs the test cases it is assigned until the coordinator tells it to
+ * quit. The failures are sent to the coordinator as they are reported.
+ * Several workers can run on the same machine, in separate processes.
+ *
+ * \code
+ * CppUnit::DistributedWorker worker;
+ * worker.addTest( CppUnit::TestFactoryRegistry::getRegistry().makeTest() );
+ * worker.run( "build-42", 7357, controller );
+ * \endcode
+ */
+class CPPUNIT_API DistributedWorker
+{
+public:
+  DistributedWorker();
+
+  /// Destructor.
+  virtual ~DistributedWorker();
+
+  /*! \brief Adds the test cases of the specified test, in enumeration order.
+   *
+   * A test whose child tests can not run separately is added whole. Must be
+   * the same test as the coordinator's. The test is not owned.
+   */
+  void addTest( Test *test );
+
+  /// Returns the number of test cases the worker can run.
+  int testCount() const;
+
+  /*! \brief Connects to the coordinator and runs the assigned tests.
+   *
+   * The connection is attempted for 10 seconds, so the workers can be
+   * started before the coordinator.
+   * \param host Name or address of the coordinator.
+   * \param port Port the coordinator listens on.
+   * \param controller Result the assigned tests are run with, with
+   *                   startTestRun() and endTestRun() around the run.
+   * \return Number of tests run.
+   * \exception std::runtime_error if the coordinator can not be reached.
+   */
+  int run( const std::string &host,
+           int port,
+           TestResult &controller );
+
+private:
+  friend class DistributedWorkerRun;
+
+  /*! \brief Runs the assigned tests. Called within the run of \a controller.
+   * \param error Set to the reason the run stopped if it is not a request
+   *              of the coordinator.
+   * \return Number of tests run.
+   */
+  int serve( DistributedConnection &connection,
+             TestResult &controller,
+             std::string &error );
+
+  /// Prevents the use of the copy constructor.
+  DistributedWorker( const DistributedWorker &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const DistributedWorker &other );
+
+private:
+  CppUnitVector<Test *> m_tests;
+};
+
+
+CPPUNIT_NS_END
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_EXTENSIONS_DISTRIBUTEDRUNNER_H
@@ -0,0 +1,129 @@
+#ifndef CPPUNIT_EXTENSIONS_FILEASSERT_H
+#define CPPUNIT_EXTENSIONS_FILEASSERT_H
+
+#include <cppunit/Portability.h>
+#include <cppunit/Message.h>
+#include <cppunit/SourceLine.h>
+#include <stddef.h>
+#include <string>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief Compares the content of two files.
+ * \ingroup Assertions
+ *
+ * Both files are read sequentially by chunks of fixed size, directly into the
+ * comparison buffers (the streams are unbuffered), and each pair of chunks is
+ * compared with memcmp(). Memory use does not depend on the size of the files:
+ * only the current and the previous chunks of each file are kept, the
+ * previous one to show the context of a difference.
+ *
+ * compareBytes() fails without reading the files if their sizes differ, and
+ * reports the offset of the first differing byte. compareLines() reads the
+ * files until the first difference and reports it by line, with the preceding
+ * lines as context. Both compare the files byte for byte.
+ *
+ * \see CPPUNIT_ASSERT_FILES_EQUAL, CPPUNIT_ASSERT_FILE_LINES_EQUAL.
+ */
+class CPPUNIT_API FileComparator
+{
+public:
+  enum 
+  {
+    /// Default size of the chunks read from the files, in bytes.
+    defaultChunkSize = 1024 * 1024
+  };
+
+  /*! Constructs a FileComparator object.
+   * \param chunkSize Size of the chunks read from the files, in bytes.
+   */
+  FileComparator( size_t chunkSize = defaultChunkSize );
+
+  /// Destructor.
+  virtual ~FileComparator();
+
+  /*! \brief Compares two files byte for byte.
+   * \param expectedPath Path of the file with the expected content.
+   * \param actualPath Path of the file to check.
+   * \param failure Set to the description of the first difference.
+   * \return \c true if both files have the same content.
+   */
+  bool compareBytes( const std::string &expectedPath,
+                     const std::string &actualPath,
+                     Message &failure ) const;
+
+  /*! \brief Compares two text files, reporting the difference by line.
+   * \param expectedPath Path of the file with the expected content.
+   * \param actualPath Path of the file to check.
+   * \param failure Set to the description of the first differing line.
+   * \return \c true if both files have the same content.
+   */
+  bool compareLines( const std::string &expectedPath,
+                     const std::string &actualPath,
+                     Message &failure ) const;
+
+private:
+  bool compare( const std::string &expectedPath,
+                const std::string &actualPath,
+                bool byLine,
+                Message &failure ) const;
+
+private:
+  size_t m_chunkSize;
+};
+
+
+/*! \brief (Implementation) Asserts that two files have the same content.
+ * \ingroup Assertions
+ * \sa CPPUNIT_ASSERT_FILES_EQUAL.
+ */
+void CPPUNIT_API assertFilesEqual( const std::string &expectedPath,
+                                   const std::string &actualPath,
+                                   SourceLine sourceLine,
+                                   const std::string &message = "" );
+
+/*! \brief (Implementation) Asserts that two text files have the same content.
+ * \ingroup Assertions
+ * \sa CPPUNIT_ASSERT_FILE_LINES_EQUAL.
+ */
+void CPPUNIT_API assertFileLinesEqual( const std::string &expectedPath,
+                                       const std::string &actualPath,
+                                       SourceLine sourceLine,
+                                       const std::string &message = "" );
+
+
+/*! \brief Asserts that two files have the same content.
+ * \ingroup Assertions
+ *
+ * The files are streamed by chunks and may be larger than the memory. If the
+ * sizes differ, the assertion fails without reading the files. Otherwise, the
+ * offset of the first differing byte is reported, with the surrounding bytes.
+ *
+ * \code
+ * CPPUNIT_ASSERT_FILES_EQUAL( "golden/orders.dat", outputPath );
+ * \endcode
+ * \see FileComparator.
+ */
+#define CPPUNIT_ASSERT_FILES_EQUAL( expectedPath, actualPath )     \
+  ( CPPUNIT_NS::assertFilesEqual( (expectedPath),                 \
+                                  (actualPath),                   \
+                                  CPPUNIT_SOURCELINE() ) )
+
+/*! \brief Asserts that two text files have the same content.
+ * \ingroup Assertions
+ *
+ * Same as CPPUNIT_ASSERT_FILES_EQUAL(), but the first difference is reported
+ * by line and column, with the preceding lines, even if the sizes differ.
+ * \see FileComparator.
+ */
+#define CPPUNIT_ASSERT_FILE_LINES_EQUAL( expectedPath, actualPath ) \
+  ( CPPUNIT_NS::assertFileLinesEqual( (expectedPath),             \
+                                      (actualPath),               \
+                                      CPPUNIT_SOURCELINE() ) )
+
+
+CPPUNIT_NS_END
+
+#endif  // CPPUNIT_EXTENSIONS_FILEASSERT_H
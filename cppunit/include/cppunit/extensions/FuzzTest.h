@@ -0,0 +1,242 @@
+#ifndef CPPUNIT_EXTENSIONS_FUZZTEST_H
+#define CPPUNIT_EXTENSIONS_FUZZTEST_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/TestComposite.h>
+#include <cppunit/portability/CppUnitVector.h>
+#include <stddef.h>
+#include <string>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief Code exercised by a FuzzTest.
+ * \ingroup WritingTestFixture
+ *
+ * A target is created for each thread replaying a corpus. setUp() and 
+ * tearDown() are called around each input.
+ */
+class CPPUNIT_API FuzzTarget
+{
+public:
+  virtual ~FuzzTarget() {}
+
+  virtual void setUp() {}
+
+  /*! \brief Runs the target on an input.
+   *
+   * Fails with an assertion, or throws an exception, if the input exposes 
+   * a bug.
+   */
+  virtual void run( const unsigned char *data, 
+                    size_t size ) =0;
+
+  virtual void tearDown() {}
+};
+
+
+/*! \brief Test that replays the inputs of a fuzzing corpus.
+ * \ingroup WritingTestFixture
+ *
+ * Each regular file of the corpus directory (hidden files excepted) is an
+ * input, run as a child test named <tt>name[file]</tt>. When the test is 
+ * run, the files are memory-mapped and replayed concurrently on several 
+ * threads, each having its own FuzzTarget. Each input is reported between
+ * its own TestResult::startTest() and TestResult::endTest(), so the inputs
+ * of different threads are reported interleaved. A corpus directory that
+ * does not exist is an empty corpus.
+ *
+ * The same test is used as an in-process fuzz target in a fuzz build (see
+ * FuzzerMain). Inputs that make the target fail or crash are then saved in
+ * the corpus directory, so that they are replayed by the next test runs.
+ *
+ * Usually created by CPPUNIT_FUZZ_TEST.
+ */
+class CPPUNIT_API FuzzTest : public TestComposite
+{
+public:
+  /*! Constructs a FuzzTest object, and lists the inputs of the corpus.
+   * \param name Name of the test.
+   * \param corpusDirectory Directory containing the inputs to replay.
+   */
+  FuzzTest( const std::string &name,
+            const std::string &corpusDirectory );
+
+  /// Destructor.
+  ~FuzzTest();
+
+  /*! \brief Creates a target to run the inputs on.
+   * \return New target, owned by the caller.
+   */
+  virtual FuzzTarget *makeTarget() const =0;
+
+  std::string corpusDirectory() const;
+
+  /// Sets the number of threads replaying the corpus.
+  void setThreadCount( int threadCount );
+
+  int threadCount() const;
+
+  /*! \brief Lists the inputs of the corpus again.
+   *
+   * The inputs left by fuzz targets that crashed are first saved in the
+   * corpus (see FuzzPendingInput).
+   */
+  void loadCorpus();
+
+  int getChildTestCount() const;
+
+  /// Returns the path of the input of the specified index.
+  std::string getInputPathAt( int index ) const;
+
+  /*! \brief Saves an input in the corpus directory.
+   *
+   * The input is saved in a file named after a hash of its content, created
+   * with the directory if needed.
+   * \return Path of the file.
+   * \exception std::runtime_error if the file could not be written.
+   */
+  std::string saveInput( const unsigned char *data, 
+                         size_t size ) const;
+
+  /*! \brief Returns the default corpus directory of a test.
+   *
+   * The directory is named after the test (<tt>Fixture::method</tt> becomes
+   * <tt>Fixture.method</tt>), in the directory specified by the environment
+   * variable \c CPPUNIT_FUZZ_CORPUS, or in \c corpus if it is not set.
+   */
+  static std::string defaultCorpusDirectory( const std::string &testName );
+
+  /*! \brief Returns the fuzz tests that currently exist.
+   *
+   * Used to find a fuzz target in a fuzz build.
+   */
+  static const CppUnitVector<FuzzTest *> &getFuzzTests();
+
+protected:
+  Test *doGetChildTestAt( int index ) const;
+
+private:
+  void doRunChildTests( TestResult *controller );
+
+  void deleteInputTests();
+
+  /// Prevents the use of the copy constructor.
+  FuzzTest( const FuzzTest &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const FuzzTest &other );
+
+private:
+  std::string m_corpusDirectory;
+  int m_threadCount;
+  CppUnitVector<std::string> m_inputPaths;
+  CppUnitVector<Test *> m_inputTests;
+};
+
+
+/*! \brief Copy of the input being run by a fuzz target.
+ * \ingroup ExecutingTest
+ *
+ * An input that crashes the process (segmentation fault, sanitizer report,
+ * abort()) can not be saved once it crashed. Before running an input, the
+ * fuzz target copies it in a hidden file of the corpus directory, mapped in
+ * memory where possible so that a copy costs a memcpy(). If the process
+ * dies, the file is left marked as running: the next FuzzTest::loadCorpus()
+ * of the corpus, in the test runner or in the next fuzzing session, saves
+ * the input with FuzzTest::saveInput() and removes the file.
+ */
+class CPPUNIT_API FuzzPendingInput
+{
+public:
+  /*! Creates the file of the pending input in the corpus of \a fuzzTest.
+   * \exception std::runtime_error if the file can not be created.
+   */
+  FuzzPendingInput( const FuzzTest &fuzzTest );
+
+  /// Removes the file.
+  ~FuzzPendingInput();
+
+  /// Copies an input and marks it as running.
+  void start( const unsigned char *data, 
+              size_t size );
+
+  /// Marks the input as done.
+  void finish();
+
+  /// Returns the path of the file.
+  std::string path() const;
+
+  /*! \brief Saves the inputs left running by dead processes.
+   * \return Number of inputs saved.
+   */
+  static int recover( const FuzzTest &fuzzTest );
+
+private:
+  void resize( size_t capacity );
+
+  /// Prevents the use of the copy constructor.
+  FuzzPendingInput( const FuzzPendingInput &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const FuzzPendingInput &other );
+
+private:
+  std::string m_path;
+  int m_descriptor;
+  void *m_mapping;
+  size_t m_capacity;
+};
+
+
+/*! \brief Entry points of a fuzz build.
+ * \ingroup ExecutingTest
+ *
+ * In a fuzz build, the test executable is linked with an in-process, 
+ * coverage-guided fuzzing engine such as libFuzzer (for example compiled
+ * with clang's <tt>-fsanitize=fuzzer</tt>) instead of a test runner. One 
+ * source file includes <cppunit/extensions/FuzzerMain.h>, which defines the
+ * entry points of the engine on top of this class.
+ *
+ * The FuzzTest to use as fuzz target is named by the environment variable
+ * \c CPPUNIT_FUZZ_TEST. It can be omitted if the registry contains a single
+ * fuzz test. The fuzz target runs each input between the setUp() and 
+ * tearDown() of the fixture. When an input fails, it is saved in the corpus
+ * directory, the failure is printed, and the process aborts so that the 
+ * engine reports the crash. An input that crashes the process is saved by
+ * the next load of the corpus (see FuzzPendingInput).
+ */
+class CPPUNIT_API FuzzerMain
+{
+public:
+  /*! \brief Selects the fuzz target in the default registry.
+   *
+   * Exits the process if the target can not be found.
+   */
+  static int initialize( int *argc, 
+                         char ***argv );
+
+  /// Runs the fuzz target on an input.
+  static int testOneInput( const unsigned char *data, 
+                           size_t size );
+
+private:
+  /// Prevents the instantiation of this class.
+  FuzzerMain();
+};
+
+
+CPPUNIT_NS_END
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_EXTENSIONS_FUZZTEST_H
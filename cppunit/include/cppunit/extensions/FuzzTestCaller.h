@@ -0,0 +1,104 @@
+#ifndef CPPUNIT_EXTENSIONS_FUZZTESTCALLER_H
+#define CPPUNIT_EXTENSIONS_FUZZTESTCALLER_H
+
+#include <cppunit/extensions/FuzzTest.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief FuzzTarget that calls a method of a fixture.
+ * \ingroup WritingTestFixture
+ *
+ * The target owns a fixture created with its default constructor.
+ */
+template <class Fixture>
+class FuzzMethodTarget : public FuzzTarget
+{
+public:
+  typedef void (Fixture::*FuzzTestMethod)( const unsigned char *data, 
+                                           size_t size );
+
+  FuzzMethodTarget( FuzzTestMethod test )
+      : m_fixture( new Fixture() )
+      , m_test( test )
+  {
+  }
+
+  ~FuzzMethodTarget()
+  {
+    delete m_fixture;
+  }
+
+  void setUp()
+  {
+    m_fixture->setUp();
+  }
+
+  void run( const unsigned char *data, 
+            size_t size )
+  {
+    (m_fixture->*m_test)( data, size );
+  }
+
+  void tearDown()
+  {
+    m_fixture->tearDown();
+  }
+
+private:
+  /// Prevents the use of the copy constructor.
+  FuzzMethodTarget( const FuzzMethodTarget &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const FuzzMethodTarget &other );
+
+private:
+  Fixture *m_fixture;
+  FuzzTestMethod m_test;
+};
+
+
+/*! \brief FuzzTest that runs a fuzz test method of a fixture.
+ * \ingroup WritingTestFixture
+ *
+ * Each replaying thread uses its own fixture. The fixture must be default
+ * constructible.
+ *
+ * Usually created by CPPUNIT_FUZZ_TEST.
+ */
+template <class Fixture>
+class FuzzTestCaller : public FuzzTest
+{
+  typedef typename FuzzMethodTarget<Fixture>::FuzzTestMethod FuzzTestMethod;
+
+public:
+  /*! Constructs a FuzzTestCaller.
+   * \param name Name of the test.
+   * \param test Method called for each input.
+   * \param corpusDirectory Directory containing the inputs to replay. Defaults
+   *                        to FuzzTest::defaultCorpusDirectory( name ).
+   */
+  FuzzTestCaller( const std::string &name,
+                  FuzzTestMethod test,
+                  const std::string &corpusDirectory = "" )
+      : FuzzTest( name, 
+                  corpusDirectory.empty() ? defaultCorpusDirectory( name ) 
+                                          : corpusDirectory )
+      , m_test( test )
+  {
+  }
+
+  FuzzTarget *makeTarget() const
+  {
+    return new FuzzMethodTarget<Fixture>( m_test );
+  }
+
+private:
+  FuzzTestMethod m_test;
+};
+
+
+CPPUNIT_NS_END
+
+#endif  // CPPUNIT_EXTENSIONS_FUZZTESTCALLER_H
@@ -0,0 +1,42 @@
+#ifndef CPPUNIT_EXTENSIONS_FUZZERMAIN_H
+#define CPPUNIT_EXTENSIONS_FUZZERMAIN_H
+
+/*! \file 
+ * \brief Entry points of a fuzz build.
+ *
+ * Include this file in exactly one source file of a fuzz build, in place of
+ * the test runner main(). It defines the functions called by libFuzzer (and
+ * compatible engines) to run the FuzzTest selected by the environment 
+ * variable \c CPPUNIT_FUZZ_TEST.
+ *
+ * \code
+ * // FuzzMain.cpp, compiled with: clang++ -fsanitize=fuzzer,address
+ * #include <cppunit/extensions/FuzzerMain.h>
+ * \endcode
+ * \code
+ * $ CPPUNIT_FUZZ_TEST=ParserTest::testParse ./parser-fuzz corpus/ParserTest.testParse
+ * \endcode
+ *
+ * \see FuzzerMain, CPPUNIT_FUZZ_TEST.
+ */
+
+#include <cppunit/extensions/FuzzTest.h>
+
+
+extern "C" int 
+LLVMFuzzerInitialize( int *argc, 
+                      char ***argv )
+{
+  return CPPUNIT_NS::FuzzerMain::initialize( argc, argv );
+}
+
+
+extern "C" int 
+LLVMFuzzerTestOneInput( const unsigned char *data, 
+                        size_t size )
+{
+  return CPPUNIT_NS::FuzzerMain::testOneInput( data, size );
+}
+
+
+#endif  // CPPUNIT_EXTENSIONS_FUZZERMAIN_H
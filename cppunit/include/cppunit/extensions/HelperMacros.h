@@ -9,7 +9,12 @@
 #include <cppunit/TestCaller.h>
 #include <cppunit/TestSuite.h>
 #include <cppunit/extensions/AutoRegisterSuite.h>
+#include <cppunit/extensions/BenchmarkTestCaller.h>
 #include <cppunit/extensions/ExceptionTestCaseDecorator.h>
+#include <cppunit/extensions/FuzzTestCaller.h>
+#include <cppunit/extensions/LoadTestCaller.h>
+#include <cppunit/extensions/PropertyGenerator.h>
+#include <cppunit/extensions/PropertyTestCaller.h>
 #include <cppunit/extensions/TestFixtureFactory.h>
 #include <cppunit/extensions/TestNamer.h>
 #include <cppunit/extensions/TestSuiteBuilderContext.h>
@@ -300,6 +305,294 @@
                   &TestFixtureType::testMethod,           \
                   context.makeFixture() ) ) )
 
+/*! \brief Add a method to the suite, with some tags.
+ *
+ * Tags are used to select the tests to run with a TagExpression, for example
+ * using the \c --tags option of DllPlugInTester. The test also inherits the
+ * tags of its fixture suite (see CPPUNIT_TEST_SUITE_TAGS).
+ * \code
+ * CPPUNIT_TEST_TAGS( testBulkInsert, "slow,db" );
+ * \endcode
+ * \param testMethod Name of the method of the test case to add to the
+ *                   suite. The signature of the method must be of
+ *                   type: void testMethod();
+ * \param tags       Comma separated list of tags.
+ * \see  CPPUNIT_TEST, TaggedTestIndex.
+ */
+#define CPPUNIT_TEST_TAGS( testMethod, tags )                 \
+    context.addTaggedTest(                                    \
+        new CPPUNIT_NS::TestCaller<TestFixtureType>(          \
+                  context.getTestNameFor( #testMethod),       \
+                  &TestFixtureType::testMethod,               \
+                  context.makeFixture() ),                    \
+        std::string( tags ) )
+
+/*! \brief Add a load test method to the suite.
+ *
+ * The method is given a LoadDriver that applies the specified LoadProfile.
+ * Its signature must be of type: <tt>void testMethod( CppUnit::LoadDriver & )</tt>.
+ *
+ * Example:
+ * \code
+ * class CacheLoadTest : public CppUnit::TestFixture
+ * {
+ *   CPPUNIT_TEST_SUITE( CacheLoadTest );
+ *   // 5000 requests per second during 2 seconds, from 4 threads.
+ *   CPPUNIT_LOAD_TEST( testLookup, CppUnit::LoadProfile( 5000, 2, 4 ) );
+ *   CPPUNIT_TEST_SUITE_END();
+ * public:
+ *   void lookup() { m_cache.find( "key" ); }
+ *
+ *   void testLookup( CppUnit::LoadDriver &load )
+ *   {
+ *     CppUnit::LoadRequestMethod<CacheLoadTest> request( this, &CacheLoadTest::lookup );
+ *     load.run( request );
+ *     CPPUNIT_ASSERT_P99_BELOW( load.latencies(), 0.001 );
+ *   }
+ * };
+ * \endcode
+ * The recorded latency distribution is added to the XML output by
+ * LatencyXmlOutputterHook.
+ *
+ * \param testMethod Name of the load test method.
+ * \param profile    LoadProfile applied by the LoadDriver.
+ * \see  LoadTestCaller, LoadDriver.
+ */
+#define CPPUNIT_LOAD_TEST( testMethod, profile )                  \
+    CPPUNIT_TEST_SUITE_ADD_TEST(                                  \
+        ( new CPPUNIT_NS::LoadTestCaller<TestFixtureType>(        \
+                  context.getTestNameFor( #testMethod ),          \
+                  &TestFixtureType::testMethod,                   \
+                  context.makeFixture(),                          \
+                  profile ) ) )
+
+/*! \brief Add a benchmark method to the suite, run for a single size of 0.
+ *
+ * The method runs the measured code in a loop controlled by the given
+ * BenchmarkState. Its signature must be of type:
+ * <tt>void testMethod( CppUnit::BenchmarkState & )</tt>.
+ *
+ * Example:
+ * \code
+ * class SortBenchmark : public CppUnit::TestFixture
+ * {
+ *   CPPUNIT_TEST_SUITE( SortBenchmark );
+ *   CPPUNIT_BENCHMARK_COMPLEXITY( benchmarkSort, 1 << 10, 1 << 20,
+ *                                 CppUnit::complexityLinearithmic );
+ *   CPPUNIT_TEST_SUITE_END();
+ * public:
+ *   void benchmarkSort( CppUnit::BenchmarkState &state )
+ *   {
+ *     std::vector<int> values = makeRandomValues( state.size() );
+ *     while ( state.keepRunning() )
+ *     {
+ *       state.pauseTiming();
+ *       std::vector<int> sorted( values );
+ *       state.resumeTiming();
+ *       std::sort( sorted.begin(), sorted.end() );
+ *     }
+ *   }
+ * };
+ * \endcode
+ * The timings of each size and the fitted complexity are added to the XML
+ * output by BenchmarkXmlOutputterHook.
+ *
+ * \param testMethod Name of the benchmark method.
+ * \see  CPPUNIT_BENCHMARK_RANGE, CPPUNIT_BENCHMARK_COMPLEXITY,
+ *       BenchmarkTestCaller, BenchmarkRunner.
+ */
+#define CPPUNIT_BENCHMARK( testMethod )                           \
+    CPPUNIT_BENCHMARK_COMPLEXITY( testMethod, 0, 0,               \
+                                  CPPUNIT_NS::complexityAny )
+
+/*! \brief Add a benchmark method to the suite, run over a range of sizes.
+ *
+ * The sizes are multiplied by 8 from \a firstSize to \a lastSize. The
+ * complexity is fitted if there are at least three sizes, but not checked.
+ *
+ * \param testMethod Name of the benchmark method.
+ * \param firstSize  First size given to the benchmark method.
+ * \param lastSize   Last size given to the benchmark method.
+ * \see  CPPUNIT_BENCHMARK.
+ */
+#define CPPUNIT_BENCHMARK_RANGE( testMethod, firstSize, lastSize ) \
+    CPPUNIT_BENCHMARK_COMPLEXITY( testMethod, firstSize, lastSize, \
+                                  CPPUNIT_NS::complexityAny )
+
+/*! \brief Add a benchmark method to the suite, that fails if its fitted
+ *         complexity is worse than the specified one.
+ *
+ * \param testMethod        Name of the benchmark method.
+ * \param firstSize         First size given to the benchmark method.
+ * \param lastSize          Last size given to the benchmark method.
+ * \param maximumComplexity Worst accepted BenchmarkComplexity.
+ * \see  CPPUNIT_BENCHMARK, CPPUNIT_ASSERT_COMPLEXITY.
+ */
+#define CPPUNIT_BENCHMARK_COMPLEXITY( testMethod, firstSize, lastSize,    \
+                                      maximumComplexity )                 \
+    CPPUNIT_TEST_SUITE_ADD_TEST(                                          \
+        ( new CPPUNIT_NS::BenchmarkTestCaller<TestFixtureType>(           \
+                  context.getTestNameFor( #testMethod ),                  \
+                  &TestFixtureType::testMethod,                           \
+                  context.makeFixture(),                                  \
+                  firstSize,                                              \
+                  lastSize,                                               \
+                  maximumComplexity ) ) )
+
+/*! \brief Add a benchmark method to the suite, run on 1, 2, 4... threads.
+ *
+ * Each thread runs the method with its own BenchmarkState, and the threads
+ * start their loop together. The aggregate throughput, the deviation of the
+ * throughput of the threads and the scaling efficiency of each thread count
+ * are added to the XML output.
+ *
+ * Example:
+ * \code
+ * void benchmarkPush( CppUnit::BenchmarkState &state )
+ * {
+ *   int value = state.threadIndex();    // local to the thread
+ *   while ( state.keepRunning() )
+ *     m_queue.push( value );
+ * }
+ * \endcode
+ *
+ * \param testMethod         Name of the benchmark method.
+ * \param maximumThreadCount Largest number of threads, for example
+ *                           CppUnit::ThreadGroup::processorCount().
+ * \see  CPPUNIT_BENCHMARK, BenchmarkRunner::runThreads().
+ */
+#define CPPUNIT_BENCHMARK_THREADS( testMethod, maximumThreadCount )       \
+    CPPUNIT_TEST_SUITE_ADD_TEST(                                          \
+        ( new CPPUNIT_NS::BenchmarkTestCaller<TestFixtureType>(           \
+                  context.getTestNameFor( #testMethod ),                  \
+                  &TestFixtureType::testMethod,                           \
+                  context.makeFixture(),                                  \
+                  0,                                                      \
+                  0,                                                      \
+                  CPPUNIT_NS::complexityAny,                              \
+                  maximumThreadCount ) ) )
+
+/*! \brief Add a benchmark method to the suite, run with cold caches.
+ *
+ * The caches are evicted before each iteration, outside of the timing, so
+ * that the benchmark measures the cost of loading its data from memory
+ * instead of finding it in the caches left warm by the previous iteration.
+ *
+ * \param testMethod Name of the benchmark method.
+ * \param firstSize  First size given to the benchmark method.
+ * \param lastSize   Last size given to the benchmark method.
+ * \see  CPPUNIT_BENCHMARK_RANGE, BenchmarkRunner::setCacheState().
+ */
+#define CPPUNIT_BENCHMARK_COLD( testMethod, firstSize, lastSize )         \
+    CPPUNIT_TEST_SUITE_ADD_TEST(                                          \
+        ( new CPPUNIT_NS::BenchmarkTestCaller<TestFixtureType>(           \
+                  context.getTestNameFor( #testMethod ),                  \
+                  &TestFixtureType::testMethod,                           \
+                  context.makeFixture(),                                  \
+                  firstSize,                                              \
+                  lastSize,                                               \
+                  CPPUNIT_NS::complexityAny,                              \
+                  0,                                                      \
+                  CPPUNIT_NS::cacheCold ) ) )
+
+/*! \brief Add a property method to the suite, checked on 100 random cases.
+ *
+ * The method draws its inputs from the given PropertyCase with 
+ * PropertyGenerator objects, and checks the property with assertions. Its 
+ * signature must be of type: <tt>void testMethod( CppUnit::PropertyCase & )</tt>.
+ *
+ * Example:
+ * \code
+ * class SortTest : public CppUnit::TestFixture
+ * {
+ *   CPPUNIT_TEST_SUITE( SortTest );
+ *   CPPUNIT_PROPERTY( testSortIsOrdered );
+ *   CPPUNIT_PROPERTY_CASES( testSortKeepsSize, 100000 );
+ *   CPPUNIT_TEST_SUITE_END();
+ * public:
+ *   void testSortIsOrdered( CppUnit::PropertyCase &property )
+ *   {
+ *     CppUnit::VectorGenerator<CppUnit::IntegerGenerator<int> > values( 
+ *         CppUnit::IntegerGenerator<int>( -1000, 1000 ), 50 );
+ *     std::vector<int> sorted = values.draw( property );
+ *     mySort( sorted );
+ *     for ( unsigned int index =1; index < sorted.size(); ++index )
+ *       CPPUNIT_ASSERT( sorted[index -1] <= sorted[index] );
+ *   }
+ * };
+ * \endcode
+ * If the property fails, the failing case is shrunk to a minimal 
+ * counterexample, reported with the seed that replays the run.
+ *
+ * \param testMethod Name of the property method.
+ * \see  CPPUNIT_PROPERTY_CASES, PropertyTestCaller, PropertyRunner.
+ */
+#define CPPUNIT_PROPERTY( testMethod )                            \
+    CPPUNIT_PROPERTY_CASES( testMethod, 100 )
+
+/*! \brief Add a property method to the suite, checked on the specified 
+ *         number of random cases.
+ * \param testMethod Name of the property method.
+ * \param caseCount  Number of cases to check.
+ * \see  CPPUNIT_PROPERTY.
+ */
+#define CPPUNIT_PROPERTY_CASES( testMethod, caseCount )           \
+    CPPUNIT_TEST_SUITE_ADD_TEST(                                  \
+        ( new CPPUNIT_NS::PropertyTestCaller<TestFixtureType>(    \
+                  context.getTestNameFor( #testMethod ),          \
+                  &TestFixtureType::testMethod,                   \
+                  context.makeFixture(),                          \
+                  caseCount ) ) )
+
+/*! \brief Add a fuzz test method to the suite.
+ *
+ * The method receives an input as a byte buffer. Its signature must be of
+ * type: <tt>void testMethod( const unsigned char *data, size_t size )</tt>.
+ *
+ * In a normal run, the test replays every file of its corpus directory as a
+ * child test (see FuzzTest). The corpus directory is named after the test, 
+ * in the directory given by the environment variable \c CPPUNIT_FUZZ_CORPUS
+ * (\c corpus by default): <tt>corpus/ParserTest.testParse</tt> below.
+ *
+ * In a fuzz build (see FuzzerMain), the method is the fuzz target, and the
+ * inputs that make it fail are saved in the corpus directory, so that they
+ * become regression tests.
+ *
+ * Example:
+ * \code
+ * class ParserTest : public CppUnit::TestFixture
+ * {
+ *   CPPUNIT_TEST_SUITE( ParserTest );
+ *   CPPUNIT_FUZZ_TEST( testParse );
+ *   CPPUNIT_TEST_SUITE_END();
+ * public:
+ *   void testParse( const unsigned char *data, size_t size )
+ *   {
+ *     Document document;
+ *     if ( m_parser.parse( data, size, document ) )
+ *       CPPUNIT_ASSERT( document.isValid() );
+ *   }
+ * };
+ * \endcode
+ *
+ * \param testMethod Name of the fuzz test method.
+ * \see  CPPUNIT_FUZZ_TEST_CORPUS, FuzzTestCaller.
+ */
+#define CPPUNIT_FUZZ_TEST( testMethod )                           \
+    CPPUNIT_FUZZ_TEST_CORPUS( testMethod, "" )
+
+/*! \brief Add a fuzz test method to the suite, with its corpus directory.
+ * \param testMethod Name of the fuzz test method.
+ * \param corpusDirectory Directory containing the inputs to replay.
+ * \see  CPPUNIT_FUZZ_TEST.
+ */
+#define CPPUNIT_FUZZ_TEST_CORPUS( testMethod, corpusDirectory )   \
+    CPPUNIT_TEST_SUITE_ADD_TEST(                                  \
+        ( new CPPUNIT_NS::FuzzTestCaller<TestFixtureType>(        \
+                  context.getTestNameFor( #testMethod ),          \
+                  &TestFixtureType::testMethod,                   \
+                  corpusDirectory ) ) )
+
 /*! \brief Add a test which fail if the specified exception is not caught.
  *
  * Example:
@@ -403,16 +696,38 @@
       testAdderMethod( context )
 
 /*! \brief Adds a property to the test suite builder context.
+ *
+ * The property is also set on the fixture suite, see Test::getProperty().
+ *
  * \param APropertyKey   Key of the property to add.
  * \param APropertyValue Value for the added property.
  * Example:
  * \code
  * CPPUNIT_TEST_SUITE_PROPERTY("XmlFileName", "paraTest.xml"); \endcode
+ *
+ * The property "resources" declares the resources used by the tests of the
+ * suite. It is used by ResourceScheduler to avoid running conflicting tests
+ * concurrently:
+ * \code
+ * CPPUNIT_TEST_SUITE_PROPERTY( "resources", "exclusive:port-8080,cpu:4" ); \endcode
  */
 #define CPPUNIT_TEST_SUITE_PROPERTY( APropertyKey, APropertyValue ) \
     context.addProperty( std::string(APropertyKey),                 \
                          std::string(APropertyValue) )
 
+/*! \brief Adds some tags to all the tests of the fixture suite.
+ *
+ * The tags are stored in the "tags" property of the fixture suite and are
+ * inherited by all the test cases of the suite.
+ * \code
+ * CPPUNIT_TEST_SUITE_TAGS( "db" );
+ * \endcode
+ * \param tags Comma separated list of tags.
+ * \see  CPPUNIT_TEST_TAGS.
+ */
+#define CPPUNIT_TEST_SUITE_TAGS( tags ) \
+    CPPUNIT_TEST_SUITE_PROPERTY( "tags", tags )
+
 /** @}
  */
 
@@ -0,0 +1,120 @@
+#ifndef CPPUNIT_EXTENSIONS_LATENCYREPORT_H
+#define CPPUNIT_EXTENSIONS_LATENCYREPORT_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/XmlOutputterHook.h>
+#include <cppunit/portability/CppUnitMap.h>
+#include <cppunit/tools/LatencyHistogram.h>
+#include <string>
+
+
+CPPUNIT_NS_BEGIN
+
+
+class Test;
+
+
+/*! \brief Latencies recorded by the load tests.
+ * \ingroup WritingTestFixture
+ *
+ * Load tests (see CPPUNIT_LOAD_TEST) store the latencies they recorded in the
+ * report shared by all the tests. LatencyXmlOutputterHook adds them to the
+ * XML output.
+ */
+class CPPUNIT_API LatencyReport
+{
+public:
+  /// Constructs an empty report.
+  LatencyReport();
+
+  /// Destructor.
+  virtual ~LatencyReport();
+
+  /// Returns the report shared by all the tests.
+  static LatencyReport &getReport();
+
+  /// Stores the latencies recorded by the specified test.
+  void setLatencies( Test *test, 
+                     const LatencyHistogram &latencies );
+
+  /// Removes the latencies recorded by the specified test.
+  void removeLatencies( Test *test );
+
+  /*! \brief Returns the latencies recorded by the specified test.
+   * \return Recorded latencies, \c NULL if \a test did not record any.
+   */
+  const LatencyHistogram *findLatencies( Test *test ) const;
+
+  /// Returns a one line summary of \a latencies (count, p50, p99, max...).
+  static std::string summaryFor( const LatencyHistogram &latencies );
+
+private:
+  /// Prevents the use of the copy constructor.
+  LatencyReport( const LatencyReport &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const LatencyReport &other );
+
+private:
+  typedef CppUnitMap<Test *, LatencyHistogram, std::less<Test *> > Latencies;
+  Latencies m_latencies;
+};
+
+
+/*! \brief Adds the latency distribution of the load tests to the XML output.
+ * \ingroup WritingTestResult
+ *
+ * A \<Latency\> element is added to the element of each test that recorded
+ * latencies:
+ * \code
+ * <Latency count="20000" min="0.000012" mean="0.000031" max="0.0042">
+ *   <Percentile value="50">2.9e-05</Percentile>
+ *   ...
+ *   <Bucket lowerBound="2.8e-05" upperBound="2.9e-05">1200</Bucket>
+ *   ...
+ * </Latency>
+ * \endcode
+ * Only the non empty buckets are written.
+ */
+class CPPUNIT_API LatencyXmlOutputterHook : public XmlOutputterHook
+{
+public:
+  /*! Constructs a LatencyXmlOutputterHook object.
+   * \param report Report that contains the recorded latencies.
+   */
+  LatencyXmlOutputterHook( const LatencyReport &report = 
+                               LatencyReport::getReport() );
+
+  virtual ~LatencyXmlOutputterHook();
+
+  void failTestAdded( XmlDocument *document,
+                      XmlElement *testElement,
+                      Test *test,
+                      TestFailure *failure );
+
+  void successfulTestAdded( XmlDocument *document,
+                            XmlElement *testElement,
+                            Test *test );
+
+private:
+  void addLatencies( XmlElement *testElement, 
+                     Test *test );
+
+private:
+  const LatencyReport &m_report;
+};
+
+
+CPPUNIT_NS_END
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_EXTENSIONS_LATENCYREPORT_H
@@ -0,0 +1,206 @@
+#ifndef CPPUNIT_EXTENSIONS_LOADDRIVER_H
+#define CPPUNIT_EXTENSIONS_LOADDRIVER_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/SourceLine.h>
+#include <cppunit/tools/LatencyHistogram.h>
+#include <string>
+
+
+CPPUNIT_NS_BEGIN
+
+
+class Test;
+
+
+/*! \brief Describes the load applied by a load test.
+ * \ingroup WritingTestFixture
+ */
+class CPPUNIT_API LoadProfile
+{
+public:
+  /*! Constructs a LoadProfile object.
+   * \param requestsPerSecond Target rate of requests, for all the threads.
+   * \param durationSeconds Duration of the load, in seconds.
+   * \param threadCount Number of threads generating the requests.
+   */
+  LoadProfile( double requestsPerSecond,
+               double durationSeconds,
+               int threadCount = 1 );
+
+  double requestsPerSecond() const;
+
+  double durationSeconds() const;
+
+  int threadCount() const;
+
+  /// Returns the number of requests sent during the load.
+  int requestCount() const;
+
+private:
+  double m_requestsPerSecond;
+  double m_durationSeconds;
+  int m_threadCount;
+};
+
+
+/*! \brief Request sent by a load test.
+ * \ingroup WritingTestFixture
+ *
+ * send() is called concurrently by the generator threads.
+ */
+class CPPUNIT_API LoadRequest
+{
+public:
+  virtual ~LoadRequest() {}
+
+  /*! \brief Sends one request and waits for its completion.
+   * \param threadIndex Index of the generator thread.
+   */
+  virtual void send( int threadIndex ) =0;
+};
+
+
+/*! \brief LoadRequest that calls a method of a fixture.
+ * \ingroup WritingTestFixture
+ *
+ * \code
+ * CppUnit::LoadRequestMethod<CacheTest> request( this, &CacheTest::lookup );
+ * load.run( request );
+ * \endcode
+ */
+template<class Fixture>
+class LoadRequestMethod : public LoadRequest
+{
+public:
+  typedef void (Fixture::*RequestMethod)();
+
+  LoadRequestMethod( Fixture *fixture, 
+                     RequestMethod method )
+      : m_fixture( fixture )
+      , m_method( method )
+  {
+  }
+
+  void send( int )
+  {
+    (m_fixture->*m_method)();
+  }
+
+private:
+  Fixture *m_fixture;
+  RequestMethod m_method;
+};
+
+
+/*! \brief Drives requests at a target rate and records their latency.
+ * \ingroup WritingTestFixture
+ *
+ * The requests are sent on an open-loop schedule: request \c i is due
+ * at <tt>start + i / requestsPerSecond</tt>, whatever the time taken by the
+ * previous requests. Its latency is measured from that due time rather than
+ * from the time it was actually sent. A slow request therefore also counts
+ * against the requests queued behind it, as it would for real clients.
+ * Otherwise the tail latency would be hidden (coordinated omission).
+ *
+ * Requests are distributed round-robin over the generator threads (see
+ * ThreadGroup).
+ *
+ * The driver is usually created by CPPUNIT_LOAD_TEST, which also reports the
+ * recorded latencies to the LatencyReport.
+ */
+class CPPUNIT_API LoadDriver
+{
+public:
+  /*! Constructs a LoadDriver object.
+   * \param profile Load to apply.
+   * \param test Test the latencies are reported for in the LatencyReport.
+   *             If \c NULL, the latencies are not reported.
+   */
+  LoadDriver( const LoadProfile &profile,
+              Test *test = NULL );
+
+  /// Destructor.
+  virtual ~LoadDriver();
+
+  /*! \brief Applies the load with the specified request.
+   *
+   * The recorded latencies are added to latencies().
+   * \exception Exception if some requests threw an exception. The failure
+   *            reports the number of failed requests and the first error.
+   */
+  void run( LoadRequest &request );
+
+  /// Returns the recorded latencies.
+  const LatencyHistogram &latencies() const;
+
+  /// Returns the applied load.
+  const LoadProfile &profile() const;
+
+  /// Returns the rate at which requests completed during the last run.
+  double achievedRequestsPerSecond() const;
+
+private:
+  /// Prevents the use of the copy constructor.
+  LoadDriver( const LoadDriver &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const LoadDriver &other );
+
+private:
+  LoadProfile m_profile;
+  Test *m_test;
+  LatencyHistogram m_latencies;
+  double m_achievedRequestsPerSecond;
+};
+
+
+/*! \brief (Implementation) Asserts that a latency percentile is below a bound.
+ * \ingroup Assertions
+ * \sa CPPUNIT_ASSERT_PERCENTILE_BELOW.
+ */
+void CPPUNIT_API assertPercentileBelow( const LatencyHistogram &latencies,
+                                        double percentile,
+                                        double maximumLatency,
+                                        SourceLine sourceLine,
+                                        const std::string &message );
+
+
+/*! \brief Asserts that a percentile of the recorded latencies is below a bound.
+ * \ingroup Assertions
+ *
+ * The assertion fails if the latency at \a percentile is greater than 
+ * \a maximumLatency (in seconds). The failure message includes the 
+ * distribution summary (p50, p90, p99, p99.9 and maximum).
+ */
+#define CPPUNIT_ASSERT_PERCENTILE_BELOW( latencies, percentile, maximumLatency ) \
+  ( CPPUNIT_NS::assertPercentileBelow( (latencies),              \
+                                       (percentile),             \
+                                       (maximumLatency),         \
+                                       CPPUNIT_SOURCELINE(),     \
+                                       "" ) )
+
+/*! \brief Asserts that the p99 latency is below \a maximumLatency seconds.
+ * \ingroup Assertions
+ * \code
+ * CPPUNIT_ASSERT_P99_BELOW( load.latencies(), 0.002 );
+ * \endcode
+ * \sa CPPUNIT_ASSERT_PERCENTILE_BELOW.
+ */
+#define CPPUNIT_ASSERT_P99_BELOW( latencies, maximumLatency ) \
+  CPPUNIT_ASSERT_PERCENTILE_BELOW( latencies, 99, maximumLatency )
+
+
+CPPUNIT_NS_END
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_EXTENSIONS_LOADDRIVER_H
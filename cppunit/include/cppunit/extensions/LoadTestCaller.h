@@ -0,0 +1,86 @@
+#ifndef CPPUNIT_EXTENSIONS_LOADTESTCALLER_H
+#define CPPUNIT_EXTENSIONS_LOADTESTCALLER_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/LatencyReport.h>
+#include <cppunit/extensions/LoadDriver.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief Test case that runs a load test method of a fixture.
+ * \ingroup WritingTestFixture
+ *
+ * The test method receives a LoadDriver configured with the LoadProfile
+ * given on construction. The latencies recorded by the driver are stored in
+ * the LatencyReport for this test.
+ *
+ * Usually created by CPPUNIT_LOAD_TEST.
+ */
+template <class Fixture>
+class LoadTestCaller : public TestCase
+{ 
+  typedef void (Fixture::*LoadTestMethod)( LoadDriver &load );
+    
+public:
+  /*! Constructs a LoadTestCaller. The LoadTestCaller owns the fixture and
+   * deletes it in its destructor.
+   * \param name Name of the test.
+   * \param test Method called in runTest().
+   * \param fixture Fixture to invoke the test method on, owned by the
+   *                LoadTestCaller.
+   * \param profile Load applied by the LoadDriver given to the method.
+   */
+  LoadTestCaller( std::string name, 
+                  LoadTestMethod test, 
+                  Fixture *fixture,
+                  const LoadProfile &profile ) 
+      : TestCase( name )
+      , m_fixture( fixture )
+      , m_test( test )
+      , m_profile( profile )
+  {
+  }
+
+  ~LoadTestCaller() 
+  {
+    LatencyReport::getReport().removeLatencies( this );
+    delete m_fixture;
+  }
+
+  void runTest()
+  { 
+    LoadDriver load( m_profile, this );
+    (m_fixture->*m_test)( load );
+  }  
+
+  void setUp()
+  { 
+    m_fixture->setUp(); 
+  }
+
+  void tearDown()
+  { 
+    m_fixture->tearDown(); 
+  }
+
+  std::string toString() const
+  { 
+    return "LoadTestCaller " + getName(); 
+  }
+
+private: 
+  LoadTestCaller( const LoadTestCaller &other ); 
+  LoadTestCaller &operator =( const LoadTestCaller &other );
+
+private:
+  Fixture *m_fixture;
+  LoadTestMethod m_test;
+  LoadProfile m_profile;
+};
+
+
+CPPUNIT_NS_END
+
+#endif  // CPPUNIT_EXTENSIONS_LOADTESTCALLER_H
@@ -35,7 +35,7 @@ CPPUNIT_NS_BEGIN
  * Templated test cases be very useful when you are want to
  * make sure that a group of classes have the same form.
  *
- * see TestSuite
+ * see TestSuite, OrthodoxMove
  */
 
 
@@ -45,6 +45,8 @@ public:
                     Orthodox () : TestCase ("Orthodox") {}
 
 protected:
+                    Orthodox (std::string name) : TestCase (name) {}
+
     ClassUnderTest  call (ClassUnderTest object);
     void            runTest ();
 
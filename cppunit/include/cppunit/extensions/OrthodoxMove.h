@@ -0,0 +1,166 @@
+#ifndef CPPUNIT_EXTENSIONS_ORTHODOXMOVE_H
+#define CPPUNIT_EXTENSIONS_ORTHODOXMOVE_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_HAVE_RVALUE_REFERENCES
+
+#include <cppunit/TestAssert.h>
+#include <cppunit/extensions/Orthodox.h>
+#include <cppunit/tools/AllocationCounter.h>
+#include <type_traits>
+#include <utility>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief (Implementation) Swaps two objects, finding swap() by ADL.
+ */
+namespace OrthodoxMoveSwap
+{
+  using std::swap;
+
+  template <class ClassUnderTest>
+  void swapObjects( ClassUnderTest &first, ClassUnderTest &second )
+  {
+    swap( first, second );
+  }
+
+  template <class ClassUnderTest>
+  struct IsNothrowSwappable
+  {
+    static const bool value = noexcept( swap( std::declval<ClassUnderTest &>(),
+                                              std::declval<ClassUnderTest &>() ) );
+  };
+}
+
+
+/*! \brief Checks the move operations of a value type.
+ * \ingroup WritingTestFixture
+ *
+ * OrthodoxMove performs the checks of Orthodox, then makes sure that:
+ * - the move constructor, the move assignment and swap() are declared 
+ *   noexcept. Otherwise, standard containers copy the elements when they
+ *   grow instead of moving them;
+ * - a moved object compares equal to the original value;
+ * - a moved-from object can still be assigned and destroyed;
+ * - swap() exchanges the values;
+ * - moving and swapping make no heap allocation. This is only checked if the
+ *   test program uses CPPUNIT_INSTALL_ALLOCATION_COUNTER (see 
+ *   AllocationCounter).
+ *
+ * \code
+ * CPPUNIT_TEST_SUITE_ADD_TEST( new CppUnit::OrthodoxMove<Buffer>() );
+ * \endcode
+ *
+ * Only available if the compiler supports rvalue references (see 
+ * CPPUNIT_HAVE_RVALUE_REFERENCES).
+ */
+template <class ClassUnderTest> 
+class OrthodoxMove : public Orthodox<ClassUnderTest>
+{
+public:
+  OrthodoxMove()
+      : Orthodox<ClassUnderTest>( "OrthodoxMove" )
+  {
+  }
+
+protected:
+  void runTest()
+  {
+    Orthodox<ClassUnderTest>::runTest();
+
+    CPPUNIT_ASSERT_MESSAGE( "move constructor must be noexcept",
+        std::is_nothrow_move_constructible<ClassUnderTest>::value );
+    CPPUNIT_ASSERT_MESSAGE( "move assignment must be noexcept",
+        std::is_nothrow_move_assignable<ClassUnderTest>::value );
+    CPPUNIT_ASSERT_MESSAGE( "swap() must be noexcept",
+        OrthodoxMoveSwap::IsNothrowSwappable<ClassUnderTest>::value );
+
+    checkMoveConstruction();
+    checkMoveAssignment();
+    checkSwap();
+  }
+
+private:
+  void checkMoveConstruction()
+  {
+    ClassUnderTest defaultValue;
+    ClassUnderTest value = !defaultValue;
+    ClassUnderTest source( value );
+
+    int allocationCount;
+    {
+      AllocationCounter counter;
+      ClassUnderTest moved( std::move( source ) );
+      allocationCount = counter.allocationCount();
+      CPPUNIT_ASSERT_MESSAGE( "moved object must equal the original value",
+                              moved == value );
+    }
+    checkNoAllocation( "move constructor", allocationCount );
+    checkMovedFrom( source );
+  }
+
+  void checkMoveAssignment()
+  {
+    ClassUnderTest defaultValue;
+    ClassUnderTest value = !defaultValue;
+    ClassUnderTest source( value );
+    ClassUnderTest target;
+
+    int allocationCount;
+    {
+      AllocationCounter counter;
+      target = std::move( source );
+      allocationCount = counter.allocationCount();
+    }
+    CPPUNIT_ASSERT_MESSAGE( "move assigned object must equal the original value",
+                            target == value );
+    checkNoAllocation( "move assignment", allocationCount );
+    checkMovedFrom( source );
+  }
+
+  void checkSwap()
+  {
+    ClassUnderTest defaultValue;
+    ClassUnderTest value = !defaultValue;
+    ClassUnderTest first( defaultValue );
+    ClassUnderTest second( value );
+
+    int allocationCount;
+    {
+      AllocationCounter counter;
+      OrthodoxMoveSwap::swapObjects( first, second );
+      allocationCount = counter.allocationCount();
+    }
+    CPPUNIT_ASSERT_MESSAGE( "swap() must exchange the values",
+                            first == value  &&  second == defaultValue );
+    checkNoAllocation( "swap()", allocationCount );
+  }
+
+  void checkMovedFrom( ClassUnderTest &movedFrom )
+  {
+    ClassUnderTest defaultValue;
+    movedFrom = defaultValue;
+    CPPUNIT_ASSERT_MESSAGE( "moved-from object must be assignable",
+                            movedFrom == defaultValue );
+  }
+
+  void checkNoAllocation( const std::string &operation,
+                          int allocationCount )
+  {
+    if ( !AllocationCounter::isInstalled() )
+      return;
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( operation + " must not allocate memory",
+                                  0, 
+                                  allocationCount );
+  }
+};
+
+
+CPPUNIT_NS_END
+
+#endif  // CPPUNIT_HAVE_RVALUE_REFERENCES
+
+#endif  // CPPUNIT_EXTENSIONS_ORTHODOXMOVE_H
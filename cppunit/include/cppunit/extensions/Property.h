@@ -0,0 +1,294 @@
+#ifndef CPPUNIT_EXTENSIONS_PROPERTY_H
+#define CPPUNIT_EXTENSIONS_PROPERTY_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/SourceLine.h>
+#include <cppunit/portability/CppUnitVector.h>
+#include <cppunit/tools/Random.h>
+#include <stddef.h>
+#include <string>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief Memory allocated for the values generated by a property case.
+ * \ingroup WritingTestFixture
+ *
+ * The arena is a bump allocator: allocate() returns the next free bytes of
+ * its current chunk, and reset() makes all its chunks free again without
+ * releasing them. Each worker thread of a PropertyRunner owns an arena that
+ * is reset before each case, so generating the values of a case does not 
+ * allocate memory once the first cases have run.
+ *
+ * Objects allocated in the arena are never destroyed: only types that do
+ * not need a destructor may be stored in it.
+ *
+ * \see ArrayGenerator.
+ */
+class CPPUNIT_API PropertyArena
+{
+public:
+  /*! Constructs an empty arena.
+   * \param chunkSize Size of the chunks of memory allocated by the arena.
+   */
+  PropertyArena( size_t chunkSize = 64 * 1024 );
+
+  /// Destructor. Releases all the chunks.
+  virtual ~PropertyArena();
+
+  /*! \brief Allocates memory.
+   * \return Memory suitably aligned for any fundamental type. Valid until the
+   *         next call to reset().
+   */
+  void *allocate( size_t size );
+
+  /// Makes all the allocated memory available again.
+  void reset();
+
+  /// Returns the number of bytes allocated since the last reset().
+  size_t allocatedSize() const;
+
+  /// Returns the number of bytes owned by the arena.
+  size_t capacity() const;
+
+private:
+  /// Prevents the use of the copy constructor.
+  PropertyArena( const PropertyArena &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const PropertyArena &other );
+
+private:
+  size_t m_chunkSize;
+  CppUnitVector<char *> m_chunks;
+  CppUnitVector<size_t> m_chunkSizes;
+  unsigned int m_chunkIndex;
+  size_t m_offset;
+  size_t m_allocatedSize;
+};
+
+
+/*! \brief Source of the values generated for a property case.
+ * \ingroup WritingTestFixture
+ *
+ * Generators (see PropertyGenerator) build their values from a sequence of
+ * choices: small integers drawn by drawChoice() and drawBoolean(). When a 
+ * case is generated, the choices are drawn from a Random and recorded. When
+ * a case is replayed, the recorded choices are returned instead.
+ *
+ * Shrinking a failing case works on its recorded choices: choices are 
+ * removed or made smaller, then the case is replayed. Generators are 
+ * written so that smaller choices produce simpler values: 0 is the simplest
+ * choice, and a replay that runs out of choices draws 0.
+ */
+class CPPUNIT_API PropertyCase
+{
+public:
+  typedef CppUnitVector<unsigned long> Choices;
+
+  /// Constructs a PropertyCase object.
+  PropertyCase();
+
+  /// Destructor.
+  virtual ~PropertyCase();
+
+  /*! \brief Draws a choice in [0, \a maximum].
+   *
+   * When generating, the choice is uniform, with some extra weight on the
+   * bounds, where bugs tend to be.
+   */
+  unsigned long drawChoice( unsigned long maximum );
+
+  /*! \brief Draws a choice in {0, 1}. 
+   *
+   * When generating, 1 (\c true) is drawn with the specified probability.
+   */
+  bool drawBoolean( double probability );
+
+  /// Returns the arena to allocate the generated values from.
+  PropertyArena &arena();
+
+  /*! \brief Tests if the drawn values should be noted.
+   *
+   * Values are only noted when the counterexample of a failed property is
+   * replayed, to report it.
+   */
+  bool isNoting() const;
+
+  /// Notes the description of a value drawn by the property.
+  void note( const std::string &value );
+
+  /// Starts a new case whose choices are drawn from a generator seeded with \a seed.
+  void startGeneration( unsigned int seed );
+
+  /// Starts a new case that replays \a choices.
+  void startReplay( const Choices &choices,
+                    bool noting = false );
+
+  /// Returns the choices drawn since the case was started.
+  const Choices &choices() const;
+
+  /// Returns the values noted since the case was started.
+  const CppUnitVector<std::string> &notes() const;
+
+private:
+  void start();
+
+  /// Prevents the use of the copy constructor.
+  PropertyCase( const PropertyCase &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const PropertyCase &other );
+
+private:
+  Random m_random;
+  bool m_replaying;
+  bool m_noting;
+  Choices m_replayedChoices;
+  unsigned int m_replayPosition;
+  Choices m_choices;
+  CppUnitVector<std::string> m_notes;
+  PropertyArena m_arena;
+};
+
+
+/*! \brief Property checked by a PropertyRunner.
+ * \ingroup WritingTestFixture
+ *
+ * check() draws its inputs from \a property and fails with an assertion if
+ * the property does not hold. It is called concurrently by the worker 
+ * threads of the runner.
+ */
+class CPPUNIT_API PropertyFunction
+{
+public:
+  virtual ~PropertyFunction() {}
+
+  virtual void check( PropertyCase &property ) =0;
+};
+
+
+/*! \brief PropertyFunction that calls a method of a fixture.
+ * \ingroup WritingTestFixture
+ */
+template<class Fixture>
+class PropertyMethod : public PropertyFunction
+{
+public:
+  typedef void (Fixture::*Method)( PropertyCase &property );
+
+  PropertyMethod( Fixture *fixture,
+                  Method method )
+      : m_fixture( fixture )
+      , m_method( method )
+  {
+  }
+
+  void check( PropertyCase &property )
+  {
+    (m_fixture->*m_method)( property );
+  }
+
+private:
+  Fixture *m_fixture;
+  Method m_method;
+};
+
+
+/*! \brief Checks a property on randomly generated cases.
+ * \ingroup WritingTestFixture
+ *
+ * Cases are run by batches, distributed over several threads. Case \c k of
+ * a run seeded with \c seed draws its choices from a Random seeded with
+ * Random::mix( seed, k ), so the result of a run does not depend on the 
+ * number of threads.
+ *
+ * The run stops at the end of the first batch that contains a failing case.
+ * The failing case of smallest index is shrunk: its choices are repeatedly
+ * removed and minimized as long as the property still fails. The failure is
+ * then reported with the values drawn by the shrunk case, the original 
+ * assertion failure, and the seed to set in the \c CPPUNIT_SEED environment
+ * variable to replay the run.
+ */
+class CPPUNIT_API PropertyRunner
+{
+public:
+  /*! Constructs a PropertyRunner object.
+   *
+   * The seed defaults to Random::defaultSeed(), the number of threads to
+   * ThreadGroup::processorCount().
+   * \param caseCount Number of cases to run.
+   */
+  PropertyRunner( int caseCount = 100 );
+
+  /// Destructor.
+  virtual ~PropertyRunner();
+
+  void setCaseCount( int caseCount );
+
+  int caseCount() const;
+
+  void setThreadCount( int threadCount );
+
+  int threadCount() const;
+
+  /// Sets the number of cases run between two checks for failures.
+  void setBatchSize( int batchSize );
+
+  int batchSize() const;
+
+  void setSeed( unsigned int seed );
+
+  unsigned int seed() const;
+
+  /// Sets the maximum number of cases replayed to shrink a failure.
+  void setMaximumShrinkRuns( int maximumShrinkRuns );
+
+  int maximumShrinkRuns() const;
+
+  /*! \brief Checks \a property on all the cases.
+   * \param property Property to check.
+   * \param sourceLine Location reported if the failure has none.
+   * \exception Exception if the property failed on a case.
+   */
+  void run( PropertyFunction &property,
+            const SourceLine &sourceLine = SourceLine() );
+
+  /*! \brief Shrinks the choices of a failing case.
+   * \param property Property that fails on \a choices.
+   * \param choices Choices of the failing case. 
+   * \return Number of cases replayed.
+   */
+  int shrink( PropertyFunction &property,
+              PropertyCase::Choices &choices ) const;
+
+private:
+  /// Prevents the use of the copy constructor.
+  PropertyRunner( const PropertyRunner &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const PropertyRunner &other );
+
+private:
+  int m_caseCount;
+  int m_threadCount;
+  int m_batchSize;
+  unsigned int m_seed;
+  int m_maximumShrinkRuns;
+};
+
+
+CPPUNIT_NS_END
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_EXTENSIONS_PROPERTY_H
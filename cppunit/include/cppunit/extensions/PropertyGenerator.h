@@ -0,0 +1,460 @@
+#ifndef CPPUNIT_EXTENSIONS_PROPERTYGENERATOR_H
+#define CPPUNIT_EXTENSIONS_PROPERTYGENERATOR_H
+
+#include <cppunit/extensions/Property.h>
+#include <cppunit/extensions/TestValueTraits.h>
+#include <limits.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief Generates the values of type \c T drawn by a property.
+ * \ingroup WritingTestFixture
+ *
+ * generate() builds a value from the choices drawn from a PropertyCase. To
+ * shrink well, a generator must produce simpler values from smaller choices,
+ * and must produce a valid value when all its choices are 0.
+ *
+ * Generators of composite values are written by combining other generators:
+ * \code
+ * class PointGenerator : public CppUnit::PropertyGenerator<Point>
+ * {
+ * public:
+ *   Point generate( CppUnit::PropertyCase &property ) const
+ *   {
+ *     CppUnit::IntegerGenerator<int> coordinates( -100, 100 );
+ *     int x = coordinates.generate( property );
+ *     return Point( x, coordinates.generate( property ) );
+ *   }
+ * };
+ * \endcode
+ *
+ * A property draws its inputs with draw(), which also notes them to report
+ * a counterexample (TestValueTraits<T>::toString() is used to describe 
+ * them).
+ */
+template<class T>
+class PropertyGenerator
+{
+public:
+  typedef T ValueType;
+
+  virtual ~PropertyGenerator() {}
+
+  /// Generates a value.
+  virtual T generate( PropertyCase &property ) const =0;
+
+  /// Generates a value drawn by a property, and notes it.
+  T draw( PropertyCase &property ) const
+  {
+    T value = generate( property );
+    if ( property.isNoting() )
+      property.note( TestValueTraits<T>::toString( value ) );
+    return value;
+  }
+};
+
+
+/*! \brief (Implementation) Unsigned type used to compute the ranges of an
+ *         IntegerGenerator<T>.
+ */
+template<class T>
+struct PropertyUnsignedTraits
+{
+  typedef unsigned long Type;
+
+  /// Draws a choice in [0, maximum].
+  static Type drawChoice( PropertyCase &property,
+                          Type maximum )
+  {
+    return property.drawChoice( maximum );
+  }
+};
+
+
+#if defined(ULLONG_MAX)
+/*! \brief (Implementation) Draws the choices of 64 bits integers.
+ *
+ * Where unsigned long has 32 bits (Windows, 32 bits platforms), a choice
+ * wider than 32 bits is drawn as two choices: its high bits, then its low
+ * bits. Both shrink toward 0.
+ */
+struct PropertyLongLongTraits
+{
+  typedef unsigned long long Type;
+
+  static Type drawChoice( PropertyCase &property,
+                          Type maximum )
+  {
+    if ( maximum <= ULONG_MAX )
+      return property.drawChoice( (unsigned long)maximum );
+
+    Type high = property.drawChoice( (unsigned long)(maximum >> 32) );
+    unsigned long lowMaximum = 0xffffffffUL;
+    if ( high == (maximum >> 32) )
+      lowMaximum = (unsigned long)(maximum & 0xffffffffUL);
+    return (high << 32) | property.drawChoice( lowMaximum );
+  }
+};
+
+
+template<>
+struct PropertyUnsignedTraits<long long> : public PropertyLongLongTraits
+{
+};
+
+
+template<>
+struct PropertyUnsignedTraits<unsigned long long> : public PropertyLongLongTraits
+{
+};
+#endif
+
+
+/*! \brief Generates integers in [minimum, maximum].
+ * \ingroup WritingTestFixture
+ *
+ * Integers shrink toward 0, or toward the bound closest to 0 if 0 is out of
+ * range.
+ */
+template<class T>
+class IntegerGenerator : public PropertyGenerator<T>
+{
+public:
+  IntegerGenerator( T minimum,
+                    T maximum )
+      : m_minimum( minimum )
+      , m_maximum( maximum )
+  {
+  }
+
+  T generate( PropertyCase &property ) const
+  {
+    typedef PropertyUnsignedTraits<T> Traits;
+    typedef typename Traits::Type Unsigned;
+
+    T origin = 0;
+    if ( m_minimum > T(0) )
+      origin = m_minimum;
+    else if ( !(m_maximum > T(0)  ||  m_maximum == T(0)) )
+      origin = m_maximum;
+
+    // Computed modulo the range of the unsigned type, to handle all the ranges.
+    Unsigned below = Unsigned(origin) - Unsigned(m_minimum);
+    Unsigned above = Unsigned(m_maximum) - Unsigned(origin);
+    bool negative = below > 0;
+    if ( below > 0  &&  above > 0 )
+      negative = property.drawChoice( 1 ) != 0;
+
+    Unsigned magnitude = Traits::drawChoice( property, negative ? below : above );
+    return negative ? T( Unsigned(origin) - magnitude )
+                    : T( Unsigned(origin) + magnitude );
+  }
+
+private:
+  T m_minimum;
+  T m_maximum;
+};
+
+
+/*! \brief Generates floating points in [minimum, maximum].
+ * \ingroup WritingTestFixture
+ *
+ * The range is divided in 2^32 steps. Values shrink toward 0, or toward the
+ * bound closest to 0 if 0 is out of range.
+ */
+template<class T>
+class FloatingPointGenerator : public PropertyGenerator<T>
+{
+public:
+  FloatingPointGenerator( T minimum,
+                          T maximum )
+      : m_minimum( minimum )
+      , m_maximum( maximum )
+  {
+  }
+
+  T generate( PropertyCase &property ) const
+  {
+    T origin = 0;
+    if ( m_minimum > 0 )
+      origin = m_minimum;
+    else if ( m_maximum < 0 )
+      origin = m_maximum;
+
+    double below = double(origin) - double(m_minimum);
+    double above = double(m_maximum) - double(origin);
+    bool negative = below > 0;
+    if ( below > 0  &&  above > 0 )
+      negative = property.drawChoice( 1 ) != 0;
+
+    double fraction = property.drawChoice( 0xffffffffUL ) / 4294967295.0;
+    return negative ? T( origin - fraction * below )
+                    : T( origin + fraction * above );
+  }
+
+private:
+  T m_minimum;
+  T m_maximum;
+};
+
+
+/*! \brief Generates booleans. Shrinks toward \c false.
+ * \ingroup WritingTestFixture
+ */
+class BooleanGenerator : public PropertyGenerator<bool>
+{
+public:
+  bool generate( PropertyCase &property ) const
+  {
+    return property.drawChoice( 1 ) != 0;
+  }
+};
+
+
+/*! \brief (Implementation) Draws whether a sequence has one more element.
+ *
+ * Sequences are generated element by element, each preceded by a boolean
+ * choice, rather than from a length: removing the choices of an element 
+ * while shrinking removes the element, instead of shifting the choices of
+ * the following elements.
+ */
+inline bool
+drawPropertyElement( PropertyCase &property,
+                     int size,
+                     int maximumSize )
+{
+  if ( size >= maximumSize )
+    return false;
+  // The average size is maximumSize / 2.
+  double averageSize = maximumSize / 2.0;
+  return property.drawBoolean( averageSize / (averageSize +1) );
+}
+
+
+/*! \brief Generates strings of up to maximumLength characters.
+ * \ingroup WritingTestFixture
+ *
+ * Characters are drawn from an alphabet, which defaults to the printable 
+ * ASCII characters. Strings shrink toward shorter strings made of the first
+ * character of the alphabet.
+ *
+ * The characters are drawn into the PropertyArena of the case, then copied
+ * into the string with a single heap allocation. A std::string can not keep
+ * its characters in the arena: use an ArrayGenerator of characters for
+ * properties that must not allocate from the heap.
+ */
+class StringGenerator : public PropertyGenerator<std::string>
+{
+public:
+  StringGenerator( int maximumLength,
+                   const std::string &alphabet = defaultAlphabet() )
+      : m_maximumLength( maximumLength )
+      , m_alphabet( alphabet )
+  {
+  }
+
+  std::string generate( PropertyCase &property ) const
+  {
+    char *characters = CPPUNIT_STATIC_CAST( char *, 
+        property.arena().allocate( m_maximumLength > 0 ? m_maximumLength : 1 ) );
+    int length = 0;
+    while ( drawPropertyElement( property, length, m_maximumLength ) )
+      characters[ length++ ] = m_alphabet[ property.drawChoice( m_alphabet.length() -1 ) ];
+    return std::string( characters, length );
+  }
+
+  /// Returns the printable ASCII characters, simplest first.
+  static std::string defaultAlphabet()
+  {
+    return "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"
+           " !\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~";
+  }
+
+private:
+  int m_maximumLength;
+  std::string m_alphabet;
+};
+
+
+/*! \brief Generates vectors of up to maximumSize elements.
+ * \ingroup WritingTestFixture
+ *
+ * \code
+ * CppUnit::VectorGenerator<CppUnit::IntegerGenerator<int> > values( 
+ *     CppUnit::IntegerGenerator<int>( -1000, 1000 ), 50 );
+ * std::vector<int> input = values.draw( property );
+ * \endcode
+ */
+template<class ElementGenerator>
+class VectorGenerator 
+    : public PropertyGenerator< std::vector<typename ElementGenerator::ValueType> >
+{
+public:
+  typedef typename ElementGenerator::ValueType ElementType;
+
+  VectorGenerator( const ElementGenerator &element,
+                   int maximumSize )
+      : m_element( element )
+      , m_maximumSize( maximumSize )
+  {
+  }
+
+  std::vector<ElementType> generate( PropertyCase &property ) const
+  {
+    std::vector<ElementType> values;
+    while ( drawPropertyElement( property, values.size(), m_maximumSize ) )
+      values.push_back( m_element.generate( property ) );
+    return values;
+  }
+
+private:
+  ElementGenerator m_element;
+  int m_maximumSize;
+};
+
+
+/*! \brief Generates pairs of values.
+ * \ingroup WritingTestFixture
+ *
+ * The pair itself allocates no memory: a pair of arrays generated by
+ * ArrayGenerator is allocated in the PropertyArena only.
+ */
+template<class FirstGenerator, class SecondGenerator>
+class PairGenerator 
+    : public PropertyGenerator< std::pair<typename FirstGenerator::ValueType,
+                                          typename SecondGenerator::ValueType> >
+{
+public:
+  typedef std::pair<typename FirstGenerator::ValueType,
+                    typename SecondGenerator::ValueType> PairType;
+
+  PairGenerator( const FirstGenerator &first,
+                 const SecondGenerator &second )
+      : m_first( first )
+      , m_second( second )
+  {
+  }
+
+  PairType generate( PropertyCase &property ) const
+  {
+    typename FirstGenerator::ValueType first = m_first.generate( property );
+    return PairType( first, m_second.generate( property ) );
+  }
+
+private:
+  FirstGenerator m_first;
+  SecondGenerator m_second;
+};
+
+
+/*! \brief Array allocated in the PropertyArena of a case.
+ * \ingroup WritingTestFixture
+ *
+ * Only valid during the case that generated it. The element type must not
+ * need a destructor.
+ */
+template<class T>
+struct PropertyArray
+{
+  T *m_data;
+  int m_size;
+
+  int size() const
+  {
+    return m_size;
+  }
+
+  T *begin() const
+  {
+    return m_data;
+  }
+
+  T *end() const
+  {
+    return m_data + m_size;
+  }
+
+  T &operator[]( int index ) const
+  {
+    return m_data[ index ];
+  }
+};
+
+
+/*! \brief Generates arrays of up to maximumSize elements in the case arena.
+ * \ingroup WritingTestFixture
+ *
+ * Unlike VectorGenerator, the generated arrays do not allocate memory from
+ * the heap: use it for properties run on millions of cases.
+ */
+template<class ElementGenerator>
+class ArrayGenerator 
+    : public PropertyGenerator< PropertyArray<typename ElementGenerator::ValueType> >
+{
+public:
+  typedef typename ElementGenerator::ValueType ElementType;
+
+  ArrayGenerator( const ElementGenerator &element,
+                  int maximumSize )
+      : m_element( element )
+      , m_maximumSize( maximumSize )
+  {
+  }
+
+  PropertyArray<ElementType> generate( PropertyCase &property ) const
+  {
+    PropertyArray<ElementType> values;
+    values.m_data = CPPUNIT_STATIC_CAST( ElementType *, 
+        property.arena().allocate( sizeof(ElementType) * m_maximumSize ) );
+    values.m_size = 0;
+    while ( drawPropertyElement( property, values.m_size, m_maximumSize ) )
+      values.m_data[ values.m_size++ ] = m_element.generate( property );
+    return values;
+  }
+
+private:
+  ElementGenerator m_element;
+  int m_maximumSize;
+};
+
+
+/*! \brief TestValueTraits for arrays generated in a PropertyArena.
+ */
+template<class T>
+struct TestValueTraits< PropertyArray<T> >
+{
+  static bool isEqual( const PropertyArray<T> &x, 
+                       const PropertyArray<T> &y, 
+                       double tolerance )
+  {
+    if ( x.size() != y.size() )
+      return false;
+    for ( int index =0; index < x.size(); ++index )
+    {
+      if ( !TestValueTraits<T>::isEqual( x[index], y[index], tolerance ) )
+        return false;
+    }
+    return true;
+  }
+
+  static std::string toString( const PropertyArray<T> &x )
+  {
+    return TestValueTraits< std::vector<T> >::toString( 
+        std::vector<T>( x.begin(), x.end() ) );
+  }
+
+  static void shrink( const PropertyArray<T> &, 
+                      CppUnitVector< PropertyArray<T> > & )
+  {
+  }
+};
+
+
+CPPUNIT_NS_END
+
+#endif  // CPPUNIT_EXTENSIONS_PROPERTYGENERATOR_H
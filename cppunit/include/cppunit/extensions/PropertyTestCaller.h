@@ -0,0 +1,84 @@
+#ifndef CPPUNIT_EXTENSIONS_PROPERTYTESTCALLER_H
+#define CPPUNIT_EXTENSIONS_PROPERTYTESTCALLER_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/Property.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief Test case that checks a property method of a fixture.
+ * \ingroup WritingTestFixture
+ *
+ * The property method is run by a PropertyRunner on the specified number of
+ * cases. setUp() and tearDown() are called once, around all the cases. The
+ * cases are run concurrently on the same fixture: the property method must
+ * not modify the fixture.
+ *
+ * Usually created by CPPUNIT_PROPERTY.
+ */
+template <class Fixture>
+class PropertyTestCaller : public TestCase
+{ 
+  typedef void (Fixture::*PropertyTestMethod)( PropertyCase &property );
+    
+public:
+  /*! Constructs a PropertyTestCaller. The fixture is owned by the caller.
+   * \param name Name of the test.
+   * \param test Property method checked in runTest().
+   * \param fixture Fixture to invoke the property method on.
+   * \param caseCount Number of cases checked.
+   */
+  PropertyTestCaller( std::string name, 
+                      PropertyTestMethod test, 
+                      Fixture *fixture,
+                      int caseCount ) 
+      : TestCase( name )
+      , m_fixture( fixture )
+      , m_test( test )
+      , m_caseCount( caseCount )
+  {
+  }
+
+  ~PropertyTestCaller() 
+  {
+    delete m_fixture;
+  }
+
+  void runTest()
+  { 
+    PropertyRunner runner( m_caseCount );
+    PropertyMethod<Fixture> property( m_fixture, m_test );
+    runner.run( property );
+  }  
+
+  void setUp()
+  { 
+    m_fixture->setUp(); 
+  }
+
+  void tearDown()
+  { 
+    m_fixture->tearDown(); 
+  }
+
+  std::string toString() const
+  { 
+    return "PropertyTestCaller " + getName(); 
+  }
+
+private: 
+  PropertyTestCaller( const PropertyTestCaller &other ); 
+  PropertyTestCaller &operator =( const PropertyTestCaller &other );
+
+private:
+  Fixture *m_fixture;
+  PropertyTestMethod m_test;
+  int m_caseCount;
+};
+
+
+CPPUNIT_NS_END
+
+#endif  // CPPUNIT_EXTENSIONS_PROPERTYTESTCALLER_H
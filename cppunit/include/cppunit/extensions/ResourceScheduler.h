@@ -0,0 +1,197 @@
+#ifndef CPPUNIT_EXTENSIONS_RESOURCESCHEDULER_H
+#define CPPUNIT_EXTENSIONS_RESOURCESCHEDULER_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/portability/CppUnitVector.h>
+#include <string>
+
+CPPUNIT_NS_BEGIN
+
+
+class Test;
+
+
+/*! \brief Resources required by a test while it runs.
+ * \ingroup ExecutingTest
+ *
+ * Resources are declared as a comma separated list of tags in the
+ * "resources" property of a test or a test suite:
+ * - \c exclusive:name: the test needs exclusive access to the resource
+ *   \c name (a fixed local port, a scratch file, the memory bandwidth...).
+ *   Two tests that share an exclusive resource never run concurrently.
+ * - \c cpu:n: the test keeps \c n CPUs busy (default is 1).
+ *
+ * \code
+ * CPPUNIT_TEST_SUITE_PROPERTY( "resources", "exclusive:port-8080,cpu:4" );
+ * \endcode
+ *
+ * \see ResourceScheduler.
+ */
+class CPPUNIT_API TestResources
+{
+public:
+  typedef CppUnitVector<std::string> Resources;
+
+  /*! Constructs a TestResources object that requires one CPU and no
+   *  exclusive resource.
+   */
+  TestResources();
+
+  /*! \brief Parses a resource declaration.
+   * \param declaration Comma separated list of resource tags.
+   * \return Resources declared by \a declaration.
+   * \exception std::invalid_argument if a tag is malformed.
+   */
+  static TestResources parse( const std::string &declaration );
+
+  /*! \brief Adds the resources declared by \a other.
+   *
+   * Exclusive resources are merged. The CPU weight of \a other replaces
+   * the current one if it was explicitly declared.
+   */
+  void merge( const TestResources &other );
+
+  void addExclusiveResource( const std::string &resource );
+
+  bool usesExclusiveResource( const std::string &resource ) const;
+
+  const Resources &exclusiveResources() const;
+
+  void setCpuWeight( int weight );
+
+  int cpuWeight() const;
+
+  /*! \brief Tests if the two tests can not run concurrently.
+   * \return \c true if both tests need exclusive access to a same resource.
+   */
+  bool conflictsWith( const TestResources &other ) const;
+
+private:
+  Resources m_exclusiveResources;
+  int m_cpuWeight;
+  bool m_hasCpuWeight;
+};
+
+
+/*! \brief Packs tests into batches that can run concurrently.
+ * \ingroup ExecutingTest
+ *
+ * The scheduler flattens the test hierarchy into its test cases. Each test
+ * case inherits the resources declared by its parent suites (see
+ * TestResources). A test whose child tests can not be run separately, such
+ * as a TestSetUp decorator (see Test::canRunChildTestsSeparately()), is
+ * scheduled as a whole: it needs the exclusive resources of all its
+ * descendants, and the largest of their CPU weights.
+ *
+ * Test cases are then packed into batches with a first-fit strategy: within
+ * a batch, no two tests share an exclusive resource, and the sum of their
+ * CPU weights does not exceed the number of available CPUs. A test whose
+ * weight exceeds the number of CPUs gets a batch of its own. A parallel runner
+ * can run all the tests of a batch concurrently, then move on to the next
+ * batch.
+ *
+ * For runners that distribute tests over several processes, makeShards()
+ * keeps all the tests that share an exclusive resource, directly or
+ * transitively, in the same shard, where they are run sequentially.
+ *
+ * \code
+ * CppUnit::ResourceScheduler scheduler( 8 );
+ * scheduler.addTest( CppUnit::TestFactoryRegistry::getRegistry().makeTest() );
+ * for ( int index =0; index < scheduler.getBatchCount(); ++index )
+ *   runConcurrently( scheduler.getBatchAt( index ) );
+ * \endcode
+ */
+class CPPUNIT_API ResourceScheduler
+{
+public:
+  typedef CppUnitVector<Test *> Tests;
+
+  /*! Constructs a ResourceScheduler object.
+   * \param cpuCount Number of CPUs available to run the tests. Must be > 0.
+   */
+  ResourceScheduler( int cpuCount );
+
+  /// Destructor.
+  virtual ~ResourceScheduler();
+
+  /*! \brief Schedules the test cases of the specified test.
+   *
+   * The test is not owned by the scheduler.
+   * \param test Test to schedule. Its test cases are added to the batches.
+   * \exception std::invalid_argument if a "resources" property is malformed.
+   */
+  void addTest( Test *test );
+
+  /// Returns the number of CPUs available to run the tests.
+  int cpuCount() const;
+
+  /// Returns the number of scheduled test cases.
+  int getTestCount() const;
+
+  /// Returns the scheduled test case of the specified index.
+  Test *getTestAt( int index ) const;
+
+  /// Returns the resources of the scheduled test case of the specified index.
+  const TestResources &getResourcesAt( int index ) const;
+
+  /// Returns the number of batches.
+  int getBatchCount() const;
+
+  /*! \brief Returns the tests of the specified batch.
+   * \param index Zero based index of the batch.
+   */
+  const Tests &getBatchAt( int index ) const;
+
+  /*! \brief Distributes the scheduled tests over several processes.
+   *
+   * Tests sharing exclusive resources are assigned to the same shard. Groups
+   * of tests are assigned, heaviest first, to the least loaded shard.
+   * \param shardCount Number of shards. Must be > 0.
+   * \return \a shardCount lists of tests. Within a shard, tests keep the order
+   *         in which they were added.
+   */
+  CppUnitVector<Tests> makeShards( int shardCount ) const;
+
+private:
+  struct Batch
+  {
+    Tests m_tests;
+    CppUnitVector<int> m_testIndexes;
+    int m_cpuWeight;
+  };
+
+  void addTest( Test *test,
+                const TestResources &inheritedResources );
+
+  void scheduleTest( int testIndex );
+
+  bool canAddToBatch( const Batch &batch,
+                      int testIndex ) const;
+
+  /// Prevents the use of the copy constructor.
+  ResourceScheduler( const ResourceScheduler &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const ResourceScheduler &other );
+
+private:
+  int m_cpuCount;
+  Tests m_tests;
+  CppUnitVector<TestResources> m_resources;
+  CppUnitVector<Batch> m_batches;
+};
+
+
+CPPUNIT_NS_END
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_EXTENSIONS_RESOURCESCHEDULER_H
@@ -0,0 +1,170 @@
+#ifndef CPPUNIT_EXTENSIONS_SNAPSHOT_H
+#define CPPUNIT_EXTENSIONS_SNAPSHOT_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/Message.h>
+#include <cppunit/SourceLine.h>
+#include <stddef.h>
+#include <string>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief Directory of the golden files compared by snapshot assertions.
+ * \ingroup Assertions
+ *
+ * The snapshot named \c name is stored in the file <tt>directory/name</tt>.
+ * The name may contain '/' to organize the snapshots in sub-directories.
+ *
+ * Golden files are memory-mapped and compared by blocks with memcmp(), 
+ * which the C library vectorizes. On mismatch, the failure shows the first
+ * difference with a few lines of context (or a hexadecimal dump for binary
+ * data), never the whole content.
+ *
+ * In update mode, a missing or different snapshot is rewritten with the
+ * actual data instead of failing. The file is written under a temporary 
+ * name unique to the process and the thread, then renamed over the golden
+ * file, so that concurrent runs never produce a partially written snapshot.
+ *
+ * The default store uses the directory given by the environment variable
+ * \c CPPUNIT_SNAPSHOT_DIR (\c snapshots if it is not set), and is in update 
+ * mode if the environment variable \c CPPUNIT_UPDATE_SNAPSHOTS is set to a
+ * value other than 0 (DllPlugInTester also has an \c --update-snapshots 
+ * option).
+ *
+ * \see CPPUNIT_ASSERT_MATCHES_SNAPSHOT.
+ */
+class CPPUNIT_API SnapshotStore
+{
+public:
+  /*! Constructs a SnapshotStore object.
+   * \param directory Directory of the golden files.
+   */
+  SnapshotStore( const std::string &directory = defaultDirectory() );
+
+  /// Destructor.
+  virtual ~SnapshotStore();
+
+  /// Returns the store used by the snapshot assertions.
+  static SnapshotStore &getStore();
+
+  void setDirectory( const std::string &directory );
+
+  std::string directory() const;
+
+  /// Sets whether mismatching snapshots are rewritten instead of failing.
+  void setUpdateMode( bool updateMode );
+
+  bool isUpdateMode() const;
+
+  /// Returns the path of the golden file of the specified snapshot.
+  std::string pathFor( const std::string &name ) const;
+
+  /*! \brief Compares data to a snapshot.
+   *
+   * In update mode, a missing or mismatching snapshot is rewritten.
+   * \param name Name of the snapshot.
+   * \param data Actual data.
+   * \param size Size of the actual data, in bytes.
+   * \param failure Set to the description of the mismatch.
+   * \return \c true if the data matches the snapshot, or if the snapshot was
+   *         updated.
+   * \exception std::runtime_error if the snapshot exists but could not be
+   *            read.
+   */
+  bool check( const std::string &name,
+              const void *data,
+              size_t size,
+              Message &failure ) const;
+
+  /*! \brief Writes a snapshot atomically.
+   *
+   * Creates the directories of the golden file if needed.
+   * \exception std::runtime_error if the file could not be written.
+   */
+  void write( const std::string &name,
+              const void *data,
+              size_t size ) const;
+
+  /// Returns the directory of the default store.
+  static std::string defaultDirectory();
+
+  /*! \brief Returns the index of the first differing byte of two buffers.
+   * \return \a size if the buffers are equal.
+   */
+  static size_t findFirstDifference( const unsigned char *expected,
+                                     const unsigned char *actual,
+                                     size_t size );
+
+private:
+  /// Prevents the use of the copy constructor.
+  SnapshotStore( const SnapshotStore &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const SnapshotStore &other );
+
+private:
+  std::string m_directory;
+  bool m_updateMode;
+};
+
+
+/*! \brief (Implementation) Asserts that data matches a snapshot.
+ * \ingroup Assertions
+ * \sa CPPUNIT_ASSERT_MATCHES_SNAPSHOT.
+ */
+void CPPUNIT_API assertMatchesSnapshot( const std::string &name,
+                                        const void *data,
+                                        size_t size,
+                                        SourceLine sourceLine,
+                                        const std::string &message = "" );
+
+/*! \brief (Implementation) Asserts that a string matches a snapshot.
+ * \ingroup Assertions
+ * \sa CPPUNIT_ASSERT_MATCHES_SNAPSHOT.
+ */
+void CPPUNIT_API assertMatchesSnapshot( const std::string &name,
+                                        const std::string &data,
+                                        SourceLine sourceLine,
+                                        const std::string &message = "" );
+
+
+/*! \brief Asserts that a string matches the golden file of a snapshot.
+ * \ingroup Assertions
+ *
+ * \code
+ * CPPUNIT_ASSERT_MATCHES_SNAPSHOT( "serializer/order.json", 
+ *                                  serializer.toJson( order ) );
+ * \endcode
+ * \see SnapshotStore.
+ */
+#define CPPUNIT_ASSERT_MATCHES_SNAPSHOT( name, data )             \
+  ( CPPUNIT_NS::assertMatchesSnapshot( (name),                    \
+                                       (data),                    \
+                                       CPPUNIT_SOURCELINE() ) )
+
+/*! \brief Asserts that a buffer matches the golden file of a snapshot.
+ * \ingroup Assertions
+ * \see CPPUNIT_ASSERT_MATCHES_SNAPSHOT.
+ */
+#define CPPUNIT_ASSERT_MATCHES_SNAPSHOT_BUFFER( name, data, size ) \
+  ( CPPUNIT_NS::assertMatchesSnapshot( (name),                    \
+                                       (data),                    \
+                                       (size),                    \
+                                       CPPUNIT_SOURCELINE() ) )
+
+
+CPPUNIT_NS_END
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_EXTENSIONS_SNAPSHOT_H
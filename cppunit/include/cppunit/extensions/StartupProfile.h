@@ -0,0 +1,167 @@
+#ifndef CPPUNIT_EXTENSIONS_STARTUPPROFILE_H
+#define CPPUNIT_EXTENSIONS_STARTUPPROFILE_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/portability/CppUnitMap.h>
+#include <cppunit/portability/CppUnitVector.h>
+#include <cppunit/portability/Stream.h>
+#include <string>
+#include <utility>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief Time spent before the first test runs, phase by phase.
+ * \ingroup ExecutingTest
+ *
+ * When the shared profile is enabled, the framework records:
+ * - the loading of each test plug-in by PlugInManager::load(): opening the
+ *   library (including its static constructors, which register the suites)
+ *   and initializing the plug-in;
+ * - each suite factory called by TestFactoryRegistry::makeTest(), which
+ *   constructs the fixture of each test. The time of a factory excludes the
+ *   time of the factories it calls, so a registry nested in another one
+ *   does not hide its slowest fixtures;
+ * - the selection of the tests to run by TestRunner.
+ *
+ * \code
+ * CppUnit::StartupProfile &profile = CppUnit::StartupProfile::getProfile();
+ * profile.setEnabled( true );
+ * runner.addTest( CppUnit::TestFactoryRegistry::getRegistry().makeTest() );
+ * runner.run( controller );
+ * profile.write( CppUnit::stdCOut() );
+ * \endcode
+ *
+ * The profile is not synchronized: the tests are expected to be set up by a
+ * single thread.
+ */
+class CPPUNIT_API StartupProfile
+{
+public:
+  /// Constructs an empty, disabled profile.
+  StartupProfile();
+
+  /// Destructor.
+  virtual ~StartupProfile();
+
+  /// Returns the profile the framework records to.
+  static StartupProfile &getProfile();
+
+  /// Enables or disables the recording (disabled by default).
+  void setEnabled( bool enabled );
+
+  bool isEnabled() const;
+
+  /*! \brief Adds the time of a startup phase.
+   *
+   * The time is added to the phase of the same name if there is one.
+   * Ignored if the profile is disabled.
+   */
+  void addPhaseTime( const std::string &phase,
+                     double seconds );
+
+  /*! \brief Starts timing a suite factory.
+   *
+   * Must be followed by a call to exitFactory(). Factories called in between
+   * are timed separately. Ignored if the profile is disabled.
+   */
+  void enterFactory();
+
+  /*! \brief Stops timing the suite factory started by the last enterFactory().
+   * \param registryName Name of the registry the factory is registered in.
+   * \param suiteName Name of the suite made by the factory.
+   */
+  void exitFactory( const std::string &registryName,
+                    const std::string &suiteName );
+
+  /*! \brief Stops timing the suite factory started by the last enterFactory()
+   *         without recording it.
+   *
+   * Called instead of exitFactory() when the factory throws.
+   */
+  void abandonFactory();
+
+  /// Tests if a suite factory is being timed.
+  bool isTimingFactory() const;
+
+  /// Removes all the recorded times. Does not change isEnabled().
+  void reset();
+
+  int phaseCount() const;
+
+  std::string phaseNameAt( int index ) const;
+
+  double phaseSecondsAt( int index ) const;
+
+  /// Returns the number of timed factories, in order of first call.
+  int factoryCount() const;
+
+  std::string factoryRegistryAt( int index ) const;
+
+  std::string factorySuiteAt( int index ) const;
+
+  /// Returns the time of a factory, excluding the factories it called.
+  double factorySecondsAt( int index ) const;
+
+  /// Returns the time of all the factories of a registry.
+  double registrySeconds( const std::string &registryName ) const;
+
+  /// Returns the time of all the phases, in seconds.
+  double totalSeconds() const;
+
+  /*! \brief Writes the phases, the time of each registry and the slowest
+   *         suite factories.
+   * \param stream Stream to write to.
+   * \param maximumFactoryCount Largest number of suite factories written.
+   */
+  void write( OStream &stream,
+              int maximumFactoryCount = 10 ) const;
+
+private:
+  /// Prevents the use of the copy constructor.
+  StartupProfile( const StartupProfile &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const StartupProfile &other );
+
+private:
+  struct Factory
+  {
+    std::string m_registryName;
+    std::string m_suiteName;
+    double m_seconds;
+  };
+
+  /// Factory being timed.
+  struct TimedFactory
+  {
+    double m_startTime;
+    double m_calledSeconds;
+  };
+
+  typedef std::pair<std::string, std::string> FactoryKey;
+  typedef CppUnitMap<FactoryKey, int, std::less<FactoryKey> > FactoryIndexes;
+
+  bool m_enabled;
+  CppUnitVector<std::string> m_phaseNames;
+  CppUnitVector<double> m_phaseSeconds;
+  CppUnitVector<Factory> m_factories;
+  FactoryIndexes m_factoryIndexes;
+  CppUnitVector<TimedFactory> m_timedFactories;
+};
+
+
+CPPUNIT_NS_END
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_EXTENSIONS_STARTUPPROFILE_H
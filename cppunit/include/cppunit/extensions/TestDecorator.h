@@ -32,6 +32,9 @@ public:
 
   int getChildTestCount() const;
 
+  /// Returns \c false: the child tests are run through the decorator.
+  bool canRunChildTestsSeparately() const;
+
 protected:
   Test *doGetChildTestAt( int index ) const;
 
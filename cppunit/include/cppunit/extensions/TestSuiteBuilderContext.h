@@ -46,6 +46,16 @@ public:
    */
   void addTest( Test *test );
 
+  /*! \brief Adds a test with some tags to the fixture suite.
+   *
+   * The tags are stored in the "tags" property of the test.
+   * \param test Test to add to the fixture suite. Must not be \c NULL.
+   * \param tags Comma separated list of tags.
+   * \see CPPUNIT_TEST_TAGS.
+   */
+  void addTaggedTest( Test *test,
+                      const std::string &tags );
+
   /*! \brief Returns the fixture name.
    * \return Fixture name. It is the name used to name the fixture
    *         suite.
@@ -63,6 +73,10 @@ public:
   std::string getTestNameFor( const std::string &testMethodName ) const;
 
   /*! \brief Adds property pair.
+   *
+   * The property is also set on the fixture suite (see Test::setProperty()),
+   * so that it can be retrieved once the suite has been built.
+   *
    * \param key   PropertyKey string to add.
    * \param value PropertyValue string to add.
    */
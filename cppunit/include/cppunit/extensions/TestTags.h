@@ -0,0 +1,357 @@
+#ifndef CPPUNIT_EXTENSIONS_TESTTAGS_H
+#define CPPUNIT_EXTENSIONS_TESTTAGS_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/TestComposite.h>
+#include <cppunit/portability/CppUnitMap.h>
+#include <cppunit/portability/CppUnitVector.h>
+#include <string>
+
+CPPUNIT_NS_BEGIN
+
+
+class TestSelection;
+class TestSelectionFilter;
+
+
+/*! \brief Compact set of small integers, stored as a bitset.
+ * \ingroup ExecutingTest
+ *
+ * A TagSet is used to store the tags of a test (bit \c n is set if the test
+ * has the tag of index \c n in the TagDictionary), and the tests that have a
+ * given tag (bit \c n is set if the test of index \c n in the TaggedTestIndex
+ * has the tag).
+ */
+class CPPUNIT_API TagSet
+{
+public:
+  /// Constructs an empty set.
+  TagSet();
+
+  /// Adds \a index to the set. \a index must be >= 0.
+  void insert( int index );
+
+  /// Tests if \a index is in the set.
+  bool contains( int index ) const;
+
+  /// Tests if the set is empty.
+  bool isEmpty() const;
+
+  /// Returns the number of elements in the set.
+  int count() const;
+
+  /// Adds all the elements of \a other to the set (bitwise or).
+  void merge( const TagSet &other );
+
+  /// Keeps only the elements that are also in \a other (bitwise and).
+  void intersect( const TagSet &other );
+
+  /// Replaces the set by its complement in [0, \a size[ (bitwise not).
+  void complement( int size );
+
+  bool operator ==( const TagSet &other ) const;
+
+private:
+  typedef CppUnitVector<unsigned long> Words;
+  Words m_words;
+};
+
+
+/*! \brief Interns the tag names into small integers.
+ * \ingroup ExecutingTest
+ *
+ * Tags are declared as a comma separated list in the "tags" property of a
+ * test or a test suite (see CPPUNIT_TEST_TAGS and CPPUNIT_TEST_SUITE_TAGS).
+ * Each distinct tag name is given an index, used as a bit index in TagSet.
+ */
+class CPPUNIT_API TagDictionary
+{
+public:
+  /// Constructs an empty dictionary.
+  TagDictionary();
+
+  /// Destructor.
+  virtual ~TagDictionary();
+
+  /// Returns the dictionary shared by all the tests.
+  static TagDictionary &getDictionary();
+
+  /*! \brief Returns the index of the specified tag, adding it if needed.
+   * \param tag Name of the tag. Leading and trailing spaces are ignored.
+   * \exception std::invalid_argument if \a tag is not a valid tag name.
+   */
+  int intern( const std::string &tag );
+
+  /*! \brief Returns the index of the specified tag.
+   * \return Index of the tag, -1 if the tag was never interned.
+   */
+  int find( const std::string &tag ) const;
+
+  /// Returns the number of interned tags.
+  int getTagCount() const;
+
+  /// Returns the name of the tag of the specified index.
+  std::string getTagAt( int index ) const;
+
+  /*! \brief Interns a comma separated list of tags.
+   * \exception std::invalid_argument if a tag name is not valid.
+   */
+  TagSet parse( const std::string &tags );
+
+  /*! \brief Tests if \a tag is a valid tag name.
+   *
+   * A tag name is made of letters, digits, '_', '-', '.' and ':'.
+   */
+  static bool isValidTag( const std::string &tag );
+
+private:
+  /// Prevents the use of the copy constructor.
+  TagDictionary( const TagDictionary &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const TagDictionary &other );
+
+private:
+  typedef CppUnitMap<std::string, int, std::less<std::string> > Indexes;
+  Indexes m_indexes;
+  CppUnitVector<std::string> m_tags;
+};
+
+
+/*! \brief Boolean expression over test tags.
+ * \ingroup ExecutingTest
+ *
+ * The expression grammar is:
+ * \code
+ * expression := term { '|' term }
+ * term       := factor { '&' factor }
+ * factor     := '!' factor  |  '(' expression ')'  |  tag
+ * \endcode
+ *
+ * For example, <tt>perf & !slow</tt> selects the tests tagged \c perf that
+ * are not tagged \c slow.
+ *
+ * The expression is compiled into a postfix program when constructed. Tag
+ * names are resolved against the TagDictionary when the expression is
+ * evaluated: a tag that no test declares matches no test.
+ */
+class CPPUNIT_API TagExpression
+{
+public:
+  /*! \brief Compiles the specified expression.
+   * \exception std::invalid_argument if \a expression is malformed.
+   */
+  TagExpression( const std::string &expression );
+
+  /// Destructor.
+  virtual ~TagExpression();
+
+  /// Returns the expression string.
+  std::string expression() const;
+
+  /*! \brief Tests if a test having the specified tags matches the expression.
+   * \param tags Tags of the test.
+   * \param dictionary Dictionary used to intern the tags.
+   */
+  bool matches( const TagSet &tags,
+                const TagDictionary &dictionary =
+                    TagDictionary::getDictionary() ) const;
+
+  /*! \brief Evaluates the expression on a whole list of tests.
+   *
+   * The expression is evaluated with bitwise operations on the columns of
+   * \a testsByTag: each instruction processes all the tests at once.
+   *
+   * \param testsByTag For each tag index, the set of the indexes of the tests
+   *                   that have the tag.
+   * \param testCount Number of tests.
+   * \param dictionary Dictionary used to intern the tags.
+   * \return Set of the indexes of the tests that match the expression.
+   */
+  TagSet select( const CppUnitVector<TagSet> &testsByTag,
+                 int testCount,
+                 const TagDictionary &dictionary =
+                     TagDictionary::getDictionary() ) const;
+
+private:
+  enum Operation
+  {
+    pushTag = 0,
+    notOperation,
+    andOperation,
+    orOperation
+  };
+
+  struct Instruction
+  {
+    Operation m_operation;
+    std::string m_tag;
+  };
+
+  void parseExpression( unsigned int &position );
+  void parseTerm( unsigned int &position );
+  void parseFactor( unsigned int &position );
+  void skipSpaces( unsigned int &position ) const;
+  void addInstruction( Operation operation,
+                       const std::string &tag = "" );
+  void fail( const std::string &message ) const;
+
+private:
+  std::string m_expression;
+  CppUnitVector<Instruction> m_program;
+};
+
+
+/*! \brief Flattened list of test cases with their tags.
+ * \ingroup ExecutingTest
+ *
+ * Each test case inherits the tags declared by its parent suites. The tags of
+ * each test are stored as a TagSet, and for each tag, the set of tests having
+ * that tag is kept, so that a TagExpression is evaluated for all the tests with
+ * a few bitwise operations.
+ *
+ * \code
+ * CppUnit::TaggedTestIndex index;
+ * index.addTest( CppUnit::TestFactoryRegistry::getRegistry().makeTest() );
+ * CppUnit::TestSelection selection( "perf" );
+ * index.select( CppUnit::TagExpression( "perf & !slow" ), selection );
+ * \endcode
+ */
+class CPPUNIT_API TaggedTestIndex
+{
+public:
+  /*! Constructs an empty index.
+   * \param dictionary Dictionary used to intern the tags.
+   */
+  TaggedTestIndex( TagDictionary &dictionary = TagDictionary::getDictionary() );
+
+  /// Destructor.
+  virtual ~TaggedTestIndex();
+
+  /*! \brief Adds the test cases of the specified test.
+   *
+   * The test is not owned by the index.
+   * \exception std::invalid_argument if a "tags" property is malformed.
+   */
+  void addTest( Test *test );
+
+  /// Returns the number of test cases.
+  int getTestCount() const;
+
+  /// Returns the test case of the specified index.
+  Test *getTestAt( int index ) const;
+
+  /// Returns the tags, including inherited ones, of the specified test case.
+  const TagSet &getTagsAt( int index ) const;
+
+  /// Returns the set of the indexes of the tests that match \a expression.
+  TagSet select( const TagExpression &expression ) const;
+
+  /*! \brief Adds the tests that match \a expression to \a selection.
+   *
+   * The largest subtrees whose test cases all match are added, so that their
+   * decorators and suites are kept. See TestSelection for the subtrees of
+   * which only some test cases match.
+   * \return Number of matching test cases.
+   */
+  int select( const TagExpression &expression,
+              TestSelection &selection ) const;
+
+private:
+  void addTest( Test *test,
+                const TagSet &inheritedTags );
+
+  void selectTests( Test *test,
+                    const TagSet &selected,
+                    int &testIndex,
+                    bool isInSelectedTest,
+                    TestSelection &selection ) const;
+
+  /// Prevents the use of the copy constructor.
+  TaggedTestIndex( const TaggedTestIndex &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const TaggedTestIndex &other );
+
+private:
+  TagDictionary &m_dictionary;
+  CppUnitVector<Test *> m_roots;
+  CppUnitVector<Test *> m_tests;
+  CppUnitVector<TagSet> m_tags;
+  CppUnitVector<TagSet> m_testsByTag;
+};
+
+
+/*! \brief Composite that runs tests it does not own.
+ * \ingroup ExecutingTest
+ *
+ * Used to run the tests selected by a TaggedTestIndex. A selected test is run
+ * as a whole, with its decorators. When only some of the test cases of a test
+ * that can not run its child tests separately (a TestSetUp, a RepeatedTest...)
+ * are selected, that test is selected and the other ones are excluded: the
+ * selection replaces it by a filter, a child test that can not run its child
+ * tests separately either. The filter runs the test with a TestResult that
+ * skips the excluded tests, and only forwards the events of the other ones.
+ * The runners that split the selection (ResourceScheduler,
+ * DistributedCoordinator) run the filter as a whole, so the exclusions only
+ * apply to the tests run through the selection.
+ *
+ * The tests must outlive the selection.
+ */
+class CPPUNIT_API TestSelection : public TestComposite
+{
+public:
+  TestSelection( const std::string &name = "" );
+
+  /// Destructor. Deletes the filters.
+  ~TestSelection();
+
+  /// Adds a test. The test is not owned by the selection.
+  void addTest( Test *test );
+
+  /*! \brief Excludes a descendant of a test of the selection.
+   *
+   * The first time a descendant of a test is excluded, the test is replaced
+   * by a filter. Ignored if \a test is not a descendant of a test of the
+   * selection. Selections are expected to be built before the tests are run.
+   */
+  void excludeTest( Test *test );
+
+  /// Tests if \a test or one of its parents is excluded by this selection.
+  bool isExcluded( const Test *test ) const;
+
+  int getChildTestCount() const;
+
+protected:
+  Test *doGetChildTestAt( int index ) const;
+
+private:
+  /// Prevents the use of the copy constructor.
+  TestSelection( const TestSelection &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const TestSelection &other );
+
+private:
+  /// Added tests.
+  CppUnitVector<Test *> m_addedTests;
+  /// Child tests: the added tests, or their filter.
+  CppUnitVector<Test *> m_tests;
+  /// Filter of each added test, \c NULL if none of its descendants is excluded.
+  CppUnitVector<TestSelectionFilter *> m_filters;
+};
+
+
+CPPUNIT_NS_END
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_EXTENSIONS_TESTTAGS_H
@@ -0,0 +1,313 @@
+#ifndef CPPUNIT_EXTENSIONS_TESTVALUETRAITS_H
+#define CPPUNIT_EXTENSIONS_TESTVALUETRAITS_H
+
+#include <cppunit/TestAssert.h>
+#include <cppunit/portability/CppUnitVector.h>
+#include <math.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief Traits used to compare, print and shrink the values of randomized
+ *         tests.
+ * \ingroup WritingTestFixture
+ *
+ * shrink() adds to \a candidates values that are "simpler" than \a value,
+ * simplest first. It is used to minimize an input that makes a test fail:
+ * the candidates are tried in turn, and the first one that still fails
+ * replaces the input. Shrinking must converge: a candidate must never shrink
+ * back to the value it was produced from.
+ *
+ * The default implementation compares and prints the values using
+ * assertion_traits, and does not shrink them. Specializations are provided
+ * for integers, floating points, std::string and std::vector.
+ *
+ * \code
+ * template<>
+ * struct TestValueTraits<Point>
+ * {
+ *   static bool isEqual( const Point &x, const Point &y, double )
+ *   {
+ *     return x == y;
+ *   }
+ *
+ *   static std::string toString( const Point &x )
+ *   {
+ *     return "(" + TestValueTraits<int>::toString( x.m_x ) + ", " + 
+ *            TestValueTraits<int>::toString( x.m_y ) + ")";
+ *   }
+ *
+ *   static void shrink( const Point &x, CppUnitVector<Point> &candidates )
+ *   {
+ *     if ( x.m_x != 0  ||  x.m_y != 0 )
+ *       candidates.push_back( Point( 0, 0 ) );
+ *   }
+ * };
+ * \endcode
+ */
+template<class T>
+struct TestValueTraits
+{
+  /// Compares two values. \a tolerance is only used by floating points.
+  static bool isEqual( const T &x, const T &y, double )
+  {
+    return assertion_traits<T>::equal( x, y );
+  }
+
+  static std::string toString( const T &x )
+  {
+    return assertion_traits<T>::toString( x );
+  }
+
+  static void shrink( const T &, CppUnitVector<T> & )
+  {
+  }
+};
+
+
+/*! \brief (Implementation) TestValueTraits for integer types.
+ *
+ * Integers shrink toward 0.
+ */
+template<class T>
+struct IntegerTestValueTraits
+{
+  static bool isEqual( T x, T y, double )
+  {
+    return x == y;
+  }
+
+  static std::string toString( T x )
+  {
+    return assertion_traits<T>::toString( x );
+  }
+
+  static void shrink( T x, CppUnitVector<T> &candidates )
+  {
+    if ( x == 0 )
+      return;
+    candidates.push_back( 0 );
+    T half = x / 2;
+    if ( half != 0 )
+      candidates.push_back( half );
+    T closer = x > 0 ? T(x -1) : T(x +1);
+    if ( closer != 0  &&  closer != half )
+      candidates.push_back( closer );
+  }
+};
+
+
+template<> struct TestValueTraits<char> : IntegerTestValueTraits<char> {};
+template<> struct TestValueTraits<short> : IntegerTestValueTraits<short> {};
+template<> struct TestValueTraits<int> : IntegerTestValueTraits<int> {};
+template<> struct TestValueTraits<long> : IntegerTestValueTraits<long> {};
+template<> struct TestValueTraits<unsigned char> : IntegerTestValueTraits<unsigned char> {};
+template<> struct TestValueTraits<unsigned short> : IntegerTestValueTraits<unsigned short> {};
+template<> struct TestValueTraits<unsigned int> : IntegerTestValueTraits<unsigned int> {};
+template<> struct TestValueTraits<unsigned long> : IntegerTestValueTraits<unsigned long> {};
+
+
+/*! \brief (Implementation) TestValueTraits for floating point types.
+ *
+ * Two values are equal if they differ by at most the tolerance, or if they
+ * are both NaN. Floating points shrink toward 0, then toward integers.
+ */
+template<class T>
+struct FloatingPointTestValueTraits
+{
+  static bool isEqual( T x, T y, double tolerance )
+  {
+    if ( x != x  ||  y != y )   // NaN
+      return x != x  &&  y != y;
+    if ( x == y )               // also handles infinities
+      return true;
+    return fabs( double(x) - double(y) ) <= tolerance;
+  }
+
+  static std::string toString( T x )
+  {
+    return assertion_traits<double>::toString( x );
+  }
+
+  static void shrink( T x, CppUnitVector<T> &candidates )
+  {
+    if ( x == 0  ||  x != x )
+      return;
+    candidates.push_back( 0 );
+    T truncated = T( x < 0 ? ceil( double(x) ) : floor( double(x) ) );
+    if ( truncated != x  &&  truncated != 0 )
+      candidates.push_back( truncated );
+    T half = x / 2;
+    if ( half != x  &&  half != 0  &&  truncated == x )
+      candidates.push_back( T( x < 0 ? ceil( double(half) ) : floor( double(half) ) ) );
+  }
+};
+
+
+template<> struct TestValueTraits<float> : FloatingPointTestValueTraits<float> {};
+template<> struct TestValueTraits<double> : FloatingPointTestValueTraits<double> {};
+
+
+template<>
+struct TestValueTraits<bool>
+{
+  static bool isEqual( bool x, bool y, double )
+  {
+    return x == y;
+  }
+
+  static std::string toString( bool x )
+  {
+    return x ? "true" : "false";
+  }
+
+  static void shrink( bool x, CppUnitVector<bool> &candidates )
+  {
+    if ( x )
+      candidates.push_back( false );
+  }
+};
+
+
+/*! \brief TestValueTraits for strings.
+ *
+ * Strings shrink by removing their halves, then one character at a time.
+ */
+template<>
+struct TestValueTraits<std::string>
+{
+  static bool isEqual( const std::string &x, const std::string &y, double )
+  {
+    return x == y;
+  }
+
+  static std::string toString( const std::string &x )
+  {
+    return "\"" + x + "\"";
+  }
+
+  static void shrink( const std::string &x, CppUnitVector<std::string> &candidates )
+  {
+    if ( x.empty() )
+      return;
+    candidates.push_back( std::string() );
+    if ( x.length() > 1 )
+    {
+      candidates.push_back( x.substr( 0, x.length() / 2 ) );
+      candidates.push_back( x.substr( x.length() / 2 ) );
+      for ( unsigned int index =0; index < x.length(); ++index )
+        candidates.push_back( x.substr( 0, index ) + x.substr( index +1 ) );
+    }
+  }
+};
+
+
+/*! \brief TestValueTraits for vectors.
+ *
+ * Vectors shrink by removing their halves, then one element at a time, then
+ * by shrinking their elements.
+ */
+template<class T>
+struct TestValueTraits< std::vector<T> >
+{
+  typedef std::vector<T> Values;
+
+  static bool isEqual( const Values &x, const Values &y, double tolerance )
+  {
+    if ( x.size() != y.size() )
+      return false;
+    for ( unsigned int index =0; index < x.size(); ++index )
+    {
+      if ( !TestValueTraits<T>::isEqual( x[index], y[index], tolerance ) )
+        return false;
+    }
+    return true;
+  }
+
+  static std::string toString( const Values &x )
+  {
+    std::string text = "[";
+    for ( unsigned int index =0; index < x.size(); ++index )
+    {
+      if ( index > 0 )
+        text += ", ";
+      text += TestValueTraits<T>::toString( x[index] );
+    }
+    return text + "]";
+  }
+
+  static void shrink( const Values &x, CppUnitVector<Values> &candidates )
+  {
+    if ( x.empty() )
+      return;
+    candidates.push_back( Values() );
+    if ( x.size() > 1 )
+    {
+      candidates.push_back( Values( x.begin(), x.begin() + x.size() / 2 ) );
+      candidates.push_back( Values( x.begin() + x.size() / 2, x.end() ) );
+      for ( unsigned int removedIndex =0; removedIndex < x.size(); ++removedIndex )
+      {
+        Values candidate( x );
+        candidate.erase( candidate.begin() + removedIndex );
+        candidates.push_back( candidate );
+      }
+    }
+
+    for ( unsigned int shrunkIndex =0; shrunkIndex < x.size(); ++shrunkIndex )
+    {
+      CppUnitVector<T> elements;
+      TestValueTraits<T>::shrink( x[shrunkIndex], elements );
+      for ( unsigned int elementIndex =0; elementIndex < elements.size(); ++elementIndex )
+      {
+        Values candidate( x );
+        candidate[shrunkIndex] = elements[elementIndex];
+        candidates.push_back( candidate );
+      }
+    }
+  }
+};
+
+
+/*! \brief TestValueTraits for pairs.
+ *
+ * Pairs shrink by shrinking their first value, then their second value.
+ */
+template<class First, class Second>
+struct TestValueTraits< std::pair<First, Second> >
+{
+  typedef std::pair<First, Second> Pair;
+
+  static bool isEqual( const Pair &x, const Pair &y, double tolerance )
+  {
+    return TestValueTraits<First>::isEqual( x.first, y.first, tolerance )  &&
+           TestValueTraits<Second>::isEqual( x.second, y.second, tolerance );
+  }
+
+  static std::string toString( const Pair &x )
+  {
+    return "(" + TestValueTraits<First>::toString( x.first ) + ", " + 
+           TestValueTraits<Second>::toString( x.second ) + ")";
+  }
+
+  static void shrink( const Pair &x, CppUnitVector<Pair> &candidates )
+  {
+    CppUnitVector<First> firsts;
+    TestValueTraits<First>::shrink( x.first, firsts );
+    for ( unsigned int firstIndex =0; firstIndex < firsts.size(); ++firstIndex )
+      candidates.push_back( Pair( firsts[firstIndex], x.second ) );
+
+    CppUnitVector<Second> seconds;
+    TestValueTraits<Second>::shrink( x.second, seconds );
+    for ( unsigned int secondIndex =0; secondIndex < seconds.size(); ++secondIndex )
+      candidates.push_back( Pair( x.first, seconds[secondIndex] ) );
+  }
+};
+
+
+CPPUNIT_NS_END
+
+#endif  // CPPUNIT_EXTENSIONS_TESTVALUETRAITS_H
@@ -0,0 +1,441 @@
+#ifndef CPPUNIT_EXTENSIONS_UNORDEREDASSERT_H
+#define CPPUNIT_EXTENSIONS_UNORDEREDASSERT_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/SourceLine.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/portability/CppUnitVector.h>
+#include <iterator>
+#include <stddef.h>
+#include <stdio.h>
+#include <string>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief Returns the FNV-1a hash of a sequence of bytes.
+ * \ingroup Assertions
+ */
+size_t CPPUNIT_API hashBytes( const void *bytes,
+                              size_t size );
+
+
+/*! \brief Traits used by CPPUNIT_ASSERT_UNORDERED_EQUAL() to hash elements.
+ * \ingroup Assertions
+ *
+ * Elements that assertion_traits<T>::equal() finds equal must have the same
+ * hash, or they are reported as missing and unexpected. The default hashes
+ * the string of assertion_traits<T>::toString(), which works for any
+ * printable type whose equal values are formatted the same way, but formats
+ * every element. Specialize the traits for the types of large collections,
+ * and for the types whose toString() shows what equal() ignores (a cache, the
+ * sign of a zero, the case of a name...).
+ *
+ * \code
+ * template<>
+ * struct hash_traits<Order>
+ * {
+ *   static size_t hash( const Order &order )
+ *   {
+ *     return hash_traits<int>::hash( order.id() );
+ *   }
+ * };
+ * \endcode
+ */
+template<class T>
+struct hash_traits
+{
+  static size_t hash( const T &value )
+  {
+    std::string text( assertion_traits<T>::toString( value ) );
+    return hashBytes( text.data(), text.length() );
+  }
+};
+
+
+/// \internal Hashes the bytes of a type whose equal values have equal bytes.
+#define CPPUNIT_HASH_TRAITS_BYTES_( Type )                                   \
+  template<>                                                                 \
+  struct hash_traits<Type>                                                   \
+  {                                                                          \
+    static size_t hash( const Type &value )                                  \
+    {                                                                        \
+      return hashBytes( &value, sizeof(value) );                             \
+    }                                                                        \
+  }
+
+CPPUNIT_HASH_TRAITS_BYTES_( char );
+CPPUNIT_HASH_TRAITS_BYTES_( signed char );
+CPPUNIT_HASH_TRAITS_BYTES_( unsigned char );
+CPPUNIT_HASH_TRAITS_BYTES_( short );
+CPPUNIT_HASH_TRAITS_BYTES_( unsigned short );
+CPPUNIT_HASH_TRAITS_BYTES_( int );
+CPPUNIT_HASH_TRAITS_BYTES_( unsigned int );
+CPPUNIT_HASH_TRAITS_BYTES_( long );
+CPPUNIT_HASH_TRAITS_BYTES_( unsigned long );
+
+
+/// Hashes the characters of a string.
+template<>
+struct hash_traits<std::string>
+{
+  static size_t hash( const std::string &value )
+  {
+    return hashBytes( value.data(), value.length() );
+  }
+};
+
+
+/// Hashes a float, 0.0 and -0.0 having the same hash as they are equal.
+template<>
+struct hash_traits<float>
+{
+  static size_t hash( float value )
+  {
+    if ( value == 0 )
+      value = 0;
+    return hashBytes( &value, sizeof(value) );
+  }
+};
+
+
+/// Hashes a double, 0.0 and -0.0 having the same hash as they are equal.
+template<>
+struct hash_traits<double>
+{
+  static size_t hash( double value )
+  {
+    if ( value == 0 )
+      value = 0;
+    return hashBytes( &value, sizeof(value) );
+  }
+};
+
+
+/*! \brief Hashes a long double as a double.
+ *
+ * The bytes of a long double may include padding, whose value is
+ * unspecified. Equal long doubles are converted to equal doubles.
+ */
+template<>
+struct hash_traits<long double>
+{
+  static size_t hash( long double value )
+  {
+    return hash_traits<double>::hash( double(value) );
+  }
+};
+
+
+/*! \brief (Implementation) Differences found by an unordered comparison.
+ * \ingroup Assertions
+ *
+ * Counts the missing and unexpected elements, and keeps the description of
+ * the first ones for the failure message.
+ */
+class CPPUNIT_API UnorderedDifferences
+{
+public:
+  /*! Constructs a UnorderedDifferences object.
+   * \param maximumShownCount Maximum number of missing elements, and of
+   *                          unexpected elements, shown by the message.
+   */
+  UnorderedDifferences( int maximumShownCount = 10 );
+
+  /// Destructor.
+  virtual ~UnorderedDifferences();
+
+  /// Returns \c true if the next missing element is shown by the message.
+  bool showsMoreMissing() const;
+
+  /// Returns \c true if the next unexpected element is shown by the message.
+  bool showsMoreUnexpected() const;
+
+  /*! Adds missing elements.
+   * \param count Number of occurrences of the element that are missing.
+   * \param element Description of the element, if showsMoreMissing().
+   */
+  void addMissing( int count,
+                   const std::string &element = "" );
+
+  /*! Adds unexpected elements.
+   * \param count Number of unexpected occurrences of the element.
+   * \param element Description of the element, if showsMoreUnexpected().
+   */
+  void addUnexpected( int count,
+                      const std::string &element = "" );
+
+  /// Returns \c true if no element is missing or unexpected.
+  bool isEmpty() const;
+
+  /*! \brief Fails with the differences, if any.
+   * \param expectedCount Number of elements of the expected collection.
+   * \param actualCount Number of elements of the actual collection.
+   */
+  void failIfAny( int expectedCount,
+                  int actualCount,
+                  const SourceLine &sourceLine,
+                  const std::string &message ) const;
+
+private:
+  /*! Returns the detail listing the shown \a elements, standing for
+   *  \a shownCount of the \a count elements.
+   */
+  std::string makeDetail( const std::string &label,
+                          int count,
+                          int shownCount,
+                          const CppUnitVector<std::string> &elements ) const;
+
+private:
+  int m_maximumShownCount;
+  int m_missingCount;
+  int m_unexpectedCount;
+  int m_shownMissingCount;
+  int m_shownUnexpectedCount;
+  CppUnitVector<std::string> m_missing;
+  CppUnitVector<std::string> m_unexpected;
+};
+
+
+/*! \brief (Implementation) Distinct element of an unordered comparison.
+ */
+template<class ExpectedIterator, class ActualIterator>
+struct UnorderedElement
+{
+  /// First occurrence in the expected range, if m_expectedCount > 0.
+  ExpectedIterator m_expected;
+  /// First occurrence in the actual range, if m_expectedCount == 0.
+  ActualIterator m_actual;
+  int m_expectedCount;
+  int m_actualCount;
+  /// Index of the next element of the hash bucket, -1 for the last one.
+  int m_next;
+};
+
+
+/*! \brief (Implementation) Returns the value of an element of an unordered
+ *         comparison.
+ */
+template<class ValueType, class ExpectedIterator, class ActualIterator>
+const ValueType &
+unorderedElementValue( 
+    const UnorderedElement<ExpectedIterator, ActualIterator> &element )
+{
+  if ( element.m_expectedCount > 0 )
+    return *element.m_expected;
+  return *element.m_actual;
+}
+
+
+/*! \brief (Implementation) Describes an element of an unordered comparison.
+ */
+template<class T>
+std::string describeUnorderedElement( const T &element,
+                                      int count )
+{
+  std::string description( assertion_traits<T>::toString( element ) );
+  if ( count > 1 )
+  {
+    char repeat[ 32 ];
+    sprintf( repeat, " (x%d)", count );
+    description += repeat;
+  }
+  return description;
+}
+
+
+/*! \brief (Implementation) Asserts that two ranges have the same elements,
+ *         in any order.
+ * \ingroup Assertions
+ *
+ * The distinct expected elements are put in a hash table, in which each
+ * actual element is then looked up, and added if it is not found: O(n)
+ * expected time. Only the elements shown by the failure message are
+ * converted to strings.
+ * \sa CPPUNIT_ASSERT_UNORDERED_RANGES_EQUAL.
+ */
+template<class ExpectedIterator, class ActualIterator>
+void assertUnorderedRangesEqual( ExpectedIterator expectedBegin,
+                                 ExpectedIterator expectedEnd,
+                                 ActualIterator actualBegin,
+                                 ActualIterator actualEnd,
+                                 SourceLine sourceLine,
+                                 const std::string &message = "" )
+{
+  typedef typename std::iterator_traits<ExpectedIterator>::value_type ValueType;
+  typedef UnorderedElement<ExpectedIterator, ActualIterator> Element;
+
+  size_t bucketCount = std::distance( expectedBegin, expectedEnd ) + 
+                       std::distance( actualBegin, actualEnd ) + 1;
+  CppUnitVector<int> buckets( bucketCount, -1 );
+  CppUnitVector<Element> elements;
+  int expectedCount = 0;
+  for ( ExpectedIterator it = expectedBegin; it != expectedEnd; ++it )
+  {
+    ++expectedCount;
+    int &bucket = buckets[ hash_traits<ValueType>::hash( *it ) % bucketCount ];
+    int index = bucket;
+    while ( index >= 0  &&
+            !assertion_traits<ValueType>::equal( *elements[index].m_expected, *it ) )
+      index = elements[index].m_next;
+
+    if ( index >= 0 )
+      ++elements[index].m_expectedCount;
+    else
+    {
+      Element element;
+      element.m_expected = it;
+      element.m_actual = actualBegin;
+      element.m_expectedCount = 1;
+      element.m_actualCount = 0;
+      element.m_next = bucket;
+      bucket = elements.size();
+      elements.push_back( element );
+    }
+  }
+
+  // The elements that are not expected are added with no expected occurrence.
+  int actualCount = 0;
+  for ( ActualIterator it = actualBegin; it != actualEnd; ++it )
+  {
+    ++actualCount;
+    int &bucket = buckets[ hash_traits<ValueType>::hash( *it ) % bucketCount ];
+    int index = bucket;
+    while ( index >= 0  &&
+            !assertion_traits<ValueType>::equal( 
+                unorderedElementValue<ValueType>( elements[index] ), *it ) )
+      index = elements[index].m_next;
+
+    if ( index >= 0 )
+      ++elements[index].m_actualCount;
+    else
+    {
+      Element element;
+      element.m_expected = expectedEnd;
+      element.m_actual = it;
+      element.m_expectedCount = 0;
+      element.m_actualCount = 1;
+      element.m_next = bucket;
+      bucket = elements.size();
+      elements.push_back( element );
+    }
+  }
+
+  UnorderedDifferences differences;
+  for ( unsigned int index = 0; index < elements.size(); ++index )
+  {
+    const Element &element = elements[ index ];
+    int difference = element.m_expectedCount - element.m_actualCount;
+    if ( difference > 0 )
+    {
+      if ( differences.showsMoreMissing() )
+        differences.addMissing( difference,
+              describeUnorderedElement<ValueType>( 
+                  unorderedElementValue<ValueType>( element ), difference ) );
+      else
+        differences.addMissing( difference );
+    }
+    else if ( difference < 0 )
+    {
+      if ( differences.showsMoreUnexpected() )
+        differences.addUnexpected( -difference,
+              describeUnorderedElement<ValueType>( 
+                  unorderedElementValue<ValueType>( element ), -difference ) );
+      else
+        differences.addUnexpected( -difference );
+    }
+  }
+
+  differences.failIfAny( expectedCount, actualCount, sourceLine, message );
+}
+
+
+/*! \brief (Implementation) Asserts that two collections have the same
+ *         elements, in any order.
+ * \ingroup Assertions
+ * \sa CPPUNIT_ASSERT_UNORDERED_EQUAL.
+ */
+template<class ExpectedCollection, class ActualCollection>
+void assertUnorderedEqual( const ExpectedCollection &expected,
+                           const ActualCollection &actual,
+                           SourceLine sourceLine,
+                           const std::string &message = "" )
+{
+  assertUnorderedRangesEqual( expected.begin(), expected.end(),
+                              actual.begin(), actual.end(),
+                              sourceLine,
+                              message );
+}
+
+
+/*! \brief Asserts that two collections have the same elements, in any order.
+ * \ingroup Assertions
+ *
+ * Each element must occur as many times in both collections. The
+ * collections may be of different types (\c std::vector, \c std::list,
+ * \c std::set, ...), with the same type of element. Elements are compared
+ * with assertion_traits<T>::equal() and hashed with hash_traits<T>, in O(n)
+ * expected time. On failure, the first elements missing from \a actual and
+ * the first unexpected ones are shown.
+ *
+ * \code
+ * CPPUNIT_ASSERT_UNORDERED_EQUAL( expectedFills, book.fills() );
+ * \endcode
+ * A failure is then reported as:
+ * \verbatim
+   unordered equality assertion failed
+   - Expected: 4 elements
+   - Actual  : 4 elements
+   - Missing (1): 12
+   - Unexpected (1): 21 \endverbatim
+ * \see hash_traits.
+ */
+#define CPPUNIT_ASSERT_UNORDERED_EQUAL( expected, actual )                   \
+  ( CPPUNIT_NS::assertUnorderedEqual( (expected),                           \
+                                      (actual),                             \
+                                      CPPUNIT_SOURCELINE() ) )
+
+/** Asserts that two collections have the same elements, in any order,
+ * setting a user message in case of failure.
+ * \ingroup Assertions
+ * \see CPPUNIT_ASSERT_UNORDERED_EQUAL
+ */
+#define CPPUNIT_ASSERT_UNORDERED_EQUAL_MESSAGE( message, expected, actual )  \
+  ( CPPUNIT_NS::assertUnorderedEqual( (expected),                           \
+                                      (actual),                             \
+                                      CPPUNIT_SOURCELINE(),                 \
+                                      (message) ) )
+
+/*! \brief Asserts that two ranges have the same elements, in any order.
+ * \ingroup Assertions
+ *
+ * Same as CPPUNIT_ASSERT_UNORDERED_EQUAL(), for ranges given by forward
+ * iterators (or pointers).
+ * \code
+ * CPPUNIT_ASSERT_UNORDERED_RANGES_EQUAL( expected, expected + 3,
+ *                                        ids.begin(), ids.end() );
+ * \endcode
+ */
+#define CPPUNIT_ASSERT_UNORDERED_RANGES_EQUAL( expectedBegin, expectedEnd,  \
+                                               actualBegin, actualEnd )     \
+  ( CPPUNIT_NS::assertUnorderedRangesEqual( (expectedBegin),                \
+                                            (expectedEnd),                  \
+                                            (actualBegin),                  \
+                                            (actualEnd),                    \
+                                            CPPUNIT_SOURCELINE() ) )
+
+
+CPPUNIT_NS_END
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_EXTENSIONS_UNORDEREDASSERT_H
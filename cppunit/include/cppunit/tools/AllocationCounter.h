@@ -0,0 +1,125 @@
+#ifndef CPPUNIT_TOOLS_ALLOCATIONCOUNTER_H
+#define CPPUNIT_TOOLS_ALLOCATIONCOUNTER_H
+
+#include <cppunit/Portability.h>
+#include <new>
+#include <stdlib.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief Counts the heap allocations of the current thread.
+ * \ingroup WritingTestFixture
+ *
+ * Allocations are only counted if the test program replaces the global
+ * operator new with CPPUNIT_INSTALL_ALLOCATION_COUNTER, in exactly one of its
+ * source files. isInstalled() tells if this is the case.
+ *
+ * An AllocationCounter counts the allocations made by the thread that
+ * constructed it, until it is destroyed. Allocations made by other threads,
+ * such as the workers of a parallel runner, are ignored. Each thread may
+ * have its own active counter; a counter constructed while another one of
+ * the same thread is active suspends it until destroyed. If the compiler has
+ * no thread-local storage (CPPUNIT_HAVE_THREAD_LOCAL is not defined), only
+ * one counter may be active at a time in the whole program.
+ *
+ * \code
+ * CppUnit::AllocationCounter counter;
+ * Buffer moved( std::move( buffer ) );
+ * CPPUNIT_ASSERT_EQUAL( 0, counter.allocationCount() );
+ * \endcode
+ */
+class CPPUNIT_API AllocationCounter
+{
+public:
+  /// Starts counting the allocations of the calling thread.
+  AllocationCounter();
+
+  /// Stops counting.
+  virtual ~AllocationCounter();
+
+  /// Returns the number of allocations since the counter was constructed.
+  int allocationCount() const;
+
+  /*! \brief Tests if the replacement operator new was installed.
+   * \return \c true once the program made one allocation through 
+   *         CPPUNIT_INSTALL_ALLOCATION_COUNTER.
+   */
+  static bool isInstalled();
+
+  /// Records an allocation. Called by the replacement operator new.
+  static void recordAllocation();
+
+private:
+  /// Prevents the use of the copy constructor.
+  AllocationCounter( const AllocationCounter &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const AllocationCounter &other );
+
+private:
+  int m_allocationCount;
+  int *m_previousAllocationCount;
+};
+
+
+CPPUNIT_NS_END
+
+
+#if CPPUNIT_HAVE_RVALUE_REFERENCES
+# define CPPUNIT_OPERATOR_NEW_THROW
+# define CPPUNIT_OPERATOR_DELETE_THROW noexcept
+#else
+# define CPPUNIT_OPERATOR_NEW_THROW throw( std::bad_alloc )
+# define CPPUNIT_OPERATOR_DELETE_THROW throw()
+#endif
+
+/*! \brief Replaces the global operator new to count allocations.
+ * \ingroup WritingTestFixture
+ *
+ * Must be used at global scope, in exactly one source file of the test
+ * program. Memory is allocated with malloc(). The sized forms of operator
+ * delete (C++14) are replaced too, so that the compiler does not call the
+ * ones of the standard library on memory from malloc().
+ * \see AllocationCounter.
+ */
+#define CPPUNIT_INSTALL_ALLOCATION_COUNTER()                                \
+  void *operator new( size_t size ) CPPUNIT_OPERATOR_NEW_THROW              \
+  {                                                                         \
+    CPPUNIT_NS::AllocationCounter::recordAllocation();                      \
+    void *memory = malloc( size > 0 ? size : 1 );                           \
+    if ( memory == NULL )                                                   \
+      throw std::bad_alloc();                                               \
+    return memory;                                                          \
+  }                                                                         \
+                                                                            \
+  void *operator new[]( size_t size ) CPPUNIT_OPERATOR_NEW_THROW            \
+  {                                                                         \
+    return operator new( size );                                            \
+  }                                                                         \
+                                                                            \
+  void operator delete( void *memory ) CPPUNIT_OPERATOR_DELETE_THROW        \
+  {                                                                         \
+    free( memory );                                                         \
+  }                                                                         \
+                                                                            \
+  void operator delete[]( void *memory ) CPPUNIT_OPERATOR_DELETE_THROW      \
+  {                                                                         \
+    free( memory );                                                         \
+  }                                                                         \
+                                                                            \
+  void operator delete( void *memory,                                       \
+                        size_t ) CPPUNIT_OPERATOR_DELETE_THROW              \
+  {                                                                         \
+    free( memory );                                                         \
+  }                                                                         \
+                                                                            \
+  void operator delete[]( void *memory,                                     \
+                          size_t ) CPPUNIT_OPERATOR_DELETE_THROW            \
+  {                                                                         \
+    free( memory );                                                         \
+  }
+
+
+#endif  // CPPUNIT_TOOLS_ALLOCATIONCOUNTER_H
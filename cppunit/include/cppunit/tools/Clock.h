@@ -0,0 +1,43 @@
+#ifndef CPPUNIT_TOOLS_CLOCK_H
+#define CPPUNIT_TOOLS_CLOCK_H
+
+#include <cppunit/Portability.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief Monotonic high resolution clock.
+ * \ingroup ExecutingTest
+ *
+ * Times are expressed in seconds, relative to an unspecified origin. Only the
+ * difference between two times is meaningful.
+ *
+ * The clock relies on clock_gettime( CLOCK_MONOTONIC ) when available, and on
+ * QueryPerformanceCounter() on Windows. Otherwise, it falls back to the
+ * wall clock time of gettimeofday(), or of time().
+ */
+class CPPUNIT_API Clock
+{
+public:
+  /// Returns the current time, in seconds.
+  static double now();
+
+  /*! \brief Suspends the calling thread until the specified time.
+   *
+   * The thread sleeps, then polls the clock for the last fraction of a
+   * millisecond to wake up on time.
+   * \param time Time returned by now(). Returns immediately if \a time is
+   *             in the past.
+   */
+  static void sleepUntil( double time );
+
+private:
+  /// Prevents the instantiation of this class.
+  Clock();
+};
+
+
+CPPUNIT_NS_END
+
+#endif  // CPPUNIT_TOOLS_CLOCK_H
@@ -0,0 +1,104 @@
+#ifndef CPPUNIT_TOOLS_LATENCYHISTOGRAM_H
+#define CPPUNIT_TOOLS_LATENCYHISTOGRAM_H
+
+#include <cppunit/Portability.h>
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( push )
+#pragma warning( disable: 4251 )  // X needs to have dll-interface to be used by clients of class Z
+#endif
+
+#include <cppunit/portability/CppUnitVector.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief Histogram of latencies with a bounded relative error.
+ * \ingroup ExecutingTest
+ *
+ * Latencies are recorded in seconds, with a resolution of one nanosecond.
+ * Like a HDR histogram, the buckets cover each power of two with a fixed
+ * number of sub-buckets, so that the error on a recorded value is at most
+ * 1 / 2^\a significantBits of the value, whatever its magnitude. Values up
+ * to 2^45 nanoseconds (about 9 hours) are recorded; longer ones are counted
+ * in the last bucket.
+ *
+ * Recording a value is done in constant time, without allocation.
+ */
+class CPPUNIT_API LatencyHistogram
+{
+public:
+  /*! Constructs an empty histogram.
+   * \param significantBits Precision of the histogram, in [1, 16].
+   */
+  LatencyHistogram( int significantBits = 7 );
+
+  /// Records a latency, in seconds. Negative latencies are recorded as 0.
+  void record( double latency );
+
+  /*! \brief Adds the latencies recorded in \a other.
+   * \exception std::invalid_argument if the histograms have different
+   *            precisions.
+   */
+  void merge( const LatencyHistogram &other );
+
+  /// Removes all the recorded latencies.
+  void reset();
+
+  /// Returns the number of recorded latencies.
+  unsigned long totalCount() const;
+
+  /// Returns the smallest recorded latency, 0 if none.
+  double minimum() const;
+
+  /// Returns the largest recorded latency, 0 if none.
+  double maximum() const;
+
+  /// Returns the mean of the recorded latencies, 0 if none.
+  double mean() const;
+
+  /*! \brief Returns the latency below which the given percentage of the
+   *         latencies fall.
+   * \param percentile Percentage in [0, 100]. 99 returns the p99 latency.
+   * \return Upper bound of the bucket that contains the percentile, clamped
+   *         to [minimum(), maximum()]. 0 if no latency was recorded.
+   */
+  double valueAtPercentile( double percentile ) const;
+
+  /// Returns the precision of the histogram.
+  int significantBits() const;
+
+  /// Returns the number of buckets.
+  int getBucketCount() const;
+
+  /// Returns the number of latencies recorded in the specified bucket.
+  unsigned long getBucketCountAt( int index ) const;
+
+  /// Returns the smallest latency, in seconds, counted in the specified bucket.
+  double getBucketLowerBoundAt( int index ) const;
+
+  /// Returns the latency, in seconds, above which values go to the next bucket.
+  double getBucketUpperBoundAt( int index ) const;
+
+private:
+  int bucketIndexFor( double latency ) const;
+
+private:
+  int m_significantBits;
+  int m_subBucketCount;
+  CppUnitVector<unsigned long> m_counts;
+  unsigned long m_totalCount;
+  double m_minimum;
+  double m_maximum;
+  double m_sum;
+};
+
+
+CPPUNIT_NS_END
+
+#if CPPUNIT_NEED_DLL_DECL
+#pragma warning( pop )
+#endif
+
+#endif  // CPPUNIT_TOOLS_LATENCYHISTOGRAM_H
@@ -0,0 +1,128 @@
+#ifndef CPPUNIT_TOOLS_LIVEMETRICSSEGMENT_H
+#define CPPUNIT_TOOLS_LIVEMETRICSSEGMENT_H
+
+#include <cppunit/Portability.h>
+#include <cppunit/portability/Stream.h>
+#include <stddef.h>
+#include <string>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief Progress of one worker, as published in a LiveMetricsSegment.
+ * \ingroup TrackingTestExecution
+ *
+ * Times are given by Clock::now(), which is shared by all the processes of
+ * the machine when it relies on CLOCK_MONOTONIC.
+ */
+struct CPPUNIT_API LiveWorkerMetrics
+{
+  /// Constructs the metrics of a worker that never ran.
+  LiveWorkerMetrics();
+
+  /// Returns the number of tests finished per second since the run started.
+  double testsPerSecond() const;
+
+  /// Process identifier of the worker, 0 if the slot was never used.
+  long m_processId;
+  /// \c true from the start to the end of the test run.
+  bool m_running;
+  long m_startedCount;
+  long m_finishedCount;
+  long m_failureCount;
+  long m_errorCount;
+  /// Resident set size of the worker process, 0 if unknown.
+  long m_residentBytes;
+  double m_startTime;
+  double m_updateTime;
+  /// Name of the test being run, empty between tests.
+  std::string m_currentTest;
+};
+
+
+/*! \brief Shared memory segment where test processes publish their progress.
+ * \ingroup TrackingTestExecution
+ *
+ * The segment is a file mapped by every process that opens it, usually in
+ * a memory file system such as /dev/shm. It has a fixed number of worker
+ * slots. Each slot is written by a single worker, the process running one
+ * shard of the tests, and read at any time by monitoring tools such as
+ * cppunit-top. A sequence number makes the readers retry instead of seeing a
+ * slot half written, so no lock is shared between the processes.
+ *
+ * The segment relies on mmap(): on other systems, the constructor throws.
+ * \see LiveMetricsListener.
+ */
+class CPPUNIT_API LiveMetricsSegment
+{
+public:
+  /// Number of worker slots in a segment.
+  static const int slotCount;
+
+  /*! \brief Maps the segment stored in the specified file.
+   * \param fileName Name of the file storing the segment.
+   * \param create If \c true, the file is created if it does not exist and
+   *               the segment is mapped for writing. Otherwise, the file must
+   *               exist and the segment is mapped read-only.
+   * \exception std::runtime_error if the file can not be created or mapped,
+   *            or is not a segment.
+   */
+  LiveMetricsSegment( const std::string &fileName,
+                      bool create );
+
+  /// Destructor. Unmaps the segment. The file is left in place.
+  virtual ~LiveMetricsSegment();
+
+  /*! \brief Publishes the metrics of a worker.
+   * \param workerIndex Index of the slot, in [0, slotCount[.
+   * \exception std::invalid_argument if \a workerIndex is out of range.
+   * \exception std::runtime_error if the segment is mapped read-only.
+   */
+  void writeWorker( int workerIndex,
+                    const LiveWorkerMetrics &metrics );
+
+  /*! \brief Returns a consistent copy of the metrics of a worker.
+   * \exception std::invalid_argument if \a workerIndex is out of range.
+   */
+  LiveWorkerMetrics readWorker( int workerIndex ) const;
+
+  /// Returns the number of slots used by a worker since the file was created.
+  int usedSlotCount() const;
+
+  /*! \brief Writes the metrics of the workers in the Prometheus text format.
+   *
+   * Only the slots used by a worker are written, with the worker index as
+   * label.
+   */
+  void writePrometheus( OStream &stream ) const;
+
+  /*! \brief Replaces a file with the metrics in the Prometheus text format.
+   *
+   * The file is written under a temporary name then renamed, so the
+   * textfile collector of the Prometheus node exporter never reads a
+   * partial file.
+   * \exception std::runtime_error if the file can not be written.
+   */
+  void writePrometheusFile( const std::string &fileName ) const;
+
+private:
+  /// Prevents the use of the copy constructor.
+  LiveMetricsSegment( const LiveMetricsSegment &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const LiveMetricsSegment &other );
+
+  void checkWorkerIndex( int workerIndex ) const;
+
+private:
+  std::string m_fileName;
+  void *m_memory;
+  size_t m_size;
+  bool m_writable;
+};
+
+
+CPPUNIT_NS_END
+
+#endif  // CPPUNIT_TOOLS_LIVEMETRICSSEGMENT_H
@@ -0,0 +1,51 @@
+#ifndef CPPUNIT_TOOLS_MAPPEDFILE_H
+#define CPPUNIT_TOOLS_MAPPEDFILE_H
+
+#include <cppunit/Portability.h>
+#include <stddef.h>
+#include <string>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief Read-only view of the content of a file.
+ * \ingroup ExecutingTest
+ *
+ * The file is memory-mapped if mmap() is available (CPPUNIT_HAVE_MMAP), and
+ * read into memory otherwise.
+ */
+class CPPUNIT_API MappedFile
+{
+public:
+  /*! \brief Maps the specified file.
+   * \exception std::runtime_error if the file can not be read.
+   */
+  MappedFile( const std::string &path );
+
+  /// Destructor. Unmaps the file.
+  virtual ~MappedFile();
+
+  /// Returns the content of the file. Never \c NULL, even for an empty file.
+  const unsigned char *data() const;
+
+  /// Returns the size of the file, in bytes.
+  size_t size() const;
+
+private:
+  /// Prevents the use of the copy constructor.
+  MappedFile( const MappedFile &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const MappedFile &other );
+
+private:
+  unsigned char *m_data;
+  size_t m_size;
+  bool m_mapped;
+};
+
+
+CPPUNIT_NS_END
+
+#endif  // CPPUNIT_TOOLS_MAPPEDFILE_H
@@ -0,0 +1,69 @@
+#ifndef CPPUNIT_TOOLS_RANDOM_H
+#define CPPUNIT_TOOLS_RANDOM_H
+
+#include <cppunit/Portability.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief Small, fast and reproducible pseudo-random number generator.
+ * \ingroup WritingTestFixture
+ *
+ * The generator is a xorshift128 generator seeded from a single 32 bits
+ * value. A given seed always produces the same sequence, on all platforms,
+ * so that a randomized test can be replayed from the seed it reports.
+ *
+ * A Random object must not be shared between threads. Derive one seed per
+ * thread or per test case with mix().
+ */
+class CPPUNIT_API Random
+{
+public:
+  /// Constructs a generator with the specified seed.
+  Random( unsigned int seed = 0 );
+
+  /// Restarts the sequence from the specified seed.
+  void seed( unsigned int seed );
+
+  /// Returns the next 32 bits value.
+  unsigned int nextUInt32();
+
+  /// Returns an integer in [\a minimum, \a maximum].
+  int nextInt( int minimum, 
+               int maximum );
+
+  /// Returns a double in [0, 1[.
+  double nextDouble();
+
+  /// Returns a double in [\a minimum, \a maximum[.
+  double nextDouble( double minimum, 
+                     double maximum );
+
+  bool nextBool();
+
+  /*! \brief Derives a seed from a seed and an index.
+   *
+   * Used to give each test case its own reproducible sequence: case \a index
+   * of a run seeded with \a seed is replayed by seeding a generator with
+   * mix( seed, index ).
+   */
+  static unsigned int mix( unsigned int seed, 
+                           unsigned int index );
+
+  /*! \brief Returns the seed to use for a randomized test.
+   *
+   * Returns the value of the environment variable \c CPPUNIT_SEED if it is
+   * set, so that a failing run can be replayed. Otherwise returns a seed
+   * derived from the current time.
+   */
+  static unsigned int defaultSeed();
+
+private:
+  unsigned int m_state[4];
+};
+
+
+CPPUNIT_NS_END
+
+#endif  // CPPUNIT_TOOLS_RANDOM_H
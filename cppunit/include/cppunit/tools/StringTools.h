@@ -26,6 +26,10 @@ struct StringTools
   static std::string CPPUNIT_API wrap( const std::string &text,
                                        int wrapColumn = CPPUNIT_WRAP_COLUMN );
 
+  /*! \brief Removes leading and trailing white spaces.
+   */
+  static std::string CPPUNIT_API trim( const std::string &text );
+
 };
 
 
@@ -0,0 +1,181 @@
+#ifndef CPPUNIT_TOOLS_THREADGROUP_H
+#define CPPUNIT_TOOLS_THREADGROUP_H
+
+#include <cppunit/SynchronizedObject.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! \brief Work run concurrently by a ThreadGroup.
+ * \ingroup ExecutingTest
+ */
+class CPPUNIT_API ThreadTask
+{
+public:
+  virtual ~ThreadTask() {}
+
+  /*! \brief Runs the part of the work assigned to a thread.
+   * \param threadIndex Zero based index of the thread running the work.
+   */
+  virtual void run( int threadIndex ) =0;
+};
+
+
+/*! \brief Runs a task on several threads and waits for their completion.
+ * \ingroup ExecutingTest
+ *
+ * Threads are implemented with POSIX threads. If they are not available
+ * (CPPUNIT_HAVE_PTHREAD_H is not defined), the task is run sequentially for
+ * each thread index in the calling thread.
+ *
+ * An exception that escapes ThreadTask::run() does not terminate the
+ * application: it is rethrown by run() once all the threads are done. An
+ * Exception is rethrown as is, any other exception is rethrown as a
+ * std::runtime_error.
+ *
+ * If CPPUNIT_NO_EXCEPTIONS is defined, each thread runs the task under an
+ * AssertionTrap: a failed assertion ends the task of its thread only, and
+ * the failure is raised to the trap of the thread that called run() once
+ * all the threads are done.
+ */
+class CPPUNIT_API ThreadGroup
+{
+public:
+  /*! \brief Runs \a task on \a threadCount threads.
+   *
+   * Calls task.run( threadIndex ) for each thread index in 
+   * [0, \a threadCount[ and returns once all the calls are done.
+   * \exception Exception or std::runtime_error if an exception escaped
+   *            ThreadTask::run(). The first one is rethrown.
+   */
+  static void run( ThreadTask &task, 
+                   int threadCount );
+
+  /// Tests if the tasks are really run concurrently.
+  static bool isConcurrent();
+
+  /// Returns the number of processors available, 1 if unknown.
+  static int processorCount();
+
+private:
+  /// Prevents the instantiation of this class.
+  ThreadGroup();
+};
+
+
+/*! \brief Runs a task on a thread of its own while the caller goes on.
+ * \ingroup ExecutingTest
+ *
+ * The task is run with the thread index 0. join() waits for its end and
+ * rethrows an exception that escaped ThreadTask::run() as ThreadGroup::run()
+ * does. If threads are not available, start() fails and the caller must do
+ * the work itself.
+ */
+class CPPUNIT_API BackgroundThread
+{
+public:
+  BackgroundThread();
+
+  /// Waits for the end of the task. An exception of the task is lost.
+  virtual ~BackgroundThread();
+
+  /*! \brief Starts running task.run( 0 ) on a new thread.
+   * \return \c false if the thread could not be created, or if a task is
+   *         already running.
+   */
+  bool start( ThreadTask &task );
+
+  /// Tests if a task was started and not joined yet.
+  bool isRunning() const;
+
+  /*! \brief Waits for the end of the task. Does nothing if none was started.
+   * \exception Exception or std::runtime_error if an exception escaped
+   *            ThreadTask::run().
+   */
+  void join();
+
+private:
+  /// Prevents the use of the copy constructor.
+  BackgroundThread( const BackgroundThread &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const BackgroundThread &other );
+
+private:
+  void *m_worker;
+};
+
+
+/*! \brief Mutex that can be shared by the threads of a ThreadGroup.
+ * \ingroup ExecutingTest
+ *
+ * Can also be given to a SynchronizedObject such as TestResult. It does
+ * nothing if threads are not available.
+ */
+class CPPUNIT_API ThreadMutex : public SynchronizedObject::SynchronizationObject
+{
+public:
+  ThreadMutex();
+
+  virtual ~ThreadMutex();
+
+  void lock();
+
+  void unlock();
+
+private:
+  /// Prevents the use of the copy constructor.
+  ThreadMutex( const ThreadMutex &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const ThreadMutex &other );
+
+private:
+  void *m_mutex;
+};
+
+
+/*! \brief Makes the threads of a ThreadGroup wait for each other.
+ * \ingroup ExecutingTest
+ *
+ * wait() returns once it has been called by the specified number of threads.
+ * The barrier can then be reused. If the other threads do not arrive within
+ * 10 seconds (a thread could not be created and is run after the others),
+ * wait() gives up and returns \c false. It does nothing if threads are not
+ * available, since the tasks are then run one after the other.
+ */
+class CPPUNIT_API ThreadBarrier
+{
+public:
+  /*! Constructs a ThreadBarrier.
+   * \param threadCount Number of threads that must call wait().
+   */
+  ThreadBarrier( int threadCount );
+
+  virtual ~ThreadBarrier();
+
+  /*! \brief Waits until all the threads called wait().
+   * \return \c true if all the threads arrived, \c false on time out.
+   */
+  bool wait();
+
+private:
+  /// Prevents the use of the copy constructor.
+  ThreadBarrier( const ThreadBarrier &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const ThreadBarrier &other );
+
+private:
+  int m_threadCount;
+  int m_waitingCount;
+  unsigned long m_generation;
+  void *m_mutex;
+  void *m_condition;
+};
+
+
+CPPUNIT_NS_END
+
+#endif  // CPPUNIT_TOOLS_THREADGROUP_H
@@ -0,0 +1,124 @@
+#include <cppunit/extensions/BenchmarkComparison.h>
+#include <cppunit/portability/Stream.h>
+#include <stdexcept>
+#include <stdlib.h>
+#include <string>
+
+
+/* Notes:
+
+  Compares two benchmark result files saved by DllPlugInTester with
+  --benchmark-results. Used to gate a continuous integration build on the
+  performance of a branch compared to the main line.
+ */
+
+
+void
+printUsage( const std::string &applicationName )
+{
+  CPPUNIT_NS::stdCOut()  << "Usage:\n"
+             << applicationName  <<  " [-s significance-level] [-m minimum-change] "
+             "baseline-filename contender-filename\n\n"
+"-s --significance level\n"
+"	Largest p-value of the Mann-Whitney U test for a difference to be\n"
+"	significant (default is 0.05).\n"
+"-m --minimum-change ratio\n"
+"	Smallest relative change of the median time reported as improved or\n"
+"	regressed (default is 0.05 for 5%).\n"
+"\n"
+"Each size of each benchmark is classified as improved, regressed,\n"
+"unchanged or not compared (missing in one file).\n\n";
+}
+
+
+/*! Parses a ratio given on the command line.
+ * \return \c false if \a text is not a number between 0 and 1.
+ */
+bool
+parseRatio( const std::string &text,
+            double &ratio )
+{
+  char *end = NULL;
+  ratio = strtod( text.c_str(), &end );
+  return !text.empty()  &&  *end == 0  &&  ratio >= 0  &&  ratio <= 1;
+}
+
+
+/*! Main
+ *
+ * Usage:
+ *
+ * BenchmarkCompare [-s significance-level] [-m minimum-change] baseline.json contender.json
+ *
+ * Writes one line for each compared benchmark size and a summary. The
+ * application exits with code 0 if no benchmark regressed, 1 if a benchmark
+ * regressed, and 2 if the command line is invalid or a file can not be read.
+ */
+int
+main( int argc,
+      const char *argv[] )
+{
+  const int successReturnCode = 0;
+  const int regressionReturnCode = 1;
+  const int badCommadLineReturnCode = 2;
+
+  std::string applicationName( argv[0] );
+  double significanceLevel = 0.05;
+  double minimumChange = 0.05;
+  CppUnitVector<std::string> fileNames;
+  for ( int index =1; index < argc; ++index )
+  {
+    std::string argument( argv[ index ] );
+    bool isSignificance = argument == "-s"  ||  argument == "--significance";
+    bool isMinimumChange = argument == "-m"  ||  argument == "--minimum-change";
+    if ( isSignificance  ||  isMinimumChange )
+    {
+      double ratio = 0;
+      if ( index +1 >= argc  ||  !parseRatio( argv[ ++index ], ratio ) )
+      {
+        CPPUNIT_NS::stdCOut() << "Error while parsing command line: option "
+                              << argument << " expects a ratio between 0 and 1\n\n";
+        printUsage( applicationName );
+        return badCommadLineReturnCode;
+      }
+      if ( isSignificance )
+        significanceLevel = ratio;
+      else
+        minimumChange = ratio;
+    }
+    else
+      fileNames.push_back( argument );
+  }
+
+  if ( fileNames.size() != 2 )
+  {
+    printUsage( applicationName );
+    return badCommadLineReturnCode;
+  }
+
+  CPPUNIT_NS::BenchmarkResultFile baseline;
+  CPPUNIT_NS::BenchmarkResultFile contender;
+  try
+  {
+    baseline.load( fileNames[0] );
+    contender.load( fileNames[1] );
+  }
+  catch ( std::runtime_error &e )
+  {
+    CPPUNIT_NS::stdCOut() << e.what() << "\n";
+    return badCommadLineReturnCode;
+  }
+
+  CPPUNIT_NS::BenchmarkComparison comparison( significanceLevel, minimumChange );
+  comparison.compare( baseline, contender );
+  CPPUNIT_NS::stdCOut() << "Baseline : " << fileNames[0];
+  if ( !baseline.revision().empty() )
+    CPPUNIT_NS::stdCOut() << " (" << baseline.revision() << ")";
+  CPPUNIT_NS::stdCOut() << "\nContender: " << fileNames[1];
+  if ( !contender.revision().empty() )
+    CPPUNIT_NS::stdCOut() << " (" << contender.revision() << ")";
+  CPPUNIT_NS::stdCOut() << "\n";
+  comparison.write( CPPUNIT_NS::stdCOut() );
+
+  return comparison.hasRegression() ? regressionReturnCode : successReturnCode;
+}
@@ -1,4 +1,4 @@
-#include "CommandLineParser.h"
+#include <cppunit/CommandLineParser.h>
 #include "CommandLineParserTest.h"
 
 CPPUNIT_TEST_SUITE_REGISTRATION( CommandLineParserTest );
@@ -36,7 +36,7 @@ CommandLineParserTest::parse( const char **lines )
       ;
 
   delete _parser;
-  _parser = new CommandLineParser( count, lines );
+  _parser = new CPPUNIT_NS::CommandLineParser( count, lines );
   _parser->parse();
 }
 
@@ -58,6 +58,17 @@ CommandLineParserTest::testEmptyCommandLine()
   CPPUNIT_ASSERT( !_parser->useCoutStream() );
   CPPUNIT_ASSERT( !_parser->useTextOutputter() );
   CPPUNIT_ASSERT( !_parser->useXmlOutputter() );
+  CPPUNIT_ASSERT( !_parser->updateSnapshots() );
+  CPPUNIT_ASSERT( !_parser->raiseBenchmarkPriority() );
+  CPPUNIT_ASSERT( _parser->getBenchmarkCpus().empty() );
+  CPPUNIT_ASSERT_EQUAL( none, _parser->getBenchmarkResultsFileName() );
+  CPPUNIT_ASSERT_EQUAL( none, _parser->getBenchmarkBaselineFileName() );
+  CPPUNIT_ASSERT( !_parser->profileListeners() );
+  CPPUNIT_ASSERT( !_parser->profileStartup() );
+  CPPUNIT_ASSERT( !_parser->measureIdleTime() );
+  CPPUNIT_ASSERT_EQUAL( none, _parser->getLiveMetricsFileName() );
+  CPPUNIT_ASSERT_EQUAL( 0, _parser->getMetricsWorkerIndex() );
+  CPPUNIT_ASSERT_EQUAL( none, _parser->getMetricsTextFileName() );
 }
 
 
@@ -123,7 +134,7 @@ CommandLineParserTest::testFileName()
 
   CPPUNIT_ASSERT_EQUAL( 1, _parser->getPlugInCount() );
 
-  CommandLinePlugInInfo info( _parser->getPlugInAt( 0 ) );
+  CPPUNIT_NS::CommandLinePlugInInfo info( _parser->getPlugInAt( 0 ) );
   CPPUNIT_ASSERT_EQUAL( std::string("TestPlugIn.dll"), info.m_fileName );
   CPPUNIT_ASSERT( info.m_parameters.getCommandLine().empty() );
 }
@@ -208,13 +219,268 @@ CommandLineParserTest::testPlugInsWithParameters()
 
   CPPUNIT_ASSERT_EQUAL( 2, _parser->getPlugInCount() );
 
-  CommandLinePlugInInfo info1( _parser->getPlugInAt( 0 ) );
+  CPPUNIT_NS::CommandLinePlugInInfo info1( _parser->getPlugInAt( 0 ) );
 
   CPPUNIT_ASSERT_EQUAL( std::string("TestPlugIn1.dll"), info1.m_fileName );
   CPPUNIT_ASSERT_EQUAL( std::string("login = lain"), 
                         info1.m_parameters.getCommandLine() );
 
-  CommandLinePlugInInfo info2( _parser->getPlugInAt( 1 ) );
+  CPPUNIT_NS::CommandLinePlugInInfo info2( _parser->getPlugInAt( 1 ) );
   CPPUNIT_ASSERT_EQUAL( std::string("Clocker.dll"), info2.m_fileName );
   CPPUNIT_ASSERT( info2.m_parameters.getCommandLine().empty() );
 }
+
+
+void 
+CommandLineParserTest::testTagExpression()
+{
+  static const char *lines[] = { "", "--tags", "perf & !slow", ":Core", NULL };
+  parse( lines );
+
+  CPPUNIT_ASSERT_EQUAL( std::string("perf & !slow"), 
+                        _parser->getTagExpression() );
+  CPPUNIT_ASSERT_EQUAL( std::string("Core"), _parser->getTestPath() );
+}
+
+
+void 
+CommandLineParserTest::testMissingTagExpressionThrow()
+{
+  static const char *lines[] = { "", "-g", NULL };
+  parse( lines );
+}
+
+
+void 
+CommandLineParserTest::testUpdateSnapshots()
+{
+  static const char *lines[] = { "", "-u", NULL };
+  parse( lines );
+  CPPUNIT_ASSERT( _parser->updateSnapshots() );
+
+  static const char *longLines[] = { "", "--update-snapshots", NULL };
+  parse( longLines );
+  CPPUNIT_ASSERT( _parser->updateSnapshots() );
+}
+
+
+void 
+CommandLineParserTest::testBenchmarkControls()
+{
+  static const char *lines[] = { "", "-a", "0-2,5", "-r", NULL };
+  parse( lines );
+  CPPUNIT_ASSERT( _parser->raiseBenchmarkPriority() );
+  CPPUNIT_ASSERT_EQUAL( 4, int(_parser->getBenchmarkCpus().size()) );
+  CPPUNIT_ASSERT_EQUAL( 2, _parser->getBenchmarkCpus()[2] );
+  CPPUNIT_ASSERT_EQUAL( 5, _parser->getBenchmarkCpus()[3] );
+
+  static const char *longLines[] = { "", "--benchmark-cpus", "3", 
+                                     "--raise-priority", NULL };
+  parse( longLines );
+  CPPUNIT_ASSERT( _parser->raiseBenchmarkPriority() );
+  CPPUNIT_ASSERT_EQUAL( 1, int(_parser->getBenchmarkCpus().size()) );
+  CPPUNIT_ASSERT_EQUAL( 3, _parser->getBenchmarkCpus()[0] );
+}
+
+
+void 
+CommandLineParserTest::testInvalidCpuListThrow()
+{
+  static const char *lines[] = { "", "-a", "3-1", NULL };
+  parse( lines );
+}
+
+
+void 
+CommandLineParserTest::testBenchmarkResultFiles()
+{
+  static const char *lines[] = { "", "-j", "results.json", 
+                                 "-k", "baseline.json", NULL };
+  parse( lines );
+  CPPUNIT_ASSERT_EQUAL( std::string( "results.json" ), 
+                        _parser->getBenchmarkResultsFileName() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "baseline.json" ), 
+                        _parser->getBenchmarkBaselineFileName() );
+
+  static const char *longLines[] = { "", "--benchmark-results", "new.json", 
+                                     "--benchmark-baseline", "old.json", NULL };
+  parse( longLines );
+  CPPUNIT_ASSERT_EQUAL( std::string( "new.json" ), 
+                        _parser->getBenchmarkResultsFileName() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "old.json" ), 
+                        _parser->getBenchmarkBaselineFileName() );
+}
+
+
+void 
+CommandLineParserTest::testProfileListeners()
+{
+  static const char *lines[] = { "", "-p", NULL };
+  parse( lines );
+  CPPUNIT_ASSERT( _parser->profileListeners() );
+
+  static const char *longLines[] = { "", "--profile-listeners", NULL };
+  parse( longLines );
+  CPPUNIT_ASSERT( _parser->profileListeners() );
+}
+
+
+void 
+CommandLineParserTest::testProfileStartup()
+{
+  static const char *lines[] = { "", "-i", NULL };
+  parse( lines );
+  CPPUNIT_ASSERT( _parser->profileStartup() );
+
+  static const char *longLines[] = { "", "--startup-profile", NULL };
+  parse( longLines );
+  CPPUNIT_ASSERT( _parser->profileStartup() );
+}
+
+
+void 
+CommandLineParserTest::testMeasureIdleTime()
+{
+  static const char *lines[] = { "", "-d", NULL };
+  parse( lines );
+  CPPUNIT_ASSERT( _parser->measureIdleTime() );
+
+  static const char *longLines[] = { "", "--idle-time", NULL };
+  parse( longLines );
+  CPPUNIT_ASSERT( _parser->measureIdleTime() );
+}
+
+
+void 
+CommandLineParserTest::testLiveMetrics()
+{
+  static const char *lines[] = { "", "-m", "/dev/shm/soak", "-l", "3", 
+                                 "-f", "soak.prom", NULL };
+  parse( lines );
+  CPPUNIT_ASSERT_EQUAL( std::string( "/dev/shm/soak" ), 
+                        _parser->getLiveMetricsFileName() );
+  CPPUNIT_ASSERT_EQUAL( 3, _parser->getMetricsWorkerIndex() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "soak.prom" ), 
+                        _parser->getMetricsTextFileName() );
+
+  static const char *longLines[] = { "", "--live-metrics", "segment", 
+                                     "--metrics-worker", "12",
+                                     "--metrics-textfile", "run.prom", NULL };
+  parse( longLines );
+  CPPUNIT_ASSERT_EQUAL( std::string( "segment" ), 
+                        _parser->getLiveMetricsFileName() );
+  CPPUNIT_ASSERT_EQUAL( 12, _parser->getMetricsWorkerIndex() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "run.prom" ), 
+                        _parser->getMetricsTextFileName() );
+}
+
+
+void 
+CommandLineParserTest::testInvalidMetricsWorkerThrow()
+{
+  static const char *lines[] = { "", "-l", "64", NULL };
+  parse( lines );
+}
+
+
+void 
+CommandLineParserTest::testDistributed()
+{
+  static const char *lines[] = { "", "-C", "7357", NULL };
+  parse( lines );
+  CPPUNIT_ASSERT_EQUAL( 7357, _parser->getCoordinatorPort() );
+  CPPUNIT_ASSERT( _parser->getWorkerHost().empty() );
+
+  static const char *longLines[] = { "", "--worker", "build-42:7357", NULL };
+  parse( longLines );
+  CPPUNIT_ASSERT_EQUAL( -1, _parser->getCoordinatorPort() );
+  CPPUNIT_ASSERT_EQUAL( std::string( "build-42" ), _parser->getWorkerHost() );
+  CPPUNIT_ASSERT_EQUAL( 7357, _parser->getWorkerPort() );
+}
+
+
+void 
+CommandLineParserTest::testInvalidWorkerAddressThrow()
+{
+  static const char *lines[] = { "", "-W", "build-42", NULL };
+  parse( lines );
+}
+
+
+void 
+CommandLineParserTest::testCoordinatorAndWorkerThrow()
+{
+  static const char *lines[] = { "", "-C", "0", "-W", "localhost:7357", NULL };
+  parse( lines );
+}
+
+
+void 
+CommandLineParserTest::testCoordinatorTimeouts()
+{
+  static const char *lines[] = { "", "-C", "0", NULL };
+  parse( lines );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 300, _parser->getTestTimeout(), 1e-9 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 300, _parser->getWorkerWaitTimeout(), 1e-9 );
+
+  static const char *longLines[] = { "", "--test-timeout", "2.5", 
+                                     "--worker-wait", "0", NULL };
+  parse( longLines );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 2.5, _parser->getTestTimeout(), 1e-9 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0, _parser->getWorkerWaitTimeout(), 1e-9 );
+}
+
+
+void 
+CommandLineParserTest::testInvalidTimeoutThrow()
+{
+  static const char *lines[] = { "", "-O", "-1", NULL };
+  parse( lines );
+}
+
+
+void 
+CommandLineParserTest::testRunModes()
+{
+  static const char *lines[] = { "", "-P", "4", "-S", "1/3", "-T", "-h", NULL };
+  parse( lines );
+  CPPUNIT_ASSERT_EQUAL( 4, _parser->getThreadCount() );
+  CPPUNIT_ASSERT_EQUAL( 0, _parser->getProcessCount() );
+  CPPUNIT_ASSERT_EQUAL( 1, _parser->getShardIndex() );
+  CPPUNIT_ASSERT_EQUAL( 3, _parser->getShardCount() );
+  CPPUNIT_ASSERT( _parser->reportTiming() );
+  CPPUNIT_ASSERT( _parser->showHelp() );
+
+  static const char *longLines[] = { "", "--processes", "2", "--shard", "0/1", NULL };
+  parse( longLines );
+  CPPUNIT_ASSERT_EQUAL( 0, _parser->getThreadCount() );
+  CPPUNIT_ASSERT_EQUAL( 2, _parser->getProcessCount() );
+  CPPUNIT_ASSERT_EQUAL( 0, _parser->getShardIndex() );
+  CPPUNIT_ASSERT_EQUAL( 1, _parser->getShardCount() );
+  CPPUNIT_ASSERT( !_parser->reportTiming() );
+  CPPUNIT_ASSERT( !_parser->showHelp() );
+}
+
+
+void 
+CommandLineParserTest::testParallelAndProcessesThrow()
+{
+  static const char *lines[] = { "", "-P", "4", "-N", "2", NULL };
+  parse( lines );
+}
+
+
+void 
+CommandLineParserTest::testInvalidThreadCountThrow()
+{
+  static const char *lines[] = { "", "-P", "0", NULL };
+  parse( lines );
+}
+
+
+void 
+CommandLineParserTest::testInvalidShardThrow()
+{
+  static const char *lines[] = { "", "-S", "3/3", NULL };
+  parse( lines );
+}
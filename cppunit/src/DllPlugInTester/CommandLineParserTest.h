@@ -4,8 +4,10 @@
 #include <cppunit/extensions/HelperMacros.h>
 
 
+CPPUNIT_NS_BEGIN
 class CommandLineParser;
 class CommandLineParserException;
+CPPUNIT_NS_END
 
 
 class CommandLineParserTest : public CPPUNIT_NS::TestCase
@@ -17,10 +19,44 @@ class CommandLineParserTest : public CPPUNIT_NS::TestCase
   CPPUNIT_TEST( testFileName );
   CPPUNIT_TEST( testTestPath );
   CPPUNIT_TEST( testParameterWithSpace );
-  CPPUNIT_TEST_EXCEPTION( testMissingStyleSheetParameterThrow, CommandLineParserException);
-  CPPUNIT_TEST_EXCEPTION( testMissingEncodingParameterThrow, CommandLineParserException);
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST_EXCEPTION( testMissingStyleSheetParameterThrow, CPPUNIT_NS::CommandLineParserException );
+  CPPUNIT_TEST_EXCEPTION( testMissingEncodingParameterThrow, CPPUNIT_NS::CommandLineParserException );
+#endif
   CPPUNIT_TEST( testXmlFileNameIsOptional );
   CPPUNIT_TEST( testPlugInsWithParameters );
+  CPPUNIT_TEST( testTagExpression );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST_EXCEPTION( testMissingTagExpressionThrow, CPPUNIT_NS::CommandLineParserException );
+#endif
+  CPPUNIT_TEST( testUpdateSnapshots );
+  CPPUNIT_TEST( testBenchmarkControls );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST_EXCEPTION( testInvalidCpuListThrow, CPPUNIT_NS::CommandLineParserException );
+#endif
+  CPPUNIT_TEST( testBenchmarkResultFiles );
+  CPPUNIT_TEST( testProfileListeners );
+  CPPUNIT_TEST( testProfileStartup );
+  CPPUNIT_TEST( testMeasureIdleTime );
+  CPPUNIT_TEST( testLiveMetrics );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST_EXCEPTION( testInvalidMetricsWorkerThrow, CPPUNIT_NS::CommandLineParserException );
+#endif
+  CPPUNIT_TEST( testDistributed );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST_EXCEPTION( testInvalidWorkerAddressThrow, CPPUNIT_NS::CommandLineParserException );
+  CPPUNIT_TEST_EXCEPTION( testCoordinatorAndWorkerThrow, CPPUNIT_NS::CommandLineParserException );
+#endif
+  CPPUNIT_TEST( testCoordinatorTimeouts );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST_EXCEPTION( testInvalidTimeoutThrow, CPPUNIT_NS::CommandLineParserException );
+#endif
+  CPPUNIT_TEST( testRunModes );
+#if !defined(CPPUNIT_NO_EXCEPTIONS)
+  CPPUNIT_TEST_EXCEPTION( testParallelAndProcessesThrow, CPPUNIT_NS::CommandLineParserException );
+  CPPUNIT_TEST_EXCEPTION( testInvalidThreadCountThrow, CPPUNIT_NS::CommandLineParserException );
+  CPPUNIT_TEST_EXCEPTION( testInvalidShardThrow, CPPUNIT_NS::CommandLineParserException );
+#endif
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -40,6 +76,26 @@ public:
   void testMissingEncodingParameterThrow();
   void testXmlFileNameIsOptional();
   void testPlugInsWithParameters();
+  void testTagExpression();
+  void testMissingTagExpressionThrow();
+  void testUpdateSnapshots();
+  void testBenchmarkControls();
+  void testInvalidCpuListThrow();
+  void testBenchmarkResultFiles();
+  void testProfileListeners();
+  void testProfileStartup();
+  void testMeasureIdleTime();
+  void testLiveMetrics();
+  void testInvalidMetricsWorkerThrow();
+  void testDistributed();
+  void testInvalidWorkerAddressThrow();
+  void testCoordinatorAndWorkerThrow();
+  void testCoordinatorTimeouts();
+  void testInvalidTimeoutThrow();
+  void testRunModes();
+  void testParallelAndProcessesThrow();
+  void testInvalidThreadCountThrow();
+  void testInvalidShardThrow();
 
 private:
   CommandLineParserTest( const CommandLineParserTest &other );
@@ -48,7 +104,7 @@ private:
   void parse( const char **lines );
 
 private:
-  CommandLineParser *_parser;
+  CPPUNIT_NS::CommandLineParser *_parser;
 };
 
 
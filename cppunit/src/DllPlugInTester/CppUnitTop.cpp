@@ -0,0 +1,180 @@
+#include <cppunit/tools/Clock.h>
+#include <cppunit/tools/LiveMetricsSegment.h>
+#include <cppunit/portability/Stream.h>
+#include <stdexcept>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+
+/* Notes:
+
+  Shows the progress of the test processes that publish their metrics in a
+  live metrics segment (DllPlugInTester --live-metrics). The segment is
+  mapped read-only: watching a run does not slow it down.
+ */
+
+
+void
+printUsage( const std::string &applicationName )
+{
+  CPPUNIT_NS::stdCOut()  << "Usage:\n"
+             << applicationName  <<  " [-d delay] [-n count] segment-filename\n\n"
+"-d --delay seconds\n"
+"	Time between two refreshes (default is 1 second).\n"
+"-n --iterations count\n"
+"	Exit after count refreshes (default is to refresh until\n"
+"	interrupted). With a count of 1, the screen is not cleared.\n"
+"\n"
+"For each worker, shows the tests started and finished, the failures and\n"
+"errors, the tests per second, the resident memory, the time since the\n"
+"last update and the test being run.\n\n";
+}
+
+
+/// Writes the metrics of the workers of the segment.
+void
+writeWorkers( const CPPUNIT_NS::LiveMetricsSegment &segment,
+              const std::string &fileName )
+{
+  CPPUNIT_NS::OStream &stream = CPPUNIT_NS::stdCOut();
+  double now = CPPUNIT_NS::Clock::now();
+  CPPUNIT_NS::LiveWorkerMetrics total;
+  double totalTestsPerSecond = 0;
+  int workerCount = 0;
+  int runningCount = 0;
+  char line[ 160 ];
+
+  CPPUNIT_NS::OStringStream rows;
+  for ( int index =0; index < CPPUNIT_NS::LiveMetricsSegment::slotCount; ++index )
+  {
+    CPPUNIT_NS::LiveWorkerMetrics metrics = segment.readWorker( index );
+    if ( metrics.m_processId == 0 )
+      continue;
+
+    ++workerCount;
+    if ( metrics.m_running )
+    {
+      ++runningCount;
+      totalTestsPerSecond += metrics.testsPerSecond();
+    }
+    total.m_startedCount += metrics.m_startedCount;
+    total.m_finishedCount += metrics.m_finishedCount;
+    total.m_failureCount += metrics.m_failureCount;
+    total.m_errorCount += metrics.m_errorCount;
+    total.m_residentBytes += metrics.m_residentBytes;
+
+    sprintf( line, "%6d %7ld  %-8s %8ld %9ld %9ld %7ld %9.2f %10.1f %8.1f  ",
+             index,
+             metrics.m_processId,
+             metrics.m_running ? "running" : "finished",
+             metrics.m_startedCount,
+             metrics.m_finishedCount,
+             metrics.m_failureCount,
+             metrics.m_errorCount,
+             metrics.testsPerSecond(),
+             metrics.m_residentBytes / 1048576.0,
+             metrics.m_running ? now - metrics.m_updateTime : 0.0 );
+    rows << line << metrics.m_currentTest << "\n";
+  }
+
+  stream << "cppunit-top - " << fileName << " - " << workerCount << " workers, "
+         << runningCount << " running\n\n"
+         << "Worker     PID  State     Started  Finished  Failures  Errors"
+            "   Tests/s   RSS (MB) Last (s)  Current test\n"
+         << rows.str();
+  if ( workerCount > 1 )
+  {
+    sprintf( line, " Total                   %8ld %9ld %9ld %7ld %9.2f %10.1f\n",
+             total.m_startedCount,
+             total.m_finishedCount,
+             total.m_failureCount,
+             total.m_errorCount,
+             totalTestsPerSecond,
+             total.m_residentBytes / 1048576.0 );
+    stream << line;
+  }
+  stream.flush();
+}
+
+
+/*! Main
+ *
+ * Usage:
+ *
+ * cppunit-top [-d delay] [-n count] segment-filename
+ *
+ * The application exits with code 0 after the requested number of
+ * refreshes, and 2 if the command line is invalid or the segment can not be
+ * mapped.
+ */
+int
+main( int argc,
+      const char *argv[] )
+{
+  const int successReturnCode = 0;
+  const int badCommadLineReturnCode = 2;
+
+  std::string applicationName( argv[0] );
+  double delay = 1;
+  long iterationCount = 0;
+  std::string fileName;
+  for ( int index =1; index < argc; ++index )
+  {
+    std::string argument( argv[ index ] );
+    bool isDelay = argument == "-d"  ||  argument == "--delay";
+    bool isIterations = argument == "-n"  ||  argument == "--iterations";
+    if ( isDelay  ||  isIterations )
+    {
+      char *end = NULL;
+      double value = index +1 < argc ? strtod( argv[ ++index ], &end ) : -1;
+      if ( end == NULL  ||  *end != 0  ||  value <= 0 )
+      {
+        CPPUNIT_NS::stdCOut() << "Error while parsing command line: option "
+                              << argument << " expects a positive number\n\n";
+        printUsage( applicationName );
+        return badCommadLineReturnCode;
+      }
+      if ( isDelay )
+        delay = value;
+      else
+        iterationCount = long( value );
+    }
+    else if ( fileName.empty() )
+      fileName = argument;
+    else
+    {
+      printUsage( applicationName );
+      return badCommadLineReturnCode;
+    }
+  }
+
+  if ( fileName.empty() )
+  {
+    printUsage( applicationName );
+    return badCommadLineReturnCode;
+  }
+
+  try
+  {
+    CPPUNIT_NS::LiveMetricsSegment segment( fileName, false );
+    double refreshTime = CPPUNIT_NS::Clock::now();
+    for ( long iteration =0; iterationCount == 0  ||  iteration < iterationCount; ++iteration )
+    {
+      if ( iterationCount != 1 )
+        CPPUNIT_NS::stdCOut() << "\033[H\033[2J";
+      writeWorkers( segment, fileName );
+      if ( iteration +1 == iterationCount )
+        break;
+      refreshTime += delay;
+      CPPUNIT_NS::Clock::sleepUntil( refreshTime );
+    }
+  }
+  catch ( std::runtime_error &e )
+  {
+    CPPUNIT_NS::stdCOut() << e.what() << "\n";
+    return badCommadLineReturnCode;
+  }
+
+  return successReturnCode;
+}
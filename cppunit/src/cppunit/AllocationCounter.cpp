@@ -0,0 +1,71 @@
+#include <cppunit/tools/AllocationCounter.h>
+
+#if !defined(CPPUNIT_HAVE_THREAD_LOCAL)  &&  defined(CPPUNIT_HAVE_PTHREAD_H)
+#include <pthread.h>
+#define CPPUNIT_ALLOCATIONCOUNTER_CHECK_THREAD
+#endif
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Set by the first counted allocation.
+static volatile bool allocationCounterInstalled = false;
+
+/// Counter of the allocations of the thread, NULL if no counter is active.
+static CPPUNIT_THREAD_LOCAL int *activeAllocationCount = NULL;
+
+#if defined(CPPUNIT_ALLOCATIONCOUNTER_CHECK_THREAD)
+/// Thread that constructed the active counter.
+static pthread_t allocationCountingThread;
+#endif
+
+
+AllocationCounter::AllocationCounter()
+    : m_allocationCount( 0 )
+    , m_previousAllocationCount( activeAllocationCount )
+{
+#if defined(CPPUNIT_ALLOCATIONCOUNTER_CHECK_THREAD)
+  allocationCountingThread = pthread_self();
+#endif
+  activeAllocationCount = &m_allocationCount;
+}
+
+
+AllocationCounter::~AllocationCounter()
+{
+  activeAllocationCount = m_previousAllocationCount;
+}
+
+
+int 
+AllocationCounter::allocationCount() const
+{
+  return m_allocationCount;
+}
+
+
+bool 
+AllocationCounter::isInstalled()
+{
+  return allocationCounterInstalled;
+}
+
+
+void 
+AllocationCounter::recordAllocation()
+{
+  allocationCounterInstalled = true;
+
+  int *allocationCount = activeAllocationCount;
+  if ( allocationCount == NULL )
+    return;
+#if defined(CPPUNIT_ALLOCATIONCOUNTER_CHECK_THREAD)
+  if ( !pthread_equal( pthread_self(), allocationCountingThread ) )
+    return;
+#endif
+  ++*allocationCount;
+}
+
+
+CPPUNIT_NS_END
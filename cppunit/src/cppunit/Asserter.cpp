@@ -1,6 +1,8 @@
 #include <cppunit/Asserter.h>
+#include <cppunit/AssertionTrap.h>
 #include <cppunit/Exception.h>
 #include <cppunit/Message.h>
+#include <cppunit/ScopedTrace.h>
 
 
 CPPUNIT_NS_BEGIN
@@ -18,7 +20,13 @@ void
 Asserter::fail( const Message &message, 
                 const SourceLine &sourceLine )
 {
-  throw Exception( message, sourceLine );
+  Message tracedMessage( message );
+  TraceContext::addDetails( tracedMessage );
+#if defined(CPPUNIT_NO_EXCEPTIONS)
+  AssertionTrap::raise( new Exception( tracedMessage, sourceLine ) );
+#else
+  throw Exception( tracedMessage, sourceLine );
+#endif
 }
 
 
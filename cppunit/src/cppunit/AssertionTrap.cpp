@@ -0,0 +1,73 @@
+#include <cppunit/AssertionTrap.h>
+#include <cppunit/Exception.h>
+#include <cppunit/ScopedTrace.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Innermost trap of the thread.
+static CPPUNIT_THREAD_LOCAL AssertionTrap *innermostAssertionTrap = NULL;
+
+
+AssertionTrap::AssertionTrap()
+    : m_failure( NULL )
+    , m_previous( innermostAssertionTrap )
+    , m_traceContext( TraceContext::current() )
+{
+  innermostAssertionTrap = this;
+}
+
+
+AssertionTrap::~AssertionTrap()
+{
+  innermostAssertionTrap = m_previous;
+  delete m_failure;
+}
+
+
+jmp_buf &
+AssertionTrap::jumpBuffer()
+{
+  return m_jumpBuffer;
+}
+
+
+const Exception *
+AssertionTrap::failure() const
+{
+  return m_failure;
+}
+
+
+AssertionTrap *
+AssertionTrap::current()
+{
+  return innermostAssertionTrap;
+}
+
+
+void
+AssertionTrap::raise( Exception *failure )
+{
+  AssertionTrap *trap = innermostAssertionTrap;
+  if ( trap == NULL )
+  {
+    fprintf( stderr, "%s:%d: assertion failed outside of a test: %s\n",
+             failure->sourceLine().fileName().c_str(),
+             failure->sourceLine().lineNumber(),
+             failure->what() );
+    abort();
+  }
+
+  delete trap->m_failure;
+  trap->m_failure = failure;
+  // longjmp() does not destroy the trace contexts it returns through.
+  TraceContext::unwindTo( trap->m_traceContext );
+  longjmp( trap->m_jumpBuffer, 1 );
+}
+
+
+CPPUNIT_NS_END
@@ -0,0 +1,1168 @@
+#include <cppunit/Asserter.h>
+#include <cppunit/Message.h>
+#include <cppunit/extensions/Benchmark.h>
+#include <cppunit/portability/Stream.h>
+#include <cppunit/tools/Clock.h>
+#include <cppunit/tools/StringTools.h>
+#include <cppunit/tools/ThreadGroup.h>
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Maximum number of iterations of a measurement.
+static const long benchmarkMaximumIterations = 1000000000L;
+
+/// Size of the eviction buffer if the size of the caches is not known.
+static const long benchmarkDefaultEvictionSize = 64L * 1024 * 1024;
+
+/// Distance between two bytes read to evict the caches (a cache line).
+static const int benchmarkCacheLineSize = 64;
+
+
+/// Returns the median of the specified values, 0 if there is none.
+static double
+benchmarkMedian( CppUnitVector<double> values )
+{
+  if ( values.empty() )
+    return 0;
+  std::sort( values.begin(), values.end() );
+  int middle = values.size() / 2;
+  if ( values.size() % 2 == 1 )
+    return values[ middle ];
+  return (values[ middle -1 ] + values[ middle ]) / 2;
+}
+
+
+BenchmarkCacheEvictor::BenchmarkCacheEvictor( long byteCount )
+{
+  if ( byteCount <= 0 )
+  {
+    long cacheSize = lastLevelCacheSize();
+    byteCount = cacheSize > 0 ? 2 * cacheSize : benchmarkDefaultEvictionSize;
+  }
+
+  // Written once, so that the buffer is backed by its own memory pages.
+  m_buffer.resize( byteCount, 1 );
+}
+
+
+BenchmarkCacheEvictor::~BenchmarkCacheEvictor()
+{
+}
+
+
+long
+BenchmarkCacheEvictor::byteCount() const
+{
+  return m_buffer.size();
+}
+
+
+int
+BenchmarkCacheEvictor::evict() const
+{
+  int checksum = 0;
+  for ( unsigned int index =0; 
+        index < m_buffer.size(); 
+        index += benchmarkCacheLineSize )
+    checksum += m_buffer[ index ];
+  return checksum;
+}
+
+
+long
+BenchmarkCacheEvictor::lastLevelCacheSize()
+{
+  long largestSize = 0;
+  for ( int index =0; index < 10; ++index )
+  {
+    std::string text = BenchmarkEnvironment::readFirstLine( 
+        "/sys/devices/system/cpu/cpu0/cache/index" + 
+        StringTools::toString( index ) + "/size" );
+    if ( text.empty() )
+      continue;
+
+    // The size is written with a unit suffix, such as "32K" or "8192K".
+    long size = atol( text.c_str() );
+    char unit = text[ text.length() -1 ];
+    if ( unit == 'K' )
+      size *= 1024;
+    else if ( unit == 'M' )
+      size *= 1024 * 1024;
+    largestSize = std::max( largestSize, size );
+  }
+  return largestSize;
+}
+
+
+
+BenchmarkState::BenchmarkState( long size,
+                                long iterationCount,
+                                int threadIndex,
+                                int threadCount,
+                                ThreadBarrier *startBarrier )
+    : m_size( size )
+    , m_iterationCount( iterationCount )
+    , m_remainingCount( iterationCount )
+    , m_threadIndex( threadIndex )
+    , m_threadCount( threadCount )
+    , m_startBarrier( startBarrier )
+    , m_started( false )
+    , m_finished( false )
+    , m_timing( false )
+    , m_startTime( 0 )
+    , m_elapsedSeconds( 0 )
+    , m_useManualTime( false )
+    , m_manualSeconds( 0 )
+    , m_cacheEvictor( NULL )
+    , m_bytesProcessed( 0 )
+    , m_itemsProcessed( 0 )
+{
+}
+
+
+BenchmarkState::~BenchmarkState()
+{
+}
+
+
+long
+BenchmarkState::size() const
+{
+  return m_size;
+}
+
+
+long
+BenchmarkState::iterationCount() const
+{
+  return m_iterationCount;
+}
+
+
+int
+BenchmarkState::threadIndex() const
+{
+  return m_threadIndex;
+}
+
+
+int
+BenchmarkState::threadCount() const
+{
+  return m_threadCount;
+}
+
+
+bool
+BenchmarkState::keepRunning()
+{
+  start();
+
+  if ( m_remainingCount > 0 )
+  {
+    if ( m_cacheEvictor != NULL )
+    {
+      bool timing = m_timing;
+      pauseTiming();
+      m_cacheEvictor->evict();
+      if ( timing )
+        resumeTiming();
+    }
+    --m_remainingCount;
+    return true;
+  }
+
+  if ( !m_finished )
+  {
+    pauseTiming();
+    m_finished = true;
+  }
+  return false;
+}
+
+
+void
+BenchmarkState::start()
+{
+  if ( m_started )
+    return;
+
+  m_started = true;
+  if ( m_startBarrier != NULL )
+    m_startBarrier->wait();
+  resumeTiming();
+}
+
+
+void
+BenchmarkState::pauseTiming()
+{
+  if ( !m_timing )
+    return;
+  m_elapsedSeconds += Clock::now() - m_startTime;
+  m_timing = false;
+}
+
+
+void
+BenchmarkState::resumeTiming()
+{
+  if ( m_timing )
+    return;
+  m_startTime = Clock::now();
+  m_timing = true;
+}
+
+
+void
+BenchmarkState::setIterationTime( double seconds )
+{
+  m_useManualTime = true;
+  m_manualSeconds += seconds;
+}
+
+
+void
+BenchmarkState::setCacheEvictor( const BenchmarkCacheEvictor *evictor )
+{
+  m_cacheEvictor = evictor;
+}
+
+
+void
+BenchmarkState::setBytesProcessed( long byteCount )
+{
+  m_bytesProcessed = byteCount;
+}
+
+
+long
+BenchmarkState::bytesProcessed() const
+{
+  return m_bytesProcessed;
+}
+
+
+void
+BenchmarkState::setItemsProcessed( long itemCount )
+{
+  m_itemsProcessed = itemCount;
+}
+
+
+long
+BenchmarkState::itemsProcessed() const
+{
+  return m_itemsProcessed;
+}
+
+
+bool
+BenchmarkState::isFinished() const
+{
+  return m_finished;
+}
+
+
+double
+BenchmarkState::elapsedSeconds() const
+{
+  return m_useManualTime ? m_manualSeconds : m_elapsedSeconds;
+}
+
+
+
+BenchmarkResult::BenchmarkResult()
+    : m_hasComplexity( false )
+    , m_complexity( complexityConstant )
+    , m_coefficient( 0 )
+    , m_rms( 0 )
+{
+}
+
+
+BenchmarkResult::~BenchmarkResult()
+{
+}
+
+
+void
+BenchmarkResult::addSample( long size,
+                            long iterationCount,
+                            double seconds,
+                            long bytesPerIteration,
+                            long itemsPerIteration )
+{
+  if ( m_series.empty()  ||  m_series.back().m_size != size )
+  {
+    Series series;
+    series.m_size = size;
+    m_series.push_back( series );
+  }
+
+  Series &series = m_series.back();
+  series.m_iterationCount = iterationCount;
+  series.m_bytesPerIteration = bytesPerIteration;
+  series.m_itemsPerIteration = itemsPerIteration;
+  series.m_samples.push_back( iterationCount > 0 ? seconds / iterationCount
+                                                 : seconds );
+}
+
+
+int
+BenchmarkResult::sizeCount() const
+{
+  return m_series.size();
+}
+
+
+long
+BenchmarkResult::sizeAt( int index ) const
+{
+  return m_series[ index ].m_size;
+}
+
+
+long
+BenchmarkResult::iterationCountAt( int index ) const
+{
+  return m_series[ index ].m_iterationCount;
+}
+
+
+const CppUnitVector<double> &
+BenchmarkResult::samplesAt( int index ) const
+{
+  return m_series[ index ].m_samples;
+}
+
+
+double
+BenchmarkResult::medianAt( int index ) const
+{
+  return benchmarkMedian( m_series[ index ].m_samples );
+}
+
+
+double
+BenchmarkResult::minimumAt( int index ) const
+{
+  const CppUnitVector<double> &samples = m_series[ index ].m_samples;
+  if ( samples.empty() )
+    return 0;
+  return *std::min_element( samples.begin(), samples.end() );
+}
+
+
+double
+BenchmarkResult::maximumAt( int index ) const
+{
+  const CppUnitVector<double> &samples = m_series[ index ].m_samples;
+  if ( samples.empty() )
+    return 0;
+  return *std::max_element( samples.begin(), samples.end() );
+}
+
+
+long
+BenchmarkResult::bytesPerIterationAt( int index ) const
+{
+  return m_series[ index ].m_bytesPerIteration;
+}
+
+
+long
+BenchmarkResult::itemsPerIterationAt( int index ) const
+{
+  return m_series[ index ].m_itemsPerIteration;
+}
+
+
+double
+BenchmarkResult::bytesPerSecondAt( int index ) const
+{
+  double median = medianAt( index );
+  return median > 0 ? m_series[ index ].m_bytesPerIteration / median : 0;
+}
+
+
+double
+BenchmarkResult::itemsPerSecondAt( int index ) const
+{
+  double median = medianAt( index );
+  return median > 0 ? m_series[ index ].m_itemsPerIteration / median : 0;
+}
+
+
+void
+BenchmarkResult::fitComplexity()
+{
+  m_hasComplexity = false;
+  int count = m_series.size();
+  if ( count < 3 )
+    return;
+
+  CppUnitVector<double> medians;
+  double sumTimes = 0;
+  for ( int index =0; index < count; ++index )
+  {
+    medians.push_back( medianAt( index ) );
+    sumTimes += medians.back();
+  }
+  double meanTime = sumTimes / count;
+
+  for ( int complexity = complexityConstant;
+        complexity < complexityAny;
+        ++complexity )
+  {
+    // Least squares fit of time = coefficient * f(size).
+    double sumTimeByFunction = 0;
+    double sumSquaredFunction = 0;
+    for ( int index =0; index < count; ++index )
+    {
+      double function = complexityFunction( BenchmarkComplexity(complexity),
+                                            m_series[ index ].m_size );
+      sumTimeByFunction += medians[ index ] * function;
+      sumSquaredFunction += function * function;
+    }
+    if ( sumSquaredFunction == 0 )
+      continue;
+
+    double coefficient = sumTimeByFunction / sumSquaredFunction;
+    double sumSquaredErrors = 0;
+    for ( int errorIndex =0; errorIndex < count; ++errorIndex )
+    {
+      double error = medians[ errorIndex ] - coefficient *
+          complexityFunction( BenchmarkComplexity(complexity),
+                              m_series[ errorIndex ].m_size );
+      sumSquaredErrors += error * error;
+    }
+    double rms = meanTime > 0 ? sqrt( sumSquaredErrors / count ) / meanTime
+                              : 0;
+
+    if ( !m_hasComplexity  ||  rms < m_rms )
+    {
+      m_hasComplexity = true;
+      m_complexity = BenchmarkComplexity(complexity);
+      m_coefficient = coefficient;
+      m_rms = rms;
+    }
+  }
+}
+
+
+bool
+BenchmarkResult::hasComplexity() const
+{
+  return m_hasComplexity;
+}
+
+
+BenchmarkComplexity
+BenchmarkResult::complexity() const
+{
+  return m_complexity;
+}
+
+
+double
+BenchmarkResult::coefficient() const
+{
+  return m_coefficient;
+}
+
+
+double
+BenchmarkResult::rms() const
+{
+  return m_rms;
+}
+
+
+std::string
+BenchmarkResult::complexitySummary() const
+{
+  if ( !m_hasComplexity )
+    return "no complexity fitted";
+
+  static const char *terms[] = { "", " * log n", " * n", " * n log n",
+                                 " * n^2", " * n^3" };
+  OStringStream summary;
+  summary << complexityName( m_complexity ) << ", " << m_coefficient
+          << terms[ m_complexity ] << " s (rms " << m_rms * 100 << "%)";
+  return summary.str();
+}
+
+
+std::string
+BenchmarkResult::complexityName( BenchmarkComplexity complexity )
+{
+  switch ( complexity )
+  {
+  case complexityConstant:
+    return "O(1)";
+  case complexityLogarithmic:
+    return "O(log n)";
+  case complexityLinear:
+    return "O(n)";
+  case complexityLinearithmic:
+    return "O(n log n)";
+  case complexityQuadratic:
+    return "O(n^2)";
+  case complexityCubic:
+    return "O(n^3)";
+  default:
+    return "any";
+  }
+}
+
+
+double
+BenchmarkResult::complexityFunction( BenchmarkComplexity complexity,
+                                     double size )
+{
+  double n = size > 1 ? size : 1;
+  switch ( complexity )
+  {
+  case complexityConstant:
+    return 1;
+  case complexityLogarithmic:
+    return log( n ) / log( 2.0 );
+  case complexityLinear:
+    return n;
+  case complexityLinearithmic:
+    return n * log( n ) / log( 2.0 );
+  case complexityQuadratic:
+    return n * n;
+  case complexityCubic:
+    return n * n * n;
+  default:
+    return 0;
+  }
+}
+
+
+std::string
+BenchmarkResult::rateToString( double perSecond,
+                               const std::string &unit )
+{
+  static const char *prefixes[] = { "", "k", "M", "G", "T" };
+  int prefixIndex = 0;
+  while ( perSecond >= 1000  &&  prefixIndex < 4 )
+  {
+    perSecond /= 1000;
+    ++prefixIndex;
+  }
+
+  char rate[ 64 ];
+  sprintf( rate, "%.3g ", perSecond );
+  return rate + std::string( prefixes[ prefixIndex ] ) + unit + "/s";
+}
+
+
+void
+BenchmarkResult::addThreadSample( int threadCount,
+                                  long iterationCount,
+                                  const CppUnitVector<double> &threadSeconds,
+                                  long bytesPerIteration,
+                                  long itemsPerIteration )
+{
+  if ( m_threadSeries.empty()  ||  
+       m_threadSeries.back().m_threadCount != threadCount )
+  {
+    ThreadSeries series;
+    series.m_threadCount = threadCount;
+    m_threadSeries.push_back( series );
+  }
+
+  double slowestSeconds = 0;
+  double sumThroughputs = 0;
+  CppUnitVector<double> throughputs;
+  for ( CppUnitVector<double>::const_iterator it = threadSeconds.begin();
+        it != threadSeconds.end();
+        ++it )
+  {
+    slowestSeconds = std::max( slowestSeconds, *it );
+    throughputs.push_back( *it > 0 ? iterationCount / *it : 0 );
+    sumThroughputs += throughputs.back();
+  }
+
+  double deviation = 0;
+  if ( !throughputs.empty()  &&  sumThroughputs > 0 )
+  {
+    double mean = sumThroughputs / throughputs.size();
+    double sumSquaredDifferences = 0;
+    for ( unsigned int index =0; index < throughputs.size(); ++index )
+    {
+      double difference = throughputs[ index ] - mean;
+      sumSquaredDifferences += difference * difference;
+    }
+    deviation = sqrt( sumSquaredDifferences / throughputs.size() ) / mean;
+  }
+
+  ThreadSeries &series = m_threadSeries.back();
+  series.m_iterationCount = iterationCount;
+  series.m_bytesPerIteration = bytesPerIteration;
+  series.m_itemsPerIteration = itemsPerIteration;
+  series.m_throughputs.push_back( slowestSeconds > 0 
+      ? double(iterationCount) * threadSeconds.size() / slowestSeconds 
+      : 0 );
+  series.m_deviations.push_back( deviation );
+}
+
+
+int
+BenchmarkResult::threadPointCount() const
+{
+  return m_threadSeries.size();
+}
+
+
+int
+BenchmarkResult::threadCountAt( int index ) const
+{
+  return m_threadSeries[ index ].m_threadCount;
+}
+
+
+long
+BenchmarkResult::threadIterationCountAt( int index ) const
+{
+  return m_threadSeries[ index ].m_iterationCount;
+}
+
+
+double
+BenchmarkResult::throughputAt( int index ) const
+{
+  return benchmarkMedian( m_threadSeries[ index ].m_throughputs );
+}
+
+
+double
+BenchmarkResult::threadDeviationAt( int index ) const
+{
+  return benchmarkMedian( m_threadSeries[ index ].m_deviations );
+}
+
+
+double
+BenchmarkResult::efficiencyAt( int index ) const
+{
+  double baseThroughput = throughputAt( 0 ) / threadCountAt( 0 );
+  if ( baseThroughput <= 0 )
+    return 0;
+  return throughputAt( index ) / threadCountAt( index ) / baseThroughput;
+}
+
+
+double
+BenchmarkResult::threadBytesPerSecondAt( int index ) const
+{
+  return throughputAt( index ) * m_threadSeries[ index ].m_bytesPerIteration;
+}
+
+
+double
+BenchmarkResult::threadItemsPerSecondAt( int index ) const
+{
+  return throughputAt( index ) * m_threadSeries[ index ].m_itemsPerIteration;
+}
+
+
+void
+BenchmarkResult::setEnvironment( const BenchmarkEnvironment &environment )
+{
+  m_environment = environment;
+}
+
+
+const BenchmarkEnvironment &
+BenchmarkResult::environment() const
+{
+  return m_environment;
+}
+
+
+
+/// Runs a benchmark on each thread of a ThreadGroup.
+class BenchmarkThreadTask : public ThreadTask
+{
+public:
+  BenchmarkThreadTask( BenchmarkFunction &benchmark,
+                       const BenchmarkControls &controls,
+                       const BenchmarkCacheEvictor *cacheEvictor,
+                       long size,
+                       long iterationCount,
+                       int threadCount )
+      : m_benchmark( benchmark )
+      , m_controls( controls )
+      , m_cacheEvictor( cacheEvictor )
+      , m_size( size )
+      , m_iterationCount( iterationCount )
+      , m_threadCount( threadCount )
+      , m_startBarrier( threadCount )
+      , m_threadSeconds( threadCount, 0 )
+      , m_finished( threadCount, 0 )
+      , m_pinFailed( threadCount, 0 )
+      , m_bytesProcessed( 0 )
+      , m_itemsProcessed( 0 )
+  {
+  }
+
+  void run( int threadIndex )
+  {
+    BenchmarkThreadControl control( m_controls, threadIndex );
+    m_pinFailed[ threadIndex ] = m_controls.pinsThreads()  &&  control.cpu() < 0;
+
+    BenchmarkState state( m_size, m_iterationCount, 
+                          threadIndex, m_threadCount, &m_startBarrier );
+    state.setCacheEvictor( m_cacheEvictor );
+    try
+    {
+      m_benchmark.run( state );
+    }
+    catch ( ... )
+    {
+      // The other threads must not wait for this one.
+      state.start();
+      throw;
+    }
+    state.start();
+
+    m_threadSeconds[ threadIndex ] = state.elapsedSeconds();
+    m_finished[ threadIndex ] = state.isFinished();
+    if ( threadIndex == 0 )
+    {
+      m_bytesProcessed = state.bytesProcessed();
+      m_itemsProcessed = state.itemsProcessed();
+    }
+  }
+
+  const CppUnitVector<double> &threadSeconds() const
+  {
+    return m_threadSeconds;
+  }
+
+  bool isFinished() const
+  {
+    for ( int index =0; index < m_threadCount; ++index )
+    {
+      if ( !m_finished[ index ] )
+        return false;
+    }
+    return true;
+  }
+
+  long bytesProcessed() const
+  {
+    return m_bytesProcessed;
+  }
+
+  long itemsProcessed() const
+  {
+    return m_itemsProcessed;
+  }
+
+  bool hasPinFailed() const
+  {
+    for ( int index =0; index < m_threadCount; ++index )
+    {
+      if ( m_pinFailed[ index ] )
+        return true;
+    }
+    return false;
+  }
+
+private:
+  BenchmarkFunction &m_benchmark;
+  const BenchmarkControls &m_controls;
+  const BenchmarkCacheEvictor *m_cacheEvictor;
+  long m_size;
+  long m_iterationCount;
+  int m_threadCount;
+  ThreadBarrier m_startBarrier;
+  CppUnitVector<double> m_threadSeconds;
+  // Not bool: each thread writes its own elements, and a vector<bool> packs
+  // the elements of several threads in the same word.
+  CppUnitVector<char> m_finished;
+  CppUnitVector<char> m_pinFailed;
+  long m_bytesProcessed;
+  long m_itemsProcessed;
+};
+
+
+
+BenchmarkRunner::BenchmarkRunner( long firstSize,
+                                  long lastSize )
+    : m_firstSize( firstSize )
+    , m_lastSize( lastSize )
+    , m_rangeMultiplier( 8 )
+    , m_minimumTime( 0.01 )
+    , m_sampleCount( 5 )
+    , m_controls( &BenchmarkControls::getControls() )
+    , m_cacheEvictor( NULL )
+{
+}
+
+
+BenchmarkRunner::~BenchmarkRunner()
+{
+  delete m_cacheEvictor;
+}
+
+
+void
+BenchmarkRunner::setRange( long firstSize,
+                           long lastSize )
+{
+  m_firstSize = firstSize;
+  m_lastSize = lastSize;
+}
+
+
+void
+BenchmarkRunner::setRangeMultiplier( int multiplier )
+{
+  m_rangeMultiplier = multiplier > 1 ? multiplier : 2;
+}
+
+
+int
+BenchmarkRunner::rangeMultiplier() const
+{
+  return m_rangeMultiplier;
+}
+
+
+void
+BenchmarkRunner::setMinimumTime( double seconds )
+{
+  m_minimumTime = seconds;
+}
+
+
+double
+BenchmarkRunner::minimumTime() const
+{
+  return m_minimumTime;
+}
+
+
+void
+BenchmarkRunner::setSampleCount( int sampleCount )
+{
+  m_sampleCount = sampleCount > 0 ? sampleCount : 1;
+}
+
+
+int
+BenchmarkRunner::sampleCount() const
+{
+  return m_sampleCount;
+}
+
+
+void
+BenchmarkRunner::setControls( const BenchmarkControls &controls )
+{
+  m_controls = &controls;
+}
+
+
+const BenchmarkControls &
+BenchmarkRunner::controls() const
+{
+  return *m_controls;
+}
+
+
+void
+BenchmarkRunner::setCacheState( BenchmarkCacheState cacheState,
+                                long evictionByteCount )
+{
+  delete m_cacheEvictor;
+  m_cacheEvictor = NULL;
+  if ( cacheState == cacheCold )
+    m_cacheEvictor = new BenchmarkCacheEvictor( evictionByteCount );
+}
+
+
+BenchmarkCacheState
+BenchmarkRunner::cacheState() const
+{
+  return m_cacheEvictor != NULL ? cacheCold : cacheWarm;
+}
+
+
+CppUnitVector<long>
+BenchmarkRunner::sizes() const
+{
+  CppUnitVector<long> sizes;
+  sizes.push_back( m_firstSize );
+  if ( m_lastSize <= m_firstSize )
+    return sizes;
+
+  long size = m_firstSize > 0 ? m_firstSize : 1;
+  while ( size <= m_lastSize / m_rangeMultiplier )
+  {
+    size *= m_rangeMultiplier;
+    if ( size < m_lastSize )
+      sizes.push_back( size );
+  }
+  sizes.push_back( m_lastSize );
+  return sizes;
+}
+
+
+BenchmarkResult
+BenchmarkRunner::run( BenchmarkFunction &benchmark ) const
+{
+  BenchmarkThreadControl control( *m_controls );
+  BenchmarkResult result;
+  result.setEnvironment( detectEnvironment( control ) );
+  CppUnitVector<long> benchmarkedSizes = sizes();
+  for ( CppUnitVector<long>::const_iterator it = benchmarkedSizes.begin();
+        it != benchmarkedSizes.end();
+        ++it )
+  {
+    long size = *it;
+    long iterationCount = calibrate( benchmark, size );
+    for ( int sampleIndex =0; sampleIndex < m_sampleCount; ++sampleIndex )
+      sample( benchmark, size, iterationCount, result );
+  }
+
+  result.fitComplexity();
+  return result;
+}
+
+
+BenchmarkResult
+BenchmarkRunner::runThreads( BenchmarkFunction &benchmark,
+                             int maximumThreadCount ) const
+{
+  BenchmarkThreadControl control( *m_controls );
+  BenchmarkEnvironment environment = detectEnvironment( control );
+  BenchmarkResult result;
+  bool allPinned = true;
+  long iterationCount = calibrate( benchmark, m_firstSize );
+  CppUnitVector<int> benchmarkedThreadCounts = threadCounts( maximumThreadCount );
+  for ( CppUnitVector<int>::const_iterator it = benchmarkedThreadCounts.begin();
+        it != benchmarkedThreadCounts.end();
+        ++it )
+  {
+    for ( int sampleIndex =0; sampleIndex < m_sampleCount; ++sampleIndex )
+    {
+      if ( !measureThreads( benchmark, m_firstSize, iterationCount, *it, 
+                            result ) )
+        allPinned = false;
+    }
+  }
+
+  if ( !allPinned )
+    environment.addWarning( "Could not pin all the benchmark threads to "
+                            "their CPU." );
+  result.setEnvironment( environment );
+  return result;
+}
+
+
+CppUnitVector<BenchmarkResult>
+BenchmarkRunner::runInterleaved( 
+    const CppUnitVector<BenchmarkFunction *> &benchmarks ) const
+{
+  BenchmarkThreadControl control( *m_controls );
+  int benchmarkCount = benchmarks.size();
+  CppUnitVector<BenchmarkResult> results( benchmarkCount );
+  BenchmarkEnvironment environment = detectEnvironment( control );
+  environment.setFact( "interleaved", StringTools::toString( benchmarkCount ) );
+
+  CppUnitVector<long> benchmarkedSizes = sizes();
+  for ( CppUnitVector<long>::const_iterator it = benchmarkedSizes.begin();
+        it != benchmarkedSizes.end();
+        ++it )
+  {
+    long size = *it;
+    CppUnitVector<long> iterationCounts;
+    for ( int index =0; index < benchmarkCount; ++index )
+      iterationCounts.push_back( calibrate( *benchmarks[ index ], size ) );
+
+    for ( int round =0; round < m_sampleCount; ++round )
+    {
+      for ( int offset =0; offset < benchmarkCount; ++offset )
+      {
+        int index = (round + offset) % benchmarkCount;
+        sample( *benchmarks[ index ], 
+                size, 
+                iterationCounts[ index ], 
+                results[ index ] );
+      }
+    }
+  }
+
+  for ( int resultIndex =0; resultIndex < benchmarkCount; ++resultIndex )
+  {
+    results[ resultIndex ].fitComplexity();
+    results[ resultIndex ].setEnvironment( environment );
+  }
+  return results;
+}
+
+
+CppUnitVector<int>
+BenchmarkRunner::threadCounts( int maximumThreadCount )
+{
+  CppUnitVector<int> threadCounts;
+  int threadCount = 1;
+  for ( ; threadCount < maximumThreadCount; threadCount *= 2 )
+    threadCounts.push_back( threadCount );
+  threadCounts.push_back( maximumThreadCount > 1 ? maximumThreadCount : 1 );
+  return threadCounts;
+}
+
+
+BenchmarkEnvironment
+BenchmarkRunner::detectEnvironment( const BenchmarkThreadControl &control ) const
+{
+  BenchmarkEnvironment environment = BenchmarkEnvironment::detect();
+  control.addFacts( environment );
+  if ( m_cacheEvictor != NULL )
+  {
+    OStringStream byteCount;
+    byteCount << m_cacheEvictor->byteCount();
+    environment.setFact( "cacheEviction", byteCount.str() );
+  }
+  return environment;
+}
+
+
+long
+BenchmarkRunner::calibrate( BenchmarkFunction &benchmark,
+                            long size ) const
+{
+  // Increases the number of iterations until a measurement lasts long
+  // enough. These measurements also warm up the caches. The evictions of a
+  // cold benchmark are not timed but are counted here, otherwise a fast
+  // benchmark would run a huge number of them.
+  long iterationCount = 1;
+  while ( iterationCount < benchmarkMaximumIterations )
+  {
+    BenchmarkState state( size, iterationCount );
+    double startTime = Clock::now();
+    double seconds = measure( benchmark, state );
+    if ( m_cacheEvictor != NULL )
+      seconds = Clock::now() - startTime;
+    if ( seconds >= m_minimumTime )
+      break;
+
+    double multiplier = seconds > 0 ? 1.4 * m_minimumTime / seconds : 10;
+    multiplier = std::min( 10.0, std::max( 2.0, multiplier ) );
+    iterationCount = std::min( double(benchmarkMaximumIterations),
+                               iterationCount * multiplier ) +0.5;
+  }
+  return iterationCount;
+}
+
+
+void
+BenchmarkRunner::sample( BenchmarkFunction &benchmark,
+                         long size,
+                         long iterationCount,
+                         BenchmarkResult &result ) const
+{
+  BenchmarkState state( size, iterationCount );
+  double seconds = measure( benchmark, state );
+  result.addSample( size,
+                    iterationCount,
+                    seconds,
+                    state.bytesProcessed(),
+                    state.itemsProcessed() );
+}
+
+
+double
+BenchmarkRunner::measure( BenchmarkFunction &benchmark,
+                          BenchmarkState &state ) const
+{
+  state.setCacheEvictor( m_cacheEvictor );
+  benchmark.run( state );
+  if ( !state.isFinished() )
+    Asserter::fail( Message( "benchmark loop not completed",
+                             "The benchmark must call keepRunning() until it "
+                             "returns false." ) );
+  return state.elapsedSeconds();
+}
+
+
+bool
+BenchmarkRunner::measureThreads( BenchmarkFunction &benchmark,
+                                 long size,
+                                 long iterationCount,
+                                 int threadCount,
+                                 BenchmarkResult &result ) const
+{
+  BenchmarkThreadTask task( benchmark, *m_controls, m_cacheEvictor,
+                            size, iterationCount, threadCount );
+  ThreadGroup::run( task, threadCount );
+  if ( !task.isFinished() )
+    Asserter::fail( Message( "benchmark loop not completed",
+                             "The benchmark must call keepRunning() until it "
+                             "returns false." ) );
+  result.addThreadSample( threadCount, 
+                          iterationCount, 
+                          task.threadSeconds(),
+                          task.bytesProcessed(),
+                          task.itemsProcessed() );
+  return !task.hasPinFailed();
+}
+
+
+
+void
+assertComplexity( const BenchmarkResult &result,
+                  BenchmarkComplexity maximumComplexity,
+                  SourceLine sourceLine,
+                  const std::string &message )
+{
+  if ( !result.hasComplexity() )
+  {
+    Message failure( "complexity not fitted",
+                     "At least 3 sizes are needed to fit a complexity class" );
+    if ( !message.empty() )
+      failure.addDetail( message );
+    Asserter::fail( failure, sourceLine );
+  }
+
+  if ( result.complexity() <= maximumComplexity )
+    return;
+
+  Message failure( "complexity bound exceeded",
+                   "Expected: " +
+                       BenchmarkResult::complexityName( maximumComplexity ) +
+                       " or better",
+                   "Actual  : " + result.complexitySummary() );
+  for ( int index =0; index < result.sizeCount(); ++index )
+  {
+    OStringStream timing;
+    timing << "n=" << result.sizeAt( index ) << ": " << result.medianAt( index )
+           << " s";
+    if ( result.bytesPerSecondAt( index ) > 0 )
+      timing << " (" 
+             << BenchmarkResult::rateToString( result.bytesPerSecondAt( index ), 
+                                               "B" ) 
+             << ")";
+    failure.addDetail( timing.str() );
+  }
+  if ( !message.empty() )
+    failure.addDetail( message );
+  Asserter::fail( failure, sourceLine );
+}
+
+
+CPPUNIT_NS_END
@@ -0,0 +1,374 @@
+#include <cppunit/extensions/BenchmarkComparison.h>
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Largest sample size for which the exact distribution of U is computed.
+static const int comparisonExactMaximumSize = 20;
+
+
+/// Returns the median of the specified values, 0 if there is none.
+static double
+comparisonMedian( CppUnitVector<double> values )
+{
+  if ( values.empty() )
+    return 0;
+  std::sort( values.begin(), values.end() );
+  int middle = values.size() / 2;
+  if ( values.size() % 2 == 1 )
+    return values[ middle ];
+  return (values[ middle -1 ] + values[ middle ]) / 2;
+}
+
+
+/*! \brief Returns the probability that a standard normal variable is greater
+ *         than \a z.
+ *
+ * Uses the approximation 7.1.26 of erfc() from Abramowitz and Stegun
+ * (absolute error below 1.5e-7), erfc() is not available on all platforms.
+ */
+static double
+comparisonNormalTail( double z )
+{
+  double x = fabs( z ) / sqrt( 2.0 );
+  double t = 1 / (1 + 0.3275911 * x);
+  double erfc = t * (0.254829592 + t * (-0.284496736 + t * (1.421413741 +
+                t * (-1.453152027 + t * 1.061405429)))) * exp( -x * x );
+  return z >= 0 ? erfc / 2 : 1 - erfc / 2;
+}
+
+
+/*! \brief Returns the number of orderings of two samples for each value of U.
+ *
+ * U is the number of pairs (x, y) with x of the first sample greater than y
+ * of the second. Uses N(u; m, n) = N(u - n; m-1, n) + N(u; m, n-1): the
+ * largest value belongs either to the first sample, and is greater than the
+ * n values of the second, or to the second sample.
+ */
+static CppUnitVector<double>
+comparisonExactCounts( int firstSize,
+                       int secondSize )
+{
+  // counts[ n ] is the distribution for m first values and n second values.
+  CppUnitVector< CppUnitVector<double> > counts( secondSize +1 );
+  for ( int n =0; n <= secondSize; ++n )
+    counts[ n ] = CppUnitVector<double>( 1, 1.0 );
+
+  for ( int m =1; m <= firstSize; ++m )
+  {
+    CppUnitVector<double> previous( 1, 1.0 );  // N(u; m, 0)
+    counts[ 0 ] = previous;
+    for ( int n =1; n <= secondSize; ++n )
+    {
+      // counts[ n ] still holds N(.; m-1, n), previous is N(.; m, n-1).
+      CppUnitVector<double> current( m * n +1, 0.0 );
+      for ( unsigned int u =0; u < counts[ n ].size(); ++u )
+        current[ u + n ] += counts[ n ][ u ];
+      for ( unsigned int v =0; v < previous.size(); ++v )
+        current[ v ] += previous[ v ];
+      counts[ n ] = current;
+      previous = current;
+    }
+  }
+  return counts[ secondSize ];
+}
+
+
+BenchmarkComparison::BenchmarkComparison( double significanceLevel,
+                                          double minimumChange )
+    : m_significanceLevel( significanceLevel )
+    , m_minimumChange( minimumChange )
+{
+}
+
+
+BenchmarkComparison::~BenchmarkComparison()
+{
+}
+
+
+void
+BenchmarkComparison::compare( const BenchmarkResultFile &baseline,
+                              const BenchmarkResultFile &contender )
+{
+  m_rows.clear();
+  CppUnitVector<double> noSamples;
+  for ( int index =0; index < baseline.resultCount(); ++index )
+  {
+    std::string name = baseline.nameAt( index );
+    const BenchmarkResult &baselineResult = baseline.resultAt( index );
+    const BenchmarkResult *contenderResult = contender.findResult( name );
+    for ( int sizeIndex =0; sizeIndex < baselineResult.sizeCount(); ++sizeIndex )
+    {
+      long size = baselineResult.sizeAt( sizeIndex );
+      const CppUnitVector<double> *contenderSamples = &noSamples;
+      for ( int contenderIndex =0;
+            contenderResult != NULL  &&
+                contenderIndex < contenderResult->sizeCount();
+            ++contenderIndex )
+      {
+        if ( contenderResult->sizeAt( contenderIndex ) == size )
+          contenderSamples = &contenderResult->samplesAt( contenderIndex );
+      }
+      addRow( name, size, baselineResult.samplesAt( sizeIndex ),
+              *contenderSamples );
+    }
+  }
+
+  // Benchmarks and sizes that are only in the contender.
+  for ( int contenderIndex =0;
+        contenderIndex < contender.resultCount();
+        ++contenderIndex )
+  {
+    std::string name = contender.nameAt( contenderIndex );
+    const BenchmarkResult &contenderResult = contender.resultAt( contenderIndex );
+    const BenchmarkResult *baselineResult = baseline.findResult( name );
+    for ( int sizeIndex =0; sizeIndex < contenderResult.sizeCount(); ++sizeIndex )
+    {
+      long size = contenderResult.sizeAt( sizeIndex );
+      bool inBaseline = false;
+      for ( int baselineIndex =0;
+            baselineResult != NULL  &&
+                baselineIndex < baselineResult->sizeCount();
+            ++baselineIndex )
+      {
+        if ( baselineResult->sizeAt( baselineIndex ) == size )
+          inBaseline = true;
+      }
+      if ( !inBaseline )
+        addRow( name, size, noSamples, contenderResult.samplesAt( sizeIndex ) );
+    }
+  }
+}
+
+
+void
+BenchmarkComparison::addRow( const std::string &name,
+                             long size,
+                             const CppUnitVector<double> &baselineSamples,
+                             const CppUnitVector<double> &contenderSamples )
+{
+  Row row;
+  row.m_name = name;
+  row.m_size = size;
+  row.m_baselineMedian = comparisonMedian( baselineSamples );
+  row.m_contenderMedian = comparisonMedian( contenderSamples );
+  row.m_pValue = mannWhitneyPValue( baselineSamples, contenderSamples );
+  row.m_change = changeUnchanged;
+
+  double relativeChange = 0;
+  if ( row.m_baselineMedian > 0 )
+    relativeChange = row.m_contenderMedian / row.m_baselineMedian - 1;
+
+  if ( baselineSamples.size() < 2  ||  contenderSamples.size() < 2  ||
+       row.m_baselineMedian <= 0 )
+    row.m_change = changeNotCompared;
+  else if ( row.m_pValue <= m_significanceLevel  &&
+            fabs( relativeChange ) >= m_minimumChange )
+    row.m_change = relativeChange > 0 ? changeRegressed : changeImproved;
+
+  m_rows.push_back( row );
+}
+
+
+int
+BenchmarkComparison::rowCount() const
+{
+  return m_rows.size();
+}
+
+
+std::string
+BenchmarkComparison::nameAt( int index ) const
+{
+  return m_rows[ index ].m_name;
+}
+
+
+long
+BenchmarkComparison::sizeAt( int index ) const
+{
+  return m_rows[ index ].m_size;
+}
+
+
+double
+BenchmarkComparison::baselineMedianAt( int index ) const
+{
+  return m_rows[ index ].m_baselineMedian;
+}
+
+
+double
+BenchmarkComparison::contenderMedianAt( int index ) const
+{
+  return m_rows[ index ].m_contenderMedian;
+}
+
+
+double
+BenchmarkComparison::relativeChangeAt( int index ) const
+{
+  const Row &row = m_rows[ index ];
+  if ( row.m_baselineMedian <= 0 )
+    return 0;
+  return row.m_contenderMedian / row.m_baselineMedian - 1;
+}
+
+
+double
+BenchmarkComparison::pValueAt( int index ) const
+{
+  return m_rows[ index ].m_pValue;
+}
+
+
+BenchmarkChange
+BenchmarkComparison::changeAt( int index ) const
+{
+  return m_rows[ index ].m_change;
+}
+
+
+int
+BenchmarkComparison::count( BenchmarkChange change ) const
+{
+  int changeCount = 0;
+  for ( CppUnitVector<Row>::const_iterator it = m_rows.begin();
+        it != m_rows.end();
+        ++it )
+  {
+    if ( (*it).m_change == change )
+      ++changeCount;
+  }
+  return changeCount;
+}
+
+
+bool
+BenchmarkComparison::hasRegression() const
+{
+  return count( changeRegressed ) > 0;
+}
+
+
+void
+BenchmarkComparison::write( OStream &stream ) const
+{
+  for ( int index =0; index < rowCount(); ++index )
+  {
+    const Row &row = m_rows[ index ];
+    char line[ 160 ];
+    if ( row.m_change == changeNotCompared )
+      sprintf( line, " %.4g s -> %.4g s",
+               row.m_baselineMedian, row.m_contenderMedian );
+    else
+      sprintf( line, " %.4g s -> %.4g s (%+.1f%%, p=%.3g)",
+               row.m_baselineMedian, row.m_contenderMedian,
+               relativeChangeAt( index ) * 100, row.m_pValue );
+    stream << row.m_name << " n=" << row.m_size << ":" << line << " "
+           << changeName( row.m_change ) << "\n";
+  }
+
+  stream << count( changeImproved ) << " improved, "
+         << count( changeRegressed ) << " regressed, "
+         << count( changeUnchanged ) << " unchanged, "
+         << count( changeNotCompared ) << " not compared\n";
+}
+
+
+std::string
+BenchmarkComparison::changeName( BenchmarkChange change )
+{
+  switch ( change )
+  {
+  case changeUnchanged:
+    return "unchanged";
+  case changeImproved:
+    return "improved";
+  case changeRegressed:
+    return "regressed";
+  default:
+    return "not compared";
+  }
+}
+
+
+double
+BenchmarkComparison::mannWhitneyPValue( const CppUnitVector<double> &first,
+                                        const CppUnitVector<double> &second )
+{
+  int firstSize = first.size();
+  int secondSize = second.size();
+  if ( firstSize == 0  ||  secondSize == 0 )
+    return 1;
+
+  // U counts the pairs with the first value greater, ties count for half.
+  double u = 0;
+  bool hasTies = false;
+  CppUnitVector<double> values( first );
+  values.insert( values.end(), second.begin(), second.end() );
+  for ( int firstIndex =0; firstIndex < firstSize; ++firstIndex )
+  {
+    for ( int secondIndex =0; secondIndex < secondSize; ++secondIndex )
+    {
+      if ( first[ firstIndex ] > second[ secondIndex ] )
+        u += 1;
+      else if ( first[ firstIndex ] == second[ secondIndex ] )
+        u += 0.5;
+    }
+  }
+
+  // Tie correction of the variance: sum of t^3 - t over the groups of ties.
+  std::sort( values.begin(), values.end() );
+  double tieCorrection = 0;
+  for ( unsigned int start =0; start < values.size(); )
+  {
+    unsigned int end = start +1;
+    while ( end < values.size()  &&  values[ end ] == values[ start ] )
+      ++end;
+    double tieCount = end - start;
+    if ( tieCount > 1 )
+      hasTies = true;
+    tieCorrection += tieCount * tieCount * tieCount - tieCount;
+    start = end;
+  }
+
+  if ( !hasTies  &&
+       firstSize <= comparisonExactMaximumSize  &&
+       secondSize <= comparisonExactMaximumSize )
+  {
+    CppUnitVector<double> counts = comparisonExactCounts( firstSize, secondSize );
+    double total = 0;
+    double lower = 0;
+    double upper = 0;
+    for ( unsigned int value =0; value < counts.size(); ++value )
+    {
+      total += counts[ value ];
+      if ( value <= u )
+        lower += counts[ value ];
+      if ( value >= u )
+        upper += counts[ value ];
+    }
+    return std::min( 1.0, 2 * std::min( lower, upper ) / total );
+  }
+
+  double count = firstSize + secondSize;
+  double mean = firstSize * secondSize / 2.0;
+  double variance = firstSize * secondSize / 12.0 *
+      ( (count +1) - tieCorrection / (count * (count -1)) );
+  if ( variance <= 0 )
+    return 1;
+
+  double z = (fabs( u - mean ) - 0.5) / sqrt( variance );
+  if ( z <= 0 )
+    return 1;
+  return std::min( 1.0, 2 * comparisonNormalTail( z ) );
+}
+
+
+CPPUNIT_NS_END
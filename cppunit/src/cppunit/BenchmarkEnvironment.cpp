@@ -0,0 +1,438 @@
+#include <cppunit/extensions/BenchmarkEnvironment.h>
+#include <cppunit/tools/StringTools.h>
+#include <cppunit/tools/ThreadGroup.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(CPPUNIT_HAVE_SCHED_SETAFFINITY)  &&  defined(CPPUNIT_HAVE_SCHED_H)
+#define CPPUNIT_BENCHMARKENVIRONMENT_USE_AFFINITY 1
+#include <sched.h>
+#endif
+#if defined(CPPUNIT_HAVE_SETPRIORITY)  &&  defined(CPPUNIT_HAVE_SYS_RESOURCE_H)
+#define CPPUNIT_BENCHMARKENVIRONMENT_USE_PRIORITY 1
+#include <errno.h>
+#include <sys/resource.h>
+#endif
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Maximum length of a line read from /proc or /sys.
+static const int environmentLineLength = 512;
+
+/// Amount by which the priority of the benchmark threads is raised.
+static const int environmentPriorityIncrease = 10;
+
+
+/// Returns the value of the first "model name" line of /proc/cpuinfo.
+static std::string
+findProcessorModel()
+{
+  FILE *file = fopen( "/proc/cpuinfo", "r" );
+  if ( file == NULL )
+    return "";
+
+  std::string model;
+  char line[ environmentLineLength ];
+  while ( model.empty()  &&  fgets( line, sizeof(line), file ) != NULL )
+  {
+    std::string text( line );
+    if ( text.compare( 0, 10, "model name" ) != 0 )
+      continue;
+    std::string::size_type colon = text.find( ':' );
+    if ( colon != std::string::npos )
+      model = StringTools::trim( text.substr( colon +1 ) );
+  }
+
+  fclose( file );
+  return model;
+}
+
+
+BenchmarkEnvironment::BenchmarkEnvironment()
+{
+}
+
+
+BenchmarkEnvironment::~BenchmarkEnvironment()
+{
+}
+
+
+BenchmarkEnvironment
+BenchmarkEnvironment::detect()
+{
+  BenchmarkEnvironment environment;
+  environment.setFact( "processors",
+                       StringTools::toString( ThreadGroup::processorCount() ) );
+
+  std::string model = findProcessorModel();
+  if ( !model.empty() )
+    environment.setFact( "processorModel", model );
+
+  std::string governor = readFirstLine(
+      "/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor" );
+  if ( !governor.empty() )
+    environment.setFact( "governor", governor );
+
+  // intel_pstate reports if turbo is disabled, other drivers if boost is
+  // enabled.
+  std::string noTurbo = readFirstLine(
+      "/sys/devices/system/cpu/intel_pstate/no_turbo" );
+  std::string boost = readFirstLine( "/sys/devices/system/cpu/cpufreq/boost" );
+  if ( noTurbo == "0"  ||  boost == "1" )
+    environment.setFact( "turbo", "on" );
+  else if ( noTurbo == "1"  ||  boost == "0" )
+    environment.setFact( "turbo", "off" );
+
+#if defined(CPPUNIT_HAVE_GETLOADAVG)
+  double loads[1];
+  if ( getloadavg( loads, 1 ) == 1 )
+    environment.setFact( "loadAverage", StringTools::toString( loads[0] ) );
+#endif
+
+  environment.checkFacts();
+  return environment;
+}
+
+
+void
+BenchmarkEnvironment::setFact( const std::string &name,
+                               const std::string &value )
+{
+  for ( unsigned int index =0; index < m_factNames.size(); ++index )
+  {
+    if ( m_factNames[ index ] == name )
+    {
+      m_factValues[ index ] = value;
+      return;
+    }
+  }
+
+  m_factNames.push_back( name );
+  m_factValues.push_back( value );
+}
+
+
+std::string
+BenchmarkEnvironment::fact( const std::string &name ) const
+{
+  for ( unsigned int index =0; index < m_factNames.size(); ++index )
+  {
+    if ( m_factNames[ index ] == name )
+      return m_factValues[ index ];
+  }
+  return "";
+}
+
+
+int
+BenchmarkEnvironment::factCount() const
+{
+  return m_factNames.size();
+}
+
+
+std::string
+BenchmarkEnvironment::factNameAt( int index ) const
+{
+  return m_factNames[ index ];
+}
+
+
+std::string
+BenchmarkEnvironment::factValueAt( int index ) const
+{
+  return m_factValues[ index ];
+}
+
+
+void
+BenchmarkEnvironment::addWarning( const std::string &warning )
+{
+  m_warnings.push_back( warning );
+}
+
+
+int
+BenchmarkEnvironment::warningCount() const
+{
+  return m_warnings.size();
+}
+
+
+std::string
+BenchmarkEnvironment::warningAt( int index ) const
+{
+  return m_warnings[ index ];
+}
+
+
+void
+BenchmarkEnvironment::checkFacts()
+{
+  std::string governor = fact( "governor" );
+  if ( !governor.empty()  &&  governor != "performance" )
+    addWarning( "CPU frequency governor is <" + governor + ">: the frequency "
+                "changes with the load, use <performance>." );
+
+  if ( fact( "turbo" ) == "on" )
+    addWarning( "Turbo boost is on: the frequency depends on the temperature "
+                "and on the load of the other processors." );
+
+  std::string loadAverage = fact( "loadAverage" );
+  if ( !loadAverage.empty()  &&  atof( loadAverage.c_str() ) > 1 )
+    addWarning( "Load average is " + loadAverage + ": other processes compete "
+                "with the benchmark for the processors." );
+}
+
+
+std::string
+BenchmarkEnvironment::readFirstLine( const std::string &fileName )
+{
+  FILE *file = fopen( fileName.c_str(), "r" );
+  if ( file == NULL )
+    return "";
+
+  char line[ environmentLineLength ];
+  std::string text;
+  if ( fgets( line, sizeof(line), file ) != NULL )
+    text = line;
+  fclose( file );
+
+  while ( !text.empty()  &&
+          ( text[ text.length() -1 ] == '\n'  ||  text[ text.length() -1 ] == '\r' ) )
+    text.erase( text.length() -1 );
+  return text;
+}
+
+
+
+BenchmarkControls::BenchmarkControls()
+    : m_raisePriority( false )
+{
+}
+
+
+BenchmarkControls::~BenchmarkControls()
+{
+}
+
+
+BenchmarkControls &
+BenchmarkControls::getControls()
+{
+  static BenchmarkControls controls;
+  return controls;
+}
+
+
+void
+BenchmarkControls::setCpus( const CppUnitVector<int> &cpus )
+{
+  m_cpus = cpus;
+}
+
+
+const CppUnitVector<int> &
+BenchmarkControls::cpus() const
+{
+  return m_cpus;
+}
+
+
+bool
+BenchmarkControls::pinsThreads() const
+{
+  return !m_cpus.empty();
+}
+
+
+void
+BenchmarkControls::setRaisePriority( bool raisePriority )
+{
+  m_raisePriority = raisePriority;
+}
+
+
+bool
+BenchmarkControls::raisesPriority() const
+{
+  return m_raisePriority;
+}
+
+
+/// Parses a processor index, returns -1 if \a text is not a number.
+static int
+parseCpuIndex( const std::string &text )
+{
+  if ( text.empty()  ||  text.length() > 6 )
+    return -1;
+
+  int index = 0;
+  for ( unsigned int position =0; position < text.length(); ++position )
+  {
+    char c = text[ position ];
+    if ( c < '0'  ||  c > '9' )
+      return -1;
+    index = index * 10 + (c - '0');
+  }
+  return index;
+}
+
+
+bool
+BenchmarkControls::parseCpuList( const std::string &text,
+                                 CppUnitVector<int> &cpus )
+{
+  CppUnitVector<int> parsed;
+  StringTools::Strings ranges = StringTools::split( text, ',' );
+  for ( StringTools::Strings::const_iterator it = ranges.begin();
+        it != ranges.end();
+        ++it )
+  {
+    std::string range = StringTools::trim( *it );
+    std::string::size_type dash = range.find( '-' );
+    int first = parseCpuIndex( range.substr( 0, dash ) );
+    int last = dash == std::string::npos ? first
+                                         : parseCpuIndex( range.substr( dash +1 ) );
+    if ( first < 0  ||  last < first )
+      return false;
+
+    for ( int cpu = first; cpu <= last; ++cpu )
+      parsed.push_back( cpu );
+  }
+
+  if ( parsed.empty() )
+    return false;
+  cpus = parsed;
+  return true;
+}
+
+
+std::string
+BenchmarkControls::cpuListToString( const CppUnitVector<int> &cpus )
+{
+  std::string list;
+  for ( unsigned int index =0; index < cpus.size(); ++index )
+  {
+    if ( index > 0 )
+      list += ",";
+    list += StringTools::toString( cpus[ index ] );
+  }
+  return list;
+}
+
+
+
+BenchmarkThreadControl::BenchmarkThreadControl( const BenchmarkControls &controls,
+                                                int threadIndex )
+    : m_controls( controls )
+    , m_cpu( -1 )
+    , m_requestedCpu( -1 )
+    , m_previousAffinity( NULL )
+    , m_priorityRaised( false )
+    , m_previousPriority( 0 )
+{
+  if ( controls.pinsThreads() )
+  {
+    const CppUnitVector<int> &cpus = controls.cpus();
+    m_requestedCpu = cpus[ threadIndex % cpus.size() ];
+#if defined(CPPUNIT_BENCHMARKENVIRONMENT_USE_AFFINITY)
+    cpu_set_t *previousAffinity = new cpu_set_t;
+    if ( m_requestedCpu < CPU_SETSIZE  &&
+         sched_getaffinity( 0, sizeof(cpu_set_t), previousAffinity ) == 0 )
+    {
+      cpu_set_t affinity;
+      CPU_ZERO( &affinity );
+      CPU_SET( m_requestedCpu, &affinity );
+      if ( sched_setaffinity( 0, sizeof(cpu_set_t), &affinity ) == 0 )
+        m_cpu = m_requestedCpu;
+    }
+
+    if ( m_cpu >= 0 )
+      m_previousAffinity = previousAffinity;
+    else
+      delete previousAffinity;
+#endif
+  }
+
+  if ( controls.raisesPriority() )
+  {
+#if defined(CPPUNIT_BENCHMARKENVIRONMENT_USE_PRIORITY)
+    errno = 0;
+    int priority = getpriority( PRIO_PROCESS, 0 );
+    if ( errno == 0 )
+    {
+      int raisedPriority = priority - environmentPriorityIncrease;
+      if ( raisedPriority < -20 )
+        raisedPriority = -20;
+      if ( raisedPriority < priority  &&
+           setpriority( PRIO_PROCESS, 0, raisedPriority ) == 0 )
+      {
+        m_priorityRaised = true;
+        m_previousPriority = priority;
+      }
+    }
+#endif
+  }
+}
+
+
+BenchmarkThreadControl::~BenchmarkThreadControl()
+{
+#if defined(CPPUNIT_BENCHMARKENVIRONMENT_USE_PRIORITY)
+  if ( m_priorityRaised )
+    setpriority( PRIO_PROCESS, 0, m_previousPriority );
+#endif
+
+#if defined(CPPUNIT_BENCHMARKENVIRONMENT_USE_AFFINITY)
+  if ( m_previousAffinity != NULL )
+  {
+    cpu_set_t *previousAffinity =
+        CPPUNIT_STATIC_CAST( cpu_set_t *, m_previousAffinity );
+    sched_setaffinity( 0, sizeof(cpu_set_t), previousAffinity );
+    delete previousAffinity;
+  }
+#endif
+}
+
+
+int
+BenchmarkThreadControl::cpu() const
+{
+  return m_cpu;
+}
+
+
+bool
+BenchmarkThreadControl::isPriorityRaised() const
+{
+  return m_priorityRaised;
+}
+
+
+void
+BenchmarkThreadControl::addFacts( BenchmarkEnvironment &environment ) const
+{
+  if ( m_controls.pinsThreads() )
+  {
+    environment.setFact( "cpus",
+                         BenchmarkControls::cpuListToString( m_controls.cpus() ) );
+    if ( m_cpu < 0 )
+      environment.addWarning( "Could not pin the benchmark thread to CPU " +
+                              StringTools::toString( m_requestedCpu ) + "." );
+  }
+
+  if ( m_controls.raisesPriority() )
+  {
+    environment.setFact( "priority", m_priorityRaised ? "raised" : "normal" );
+    if ( !m_priorityRaised )
+      environment.addWarning( "Could not raise the scheduling priority of the "
+                              "benchmark (it usually needs privileges)." );
+  }
+}
+
+
+CPPUNIT_NS_END
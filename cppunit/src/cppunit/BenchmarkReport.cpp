@@ -0,0 +1,189 @@
+#include <cppunit/extensions/BenchmarkReport.h>
+#include <cppunit/portability/Stream.h>
+#include <cppunit/tools/StringTools.h>
+#include <cppunit/tools/XmlElement.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+BenchmarkReport::BenchmarkReport()
+{
+}
+
+
+BenchmarkReport::~BenchmarkReport()
+{
+}
+
+
+BenchmarkReport &
+BenchmarkReport::getReport()
+{
+  static BenchmarkReport report;
+  return report;
+}
+
+
+void 
+BenchmarkReport::setResult( Test *test, 
+                            const BenchmarkResult &result )
+{
+  removeResult( test );
+  m_results.insert( Results::value_type( test, result ) );
+}
+
+
+void 
+BenchmarkReport::removeResult( Test *test )
+{
+  m_results.erase( test );
+}
+
+
+const BenchmarkResult *
+BenchmarkReport::findResult( Test *test ) const
+{
+  Results::const_iterator it = m_results.find( test );
+  if ( it == m_results.end() )
+    return NULL;
+  return &(*it).second;
+}
+
+
+CppUnitVector<Test *> 
+BenchmarkReport::tests() const
+{
+  CppUnitVector<Test *> tests;
+  for ( Results::const_iterator it = m_results.begin(); 
+        it != m_results.end(); 
+        ++it )
+    tests.push_back( (*it).first );
+  return tests;
+}
+
+
+
+BenchmarkXmlOutputterHook::BenchmarkXmlOutputterHook( const BenchmarkReport &report )
+    : m_report( report )
+{
+}
+
+
+BenchmarkXmlOutputterHook::~BenchmarkXmlOutputterHook()
+{
+}
+
+
+void 
+BenchmarkXmlOutputterHook::failTestAdded( XmlDocument *,
+                                          XmlElement *testElement,
+                                          Test *test,
+                                          TestFailure * )
+{
+  addResult( testElement, test );
+}
+
+
+void 
+BenchmarkXmlOutputterHook::successfulTestAdded( XmlDocument *,
+                                                XmlElement *testElement,
+                                                Test *test )
+{
+  addResult( testElement, test );
+}
+
+
+void 
+BenchmarkXmlOutputterHook::addResult( XmlElement *testElement, 
+                                      Test *test )
+{
+  const BenchmarkResult *result = m_report.findResult( test );
+  if ( result == NULL )
+    return;
+
+  XmlElement *benchmarkElement = new XmlElement( "Benchmark" );
+  testElement->addElement( benchmarkElement );
+  if ( result->hasComplexity() )
+  {
+    benchmarkElement->addAttribute( "complexity", 
+        BenchmarkResult::complexityName( result->complexity() ) );
+    benchmarkElement->addAttribute( "coefficient", 
+                                    StringTools::toString( result->coefficient() ) );
+    benchmarkElement->addAttribute( "rms", 
+                                    StringTools::toString( result->rms() ) );
+  }
+
+  for ( int index =0; index < result->sizeCount(); ++index )
+  {
+    // Sizes and iteration counts may not fit in an int.
+    OStringStream size;
+    size << result->sizeAt( index );
+    OStringStream iterations;
+    iterations << result->iterationCountAt( index );
+
+    XmlElement *sizeElement = new XmlElement( "Size" );
+    sizeElement->addAttribute( "value", size.str() );
+    sizeElement->addAttribute( "iterations", iterations.str() );
+    sizeElement->addAttribute( "min", 
+                               StringTools::toString( result->minimumAt( index ) ) );
+    sizeElement->addAttribute( "median", 
+                               StringTools::toString( result->medianAt( index ) ) );
+    sizeElement->addAttribute( "max", 
+                               StringTools::toString( result->maximumAt( index ) ) );
+    if ( result->bytesPerSecondAt( index ) > 0 )
+      sizeElement->addAttribute( "bytesPerSecond", 
+          StringTools::toString( result->bytesPerSecondAt( index ) ) );
+    if ( result->itemsPerSecondAt( index ) > 0 )
+      sizeElement->addAttribute( "itemsPerSecond", 
+          StringTools::toString( result->itemsPerSecondAt( index ) ) );
+    benchmarkElement->addElement( sizeElement );
+  }
+
+  for ( int pointIndex =0; pointIndex < result->threadPointCount(); ++pointIndex )
+  {
+    OStringStream iterations;
+    iterations << result->threadIterationCountAt( pointIndex );
+
+    XmlElement *threadsElement = new XmlElement( "Threads" );
+    threadsElement->addAttribute( "count", result->threadCountAt( pointIndex ) );
+    threadsElement->addAttribute( "iterations", iterations.str() );
+    threadsElement->addAttribute( "throughput", 
+        StringTools::toString( result->throughputAt( pointIndex ) ) );
+    threadsElement->addAttribute( "deviation", 
+        StringTools::toString( result->threadDeviationAt( pointIndex ) ) );
+    threadsElement->addAttribute( "efficiency", 
+        StringTools::toString( result->efficiencyAt( pointIndex ) ) );
+    if ( result->threadBytesPerSecondAt( pointIndex ) > 0 )
+      threadsElement->addAttribute( "bytesPerSecond", 
+          StringTools::toString( result->threadBytesPerSecondAt( pointIndex ) ) );
+    if ( result->threadItemsPerSecondAt( pointIndex ) > 0 )
+      threadsElement->addAttribute( "itemsPerSecond", 
+          StringTools::toString( result->threadItemsPerSecondAt( pointIndex ) ) );
+    benchmarkElement->addElement( threadsElement );
+  }
+
+  const BenchmarkEnvironment &environment = result->environment();
+  if ( environment.factCount() == 0  &&  environment.warningCount() == 0 )
+    return;
+
+  XmlElement *environmentElement = new XmlElement( "Environment" );
+  benchmarkElement->addElement( environmentElement );
+  for ( int factIndex =0; factIndex < environment.factCount(); ++factIndex )
+  {
+    XmlElement *factElement = new XmlElement( "Fact", 
+                                              environment.factValueAt( factIndex ) );
+    factElement->addAttribute( "name", environment.factNameAt( factIndex ) );
+    environmentElement->addElement( factElement );
+  }
+  for ( int warningIndex =0; 
+        warningIndex < environment.warningCount(); 
+        ++warningIndex )
+  {
+    environmentElement->addElement( 
+        new XmlElement( "Warning", environment.warningAt( warningIndex ) ) );
+  }
+}
+
+
+CPPUNIT_NS_END
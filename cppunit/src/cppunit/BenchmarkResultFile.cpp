@@ -0,0 +1,654 @@
+#include <cppunit/Test.h>
+#include <cppunit/extensions/BenchmarkReport.h>
+#include <cppunit/extensions/BenchmarkResultFile.h>
+#include <cppunit/portability/CppUnitMap.h>
+#include <cppunit/tools/MappedFile.h>
+#include <cppunit/tools/StringTools.h>
+#include <stdexcept>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Value of the "format" member of a result file.
+static const char *const benchmarkFileFormat = "cppunit-benchmark";
+
+/// Version of the layout of a result file.
+static const int benchmarkFileVersion = 1;
+
+/// Maximum number of parent directories searched for a .git directory.
+static const int benchmarkRevisionSearchDepth = 16;
+
+
+/// Returns a sample with enough digits to compare it with another run.
+static std::string
+benchmarkJsonNumber( double value )
+{
+  char number[ 64 ];
+  sprintf( number, "%.9g", value );
+  return number;
+}
+
+
+/// Writes a JSON string, with its quotes.
+static void
+writeBenchmarkJsonString( OStream &stream,
+                          const std::string &text )
+{
+  stream << '"';
+  for ( unsigned int index =0; index < text.length(); ++index )
+  {
+    unsigned char c = text[ index ];
+    if ( c == '"'  ||  c == '\\' )
+      stream << '\\' << char(c);
+    else if ( c == '\n' )
+      stream << "\\n";
+    else if ( c == '\t' )
+      stream << "\\t";
+    else if ( c < 0x20 )
+    {
+      static const char *digits = "0123456789abcdef";
+      stream << "\\u00" << digits[ c >> 4 ] << digits[ c & 15 ];
+    }
+    else
+      stream << char(c);
+  }
+  stream << '"';
+}
+
+
+/*! \brief Reads the JSON written by BenchmarkResultFile::write().
+ *
+ * A pull parser: the caller reads the members it expects and skips the
+ * others. Throws std::runtime_error on a syntax error.
+ */
+class BenchmarkJsonReader
+{
+public:
+  BenchmarkJsonReader( const std::string &text )
+      : m_text( text )
+      , m_position( 0 )
+  {
+  }
+
+  /*! \brief Tests if the object or array has another element and skips the
+   *         comma before it.
+   * \param end Character ending the object or array, consumed at the end.
+   */
+  bool hasNext( char end, bool &first )
+  {
+    skipSpaces();
+    if ( peek() == end )
+    {
+      ++m_position;
+      return false;
+    }
+    if ( !first )
+      expect( ',' );
+    first = false;
+    return true;
+  }
+
+  /// Reads the name of a member and its colon.
+  std::string readName()
+  {
+    std::string name = readString();
+    expect( ':' );
+    return name;
+  }
+
+  std::string readString()
+  {
+    expect( '"' );
+    std::string text;
+    while ( true )
+    {
+      char c = next();
+      if ( c == '"' )
+        return text;
+      if ( c != '\\' )
+      {
+        text += c;
+        continue;
+      }
+
+      c = next();
+      switch ( c )
+      {
+      case 'n':
+        text += '\n';
+        break;
+      case 't':
+        text += '\t';
+        break;
+      case 'r':
+        text += '\r';
+        break;
+      case 'b':
+        text += '\b';
+        break;
+      case 'f':
+        text += '\f';
+        break;
+      case 'u':
+        appendCodePoint( text, readHexadecimal() );
+        break;
+      default:
+        text += c;
+      }
+    }
+  }
+
+  double readNumber()
+  {
+    skipSpaces();
+    const char *start = m_text.c_str() + m_position;
+    char *end = NULL;
+    double number = strtod( start, &end );
+    if ( end == start )
+      fail( "number expected" );
+    m_position += end - start;
+    return number;
+  }
+
+  /// Skips a value of any type.
+  void skipValue()
+  {
+    skipSpaces();
+    char c = peek();
+    if ( c == '"' )
+      readString();
+    else if ( c == '{'  ||  c == '[' )
+    {
+      char end = c == '{' ? '}' : ']';
+      ++m_position;
+      bool first = true;
+      while ( hasNext( end, first ) )
+      {
+        if ( end == '}' )
+          readName();
+        skipValue();
+      }
+    }
+    else if ( c == 't'  ||  c == 'f'  ||  c == 'n' )
+    {
+      while ( m_position < m_text.length()  &&
+              m_text[ m_position ] >= 'a'  &&  m_text[ m_position ] <= 'z' )
+        ++m_position;
+    }
+    else
+      readNumber();
+  }
+
+  /// Checks that only spaces follow the value.
+  void readEnd()
+  {
+    skipSpaces();
+    if ( m_position != m_text.length() )
+      fail( "end of file expected" );
+  }
+
+  void expect( char expected )
+  {
+    skipSpaces();
+    if ( next() != expected )
+      fail( std::string( "'" ) + expected + "' expected" );
+  }
+
+  void fail( const std::string &message )
+  {
+    throw std::runtime_error( "Invalid benchmark result file at offset " +
+                              StringTools::toString( int(m_position) ) + ": " +
+                              message + "." );
+  }
+
+private:
+  void skipSpaces()
+  {
+    while ( m_position < m_text.length()  &&
+            ( m_text[ m_position ] == ' '  ||  m_text[ m_position ] == '\n'  ||
+              m_text[ m_position ] == '\r'  ||  m_text[ m_position ] == '\t' ) )
+      ++m_position;
+  }
+
+  char peek()
+  {
+    if ( m_position >= m_text.length() )
+      fail( "unexpected end of file" );
+    return m_text[ m_position ];
+  }
+
+  char next()
+  {
+    char c = peek();
+    ++m_position;
+    return c;
+  }
+
+  unsigned int readHexadecimal()
+  {
+    unsigned int value = 0;
+    for ( int count =0; count < 4; ++count )
+    {
+      char c = next();
+      value *= 16;
+      if ( c >= '0'  &&  c <= '9' )
+        value += c - '0';
+      else if ( c >= 'a'  &&  c <= 'f' )
+        value += c - 'a' + 10;
+      else if ( c >= 'A'  &&  c <= 'F' )
+        value += c - 'A' + 10;
+      else
+        fail( "hexadecimal digit expected" );
+    }
+    return value;
+  }
+
+  /// Appends a code point of the basic multilingual plane as UTF-8.
+  static void appendCodePoint( std::string &text,
+                               unsigned int codePoint )
+  {
+    if ( codePoint < 0x80 )
+      text += char(codePoint);
+    else if ( codePoint < 0x800 )
+    {
+      text += char(0xc0 | (codePoint >> 6));
+      text += char(0x80 | (codePoint & 0x3f));
+    }
+    else
+    {
+      text += char(0xe0 | (codePoint >> 12));
+      text += char(0x80 | ((codePoint >> 6) & 0x3f));
+      text += char(0x80 | (codePoint & 0x3f));
+    }
+  }
+
+private:
+  const std::string &m_text;
+  std::string::size_type m_position;
+};
+
+
+/// Reads the "environment" member of a benchmark.
+static BenchmarkEnvironment
+readBenchmarkEnvironment( BenchmarkJsonReader &reader )
+{
+  BenchmarkEnvironment environment;
+  reader.expect( '{' );
+  bool first = true;
+  while ( reader.hasNext( '}', first ) )
+  {
+    std::string member = reader.readName();
+    bool firstElement = true;
+    if ( member == "facts" )
+    {
+      reader.expect( '{' );
+      while ( reader.hasNext( '}', firstElement ) )
+      {
+        std::string name = reader.readName();
+        environment.setFact( name, reader.readString() );
+      }
+    }
+    else if ( member == "warnings" )
+    {
+      reader.expect( '[' );
+      while ( reader.hasNext( ']', firstElement ) )
+        environment.addWarning( reader.readString() );
+    }
+    else
+      reader.skipValue();
+  }
+  return environment;
+}
+
+
+/// Reads one element of the "sizes" member of a benchmark.
+static void
+readBenchmarkSize( BenchmarkJsonReader &reader,
+                   BenchmarkResult &result )
+{
+  double size = 0;
+  double iterationCount = 0;
+  double bytesPerIteration = 0;
+  double itemsPerIteration = 0;
+  CppUnitVector<double> samples;
+
+  reader.expect( '{' );
+  bool first = true;
+  while ( reader.hasNext( '}', first ) )
+  {
+    std::string member = reader.readName();
+    if ( member == "size" )
+      size = reader.readNumber();
+    else if ( member == "iterations" )
+      iterationCount = reader.readNumber();
+    else if ( member == "bytesPerIteration" )
+      bytesPerIteration = reader.readNumber();
+    else if ( member == "itemsPerIteration" )
+      itemsPerIteration = reader.readNumber();
+    else if ( member == "samples" )
+    {
+      reader.expect( '[' );
+      bool firstSample = true;
+      while ( reader.hasNext( ']', firstSample ) )
+        samples.push_back( reader.readNumber() );
+    }
+    else
+      reader.skipValue();
+  }
+
+  // Samples are stored per iteration, addSample() expects the total time.
+  long iterations = long(iterationCount);
+  for ( CppUnitVector<double>::const_iterator it = samples.begin();
+        it != samples.end();
+        ++it )
+    result.addSample( long(size),
+                      iterations,
+                      iterations > 0 ? *it * iterations : *it,
+                      long(bytesPerIteration),
+                      long(itemsPerIteration) );
+}
+
+
+BenchmarkResultFile::BenchmarkResultFile()
+{
+}
+
+
+BenchmarkResultFile::~BenchmarkResultFile()
+{
+}
+
+
+void
+BenchmarkResultFile::addResult( const std::string &name,
+                                const BenchmarkResult &result )
+{
+  for ( unsigned int index =0; index < m_names.size(); ++index )
+  {
+    if ( m_names[ index ] == name )
+    {
+      m_results[ index ] = result;
+      return;
+    }
+  }
+
+  m_names.push_back( name );
+  m_results.push_back( result );
+}
+
+
+void
+BenchmarkResultFile::addReport( const BenchmarkReport &report )
+{
+  // Sorted by name, so that the files of two runs can be diffed.
+  typedef CppUnitMap<std::string, Test *, std::less<std::string> > TestsByName;
+  TestsByName testsByName;
+  CppUnitVector<Test *> tests = report.tests();
+  for ( CppUnitVector<Test *>::const_iterator it = tests.begin();
+        it != tests.end();
+        ++it )
+    testsByName.insert( TestsByName::value_type( (*it)->getName(), *it ) );
+
+  for ( TestsByName::const_iterator itTest = testsByName.begin();
+        itTest != testsByName.end();
+        ++itTest )
+    addResult( (*itTest).first, *report.findResult( (*itTest).second ) );
+}
+
+
+int
+BenchmarkResultFile::resultCount() const
+{
+  return m_names.size();
+}
+
+
+std::string
+BenchmarkResultFile::nameAt( int index ) const
+{
+  return m_names[ index ];
+}
+
+
+const BenchmarkResult &
+BenchmarkResultFile::resultAt( int index ) const
+{
+  return m_results[ index ];
+}
+
+
+const BenchmarkResult *
+BenchmarkResultFile::findResult( const std::string &name ) const
+{
+  for ( unsigned int index =0; index < m_names.size(); ++index )
+  {
+    if ( m_names[ index ] == name )
+      return &m_results[ index ];
+  }
+  return NULL;
+}
+
+
+void
+BenchmarkResultFile::setRevision( const std::string &revision )
+{
+  m_revision = revision;
+}
+
+
+std::string
+BenchmarkResultFile::revision() const
+{
+  return m_revision;
+}
+
+
+std::string
+BenchmarkResultFile::detectRevision()
+{
+  const char *revision = getenv( "CPPUNIT_BENCHMARK_REVISION" );
+  if ( revision != NULL  &&  *revision != 0 )
+    return revision;
+
+  std::string gitDirectory = ".git";
+  for ( int depth =0; depth < benchmarkRevisionSearchDepth; ++depth )
+  {
+    std::string head = BenchmarkEnvironment::readFirstLine( gitDirectory + "/HEAD" );
+    if ( !head.empty() )
+    {
+      // HEAD holds the commit if detached, the branch it is on otherwise.
+      if ( head.compare( 0, 5, "ref: " ) != 0 )
+        return head;
+
+      std::string reference = head.substr( 5 );
+      std::string commit = BenchmarkEnvironment::readFirstLine(
+          gitDirectory + "/" + reference );
+      if ( !commit.empty() )
+        return commit;
+
+      // The branch may only be listed in packed-refs ("<commit> <ref>").
+      FILE *file = fopen( (gitDirectory + "/packed-refs").c_str(), "r" );
+      if ( file == NULL )
+        return "";
+      char line[ 512 ];
+      while ( commit.empty()  &&  fgets( line, sizeof(line), file ) != NULL )
+      {
+        std::string text = StringTools::trim( line );
+        std::string::size_type space = text.find( ' ' );
+        if ( space != std::string::npos  &&
+             text.substr( space +1 ) == reference )
+          commit = text.substr( 0, space );
+      }
+      fclose( file );
+      return commit;
+    }
+    gitDirectory = "../" + gitDirectory;
+  }
+  return "";
+}
+
+
+void
+BenchmarkResultFile::write( OStream &stream ) const
+{
+  stream << "{\"format\":";
+  writeBenchmarkJsonString( stream, benchmarkFileFormat );
+  stream << ",\"version\":" << benchmarkFileVersion << ",\"revision\":";
+  writeBenchmarkJsonString( stream, m_revision );
+  stream << ",\n\"benchmarks\":[";
+  for ( unsigned int resultIndex =0;
+        resultIndex < m_results.size();
+        ++resultIndex )
+  {
+    const BenchmarkResult &result = m_results[ resultIndex ];
+    const BenchmarkEnvironment &environment = result.environment();
+    if ( resultIndex > 0 )
+      stream << ",";
+    stream << "\n{\"name\":";
+    writeBenchmarkJsonString( stream, m_names[ resultIndex ] );
+
+    stream << ",\"environment\":{\"facts\":{";
+    for ( int factIndex =0; factIndex < environment.factCount(); ++factIndex )
+    {
+      if ( factIndex > 0 )
+        stream << ",";
+      writeBenchmarkJsonString( stream, environment.factNameAt( factIndex ) );
+      stream << ":";
+      writeBenchmarkJsonString( stream, environment.factValueAt( factIndex ) );
+    }
+    stream << "},\"warnings\":[";
+    for ( int warningIndex =0;
+          warningIndex < environment.warningCount();
+          ++warningIndex )
+    {
+      if ( warningIndex > 0 )
+        stream << ",";
+      writeBenchmarkJsonString( stream, environment.warningAt( warningIndex ) );
+    }
+    stream << "]},\n\"sizes\":[";
+
+    for ( int sizeIndex =0; sizeIndex < result.sizeCount(); ++sizeIndex )
+    {
+      if ( sizeIndex > 0 )
+        stream << ",";
+      stream << "{\"size\":" << result.sizeAt( sizeIndex )
+             << ",\"iterations\":" << result.iterationCountAt( sizeIndex )
+             << ",\"bytesPerIteration\":" << result.bytesPerIterationAt( sizeIndex )
+             << ",\"itemsPerIteration\":" << result.itemsPerIterationAt( sizeIndex )
+             << ",\"samples\":[";
+      const CppUnitVector<double> &samples = result.samplesAt( sizeIndex );
+      for ( unsigned int sampleIndex =0;
+            sampleIndex < samples.size();
+            ++sampleIndex )
+      {
+        if ( sampleIndex > 0 )
+          stream << ",";
+        stream << benchmarkJsonNumber( samples[ sampleIndex ] );
+      }
+      stream << "]}";
+    }
+    stream << "]}";
+  }
+  stream << "]}\n";
+}
+
+
+void
+BenchmarkResultFile::read( const std::string &text )
+{
+  CppUnitVector<std::string> names;
+  CppUnitVector<BenchmarkResult> results;
+  std::string revision;
+  std::string format;
+
+  BenchmarkJsonReader reader( text );
+  reader.expect( '{' );
+  bool first = true;
+  while ( reader.hasNext( '}', first ) )
+  {
+    std::string member = reader.readName();
+    if ( member == "format" )
+      format = reader.readString();
+    else if ( member == "version" )
+    {
+      if ( reader.readNumber() > benchmarkFileVersion )
+        reader.fail( "unsupported version" );
+    }
+    else if ( member == "revision" )
+      revision = reader.readString();
+    else if ( member == "benchmarks" )
+    {
+      reader.expect( '[' );
+      bool firstBenchmark = true;
+      while ( reader.hasNext( ']', firstBenchmark ) )
+      {
+        std::string name;
+        BenchmarkResult result;
+        reader.expect( '{' );
+        bool firstMember = true;
+        while ( reader.hasNext( '}', firstMember ) )
+        {
+          std::string benchmarkMember = reader.readName();
+          if ( benchmarkMember == "name" )
+            name = reader.readString();
+          else if ( benchmarkMember == "environment" )
+            result.setEnvironment( readBenchmarkEnvironment( reader ) );
+          else if ( benchmarkMember == "sizes" )
+          {
+            reader.expect( '[' );
+            bool firstSize = true;
+            while ( reader.hasNext( ']', firstSize ) )
+              readBenchmarkSize( reader, result );
+          }
+          else
+            reader.skipValue();
+        }
+        result.fitComplexity();
+        names.push_back( name );
+        results.push_back( result );
+      }
+    }
+    else
+      reader.skipValue();
+  }
+  reader.readEnd();
+
+  if ( format != benchmarkFileFormat )
+    throw std::runtime_error( "Not a benchmark result file (format <" +
+                              format + ">)." );
+
+  m_names = names;
+  m_results = results;
+  m_revision = revision;
+}
+
+
+void
+BenchmarkResultFile::save( const std::string &fileName ) const
+{
+  OStringStream stream;
+  write( stream );
+  std::string text = stream.str();
+
+  FILE *file = fopen( fileName.c_str(), "wb" );
+  if ( file == NULL )
+    throw std::runtime_error( "Can not create file <" + fileName + ">." );
+  bool written = fwrite( text.c_str(), 1, text.length(), file ) == text.length();
+  if ( fclose( file ) != 0  ||  !written )
+    throw std::runtime_error( "Can not write file <" + fileName + ">." );
+}
+
+
+void
+BenchmarkResultFile::load( const std::string &fileName )
+{
+  MappedFile file( fileName );
+  read( std::string( CPPUNIT_REINTERPRET_CAST( const char *, file.data() ),
+                     file.size() ) );
+}
+
+
+CPPUNIT_NS_END
@@ -0,0 +1,203 @@
+#include <cppunit/CallbackProfile.h>
+#include <cppunit/TestListener.h>
+#include <cppunit/XmlOutputterHook.h>
+#include <cppunit/extensions/TypeInfoHelper.h>
+#include <algorithm>
+#include <stdio.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Orders entry indexes by decreasing total time.
+class CallbackProfileOrder
+{
+public:
+  CallbackProfileOrder( const CallbackProfile &profile )
+      : m_profile( profile )
+  {
+  }
+
+  bool operator()( int first, int second ) const
+  {
+    return m_profile.totalSecondsAt( first ) > m_profile.totalSecondsAt( second );
+  }
+
+private:
+  const CallbackProfile &m_profile;
+};
+
+
+CallbackProfile::CallbackProfile()
+{
+}
+
+
+CallbackProfile::~CallbackProfile()
+{
+}
+
+
+void
+CallbackProfile::addListenerTime( TestListener *listener,
+                                  const std::string &event,
+                                  double seconds )
+{
+  if ( addTime( listener, event, seconds ) )
+    return;
+
+#if CPPUNIT_HAVE_RTTI
+  addEntry( listener, TypeInfoHelper::getClassName( typeid(*listener) ),
+            event, seconds );
+#else
+  addEntry( listener, "TestListener", event, seconds );
+#endif
+}
+
+
+void
+CallbackProfile::addHookTime( XmlOutputterHook *hook,
+                              const std::string &event,
+                              double seconds )
+{
+  if ( addTime( hook, event, seconds ) )
+    return;
+
+#if CPPUNIT_HAVE_RTTI
+  addEntry( hook, TypeInfoHelper::getClassName( typeid(*hook) ),
+            event, seconds );
+#else
+  addEntry( hook, "XmlOutputterHook", event, seconds );
+#endif
+}
+
+
+bool
+CallbackProfile::addTime( const void *callback,
+                          const std::string &event,
+                          double seconds )
+{
+  EntryIndexes::const_iterator it = m_indexes.find( EntryKey( callback, event ) );
+  if ( it == m_indexes.end() )
+    return false;
+
+  Entry &entry = m_entries[ (*it).second ];
+  ++entry.m_callCount;
+  entry.m_totalSeconds += seconds;
+  return true;
+}
+
+
+void
+CallbackProfile::addEntry( const void *callback,
+                           const std::string &callbackName,
+                           const std::string &event,
+                           double seconds )
+{
+  Entry entry;
+  entry.m_callbackName = callbackName;
+  entry.m_event = event;
+  entry.m_callCount = 1;
+  entry.m_totalSeconds = seconds;
+  m_indexes.insert( std::pair<const EntryKey, int>( EntryKey( callback, event ),
+                                                    m_entries.size() ) );
+  m_entries.push_back( entry );
+}
+
+
+void
+CallbackProfile::reset()
+{
+  m_entries.clear();
+  m_indexes.clear();
+}
+
+
+int
+CallbackProfile::entryCount() const
+{
+  return m_entries.size();
+}
+
+
+std::string
+CallbackProfile::callbackNameAt( int index ) const
+{
+  return m_entries[ index ].m_callbackName;
+}
+
+
+std::string
+CallbackProfile::eventAt( int index ) const
+{
+  return m_entries[ index ].m_event;
+}
+
+
+long
+CallbackProfile::callCountAt( int index ) const
+{
+  return m_entries[ index ].m_callCount;
+}
+
+
+double
+CallbackProfile::totalSecondsAt( int index ) const
+{
+  return m_entries[ index ].m_totalSeconds;
+}
+
+
+double
+CallbackProfile::secondsPerCallAt( int index ) const
+{
+  const Entry &entry = m_entries[ index ];
+  return entry.m_callCount > 0 ? entry.m_totalSeconds / entry.m_callCount : 0;
+}
+
+
+double
+CallbackProfile::totalSeconds() const
+{
+  double seconds = 0;
+  for ( CppUnitVector<Entry>::const_iterator it = m_entries.begin();
+        it != m_entries.end();
+        ++it )
+    seconds += (*it).m_totalSeconds;
+  return seconds;
+}
+
+
+void
+CallbackProfile::write( OStream &stream,
+                        int maximumEntryCount ) const
+{
+  CppUnitVector<int> order;
+  long callCount = 0;
+  for ( int index =0; index < entryCount(); ++index )
+  {
+    order.push_back( index );
+    callCount += callCountAt( index );
+  }
+  std::stable_sort( order.begin(), order.end(), CallbackProfileOrder( *this ) );
+
+  char line[ 80 ];
+  sprintf( line, "%.3f ms in %ld calls", totalSeconds() * 1e3, callCount );
+  stream << "Listener and hook profile: " << line << "\n";
+  if ( order.empty() )
+    return;
+
+  stream << "  Total (ms)     Calls  Per call (us)  Callback\n";
+  for ( int rank =0; rank < int(order.size())  &&  rank < maximumEntryCount; ++rank )
+  {
+    int index = order[ rank ];
+    sprintf( line, "%12.3f %9ld %14.3f  ",
+             totalSecondsAt( index ) * 1e3,
+             callCountAt( index ),
+             secondsPerCallAt( index ) * 1e6 );
+    stream << line << callbackNameAt( index ) << "::" << eventAt( index ) << "\n";
+  }
+}
+
+
+CPPUNIT_NS_END
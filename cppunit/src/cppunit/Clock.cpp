@@ -0,0 +1,101 @@
+#include <cppunit/tools/Clock.h>
+
+#if defined(CPPUNIT_HAVE_CLOCK_GETTIME)  ||  defined(CPPUNIT_HAVE_NANOSLEEP)
+#include <time.h>
+#elif defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN 
+#define NOGDI
+#define NOUSER
+#define NOKERNEL
+#define NOSOUND
+#define NOMINMAX
+#define BLENDFUNCTION void    // for mingw & gcc  
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#if !defined(CPPUNIT_HAVE_CLOCK_GETTIME)  &&  !defined(_WIN32)  &&  \
+    defined(CPPUNIT_HAVE_GETTIMEOFDAY)  &&  defined(CPPUNIT_HAVE_SYS_TIME_H)
+#define CPPUNIT_CLOCK_USE_GETTIMEOFDAY 1
+#include <sys/time.h>
+#endif
+
+#if !defined(CPPUNIT_HAVE_NANOSLEEP)  &&  !defined(_WIN32)  &&  \
+    defined(CPPUNIT_HAVE_UNISTD_H)
+#define CPPUNIT_CLOCK_USE_SLEEP 1
+#include <unistd.h>
+#endif
+
+
+CPPUNIT_NS_BEGIN
+
+
+/*! Final part of a wait spent polling the clock, in seconds. Sleeping may
+ *  overshoot by the timer granularity, or return early on a signal.
+ */
+#if defined(_WIN32)
+static const double clockSpinSeconds = 0.002;
+#else
+static const double clockSpinSeconds = 0.0002;
+#endif
+
+
+double 
+Clock::now()
+{
+#if defined(CPPUNIT_HAVE_CLOCK_GETTIME)
+  struct timespec time;
+  clock_gettime( CLOCK_MONOTONIC, &time );
+  return time.tv_sec + time.tv_nsec * 1e-9;
+#elif defined(_WIN32)
+  LARGE_INTEGER frequency;
+  LARGE_INTEGER counter;
+  ::QueryPerformanceFrequency( &frequency );
+  ::QueryPerformanceCounter( &counter );
+  return double(counter.QuadPart) / double(frequency.QuadPart);
+#elif defined(CPPUNIT_CLOCK_USE_GETTIMEOFDAY)
+  struct timeval time;
+  gettimeofday( &time, NULL );
+  return time.tv_sec + time.tv_usec * 1e-6;
+#else
+  return double( time( NULL ) );
+#endif
+}
+
+
+/// Suspends the calling thread for about \a duration seconds, or less.
+static void
+sleepFor( double duration )
+{
+#if defined(CPPUNIT_HAVE_NANOSLEEP)
+  struct timespec delay;
+  delay.tv_sec = (time_t)duration;
+  delay.tv_nsec = (long)( (duration - delay.tv_sec) * 1e9 );
+  nanosleep( &delay, NULL );
+#elif defined(_WIN32)
+  ::Sleep( (DWORD)(duration * 1000) );
+#elif defined(CPPUNIT_CLOCK_USE_SLEEP)
+  // Whole seconds only: the last second is spent polling the clock.
+  ::sleep( (unsigned int)duration );
+#endif
+}
+
+
+void 
+Clock::sleepUntil( double time )
+{
+  while ( true )
+  {
+    double remaining = time - now();
+    if ( remaining <= clockSpinSeconds )
+      break;
+    sleepFor( remaining - clockSpinSeconds );
+  }
+
+  while ( now() < time )
+    ;
+}
+
+
+CPPUNIT_NS_END
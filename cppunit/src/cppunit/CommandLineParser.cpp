@@ -0,0 +1,556 @@
+#include <cppunit/CommandLineParser.h>
+#include <stdlib.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Default time a worker may run a test in the coordinator modes.
+static const double commandLineDefaultTestTimeout = 300;
+
+/// Default time the coordinator waits while no worker is connected.
+static const double commandLineDefaultWorkerWaitTimeout = 300;
+
+
+CommandLineParser::CommandLineParser( int argc, 
+                                      const char *argv[] )
+    : m_useCompiler( false )
+    , m_useXml( false )
+    , m_briefProgress( false )
+    , m_noProgress( false )
+    , m_useText( false )
+    , m_useCout( false )
+    , m_waitBeforeExit( false )
+    , m_updateSnapshots( false )
+    , m_raiseBenchmarkPriority( false )
+    , m_profileListeners( false )
+    , m_profileStartup( false )
+    , m_measureIdleTime( false )
+    , m_metricsWorkerIndex( 0 )
+    , m_coordinatorPort( -1 )
+    , m_workerPort( -1 )
+    , m_testTimeout( commandLineDefaultTestTimeout )
+    , m_workerWaitTimeout( commandLineDefaultWorkerWaitTimeout )
+    , m_threadCount( 0 )
+    , m_processCount( 0 )
+    , m_shardIndex( 0 )
+    , m_shardCount( 0 )
+    , m_reportTiming( false )
+    , m_showHelp( false )
+    , m_currentArgument( 0 )
+{
+  for ( int index =1; index < argc; ++index )
+  {
+    std::string argument( argv[index ] );
+    m_arguments.push_back( argument );
+  }
+}
+
+
+CommandLineParser::~CommandLineParser()
+{
+}
+
+
+void 
+CommandLineParser::parse()
+{
+  while ( hasNextArgument() )
+  {
+    getNextOption();
+    if ( isOption( "c", "compiler" ) )
+      m_useCompiler = true;
+    else if ( isOption( "x", "xml" ) )
+    {
+      m_useXml = true;
+      m_xmlFileName = getNextOptionalParameter();
+    }
+    else if ( isOption( "s", "xsl" ) )
+      m_xsl = getNextParameter();
+    else if ( isOption( "e", "encoding" ) )
+      m_encoding = getNextParameter();
+    else if ( isOption( "b", "brief-progress" ) )
+      m_briefProgress = true;
+    else if ( isOption( "n", "no-progress" ) )
+      m_noProgress = true;
+    else if ( isOption( "t", "text" ) )
+      m_useText = true;
+    else if ( isOption( "o", "cout" ) )
+      m_useCout = true;
+    else if ( isOption( "w", "wait" ) )
+      m_waitBeforeExit = true;
+    else if ( isOption( "g", "tags" ) )
+      m_tagExpression = getNextParameter();
+    else if ( isOption( "u", "update-snapshots" ) )
+      m_updateSnapshots = true;
+    else if ( isOption( "a", "benchmark-cpus" ) )
+    {
+      if ( !BenchmarkControls::parseCpuList( getNextParameter(), 
+                                                         m_benchmarkCpus ) )
+        fail( "invalid CPU list, expected indexes and ranges such as 0-3,6" );
+    }
+    else if ( isOption( "r", "raise-priority" ) )
+      m_raiseBenchmarkPriority = true;
+    else if ( isOption( "j", "benchmark-results" ) )
+      m_benchmarkResultsFileName = getNextParameter();
+    else if ( isOption( "k", "benchmark-baseline" ) )
+      m_benchmarkBaselineFileName = getNextParameter();
+    else if ( isOption( "p", "profile-listeners" ) )
+      m_profileListeners = true;
+    else if ( isOption( "i", "startup-profile" ) )
+      m_profileStartup = true;
+    else if ( isOption( "d", "idle-time" ) )
+      m_measureIdleTime = true;
+    else if ( isOption( "m", "live-metrics" ) )
+      m_liveMetricsFileName = getNextParameter();
+    else if ( isOption( "l", "metrics-worker" ) )
+    {
+      std::string index = getNextParameter();
+      char *end = NULL;
+      m_metricsWorkerIndex = int( strtol( index.c_str(), &end, 10 ) );
+      if ( index.empty()  ||  *end != 0  ||  m_metricsWorkerIndex < 0  ||
+           m_metricsWorkerIndex >= LiveMetricsSegment::slotCount )
+        fail( "invalid worker index, expected a number between 0 and 63" );
+    }
+    else if ( isOption( "f", "metrics-textfile" ) )
+      m_metricsTextFileName = getNextParameter();
+    else if ( isOption( "C", "coordinator" ) )
+      m_coordinatorPort = parsePort( getNextParameter() );
+    else if ( isOption( "W", "worker" ) )
+    {
+      std::string address = getNextParameter();
+      std::string::size_type separator = address.rfind( ':' );
+      if ( separator == std::string::npos  ||  separator == 0 )
+        fail( "invalid coordinator address, expected host:port" );
+      m_workerHost = address.substr( 0, separator );
+      m_workerPort = parsePort( address.substr( separator +1 ) );
+    }
+    else if ( isOption( "O", "test-timeout" ) )
+      m_testTimeout = parseSeconds( getNextParameter() );
+    else if ( isOption( "A", "worker-wait" ) )
+      m_workerWaitTimeout = parseSeconds( getNextParameter() );
+    else if ( isOption( "P", "parallel" ) )
+      m_threadCount = parsePositive( getNextParameter() );
+    else if ( isOption( "N", "processes" ) )
+      m_processCount = parsePositive( getNextParameter() );
+    else if ( isOption( "S", "shard" ) )
+    {
+      std::string shard = getNextParameter();
+      std::string::size_type separator = shard.find( '/' );
+      if ( separator == std::string::npos )
+        fail( "invalid shard, expected index/count" );
+      m_shardCount = parsePositive( shard.substr( separator +1 ) );
+      char *end = NULL;
+      std::string index = shard.substr( 0, separator );
+      m_shardIndex = int( strtol( index.c_str(), &end, 10 ) );
+      if ( index.empty()  ||  *end != 0  ||  m_shardIndex < 0  ||
+           m_shardIndex >= m_shardCount )
+        fail( "invalid shard index, expected a number between 0 and count - 1" );
+    }
+    else if ( isOption( "T", "timing" ) )
+      m_reportTiming = true;
+    else if ( isOption( "h", "help" ) )
+      m_showHelp = true;
+    else if ( !m_option.empty() )
+      fail( "Unknown option" );
+    else if ( hasNextArgument() )
+      readNonOptionCommands();
+  }
+
+  int modeCount = ( m_coordinatorPort >= 0 ? 1 : 0 )  +  
+                  ( m_workerHost.empty() ? 0 : 1 )  +
+                  ( m_threadCount > 0 ? 1 : 0 )  +
+                  ( m_processCount > 0 ? 1 : 0 );
+  if ( modeCount > 1 )
+    fail( "only one of --coordinator, --worker, --parallel and --processes "
+          "can be specified" );
+}
+
+
+void 
+CommandLineParser::readNonOptionCommands()
+{
+  if ( argumentStartsWith( ":" ) )
+    m_testPath = getNextArgument().substr( 1 );
+  else
+  {
+    CommandLinePlugInInfo plugIn;
+    int indexParameter = getCurrentArgument().find( '=' );
+    if ( indexParameter < 0 )
+      plugIn.m_fileName = getCurrentArgument();
+    else
+    {
+      plugIn.m_fileName = getCurrentArgument().substr( 0, indexParameter );
+      std::string parameters = getCurrentArgument().substr( indexParameter +1 );
+      plugIn.m_parameters = PlugInParameters( parameters );
+    }
+    
+    m_plugIns.push_back( plugIn );
+
+    getNextArgument();
+  }
+}
+
+
+bool 
+CommandLineParser::hasNextArgument() const
+{
+  return m_currentArgument < m_arguments.size();
+}
+
+
+std::string 
+CommandLineParser::getNextArgument()
+{
+  if ( hasNextArgument() )
+    return m_arguments[ m_currentArgument++ ];
+  return "";
+}
+
+
+std::string 
+CommandLineParser::getCurrentArgument() const
+{
+  if ( m_currentArgument < m_arguments.size() )
+    return m_arguments[ m_currentArgument ];
+  return "";
+}
+
+
+bool 
+CommandLineParser::argumentStartsWith( const std::string &expected ) const
+{
+  return getCurrentArgument().substr( 0, expected.length() ) == expected;
+}
+
+
+void 
+CommandLineParser::getNextOption()
+{
+  if ( argumentStartsWith( "-" )  ||  argumentStartsWith( "--" ) )
+    m_option = getNextArgument();
+  else
+    m_option = "";
+}
+
+
+bool 
+CommandLineParser::isOption( const std::string &shortName,
+                             const std::string &longName )
+{
+  return (m_option == "-" + shortName)  ||
+         (m_option == "--" + longName);
+}
+
+
+std::string 
+CommandLineParser::getNextParameter()
+{
+  if ( !hasNextArgument() )
+    fail( "missing parameter" );
+  return getNextArgument();
+}
+
+
+std::string
+CommandLineParser::getNextOptionalParameter()
+{
+  if ( argumentStartsWith( "-" )  ||  argumentStartsWith( ":" ) )
+    return "";
+  return getNextArgument();
+}
+
+
+int
+CommandLineParser::parsePort( const std::string &port )
+{
+  char *end = NULL;
+  long value = strtol( port.c_str(), &end, 10 );
+  if ( port.empty()  ||  *end != 0  ||  value < 0  ||  value > 65535 )
+    fail( "invalid port, expected a number between 0 and 65535" );
+  return int( value );
+}
+
+
+int
+CommandLineParser::parsePositive( const std::string &value )
+{
+  char *end = NULL;
+  long number = strtol( value.c_str(), &end, 10 );
+  if ( value.empty()  ||  *end != 0  ||  number <= 0 )
+    fail( "invalid number, expected a positive integer" );
+  return int( number );
+}
+
+
+double
+CommandLineParser::parseSeconds( const std::string &value )
+{
+  char *end = NULL;
+  double seconds = strtod( value.c_str(), &end );
+  if ( value.empty()  ||  *end != 0  ||  !(seconds >= 0) )
+    fail( "invalid time, expected a number of seconds, 0 for no limit" );
+  return seconds;
+}
+
+
+void 
+CommandLineParser::fail( std::string message )
+{
+  throw CommandLineParserException( "while parsing option " + m_option+
+            ",\n" + message );
+}
+
+
+bool 
+CommandLineParser::useCompilerOutputter() const
+{
+  return m_useCompiler;
+}
+
+
+bool 
+CommandLineParser::useXmlOutputter() const
+{
+  return m_useXml;
+}
+
+
+std::string 
+CommandLineParser::getXmlFileName() const
+{
+  return m_xmlFileName;
+}
+
+
+std::string 
+CommandLineParser::getXmlStyleSheet() const
+{
+  return m_xsl;
+}
+
+
+std::string 
+CommandLineParser::getEncoding() const
+{
+  return m_encoding;
+}
+
+
+bool 
+CommandLineParser::useBriefTestProgress() const
+{
+  return m_briefProgress;
+}
+
+
+bool 
+CommandLineParser::noTestProgress() const
+{
+  return m_noProgress;
+}
+
+
+bool 
+CommandLineParser::useTextOutputter() const
+{
+  return m_useText;
+}
+
+
+bool 
+CommandLineParser::useCoutStream() const
+{
+  return m_useCout;
+}
+
+
+bool 
+CommandLineParser::waitBeforeExit() const
+{
+  return m_waitBeforeExit;
+}
+
+
+int 
+CommandLineParser::getPlugInCount() const
+{
+  return m_plugIns.size(); 
+}
+
+CommandLinePlugInInfo 
+CommandLineParser::getPlugInAt( int index ) const
+{
+  return m_plugIns[ index ];
+}
+
+
+std::string 
+CommandLineParser::getTestPath() const
+{
+  return m_testPath;
+}
+
+
+std::string 
+CommandLineParser::getTagExpression() const
+{
+  return m_tagExpression;
+}
+
+
+bool 
+CommandLineParser::updateSnapshots() const
+{
+  return m_updateSnapshots;
+}
+
+
+const CppUnitVector<int> &
+CommandLineParser::getBenchmarkCpus() const
+{
+  return m_benchmarkCpus;
+}
+
+
+bool 
+CommandLineParser::raiseBenchmarkPriority() const
+{
+  return m_raiseBenchmarkPriority;
+}
+
+
+std::string 
+CommandLineParser::getBenchmarkResultsFileName() const
+{
+  return m_benchmarkResultsFileName;
+}
+
+
+std::string 
+CommandLineParser::getBenchmarkBaselineFileName() const
+{
+  return m_benchmarkBaselineFileName;
+}
+
+
+bool 
+CommandLineParser::profileListeners() const
+{
+  return m_profileListeners;
+}
+
+
+bool 
+CommandLineParser::profileStartup() const
+{
+  return m_profileStartup;
+}
+
+
+bool 
+CommandLineParser::measureIdleTime() const
+{
+  return m_measureIdleTime;
+}
+
+
+std::string 
+CommandLineParser::getLiveMetricsFileName() const
+{
+  return m_liveMetricsFileName;
+}
+
+
+int 
+CommandLineParser::getMetricsWorkerIndex() const
+{
+  return m_metricsWorkerIndex;
+}
+
+
+std::string 
+CommandLineParser::getMetricsTextFileName() const
+{
+  return m_metricsTextFileName;
+}
+
+
+int 
+CommandLineParser::getCoordinatorPort() const
+{
+  return m_coordinatorPort;
+}
+
+
+std::string 
+CommandLineParser::getWorkerHost() const
+{
+  return m_workerHost;
+}
+
+
+int 
+CommandLineParser::getWorkerPort() const
+{
+  return m_workerPort;
+}
+
+
+double 
+CommandLineParser::getTestTimeout() const
+{
+  return m_testTimeout;
+}
+
+
+double 
+CommandLineParser::getWorkerWaitTimeout() const
+{
+  return m_workerWaitTimeout;
+}
+
+
+int 
+CommandLineParser::getThreadCount() const
+{
+  return m_threadCount;
+}
+
+
+int 
+CommandLineParser::getProcessCount() const
+{
+  return m_processCount;
+}
+
+
+int 
+CommandLineParser::getShardIndex() const
+{
+  return m_shardIndex;
+}
+
+
+int 
+CommandLineParser::getShardCount() const
+{
+  return m_shardCount;
+}
+
+
+bool 
+CommandLineParser::reportTiming() const
+{
+  return m_reportTiming;
+}
+
+
+bool 
+CommandLineParser::showHelp() const
+{
+  return m_showHelp;
+}
+
+
+CPPUNIT_NS_END
@@ -0,0 +1,872 @@
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CallbackProfile.h>
+#include <cppunit/CommandLineParser.h>
+#include <cppunit/CommandLineRunner.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/IdleTimeListener.h>
+#include <cppunit/LiveMetricsListener.h>
+#include <cppunit/TestLeaf.h>
+#include <cppunit/TestPath.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+#include <cppunit/TextOutputter.h>
+#include <cppunit/TextTestProgressListener.h>
+#include <cppunit/XmlOutputter.h>
+#include <cppunit/extensions/BenchmarkComparison.h>
+#include <cppunit/extensions/BenchmarkReport.h>
+#include <cppunit/extensions/BenchmarkResultFile.h>
+#include <cppunit/extensions/DistributedRunner.h>
+#include <cppunit/extensions/LatencyReport.h>
+#include <cppunit/extensions/ResourceScheduler.h>
+#include <cppunit/extensions/Snapshot.h>
+#include <cppunit/extensions/StartupProfile.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/extensions/TestTags.h>
+#include <cppunit/plugin/DynamicLibraryManagerException.h>
+#include <cppunit/plugin/PlugInManager.h>
+#include <cppunit/portability/CppUnitMap.h>
+#include <cppunit/tools/Clock.h>
+#include <cppunit/tools/ThreadGroup.h>
+#include <algorithm>
+#include <stdio.h>
+#include <utility>
+
+#if !defined( CPPUNIT_NO_STREAM )
+#include <iostream>
+#endif
+
+#if defined(CPPUNIT_HAVE_FORK)  &&  defined(CPPUNIT_HAVE_SYS_WAIT_H)  &&  \
+    defined(CPPUNIT_HAVE_UNISTD_H)
+#define CPPUNIT_COMMANDLINERUNNER_USE_FORK 1
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+
+/* Notes:
+
+  Memory allocated by test plug-in must be freed before unloading the test plug-in.
+  That is the reason why the XmlOutputter is explicitely destroyed.
+ */
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Time the coordinator of the process mode waits once all workers died.
+static const double commandLineWorkerWaitSeconds = 10;
+/// Workers a test of the process mode is assigned to before it is an error.
+static const int commandLineMaximumAttempts = 3;
+
+
+/// Records the wall time of each test, and of the run (--timing).
+class CommandLineTestTimer : public TestListener
+{
+public:
+  CommandLineTestTimer()
+      : m_runStartTime( 0 )
+      , m_runSeconds( 0 )
+  {
+  }
+
+  void startTestRun( Test *,
+                     TestResult * )
+  {
+    m_runStartTime = Clock::now();
+  }
+
+  void startTest( Test *test )
+  {
+    m_startTimes[ test ] = Clock::now();
+  }
+
+  void endTest( Test *test )
+  {
+    double seconds = Clock::now() - m_startTimes[ test ];
+    m_startTimes.erase( test );
+    m_times.push_back( TestTime( seconds, test->getName() ) );
+  }
+
+  void endTestRun( Test *,
+                   TestResult * )
+  {
+    m_runSeconds = Clock::now() - m_runStartTime;
+  }
+
+  /// Writes the time of the run and the slowest tests.
+  void write( OStream &stream,
+              int maximumTestCount = 10 )
+  {
+    std::sort( m_times.begin(), m_times.end() );
+    char line[ 64 ];
+    sprintf( line, "%.3f s", m_runSeconds );
+    stream << "Run time: " << line << " for " << int(m_times.size()) << " tests\n";
+    if ( !m_times.empty() )
+      stream << "Slowest tests:\n";
+    for ( int index =0; index < maximumTestCount  &&  index < int(m_times.size()); ++index )
+    {
+      const TestTime &time = m_times[ m_times.size() - 1 - index ];
+      sprintf( line, "  %10.3f s  ", time.first );
+      stream << line << time.second << "\n";
+    }
+  }
+
+private:
+  typedef std::pair<double, std::string> TestTime;
+  typedef CppUnitMap<Test *, double, std::less<Test *> > StartTimes;
+
+  double m_runStartTime;
+  double m_runSeconds;
+  StartTimes m_startTimes;
+  CppUnitVector<TestTime> m_times;
+};
+
+
+/// Runs the tests of a batch, one per thread.
+class CommandLineBatchTask : public ThreadTask
+{
+public:
+  CommandLineBatchTask( const ResourceScheduler::Tests &tests,
+                        TestResult *result )
+      : m_tests( tests )
+      , m_result( result )
+  {
+  }
+
+  void run( int threadIndex )
+  {
+    if ( !m_result->shouldStop() )
+      m_tests[ threadIndex ]->run( m_result );
+  }
+
+private:
+  const ResourceScheduler::Tests &m_tests;
+  TestResult *m_result;
+};
+
+
+/// Test run by TestResult::runTest() to run the test cases on threads.
+class CommandLineParallelRun : public TestLeaf
+{
+public:
+  CommandLineParallelRun( Test *test,
+                          int threadCount )
+      : m_test( test )
+      , m_threadCount( threadCount )
+  {
+  }
+
+  int countTestCases() const
+  {
+    return m_test->countTestCases();
+  }
+
+  void run( TestResult *result )
+  {
+    ResourceScheduler scheduler( m_threadCount );
+    scheduler.addTest( m_test );
+    for ( int index =0; index < scheduler.getBatchCount(); ++index )
+    {
+      if ( result->shouldStop() )
+        break;
+      const ResourceScheduler::Tests &batch = scheduler.getBatchAt( index );
+      CommandLineBatchTask task( batch, result );
+      ThreadGroup::run( task, batch.size() );
+    }
+  }
+
+  std::string getName() const
+  {
+    return m_test->getName();
+  }
+
+private:
+  Test *m_test;
+  int m_threadCount;
+};
+
+
+#if defined(CPPUNIT_COMMANDLINERUNNER_USE_FORK)
+/*! \brief Forks the workers of the process mode, and replaces the lost ones.
+ *
+ * A worker that crashed is reaped and replaced by a new one. A worker the
+ * coordinator gave up on (its test timed out) is killed first. The number
+ * of replacements is bounded, so that workers dying as soon as they start
+ * do not make the run fork forever.
+ */
+class CommandLineWorkerProcesses : public DistributedWorkerLauncher
+{
+public:
+  CommandLineWorkerProcesses( DistributedCoordinator &coordinator,
+                              Test *test,
+                              PlugInManager *plugInManager,
+                              int replacementCount )
+      : m_coordinator( coordinator )
+      , m_test( test )
+      , m_plugInManager( plugInManager )
+      , m_replacementCount( replacementCount )
+  {
+  }
+
+  /*! \brief Waits for the workers, which the coordinator told to quit.
+   *
+   * The workers left after commandLineWorkerWaitSeconds, such as those of a
+   * run interrupted by an exception, are killed.
+   */
+  ~CommandLineWorkerProcesses()
+  {
+    double deadline = Clock::now() + commandLineWorkerWaitSeconds;
+    for ( unsigned int index =0; index < m_workerIds.size(); ++index )
+    {
+      while ( ::waitpid( m_workerIds[ index ], NULL, WNOHANG ) == 0 )
+      {
+        if ( Clock::now() > deadline )
+        {
+          ::kill( m_workerIds[ index ], SIGKILL );
+          ::waitpid( m_workerIds[ index ], NULL, 0 );
+          break;
+        }
+        Clock::sleepUntil( Clock::now() + 0.01 );
+      }
+    }
+  }
+
+  /// Forks a worker. Returns \c false if it could not be forked.
+  bool startWorker()
+  {
+    // Output buffered before the fork would be written by every worker.
+    stdCOut().flush();
+    stdCErr().flush();
+    fflush( NULL );
+
+    pid_t workerId = ::fork();
+    if ( workerId < 0 )
+      return false;
+    if ( workerId == 0 )
+      runWorker();
+    m_workerIds.push_back( workerId );
+    return true;
+  }
+
+  int workerCount() const
+  {
+    return m_workerIds.size();
+  }
+
+  void superviseWorkers()
+  {
+    for ( int index = m_workerIds.size() -1; index >= 0; --index )
+    {
+      if ( ::waitpid( m_workerIds[ index ], NULL, WNOHANG ) == 0 )
+        continue;
+      m_workerIds.erase( m_workerIds.begin() + index );
+      if ( m_replacementCount > 0  &&  startWorker() )
+        --m_replacementCount;
+    }
+  }
+
+  void workerLost( int processId )
+  {
+    // The worker may be stuck in a test: it would never read the quit record.
+    for ( unsigned int index =0; index < m_workerIds.size(); ++index )
+    {
+      if ( m_workerIds[ index ] == processId )
+        ::kill( m_workerIds[ index ], SIGKILL );
+    }
+  }
+
+private:
+  /// Runs the worker process: reports to the coordinator only, then exits.
+  void runWorker()
+  {
+    m_coordinator.releaseSockets();
+    int exitCode = 0;
+    try
+    {
+      TestResult workerController;
+#if !defined(CPPUNIT_NO_TESTPLUGIN)
+      if ( m_plugInManager != NULL )
+        m_plugInManager->addListener( &workerController );
+#endif
+      DistributedWorker worker;
+      worker.addTest( m_test );
+      worker.run( "127.0.0.1", m_coordinator.port(), workerController );
+    }
+    catch ( ... )
+    {
+      exitCode = 1;
+    }
+    ::_exit( exitCode );
+  }
+
+  /// Prevents the use of the copy constructor.
+  CommandLineWorkerProcesses( const CommandLineWorkerProcesses &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const CommandLineWorkerProcesses &other );
+
+private:
+  DistributedCoordinator &m_coordinator;
+  Test *m_test;
+  PlugInManager *m_plugInManager;
+  int m_replacementCount;
+  CppUnitVector<pid_t> m_workerIds;
+};
+#endif
+
+
+CommandLineRunner::CommandLineRunner( const std::string &registryName )
+    : m_registryName( registryName )
+    , m_plugInManager( NULL )
+{
+}
+
+
+CommandLineRunner::~CommandLineRunner()
+{
+}
+
+
+int
+CommandLineRunner::main( int argc,
+                         const char *argv[] )
+{
+  std::string applicationName( argc > 0 ? argv[0] : "" );
+  CommandLineParser parser( argc, argv );
+  try
+  {
+    parser.parse();
+  }
+  catch ( CommandLineParserException &e )
+  {
+    stdCOut()  <<  "Error while parsing command line: "  <<  e.what()
+               << "\n\n";
+    printShortUsage( applicationName );
+    return badCommandLineReturnCode;
+  }
+
+  if ( parser.showHelp() )
+  {
+    printUsage( applicationName );
+    return successReturnCode;
+  }
+
+  bool wasSuccessful = false;
+  try
+  {
+    wasSuccessful = run( parser );
+  }
+#if !defined(CPPUNIT_NO_TESTPLUGIN)
+  catch ( DynamicLibraryManagerException &e )
+  {
+    stdCOut()  << "Failed to load test plug-in:\n"
+               << e.what() << "\n";
+  }
+#endif
+  catch ( std::runtime_error &e )
+  {
+    stdCOut()  << e.what() << "\n";
+  }
+
+#if !defined( CPPUNIT_NO_STREAM )
+  if ( parser.waitBeforeExit() )
+  {
+    stdCOut() << "Please press <RETURN> to exit\n";
+    stdCOut().flush();
+    std::cin.get();
+  }
+#endif
+
+  return wasSuccessful ? successReturnCode : failureReturnCode;
+}
+
+
+bool
+CommandLineRunner::run( const CommandLineParser &parser )
+{
+  bool wasSuccessful = false;
+
+  // Segment where the progress of the run is published for cppunit-top.
+  LiveMetricsSegment *liveMetricsSegment = NULL;
+  if ( !parser.getLiveMetricsFileName().empty() )
+  {
+    try
+    {
+      liveMetricsSegment = new LiveMetricsSegment(
+          parser.getLiveMetricsFileName(), true );
+    }
+    catch ( std::runtime_error &e )
+    {
+      stdCOut() << "Live metrics: " << e.what() << "\n";
+      return false;
+    }
+  }
+
+#if !defined(CPPUNIT_NO_TESTPLUGIN)
+  PlugInManager plugInManager;
+  m_plugInManager = &plugInManager;
+#else
+  if ( parser.getPlugInCount() > 0 )
+  {
+    stdCOut() << "Test plug-ins are not supported by this build of CppUnit.\n";
+    delete liveMetricsSegment;
+    return false;
+  }
+#endif
+
+  // The following scope is used to explicitely free all memory allocated before
+  // unload the test plug-ins (uppon plugInManager destruction).
+  {
+    // Tests run on threads report their events concurrently.
+    TestResult controller( parser.getThreadCount() > 0 ? new ThreadMutex() : 0 );
+    TestResultCollector result;
+    controller.addListener( &result );
+
+    // Times the listeners and hooks, those of the plug-ins included.
+    CallbackProfile profile;
+    if ( parser.profileListeners() )
+      controller.setProfile( &profile );
+
+    // Set up outputters
+    OStream *stream = &stdCErr();
+    if ( parser.useCoutStream() )
+      stream = &stdCOut();
+
+    OStream *xmlStream = stream;
+    if ( !parser.getXmlFileName().empty() )
+      xmlStream = new OFileStream( parser.getXmlFileName().c_str() );
+
+    XmlOutputter xmlOutputter( &result, *xmlStream, parser.getEncoding() );
+    xmlOutputter.setStyleSheet( parser.getXmlStyleSheet() );
+    if ( parser.profileListeners() )
+      xmlOutputter.setProfile( &profile );
+    LatencyXmlOutputterHook latencyHook;
+    xmlOutputter.addHook( &latencyHook );
+    BenchmarkXmlOutputterHook benchmarkHook;
+    xmlOutputter.addHook( &benchmarkHook );
+    TextOutputter textOutputter( &result, *stream );
+    CompilerOutputter compilerOutputter( &result, *stream );
+
+    // Set up test listeners
+    BriefTestProgressListener briefListener;
+    TextTestProgressListener dotListener;
+    if ( parser.useBriefTestProgress() )
+      controller.addListener( &briefListener );
+    else if ( !parser.noTestProgress() )
+      controller.addListener( &dotListener );
+    IdleTimeListener idleTimeListener;
+    if ( parser.measureIdleTime() )
+      controller.addListener( &idleTimeListener );
+    CommandLineTestTimer timer;
+    if ( parser.reportTiming() )
+      controller.addListener( &timer );
+    LiveMetricsListener *liveMetricsListener = NULL;
+    if ( liveMetricsSegment != NULL )
+    {
+      liveMetricsListener = new LiveMetricsListener(
+          *liveMetricsSegment,
+          parser.getMetricsWorkerIndex(),
+          parser.getMetricsTextFileName() );
+      controller.addListener( liveMetricsListener );
+    }
+
+    // Times the loading of the plug-ins and the construction of the tests.
+    StartupProfile &startupProfile = StartupProfile::getProfile();
+    startupProfile.setEnabled( parser.profileStartup() );
+
+#if !defined(CPPUNIT_NO_TESTPLUGIN)
+    // Set up plug-ins
+    for ( int index =0; index < parser.getPlugInCount(); ++index )
+    {
+      CommandLinePlugInInfo plugIn = parser.getPlugInAt( index );
+      plugInManager.load( plugIn.m_fileName, plugIn.m_parameters );
+    }
+
+    // Registers plug-in specific TestListener (global setUp/tearDown, custom TestListener...)
+    plugInManager.addListener( &controller );
+#endif
+
+    if ( parser.updateSnapshots() )
+      SnapshotStore::getStore().setUpdateMode( true );
+
+    BenchmarkControls &benchmarkControls = BenchmarkControls::getControls();
+    benchmarkControls.setCpus( parser.getBenchmarkCpus() );
+    benchmarkControls.setRaisePriority( parser.raiseBenchmarkPriority() );
+    if ( benchmarkControls.pinsThreads()  ||  benchmarkControls.raisesPriority() )
+    {
+      // Benchmarks are run: warns about what makes their timings noisy.
+      BenchmarkEnvironment environment = BenchmarkEnvironment::detect();
+      for ( int index =0; index < environment.warningCount(); ++index )
+        *stream << "Warning: " << environment.warningAt( index ) << "\n";
+    }
+
+    // Adds the registry suite
+    TestRunner runner;
+    double makeTestStartTime = Clock::now();
+    Test *root = TestFactoryRegistry::getRegistry( m_registryName ).makeTest();
+    runner.addTest( root );
+    startupProfile.addPhaseTime( "make tests", Clock::now() - makeTestStartTime );
+
+    // Runs the specified test
+    try
+    {
+      if ( parser.getShardCount() > 0  ||  parser.getThreadCount() > 0  ||
+           parser.getProcessCount() > 0  ||  parser.getCoordinatorPort() >= 0  ||
+           !parser.getWorkerHost().empty() )
+        runSelectedTests( parser, root, controller );
+      else if ( parser.getTagExpression().empty() )
+        runner.run( controller, parser.getTestPath() );
+      else
+        runner.runTagged( controller,
+                          parser.getTagExpression(),
+                          parser.getTestPath() );
+      wasSuccessful = result.wasSuccessful();
+      if ( !processBenchmarkResults( parser, *stream ) )
+        wasSuccessful = false;
+    }
+    catch ( std::invalid_argument &e )
+    {
+      stdCOut()  <<  "Failed to select tests (test path: "
+                 <<  parser.getTestPath()
+                 <<  ", tags: "
+                 <<  parser.getTagExpression()
+                 <<  "):\n"
+                 <<  e.what()
+                 <<  "\n";
+    }
+    catch ( std::runtime_error &e )
+    {
+      stdCOut()  <<  "Distributed run: "  <<  e.what()  <<  "\n";
+      wasSuccessful = false;
+    }
+
+#if !defined(CPPUNIT_NO_TESTPLUGIN)
+    // Removes plug-in specific TestListener (not really needed but...)
+    plugInManager.removeListener( &controller );
+#endif
+
+    // write using outputters
+    if ( parser.useCompilerOutputter() )
+      compilerOutputter.write();
+
+    if ( parser.useTextOutputter() )
+      textOutputter.write();
+
+    if ( parser.useXmlOutputter() )
+    {
+#if !defined(CPPUNIT_NO_TESTPLUGIN)
+      plugInManager.addXmlOutputterHooks( &xmlOutputter );
+#endif
+      xmlOutputter.write();
+#if !defined(CPPUNIT_NO_TESTPLUGIN)
+      plugInManager.removeXmlOutputterHooks();
+#endif
+    }
+
+    if ( parser.profileStartup() )
+      startupProfile.write( *stream );
+
+    if ( parser.profileListeners() )
+      profile.write( *stream );
+
+    if ( parser.measureIdleTime() )
+      idleTimeListener.write( *stream );
+
+    if ( parser.reportTiming() )
+      timer.write( *stream );
+
+    if ( !parser.getXmlFileName().empty() )
+      delete xmlStream;
+
+    delete liveMetricsListener;
+  }
+
+  m_plugInManager = NULL;
+  delete liveMetricsSegment;
+
+  return wasSuccessful;
+}
+
+
+void
+CommandLineRunner::runSelectedTests( const CommandLineParser &parser,
+                                     Test *root,
+                                     TestResult &controller )
+{
+  double startTime = Clock::now();
+  Test *test = root;
+  if ( !parser.getTestPath().empty() )
+    test = root->resolveTestPath( parser.getTestPath() ).getChildTest();
+
+  TestSelection tagged( test->getName() );
+  if ( !parser.getTagExpression().empty() )
+  {
+    TaggedTestIndex index;
+    index.addTest( test );
+    index.select( TagExpression( parser.getTagExpression() ), tagged );
+    test = &tagged;
+  }
+
+  // Every process computes the same shards from the same tests.
+  TestSelection shard( test->getName() );
+  if ( parser.getShardCount() > 0 )
+  {
+    ResourceScheduler scheduler( ThreadGroup::processorCount() );
+    scheduler.addTest( test );
+    CppUnitVector<ResourceScheduler::Tests> shards =
+        scheduler.makeShards( parser.getShardCount() );
+    const ResourceScheduler::Tests &tests = shards[ parser.getShardIndex() ];
+    for ( unsigned int index =0; index < tests.size(); ++index )
+      shard.addTest( tests[ index ] );
+    test = &shard;
+  }
+  StartupProfile::getProfile().addPhaseTime( "select tests",
+                                             Clock::now() - startTime );
+
+  if ( parser.getThreadCount() > 0 )
+  {
+    CommandLineParallelRun parallelRun( test, parser.getThreadCount() );
+    controller.runTest( &parallelRun );
+  }
+  else if ( parser.getProcessCount() > 0 )
+    runInProcesses( parser, test, controller );
+  else if ( parser.getCoordinatorPort() >= 0 )
+  {
+    DistributedCoordinator coordinator( parser.getCoordinatorPort() );
+    coordinator.addTest( test );
+    coordinator.setTestTimeout( parser.getTestTimeout() );
+    coordinator.setWorkerWaitTimeout( parser.getWorkerWaitTimeout() );
+    stdCOut() << "Coordinator listening on port " << coordinator.port()
+              << " for " << coordinator.testCount() << " tests\n";
+    stdCOut().flush();
+    coordinator.run( controller );
+  }
+  else if ( !parser.getWorkerHost().empty() )
+  {
+    // The coordinator collects the results: the worker only runs tests.
+    DistributedWorker worker;
+    worker.addTest( test );
+    worker.run( parser.getWorkerHost(), parser.getWorkerPort(), controller );
+  }
+  else
+    controller.runTest( test );
+}
+
+
+void
+CommandLineRunner::runInProcesses( const CommandLineParser &parser,
+                                   Test *test,
+                                   TestResult &controller )
+{
+#if defined(CPPUNIT_COMMANDLINERUNNER_USE_FORK)
+  DistributedCoordinator coordinator( 0 );
+  coordinator.addTest( test );
+  coordinator.setTestTimeout( parser.getTestTimeout() );
+  coordinator.setMaximumAttempts( commandLineMaximumAttempts );
+  coordinator.setWorkerWaitTimeout( commandLineWorkerWaitSeconds );
+
+  // Each attempt of a test may cost a worker.
+  CommandLineWorkerProcesses workers( coordinator, test, m_plugInManager,
+                                      coordinator.testCount() *
+                                          commandLineMaximumAttempts );
+  for ( int index =0; index < parser.getProcessCount(); ++index )
+  {
+    if ( !workers.startWorker() )
+      break;
+  }
+  if ( workers.workerCount() == 0 )
+    throw std::runtime_error( "Can not fork the worker processes." );
+
+  coordinator.setWorkerLauncher( &workers );
+  coordinator.run( controller );
+#else
+  throw std::runtime_error( "Running the tests in processes requires fork()." );
+#endif
+}
+
+
+bool
+CommandLineRunner::processBenchmarkResults( const CommandLineParser &parser,
+                                            OStream &stream )
+{
+  if ( parser.getBenchmarkResultsFileName().empty()  &&
+       parser.getBenchmarkBaselineFileName().empty() )
+    return true;
+
+  try
+  {
+    BenchmarkResultFile results;
+    results.addReport( BenchmarkReport::getReport() );
+    results.setRevision( BenchmarkResultFile::detectRevision() );
+    if ( !parser.getBenchmarkResultsFileName().empty() )
+      results.save( parser.getBenchmarkResultsFileName() );
+
+    if ( parser.getBenchmarkBaselineFileName().empty() )
+      return true;
+
+    BenchmarkResultFile baseline;
+    baseline.load( parser.getBenchmarkBaselineFileName() );
+    BenchmarkComparison comparison;
+    comparison.compare( baseline, results );
+    stream << "Benchmarks compared to " << parser.getBenchmarkBaselineFileName()
+           << ":\n";
+    comparison.write( stream );
+    return !comparison.hasRegression();
+  }
+  catch ( std::runtime_error &e )
+  {
+    stream << "Benchmark results: " << e.what() << "\n";
+    return false;
+  }
+}
+
+
+void
+CommandLineRunner::printShortUsage( const std::string &applicationName )
+{
+   stdCOut()  << "Usage:\n"
+             << applicationName  <<  " [-c -b -n -t -o -w -u -r -p -i -d -T -h] [-x xml-filename]"
+             "[-s stylesheet] [-e encoding] [-g tag-expression] [-a cpu-list] "
+             "[-j results-filename] [-k baseline-filename] [-m segment-filename] "
+             "[-l worker-index] [-f textfile-filename] [-S index/count] "
+             "[-P threads | -N count | -C port | -W host:port] "
+             "[plug-in[=parameters] ...] [:testPath]\n\n";
+}
+
+
+void
+CommandLineRunner::printUsage( const std::string &applicationName )
+{
+  printShortUsage( applicationName );
+  stdCOut()  <<
+"-c --compiler\n"
+"	Use CompilerOutputter\n"
+"-x --xml [filename]\n"
+"	Use XmlOutputter (if filename is omitted, then output to cout or\n"
+"	cerr.\n"
+"-s --xsl stylesheet\n"
+"	XML style sheet for XML Outputter\n"
+"-e --encoding encoding\n"
+"	XML file encoding (UTF8, shift_jis, ISO-8859-1...)\n"
+"-b --brief-progress\n"
+"	Use BriefTestProgressListener (default is TextTestProgressListener)\n"
+"-n --no-progress\n"
+"	Show no test progress (disable default TextTestProgressListener)\n"
+"-t --text\n"
+"	Use TextOutputter\n"
+"-o --cout\n"
+"	Ouputters output to cout instead of the default cerr.\n"
+"-w --wait\n"
+"	Wait for the user to press a return before exit.\n"
+"-g --tags expression\n"
+"	Only run the tests whose tags match the expression. Tags are\n"
+"	combined with '&', '|', '!' and parentheses (\"perf & !slow\").\n"
+"-u --update-snapshots\n"
+"	Rewrite the golden files of the snapshot assertions that fail\n"
+"	instead of reporting a failure.\n"
+"-a --benchmark-cpus cpu-list\n"
+"	Pin the benchmark threads to the listed CPUs (\"0-3,6\"). Thread i\n"
+"	runs on the i-th CPU of the list.\n"
+"-r --raise-priority\n"
+"	Raise the scheduling priority of the benchmark threads (usually\n"
+"	needs privileges).\n"
+"-j --benchmark-results filename\n"
+"	Save the samples of the benchmarks in a JSON file, with their\n"
+"	environment and the git revision.\n"
+"-k --benchmark-baseline filename\n"
+"	Compare the benchmarks to the results saved in filename. The run\n"
+"	fails if a benchmark is significantly slower.\n"
+"-p --profile-listeners\n"
+"	Time each call of the test listeners and XML outputter hooks\n"
+"	(plug-ins included) and report the slowest ones after the run.\n"
+"-i --startup-profile\n"
+"	Report the time spent loading each plug-in, making the tests of\n"
+"	each registry and selecting the tests to run, with the slowest\n"
+"	suite factories (fixtures to construct lazily).\n"
+"-d --idle-time\n"
+"	Classify each test as CPU-bound, sleep-bound or I/O-bound from its\n"
+"	thread CPU time, context switches and I/O wait, and report the\n"
+"	tests that spend the most time waiting.\n"
+"-T --timing\n"
+"	Report the time of the run and the slowest tests. With -N and -C,\n"
+"	the time of each test is not known to the reporting process.\n"
+"-m --live-metrics segment-filename\n"
+"	Publish the progress of the run (tests started and finished,\n"
+"	failures, current test, memory) in a shared memory segment stored\n"
+"	in segment-filename (use /dev/shm). Watch it with cppunit-top.\n"
+"-l --metrics-worker index\n"
+"	Slot of this process in the live metrics segment (0 to 63, default\n"
+"	is 0). Processes sharing a segment must use different slots.\n"
+"-f --metrics-textfile filename\n"
+"	Write the metrics of all the workers of the live metrics segment\n"
+"	to filename, for the textfile collector of the Prometheus node\n"
+"	exporter, at most every 10 seconds.\n"
+"-S --shard index/count\n"
+"	Only run the shard index (0 to count - 1) of the selected tests,\n"
+"	split in count shards of similar cost. Tests sharing an exclusive\n"
+"	resource are in the same shard.\n"
+"-P --parallel threads\n"
+"	Run the tests on threads, at most threads CPUs worth at a time.\n"
+"	Tests sharing an exclusive resource are not run concurrently. The\n"
+"	lines of the brief progress (-b) of concurrent tests interleave.\n"
+"-N --processes count\n"
+"	Run the tests in count forked worker processes. A test crashing\n"
+"	its worker is run again by another one, then reported as an error.\n"
+"	The crashed workers are replaced.\n"
+"-C --coordinator port\n"
+"	Do not run the tests: serve them to the workers that connect to\n"
+"	port (0 picks a free one) and report their results. The workers\n"
+"	must load the same plug-ins and select the same tests.\n"
+"-W --worker host:port\n"
+"	Run the tests assigned by the coordinator listening on host:port.\n"
+"	The results are reported by the coordinator only.\n"
+"-O --test-timeout seconds\n"
+"	With -C and -N, longest time a worker may run a test before it is\n"
+"	considered lost and the test given to another worker (default is\n"
+"	300, 0 waits forever). With -N, the worker is killed.\n"
+"-A --worker-wait seconds\n"
+"	With -C, longest time to wait while no worker is connected before\n"
+"	the remaining tests are reported as errors (default is 300, 0 waits\n"
+"	forever).\n"
+"-h --help\n"
+"	Print this help.\n"
+"filename[=\"options\"]\n"
+"	Many filenames can be specified. They are the name of the \n"
+"	test plug-ins to load. Optional plug-ins parameters can be \n"
+"	specified after the filename by adding '='.\n"
+"[:testpath]\n"
+"	Optional. Only one test path can be specified. It must \n"
+"	be prefixed with ':'. See TestPath constructor for syntax.\n"
+"\n"
+"'parameters' (test plug-in or XML filename, test path...) may contains \n"
+"spaces if double quoted. Quote may be escaped with \".\n"
+"\n"
+"Some examples of command lines:\n"
+"\n"
+"DllPlugInTesterd_dll.exe -b -x tests.xml -c simple_plugind.dll CppUnitTestPlugInd.dll\n"
+"\n"
+" Will load 2 tests plug-ins (available in lib/), use the brief test\n"
+"progress, output the result in XML in file tests.xml and also\n"
+"output the result using the compiler outputter.\n"
+"\n"
+"DllPlugInTesterd_dll.exe ClockerPlugInd.dll=\"flat\" -n CppUnitTestPlugInd.dll\n"
+"\n"
+" Will load the 2 test plug-ins, and pass the parameter string \"flat\"\n"
+"to the Clocker plug-in, disable test progress.\n\n";
+
+}
+
+
+CPPUNIT_NS_END
+
+
+int
+cppunit_main( int argc,
+              char *argv[] )
+{
+  CPPUNIT_NS::CommandLineRunner runner;
+  return runner.main( argc, (const char **)argv );
+}
@@ -0,0 +1,432 @@
+#include <cppunit/Asserter.h>
+#include <cppunit/Message.h>
+#include <cppunit/extensions/DeathTest.h>
+#include <cppunit/tools/Clock.h>
+#include <stdexcept>
+#include <stdio.h>
+
+#if defined(CPPUNIT_HAVE_FORK)  &&  defined(CPPUNIT_HAVE_SYS_WAIT_H)  &&  \
+    defined(CPPUNIT_HAVE_UNISTD_H)
+#define CPPUNIT_DEATHTEST_USE_FORK 1
+#include <errno.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#if defined(CPPUNIT_HAVE_POLL_H)  &&  defined(CPPUNIT_HAVE_POLL)
+#define CPPUNIT_DEATHTEST_USE_POLL 1
+#include <poll.h>
+#endif
+#endif
+
+#if defined(CPPUNIT_HAVE_REGEX_H)
+#include <sys/types.h>
+#include <regex.h>
+#endif
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Maximum number of characters of the standard error shown by a failure.
+static const std::string::size_type deathTestMaximumErrorLength = 1000;
+
+/// Timeout of the death tests constructed afterward.
+static double deathTestDefaultTimeout = 60;
+
+
+DeathTest::DeathTest()
+    : m_isChild( false )
+    , m_childId( 0 )
+    , m_errorDescriptor( -1 )
+    , m_outcomeDescriptor( -1 )
+    , m_outcome( running )
+    , m_status( 0 )
+    , m_timeout( deathTestDefaultTimeout )
+    , m_childTrap( NULL )
+{
+}
+
+
+DeathTest::~DeathTest()
+{
+  if ( m_isChild )
+    exitChild( returned );
+  if ( m_childId > 0  &&  m_outcome == running )
+    wait();
+}
+
+
+void
+DeathTest::setTimeout( double seconds )
+{
+  m_timeout = seconds;
+}
+
+
+double
+DeathTest::timeout() const
+{
+  return m_timeout;
+}
+
+
+void
+DeathTest::setDefaultTimeout( double seconds )
+{
+  deathTestDefaultTimeout = seconds;
+}
+
+
+double
+DeathTest::defaultTimeout()
+{
+  return deathTestDefaultTimeout;
+}
+
+
+bool
+DeathTest::spawnChild()
+{
+#if defined(CPPUNIT_DEATHTEST_USE_FORK)
+  int errorPipe[2];
+  int outcomePipe[2];
+  if ( ::pipe( errorPipe ) != 0 )
+    throw std::runtime_error( "Can not create the pipes of the death test." );
+  if ( ::pipe( outcomePipe ) != 0 )
+  {
+    ::close( errorPipe[0] );
+    ::close( errorPipe[1] );
+    throw std::runtime_error( "Can not create the pipes of the death test." );
+  }
+
+  // Output buffered before the fork would be written by the child too.
+  fflush( NULL );
+
+  pid_t childId = ::fork();
+  if ( childId < 0 )
+  {
+    ::close( errorPipe[0] );
+    ::close( errorPipe[1] );
+    ::close( outcomePipe[0] );
+    ::close( outcomePipe[1] );
+    throw std::runtime_error( "Can not fork the process of the death test." );
+  }
+
+  if ( childId == 0 )
+  {
+    ::close( errorPipe[0] );
+    ::close( outcomePipe[0] );
+    ::dup2( errorPipe[1], 2 );
+    ::close( errorPipe[1] );
+    m_outcomeDescriptor = outcomePipe[1];
+    m_isChild = true;
+    return true;
+  }
+
+  ::close( errorPipe[1] );
+  ::close( outcomePipe[1] );
+  m_childId = childId;
+  m_errorDescriptor = errorPipe[0];
+  m_outcomeDescriptor = outcomePipe[0];
+  return false;
+#else
+  throw std::runtime_error( "Death tests require fork()." );
+#endif
+}
+
+
+AssertionTrap &
+DeathTest::childTrap()
+{
+  // Never deleted: the child ends with _exit().
+  if ( m_childTrap == NULL )
+    m_childTrap = new AssertionTrap();
+  return *m_childTrap;
+}
+
+
+void
+DeathTest::exitChild( Outcome outcome )
+{
+#if defined(CPPUNIT_DEATHTEST_USE_FORK)
+  char outcomeCode = char(outcome);
+  ::_exit( ::write( m_outcomeDescriptor, &outcomeCode, 1 ) == 1 ? 0 : 1 );
+#endif
+}
+
+
+#if defined(CPPUNIT_DEATHTEST_USE_FORK)
+/*! \brief Waits until a pipe of the child can be read without blocking.
+ * \return \c false if \a deadline passed first. Always \c true if
+ *         \a timeout is 0 or on platforms without poll().
+ */
+static bool
+waitForDeathTestInput( int descriptor,
+                       double timeout,
+                       double deadline )
+{
+#if defined(CPPUNIT_DEATHTEST_USE_POLL)
+  if ( timeout <= 0 )
+    return true;
+
+  while ( true )
+  {
+    double remaining = deadline - Clock::now();
+    if ( remaining <= 0 )
+      return false;
+
+    struct pollfd pollDescriptor;
+    pollDescriptor.fd = descriptor;
+    pollDescriptor.events = POLLIN;
+    pollDescriptor.revents = 0;
+    int readyCount = ::poll( &pollDescriptor, 1, int(remaining * 1000) +1 );
+    if ( readyCount != 0  &&  !( readyCount < 0  &&  errno == EINTR ) )
+      return true;
+  }
+#else
+  return true;
+#endif
+}
+#endif
+
+
+void
+DeathTest::wait()
+{
+#if defined(CPPUNIT_DEATHTEST_USE_FORK)
+  if ( m_childId <= 0  ||  m_outcome != running )
+    return;
+
+  // Reads until the child ends, so that it never blocks on a full pipe.
+  double deadline = Clock::now() + m_timeout;
+  bool isTimedOut = false;
+  char buffer[ 4096 ];
+  while ( true )
+  {
+    if ( !waitForDeathTestInput( m_errorDescriptor, m_timeout, deadline ) )
+    {
+      isTimedOut = true;
+      break;
+    }
+    ssize_t count = ::read( m_errorDescriptor, buffer, sizeof(buffer) );
+    if ( count > 0 )
+      m_errorOutput.append( buffer, count );
+    else if ( count == 0  ||  errno != EINTR )
+      break;
+  }
+
+  // A child that closed its standard error may still run.
+  if ( !isTimedOut  &&
+       !waitForDeathTestInput( m_outcomeDescriptor, m_timeout, deadline ) )
+    isTimedOut = true;
+
+  // The processes the child forked may keep the pipes open after it is killed.
+  char outcomeCode = 0;
+  ssize_t outcomeCount = 0;
+  if ( isTimedOut )
+    ::kill( m_childId, SIGKILL );
+  else
+  {
+    do
+      outcomeCount = ::read( m_outcomeDescriptor, &outcomeCode, 1 );
+    while ( outcomeCount < 0  &&  errno == EINTR );
+  }
+
+  ::close( m_errorDescriptor );
+  ::close( m_outcomeDescriptor );
+  m_errorDescriptor = -1;
+  m_outcomeDescriptor = -1;
+
+  while ( ::waitpid( m_childId, &m_status, 0 ) < 0  &&  errno == EINTR )
+    ;
+
+  if ( isTimedOut )
+    m_outcome = timedOut;
+  else if ( outcomeCount == 1 )
+    m_outcome = Outcome( outcomeCode );
+  else if ( WIFSIGNALED( m_status ) )
+    m_outcome = signaled;
+  else
+    m_outcome = exited;
+#endif
+}
+
+
+DeathTest::Outcome
+DeathTest::outcome() const
+{
+  return m_outcome;
+}
+
+
+bool
+DeathTest::died() const
+{
+  return m_outcome == signaled  ||
+         ( m_outcome == exited  &&  exitCode() != 0 );
+}
+
+
+int
+DeathTest::exitCode() const
+{
+#if defined(CPPUNIT_DEATHTEST_USE_FORK)
+  if ( m_outcome == exited  &&  WIFEXITED( m_status ) )
+    return WEXITSTATUS( m_status );
+#endif
+  return 0;
+}
+
+
+int
+DeathTest::signalNumber() const
+{
+#if defined(CPPUNIT_DEATHTEST_USE_FORK)
+  if ( m_outcome == signaled )
+    return WTERMSIG( m_status );
+#endif
+  return 0;
+}
+
+
+const std::string &
+DeathTest::errorOutput() const
+{
+  return m_errorOutput;
+}
+
+
+std::string
+DeathTest::describeOutcome() const
+{
+  char description[ 64 ];
+  switch ( m_outcome )
+  {
+  case returned:
+    return "the statement returned";
+  case threw:
+    return "the statement threw an exception or failed an assertion";
+  case exited:
+    sprintf( description, "exited with code %d", exitCode() );
+    return description;
+  case signaled:
+    sprintf( description, "killed by signal %d", signalNumber() );
+    return description;
+  case timedOut:
+    sprintf( description, "timed out after %g seconds", m_timeout );
+    return description;
+  default:
+    return "running";
+  }
+}
+
+
+bool
+DeathTest::matches( const std::string &text,
+                    const std::string &pattern )
+{
+  if ( pattern.empty() )
+    return true;
+
+#if defined(CPPUNIT_HAVE_REGEX_H)
+  regex_t expression;
+  if ( regcomp( &expression, pattern.c_str(), REG_EXTENDED | REG_NOSUB ) != 0 )
+    throw std::invalid_argument( "Invalid regular expression: " + pattern );
+  bool found = regexec( &expression, text.c_str(), 0, NULL, 0 ) == 0;
+  regfree( &expression );
+  return found;
+#else
+  return text.find( pattern ) != std::string::npos;
+#endif
+}
+
+
+/// Returns the standard error of the child, shortened for a failure message.
+static std::string 
+deathTestErrorDetail( const DeathTest &deathTest )
+{
+  std::string output = deathTest.errorOutput();
+  if ( output.length() > deathTestMaximumErrorLength )
+    output = output.substr( 0, deathTestMaximumErrorLength ) + "...";
+  return "Standard error: " + output;
+}
+
+
+/// Checks the standard error of a child that ended as expected.
+static void
+checkDeathTestOutput( DeathTest &deathTest,
+                      Message &failure,
+                      const std::string &pattern,
+                      SourceLine sourceLine,
+                      const std::string &message )
+{
+  if ( DeathTest::matches( deathTest.errorOutput(), pattern ) )
+    return;
+
+  failure.addDetail( "Actual  : " + deathTest.describeOutcome() +
+                     ", the standard error does not match" );
+  failure.addDetail( deathTestErrorDetail( deathTest ) );
+  if ( !message.empty() )
+    failure.addDetail( message );
+  Asserter::fail( failure, sourceLine );
+}
+
+
+/// Fails for a child that did not end as expected.
+static void
+failDeathTestOutcome( DeathTest &deathTest,
+                      Message &failure,
+                      SourceLine sourceLine,
+                      const std::string &message )
+{
+  failure.addDetail( "Actual  : " + deathTest.describeOutcome() );
+  if ( !deathTest.errorOutput().empty() )
+    failure.addDetail( deathTestErrorDetail( deathTest ) );
+  if ( !message.empty() )
+    failure.addDetail( message );
+  Asserter::fail( failure, sourceLine );
+}
+
+
+void
+assertDeath( DeathTest &deathTest,
+             const std::string &statement,
+             const std::string &pattern,
+             SourceLine sourceLine,
+             const std::string &message )
+{
+  deathTest.wait();
+  Message failure( "death assertion failed",
+                   "Statement: " + statement,
+                   "Expected: dies, with a standard error matching <" +
+                     pattern + ">" );
+  if ( !deathTest.died() )
+    failDeathTestOutcome( deathTest, failure, sourceLine, message );
+  checkDeathTestOutput( deathTest, failure, pattern, sourceLine, message );
+}
+
+
+void
+assertExit( DeathTest &deathTest,
+            const std::string &statement,
+            int exitCode,
+            const std::string &pattern,
+            SourceLine sourceLine,
+            const std::string &message )
+{
+  deathTest.wait();
+  char expected[ 64 ];
+  sprintf( expected, "Expected: exits with code %d", exitCode );
+  Message failure( "exit assertion failed",
+                   "Statement: " + statement,
+                   std::string( expected ) +
+                     ", with a standard error matching <" + pattern + ">" );
+  if ( deathTest.outcome() != DeathTest::exited  ||
+       deathTest.exitCode() != exitCode )
+    failDeathTestOutcome( deathTest, failure, sourceLine, message );
+  checkDeathTestOutput( deathTest, failure, pattern, sourceLine, message );
+}
+
+
+CPPUNIT_NS_END
@@ -1,3 +1,4 @@
+#include <cppunit/AssertionTrap.h>
 #include <cppunit/Exception.h>
 #include <cppunit/extensions/TypeInfoHelper.h>
 #include "DefaultProtector.h"
@@ -10,6 +11,20 @@ bool
 DefaultProtector::protect( const Functor &functor,
                            const ProtectorContext &context )
 {
+#if defined(CPPUNIT_NO_EXCEPTIONS)
+  // A failed assertion jumps back here: nothing is thrown.
+  Exception *failure = NULL;
+  {
+    AssertionTrap trap;
+    if ( setjmp( trap.jumpBuffer() ) == 0 )
+      return functor();
+    failure = trap.failure()->clone();
+  }
+
+  // A listener failing an assertion jumps to the enclosing trap, not here.
+  reportFailure( context, *failure );
+  delete failure;
+#else
   try
   {
     return functor();
@@ -34,6 +49,7 @@ DefaultProtector::protect( const Functor &functor,
     reportError( context,
                  Message( "uncaught exception of unknown type") );
   }
+#endif
   
   return false;
 }
@@ -13,6 +13,9 @@ CPPUNIT_NS_BEGIN
  * - Exception
  * - std::exception
  * - ...
+ *
+ * If CPPUNIT_NO_EXCEPTIONS is defined, it catches nothing: it sets an
+ * AssertionTrap and generates a failure for the assertion that jumped to it.
  */
 class DefaultProtector : public Protector
 {
@@ -0,0 +1,202 @@
+#include <cppunit/Asserter.h>
+#include <cppunit/extensions/DifferentialTest.h>
+#include <cppunit/portability/Stream.h>
+#include <cppunit/tools/StringTools.h>
+#include <cppunit/tools/ThreadGroup.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Runs the cases of a batch, and keeps the first mismatch of each thread.
+class DifferentialBatchTask : public ThreadTask
+{
+public:
+  DifferentialBatchTask( const DifferentialTestBase &test,
+                         int firstCase,
+                         int endCase,
+                         int threadCount )
+      : m_test( test )
+      , m_firstCase( firstCase )
+      , m_endCase( endCase )
+      , m_threadCount( threadCount )
+      , m_mismatchCases( threadCount, -1 )
+      , m_mismatchCandidates( threadCount, -1 )
+  {
+  }
+
+  void run( int threadIndex )
+  {
+    for ( int caseIndex = m_firstCase + threadIndex; 
+          caseIndex < m_endCase; 
+          caseIndex += m_threadCount )
+    {
+      int candidateIndex = m_test.findMismatch( 
+          Random::mix( m_test.seed(), caseIndex ) );
+      if ( candidateIndex >= 0 )
+      {
+        m_mismatchCases[ threadIndex ] = caseIndex;
+        m_mismatchCandidates[ threadIndex ] = candidateIndex;
+        return;
+      }
+    }
+  }
+
+  /*! Returns the index of the thread that found the mismatch of smallest case
+   *  index, -1 if there is none.
+   */
+  int firstMismatchThread() const
+  {
+    int firstThread = -1;
+    for ( int threadIndex =0; threadIndex < m_threadCount; ++threadIndex )
+    {
+      if ( m_mismatchCases[ threadIndex ] < 0 )
+        continue;
+      if ( firstThread < 0  ||  
+           m_mismatchCases[ threadIndex ] < m_mismatchCases[ firstThread ] )
+        firstThread = threadIndex;
+    }
+    return firstThread;
+  }
+
+  int mismatchCase( int threadIndex ) const
+  {
+    return m_mismatchCases[ threadIndex ];
+  }
+
+  int mismatchCandidate( int threadIndex ) const
+  {
+    return m_mismatchCandidates[ threadIndex ];
+  }
+
+private:
+  const DifferentialTestBase &m_test;
+  int m_firstCase;
+  int m_endCase;
+  int m_threadCount;
+  CppUnitVector<int> m_mismatchCases;
+  CppUnitVector<int> m_mismatchCandidates;
+};
+
+
+
+DifferentialTestBase::DifferentialTestBase()
+    : m_caseCount( 1000 )
+    , m_threadCount( ThreadGroup::processorCount() )
+    , m_batchSize( 256 )
+    , m_seed( Random::defaultSeed() )
+    , m_tolerance( 0 )
+{
+}
+
+
+DifferentialTestBase::~DifferentialTestBase()
+{
+}
+
+
+void 
+DifferentialTestBase::setCaseCount( int caseCount )
+{
+  m_caseCount = caseCount;
+}
+
+
+int 
+DifferentialTestBase::caseCount() const
+{
+  return m_caseCount;
+}
+
+
+void 
+DifferentialTestBase::setThreadCount( int threadCount )
+{
+  m_threadCount = threadCount > 0 ? threadCount : 1;
+}
+
+
+int 
+DifferentialTestBase::threadCount() const
+{
+  return m_threadCount;
+}
+
+
+void 
+DifferentialTestBase::setBatchSize( int batchSize )
+{
+  m_batchSize = batchSize > 0 ? batchSize : 1;
+}
+
+
+int 
+DifferentialTestBase::batchSize() const
+{
+  return m_batchSize;
+}
+
+
+void 
+DifferentialTestBase::setSeed( unsigned int seed )
+{
+  m_seed = seed;
+}
+
+
+unsigned int 
+DifferentialTestBase::seed() const
+{
+  return m_seed;
+}
+
+
+void 
+DifferentialTestBase::setTolerance( double tolerance )
+{
+  m_tolerance = tolerance;
+}
+
+
+double 
+DifferentialTestBase::tolerance() const
+{
+  return m_tolerance;
+}
+
+
+void 
+DifferentialTestBase::check( const SourceLine &sourceLine )
+{
+  for ( int firstCase =0; firstCase < m_caseCount; firstCase += m_batchSize )
+  {
+    int endCase = firstCase + m_batchSize;
+    if ( endCase > m_caseCount )
+      endCase = m_caseCount;
+    int threadCount = endCase - firstCase < m_threadCount ? endCase - firstCase
+                                                          : m_threadCount;
+
+    DifferentialBatchTask task( *this, firstCase, endCase, threadCount );
+    ThreadGroup::run( task, threadCount );
+
+    int mismatchThread = task.firstMismatchThread();
+    if ( mismatchThread < 0 )
+      continue;
+
+    int caseIndex = task.mismatchCase( mismatchThread );
+    int candidateIndex = task.mismatchCandidate( mismatchThread );
+    Message message( "differential test failed",
+                     "Candidate <" + candidateName( candidateIndex ) + 
+                     "> differs from the reference" );
+    describeMismatch( Random::mix( m_seed, caseIndex ), candidateIndex, message );
+    OStringStream seed;
+    seed << m_seed;
+    message.addDetail( "Seed: " + seed.str() + ", case " + 
+                       StringTools::toString( caseIndex ) + 
+                       " (replay with CPPUNIT_SEED=" + seed.str() + ")" );
+    Asserter::fail( message, sourceLine );
+  }
+}
+
+
+CPPUNIT_NS_END
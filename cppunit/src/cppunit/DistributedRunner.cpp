@@ -0,0 +1,1022 @@
+#include <cppunit/Exception.h>
+#include <cppunit/Message.h>
+#include <cppunit/SourceLine.h>
+#include <cppunit/TestFailure.h>
+#include <cppunit/TestLeaf.h>
+#include <cppunit/TestListener.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/extensions/DistributedRunner.h>
+#include <cppunit/tools/Clock.h>
+#include <cppunit/tools/StringTools.h>
+#include <stdexcept>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(CPPUNIT_HAVE_SYS_SOCKET_H)  &&  defined(CPPUNIT_HAVE_NETINET_IN_H)  &&  \
+    defined(CPPUNIT_HAVE_NETDB_H)  &&  defined(CPPUNIT_HAVE_POLL_H)  &&  \
+    defined(CPPUNIT_HAVE_UNISTD_H)  &&  defined(CPPUNIT_HAVE_POLL)  &&  \
+    defined(CPPUNIT_HAVE_GETADDRINFO)
+#define CPPUNIT_DISTRIBUTEDRUNNER_USE_SOCKETS 1
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#if defined(CPPUNIT_HAVE_NETINET_TCP_H)
+#include <netinet/tcp.h>
+#endif
+#endif
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Version sent by the workers in their hello record.
+static const int distributedProtocolVersion = 1;
+/// Time the coordinator waits for a record before checking the timeouts.
+static const int distributedPollMilliseconds = 100;
+/// Time a worker tries to connect to the coordinator.
+static const double distributedConnectSeconds = 10;
+
+
+/// Joins the fields of a record with tabs, escaping them.
+static std::string
+encodeDistributedRecord( const CppUnitVector<std::string> &fields )
+{
+  std::string line;
+  for ( unsigned int fieldIndex =0; fieldIndex < fields.size(); ++fieldIndex )
+  {
+    if ( fieldIndex > 0 )
+      line += '\t';
+    const std::string &field = fields[ fieldIndex ];
+    for ( unsigned int index =0; index < field.length(); ++index )
+    {
+      char c = field[ index ];
+      if ( c == '\\' )
+        line += "\\\\";
+      else if ( c == '\t' )
+        line += "\\t";
+      else if ( c == '\n' )
+        line += "\\n";
+      else if ( c == '\r' )
+        line += "\\r";
+      else
+        line += c;
+    }
+  }
+  return line;
+}
+
+
+/// Splits a line into the fields of a record.
+static CppUnitVector<std::string>
+decodeDistributedRecord( const std::string &line )
+{
+  CppUnitVector<std::string> fields;
+  std::string field;
+  for ( unsigned int index =0; index < line.length(); ++index )
+  {
+    char c = line[ index ];
+    if ( c == '\t' )
+    {
+      fields.push_back( field );
+      field = "";
+    }
+    else if ( c == '\\'  &&  index +1 < line.length() )
+    {
+      char escaped = line[ ++index ];
+      if ( escaped == 't' )
+        field += '\t';
+      else if ( escaped == 'n' )
+        field += '\n';
+      else if ( escaped == 'r' )
+        field += '\r';
+      else
+        field += escaped;
+    }
+    else
+      field += c;
+  }
+  fields.push_back( field );
+  return fields;
+}
+
+
+/*! Adds the tests assigned to the workers for \a test to \a tests, in
+ *  enumeration order: its test cases, and the tests whose child tests can
+ *  not run separately.
+ */
+static void
+collectDistributedTestCases( Test *test,
+                             CppUnitVector<Test *> &tests )
+{
+  int childCount = test->getChildTestCount();
+  if ( childCount == 0  ||  !test->canRunChildTestsSeparately() )
+  {
+    tests.push_back( test );
+    return;
+  }
+
+  for ( int childIndex =0; childIndex < childCount; ++childIndex )
+    collectDistributedTestCases( test->getChildTestAt( childIndex ), tests );
+}
+
+
+/// Adds all the test cases of \a test to \a testCases, in enumeration order.
+static void
+collectDistributedLeaves( Test *test,
+                          CppUnitVector<Test *> &testCases )
+{
+  int childCount = test->getChildTestCount();
+  if ( childCount == 0 )
+    testCases.push_back( test );
+  for ( int childIndex =0; childIndex < childCount; ++childIndex )
+    collectDistributedLeaves( test->getChildTestAt( childIndex ), testCases );
+}
+
+
+#if defined(CPPUNIT_DISTRIBUTEDRUNNER_USE_SOCKETS)
+/// Sends small records without delay, and without SIGPIPE where possible.
+static void
+configureDistributedSocket( int socket )
+{
+#if defined(TCP_NODELAY)
+  int noDelay = 1;
+  ::setsockopt( socket, IPPROTO_TCP, TCP_NODELAY, (char *)&noDelay, sizeof(noDelay) );
+#endif
+#if defined(SO_NOSIGPIPE)
+  int noSigPipe = 1;
+  ::setsockopt( socket, SOL_SOCKET, SO_NOSIGPIPE, (char *)&noSigPipe, sizeof(noSigPipe) );
+#endif
+}
+
+
+/// Returns a socket connected to the coordinator, -1 on failure.
+static int
+connectDistributedSocket( const std::string &host,
+                          int port )
+{
+  struct addrinfo hints;
+  memset( &hints, 0, sizeof(hints) );
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  struct addrinfo *addresses = NULL;
+  if ( ::getaddrinfo( host.c_str(), StringTools::toString( port ).c_str(),
+                      &hints, &addresses ) != 0 )
+    return -1;
+
+  int connected = -1;
+  for ( struct addrinfo *address = addresses;
+        address != NULL  &&  connected < 0;
+        address = address->ai_next )
+  {
+    int candidate = ::socket( address->ai_family, address->ai_socktype,
+                              address->ai_protocol );
+    if ( candidate < 0 )
+      continue;
+    if ( ::connect( candidate, address->ai_addr, address->ai_addrlen ) == 0 )
+      connected = candidate;
+    else
+      ::close( candidate );
+  }
+  ::freeaddrinfo( addresses );
+
+  if ( connected >= 0 )
+    configureDistributedSocket( connected );
+  return connected;
+}
+#endif
+
+
+/// Connection between the coordinator and a worker, exchanging records.
+class DistributedConnection
+{
+public:
+  DistributedConnection( int socket )
+      : m_socket( socket )
+  {
+  }
+
+  ~DistributedConnection()
+  {
+    close();
+  }
+
+  int socket() const
+  {
+    return m_socket;
+  }
+
+  void close()
+  {
+#if defined(CPPUNIT_DISTRIBUTEDRUNNER_USE_SOCKETS)
+    if ( m_socket >= 0 )
+      ::close( m_socket );
+#endif
+    m_socket = -1;
+  }
+
+  /// Sends a record. Returns \c false if the connection is closed.
+  bool send( const CppUnitVector<std::string> &fields )
+  {
+#if defined(CPPUNIT_DISTRIBUTEDRUNNER_USE_SOCKETS)
+#if defined(MSG_NOSIGNAL)
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+    std::string line = encodeDistributedRecord( fields ) + "\n";
+    size_t sentCount = 0;
+    while ( m_socket >= 0  &&  sentCount < line.length() )
+    {
+      ssize_t count = ::send( m_socket, line.data() + sentCount,
+                              line.length() - sentCount, flags );
+      if ( count < 0  &&  errno == EINTR )
+        continue;
+      if ( count <= 0 )
+        close();
+      else
+        sentCount += count;
+    }
+    return m_socket >= 0;
+#else
+    return false;
+#endif
+  }
+
+  /*! Reads the bytes available on the connection.
+   * Returns \c false if the connection is closed. Records already received
+   * can still be read with nextRecord().
+   */
+  bool receive()
+  {
+#if defined(CPPUNIT_DISTRIBUTEDRUNNER_USE_SOCKETS)
+    if ( m_socket < 0 )
+      return false;
+    char buffer[ 4096 ];
+    ssize_t count;
+    do
+      count = ::recv( m_socket, buffer, sizeof(buffer), 0 );
+    while ( count < 0  &&  errno == EINTR );
+    if ( count <= 0 )
+    {
+      close();
+      return false;
+    }
+    m_input.append( buffer, count );
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /// Extracts the next received record. Returns \c false if there is none.
+  bool nextRecord( CppUnitVector<std::string> &fields )
+  {
+    std::string::size_type end = m_input.find( '\n' );
+    if ( end == std::string::npos )
+      return false;
+    fields = decodeDistributedRecord( m_input.substr( 0, end ) );
+    m_input.erase( 0, end +1 );
+    return true;
+  }
+
+  /// Waits for the next record. Returns \c false if the connection closed.
+  bool readRecord( CppUnitVector<std::string> &fields )
+  {
+    while ( !nextRecord( fields ) )
+    {
+      if ( !receive() )
+        return false;
+    }
+    return true;
+  }
+
+private:
+  int m_socket;
+  std::string m_input;
+};
+
+
+/// Test run by TestResult::runTest() to serve the tests of a coordinator.
+class DistributedCoordinatorRun : public TestLeaf
+{
+public:
+  DistributedCoordinatorRun( DistributedCoordinator &coordinator )
+      : m_coordinator( coordinator )
+  {
+  }
+
+  int countTestCases() const
+  {
+    return m_coordinator.testCount();
+  }
+
+  void run( TestResult *result )
+  {
+    m_coordinator.serve( *result );
+  }
+
+  std::string getName() const
+  {
+    return "DistributedCoordinator";
+  }
+
+private:
+  DistributedCoordinator &m_coordinator;
+};
+
+
+/// Test run by TestResult::runTest() to run the tests assigned to a worker.
+class DistributedWorkerRun : public TestLeaf
+{
+public:
+  DistributedWorkerRun( DistributedWorker &worker,
+                        DistributedConnection &connection )
+      : m_worker( worker )
+      , m_connection( connection )
+      , m_runCount( 0 )
+  {
+  }
+
+  void run( TestResult *result )
+  {
+    m_runCount = m_worker.serve( m_connection, *result, m_error );
+  }
+
+  std::string getName() const
+  {
+    return "DistributedWorker";
+  }
+
+  int runCount() const
+  {
+    return m_runCount;
+  }
+
+  const std::string &error() const
+  {
+    return m_error;
+  }
+
+private:
+  DistributedWorker &m_worker;
+  DistributedConnection &m_connection;
+  int m_runCount;
+  std::string m_error;
+};
+
+
+/// Sends the failures of the test a worker runs to the coordinator.
+class DistributedFailureSender : public TestListener
+{
+public:
+  DistributedFailureSender( DistributedConnection &connection )
+      : m_connection( connection )
+      , m_testIndex( -1 )
+  {
+  }
+
+  /// Sets the test the worker runs, \c NULL if it was not found.
+  void setTest( int testIndex,
+                Test *test )
+  {
+    m_testIndex = testIndex;
+    m_testCases.clear();
+    if ( test != NULL )
+      collectDistributedLeaves( test, m_testCases );
+  }
+
+  void startTest( Test *test )
+  {
+    CppUnitVector<std::string> fields;
+    fields.push_back( "start" );
+    fields.push_back( StringTools::toString( m_testIndex ) );
+    fields.push_back( StringTools::toString( testCaseIndex( test ) ) );
+    m_connection.send( fields );
+  }
+
+  void addFailure( const TestFailure &failure )
+  {
+    Exception *exception = failure.thrownException();
+    Message message = exception->message();
+    SourceLine sourceLine = exception->sourceLine();
+
+    CppUnitVector<std::string> fields;
+    fields.push_back( "failure" );
+    fields.push_back( StringTools::toString( m_testIndex ) );
+    fields.push_back( StringTools::toString( 
+        testCaseIndex( failure.failedTest() ) ) );
+    fields.push_back( failure.isError() ? "1" : "0" );
+    fields.push_back( sourceLine.fileName() );
+    fields.push_back( StringTools::toString( sourceLine.lineNumber() ) );
+    fields.push_back( message.shortDescription() );
+    for ( int index =0; index < message.detailCount(); ++index )
+      fields.push_back( message.detailAt( index ) );
+    m_connection.send( fields );
+  }
+
+private:
+  /// Returns the index of a test case of the test, -1 for another test.
+  int testCaseIndex( Test *test ) const
+  {
+    for ( unsigned int index =0; index < m_testCases.size(); ++index )
+    {
+      if ( m_testCases[ index ] == test )
+        return index;
+    }
+    return -1;
+  }
+
+private:
+  DistributedConnection &m_connection;
+  int m_testIndex;
+  CppUnitVector<Test *> m_testCases;
+};
+
+
+DistributedCoordinator::DistributedCoordinator( int port )
+    : m_listenSocket( -1 )
+    , m_port( port )
+    , m_testTimeout( 0 )
+    , m_maximumAttempts( 3 )
+    , m_workerWaitTimeout( 0 )
+    , m_launcher( NULL )
+    , m_doneCount( 0 )
+    , m_workerCount( 0 )
+    , m_reassignedCount( 0 )
+{
+#if defined(CPPUNIT_DISTRIBUTEDRUNNER_USE_SOCKETS)
+  m_listenSocket = ::socket( AF_INET, SOCK_STREAM, 0 );
+  if ( m_listenSocket < 0 )
+    throw std::runtime_error( "Can not create the socket of the coordinator." );
+
+  int reuseAddress = 1;
+  ::setsockopt( m_listenSocket, SOL_SOCKET, SO_REUSEADDR,
+                (char *)&reuseAddress, sizeof(reuseAddress) );
+
+  struct sockaddr_in address;
+  memset( &address, 0, sizeof(address) );
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl( INADDR_ANY );
+  address.sin_port = htons( port );
+  if ( ::bind( m_listenSocket, (struct sockaddr *)&address, sizeof(address) ) != 0  ||
+       ::listen( m_listenSocket, SOMAXCONN ) != 0 )
+  {
+    ::close( m_listenSocket );
+    throw std::runtime_error( "Can not listen for workers on port " +
+                              StringTools::toString( port ) + "." );
+  }
+
+  socklen_t length = sizeof(address);
+  if ( ::getsockname( m_listenSocket, (struct sockaddr *)&address, &length ) == 0 )
+    m_port = ntohs( address.sin_port );
+#else
+  throw std::runtime_error( "Distributed test runs require POSIX sockets." );
+#endif
+}
+
+
+DistributedCoordinator::~DistributedCoordinator()
+{
+  closeWorkers();
+#if defined(CPPUNIT_DISTRIBUTEDRUNNER_USE_SOCKETS)
+  if ( m_listenSocket >= 0 )
+    ::close( m_listenSocket );
+#endif
+}
+
+
+int
+DistributedCoordinator::port() const
+{
+  return m_port;
+}
+
+
+void
+DistributedCoordinator::setTestTimeout( double seconds )
+{
+  m_testTimeout = seconds;
+}
+
+
+void
+DistributedCoordinator::setMaximumAttempts( int attempts )
+{
+  m_maximumAttempts = attempts;
+}
+
+
+void
+DistributedCoordinator::setWorkerWaitTimeout( double seconds )
+{
+  m_workerWaitTimeout = seconds;
+}
+
+
+void
+DistributedCoordinator::setWorkerLauncher( DistributedWorkerLauncher *launcher )
+{
+  m_launcher = launcher;
+}
+
+
+void
+DistributedCoordinator::addTest( Test *test )
+{
+  collectDistributedTestCases( test, m_tests );
+  m_attempts.resize( m_tests.size(), 0 );
+}
+
+
+int
+DistributedCoordinator::testCount() const
+{
+  return m_tests.size();
+}
+
+
+void
+DistributedCoordinator::run( TestResult &controller )
+{
+  DistributedCoordinatorRun run( *this );
+  controller.runTest( &run );
+}
+
+
+int
+DistributedCoordinator::workerCount() const
+{
+  return m_workerCount;
+}
+
+
+int
+DistributedCoordinator::reassignedCount() const
+{
+  return m_reassignedCount;
+}
+
+
+void
+DistributedCoordinator::releaseSockets()
+{
+  for ( unsigned int index =0; index < m_workers.size(); ++index )
+  {
+    deleteEvents( m_workers[ index ].m_events );
+    delete m_workers[ index ].m_connection;
+  }
+  m_workers.clear();
+#if defined(CPPUNIT_DISTRIBUTEDRUNNER_USE_SOCKETS)
+  if ( m_listenSocket >= 0 )
+    ::close( m_listenSocket );
+#endif
+  m_listenSocket = -1;
+}
+
+
+void
+DistributedCoordinator::serve( TestResult &controller )
+{
+  m_queue.clear();
+  for ( int testIndex =0; testIndex < testCount(); ++testIndex )
+  {
+    m_queue.push_back( testIndex );
+    m_attempts[ testIndex ] = 0;
+  }
+  m_doneCount = 0;
+
+#if defined(CPPUNIT_DISTRIBUTEDRUNNER_USE_SOCKETS)
+  double lastWorkerTime = Clock::now();
+  while ( m_doneCount < testCount()  &&  !controller.shouldStop() )
+  {
+    CppUnitVector<struct pollfd> descriptors( m_workers.size() +1 );
+    descriptors[0].fd = m_listenSocket;
+    descriptors[0].events = POLLIN;
+    descriptors[0].revents = 0;
+    for ( unsigned int index =0; index < m_workers.size(); ++index )
+    {
+      descriptors[ index +1 ].fd = m_workers[ index ].m_connection->socket();
+      descriptors[ index +1 ].events = POLLIN;
+      descriptors[ index +1 ].revents = 0;
+    }
+    int readyCount = ::poll( &descriptors[0], descriptors.size(),
+                             distributedPollMilliseconds );
+    if ( readyCount < 0  &&  errno != EINTR )
+      throw std::runtime_error( "Can not wait for the records of the workers." );
+
+    // Backward, so that losing a worker does not move the ones left to read.
+    for ( int workerIndex = m_workers.size() -1; workerIndex >= 0; --workerIndex )
+    {
+      if ( readyCount > 0  &&  descriptors[ workerIndex +1 ].revents != 0  &&
+           !readWorker( m_workers[ workerIndex ], controller ) )
+        loseWorker( workerIndex, controller, "connection to the worker lost" );
+    }
+    if ( readyCount > 0  &&  descriptors[0].revents != 0 )
+      acceptWorker();
+
+    double now = Clock::now();
+    for ( int workerIndex = m_workers.size() -1; workerIndex >= 0; --workerIndex )
+    {
+      const Worker &worker = m_workers[ workerIndex ];
+      if ( m_testTimeout > 0  &&  worker.m_testIndex >= 0  &&
+           now - worker.m_assignTime > m_testTimeout )
+        loseWorker( workerIndex, controller, "test timed out on the worker" );
+    }
+
+    for ( unsigned int index =0; index < m_workers.size(); ++index )
+    {
+      Worker &worker = m_workers[ index ];
+      if ( worker.m_greeted  &&  worker.m_testIndex < 0  &&  !m_queue.empty() )
+        assignTest( worker );
+    }
+
+    if ( !m_workers.empty() )
+      lastWorkerTime = now;
+    else if ( m_workerWaitTimeout > 0  &&  now - lastWorkerTime > m_workerWaitTimeout )
+    {
+      while ( !m_queue.empty() )
+      {
+        reportError( m_queue.front(), "no worker connected", controller );
+        m_queue.pop_front();
+      }
+    }
+
+    if ( m_launcher != NULL  &&  m_doneCount < testCount() )
+      m_launcher->superviseWorkers();
+  }
+#endif
+
+  closeWorkers();
+}
+
+
+void
+DistributedCoordinator::acceptWorker()
+{
+#if defined(CPPUNIT_DISTRIBUTEDRUNNER_USE_SOCKETS)
+  int socket = ::accept( m_listenSocket, NULL, NULL );
+  if ( socket < 0 )
+    return;
+  configureDistributedSocket( socket );
+
+  Worker worker;
+  worker.m_connection = new DistributedConnection( socket );
+  worker.m_greeted = false;
+  worker.m_processId = 0;
+  worker.m_testIndex = -1;
+  worker.m_assignTime = 0;
+  m_workers.push_back( worker );
+#endif
+}
+
+
+bool
+DistributedCoordinator::readWorker( Worker &worker,
+                                    TestResult &controller )
+{
+  bool isOpen = worker.m_connection->receive();
+  CppUnitVector<std::string> fields;
+  while ( worker.m_connection->nextRecord( fields ) )
+  {
+    if ( !handleRecord( worker, fields, controller ) )
+      return false;
+  }
+  return isOpen;
+}
+
+
+bool
+DistributedCoordinator::handleRecord( Worker &worker,
+                                      const CppUnitVector<std::string> &fields,
+                                      TestResult &controller )
+{
+  const std::string &type = fields[0];
+  if ( type == "hello"  &&  fields.size() == 4  &&  !worker.m_greeted )
+  {
+    if ( atoi( fields[1].c_str() ) != distributedProtocolVersion  ||
+         atoi( fields[2].c_str() ) != testCount() )
+    {
+      CppUnitVector<std::string> quit;
+      quit.push_back( "quit" );
+      quit.push_back( "the worker does not have the tests of the coordinator (" +
+                      fields[2] + " tests instead of " +
+                      StringTools::toString( testCount() ) + ")" );
+      worker.m_connection->send( quit );
+      return false;
+    }
+    worker.m_greeted = true;
+    worker.m_processId = atoi( fields[3].c_str() );
+    ++m_workerCount;
+    return true;
+  }
+
+  if ( fields.size() < 2  ||  worker.m_testIndex < 0  ||
+       atoi( fields[1].c_str() ) != worker.m_testIndex )
+    return false;
+
+  if ( type == "start"  &&  fields.size() == 3 )
+  {
+    PendingEvent start;
+    start.m_testCaseIndex = atoi( fields[2].c_str() );
+    start.m_exception = NULL;
+    start.m_isError = false;
+    worker.m_events.push_back( start );
+    return true;
+  }
+
+  if ( type == "failure"  &&  fields.size() >= 7 )
+  {
+    Message message( fields[6] );
+    for ( unsigned int index =7; index < fields.size(); ++index )
+      message.addDetail( fields[ index ] );
+    SourceLine sourceLine;
+    if ( !fields[4].empty() )
+      sourceLine = SourceLine( fields[4], atoi( fields[5].c_str() ) );
+
+    PendingEvent failure;
+    failure.m_testCaseIndex = atoi( fields[2].c_str() );
+    failure.m_exception = new Exception( message, sourceLine );
+    failure.m_isError = fields[3] == "1";
+    worker.m_events.push_back( failure );
+    return true;
+  }
+
+  if ( type == "done" )
+  {
+    reportTest( worker.m_testIndex, worker.m_events, controller );
+    worker.m_testIndex = -1;
+    return true;
+  }
+
+  return false;
+}
+
+
+void
+DistributedCoordinator::assignTest( Worker &worker )
+{
+  int testIndex = m_queue.front();
+  m_queue.pop_front();
+  ++m_attempts[ testIndex ];
+  worker.m_testIndex = testIndex;
+  worker.m_assignTime = Clock::now();
+
+  CppUnitVector<std::string> fields;
+  fields.push_back( "run" );
+  fields.push_back( StringTools::toString( testIndex ) );
+  fields.push_back( m_tests[ testIndex ]->getName() );
+  // A failure shows up as a closed connection on the next poll.
+  worker.m_connection->send( fields );
+}
+
+
+void
+DistributedCoordinator::loseWorker( int workerIndex,
+                                    TestResult &controller,
+                                    const std::string &reason )
+{
+  Worker &worker = m_workers[ workerIndex ];
+  deleteEvents( worker.m_events );
+  int testIndex = worker.m_testIndex;
+  if ( testIndex >= 0 )
+  {
+    if ( m_attempts[ testIndex ] >= m_maximumAttempts )
+      reportError( testIndex,
+                   reason + " (" + StringTools::toString( m_attempts[ testIndex ] ) +
+                       " attempts)",
+                   controller );
+    else
+    {
+      m_queue.push_front( testIndex );
+      ++m_reassignedCount;
+    }
+  }
+
+  // A worker that timed out is told to stop.
+  CppUnitVector<std::string> quit;
+  quit.push_back( "quit" );
+  quit.push_back( reason );
+  worker.m_connection->send( quit );
+  delete worker.m_connection;
+  int processId = worker.m_processId;
+  m_workers.erase( m_workers.begin() + workerIndex );
+
+  if ( m_launcher != NULL )
+    m_launcher->workerLost( processId );
+}
+
+
+void
+DistributedCoordinator::reportTest( int testIndex,
+                                    CppUnitVector<PendingEvent> &events,
+                                    TestResult &controller )
+{
+  Test *test = m_tests[ testIndex ];
+  CppUnitVector<Test *> testCases;
+  collectDistributedLeaves( test, testCases );
+
+  // A failure of another test than the started one, such as the setUp() of
+  // a TestSetUp, is reported as a run of that test.
+  Test *startedTest = NULL;
+  for ( unsigned int index =0; index < events.size(); ++index )
+  {
+    const PendingEvent &event = events[ index ];
+    Test *eventTest = test;
+    if ( event.m_testCaseIndex >= 0  &&  
+         event.m_testCaseIndex < int(testCases.size()) )
+      eventTest = testCases[ event.m_testCaseIndex ];
+
+    if ( event.m_exception == NULL  ||  eventTest != startedTest )
+    {
+      if ( startedTest != NULL )
+        controller.endTest( startedTest );
+      startedTest = eventTest;
+      controller.startTest( startedTest );
+    }
+
+    if ( event.m_exception == NULL )
+      continue;
+    if ( event.m_isError )
+      controller.addError( startedTest, event.m_exception );
+    else
+      controller.addFailure( startedTest, event.m_exception );
+  }
+  events.clear();
+
+  if ( startedTest == NULL )
+  {
+    startedTest = test;
+    controller.startTest( startedTest );
+  }
+  controller.endTest( startedTest );
+  ++m_doneCount;
+}
+
+
+void
+DistributedCoordinator::reportError( int testIndex,
+                                     const std::string &reason,
+                                     TestResult &controller )
+{
+  CppUnitVector<PendingEvent> events;
+  PendingEvent failure;
+  failure.m_testCaseIndex = -1;
+  failure.m_exception = new Exception( Message( "test not run by a worker",
+                                                reason ) );
+  failure.m_isError = true;
+  events.push_back( failure );
+  reportTest( testIndex, events, controller );
+}
+
+
+void
+DistributedCoordinator::closeWorkers()
+{
+  CppUnitVector<std::string> quit;
+  quit.push_back( "quit" );
+  for ( unsigned int index =0; index < m_workers.size(); ++index )
+  {
+    Worker &worker = m_workers[ index ];
+    worker.m_connection->send( quit );
+    delete worker.m_connection;
+    deleteEvents( worker.m_events );
+  }
+  m_workers.clear();
+}
+
+
+void
+DistributedCoordinator::deleteEvents( CppUnitVector<PendingEvent> &events )
+{
+  for ( unsigned int index =0; index < events.size(); ++index )
+    delete events[ index ].m_exception;
+  events.clear();
+}
+
+
+
+DistributedWorker::DistributedWorker()
+{
+}
+
+
+DistributedWorker::~DistributedWorker()
+{
+}
+
+
+void
+DistributedWorker::addTest( Test *test )
+{
+  collectDistributedTestCases( test, m_tests );
+}
+
+
+int
+DistributedWorker::testCount() const
+{
+  return m_tests.size();
+}
+
+
+int
+DistributedWorker::run( const std::string &host,
+                        int port,
+                        TestResult &controller )
+{
+  std::string address = host + ":" + StringTools::toString( port );
+#if defined(CPPUNIT_DISTRIBUTEDRUNNER_USE_SOCKETS)
+  double deadline = Clock::now() + distributedConnectSeconds;
+  int socket = connectDistributedSocket( host, port );
+  while ( socket < 0  &&  Clock::now() < deadline )
+  {
+    Clock::sleepUntil( Clock::now() + 0.1 );
+    socket = connectDistributedSocket( host, port );
+  }
+  if ( socket < 0 )
+    throw std::runtime_error( "Can not connect to the coordinator <" + address + ">." );
+
+  DistributedConnection connection( socket );
+  DistributedWorkerRun run( *this, connection );
+  controller.runTest( &run );
+  if ( !run.error().empty() )
+    throw std::runtime_error( "Coordinator <" + address + ">: " + run.error() + "." );
+  return run.runCount();
+#else
+  throw std::runtime_error( "Distributed test runs require POSIX sockets: can not "
+                            "connect to <" + address + ">." );
+#endif
+}
+
+
+int
+DistributedWorker::serve( DistributedConnection &connection,
+                          TestResult &controller,
+                          std::string &error )
+{
+  CppUnitVector<std::string> hello;
+  hello.push_back( "hello" );
+  hello.push_back( StringTools::toString( distributedProtocolVersion ) );
+  hello.push_back( StringTools::toString( testCount() ) );
+#if defined(CPPUNIT_DISTRIBUTEDRUNNER_USE_SOCKETS)
+  hello.push_back( StringTools::toString( int(::getpid()) ) );
+#else
+  hello.push_back( "0" );
+#endif
+  connection.send( hello );
+
+  DistributedFailureSender sender( connection );
+  controller.addListener( &sender );
+  int runCount = 0;
+  error = "connection to the coordinator lost";
+  CppUnitVector<std::string> fields;
+  while ( connection.readRecord( fields ) )
+  {
+    if ( fields[0] == "quit" )
+    {
+      error = fields.size() > 1 ? fields[1] : "";
+      break;
+    }
+    if ( fields[0] != "run"  ||  fields.size() != 3 )
+    {
+      error = "unexpected record <" + fields[0] + ">";
+      break;
+    }
+
+    int testIndex = atoi( fields[1].c_str() );
+    if ( testIndex >= 0  &&  testIndex < testCount()  &&
+         m_tests[ testIndex ]->getName() == fields[2] )
+    {
+      sender.setTest( testIndex, m_tests[ testIndex ] );
+      m_tests[ testIndex ]->run( &controller );
+      ++runCount;
+    }
+    else
+    {
+      CppUnitVector<std::string> failure;
+      failure.push_back( "failure" );
+      failure.push_back( fields[1] );
+      failure.push_back( "-1" );
+      failure.push_back( "1" );
+      failure.push_back( "" );
+      failure.push_back( "-1" );
+      failure.push_back( "test not found by the worker" );
+      failure.push_back( "The worker does not have the test " + fields[2] +
+                         " at index " + fields[1] + "." );
+      connection.send( failure );
+    }
+
+    CppUnitVector<std::string> done;
+    done.push_back( "done" );
+    done.push_back( fields[1] );
+    connection.send( done );
+  }
+  controller.removeListener( &sender );
+  return runCount;
+}
+
+
+CPPUNIT_NS_END
@@ -123,4 +123,11 @@ Exception::clone() const
 }
 
 
+void
+Exception::throwCopy() const
+{
+  throw Exception( *this );
+}
+
+
 CPPUNIT_NS_END
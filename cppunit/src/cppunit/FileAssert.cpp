@@ -0,0 +1,430 @@
+#include <cppunit/Asserter.h>
+#include <cppunit/extensions/FileAssert.h>
+#include <cppunit/portability/CppUnitVector.h>
+#include <cppunit/portability/Stream.h>
+#include <limits.h>
+#include <stdexcept>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(CPPUNIT_HAVE_SYS_STAT_H)
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Offset, size or line number in a compared file, 64 bits wide when available.
+#if defined(ULLONG_MAX)
+typedef unsigned long long FileOffset;
+#else
+typedef unsigned long FileOffset;
+#endif
+
+
+/// Number of lines shown before the differing line.
+static const int fileContextLines = 2;
+
+/// Maximum number of characters shown for a line.
+static const size_t fileMaximumLineLength = 120;
+
+/// Number of bytes shown before and after the differing byte.
+static const size_t fileDumpRadius = 16;
+
+
+/// Sequential reader of the chunks of a file.
+class FileChunkReader
+{
+public:
+  FileChunkReader( const std::string &path,
+                   size_t chunkSize )
+      : m_path( path )
+      , m_file( fopen( path.c_str(), "rb" ) )
+      , m_offset( 0 )
+      , m_chunkSize( chunkSize )
+      , m_currentSize( 0 )
+      , m_previousSize( 0 )
+      , m_windowStartsLine( true )
+  {
+    if ( m_file == NULL )
+      throw std::runtime_error( "Can not open file <" + path + ">." );
+    // Reads directly into the chunks, without going through the stdio buffer.
+    setvbuf( m_file, NULL, _IONBF, 0 );
+    m_current.resize( chunkSize );
+    m_previous.resize( chunkSize );
+  }
+
+  ~FileChunkReader()
+  {
+    fclose( m_file );
+  }
+
+  /// Reads the next chunk. Returns its size, 0 at the end of the file.
+  size_t readChunk()
+  {
+    m_windowStartsLine = m_previousSize == 0  ||  
+                         m_previous[ m_previousSize -1 ] == '\n';
+    m_offset += m_currentSize;
+    m_current.swap( m_previous );
+    m_previousSize = m_currentSize;
+
+    m_currentSize = 0;
+    while ( m_currentSize < m_chunkSize )
+    {
+      size_t count = fread( &m_current[ m_currentSize ], 1, 
+                            m_chunkSize - m_currentSize, m_file );
+      if ( count == 0 )
+      {
+        if ( ferror( m_file ) )
+          throw std::runtime_error( "Can not read file <" + m_path + ">." );
+        break;
+      }
+      m_currentSize += count;
+    }
+    return m_currentSize;
+  }
+
+  const unsigned char *chunk() const
+  {
+    return &m_current[ 0 ];
+  }
+
+  /// Returns the offset of the current chunk in the file.
+  FileOffset offset() const
+  {
+    return m_offset;
+  }
+
+  /// Returns the previous and the current chunks.
+  std::string window() const
+  {
+    return std::string( (const char *)&m_previous[0], m_previousSize ) +
+           std::string( (const char *)&m_current[0], m_currentSize );
+  }
+
+  /// Returns the offset of window() in the file.
+  FileOffset windowOffset() const
+  {
+    return m_offset - m_previousSize;
+  }
+
+  /// Tests if window() starts at the beginning of a line.
+  bool windowStartsLine() const
+  {
+    return m_windowStartsLine;
+  }
+
+private:
+  /// Prevents the use of the copy constructor.
+  FileChunkReader( const FileChunkReader &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const FileChunkReader &other );
+
+private:
+  std::string m_path;
+  FILE *m_file;
+  FileOffset m_offset;
+  size_t m_chunkSize;
+  CppUnitVector<unsigned char> m_current;
+  size_t m_currentSize;
+  CppUnitVector<unsigned char> m_previous;
+  size_t m_previousSize;
+  bool m_windowStartsLine;
+};
+
+
+/// Gets the size of a file. Returns \c false if it is not available.
+static bool
+getComparedFileSize( const std::string &path,
+                     FileOffset &size )
+{
+#if defined(CPPUNIT_HAVE_SYS_STAT_H)
+  struct stat status;
+  if ( ::stat( path.c_str(), &status ) != 0 )
+    return false;
+  size = status.st_size;
+  return true;
+#else
+  return false;
+#endif
+}
+
+
+/// Returns the bytes of \a text as a quoted C string.
+static std::string
+quoteFileBytes( const std::string &text )
+{
+  static const char digits[] = "0123456789abcdef";
+  std::string quoted( "\"" );
+  for ( unsigned int index =0; index < text.length(); ++index )
+  {
+    unsigned char c = text[ index ];
+    if ( c == '\n' )
+      quoted += "\\n";
+    else if ( c == '\r' )
+      quoted += "\\r";
+    else if ( c == '\t' )
+      quoted += "\\t";
+    else if ( c == '"'  ||  c == '\\' )
+      quoted += std::string( "\\" ) + char(c);
+    else if ( c < 32  ||  c >= 127 )
+    {
+      quoted += "\\x";
+      quoted += digits[ c >> 4 ];
+      quoted += digits[ c & 15 ];
+    }
+    else
+      quoted += char(c);
+  }
+  return quoted + "\"";
+}
+
+
+/// Returns the line of \a window starting at \a start, truncated for display.
+static std::string
+getFileLine( const std::string &window,
+             std::string::size_type start )
+{
+  std::string::size_type end = window.find( '\n', start );
+  if ( end == std::string::npos )
+    end = window.length();
+  if ( end - start <= fileMaximumLineLength )
+    return window.substr( start, end - start );
+  return window.substr( start, fileMaximumLineLength ) + "...";
+}
+
+
+/// Adds the bytes around the first difference to \a failure.
+static void
+describeByteDifference( Message &failure,
+                        const FileChunkReader &expected,
+                        const FileChunkReader &actual,
+                        FileOffset offset )
+{
+  OStringStream position;
+  position << "First difference at byte " << offset;
+  failure.addDetail( position.str() );
+
+  std::string expectedWindow = expected.window();
+  std::string actualWindow = actual.window();
+  size_t index = offset - expected.windowOffset();
+  size_t start = index > fileDumpRadius ? index - fileDumpRadius : 0;
+  failure.addDetail( "Expected: " + 
+      quoteFileBytes( expectedWindow.substr( start, index - start + fileDumpRadius ) ) );
+  failure.addDetail( "Actual:   " + 
+      quoteFileBytes( actualWindow.substr( start, index - start + fileDumpRadius ) ) );
+}
+
+
+/// Adds the first differing line and the preceding lines to \a failure.
+static void
+describeLineDifference( Message &failure,
+                        const FileChunkReader &expected,
+                        const FileChunkReader &actual,
+                        FileOffset offset,
+                        FileOffset line,
+                        FileOffset lineStart )
+{
+  OStringStream position;
+  position << "First difference at line " << line << ", column " 
+           << (offset - lineStart +1) << " (byte " << offset << ")";
+  failure.addDetail( position.str() );
+
+  // Lines before the difference are the same in both files. Only the lines
+  // still in memory are shown.
+  std::string expectedWindow = expected.window();
+  std::string actualWindow = actual.window();
+  if ( lineStart < expected.windowOffset() )
+    lineStart = expected.windowOffset();
+  size_t start = lineStart - expected.windowOffset();
+
+  CppUnitVector<size_t> contextStarts;
+  size_t contextStart = start;
+  while ( int(contextStarts.size()) < fileContextLines  &&  contextStart > 0 )
+  {
+    std::string::size_type previousEnd = contextStart -1;
+    contextStart = previousEnd > 0 ? expectedWindow.rfind( '\n', previousEnd -1 ) 
+                                   : std::string::npos;
+    if ( contextStart == std::string::npos )
+    {
+      if ( !expected.windowStartsLine() )
+        break;
+      contextStart = 0;
+    }
+    else
+      ++contextStart;
+    contextStarts.insert( contextStarts.begin(), contextStart );
+  }
+
+  FileOffset contextLine = line - contextStarts.size();
+  for ( CppUnitVector<size_t>::const_iterator it = contextStarts.begin();
+        it != contextStarts.end();
+        ++it, ++contextLine )
+  {
+    OStringStream context;
+    context << "Line " << contextLine << ": " << getFileLine( expectedWindow, *it );
+    failure.addDetail( context.str() );
+  }
+
+  OStringStream expectedLine;
+  expectedLine << "Expected line " << line << ": " 
+               << getFileLine( expectedWindow, start );
+  failure.addDetail( expectedLine.str() );
+
+  OStringStream actualLine;
+  actualLine << "Actual   line " << line << ": " 
+             << getFileLine( actualWindow, start );
+  failure.addDetail( actualLine.str() );
+}
+
+
+
+FileComparator::FileComparator( size_t chunkSize )
+    : m_chunkSize( chunkSize > 0 ? chunkSize : 1 )
+{
+}
+
+
+FileComparator::~FileComparator()
+{
+}
+
+
+bool 
+FileComparator::compareBytes( const std::string &expectedPath,
+                              const std::string &actualPath,
+                              Message &failure ) const
+{
+  return compare( expectedPath, actualPath, false, failure );
+}
+
+
+bool 
+FileComparator::compareLines( const std::string &expectedPath,
+                              const std::string &actualPath,
+                              Message &failure ) const
+{
+  return compare( expectedPath, actualPath, true, failure );
+}
+
+
+bool 
+FileComparator::compare( const std::string &expectedPath,
+                         const std::string &actualPath,
+                         bool byLine,
+                         Message &failure ) const
+{
+  failure = Message( "files differ", 
+                     "Expected file: " + expectedPath,
+                     "Actual file: " + actualPath );
+
+  FileOffset expectedSize = 0;
+  FileOffset actualSize = 0;
+  if ( getComparedFileSize( expectedPath, expectedSize )  &&
+       getComparedFileSize( actualPath, actualSize )  &&
+       expectedSize != actualSize )
+  {
+    OStringStream sizes;
+    sizes << "Expected " << expectedSize << " bytes, actual " << actualSize 
+          << " bytes";
+    failure.addDetail( sizes.str() );
+    if ( !byLine )
+      return false;
+  }
+
+  try
+  {
+    FileChunkReader expected( expectedPath, m_chunkSize );
+    FileChunkReader actual( actualPath, m_chunkSize );
+    FileOffset line = 1;
+    FileOffset lineStart = 0;
+    while ( true )
+    {
+      size_t expectedChunkSize = expected.readChunk();
+      size_t actualChunkSize = actual.readChunk();
+      size_t commonSize = expectedChunkSize < actualChunkSize ? expectedChunkSize 
+                                                              : actualChunkSize;
+      const unsigned char *expectedChunk = expected.chunk();
+      const unsigned char *actualChunk = actual.chunk();
+
+      size_t index = commonSize;
+      if ( memcmp( expectedChunk, actualChunk, commonSize ) != 0 )
+      {
+        index = 0;
+        while ( expectedChunk[ index ] == actualChunk[ index ] )
+          ++index;
+      }
+
+      if ( byLine )
+      {
+        const unsigned char *current = expectedChunk;
+        const unsigned char *end = expectedChunk + index;
+        while ( (current = (const unsigned char *)memchr( current, '\n', 
+                                                          end - current )) != NULL )
+        {
+          ++line;
+          ++current;
+          lineStart = expected.offset() + (current - expectedChunk);
+        }
+      }
+
+      if ( index < commonSize  ||  expectedChunkSize != actualChunkSize )
+      {
+        FileOffset offset = expected.offset() + index;
+        if ( byLine )
+          describeLineDifference( failure, expected, actual, 
+                                  offset, line, lineStart );
+        else
+          describeByteDifference( failure, expected, actual, offset );
+        return false;
+      }
+
+      if ( expectedChunkSize == 0 )
+        return true;
+    }
+  }
+  catch ( std::runtime_error &e )
+  {
+    failure.addDetail( e.what() );
+    return false;
+  }
+}
+
+
+
+void 
+assertFilesEqual( const std::string &expectedPath,
+                  const std::string &actualPath,
+                  SourceLine sourceLine,
+                  const std::string &message )
+{
+  Message failure;
+  if ( FileComparator().compareBytes( expectedPath, actualPath, failure ) )
+    return;
+
+  if ( !message.empty() )
+    failure.addDetail( message );
+  Asserter::fail( failure, sourceLine );
+}
+
+
+void 
+assertFileLinesEqual( const std::string &expectedPath,
+                      const std::string &actualPath,
+                      SourceLine sourceLine,
+                      const std::string &message )
+{
+  Message failure;
+  if ( FileComparator().compareLines( expectedPath, actualPath, failure ) )
+    return;
+
+  if ( !message.empty() )
+    failure.addDetail( message );
+  Asserter::fail( failure, sourceLine );
+}
+
+
+CPPUNIT_NS_END
@@ -0,0 +1,746 @@
+#include <cppunit/Exception.h>
+#include <cppunit/Message.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/extensions/FuzzTest.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/portability/Stream.h>
+#include <cppunit/tools/MappedFile.h>
+#include <cppunit/tools/ThreadGroup.h>
+#include <algorithm>
+#include <stdexcept>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(CPPUNIT_HAVE_DIRENT_H)
+#include <dirent.h>
+#endif
+#if defined(CPPUNIT_HAVE_SYS_STAT_H)
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+#if defined(CPPUNIT_HAVE_MMAP)  &&  defined(CPPUNIT_HAVE_SYS_MMAN_H)  &&  \
+    defined(CPPUNIT_HAVE_FCNTL_H)  &&  defined(CPPUNIT_HAVE_UNISTD_H)
+#define CPPUNIT_FUZZTEST_USE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#if defined(CPPUNIT_HAVE_FORK)  &&  defined(CPPUNIT_HAVE_UNISTD_H)
+#define CPPUNIT_FUZZTEST_USE_PIDS 1
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Result of the replay of an input.
+struct FuzzInputResult
+{
+  FuzzInputResult()
+      : m_failed( false )
+      , m_isError( false )
+  {
+  }
+
+  bool m_failed;
+  bool m_isError;
+  Message m_message;
+  SourceLine m_sourceLine;
+};
+
+
+/*! Calls a step of the replay of an input, catching any exception.
+ * \return \c false if the step failed.
+ */
+static bool
+runFuzzStep( FuzzTarget &target,
+             int step,
+             const unsigned char *data,
+             size_t size,
+             FuzzInputResult &result )
+{
+  static const char *stepNames[] = { "setUp() failed", "", "tearDown() failed" };
+  try
+  {
+    if ( step == 0 )
+      target.setUp();
+    else if ( step == 1 )
+      target.run( data, size );
+    else
+      target.tearDown();
+    return true;
+  }
+  catch ( Exception &e )
+  {
+    result.m_message = e.message();
+    result.m_sourceLine = e.sourceLine();
+    result.m_isError = step != 1;
+  }
+  catch ( std::exception &e )
+  {
+    result.m_message = Message( "uncaught exception of type std::exception (or derived).",
+                                e.what() );
+    result.m_isError = true;
+  }
+  catch ( ... )
+  {
+    result.m_message = Message( "uncaught exception of unknown type" );
+    result.m_isError = true;
+  }
+
+  if ( *stepNames[ step ] != 0 )
+    result.m_message.addDetail( stepNames[ step ] );
+  result.m_failed = true;
+  return false;
+}
+
+
+/// Runs an input between setUp() and tearDown().
+static void
+runFuzzInput( FuzzTarget &target,
+              const unsigned char *data,
+              size_t size,
+              FuzzInputResult &result )
+{
+  if ( !runFuzzStep( target, 0, data, size, result ) )
+    return;
+  bool succeeded = runFuzzStep( target, 1, data, size, result );
+  if ( succeeded )
+    runFuzzStep( target, 2, data, size, result );
+  else
+  {
+    FuzzInputResult tearDownResult;
+    runFuzzStep( target, 2, data, size, tearDownResult );
+  }
+}
+
+
+/// Maps an input file and replays it.
+static void
+replayFuzzInput( FuzzTarget &target,
+                 const std::string &path,
+                 FuzzInputResult &result )
+{
+  try
+  {
+    MappedFile input( path );
+    runFuzzInput( target, input.data(), input.size(), result );
+  }
+  catch ( std::exception &e )
+  {
+    result.m_failed = true;
+    result.m_isError = true;
+    result.m_message = Message( "corpus input can not be read", e.what() );
+  }
+}
+
+
+/// Child test of a FuzzTest that replays one input when run alone.
+class FuzzInputTest : public TestCase
+{
+public:
+  FuzzInputTest( const std::string &name,
+                 const FuzzTest &fuzzTest,
+                 const std::string &path )
+      : TestCase( name )
+      , m_fuzzTest( fuzzTest )
+      , m_path( path )
+      , m_target( NULL )
+  {
+  }
+
+  ~FuzzInputTest()
+  {
+    delete m_target;
+  }
+
+  void setUp()
+  {
+    delete m_target;
+    m_target = m_fuzzTest.makeTarget();
+    m_target->setUp();
+  }
+
+  void runTest()
+  {
+    MappedFile input( m_path );
+    m_target->run( input.data(), input.size() );
+  }
+
+  void tearDown()
+  {
+    m_target->tearDown();
+    delete m_target;
+    m_target = NULL;
+  }
+
+private:
+  const FuzzTest &m_fuzzTest;
+  std::string m_path;
+  FuzzTarget *m_target;
+};
+
+
+/*! Replays the inputs of a corpus, each thread with its own target. Each
+ *  input is reported by the thread that replays it.
+ */
+class FuzzReplayTask : public ThreadTask
+{
+public:
+  FuzzReplayTask( const FuzzTest &fuzzTest,
+                  int threadCount,
+                  TestResult *controller )
+      : m_fuzzTest( fuzzTest )
+      , m_threadCount( threadCount )
+      , m_controller( controller )
+  {
+  }
+
+  void run( int threadIndex )
+  {
+    FuzzTarget *target = m_fuzzTest.makeTarget();
+    for ( int index = threadIndex; 
+          index < m_fuzzTest.getChildTestCount(); 
+          index += m_threadCount )
+    {
+      if ( m_controller->shouldStop() )
+        break;
+
+      Test *test = m_fuzzTest.getChildTestAt( index );
+      m_mutex.lock();
+      m_controller->startTest( test );
+      m_mutex.unlock();
+
+      FuzzInputResult result;
+      replayFuzzInput( *target, m_fuzzTest.getInputPathAt( index ), result );
+
+      m_mutex.lock();
+      report( test, result );
+      m_controller->endTest( test );
+      m_mutex.unlock();
+    }
+    delete target;
+  }
+
+private:
+  void report( Test *test,
+               const FuzzInputResult &result )
+  {
+    if ( !result.m_failed )
+      return;
+
+    Exception *exception = new Exception( result.m_message, result.m_sourceLine );
+    if ( result.m_isError )
+      m_controller->addError( test, exception );
+    else
+      m_controller->addFailure( test, exception );
+  }
+
+  const FuzzTest &m_fuzzTest;
+  int m_threadCount;
+  TestResult *m_controller;
+  /// Serializes the calls to the controller, which may not be synchronized.
+  ThreadMutex m_mutex;
+};
+
+
+
+/// Returns the list of the fuzz tests that currently exist.
+static CppUnitVector<FuzzTest *> &
+getFuzzTestList()
+{
+  static CppUnitVector<FuzzTest *> fuzzTests;
+  return fuzzTests;
+}
+
+
+FuzzTest::FuzzTest( const std::string &name,
+                    const std::string &corpusDirectory )
+    : TestComposite( name )
+    , m_corpusDirectory( corpusDirectory )
+    , m_threadCount( ThreadGroup::processorCount() )
+{
+  setProperty( "fuzz-corpus", corpusDirectory );
+  loadCorpus();
+  getFuzzTestList().push_back( this );
+}
+
+
+FuzzTest::~FuzzTest()
+{
+  CppUnitVector<FuzzTest *> &fuzzTests = getFuzzTestList();
+  fuzzTests.erase( std::remove( fuzzTests.begin(), fuzzTests.end(), this ), 
+                   fuzzTests.end() );
+  deleteInputTests();
+}
+
+
+std::string 
+FuzzTest::corpusDirectory() const
+{
+  return m_corpusDirectory;
+}
+
+
+void 
+FuzzTest::setThreadCount( int threadCount )
+{
+  m_threadCount = threadCount > 0 ? threadCount : 1;
+}
+
+
+int 
+FuzzTest::threadCount() const
+{
+  return m_threadCount;
+}
+
+
+void 
+FuzzTest::loadCorpus()
+{
+  deleteInputTests();
+  m_inputPaths.clear();
+  FuzzPendingInput::recover( *this );
+
+  CppUnitVector<std::string> fileNames;
+#if defined(CPPUNIT_HAVE_DIRENT_H)
+  DIR *directory = ::opendir( m_corpusDirectory.c_str() );
+  if ( directory != NULL )
+  {
+    struct dirent *entry;
+    while ( (entry = ::readdir( directory )) != NULL )
+    {
+      std::string fileName( entry->d_name );
+      if ( fileName.empty()  ||  fileName[0] == '.' )
+        continue;
+#if defined(CPPUNIT_HAVE_SYS_STAT_H)
+      struct stat status;
+      std::string path = m_corpusDirectory + "/" + fileName;
+      if ( ::stat( path.c_str(), &status ) != 0  ||  !S_ISREG( status.st_mode ) )
+        continue;
+#endif
+      fileNames.push_back( fileName );
+    }
+    ::closedir( directory );
+  }
+#endif
+
+  std::sort( fileNames.begin(), fileNames.end() );
+  for ( unsigned int index =0; index < fileNames.size(); ++index )
+  {
+    std::string path = m_corpusDirectory + "/" + fileNames[ index ];
+    m_inputPaths.push_back( path );
+    m_inputTests.push_back( new FuzzInputTest( getName() + "[" + fileNames[ index ] + "]",
+                                               *this,
+                                               path ) );
+  }
+}
+
+
+void 
+FuzzTest::deleteInputTests()
+{
+  for ( unsigned int index =0; index < m_inputTests.size(); ++index )
+    delete m_inputTests[ index ];
+  m_inputTests.clear();
+}
+
+
+int 
+FuzzTest::getChildTestCount() const
+{
+  return m_inputTests.size();
+}
+
+
+Test *
+FuzzTest::doGetChildTestAt( int index ) const
+{
+  return m_inputTests[ index ];
+}
+
+
+std::string 
+FuzzTest::getInputPathAt( int index ) const
+{
+  return m_inputPaths[ index ];
+}
+
+
+void 
+FuzzTest::doRunChildTests( TestResult *controller )
+{
+  int inputCount = getChildTestCount();
+  if ( inputCount == 0 )
+    return;
+
+  int threadCount = m_threadCount < inputCount ? m_threadCount : inputCount;
+  FuzzReplayTask task( *this, threadCount, controller );
+  ThreadGroup::run( task, threadCount );
+}
+
+
+std::string 
+FuzzTest::saveInput( const unsigned char *data, 
+                     size_t size ) const
+{
+  // FNV-1a hash of the content.
+  unsigned long hash = 2166136261UL;
+  for ( size_t index =0; index < size; ++index )
+    hash = ((hash ^ data[ index ]) * 16777619UL) & 0xffffffffUL;
+
+  OStringStream fileName;
+  fileName << "crash-" << std::hex;
+  fileName.width( 8 );
+  fileName.fill( '0' );
+  fileName << hash;
+  std::string path = m_corpusDirectory + "/" + fileName.str();
+
+#if defined(CPPUNIT_HAVE_SYS_STAT_H)
+  ::mkdir( m_corpusDirectory.c_str(), 0777 );
+#endif
+  FILE *file = fopen( path.c_str(), "wb" );
+  if ( file == NULL )
+    throw std::runtime_error( "Can not create file <" + path + ">." );
+  bool written = fwrite( data, 1, size, file ) == size;
+  if ( fclose( file ) != 0  ||  !written )
+    throw std::runtime_error( "Can not write file <" + path + ">." );
+  return path;
+}
+
+
+std::string 
+FuzzTest::defaultCorpusDirectory( const std::string &testName )
+{
+  const char *baseDirectory = getenv( "CPPUNIT_FUZZ_CORPUS" );
+  std::string directory( baseDirectory != NULL  &&  *baseDirectory != 0 
+                             ? baseDirectory 
+                             : "corpus" );
+
+  std::string name( testName );
+  std::string::size_type separatorIndex;
+  while ( (separatorIndex = name.find( "::" )) != std::string::npos )
+    name.replace( separatorIndex, 2, "." );
+  return directory + "/" + name;
+}
+
+
+const CppUnitVector<FuzzTest *> &
+FuzzTest::getFuzzTests()
+{
+  return getFuzzTestList();
+}
+
+
+
+/// Prefix of the names of the files of the pending inputs.
+static const char *fuzzPendingInputPrefix = ".pending-input";
+/// Initial capacity of the file of a pending input.
+static const size_t fuzzPendingInputCapacity = 4096;
+
+
+/*! Header of the file of a pending input, followed by the input: \c 1 if
+ *  the input is running, and the size of the input.
+ */
+struct FuzzPendingInputHeader
+{
+  unsigned long m_running;
+  unsigned long m_size;
+};
+
+
+FuzzPendingInput::FuzzPendingInput( const FuzzTest &fuzzTest )
+    : m_path( fuzzTest.corpusDirectory() + "/" + fuzzPendingInputPrefix )
+    , m_descriptor( -1 )
+    , m_mapping( NULL )
+    , m_capacity( 0 )
+{
+#if defined(CPPUNIT_FUZZTEST_USE_PIDS)
+  OStringStream suffix;
+  suffix << "-" << long( ::getpid() );
+  m_path += suffix.str();
+#endif
+#if defined(CPPUNIT_HAVE_SYS_STAT_H)
+  ::mkdir( fuzzTest.corpusDirectory().c_str(), 0777 );
+#endif
+
+#if defined(CPPUNIT_FUZZTEST_USE_MMAP)
+  m_descriptor = ::open( m_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0666 );
+  if ( m_descriptor < 0 )
+    throw std::runtime_error( "Can not create file <" + m_path + ">." );
+  resize( fuzzPendingInputCapacity );
+#else
+  FILE *file = fopen( m_path.c_str(), "wb" );
+  if ( file == NULL )
+    throw std::runtime_error( "Can not create file <" + m_path + ">." );
+  fclose( file );
+#endif
+}
+
+
+FuzzPendingInput::~FuzzPendingInput()
+{
+#if defined(CPPUNIT_FUZZTEST_USE_MMAP)
+  if ( m_mapping != NULL )
+    ::munmap( m_mapping, sizeof(FuzzPendingInputHeader) + m_capacity );
+  ::close( m_descriptor );
+#endif
+  remove( m_path.c_str() );
+}
+
+
+void 
+FuzzPendingInput::resize( size_t capacity )
+{
+#if defined(CPPUNIT_FUZZTEST_USE_MMAP)
+  if ( m_mapping != NULL )
+    ::munmap( m_mapping, sizeof(FuzzPendingInputHeader) + m_capacity );
+  m_mapping = NULL;
+  m_capacity = 0;
+
+  size_t fileSize = sizeof(FuzzPendingInputHeader) + capacity;
+  void *mapping = MAP_FAILED;
+  if ( ::ftruncate( m_descriptor, off_t(fileSize) ) == 0 )
+    mapping = ::mmap( NULL, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, 
+                      m_descriptor, 0 );
+  if ( mapping == MAP_FAILED )
+    throw std::runtime_error( "Can not map file <" + m_path + ">." );
+  m_mapping = mapping;
+  m_capacity = capacity;
+#else
+  (void)capacity;
+#endif
+}
+
+
+void 
+FuzzPendingInput::start( const unsigned char *data, 
+                         size_t size )
+{
+#if defined(CPPUNIT_FUZZTEST_USE_MMAP)
+  if ( size > m_capacity )
+    resize( size > 2 * m_capacity ? size : 2 * m_capacity );
+  FuzzPendingInputHeader *header = 
+      CPPUNIT_STATIC_CAST( FuzzPendingInputHeader *, m_mapping );
+  // Written by the process, the mapped pages outlive it if it crashes.
+  header->m_running = 0;
+  memcpy( header +1, data, size );
+  header->m_size = size;
+  header->m_running = 1;
+#else
+  FuzzPendingInputHeader header;
+  header.m_running = 1;
+  header.m_size = size;
+  FILE *file = fopen( m_path.c_str(), "wb" );
+  if ( file == NULL )
+    return;
+  fwrite( &header, sizeof(header), 1, file );
+  fwrite( data, 1, size, file );
+  fclose( file );
+#endif
+}
+
+
+void 
+FuzzPendingInput::finish()
+{
+#if defined(CPPUNIT_FUZZTEST_USE_MMAP)
+  CPPUNIT_STATIC_CAST( FuzzPendingInputHeader *, m_mapping )->m_running = 0;
+#else
+  FuzzPendingInputHeader header;
+  header.m_running = 0;
+  header.m_size = 0;
+  FILE *file = fopen( m_path.c_str(), "wb" );
+  if ( file == NULL )
+    return;
+  fwrite( &header, sizeof(header), 1, file );
+  fclose( file );
+#endif
+}
+
+
+std::string 
+FuzzPendingInput::path() const
+{
+  return m_path;
+}
+
+
+/*! Tests if the process that owns the pending input file \a fileName may
+ *  still be running it.
+ */
+static bool
+isFuzzPendingInputOwnerAlive( const std::string &fileName )
+{
+#if defined(CPPUNIT_FUZZTEST_USE_PIDS)
+  std::string prefix = std::string( fuzzPendingInputPrefix ) + "-";
+  long processId = atol( fileName.substr( prefix.length() ).c_str() );
+  if ( processId <= 0 )
+    return false;
+  if ( processId == long( ::getpid() ) )
+    return true;
+  return ::kill( pid_t(processId), 0 ) == 0  ||  errno == EPERM;
+#else
+  (void)fileName;
+  return false;
+#endif
+}
+
+
+int 
+FuzzPendingInput::recover( const FuzzTest &fuzzTest )
+{
+  int savedCount = 0;
+#if defined(CPPUNIT_HAVE_DIRENT_H)
+  std::string directoryName = fuzzTest.corpusDirectory();
+  DIR *directory = ::opendir( directoryName.c_str() );
+  if ( directory == NULL )
+    return 0;
+
+  CppUnitVector<std::string> fileNames;
+  std::string prefix( fuzzPendingInputPrefix );
+  struct dirent *entry;
+  while ( (entry = ::readdir( directory )) != NULL )
+  {
+    std::string fileName( entry->d_name );
+    if ( fileName.compare( 0, prefix.length(), prefix ) == 0  &&
+         !isFuzzPendingInputOwnerAlive( fileName ) )
+      fileNames.push_back( fileName );
+  }
+  ::closedir( directory );
+
+  for ( unsigned int index =0; index < fileNames.size(); ++index )
+  {
+    std::string path = directoryName + "/" + fileNames[ index ];
+    try
+    {
+      MappedFile file( path );
+      FuzzPendingInputHeader header;
+      if ( file.size() >= sizeof(header) )
+      {
+        memcpy( &header, file.data(), sizeof(header) );
+        if ( header.m_running != 0  &&  
+             header.m_size <= file.size() - sizeof(header) )
+        {
+          fuzzTest.saveInput( file.data() + sizeof(header), header.m_size );
+          ++savedCount;
+        }
+      }
+    }
+    catch ( std::runtime_error & )
+    {
+      // An unreadable file is left for the next load.
+      continue;
+    }
+    remove( path.c_str() );
+  }
+#else
+  (void)fuzzTest;
+#endif
+  return savedCount;
+}
+
+
+
+/// Fuzz test and target selected by FuzzerMain::initialize().
+static FuzzTest *fuzzerMainTest = NULL;
+static FuzzTarget *fuzzerMainTarget = NULL;
+/// Copy of the input run by FuzzerMain::testOneInput(), NULL if unavailable.
+static FuzzPendingInput *fuzzerMainPendingInput = NULL;
+
+
+int 
+FuzzerMain::initialize( int *, 
+                        char *** )
+{
+  // The tests are kept alive for the whole fuzzing session.
+  static Test *tests = TestFactoryRegistry::getRegistry().makeTest();
+  (void)tests;
+
+  const char *name = getenv( "CPPUNIT_FUZZ_TEST" );
+  const CppUnitVector<FuzzTest *> &fuzzTests = FuzzTest::getFuzzTests();
+  for ( unsigned int index =0; index < fuzzTests.size(); ++index )
+  {
+    if ( name == NULL  ?  fuzzTests.size() == 1 
+                       :  fuzzTests[ index ]->getName() == name )
+      fuzzerMainTest = fuzzTests[ index ];
+  }
+
+  if ( fuzzerMainTest == NULL )
+  {
+    fprintf( stderr, "%s\n", 
+             name == NULL ? "Set CPPUNIT_FUZZ_TEST to the name of the fuzz test "
+                            "to run. Fuzz tests:"
+                          : "Fuzz test not found. Fuzz tests:" );
+    for ( unsigned int testIndex =0; testIndex < fuzzTests.size(); ++testIndex )
+      fprintf( stderr, "  %s\n", fuzzTests[ testIndex ]->getName().c_str() );
+    exit( 1 );
+  }
+
+  fuzzerMainTarget = fuzzerMainTest->makeTarget();
+  try
+  {
+    // Never deleted: the engine ends the process with exit().
+    fuzzerMainPendingInput = new FuzzPendingInput( *fuzzerMainTest );
+  }
+  catch ( std::runtime_error &e )
+  {
+    fprintf( stderr, "%s Inputs that crash will not be saved.\n", e.what() );
+  }
+  return 0;
+}
+
+
+int 
+FuzzerMain::testOneInput( const unsigned char *data, 
+                          size_t size )
+{
+  if ( fuzzerMainPendingInput != NULL )
+  {
+    try
+    {
+      fuzzerMainPendingInput->start( data, size );
+    }
+    catch ( std::runtime_error &e )
+    {
+      fprintf( stderr, "%s Inputs that crash will not be saved.\n", e.what() );
+      delete fuzzerMainPendingInput;
+      fuzzerMainPendingInput = NULL;
+    }
+  }
+  FuzzInputResult result;
+  runFuzzInput( *fuzzerMainTarget, data, size, result );
+  if ( fuzzerMainPendingInput != NULL )
+    fuzzerMainPendingInput->finish();
+  if ( !result.m_failed )
+    return 0;
+
+  fprintf( stderr, "%s failed", fuzzerMainTest->getName().c_str() );
+  if ( result.m_sourceLine.isValid() )
+    fprintf( stderr, " at %s:%d", 
+             result.m_sourceLine.fileName().c_str(),
+             result.m_sourceLine.lineNumber() );
+  fprintf( stderr, "\n%s\n%s", 
+           result.m_message.shortDescription().c_str(),
+           result.m_message.details().c_str() );
+  try
+  {
+    fprintf( stderr, "Input saved to %s\n", 
+             fuzzerMainTest->saveInput( data, size ).c_str() );
+  }
+  catch ( std::exception &e )
+  {
+    fprintf( stderr, "%s\n", e.what() );
+  }
+  abort();
+  return 0;
+}
+
+
+CPPUNIT_NS_END
@@ -0,0 +1,312 @@
+#include <cppunit/IdleTimeListener.h>
+#include <cppunit/Test.h>
+#include <cppunit/extensions/BenchmarkEnvironment.h>
+#include <cppunit/tools/Clock.h>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(CPPUNIT_HAVE_GETRUSAGE)  &&  defined(CPPUNIT_HAVE_SYS_RESOURCE_H)
+#define CPPUNIT_IDLETIMELISTENER_USE_RUSAGE 1
+#include <sys/resource.h>
+#endif
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Index of delayacct_blkio_ticks in /proc/thread-self/stat, after the name.
+static const int ioWaitFieldIndex = 39;
+
+
+/// Orders record indexes by decreasing idle time.
+class IdleTimeOrder
+{
+public:
+  IdleTimeOrder( const IdleTimeListener &listener )
+      : m_listener( listener )
+  {
+  }
+
+  bool operator()( int first, int second ) const
+  {
+    return m_listener.idleSecondsAt( first ) > m_listener.idleSecondsAt( second );
+  }
+
+private:
+  const IdleTimeListener &m_listener;
+};
+
+
+IdleTimeListener::IdleTimeListener( double cpuBoundRatio,
+                                    double minimumIdleSeconds )
+    : m_cpuBoundRatio( cpuBoundRatio )
+    , m_minimumIdleSeconds( minimumIdleSeconds )
+{
+}
+
+
+IdleTimeListener::~IdleTimeListener()
+{
+}
+
+
+void
+IdleTimeListener::startTest( Test *test )
+{
+  m_startCounters[ test ] = readCounters();
+}
+
+
+void
+IdleTimeListener::endTest( Test *test )
+{
+  Counters end = readCounters();
+  StartCounters::iterator it = m_startCounters.find( test );
+  if ( it == m_startCounters.end() )
+    return;
+
+  const Counters &start = (*it).second;
+  Record record;
+  record.m_testName = test->getName();
+  record.m_counters.m_wallSeconds = end.m_wallSeconds - start.m_wallSeconds;
+  record.m_counters.m_cpuSeconds = end.m_cpuSeconds - start.m_cpuSeconds;
+  record.m_counters.m_ioWaitSeconds = end.m_ioWaitSeconds - start.m_ioWaitSeconds;
+  record.m_counters.m_voluntarySwitches = end.m_voluntarySwitches -
+                                          start.m_voluntarySwitches;
+  record.m_counters.m_blockOperations = end.m_blockOperations -
+                                        start.m_blockOperations;
+  record.m_kind = classify( record.m_counters.m_wallSeconds,
+                            record.m_counters.m_cpuSeconds,
+                            record.m_counters.m_ioWaitSeconds,
+                            record.m_counters.m_blockOperations );
+  m_records.push_back( record );
+  m_startCounters.erase( it );
+}
+
+
+void
+IdleTimeListener::reset()
+{
+  m_startCounters.clear();
+  m_records.clear();
+}
+
+
+int
+IdleTimeListener::testCount() const
+{
+  return m_records.size();
+}
+
+
+std::string
+IdleTimeListener::testNameAt( int index ) const
+{
+  return m_records[ index ].m_testName;
+}
+
+
+double
+IdleTimeListener::wallSecondsAt( int index ) const
+{
+  return m_records[ index ].m_counters.m_wallSeconds;
+}
+
+
+double
+IdleTimeListener::cpuSecondsAt( int index ) const
+{
+  return m_records[ index ].m_counters.m_cpuSeconds;
+}
+
+
+double
+IdleTimeListener::idleSecondsAt( int index ) const
+{
+  const Counters &counters = m_records[ index ].m_counters;
+  double idleSeconds = counters.m_wallSeconds - counters.m_cpuSeconds;
+  return idleSeconds > 0 ? idleSeconds : 0;
+}
+
+
+long
+IdleTimeListener::voluntarySwitchesAt( int index ) const
+{
+  return m_records[ index ].m_counters.m_voluntarySwitches;
+}
+
+
+double
+IdleTimeListener::ioWaitSecondsAt( int index ) const
+{
+  return m_records[ index ].m_counters.m_ioWaitSeconds;
+}
+
+
+long
+IdleTimeListener::blockOperationsAt( int index ) const
+{
+  return m_records[ index ].m_counters.m_blockOperations;
+}
+
+
+IdleTimeKind
+IdleTimeListener::kindAt( int index ) const
+{
+  return m_records[ index ].m_kind;
+}
+
+
+int
+IdleTimeListener::count( IdleTimeKind kind ) const
+{
+  int kindCount = 0;
+  for ( CppUnitVector<Record>::const_iterator it = m_records.begin();
+        it != m_records.end();
+        ++it )
+  {
+    if ( (*it).m_kind == kind )
+      ++kindCount;
+  }
+  return kindCount;
+}
+
+
+double
+IdleTimeListener::totalIdleSeconds() const
+{
+  double seconds = 0;
+  for ( int index =0; index < testCount(); ++index )
+    seconds += idleSecondsAt( index );
+  return seconds;
+}
+
+
+IdleTimeKind
+IdleTimeListener::classify( double wallSeconds,
+                            double cpuSeconds,
+                            double ioWaitSeconds,
+                            long blockOperations ) const
+{
+  double idleSeconds = wallSeconds - cpuSeconds;
+  if ( idleSeconds < m_minimumIdleSeconds  ||
+       cpuSeconds >= m_cpuBoundRatio * wallSeconds )
+    return idleCpuBound;
+
+  if ( ioWaitSeconds > 0 )
+    return ioWaitSeconds * 2 >= idleSeconds ? idleIoBound : idleSleepBound;
+
+  // Without delay accounting, block operations are the only evidence of I/O.
+  return blockOperations > 0 ? idleIoBound : idleSleepBound;
+}
+
+
+void
+IdleTimeListener::write( OStream &stream,
+                         int maximumTestCount ) const
+{
+  char line[ 120 ];
+  sprintf( line, "%d CPU-bound, %d sleep-bound, %d I/O-bound, %.3f s idle",
+           count( idleCpuBound ), count( idleSleepBound ), count( idleIoBound ),
+           totalIdleSeconds() );
+  stream << "Idle time: " << line << "\n";
+
+  CppUnitVector<int> order;
+  for ( int index =0; index < testCount(); ++index )
+  {
+    if ( kindAt( index ) != idleCpuBound )
+      order.push_back( index );
+  }
+  if ( order.empty() )
+    return;
+  std::stable_sort( order.begin(), order.end(), IdleTimeOrder( *this ) );
+
+  stream << "   Idle (ms)    Wall (ms)  CPU %  Switches  Kind         Test\n";
+  for ( int rank =0; rank < int(order.size())  &&  rank < maximumTestCount; ++rank )
+  {
+    int index = order[ rank ];
+    double wallSeconds = wallSecondsAt( index );
+    double cpuPercent = wallSeconds > 0 ? 100 * cpuSecondsAt( index ) / wallSeconds
+                                        : 0;
+    sprintf( line, "%12.3f %12.3f %6.1f %9ld  %-11s  ",
+             idleSecondsAt( index ) * 1e3,
+             wallSeconds * 1e3,
+             cpuPercent,
+             voluntarySwitchesAt( index ),
+             kindName( kindAt( index ) ).c_str() );
+    stream << line << testNameAt( index ) << "\n";
+  }
+}
+
+
+std::string
+IdleTimeListener::kindName( IdleTimeKind kind )
+{
+  switch ( kind )
+  {
+  case idleSleepBound:
+    return "sleep-bound";
+  case idleIoBound:
+    return "I/O-bound";
+  default:
+    return "CPU-bound";
+  }
+}
+
+
+IdleTimeListener::Counters
+IdleTimeListener::readCounters()
+{
+  Counters counters;
+  counters.m_wallSeconds = Clock::now();
+  counters.m_ioWaitSeconds = 0;
+  counters.m_voluntarySwitches = 0;
+  counters.m_blockOperations = 0;
+
+#if defined(CPPUNIT_IDLETIMELISTENER_USE_RUSAGE)
+  struct rusage usage;
+#if defined(RUSAGE_THREAD)
+  int status = getrusage( RUSAGE_THREAD, &usage );
+#else
+  int status = getrusage( RUSAGE_SELF, &usage );
+#endif
+  if ( status == 0 )
+  {
+    counters.m_voluntarySwitches = usage.ru_nvcsw;
+    counters.m_blockOperations = usage.ru_inblock + usage.ru_oublock;
+  }
+#endif
+
+#if defined(CPPUNIT_HAVE_CLOCK_GETTIME)  &&  defined(CLOCK_THREAD_CPUTIME_ID)
+  struct timespec time;
+  clock_gettime( CLOCK_THREAD_CPUTIME_ID, &time );
+  counters.m_cpuSeconds = time.tv_sec + time.tv_nsec * 1e-9;
+#elif defined(CPPUNIT_IDLETIMELISTENER_USE_RUSAGE)
+  counters.m_cpuSeconds = status != 0 ? 0 :
+      usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 +
+      usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+#else
+  counters.m_cpuSeconds = double(clock()) / CLOCKS_PER_SEC;
+#endif
+
+#if defined(__linux__)
+  // The name of the thread may contain spaces: fields are counted after it.
+  std::string stat = BenchmarkEnvironment::readFirstLine( "/proc/thread-self/stat" );
+  std::string::size_type position = stat.rfind( ')' );
+  for ( int field =0; position != std::string::npos  &&  field <= ioWaitFieldIndex; ++field )
+    position = stat.find( ' ', position + 1 );
+  long ticksPerSecond = sysconf( _SC_CLK_TCK );
+  if ( position != std::string::npos  &&  ticksPerSecond > 0 )
+    counters.m_ioWaitSeconds = atof( stat.c_str() + position + 1 ) / ticksPerSecond;
+#endif
+
+  return counters;
+}
+
+
+CPPUNIT_NS_END
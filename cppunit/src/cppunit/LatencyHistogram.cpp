@@ -0,0 +1,211 @@
+#include <cppunit/tools/LatencyHistogram.h>
+#include <math.h>
+#include <stdexcept>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Resolution of the histogram, in seconds.
+static const double latencyResolution = 1e-9;
+
+/// Largest power of two of latencyResolution covered by the histogram.
+static const int latencyMaximumExponent = 45;
+
+
+LatencyHistogram::LatencyHistogram( int significantBits )
+    : m_significantBits( significantBits < 1 ? 1 
+                                             : significantBits > 16 ? 16 
+                                                                    : significantBits )
+    , m_subBucketCount( 1 << m_significantBits )
+    , m_counts( m_subBucketCount * (latencyMaximumExponent - m_significantBits +1) )
+    , m_totalCount( 0 )
+    , m_minimum( 0 )
+    , m_maximum( 0 )
+    , m_sum( 0 )
+{
+}
+
+
+// Bucket layout: values below m_subBucketCount nanoseconds are counted in
+// one bucket per nanosecond. Then each power of two [2^e, 2^(e+1)[ is split
+// in m_subBucketCount buckets of equal width.
+int 
+LatencyHistogram::bucketIndexFor( double latency ) const
+{
+  double units = latency / latencyResolution;
+  if ( units < m_subBucketCount )
+    return int(units);
+
+  int exponent;
+  double mantissa = frexp( units, &exponent );  // units = mantissa * 2^exponent
+  int subBucket = int( (mantissa - 0.5) * 2 * m_subBucketCount );
+  int index = m_subBucketCount * (exponent - m_significantBits) + subBucket;
+  if ( index >= int(m_counts.size()) )
+    return m_counts.size() -1;
+  return index;
+}
+
+
+double 
+LatencyHistogram::getBucketLowerBoundAt( int index ) const
+{
+  if ( index < m_subBucketCount )
+    return index * latencyResolution;
+
+  int exponent = index / m_subBucketCount + m_significantBits -1;
+  int subBucket = index % m_subBucketCount;
+  return ldexp( 1.0 + double(subBucket) / m_subBucketCount, exponent ) 
+         * latencyResolution;
+}
+
+
+double 
+LatencyHistogram::getBucketUpperBoundAt( int index ) const
+{
+  if ( index < m_subBucketCount )
+    return (index +1) * latencyResolution;
+
+  int exponent = index / m_subBucketCount + m_significantBits -1;
+  return getBucketLowerBoundAt( index ) 
+         + ldexp( 1.0 / m_subBucketCount, exponent ) * latencyResolution;
+}
+
+
+void 
+LatencyHistogram::record( double latency )
+{
+  if ( latency < 0 )
+    latency = 0;
+
+  ++m_counts[ bucketIndexFor( latency ) ];
+  if ( m_totalCount == 0  ||  latency < m_minimum )
+    m_minimum = latency;
+  if ( m_totalCount == 0  ||  latency > m_maximum )
+    m_maximum = latency;
+  m_sum += latency;
+  ++m_totalCount;
+}
+
+
+void 
+LatencyHistogram::merge( const LatencyHistogram &other )
+{
+  if ( other.m_significantBits != m_significantBits )
+    throw std::invalid_argument( "LatencyHistogram::merge(): histograms have "
+                                 "different precisions" );
+  if ( other.m_totalCount == 0 )
+    return;
+
+  for ( unsigned int index =0; index < m_counts.size(); ++index )
+    m_counts[ index ] += other.m_counts[ index ];
+
+  if ( m_totalCount == 0  ||  other.m_minimum < m_minimum )
+    m_minimum = other.m_minimum;
+  if ( m_totalCount == 0  ||  other.m_maximum > m_maximum )
+    m_maximum = other.m_maximum;
+  m_sum += other.m_sum;
+  m_totalCount += other.m_totalCount;
+}
+
+
+void 
+LatencyHistogram::reset()
+{
+  for ( unsigned int index =0; index < m_counts.size(); ++index )
+    m_counts[ index ] = 0;
+  m_totalCount = 0;
+  m_minimum = 0;
+  m_maximum = 0;
+  m_sum = 0;
+}
+
+
+unsigned long 
+LatencyHistogram::totalCount() const
+{
+  return m_totalCount;
+}
+
+
+double 
+LatencyHistogram::minimum() const
+{
+  return m_minimum;
+}
+
+
+double 
+LatencyHistogram::maximum() const
+{
+  return m_maximum;
+}
+
+
+double 
+LatencyHistogram::mean() const
+{
+  if ( m_totalCount == 0 )
+    return 0;
+  return m_sum / m_totalCount;
+}
+
+
+double 
+LatencyHistogram::valueAtPercentile( double percentile ) const
+{
+  if ( m_totalCount == 0 )
+    return 0;
+
+  if ( percentile < 0 )
+    percentile = 0;
+  if ( percentile > 100 )
+    percentile = 100;
+
+  // Rank (1 based) of the latency at the given percentile.
+  double rank = ceil( percentile / 100 * m_totalCount );
+  if ( rank < 1 )
+    rank = 1;
+
+  double value = m_maximum;
+  unsigned long cumulatedCount = 0;
+  for ( unsigned int index =0; index < m_counts.size(); ++index )
+  {
+    cumulatedCount += m_counts[ index ];
+    if ( cumulatedCount >= rank )
+    {
+      value = getBucketUpperBoundAt( index );
+      break;
+    }
+  }
+
+  if ( value > m_maximum )
+    return m_maximum;
+  if ( value < m_minimum )
+    return m_minimum;
+  return value;
+}
+
+
+int 
+LatencyHistogram::significantBits() const
+{
+  return m_significantBits;
+}
+
+
+int 
+LatencyHistogram::getBucketCount() const
+{
+  return m_counts.size();
+}
+
+
+unsigned long 
+LatencyHistogram::getBucketCountAt( int index ) const
+{
+  return m_counts[ index ];
+}
+
+
+CPPUNIT_NS_END
@@ -0,0 +1,146 @@
+#include <cppunit/extensions/LatencyReport.h>
+#include <cppunit/tools/StringTools.h>
+#include <cppunit/tools/XmlElement.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+LatencyReport::LatencyReport()
+{
+}
+
+
+LatencyReport::~LatencyReport()
+{
+}
+
+
+LatencyReport &
+LatencyReport::getReport()
+{
+  static LatencyReport report;
+  return report;
+}
+
+
+void 
+LatencyReport::setLatencies( Test *test, 
+                             const LatencyHistogram &latencies )
+{
+  removeLatencies( test );
+  m_latencies.insert( Latencies::value_type( test, latencies ) );
+}
+
+
+void 
+LatencyReport::removeLatencies( Test *test )
+{
+  m_latencies.erase( test );
+}
+
+
+const LatencyHistogram *
+LatencyReport::findLatencies( Test *test ) const
+{
+  Latencies::const_iterator it = m_latencies.find( test );
+  if ( it == m_latencies.end() )
+    return NULL;
+  return &(*it).second;
+}
+
+
+std::string 
+LatencyReport::summaryFor( const LatencyHistogram &latencies )
+{
+  return "count=" + StringTools::toString( int(latencies.totalCount()) ) +
+         " min=" + StringTools::toString( latencies.minimum() ) +
+         " p50=" + StringTools::toString( latencies.valueAtPercentile( 50 ) ) +
+         " p90=" + StringTools::toString( latencies.valueAtPercentile( 90 ) ) +
+         " p99=" + StringTools::toString( latencies.valueAtPercentile( 99 ) ) +
+         " p99.9=" + StringTools::toString( latencies.valueAtPercentile( 99.9 ) ) +
+         " max=" + StringTools::toString( latencies.maximum() );
+}
+
+
+
+LatencyXmlOutputterHook::LatencyXmlOutputterHook( const LatencyReport &report )
+    : m_report( report )
+{
+}
+
+
+LatencyXmlOutputterHook::~LatencyXmlOutputterHook()
+{
+}
+
+
+void 
+LatencyXmlOutputterHook::failTestAdded( XmlDocument *,
+                                        XmlElement *testElement,
+                                        Test *test,
+                                        TestFailure * )
+{
+  addLatencies( testElement, test );
+}
+
+
+void 
+LatencyXmlOutputterHook::successfulTestAdded( XmlDocument *,
+                                              XmlElement *testElement,
+                                              Test *test )
+{
+  addLatencies( testElement, test );
+}
+
+
+void 
+LatencyXmlOutputterHook::addLatencies( XmlElement *testElement, 
+                                       Test *test )
+{
+  const LatencyHistogram *latencies = m_report.findLatencies( test );
+  if ( latencies == NULL )
+    return;
+
+  XmlElement *latencyElement = new XmlElement( "Latency" );
+  testElement->addElement( latencyElement );
+  latencyElement->addAttribute( "count", int(latencies->totalCount()) );
+  latencyElement->addAttribute( "min", 
+                                StringTools::toString( latencies->minimum() ) );
+  latencyElement->addAttribute( "mean", 
+                                StringTools::toString( latencies->mean() ) );
+  latencyElement->addAttribute( "max", 
+                                StringTools::toString( latencies->maximum() ) );
+
+  static const double percentiles[] = { 50, 90, 99, 99.9, 99.99 };
+  for ( unsigned int percentileIndex =0; 
+        percentileIndex < sizeof(percentiles) / sizeof(percentiles[0]); 
+        ++percentileIndex )
+  {
+    double percentile = percentiles[ percentileIndex ];
+    XmlElement *percentileElement = new XmlElement( "Percentile", 
+        StringTools::toString( latencies->valueAtPercentile( percentile ) ) );
+    percentileElement->addAttribute( "value", 
+                                     StringTools::toString( percentile ) );
+    latencyElement->addElement( percentileElement );
+  }
+
+  for ( int bucketIndex =0; 
+        bucketIndex < latencies->getBucketCount(); 
+        ++bucketIndex )
+  {
+    unsigned long count = latencies->getBucketCountAt( bucketIndex );
+    if ( count == 0 )
+      continue;
+
+    XmlElement *bucketElement = new XmlElement( "Bucket", int(count) );
+    bucketElement->addAttribute( "lowerBound", StringTools::toString( 
+        latencies->getBucketLowerBoundAt( bucketIndex ) ) );
+    bucketElement->addAttribute( "upperBound", StringTools::toString( 
+        latencies->getBucketUpperBoundAt( bucketIndex ) ) );
+    latencyElement->addElement( bucketElement );
+  }
+}
+
+
+CPPUNIT_NS_END
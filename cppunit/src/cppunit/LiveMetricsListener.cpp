@@ -0,0 +1,216 @@
+#include <cppunit/LiveMetricsListener.h>
+#include <cppunit/Test.h>
+#include <cppunit/TestFailure.h>
+#include <cppunit/extensions/BenchmarkEnvironment.h>
+#include <cppunit/tools/Clock.h>
+#include <algorithm>
+#include <stdexcept>
+#include <stdlib.h>
+
+#if defined(CPPUNIT_HAVE_UNISTD_H)
+#include <unistd.h>
+#endif
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Largest time the renderer thread takes to notice it must stop.
+static const double liveMetricsRendererPollSeconds = 0.05;
+
+
+LiveMetricsListener::LiveMetricsListener( LiveMetricsSegment &segment,
+                                          int workerIndex,
+                                          const std::string &textFileName,
+                                          double renderIntervalSeconds )
+    : m_segment( segment )
+    , m_workerIndex( workerIndex )
+    , m_textFileName( textFileName )
+    , m_renderIntervalSeconds( renderIntervalSeconds )
+    , m_lastRenderTime( 0 )
+    , m_rendererStopped( true )
+{
+  if ( workerIndex < 0  ||  workerIndex >= LiveMetricsSegment::slotCount )
+    throw std::invalid_argument( "LiveMetricsListener: worker index out of range" );
+}
+
+
+LiveMetricsListener::~LiveMetricsListener()
+{
+  stopRenderer();
+}
+
+
+void
+LiveMetricsListener::startTestRun( Test *,
+                                   TestResult * )
+{
+  startRun();
+  publish();
+  render( true );
+  startRenderer();
+}
+
+
+void
+LiveMetricsListener::startTest( Test *test )
+{
+  if ( !m_metrics.m_running )
+    startRun();
+  ++m_metrics.m_startedCount;
+  m_metrics.m_currentTest = test->getName();
+  publish();
+}
+
+
+void
+LiveMetricsListener::addFailure( const TestFailure &failure )
+{
+  if ( failure.isError() )
+    ++m_metrics.m_errorCount;
+  else
+    ++m_metrics.m_failureCount;
+  publish();
+}
+
+
+void
+LiveMetricsListener::endTest( Test * )
+{
+  ++m_metrics.m_finishedCount;
+  m_metrics.m_currentTest = "";
+  m_metrics.m_residentBytes = residentBytes();
+  publish();
+  if ( !m_renderer.isRunning() )
+    render( false );
+}
+
+
+void
+LiveMetricsListener::endTestRun( Test *,
+                                 TestResult * )
+{
+  stopRenderer();
+  m_metrics.m_running = false;
+  m_metrics.m_currentTest = "";
+  m_metrics.m_residentBytes = residentBytes();
+  publish();
+  render( true );
+}
+
+
+const LiveWorkerMetrics &
+LiveMetricsListener::metrics() const
+{
+  return m_metrics;
+}
+
+
+long
+LiveMetricsListener::residentBytes()
+{
+#if defined(__linux__)  &&  defined(CPPUNIT_HAVE_UNISTD_H)
+  // Second field of statm: resident pages.
+  std::string statm = BenchmarkEnvironment::readFirstLine( "/proc/self/statm" );
+  std::string::size_type position = statm.find( ' ' );
+  if ( position != std::string::npos )
+    return atol( statm.c_str() + position + 1 ) * sysconf( _SC_PAGESIZE );
+#endif
+  return 0;
+}
+
+
+void
+LiveMetricsListener::startRun()
+{
+  m_metrics = LiveWorkerMetrics();
+#if defined(CPPUNIT_HAVE_UNISTD_H)
+  m_metrics.m_processId = ::getpid();
+#else
+  m_metrics.m_processId = 1;
+#endif
+  m_metrics.m_running = true;
+  m_metrics.m_residentBytes = residentBytes();
+  m_metrics.m_startTime = Clock::now();
+}
+
+
+void
+LiveMetricsListener::publish()
+{
+  m_metrics.m_updateTime = Clock::now();
+  m_segment.writeWorker( m_workerIndex, m_metrics );
+}
+
+
+void
+LiveMetricsListener::render( bool force )
+{
+  // The renderer thread may call this at the same time as the listener.
+  m_renderMutex.lock();
+  double now = Clock::now();
+  if ( m_textFileName.empty()  ||  
+       ( !force  &&  now - m_lastRenderTime < m_renderIntervalSeconds ) )
+  {
+    m_renderMutex.unlock();
+    return;
+  }
+
+  m_lastRenderTime = now;
+  try
+  {
+    m_segment.writePrometheusFile( m_textFileName );
+  }
+  catch ( std::runtime_error & )
+  {
+    // A monitoring failure must not fail the tests.
+    m_textFileName = "";
+  }
+  m_renderMutex.unlock();
+}
+
+
+void
+LiveMetricsListener::startRenderer()
+{
+  if ( m_textFileName.empty()  ||  m_renderer.isRunning() )
+    return;
+
+  m_rendererStopped = false;
+  m_renderer.start( *this );
+}
+
+
+void
+LiveMetricsListener::stopRenderer()
+{
+  m_renderMutex.lock();
+  m_rendererStopped = true;
+  m_renderMutex.unlock();
+  m_renderer.join();
+}
+
+
+void
+LiveMetricsListener::run( int )
+{
+  while ( true )
+  {
+    double deadline = Clock::now() + std::max( m_renderIntervalSeconds, 
+                                               liveMetricsRendererPollSeconds );
+    double now;
+    while ( (now = Clock::now()) < deadline )
+    {
+      m_renderMutex.lock();
+      bool stopped = m_rendererStopped;
+      m_renderMutex.unlock();
+      if ( stopped )
+        return;
+      Clock::sleepUntil( std::min( deadline, now + liveMetricsRendererPollSeconds ) );
+    }
+    render( true );
+  }
+}
+
+
+CPPUNIT_NS_END
@@ -0,0 +1,421 @@
+#include <cppunit/tools/LiveMetricsSegment.h>
+#include <cppunit/portability/CppUnitVector.h>
+#include <cppunit/tools/Clock.h>
+#include <stdexcept>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(CPPUNIT_HAVE_MMAP)  &&  defined(CPPUNIT_HAVE_SYS_MMAN_H)  &&  \
+    defined(CPPUNIT_HAVE_SYS_STAT_H)  &&  defined(CPPUNIT_HAVE_FCNTL_H)  &&  \
+    defined(CPPUNIT_HAVE_UNISTD_H)
+#define CPPUNIT_LIVEMETRICSSEGMENT_USE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#if defined(CPPUNIT_HAVE_UNISTD_H)
+#include <unistd.h>
+#endif
+
+
+CPPUNIT_NS_BEGIN
+
+
+const int LiveMetricsSegment::slotCount = 64;
+
+/// Identifies the files storing a segment (7 characters and a null).
+static const char liveMetricsMagic[8] = "CPPUNLM";
+static const int liveMetricsVersion = 1;
+/// Longest test name stored in a slot, including the terminating null.
+static const int liveMetricsTestNameLength = 256;
+/// Attempts to read a slot before returning a possibly inconsistent copy.
+static const int liveMetricsReadAttempts = 1000;
+/// Longest time to wait for the process creating a segment to initialise it.
+static const double liveMetricsInitialisationSeconds = 1;
+/// Value of LiveMetricsHeader::m_initialised once the header is written.
+static const unsigned long liveMetricsInitialised = 1;
+
+
+/*! Beginning of the segment. The other fields are only valid once
+ *  m_initialised is set, after them.
+ */
+struct LiveMetricsHeader
+{
+  volatile unsigned long m_initialised;
+  char m_magic[8];
+  int m_version;
+  int m_slotCount;
+};
+
+
+/*! Slot written by one worker. The sequence number is odd while the worker
+ *  updates the slot.
+ */
+struct LiveMetricsSlot
+{
+  volatile unsigned long m_sequence;
+  long m_processId;
+  long m_running;
+  long m_startedCount;
+  long m_finishedCount;
+  long m_failureCount;
+  long m_errorCount;
+  long m_residentBytes;
+  double m_startTime;
+  double m_updateTime;
+  char m_currentTest[ liveMetricsTestNameLength ];
+};
+
+
+/// Metric written by LiveMetricsSegment::writePrometheus().
+struct LiveMetricsFamily
+{
+  const char *m_name;
+  const char *m_type;
+  const char *m_help;
+};
+
+
+static const LiveMetricsFamily liveMetricsFamilies[] =
+{
+  { "cppunit_tests_started_total", "counter", "Tests started by the worker." },
+  { "cppunit_tests_finished_total", "counter", "Tests finished by the worker." },
+  { "cppunit_test_failures_total", "counter", "Assertion failures." },
+  { "cppunit_test_errors_total", "counter", "Tests that threw an unexpected exception." },
+  { "cppunit_tests_per_second", "gauge", "Tests finished per second since the run started." },
+  { "cppunit_resident_memory_bytes", "gauge", "Resident set size of the worker process." },
+  { "cppunit_worker_running", "gauge", "1 while the worker runs tests." }
+};
+
+static const int liveMetricsFamilyCount =
+    sizeof(liveMetricsFamilies) / sizeof(liveMetricsFamilies[0]);
+
+
+/// Orders the memory accesses around the updates of the sequence number.
+static void
+liveMetricsBarrier()
+{
+#if defined(__GNUC__)
+  __sync_synchronize();
+#endif
+}
+
+
+/// Returns the slot of a worker in a mapped segment.
+static LiveMetricsSlot *
+liveMetricsSlot( void *memory,
+                 int workerIndex )
+{
+  void *slots = CPPUNIT_STATIC_CAST( char *, memory ) + sizeof(LiveMetricsHeader);
+  return CPPUNIT_STATIC_CAST( LiveMetricsSlot *, slots ) + workerIndex;
+}
+
+
+/// Returns the value of the metric family of the specified index.
+static double
+liveMetricsValue( const LiveWorkerMetrics &metrics,
+                  int familyIndex )
+{
+  switch ( familyIndex )
+  {
+  case 0:
+    return metrics.m_startedCount;
+  case 1:
+    return metrics.m_finishedCount;
+  case 2:
+    return metrics.m_failureCount;
+  case 3:
+    return metrics.m_errorCount;
+  case 4:
+    return metrics.testsPerSecond();
+  case 5:
+    return metrics.m_residentBytes;
+  default:
+    return metrics.m_running ? 1 : 0;
+  }
+}
+
+
+/// Escapes a label value of the Prometheus text format.
+static std::string
+escapePrometheusLabel( const std::string &value )
+{
+  std::string escaped;
+  for ( unsigned int index =0; index < value.length(); ++index )
+  {
+    char c = value[ index ];
+    if ( c == '\\'  ||  c == '"' )
+      escaped += '\\';
+    if ( c == '\n' )
+      escaped += "\\n";
+    else
+      escaped += c;
+  }
+  return escaped;
+}
+
+
+LiveWorkerMetrics::LiveWorkerMetrics()
+    : m_processId( 0 )
+    , m_running( false )
+    , m_startedCount( 0 )
+    , m_finishedCount( 0 )
+    , m_failureCount( 0 )
+    , m_errorCount( 0 )
+    , m_residentBytes( 0 )
+    , m_startTime( 0 )
+    , m_updateTime( 0 )
+{
+}
+
+
+double
+LiveWorkerMetrics::testsPerSecond() const
+{
+  double elapsed = m_updateTime - m_startTime;
+  return elapsed > 0 ? m_finishedCount / elapsed : 0;
+}
+
+
+LiveMetricsSegment::LiveMetricsSegment( const std::string &fileName,
+                                        bool create )
+    : m_fileName( fileName )
+    , m_memory( NULL )
+    , m_size( sizeof(LiveMetricsHeader) + slotCount * sizeof(LiveMetricsSlot) )
+    , m_writable( create )
+{
+#if defined(CPPUNIT_LIVEMETRICSSEGMENT_USE_MMAP)
+  int fd = create ? ::open( fileName.c_str(), O_RDWR | O_CREAT, 0644 )
+                  : ::open( fileName.c_str(), O_RDONLY );
+  if ( fd < 0 )
+    throw std::runtime_error( "Can not open live metrics segment <" + fileName + ">." );
+
+  struct stat status;
+  if ( ::fstat( fd, &status ) != 0 )
+  {
+    ::close( fd );
+    throw std::runtime_error( "Can not get the size of file <" + fileName + ">." );
+  }
+
+  // Workers starting together may all extend the new file: the header they
+  // write below is the same.
+  if ( create  &&  status.st_size == 0  &&  ::ftruncate( fd, m_size ) == 0 )
+    status.st_size = m_size;
+  if ( size_t(status.st_size) != m_size )
+  {
+    ::close( fd );
+    throw std::runtime_error( "File <" + fileName + "> is not a live metrics segment." );
+  }
+
+  void *memory = ::mmap( NULL, m_size,
+                         create ? PROT_READ | PROT_WRITE : PROT_READ,
+                         MAP_SHARED, fd, 0 );
+  ::close( fd );
+  if ( memory == MAP_FAILED )
+    throw std::runtime_error( "Can not map live metrics segment <" + fileName + ">." );
+  m_memory = memory;
+
+  LiveMetricsHeader *header = CPPUNIT_STATIC_CAST( LiveMetricsHeader *, m_memory );
+  if ( create  &&  header->m_initialised == 0 )
+  {
+    // Workers creating the file together all write the same header.
+    header->m_version = liveMetricsVersion;
+    header->m_slotCount = slotCount;
+    memcpy( header->m_magic, liveMetricsMagic, sizeof(header->m_magic) );
+    liveMetricsBarrier();
+    header->m_initialised = liveMetricsInitialised;
+  }
+
+  // The file may have just been created by another process.
+  double deadline = Clock::now() + liveMetricsInitialisationSeconds;
+  while ( header->m_initialised == 0  &&  Clock::now() < deadline )
+    Clock::sleepUntil( Clock::now() + 0.001 );
+  liveMetricsBarrier();
+  if ( header->m_initialised != liveMetricsInitialised  ||
+       memcmp( header->m_magic, liveMetricsMagic, sizeof(header->m_magic) ) != 0  ||
+       header->m_version != liveMetricsVersion  ||
+       header->m_slotCount != slotCount )
+  {
+    ::munmap( m_memory, m_size );
+    throw std::runtime_error( "File <" + fileName + "> is not a live metrics segment." );
+  }
+#else
+  throw std::runtime_error( "Live metrics segments require mmap(): can not map <" +
+                            fileName + ">." );
+#endif
+}
+
+
+LiveMetricsSegment::~LiveMetricsSegment()
+{
+#if defined(CPPUNIT_LIVEMETRICSSEGMENT_USE_MMAP)
+  if ( m_memory != NULL )
+    ::munmap( m_memory, m_size );
+#endif
+}
+
+
+void
+LiveMetricsSegment::checkWorkerIndex( int workerIndex ) const
+{
+  if ( workerIndex < 0  ||  workerIndex >= slotCount )
+    throw std::invalid_argument( "LiveMetricsSegment: worker index out of range" );
+}
+
+
+void
+LiveMetricsSegment::writeWorker( int workerIndex,
+                                 const LiveWorkerMetrics &metrics )
+{
+  checkWorkerIndex( workerIndex );
+  if ( !m_writable )
+    throw std::runtime_error( "Live metrics segment <" + m_fileName +
+                              "> is mapped read-only." );
+
+  LiveMetricsSlot *slot = liveMetricsSlot( m_memory, workerIndex );
+  slot->m_sequence = slot->m_sequence + 1;
+  liveMetricsBarrier();
+  slot->m_processId = metrics.m_processId;
+  slot->m_running = metrics.m_running ? 1 : 0;
+  slot->m_startedCount = metrics.m_startedCount;
+  slot->m_finishedCount = metrics.m_finishedCount;
+  slot->m_failureCount = metrics.m_failureCount;
+  slot->m_errorCount = metrics.m_errorCount;
+  slot->m_residentBytes = metrics.m_residentBytes;
+  slot->m_startTime = metrics.m_startTime;
+  slot->m_updateTime = metrics.m_updateTime;
+  strncpy( slot->m_currentTest, metrics.m_currentTest.c_str(),
+           liveMetricsTestNameLength -1 );
+  slot->m_currentTest[ liveMetricsTestNameLength -1 ] = 0;
+  liveMetricsBarrier();
+  slot->m_sequence = slot->m_sequence + 1;
+}
+
+
+LiveWorkerMetrics
+LiveMetricsSegment::readWorker( int workerIndex ) const
+{
+  checkWorkerIndex( workerIndex );
+
+  const LiveMetricsSlot *slot = liveMetricsSlot( m_memory, workerIndex );
+  LiveMetricsSlot copy;
+  for ( int attempt =0; attempt < liveMetricsReadAttempts; ++attempt )
+  {
+    unsigned long sequence = slot->m_sequence;
+    liveMetricsBarrier();
+    memcpy( &copy, slot, sizeof(copy) );
+    liveMetricsBarrier();
+    if ( sequence % 2 == 0  &&  sequence == slot->m_sequence )
+      break;
+  }
+  copy.m_currentTest[ liveMetricsTestNameLength -1 ] = 0;
+
+  LiveWorkerMetrics metrics;
+  metrics.m_processId = copy.m_processId;
+  metrics.m_running = copy.m_running != 0;
+  metrics.m_startedCount = copy.m_startedCount;
+  metrics.m_finishedCount = copy.m_finishedCount;
+  metrics.m_failureCount = copy.m_failureCount;
+  metrics.m_errorCount = copy.m_errorCount;
+  metrics.m_residentBytes = copy.m_residentBytes;
+  metrics.m_startTime = copy.m_startTime;
+  metrics.m_updateTime = copy.m_updateTime;
+  metrics.m_currentTest = copy.m_currentTest;
+  return metrics;
+}
+
+
+int
+LiveMetricsSegment::usedSlotCount() const
+{
+  int count = 0;
+  for ( int workerIndex =0; workerIndex < slotCount; ++workerIndex )
+  {
+    if ( readWorker( workerIndex ).m_processId != 0 )
+      ++count;
+  }
+  return count;
+}
+
+
+void
+LiveMetricsSegment::writePrometheus( OStream &stream ) const
+{
+  CppUnitVector<int> workerIndexes;
+  CppUnitVector<LiveWorkerMetrics> workers;
+  for ( int workerIndex =0; workerIndex < slotCount; ++workerIndex )
+  {
+    LiveWorkerMetrics metrics = readWorker( workerIndex );
+    if ( metrics.m_processId == 0 )
+      continue;
+    workerIndexes.push_back( workerIndex );
+    workers.push_back( metrics );
+  }
+
+  char line[ 120 ];
+  for ( int familyIndex =0; familyIndex < liveMetricsFamilyCount; ++familyIndex )
+  {
+    const LiveMetricsFamily &family = liveMetricsFamilies[ familyIndex ];
+    stream << "# HELP " << family.m_name << " " << family.m_help << "\n"
+           << "# TYPE " << family.m_name << " " << family.m_type << "\n";
+    for ( unsigned int index =0; index < workers.size(); ++index )
+    {
+      sprintf( line, "{worker=\"%d\"} %.15g",
+               workerIndexes[ index ],
+               liveMetricsValue( workers[ index ], familyIndex ) );
+      stream << family.m_name << line << "\n";
+    }
+  }
+
+  stream << "# HELP cppunit_current_test Test being run by the worker.\n"
+            "# TYPE cppunit_current_test gauge\n";
+  for ( unsigned int index =0; index < workers.size(); ++index )
+  {
+    const LiveWorkerMetrics &metrics = workers[ index ];
+    if ( !metrics.m_running  ||  metrics.m_currentTest.empty() )
+      continue;
+    sprintf( line, "{worker=\"%d\",test=\"", workerIndexes[ index ] );
+    stream << "cppunit_current_test" << line
+           << escapePrometheusLabel( metrics.m_currentTest ) << "\"} 1\n";
+  }
+}
+
+
+void
+LiveMetricsSegment::writePrometheusFile( const std::string &fileName ) const
+{
+  OStringStream content;
+  writePrometheus( content );
+  std::string text = content.str();
+
+  OStringStream temporaryName;
+  temporaryName << fileName << ".tmp";
+#if defined(CPPUNIT_HAVE_UNISTD_H)
+  temporaryName << "." << ::getpid();
+#endif
+
+  FILE *file = fopen( temporaryName.str().c_str(), "wb" );
+  if ( file == NULL )
+    throw std::runtime_error( "Can not create file <" + temporaryName.str() + ">." );
+  bool written = fwrite( text.c_str(), 1, text.length(), file ) == text.length();
+  if ( fclose( file ) != 0  ||  !written )
+  {
+    remove( temporaryName.str().c_str() );
+    throw std::runtime_error( "Can not write file <" + temporaryName.str() + ">." );
+  }
+
+  // rename() atomically replaces the file on POSIX systems. Windows refuses
+  // to replace an existing file.
+  if ( rename( temporaryName.str().c_str(), fileName.c_str() ) != 0 )
+  {
+    remove( fileName.c_str() );
+    if ( rename( temporaryName.str().c_str(), fileName.c_str() ) != 0 )
+    {
+      remove( temporaryName.str().c_str() );
+      throw std::runtime_error( "Can not replace file <" + fileName + ">." );
+    }
+  }
+}
+
+
+CPPUNIT_NS_END
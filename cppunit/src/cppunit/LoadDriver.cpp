@@ -0,0 +1,238 @@
+#include <cppunit/Asserter.h>
+#include <cppunit/Exception.h>
+#include <cppunit/extensions/LatencyReport.h>
+#include <cppunit/extensions/LoadDriver.h>
+#include <cppunit/portability/CppUnitVector.h>
+#include <cppunit/tools/Clock.h>
+#include <cppunit/tools/StringTools.h>
+#include <cppunit/tools/ThreadGroup.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+LoadProfile::LoadProfile( double requestsPerSecond,
+                          double durationSeconds,
+                          int threadCount )
+    : m_requestsPerSecond( requestsPerSecond )
+    , m_durationSeconds( durationSeconds )
+    , m_threadCount( threadCount > 0 ? threadCount : 1 )
+{
+}
+
+
+double 
+LoadProfile::requestsPerSecond() const
+{
+  return m_requestsPerSecond;
+}
+
+
+double 
+LoadProfile::durationSeconds() const
+{
+  return m_durationSeconds;
+}
+
+
+int 
+LoadProfile::threadCount() const
+{
+  return m_threadCount;
+}
+
+
+int 
+LoadProfile::requestCount() const
+{
+  if ( m_requestsPerSecond <= 0  ||  m_durationSeconds <= 0 )
+    return 0;
+  return int( m_requestsPerSecond * m_durationSeconds + 0.5 );
+}
+
+
+
+/// Sends the requests assigned to each generator thread.
+class LoadGeneratorTask : public ThreadTask
+{
+public:
+  LoadGeneratorTask( const LoadProfile &profile,
+                     LoadRequest &request,
+                     int significantBits )
+      : m_profile( profile )
+      , m_request( request )
+      , m_startTime( 0 )
+      , m_latencies( profile.threadCount(), LatencyHistogram( significantBits ) )
+      , m_failureCounts( profile.threadCount(), 0 )
+      , m_firstFailures( profile.threadCount() )
+  {
+  }
+
+  void start()
+  {
+    // Gives the threads some time to start before the first request is due.
+    m_startTime = Clock::now() + 0.001;
+  }
+
+  void run( int threadIndex )
+  {
+    int requestCount = m_profile.requestCount();
+    double interval = 1.0 / m_profile.requestsPerSecond();
+    for ( int requestIndex = threadIndex; 
+          requestIndex < requestCount; 
+          requestIndex += m_profile.threadCount() )
+    {
+      double dueTime = m_startTime + requestIndex * interval;
+      Clock::sleepUntil( dueTime );
+      try
+      {
+        m_request.send( threadIndex );
+      }
+      catch ( std::exception &e )
+      {
+        addFailure( threadIndex, e.what() );
+      }
+      catch ( ... )
+      {
+        addFailure( threadIndex, "unknown exception" );
+      }
+      m_latencies[ threadIndex ].record( Clock::now() - dueTime );
+    }
+  }
+
+  double startTime() const
+  {
+    return m_startTime;
+  }
+
+  void mergeLatencies( LatencyHistogram &latencies ) const
+  {
+    for ( int index =0; index < m_profile.threadCount(); ++index )
+      latencies.merge( m_latencies[ index ] );
+  }
+
+  int failureCount() const
+  {
+    int count = 0;
+    for ( int index =0; index < m_profile.threadCount(); ++index )
+      count += m_failureCounts[ index ];
+    return count;
+  }
+
+  std::string firstFailure() const
+  {
+    for ( int index =0; index < m_profile.threadCount(); ++index )
+    {
+      if ( m_failureCounts[ index ] > 0 )
+        return m_firstFailures[ index ];
+    }
+    return "";
+  }
+
+private:
+  void addFailure( int threadIndex, 
+                   const std::string &failure )
+  {
+    if ( m_failureCounts[ threadIndex ]++ == 0 )
+      m_firstFailures[ threadIndex ] = failure;
+  }
+
+private:
+  const LoadProfile &m_profile;
+  LoadRequest &m_request;
+  double m_startTime;
+  CppUnitVector<LatencyHistogram> m_latencies;
+  CppUnitVector<int> m_failureCounts;
+  CppUnitVector<std::string> m_firstFailures;
+};
+
+
+
+LoadDriver::LoadDriver( const LoadProfile &profile,
+                        Test *test )
+    : m_profile( profile )
+    , m_test( test )
+    , m_achievedRequestsPerSecond( 0 )
+{
+}
+
+
+LoadDriver::~LoadDriver()
+{
+}
+
+
+void 
+LoadDriver::run( LoadRequest &request )
+{
+  LoadGeneratorTask task( m_profile, request, m_latencies.significantBits() );
+  task.start();
+  ThreadGroup::run( task, m_profile.threadCount() );
+
+  double elapsed = Clock::now() - task.startTime();
+  if ( elapsed > 0 )
+    m_achievedRequestsPerSecond = m_profile.requestCount() / elapsed;
+
+  task.mergeLatencies( m_latencies );
+  if ( m_test != NULL )
+    LatencyReport::getReport().setLatencies( m_test, m_latencies );
+
+  int failureCount = task.failureCount();
+  if ( failureCount > 0 )
+  {
+    Message message( "load test request failed",
+                     StringTools::toString( failureCount ) + " of " +
+                     StringTools::toString( m_profile.requestCount() ) + 
+                     " requests failed",
+                     "First failure: " + task.firstFailure() );
+    Asserter::fail( message );
+  }
+}
+
+
+const LatencyHistogram &
+LoadDriver::latencies() const
+{
+  return m_latencies;
+}
+
+
+const LoadProfile &
+LoadDriver::profile() const
+{
+  return m_profile;
+}
+
+
+double 
+LoadDriver::achievedRequestsPerSecond() const
+{
+  return m_achievedRequestsPerSecond;
+}
+
+
+
+void 
+assertPercentileBelow( const LatencyHistogram &latencies,
+                       double percentile,
+                       double maximumLatency,
+                       SourceLine sourceLine,
+                       const std::string &message )
+{
+  double latency = latencies.valueAtPercentile( percentile );
+  if ( latency <= maximumLatency )
+    return;
+
+  Message failure( "latency percentile assertion failed",
+                   "Expected p" + StringTools::toString( percentile ) + 
+                   " <= " + StringTools::toString( maximumLatency ) + " s",
+                   "Actual   p" + StringTools::toString( percentile ) + 
+                   " = " + StringTools::toString( latency ) + " s" );
+  failure.addDetail( "Distribution: " + LatencyReport::summaryFor( latencies ) );
+  if ( !message.empty() )
+    failure.addDetail( message );
+  Asserter::fail( failure, sourceLine );
+}
+
+
+CPPUNIT_NS_END
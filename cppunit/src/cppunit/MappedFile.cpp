@@ -0,0 +1,97 @@
+#include <cppunit/tools/MappedFile.h>
+#include <stdexcept>
+#include <stdio.h>
+
+#if defined(CPPUNIT_HAVE_MMAP)  &&  defined(CPPUNIT_HAVE_SYS_MMAN_H)  &&  \
+    defined(CPPUNIT_HAVE_SYS_STAT_H)  &&  defined(CPPUNIT_HAVE_FCNTL_H)  &&  \
+    defined(CPPUNIT_HAVE_UNISTD_H)
+#define CPPUNIT_MAPPEDFILE_USE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Content returned for empty files.
+static unsigned char mappedFileEmptyContent[1] = { 0 };
+
+
+MappedFile::MappedFile( const std::string &path )
+    : m_data( mappedFileEmptyContent )
+    , m_size( 0 )
+    , m_mapped( false )
+{
+#if defined(CPPUNIT_MAPPEDFILE_USE_MMAP)
+  int fd = ::open( path.c_str(), O_RDONLY );
+  if ( fd < 0 )
+    throw std::runtime_error( "Can not open file <" + path + ">." );
+
+  struct stat status;
+  if ( ::fstat( fd, &status ) != 0 )
+  {
+    ::close( fd );
+    throw std::runtime_error( "Can not get the size of file <" + path + ">." );
+  }
+
+  if ( status.st_size > 0 )
+  {
+    void *memory = ::mmap( NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    if ( memory == MAP_FAILED )
+    {
+      ::close( fd );
+      throw std::runtime_error( "Can not map file <" + path + ">." );
+    }
+    m_data = CPPUNIT_STATIC_CAST( unsigned char *, memory );
+    m_size = status.st_size;
+    m_mapped = true;
+  }
+  ::close( fd );
+#else
+  FILE *file = fopen( path.c_str(), "rb" );
+  if ( file == NULL )
+    throw std::runtime_error( "Can not open file <" + path + ">." );
+
+  fseek( file, 0, SEEK_END );
+  long size = ftell( file );
+  fseek( file, 0, SEEK_SET );
+  if ( size > 0 )
+  {
+    m_data = new unsigned char[ size ];
+    m_size = fread( m_data, 1, size, file );
+  }
+  fclose( file );
+#endif
+}
+
+
+MappedFile::~MappedFile()
+{
+#if defined(CPPUNIT_MAPPEDFILE_USE_MMAP)
+  if ( m_mapped )
+    ::munmap( m_data, m_size );
+#else
+  if ( m_data != mappedFileEmptyContent )
+    delete [] m_data;
+#endif
+}
+
+
+const unsigned char *
+MappedFile::data() const
+{
+  return m_data;
+}
+
+
+size_t 
+MappedFile::size() const
+{
+  return m_size;
+}
+
+
+CPPUNIT_NS_END
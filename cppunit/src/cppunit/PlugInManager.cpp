@@ -2,10 +2,12 @@
 #include <cppunit/XmlOutputterHook.h>
 
 #if !defined(CPPUNIT_NO_TESTPLUGIN)
+#include <cppunit/extensions/StartupProfile.h>
 #include <cppunit/extensions/TestFactoryRegistry.h>
 #include <cppunit/plugin/PlugInManager.h>
 #include <cppunit/plugin/TestPlugIn.h>
 #include <cppunit/plugin/DynamicLibraryManager.h>
+#include <cppunit/tools/Clock.h>
 
 
 CPPUNIT_NS_BEGIN
@@ -27,6 +29,10 @@ void
 PlugInManager::load( const std::string &libraryFileName,
                      const PlugInParameters &parameters )
 {
+  // Loading the library runs its static constructors, which register its suites.
+  StartupProfile &profile = StartupProfile::getProfile();
+  double startTime = Clock::now();
+
   PlugInInfo info;
   info.m_fileName = libraryFileName;
   info.m_manager = new DynamicLibraryManager( libraryFileName );
@@ -34,10 +40,15 @@ PlugInManager::load( const std::string &libraryFileName,
   TestPlugInSignature plug = (TestPlugInSignature)info.m_manager->findSymbol( 
         CPPUNIT_STRINGIZE( CPPUNIT_PLUGIN_EXPORTED_NAME ) );
   info.m_interface = (*plug)();
+  profile.addPhaseTime( "load plug-in " + libraryFileName, 
+                        Clock::now() - startTime );
 
   m_plugIns.push_back( info );
   
+  startTime = Clock::now();
   info.m_interface->initialize( &TestFactoryRegistry::getRegistry(), parameters );
+  profile.addPhaseTime( "initialize plug-in " + libraryFileName, 
+                        Clock::now() - startTime );
 }
 
 
@@ -0,0 +1,612 @@
+#include <cppunit/Asserter.h>
+#include <cppunit/Exception.h>
+#include <cppunit/Message.h>
+#include <cppunit/extensions/Property.h>
+#include <cppunit/portability/Stream.h>
+#include <cppunit/tools/StringTools.h>
+#include <cppunit/tools/ThreadGroup.h>
+#include <limits.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Alignment of the memory returned by PropertyArena::allocate().
+static const size_t propertyArenaAlignment = 16;
+
+
+PropertyArena::PropertyArena( size_t chunkSize )
+    : m_chunkSize( chunkSize > 0 ? chunkSize : propertyArenaAlignment )
+    , m_chunkIndex( 0 )
+    , m_offset( 0 )
+    , m_allocatedSize( 0 )
+{
+}
+
+
+PropertyArena::~PropertyArena()
+{
+  for ( unsigned int index =0; index < m_chunks.size(); ++index )
+    delete [] m_chunks[ index ];
+}
+
+
+void *
+PropertyArena::allocate( size_t size )
+{
+  size = (size + propertyArenaAlignment -1) & ~(propertyArenaAlignment -1);
+  if ( size == 0 )
+    size = propertyArenaAlignment;
+
+  while ( m_chunkIndex < m_chunks.size() )
+  {
+    if ( m_offset + size <= m_chunkSizes[ m_chunkIndex ] )
+    {
+      void *memory = m_chunks[ m_chunkIndex ] + m_offset;
+      m_offset += size;
+      m_allocatedSize += size;
+      return memory;
+    }
+    ++m_chunkIndex;
+    m_offset = 0;
+  }
+
+  size_t chunkSize = size > m_chunkSize ? size : m_chunkSize;
+  m_chunks.push_back( new char[ chunkSize ] );
+  m_chunkSizes.push_back( chunkSize );
+  m_chunkIndex = m_chunks.size() -1;
+  m_offset = size;
+  m_allocatedSize += size;
+  return m_chunks[ m_chunkIndex ];
+}
+
+
+void 
+PropertyArena::reset()
+{
+  m_chunkIndex = 0;
+  m_offset = 0;
+  m_allocatedSize = 0;
+}
+
+
+size_t 
+PropertyArena::allocatedSize() const
+{
+  return m_allocatedSize;
+}
+
+
+size_t 
+PropertyArena::capacity() const
+{
+  size_t capacity = 0;
+  for ( unsigned int index =0; index < m_chunkSizes.size(); ++index )
+    capacity += m_chunkSizes[ index ];
+  return capacity;
+}
+
+
+
+PropertyCase::PropertyCase()
+    : m_replaying( false )
+    , m_noting( false )
+    , m_replayPosition( 0 )
+{
+}
+
+
+PropertyCase::~PropertyCase()
+{
+}
+
+
+/// Returns a uniform value in [0, \a maximum].
+static unsigned long
+drawUniformChoice( Random &random,
+                   unsigned long maximum )
+{
+  if ( maximum == 0xffffffffUL )
+    return random.nextUInt32();
+  if ( maximum < 0xffffffffUL )
+  {
+    // Rejects the values that would bias the modulo.
+    unsigned long bucketCount = maximum +1;
+    unsigned long limit = 0xffffffffUL - (0xffffffffUL % bucketCount);
+    unsigned long value;
+    do
+    {
+      value = random.nextUInt32();
+    }
+    while ( value >= limit );
+    return value % bucketCount;
+  }
+
+  // unsigned long has more than 32 bits.
+  unsigned long value;
+  do
+  {
+    value = ((unsigned long)random.nextUInt32() << 16 << 16) | random.nextUInt32();
+  }
+  while ( maximum != ULONG_MAX  &&  
+          value >= ULONG_MAX - ULONG_MAX % (maximum +1) );
+  return maximum == ULONG_MAX ? value : value % (maximum +1);
+}
+
+
+unsigned long 
+PropertyCase::drawChoice( unsigned long maximum )
+{
+  unsigned long choice;
+  if ( m_replaying )
+  {
+    choice = m_replayPosition < m_replayedChoices.size() 
+                 ? m_replayedChoices[ m_replayPosition++ ] 
+                 : 0;
+    if ( choice > maximum )
+      choice = maximum;
+  }
+  else
+  {
+    // One case out of 16 draws a bound.
+    unsigned int bias = m_random.nextUInt32() & 0x1f;
+    if ( bias == 0 )
+      choice = 0;
+    else if ( bias == 1 )
+      choice = maximum;
+    else
+      choice = drawUniformChoice( m_random, maximum );
+  }
+
+  m_choices.push_back( choice );
+  return choice;
+}
+
+
+bool 
+PropertyCase::drawBoolean( double probability )
+{
+  unsigned long choice;
+  if ( m_replaying )
+  {
+    choice = m_replayPosition < m_replayedChoices.size() 
+                 ? m_replayedChoices[ m_replayPosition++ ] 
+                 : 0;
+    if ( choice > 1 )
+      choice = 1;
+  }
+  else
+    choice = m_random.nextDouble() < probability ? 1 : 0;
+
+  m_choices.push_back( choice );
+  return choice != 0;
+}
+
+
+PropertyArena &
+PropertyCase::arena()
+{
+  return m_arena;
+}
+
+
+bool 
+PropertyCase::isNoting() const
+{
+  return m_noting;
+}
+
+
+void 
+PropertyCase::note( const std::string &value )
+{
+  m_notes.push_back( value );
+}
+
+
+void 
+PropertyCase::start()
+{
+  m_choices.clear();
+  m_notes.clear();
+  m_arena.reset();
+}
+
+
+void 
+PropertyCase::startGeneration( unsigned int seed )
+{
+  start();
+  m_random.seed( seed );
+  m_replaying = false;
+  m_noting = false;
+}
+
+
+void 
+PropertyCase::startReplay( const Choices &choices,
+                           bool noting )
+{
+  start();
+  m_replayedChoices = choices;
+  m_replayPosition = 0;
+  m_replaying = true;
+  m_noting = noting;
+}
+
+
+const PropertyCase::Choices &
+PropertyCase::choices() const
+{
+  return m_choices;
+}
+
+
+const CppUnitVector<std::string> &
+PropertyCase::notes() const
+{
+  return m_notes;
+}
+
+
+
+/// Runs a property on a case. Returns \c false and the failure if it failed.
+static bool
+checkPropertyCase( PropertyFunction &property,
+                   PropertyCase &propertyCase,
+                   Message *failure = NULL,
+                   SourceLine *failureLine = NULL )
+{
+  Message message;
+  SourceLine sourceLine;
+  try
+  {
+    property.check( propertyCase );
+    return true;
+  }
+  catch ( Exception &e )
+  {
+    message = e.message();
+    sourceLine = e.sourceLine();
+  }
+  catch ( std::exception &e )
+  {
+    message = Message( "uncaught exception of type std::exception (or derived).",
+                       e.what() );
+  }
+  catch ( ... )
+  {
+    message = Message( "uncaught exception of unknown type" );
+  }
+
+  if ( failure != NULL )
+    *failure = message;
+  if ( failureLine != NULL )
+    *failureLine = sourceLine;
+  return false;
+}
+
+
+/// Tests if choices are simpler than other choices (shorter, then smaller).
+static bool
+isSimplerChoices( const PropertyCase::Choices &choices,
+                  const PropertyCase::Choices &other )
+{
+  if ( choices.size() != other.size() )
+    return choices.size() < other.size();
+  for ( unsigned int index =0; index < choices.size(); ++index )
+  {
+    if ( choices[ index ] != other[ index ] )
+      return choices[ index ] < other[ index ];
+  }
+  return false;
+}
+
+
+/*! Replays \a candidate, and replaces \a choices by the choices it drew if the
+ *  property still fails and they are simpler.
+ */
+static bool
+tryShrinkChoices( PropertyFunction &property,
+                  PropertyCase &propertyCase,
+                  const PropertyCase::Choices &candidate,
+                  PropertyCase::Choices &choices )
+{
+  propertyCase.startReplay( candidate );
+  if ( checkPropertyCase( property, propertyCase )  ||
+       !isSimplerChoices( propertyCase.choices(), choices ) )
+    return false;
+  choices = propertyCase.choices();
+  return true;
+}
+
+
+/// Runs the cases of a batch, and keeps the first failing case of each thread.
+class PropertyBatchTask : public ThreadTask
+{
+public:
+  PropertyBatchTask( PropertyFunction &property,
+                     unsigned int seed,
+                     int threadCount )
+      : m_property( property )
+      , m_seed( seed )
+      , m_threadCount( threadCount )
+      , m_firstCase( 0 )
+      , m_endCase( 0 )
+      , m_cases( threadCount )
+      , m_failedCases( threadCount, -1 )
+      , m_failedChoices( threadCount )
+  {
+    for ( int index =0; index < threadCount; ++index )
+      m_cases[ index ] = new PropertyCase();
+  }
+
+  ~PropertyBatchTask()
+  {
+    for ( int index =0; index < m_threadCount; ++index )
+      delete m_cases[ index ];
+  }
+
+  void setBatch( int firstCase, 
+                 int endCase )
+  {
+    m_firstCase = firstCase;
+    m_endCase = endCase;
+  }
+
+  void run( int threadIndex )
+  {
+    PropertyCase &propertyCase = *m_cases[ threadIndex ];
+    for ( int caseIndex = m_firstCase + threadIndex; 
+          caseIndex < m_endCase; 
+          caseIndex += m_threadCount )
+    {
+      propertyCase.startGeneration( Random::mix( m_seed, caseIndex ) );
+      if ( !checkPropertyCase( m_property, propertyCase ) )
+      {
+        m_failedCases[ threadIndex ] = caseIndex;
+        m_failedChoices[ threadIndex ] = propertyCase.choices();
+        return;
+      }
+    }
+  }
+
+  /// Returns the index of the first failing case, -1 if none failed.
+  int firstFailedCase( PropertyCase::Choices &choices ) const
+  {
+    int firstThread = -1;
+    for ( int threadIndex =0; threadIndex < m_threadCount; ++threadIndex )
+    {
+      if ( m_failedCases[ threadIndex ] < 0 )
+        continue;
+      if ( firstThread < 0  ||  
+           m_failedCases[ threadIndex ] < m_failedCases[ firstThread ] )
+        firstThread = threadIndex;
+    }
+
+    if ( firstThread < 0 )
+      return -1;
+    choices = m_failedChoices[ firstThread ];
+    return m_failedCases[ firstThread ];
+  }
+
+private:
+  /// Prevents the use of the copy constructor.
+  PropertyBatchTask( const PropertyBatchTask &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const PropertyBatchTask &other );
+
+private:
+  PropertyFunction &m_property;
+  unsigned int m_seed;
+  int m_threadCount;
+  int m_firstCase;
+  int m_endCase;
+  CppUnitVector<PropertyCase *> m_cases;
+  CppUnitVector<int> m_failedCases;
+  CppUnitVector<PropertyCase::Choices> m_failedChoices;
+};
+
+
+
+PropertyRunner::PropertyRunner( int caseCount )
+    : m_caseCount( caseCount )
+    , m_threadCount( ThreadGroup::processorCount() )
+    , m_batchSize( 256 )
+    , m_seed( Random::defaultSeed() )
+    , m_maximumShrinkRuns( 5000 )
+{
+}
+
+
+PropertyRunner::~PropertyRunner()
+{
+}
+
+
+void 
+PropertyRunner::setCaseCount( int caseCount )
+{
+  m_caseCount = caseCount;
+}
+
+
+int 
+PropertyRunner::caseCount() const
+{
+  return m_caseCount;
+}
+
+
+void 
+PropertyRunner::setThreadCount( int threadCount )
+{
+  m_threadCount = threadCount > 0 ? threadCount : 1;
+}
+
+
+int 
+PropertyRunner::threadCount() const
+{
+  return m_threadCount;
+}
+
+
+void 
+PropertyRunner::setBatchSize( int batchSize )
+{
+  m_batchSize = batchSize > 0 ? batchSize : 1;
+}
+
+
+int 
+PropertyRunner::batchSize() const
+{
+  return m_batchSize;
+}
+
+
+void 
+PropertyRunner::setSeed( unsigned int seed )
+{
+  m_seed = seed;
+}
+
+
+unsigned int 
+PropertyRunner::seed() const
+{
+  return m_seed;
+}
+
+
+void 
+PropertyRunner::setMaximumShrinkRuns( int maximumShrinkRuns )
+{
+  m_maximumShrinkRuns = maximumShrinkRuns;
+}
+
+
+int 
+PropertyRunner::maximumShrinkRuns() const
+{
+  return m_maximumShrinkRuns;
+}
+
+
+void 
+PropertyRunner::run( PropertyFunction &property,
+                     const SourceLine &sourceLine )
+{
+  int threadCount = m_threadCount < m_batchSize ? m_threadCount : m_batchSize;
+  PropertyBatchTask task( property, m_seed, threadCount );
+  for ( int firstCase =0; firstCase < m_caseCount; firstCase += m_batchSize )
+  {
+    int endCase = firstCase + m_batchSize;
+    if ( endCase > m_caseCount )
+      endCase = m_caseCount;
+    task.setBatch( firstCase, endCase );
+    ThreadGroup::run( task, threadCount );
+
+    PropertyCase::Choices choices;
+    int failedCase = task.firstFailedCase( choices );
+    if ( failedCase < 0 )
+      continue;
+
+    int shrinkRuns = shrink( property, choices );
+
+    PropertyCase counterexample;
+    counterexample.startReplay( choices, true );
+    Message failure;
+    SourceLine failureLine;
+    checkPropertyCase( property, counterexample, &failure, &failureLine );
+
+    OStringStream seed;
+    seed << m_seed;
+    Message message( "property falsified",
+                     "Falsified after " + StringTools::toString( failedCase +1 ) +
+                     " cases, shrunk in " + StringTools::toString( shrinkRuns ) + 
+                     " runs" );
+    const CppUnitVector<std::string> &notes = counterexample.notes();
+    for ( unsigned int index =0; index < notes.size(); ++index )
+      message.addDetail( "Drawn: " + notes[ index ] );
+    message.addDetail( "Failure: " + failure.shortDescription() );
+    for ( int detailIndex =0; detailIndex < failure.detailCount(); ++detailIndex )
+      message.addDetail( failure.detailAt( detailIndex ) );
+    message.addDetail( "Seed: " + seed.str() + ", case " + 
+                       StringTools::toString( failedCase ) + 
+                       " (replay with CPPUNIT_SEED=" + seed.str() + ")" );
+    Asserter::fail( message, failureLine.isValid() ? failureLine : sourceLine );
+  }
+}
+
+
+int 
+PropertyRunner::shrink( PropertyFunction &property,
+                        PropertyCase::Choices &choices ) const
+{
+  PropertyCase propertyCase;
+  int runCount = 0;
+
+  bool improved = true;
+  while ( improved  &&  runCount < m_maximumShrinkRuns )
+  {
+    improved = false;
+
+    // Removes blocks of choices, largest first.
+    for ( unsigned int blockSize = 8; blockSize > 0; blockSize /= 2 )
+    {
+      for ( unsigned int end = choices.size(); 
+            end >= blockSize  &&  runCount < m_maximumShrinkRuns; 
+            --end )
+      {
+        if ( end > choices.size() )
+          continue;
+        PropertyCase::Choices candidate( choices.begin(), 
+                                         choices.begin() + (end - blockSize) );
+        candidate.insert( candidate.end(), choices.begin() + end, choices.end() );
+        ++runCount;
+        if ( tryShrinkChoices( property, propertyCase, candidate, choices ) )
+          improved = true;
+      }
+    }
+
+    // Minimizes each choice: tries 0, then searches the smallest failing value.
+    for ( unsigned int index =0; 
+          index < choices.size()  &&  runCount < m_maximumShrinkRuns; 
+          ++index )
+    {
+      if ( choices[ index ] == 0 )
+        continue;
+
+      PropertyCase::Choices candidate( choices );
+      candidate[ index ] = 0;
+      ++runCount;
+      if ( tryShrinkChoices( property, propertyCase, candidate, choices ) )
+      {
+        improved = true;
+        continue;
+      }
+
+      unsigned long passing = 0;
+      while ( index < choices.size()  &&  
+              passing +1 < choices[ index ]  &&  
+              runCount < m_maximumShrinkRuns )
+      {
+        candidate = choices;
+        candidate[ index ] = passing + (choices[ index ] - passing) / 2;
+        ++runCount;
+        if ( tryShrinkChoices( property, propertyCase, candidate, choices ) )
+          improved = true;
+        else
+          passing = candidate[ index ];
+      }
+    }
+  }
+
+  return runCount;
+}
+
+
+CPPUNIT_NS_END
@@ -0,0 +1,121 @@
+#include <cppunit/tools/Clock.h>
+#include <cppunit/tools/Random.h>
+#include <stdlib.h>
+#include <time.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Mask used to keep the state on 32 bits where unsigned int is larger.
+static const unsigned int randomWordMask = 0xffffffffU;
+
+
+Random::Random( unsigned int seed )
+{
+  this->seed( seed );
+}
+
+
+void 
+Random::seed( unsigned int seed )
+{
+  // The state must not be all zero: derive it from the seed.
+  for ( unsigned int index =0; index < 4; ++index )
+    m_state[ index ] = mix( seed, index );
+}
+
+
+unsigned int 
+Random::nextUInt32()
+{
+  unsigned int t = m_state[3];
+  unsigned int s = m_state[0];
+  m_state[3] = m_state[2];
+  m_state[2] = m_state[1];
+  m_state[1] = s;
+
+  t ^= (t << 11) & randomWordMask;
+  t ^= t >> 8;
+  m_state[0] = (t ^ s ^ (s >> 19)) & randomWordMask;
+  return m_state[0];
+}
+
+
+int 
+Random::nextInt( int minimum, 
+                 int maximum )
+{
+  if ( maximum <= minimum )
+    return minimum;
+
+  // Computed modulo 2^32 so that the full int range does not overflow.
+  unsigned int range = ((unsigned int)maximum - (unsigned int)minimum) 
+                       & randomWordMask;
+  if ( range == randomWordMask )
+    return (int)nextUInt32();
+
+  // Rejects the values that would bias the modulo.
+  unsigned int bucketCount = range +1;
+  unsigned int limit = randomWordMask - (randomWordMask % bucketCount);
+  unsigned int value;
+  do
+  {
+    value = nextUInt32();
+  }
+  while ( value >= limit );
+  return (int)((unsigned int)minimum + value % bucketCount);
+}
+
+
+double 
+Random::nextDouble()
+{
+  // 53 bits of randomness.
+  double high = nextUInt32() >> 5;
+  double low = nextUInt32() >> 6;
+  return (high * 67108864.0 + low) / 9007199254740992.0;
+}
+
+
+double 
+Random::nextDouble( double minimum, 
+                    double maximum )
+{
+  return minimum + (maximum - minimum) * nextDouble();
+}
+
+
+bool 
+Random::nextBool()
+{
+  return (nextUInt32() & 0x80000000U) != 0;
+}
+
+
+unsigned int 
+Random::mix( unsigned int seed, 
+             unsigned int index )
+{
+  // Murmur3 finalizer on the combined value.
+  unsigned int hash = (seed ^ (index * 0x9e3779b9U)) & randomWordMask;
+  hash = ((hash ^ (hash >> 16)) * 0x85ebca6bU) & randomWordMask;
+  hash = ((hash ^ (hash >> 13)) * 0xc2b2ae35U) & randomWordMask;
+  hash ^= hash >> 16;
+  return hash != 0 ? hash : 0x6a09e667U;
+}
+
+
+unsigned int 
+Random::defaultSeed()
+{
+  const char *seed = getenv( "CPPUNIT_SEED" );
+  if ( seed != NULL  &&  *seed != 0 )
+    return (unsigned int)strtoul( seed, NULL, 0 );
+
+  return mix( (unsigned int)time( NULL ), 
+              (unsigned int)(Clock::now() * 1e6) );
+}
+
+
+CPPUNIT_NS_END
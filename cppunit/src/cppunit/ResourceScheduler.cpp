@@ -0,0 +1,394 @@
+#include <cppunit/Test.h>
+#include <cppunit/extensions/ResourceScheduler.h>
+#include <cppunit/portability/CppUnitMap.h>
+#include <cppunit/tools/StringTools.h>
+#include <algorithm>
+#include <stdexcept>
+#include <stdlib.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+TestResources::TestResources()
+    : m_cpuWeight( 1 )
+    , m_hasCpuWeight( false )
+{
+}
+
+
+TestResources
+TestResources::parse( const std::string &declaration )
+{
+  TestResources resources;
+  StringTools::Strings tags = StringTools::split( declaration, ',' );
+  for ( StringTools::Strings::const_iterator it = tags.begin();
+        it != tags.end();
+        ++it )
+  {
+    std::string tag = StringTools::trim( *it );
+    if ( tag.empty() )
+      continue;
+
+    std::string::size_type separatorIndex = tag.find( ':' );
+    if ( separatorIndex == std::string::npos )
+      throw std::invalid_argument( "Missing ':' in resource tag <" + tag + ">." );
+
+    std::string kind = tag.substr( 0, separatorIndex );
+    std::string value = tag.substr( separatorIndex +1 );
+    if ( value.empty() )
+      throw std::invalid_argument( "Missing value in resource tag <" + tag + ">." );
+
+    if ( kind == "exclusive" )
+      resources.addExclusiveResource( value );
+    else if ( kind == "cpu" )
+    {
+      int weight = atoi( value.c_str() );
+      if ( weight <= 0 )
+        throw std::invalid_argument( "Invalid CPU weight in resource tag <" +
+                                     tag + ">." );
+      resources.setCpuWeight( weight );
+    }
+    else
+      throw std::invalid_argument( "Unknown resource kind in resource tag <" +
+                                   tag + ">." );
+  }
+
+  return resources;
+}
+
+
+void
+TestResources::merge( const TestResources &other )
+{
+  for ( Resources::const_iterator it = other.m_exclusiveResources.begin();
+        it != other.m_exclusiveResources.end();
+        ++it )
+    addExclusiveResource( *it );
+
+  if ( other.m_hasCpuWeight )
+    setCpuWeight( other.m_cpuWeight );
+}
+
+
+void
+TestResources::addExclusiveResource( const std::string &resource )
+{
+  if ( !usesExclusiveResource( resource ) )
+    m_exclusiveResources.push_back( resource );
+}
+
+
+bool
+TestResources::usesExclusiveResource( const std::string &resource ) const
+{
+  for ( Resources::const_iterator it = m_exclusiveResources.begin();
+        it != m_exclusiveResources.end();
+        ++it )
+  {
+    if ( *it == resource )
+      return true;
+  }
+  return false;
+}
+
+
+const TestResources::Resources &
+TestResources::exclusiveResources() const
+{
+  return m_exclusiveResources;
+}
+
+
+void
+TestResources::setCpuWeight( int weight )
+{
+  m_cpuWeight = weight;
+  m_hasCpuWeight = true;
+}
+
+
+int
+TestResources::cpuWeight() const
+{
+  return m_cpuWeight;
+}
+
+
+bool
+TestResources::conflictsWith( const TestResources &other ) const
+{
+  for ( Resources::const_iterator it = m_exclusiveResources.begin();
+        it != m_exclusiveResources.end();
+        ++it )
+  {
+    if ( other.usesExclusiveResource( *it ) )
+      return true;
+  }
+  return false;
+}
+
+
+
+/*! Adds the resources of the descendants of a test run as a whole: all
+ *  their exclusive resources, and the largest of their CPU weights.
+ */
+static void
+mergeDescendantResources( Test *test,
+                          TestResources &resources )
+{
+  for ( int childIndex =0; childIndex < test->getChildTestCount(); ++childIndex )
+  {
+    Test *child = test->getChildTestAt( childIndex );
+    if ( child->hasProperty( "resources" ) )
+    {
+      TestResources childResources =
+          TestResources::parse( child->getProperty( "resources" ) );
+      const TestResources::Resources &exclusiveResources =
+          childResources.exclusiveResources();
+      for ( TestResources::Resources::const_iterator it = exclusiveResources.begin();
+            it != exclusiveResources.end();
+            ++it )
+        resources.addExclusiveResource( *it );
+      if ( childResources.cpuWeight() > resources.cpuWeight() )
+        resources.setCpuWeight( childResources.cpuWeight() );
+    }
+    mergeDescendantResources( child, resources );
+  }
+}
+
+
+
+ResourceScheduler::ResourceScheduler( int cpuCount )
+    : m_cpuCount( cpuCount > 0 ? cpuCount : 1 )
+{
+}
+
+
+ResourceScheduler::~ResourceScheduler()
+{
+}
+
+
+void
+ResourceScheduler::addTest( Test *test )
+{
+  addTest( test, TestResources() );
+}
+
+
+void
+ResourceScheduler::addTest( Test *test,
+                            const TestResources &inheritedResources )
+{
+  TestResources resources( inheritedResources );
+  if ( test->hasProperty( "resources" ) )
+    resources.merge( TestResources::parse( test->getProperty( "resources" ) ) );
+
+  int childCount = test->getChildTestCount();
+  if ( childCount == 0  ||  !test->canRunChildTestsSeparately() )
+  {
+    mergeDescendantResources( test, resources );
+    m_tests.push_back( test );
+    m_resources.push_back( resources );
+    scheduleTest( m_tests.size() -1 );
+    return;
+  }
+
+  for ( int childIndex =0; childIndex < childCount; ++childIndex )
+    addTest( test->getChildTestAt( childIndex ), resources );
+}
+
+
+void
+ResourceScheduler::scheduleTest( int testIndex )
+{
+  for ( unsigned int batchIndex =0; batchIndex < m_batches.size(); ++batchIndex )
+  {
+    Batch &batch = m_batches[ batchIndex ];
+    if ( canAddToBatch( batch, testIndex ) )
+    {
+      batch.m_tests.push_back( m_tests[ testIndex ] );
+      batch.m_testIndexes.push_back( testIndex );
+      batch.m_cpuWeight += m_resources[ testIndex ].cpuWeight();
+      return;
+    }
+  }
+
+  Batch batch;
+  batch.m_tests.push_back( m_tests[ testIndex ] );
+  batch.m_testIndexes.push_back( testIndex );
+  batch.m_cpuWeight = m_resources[ testIndex ].cpuWeight();
+  m_batches.push_back( batch );
+}
+
+
+bool
+ResourceScheduler::canAddToBatch( const Batch &batch,
+                                  int testIndex ) const
+{
+  const TestResources &resources = m_resources[ testIndex ];
+  if ( batch.m_cpuWeight + resources.cpuWeight() > m_cpuCount )
+    return false;
+
+  for ( CppUnitVector<int>::const_iterator it = batch.m_testIndexes.begin();
+        it != batch.m_testIndexes.end();
+        ++it )
+  {
+    if ( resources.conflictsWith( m_resources[ *it ] ) )
+      return false;
+  }
+
+  return true;
+}
+
+
+int
+ResourceScheduler::cpuCount() const
+{
+  return m_cpuCount;
+}
+
+
+int
+ResourceScheduler::getTestCount() const
+{
+  return m_tests.size();
+}
+
+
+Test *
+ResourceScheduler::getTestAt( int index ) const
+{
+  return m_tests[ index ];
+}
+
+
+const TestResources &
+ResourceScheduler::getResourcesAt( int index ) const
+{
+  return m_resources[ index ];
+}
+
+
+int
+ResourceScheduler::getBatchCount() const
+{
+  return m_batches.size();
+}
+
+
+const ResourceScheduler::Tests &
+ResourceScheduler::getBatchAt( int index ) const
+{
+  return m_batches[ index ].m_tests;
+}
+
+
+/// Returns the representative of the group of the specified test (union-find).
+static int
+findResourceGroup( CppUnitVector<int> &groups,
+                   int testIndex )
+{
+  while ( groups[ testIndex ] != testIndex )
+  {
+    groups[ testIndex ] = groups[ groups[ testIndex ] ];
+    testIndex = groups[ testIndex ];
+  }
+  return testIndex;
+}
+
+
+/// Orders groups by decreasing CPU weight.
+struct HeavierGroup
+{
+  HeavierGroup( const CppUnitVector<int> &weights )
+      : m_weights( weights )
+  {
+  }
+
+  bool operator()( int group1, int group2 ) const
+  {
+    return m_weights[ group1 ] > m_weights[ group2 ];
+  }
+
+  const CppUnitVector<int> &m_weights;
+};
+
+
+CppUnitVector<ResourceScheduler::Tests>
+ResourceScheduler::makeShards( int shardCount ) const
+{
+  if ( shardCount < 1 )
+    shardCount = 1;
+
+  // Groups the tests that share an exclusive resource.
+  int testCount = m_tests.size();
+  CppUnitVector<int> groups( testCount );
+  for ( int testIndex =0; testIndex < testCount; ++testIndex )
+    groups[ testIndex ] = testIndex;
+
+  typedef CppUnitMap<std::string, int, std::less<std::string> > ResourceOwners;
+  ResourceOwners owners;
+  for ( int index =0; index < testCount; ++index )
+  {
+    const TestResources::Resources &resources =
+        m_resources[ index ].exclusiveResources();
+    for ( TestResources::Resources::const_iterator it = resources.begin();
+          it != resources.end();
+          ++it )
+    {
+      ResourceOwners::iterator itOwner = owners.find( *it );
+      if ( itOwner == owners.end() )
+        owners.insert( ResourceOwners::value_type( *it, index ) );
+      else
+        groups[ findResourceGroup( groups, index ) ] =
+            findResourceGroup( groups, (*itOwner).second );
+    }
+  }
+
+  CppUnitVector<int> groupWeights( testCount, 0 );
+  for ( int weightIndex =0; weightIndex < testCount; ++weightIndex )
+    groupWeights[ findResourceGroup( groups, weightIndex ) ] +=
+        m_resources[ weightIndex ].cpuWeight();
+
+  // Assigns the heaviest group first to the least loaded shard.
+  CppUnitVector<int> sortedGroups;
+  for ( int group =0; group < testCount; ++group )
+  {
+    if ( findResourceGroup( groups, group ) == group )
+      sortedGroups.push_back( group );
+  }
+  std::stable_sort( sortedGroups.begin(), 
+                    sortedGroups.end(), 
+                    HeavierGroup( groupWeights ) );
+
+  CppUnitVector<int> groupShards( testCount, 0 );
+  CppUnitVector<int> shardWeights( shardCount, 0 );
+  for ( CppUnitVector<int>::const_iterator it = sortedGroups.begin();
+        it != sortedGroups.end();
+        ++it )
+  {
+    int lightestShard = 0;
+    for ( int shard =1; shard < shardCount; ++shard )
+    {
+      if ( shardWeights[ shard ] < shardWeights[ lightestShard ] )
+        lightestShard = shard;
+    }
+
+    groupShards[ *it ] = lightestShard;
+    shardWeights[ lightestShard ] += groupWeights[ *it ];
+  }
+
+  CppUnitVector<Tests> shards( shardCount );
+  for ( int shardIndex =0; shardIndex < testCount; ++shardIndex )
+  {
+    int shard = groupShards[ findResourceGroup( groups, shardIndex ) ];
+    shards[ shard ].push_back( m_tests[ shardIndex ] );
+  }
+
+  return shards;
+}
+
+
+CPPUNIT_NS_END
@@ -0,0 +1,66 @@
+#include <cppunit/Message.h>
+#include <cppunit/ScopedTrace.h>
+#include <cppunit/portability/CppUnitVector.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Innermost trace context of the thread.
+static CPPUNIT_THREAD_LOCAL TraceContext *innermostTraceContext = NULL;
+
+
+TraceContext::TraceContext()
+    : m_previous( innermostTraceContext )
+{
+  innermostTraceContext = this;
+}
+
+
+TraceContext::TraceContext( const TraceContext & )
+    : m_previous( innermostTraceContext )
+{
+  innermostTraceContext = this;
+}
+
+
+TraceContext::~TraceContext()
+{
+  // Usually the innermost one, unless a copy was made after it.
+  TraceContext **link = &innermostTraceContext;
+  while ( *link != NULL  &&  *link != this )
+    link = &(*link)->m_previous;
+  if ( *link == this )
+    *link = m_previous;
+}
+
+
+void
+TraceContext::addDetails( Message &message )
+{
+  CppUnitVector<const TraceContext *> contexts;
+  for ( const TraceContext *context = innermostTraceContext;
+        context != NULL;
+        context = context->m_previous )
+    contexts.push_back( context );
+
+  for ( int index = contexts.size() -1; index >= 0; --index )
+    message.addDetail( "Trace: " + contexts[ index ]->describe() );
+}
+
+
+TraceContext *
+TraceContext::current()
+{
+  return innermostTraceContext;
+}
+
+
+void
+TraceContext::unwindTo( TraceContext *context )
+{
+  innermostTraceContext = context;
+}
+
+
+CPPUNIT_NS_END
@@ -0,0 +1,434 @@
+#include <cppunit/Asserter.h>
+#include <cppunit/extensions/Snapshot.h>
+#include <cppunit/portability/Stream.h>
+#include <cppunit/tools/MappedFile.h>
+#include <cppunit/tools/ThreadGroup.h>
+#include <errno.h>
+#include <stdexcept>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(CPPUNIT_HAVE_SYS_STAT_H)
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+#if defined(CPPUNIT_HAVE_UNISTD_H)
+#include <unistd.h>
+#endif
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Size of the blocks compared with memcmp() before looking for the byte.
+static const size_t snapshotCompareBlockSize = 4096;
+
+/// Maximum number of context lines shown before and after a difference.
+static const int snapshotContextLines = 2;
+
+/// Maximum number of characters shown for a line.
+static const size_t snapshotMaximumLineLength = 120;
+
+/// Number of bytes shown in a hexadecimal dump.
+static const size_t snapshotDumpSize = 16;
+
+
+/// Serializes the attribution of unique temporary file names.
+static ThreadMutex &
+snapshotWriteMutex()
+{
+  static ThreadMutex mutex;
+  return mutex;
+}
+
+
+/// Tests if a buffer looks like binary data (contains a NUL byte).
+static bool
+isBinarySnapshot( const unsigned char *data,
+                  size_t size )
+{
+  return memchr( data, 0, size ) != NULL;
+}
+
+
+/// Returns the offset of the start of the line containing \a offset.
+static size_t
+findSnapshotLineStart( const unsigned char *data,
+                       size_t offset )
+{
+  while ( offset > 0  &&  data[ offset -1 ] != '\n' )
+    --offset;
+  return offset;
+}
+
+
+/*! Adds the lines [\a firstLine, \a firstLine + \a lineCount[ of \a data,
+ *  starting at \a lineStart, to \a message.
+ */
+static void
+addSnapshotLines( Message &message,
+                  const std::string &label,
+                  const unsigned char *data,
+                  size_t size,
+                  size_t lineStart,
+                  int firstLine,
+                  int lineCount )
+{
+  for ( int line = firstLine; line < firstLine + lineCount; ++line )
+  {
+    if ( lineStart >= size )
+      break;
+
+    const unsigned char *end = 
+        CPPUNIT_STATIC_CAST( const unsigned char *, memchr( data + lineStart, 
+                                                            '\n', 
+                                                            size - lineStart ) );
+    size_t lineEnd = end != NULL ? end - data : size;
+    size_t length = lineEnd - lineStart;
+    std::string text( CPPUNIT_REINTERPRET_CAST( const char *, data + lineStart ), 
+                      length < snapshotMaximumLineLength 
+                          ? length 
+                          : snapshotMaximumLineLength );
+    if ( length > snapshotMaximumLineLength )
+      text += "...";
+
+    OStringStream detail;
+    detail << label << " line " << line << ": " << text;
+    message.addDetail( detail.str() );
+    lineStart = lineEnd +1;
+  }
+}
+
+
+/// Adds a hexadecimal dump of the bytes around \a offset to \a message.
+static void
+addSnapshotDump( Message &message,
+                 const std::string &label,
+                 const unsigned char *data,
+                 size_t size,
+                 size_t offset )
+{
+  static const char digits[] = "0123456789abcdef";
+  size_t start = offset - offset % snapshotDumpSize;
+
+  OStringStream detail;
+  detail << label << " at 0x" << std::hex << start << ":";
+  for ( size_t index = start; index < start + snapshotDumpSize  &&  index < size; 
+        ++index )
+    detail << ' ' << digits[ data[ index ] >> 4 ] << digits[ data[ index ] & 15 ];
+  message.addDetail( detail.str() );
+}
+
+
+/// Describes the first difference between the golden file and the actual data.
+static void
+describeSnapshotMismatch( Message &message,
+                          const unsigned char *expected,
+                          size_t expectedSize,
+                          const unsigned char *actual,
+                          size_t actualSize )
+{
+  size_t commonSize = expectedSize < actualSize ? expectedSize : actualSize;
+  size_t offset = SnapshotStore::findFirstDifference( expected, actual, commonSize );
+
+  OStringStream sizes;
+  sizes << "Expected " << expectedSize << " bytes, actual " << actualSize 
+        << " bytes";
+  message.addDetail( sizes.str() );
+
+  if ( isBinarySnapshot( expected, expectedSize )  ||  
+       isBinarySnapshot( actual, actualSize ) )
+  {
+    OStringStream position;
+    position << "First difference at byte " << offset;
+    message.addDetail( position.str() );
+    addSnapshotDump( message, "Expected", expected, expectedSize, offset );
+    addSnapshotDump( message, "Actual  ", actual, actualSize, offset );
+    return;
+  }
+
+  int line = 1;
+  const unsigned char *current = expected;
+  const unsigned char *differenceStart = expected + offset;
+  while ( (current = CPPUNIT_STATIC_CAST( const unsigned char *, 
+               memchr( current, '\n', differenceStart - current ) )) != NULL )
+  {
+    ++line;
+    ++current;
+  }
+  size_t lineStart = findSnapshotLineStart( expected, offset );
+
+  OStringStream position;
+  position << "First difference at byte " << offset << ", line " << line
+           << ", column " << (offset - lineStart +1);
+  message.addDetail( position.str() );
+
+  // Moves back to the first context line. The lines before the difference
+  // are the same in both buffers.
+  int firstLine = line;
+  while ( firstLine > 1  &&  firstLine > line - snapshotContextLines )
+  {
+    lineStart = findSnapshotLineStart( expected, lineStart -1 );
+    --firstLine;
+  }
+
+  int lineCount = line - firstLine + snapshotContextLines +1;
+  addSnapshotLines( message, "Expected", expected, expectedSize, 
+                    lineStart, firstLine, lineCount );
+  addSnapshotLines( message, "Actual  ", actual, actualSize, 
+                    lineStart, firstLine, lineCount );
+}
+
+
+/*! Tests if the file \a path exists. Errors other than a missing file or
+ *  directory are left to the opening of the file to report.
+ */
+static bool
+snapshotExists( const std::string &path )
+{
+#if defined(CPPUNIT_HAVE_SYS_STAT_H)
+  struct stat status;
+  if ( ::stat( path.c_str(), &status ) == 0 )
+    return true;
+#else
+  FILE *file = fopen( path.c_str(), "rb" );
+  if ( file != NULL )
+  {
+    fclose( file );
+    return true;
+  }
+#endif
+  return errno != ENOENT  &&  errno != ENOTDIR;
+}
+
+
+/// Creates the parent directories of \a path.
+static void
+makeSnapshotDirectories( const std::string &path )
+{
+#if defined(CPPUNIT_HAVE_SYS_STAT_H)
+  std::string::size_type separatorIndex = 0;
+  while ( (separatorIndex = path.find( '/', separatorIndex +1 )) 
+              != std::string::npos )
+    ::mkdir( path.substr( 0, separatorIndex ).c_str(), 0777 );
+#endif
+}
+
+
+
+SnapshotStore::SnapshotStore( const std::string &directory )
+    : m_directory( directory )
+    , m_updateMode( false )
+{
+  const char *updateMode = getenv( "CPPUNIT_UPDATE_SNAPSHOTS" );
+  if ( updateMode != NULL  &&  *updateMode != 0  &&  strcmp( updateMode, "0" ) != 0 )
+    m_updateMode = true;
+}
+
+
+SnapshotStore::~SnapshotStore()
+{
+}
+
+
+SnapshotStore &
+SnapshotStore::getStore()
+{
+  static SnapshotStore store;
+  return store;
+}
+
+
+void 
+SnapshotStore::setDirectory( const std::string &directory )
+{
+  m_directory = directory;
+}
+
+
+std::string 
+SnapshotStore::directory() const
+{
+  return m_directory;
+}
+
+
+void 
+SnapshotStore::setUpdateMode( bool updateMode )
+{
+  m_updateMode = updateMode;
+}
+
+
+bool 
+SnapshotStore::isUpdateMode() const
+{
+  return m_updateMode;
+}
+
+
+std::string 
+SnapshotStore::pathFor( const std::string &name ) const
+{
+  if ( m_directory.empty() )
+    return name;
+  return m_directory + "/" + name;
+}
+
+
+bool 
+SnapshotStore::check( const std::string &name,
+                      const void *data,
+                      size_t size,
+                      Message &failure ) const
+{
+  const unsigned char *actual = CPPUNIT_STATIC_CAST( const unsigned char *, data );
+  std::string path = pathFor( name );
+
+  if ( !snapshotExists( path ) )
+  {
+    if ( m_updateMode )
+    {
+      write( name, data, size );
+      return true;
+    }
+
+    failure = Message( "snapshot not found",
+                       "Snapshot: " + path,
+                       "Run with --update-snapshots (or CPPUNIT_UPDATE_SNAPSHOTS=1)"
+                       " to create it" );
+    return false;
+  }
+
+  bool matches;
+  {
+    MappedFile golden( path );
+    matches = golden.size() == size  &&
+              findFirstDifference( golden.data(), actual, size ) == size;
+    if ( !matches  &&  !m_updateMode )
+    {
+      failure = Message( "snapshot mismatch", "Snapshot: " + path );
+      describeSnapshotMismatch( failure, 
+                                golden.data(), golden.size(), 
+                                actual, size );
+      failure.addDetail( "Run with --update-snapshots (or CPPUNIT_UPDATE_SNAPSHOTS=1)"
+                         " to accept the actual data" );
+    }
+  }
+
+  if ( !matches  &&  m_updateMode )
+  {
+    write( name, data, size );
+    return true;
+  }
+  return matches;
+}
+
+
+void 
+SnapshotStore::write( const std::string &name,
+                      const void *data,
+                      size_t size ) const
+{
+  std::string path = pathFor( name );
+  makeSnapshotDirectories( path );
+
+  static unsigned long temporaryCount = 0;
+  snapshotWriteMutex().lock();
+  unsigned long temporaryIndex = ++temporaryCount;
+  snapshotWriteMutex().unlock();
+
+  OStringStream temporaryPath;
+  temporaryPath << path << ".tmp";
+#if defined(CPPUNIT_HAVE_UNISTD_H)
+  temporaryPath << "." << ::getpid();
+#endif
+  temporaryPath << "." << temporaryIndex;
+
+  FILE *file = fopen( temporaryPath.str().c_str(), "wb" );
+  if ( file == NULL )
+    throw std::runtime_error( "Can not create file <" + temporaryPath.str() + ">." );
+  bool written = fwrite( data, 1, size, file ) == size;
+  if ( fclose( file ) != 0  ||  !written )
+  {
+    remove( temporaryPath.str().c_str() );
+    throw std::runtime_error( "Can not write file <" + temporaryPath.str() + ">." );
+  }
+
+  // rename() atomically replaces the golden file on POSIX systems. Windows
+  // refuses to replace an existing file.
+  if ( rename( temporaryPath.str().c_str(), path.c_str() ) != 0 )
+  {
+    remove( path.c_str() );
+    if ( rename( temporaryPath.str().c_str(), path.c_str() ) != 0 )
+    {
+      remove( temporaryPath.str().c_str() );
+      throw std::runtime_error( "Can not replace file <" + path + ">." );
+    }
+  }
+}
+
+
+std::string 
+SnapshotStore::defaultDirectory()
+{
+  const char *directory = getenv( "CPPUNIT_SNAPSHOT_DIR" );
+  if ( directory != NULL  &&  *directory != 0 )
+    return directory;
+  return "snapshots";
+}
+
+
+size_t 
+SnapshotStore::findFirstDifference( const unsigned char *expected,
+                                    const unsigned char *actual,
+                                    size_t size )
+{
+  size_t offset = 0;
+  while ( offset < size )
+  {
+    size_t blockSize = size - offset < snapshotCompareBlockSize 
+                           ? size - offset 
+                           : snapshotCompareBlockSize;
+    if ( memcmp( expected + offset, actual + offset, blockSize ) != 0 )
+    {
+      while ( expected[ offset ] == actual[ offset ] )
+        ++offset;
+      return offset;
+    }
+    offset += blockSize;
+  }
+  return size;
+}
+
+
+
+void 
+assertMatchesSnapshot( const std::string &name,
+                       const void *data,
+                       size_t size,
+                       SourceLine sourceLine,
+                       const std::string &message )
+{
+  Message failure;
+  if ( SnapshotStore::getStore().check( name, data, size, failure ) )
+    return;
+
+  if ( !message.empty() )
+    failure.addDetail( message );
+  Asserter::fail( failure, sourceLine );
+}
+
+
+void 
+assertMatchesSnapshot( const std::string &name,
+                       const std::string &data,
+                       SourceLine sourceLine,
+                       const std::string &message )
+{
+  assertMatchesSnapshot( name, data.data(), data.size(), sourceLine, message );
+}
+
+
+CPPUNIT_NS_END
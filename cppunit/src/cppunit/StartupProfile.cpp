@@ -0,0 +1,285 @@
+#include <cppunit/extensions/StartupProfile.h>
+#include <cppunit/tools/Clock.h>
+#include <algorithm>
+#include <stdio.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Orders factory indexes by decreasing time.
+class StartupFactoryOrder
+{
+public:
+  StartupFactoryOrder( const StartupProfile &profile )
+      : m_profile( profile )
+  {
+  }
+
+  bool operator()( int first, int second ) const
+  {
+    return m_profile.factorySecondsAt( first ) >
+           m_profile.factorySecondsAt( second );
+  }
+
+private:
+  const StartupProfile &m_profile;
+};
+
+
+StartupProfile::StartupProfile()
+    : m_enabled( false )
+{
+}
+
+
+StartupProfile::~StartupProfile()
+{
+}
+
+
+StartupProfile &
+StartupProfile::getProfile()
+{
+  static StartupProfile profile;
+  return profile;
+}
+
+
+void
+StartupProfile::setEnabled( bool enabled )
+{
+  m_enabled = enabled;
+}
+
+
+bool
+StartupProfile::isEnabled() const
+{
+  return m_enabled;
+}
+
+
+void
+StartupProfile::addPhaseTime( const std::string &phase,
+                              double seconds )
+{
+  if ( !m_enabled )
+    return;
+
+  for ( unsigned int index =0; index < m_phaseNames.size(); ++index )
+  {
+    if ( m_phaseNames[ index ] == phase )
+    {
+      m_phaseSeconds[ index ] += seconds;
+      return;
+    }
+  }
+  m_phaseNames.push_back( phase );
+  m_phaseSeconds.push_back( seconds );
+}
+
+
+void
+StartupProfile::enterFactory()
+{
+  if ( !m_enabled )
+    return;
+
+  TimedFactory factory;
+  factory.m_calledSeconds = 0;
+  factory.m_startTime = Clock::now();
+  m_timedFactories.push_back( factory );
+}
+
+
+void
+StartupProfile::exitFactory( const std::string &registryName,
+                             const std::string &suiteName )
+{
+  if ( m_timedFactories.empty() )
+    return;
+
+  TimedFactory timed = m_timedFactories.back();
+  m_timedFactories.pop_back();
+  double elapsed = Clock::now() - timed.m_startTime;
+  if ( !m_timedFactories.empty() )
+    m_timedFactories.back().m_calledSeconds += elapsed;
+  double seconds = elapsed - timed.m_calledSeconds;
+
+  FactoryKey key( registryName, suiteName );
+  FactoryIndexes::const_iterator it = m_factoryIndexes.find( key );
+  if ( it != m_factoryIndexes.end() )
+  {
+    m_factories[ (*it).second ].m_seconds += seconds;
+    return;
+  }
+
+  Factory factory;
+  factory.m_registryName = registryName;
+  factory.m_suiteName = suiteName;
+  factory.m_seconds = seconds;
+  m_factoryIndexes.insert( std::pair<const FactoryKey, int>( key,
+                                                             m_factories.size() ) );
+  m_factories.push_back( factory );
+}
+
+
+void
+StartupProfile::abandonFactory()
+{
+  if ( !m_timedFactories.empty() )
+    m_timedFactories.pop_back();
+}
+
+
+bool
+StartupProfile::isTimingFactory() const
+{
+  return !m_timedFactories.empty();
+}
+
+
+void
+StartupProfile::reset()
+{
+  m_phaseNames.clear();
+  m_phaseSeconds.clear();
+  m_factories.clear();
+  m_factoryIndexes.clear();
+  m_timedFactories.clear();
+}
+
+
+int
+StartupProfile::phaseCount() const
+{
+  return m_phaseNames.size();
+}
+
+
+std::string
+StartupProfile::phaseNameAt( int index ) const
+{
+  return m_phaseNames[ index ];
+}
+
+
+double
+StartupProfile::phaseSecondsAt( int index ) const
+{
+  return m_phaseSeconds[ index ];
+}
+
+
+int
+StartupProfile::factoryCount() const
+{
+  return m_factories.size();
+}
+
+
+std::string
+StartupProfile::factoryRegistryAt( int index ) const
+{
+  return m_factories[ index ].m_registryName;
+}
+
+
+std::string
+StartupProfile::factorySuiteAt( int index ) const
+{
+  return m_factories[ index ].m_suiteName;
+}
+
+
+double
+StartupProfile::factorySecondsAt( int index ) const
+{
+  return m_factories[ index ].m_seconds;
+}
+
+
+double
+StartupProfile::registrySeconds( const std::string &registryName ) const
+{
+  double seconds = 0;
+  for ( CppUnitVector<Factory>::const_iterator it = m_factories.begin();
+        it != m_factories.end();
+        ++it )
+  {
+    if ( (*it).m_registryName == registryName )
+      seconds += (*it).m_seconds;
+  }
+  return seconds;
+}
+
+
+double
+StartupProfile::totalSeconds() const
+{
+  double seconds = 0;
+  for ( unsigned int index =0; index < m_phaseSeconds.size(); ++index )
+    seconds += m_phaseSeconds[ index ];
+  return seconds;
+}
+
+
+void
+StartupProfile::write( OStream &stream,
+                       int maximumFactoryCount ) const
+{
+  char line[ 80 ];
+  sprintf( line, "%.3f ms", totalSeconds() * 1e3 );
+  stream << "Startup profile: " << line << "\n";
+
+  if ( !m_phaseNames.empty() )
+    stream << "   Time (ms)  Phase\n";
+  for ( int phaseIndex =0; phaseIndex < phaseCount(); ++phaseIndex )
+  {
+    sprintf( line, "%12.3f  ", phaseSecondsAt( phaseIndex ) * 1e3 );
+    stream << line << phaseNameAt( phaseIndex ) << "\n";
+  }
+
+  if ( m_factories.empty() )
+    return;
+
+  // Registries, in order of their first factory.
+  stream << "   Time (ms)  Factories  Registry\n";
+  CppUnitVector<std::string> registries;
+  for ( int index =0; index < factoryCount(); ++index )
+  {
+    std::string registryName = factoryRegistryAt( index );
+    if ( std::find( registries.begin(), registries.end(), registryName ) !=
+         registries.end() )
+      continue;
+    registries.push_back( registryName );
+
+    int registryFactoryCount = 0;
+    for ( int factoryIndex =0; factoryIndex < factoryCount(); ++factoryIndex )
+    {
+      if ( factoryRegistryAt( factoryIndex ) == registryName )
+        ++registryFactoryCount;
+    }
+    sprintf( line, "%12.3f %10d  ",
+             registrySeconds( registryName ) * 1e3, registryFactoryCount );
+    stream << line << registryName << "\n";
+  }
+
+  CppUnitVector<int> order;
+  for ( int orderIndex =0; orderIndex < factoryCount(); ++orderIndex )
+    order.push_back( orderIndex );
+  std::stable_sort( order.begin(), order.end(), StartupFactoryOrder( *this ) );
+
+  stream << "   Time (ms)  Slowest suite factories\n";
+  for ( int rank =0; rank < int(order.size())  &&  rank < maximumFactoryCount; ++rank )
+  {
+    int index = order[ rank ];
+    sprintf( line, "%12.3f  ", factorySecondsAt( index ) * 1e3 );
+    stream << line << factoryRegistryAt( index ) << " / "
+           << factorySuiteAt( index ) << "\n";
+  }
+}
+
+
+CPPUNIT_NS_END
@@ -76,5 +76,17 @@ StringTools::wrap( const std::string &text,
 }
 
 
+std::string 
+StringTools::trim( const std::string &text )
+{
+  const char *whiteSpaces = " \t\r\n";
+  std::string::size_type begin = text.find_first_not_of( whiteSpaces );
+  if ( begin == std::string::npos )
+    return "";
+  std::string::size_type end = text.find_last_not_of( whiteSpaces );
+  return text.substr( begin, end - begin +1 );
+}
+
+
 CPPUNIT_NS_END
 
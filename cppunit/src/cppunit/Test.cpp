@@ -15,6 +15,13 @@ Test::getChildTestAt( int index ) const
 }
 
 
+bool 
+Test::canRunChildTestsSeparately() const
+{
+  return true;
+}
+
+
 Test *
 Test::findTest( const std::string &testName ) const
 {
@@ -86,6 +93,50 @@ Test::resolveTestPath( const std::string &testPath ) const
 }
 
 
+void 
+Test::setProperty( const std::string &key,
+                   const std::string &value )
+{
+  Properties::iterator it = m_properties.begin();
+  for ( ; it != m_properties.end(); ++it )
+  {
+    if ( (*it).first == key )
+    {
+      (*it).second = value;
+      return;
+    }
+  }
+
+  m_properties.push_back( Property( key, value ) );
+}
+
+
+std::string 
+Test::getProperty( const std::string &key ) const
+{
+  Properties::const_iterator it = m_properties.begin();
+  for ( ; it != m_properties.end(); ++it )
+  {
+    if ( (*it).first == key )
+      return (*it).second;
+  }
+  return "";
+}
+
+
+bool 
+Test::hasProperty( const std::string &key ) const
+{
+  Properties::const_iterator it = m_properties.begin();
+  for ( ; it != m_properties.end(); ++it )
+  {
+    if ( (*it).first == key )
+      return true;
+  }
+  return false;
+}
+
+
 void 
 Test::checkIsValidIndex( int index ) const
 {
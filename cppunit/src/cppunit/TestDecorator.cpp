@@ -43,6 +43,13 @@ TestDecorator::getChildTestCount() const
 }
 
 
+bool 
+TestDecorator::canRunChildTestsSeparately() const
+{
+  return false;
+}
+
+
 Test *
 TestDecorator::doGetChildTestAt( int index ) const
 {
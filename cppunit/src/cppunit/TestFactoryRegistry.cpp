@@ -1,4 +1,5 @@
 #include <cppunit/config/SourcePrefix.h>
+#include <cppunit/extensions/StartupProfile.h>
 #include <cppunit/extensions/TestFactoryRegistry.h>
 #include <cppunit/portability/CppUnitMap.h>
 #include <cppunit/TestSuite.h>
@@ -82,6 +83,49 @@ public:
 
 
 
+/*! \brief (INTERNAL) Times a suite factory in the StartupProfile.
+ *
+ * Abandons the timing if the factory throws, so that the following
+ * factories are not nested in it.
+ */
+class StartupFactoryTimer
+{
+public:
+  StartupFactoryTimer( StartupProfile &profile )
+      : m_profile( profile )
+      , m_exited( false )
+  {
+    m_profile.enterFactory();
+  }
+
+  ~StartupFactoryTimer()
+  {
+    if ( !m_exited )
+      m_profile.abandonFactory();
+  }
+
+  void exit( const std::string &registryName,
+             const std::string &suiteName )
+  {
+    m_exited = true;
+    if ( m_profile.isEnabled() )
+      m_profile.exitFactory( registryName, suiteName );
+  }
+
+private:
+  /// Prevents the use of the copy constructor.
+  StartupFactoryTimer( const StartupFactoryTimer &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const StartupFactoryTimer &other );
+
+private:
+  StartupProfile &m_profile;
+  bool m_exited;
+};
+
+
+
 TestFactoryRegistry::TestFactoryRegistry( std::string name ) :
     m_name( name )
 {
@@ -133,7 +177,15 @@ Test *
 TestFactoryRegistry::makeTest()
 {
   TestSuite *suite = new TestSuite( m_name );
-  addTestToSuite( suite );
+  try
+  {
+    addTestToSuite( suite );
+  }
+  catch ( ... )
+  {
+    delete suite;
+    throw;
+  }
   return suite;
 }
 
@@ -141,12 +193,16 @@ TestFactoryRegistry::makeTest()
 void 
 TestFactoryRegistry::addTestToSuite( TestSuite *suite )
 {
+  StartupProfile &profile = StartupProfile::getProfile();
   for ( Factories::iterator it = m_factories.begin(); 
         it != m_factories.end(); 
         ++it )
   {
     TestFactory *factory = *it;
-    suite->addTest( factory->makeTest() );
+    StartupFactoryTimer timer( profile );
+    Test *test = factory->makeTest();
+    timer.exit( m_name, test->getName() );
+    suite->addTest( test );
   }
 }
 
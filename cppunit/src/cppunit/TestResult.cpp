@@ -1,8 +1,10 @@
+#include <cppunit/CallbackProfile.h>
 #include <cppunit/Test.h>
 #include <cppunit/TestFailure.h>
 #include <cppunit/TestListener.h>
 #include <cppunit/TestResult.h>
 #include <cppunit/tools/Algorithm.h>
+#include <cppunit/tools/Clock.h>
 #include <cppunit/portability/Stream.h>
 #include <algorithm>
 #include "DefaultProtector.h"
@@ -12,10 +14,39 @@
 CPPUNIT_NS_BEGIN
 
 
+/// Times a listener call into the profile, if there is one.
+class ListenerTimer
+{
+public:
+  ListenerTimer( CallbackProfile *profile,
+                 TestListener *listener,
+                 const char *event )
+      : m_profile( profile )
+      , m_listener( listener )
+      , m_event( event )
+      , m_startTime( profile != NULL ? Clock::now() : 0 )
+  {
+  }
+
+  ~ListenerTimer()
+  {
+    if ( m_profile != NULL )
+      m_profile->addListenerTime( m_listener, m_event, Clock::now() - m_startTime );
+  }
+
+private:
+  CallbackProfile *m_profile;
+  TestListener *m_listener;
+  const char *m_event;
+  double m_startTime;
+};
+
+
 TestResult::TestResult( SynchronizationObject *syncObject )
     : SynchronizedObject( syncObject )
     , m_protectorChain( new ProtectorChain() )
     , m_stop( false )
+    , m_profile( NULL )
 { 
   m_protectorChain->push( new DefaultProtector() );
 }
@@ -61,7 +92,10 @@ TestResult::addFailure( const TestFailure &failure )
   for ( TestListeners::iterator it = m_listeners.begin();
         it != m_listeners.end(); 
         ++it )
+  {
+    ListenerTimer timer( m_profile, *it, "addFailure" );
     (*it)->addFailure( failure );
+  }
 }
 
 
@@ -72,7 +106,10 @@ TestResult::startTest( Test *test )
   for ( TestListeners::iterator it = m_listeners.begin();
         it != m_listeners.end(); 
         ++it )
+  {
+    ListenerTimer timer( m_profile, *it, "startTest" );
     (*it)->startTest( test );
+  }
 }
 
   
@@ -83,7 +120,10 @@ TestResult::endTest( Test *test )
   for ( TestListeners::iterator it = m_listeners.begin();
         it != m_listeners.end(); 
         ++it )
+  {
+    ListenerTimer timer( m_profile, *it, "endTest" );
     (*it)->endTest( test );
+  }
 }
 
 
@@ -94,7 +134,10 @@ TestResult::startSuite( Test *test )
   for ( TestListeners::iterator it = m_listeners.begin();
         it != m_listeners.end(); 
         ++it )
+  {
+    ListenerTimer timer( m_profile, *it, "startSuite" );
     (*it)->startSuite( test );
+  }
 }
 
 
@@ -105,7 +148,10 @@ TestResult::endSuite( Test *test )
   for ( TestListeners::iterator it = m_listeners.begin();
         it != m_listeners.end(); 
         ++it )
+  {
+    ListenerTimer timer( m_profile, *it, "endSuite" );
     (*it)->endSuite( test );
+  }
 }
 
 
@@ -157,7 +203,10 @@ TestResult::startTestRun( Test *test )
   for ( TestListeners::iterator it = m_listeners.begin();
         it != m_listeners.end(); 
         ++it )
+  {
+    ListenerTimer timer( m_profile, *it, "startTestRun" );
     (*it)->startTestRun( test, this );
+  }
 }
 
 
@@ -168,7 +217,10 @@ TestResult::endTestRun( Test *test )
   for ( TestListeners::iterator it = m_listeners.begin();
         it != m_listeners.end(); 
         ++it )
+  {
+    ListenerTimer timer( m_profile, *it, "endTestRun" );
     (*it)->endTestRun( test, this );
+  }
 }
 
 
@@ -196,4 +248,20 @@ TestResult::popProtector()
 }
 
 
+void 
+TestResult::setProfile( CallbackProfile *profile )
+{
+  ExclusiveZone zone( m_syncObject ); 
+  m_profile = profile;
+}
+
+
+CallbackProfile *
+TestResult::profile() const
+{
+  ExclusiveZone zone( m_syncObject ); 
+  return m_profile;
+}
+
+
 CPPUNIT_NS_END
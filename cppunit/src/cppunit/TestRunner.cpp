@@ -2,6 +2,9 @@
 #include <cppunit/TestRunner.h>
 #include <cppunit/TestPath.h>
 #include <cppunit/TestResult.h>
+#include <cppunit/extensions/StartupProfile.h>
+#include <cppunit/extensions/TestTags.h>
+#include <cppunit/tools/Clock.h>
 
 
 CPPUNIT_NS_BEGIN
@@ -90,12 +93,36 @@ void
 TestRunner::run( TestResult &controller,
                  const std::string &testPath )
 {
+  double startTime = Clock::now();
   TestPath path = m_suite->resolveTestPath( testPath );
   Test *testToRun = path.getChildTest();
+  StartupProfile::getProfile().addPhaseTime( "resolve test path", 
+                                             Clock::now() - startTime );
 
   controller.runTest( testToRun );
 }
 
 
+void 
+TestRunner::runTagged( TestResult &controller,
+                       const std::string &tagExpression,
+                       const std::string &testPath )
+{
+  double startTime = Clock::now();
+  TagExpression expression( tagExpression );
+  TestPath path = m_suite->resolveTestPath( testPath );
+  Test *testToRun = path.getChildTest();
+
+  TaggedTestIndex index;
+  index.addTest( testToRun );
+  TestSelection selection( testToRun->getName() );
+  index.select( expression, selection );
+  StartupProfile::getProfile().addPhaseTime( "select tagged tests", 
+                                             Clock::now() - startTime );
+
+  controller.runTest( &selection );
+}
+
+
 CPPUNIT_NS_END
 
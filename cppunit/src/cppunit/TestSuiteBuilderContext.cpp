@@ -29,6 +29,15 @@ TestSuiteBuilderContextBase::addTest( Test *test )
 }
 
 
+void 
+TestSuiteBuilderContextBase::addTaggedTest( Test *test,
+                                            const std::string &tags )
+{
+  test->setProperty( "tags", tags );
+  addTest( test );
+}
+
+
 std::string 
 TestSuiteBuilderContextBase::getFixtureName() const
 {
@@ -55,6 +64,8 @@ void
 TestSuiteBuilderContextBase::addProperty( const std::string &key, 
                                           const std::string &value )
 {
+  m_suite.setProperty( key, value );
+
   Properties::iterator it = m_properties.begin();
   for ( ; it != m_properties.end(); ++it )
   {
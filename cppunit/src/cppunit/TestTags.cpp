@@ -0,0 +1,842 @@
+#include <cppunit/Exception.h>
+#include <cppunit/Test.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/extensions/TestTags.h>
+#include <cppunit/portability/CppUnitSet.h>
+#include <cppunit/tools/StringTools.h>
+#include <stdexcept>
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Number of bits in a TagSet word.
+static const int tagSetWordBits = sizeof(unsigned long) * 8;
+
+
+TagSet::TagSet()
+{
+}
+
+
+void
+TagSet::insert( int index )
+{
+  unsigned int wordIndex = index / tagSetWordBits;
+  if ( wordIndex >= m_words.size() )
+    m_words.resize( wordIndex +1, 0 );
+  m_words[ wordIndex ] |= 1UL << (index % tagSetWordBits);
+}
+
+
+bool
+TagSet::contains( int index ) const
+{
+  unsigned int wordIndex = index / tagSetWordBits;
+  if ( index < 0  ||  wordIndex >= m_words.size() )
+    return false;
+  return (m_words[ wordIndex ] & (1UL << (index % tagSetWordBits))) != 0;
+}
+
+
+bool
+TagSet::isEmpty() const
+{
+  for ( Words::const_iterator it = m_words.begin(); it != m_words.end(); ++it )
+  {
+    if ( *it != 0 )
+      return false;
+  }
+  return true;
+}
+
+
+int
+TagSet::count() const
+{
+  int count = 0;
+  for ( Words::const_iterator it = m_words.begin(); it != m_words.end(); ++it )
+  {
+    for ( unsigned long word = *it; word != 0; word &= word -1 )
+      ++count;
+  }
+  return count;
+}
+
+
+void
+TagSet::merge( const TagSet &other )
+{
+  if ( other.m_words.size() > m_words.size() )
+    m_words.resize( other.m_words.size(), 0 );
+  for ( unsigned int index =0; index < other.m_words.size(); ++index )
+    m_words[ index ] |= other.m_words[ index ];
+}
+
+
+void
+TagSet::intersect( const TagSet &other )
+{
+  if ( other.m_words.size() < m_words.size() )
+    m_words.resize( other.m_words.size() );
+  for ( unsigned int index =0; index < m_words.size(); ++index )
+    m_words[ index ] &= other.m_words[ index ];
+}
+
+
+void
+TagSet::complement( int size )
+{
+  unsigned int wordCount = (size + tagSetWordBits -1) / tagSetWordBits;
+  m_words.resize( wordCount, 0 );
+  for ( unsigned int index =0; index < wordCount; ++index )
+    m_words[ index ] = ~m_words[ index ];
+
+  int lastBits = size % tagSetWordBits;
+  if ( lastBits != 0 )
+    m_words[ wordCount -1 ] &= (1UL << lastBits) -1;
+}
+
+
+bool
+TagSet::operator ==( const TagSet &other ) const
+{
+  const Words &longest = m_words.size() > other.m_words.size() ? m_words
+                                                               : other.m_words;
+  for ( unsigned int index =0; index < longest.size(); ++index )
+  {
+    unsigned long word = index < m_words.size() ? m_words[ index ] : 0;
+    unsigned long otherWord = index < other.m_words.size() ? other.m_words[ index ]
+                                                           : 0;
+    if ( word != otherWord )
+      return false;
+  }
+  return true;
+}
+
+
+
+TagDictionary::TagDictionary()
+{
+}
+
+
+TagDictionary::~TagDictionary()
+{
+}
+
+
+TagDictionary &
+TagDictionary::getDictionary()
+{
+  static TagDictionary dictionary;
+  return dictionary;
+}
+
+
+int
+TagDictionary::intern( const std::string &tag )
+{
+  std::string name = StringTools::trim( tag );
+  if ( !isValidTag( name ) )
+    throw std::invalid_argument( "Invalid tag name <" + tag + ">." );
+
+  Indexes::const_iterator it = m_indexes.find( name );
+  if ( it != m_indexes.end() )
+    return (*it).second;
+
+  int index = m_tags.size();
+  m_tags.push_back( name );
+  m_indexes.insert( Indexes::value_type( name, index ) );
+  return index;
+}
+
+
+int
+TagDictionary::find( const std::string &tag ) const
+{
+  Indexes::const_iterator it = m_indexes.find( StringTools::trim( tag ) );
+  if ( it == m_indexes.end() )
+    return -1;
+  return (*it).second;
+}
+
+
+int
+TagDictionary::getTagCount() const
+{
+  return m_tags.size();
+}
+
+
+std::string
+TagDictionary::getTagAt( int index ) const
+{
+  return m_tags[ index ];
+}
+
+
+TagSet
+TagDictionary::parse( const std::string &tags )
+{
+  TagSet tagSet;
+  StringTools::Strings names = StringTools::split( tags, ',' );
+  for ( StringTools::Strings::const_iterator it = names.begin();
+        it != names.end();
+        ++it )
+  {
+    if ( !StringTools::trim( *it ).empty() )
+      tagSet.insert( intern( *it ) );
+  }
+  return tagSet;
+}
+
+
+/// Tests if \a c may be used in a tag name.
+static bool
+isTagCharacter( char c )
+{
+  return ( c >= 'a'  &&  c <= 'z' )  ||
+         ( c >= 'A'  &&  c <= 'Z' )  ||
+         ( c >= '0'  &&  c <= '9' )  ||
+         c == '_'  ||  c == '-'  ||  c == '.'  ||  c == ':';
+}
+
+
+bool
+TagDictionary::isValidTag( const std::string &tag )
+{
+  if ( tag.empty() )
+    return false;
+
+  for ( unsigned int index =0; index < tag.length(); ++index )
+  {
+    if ( !isTagCharacter( tag[ index ] ) )
+      return false;
+  }
+  return true;
+}
+
+
+
+TagExpression::TagExpression( const std::string &expression )
+    : m_expression( expression )
+{
+  unsigned int position = 0;
+  parseExpression( position );
+  skipSpaces( position );
+  if ( position < m_expression.length() )
+    fail( "unexpected character" );
+}
+
+
+TagExpression::~TagExpression()
+{
+}
+
+
+std::string
+TagExpression::expression() const
+{
+  return m_expression;
+}
+
+
+void
+TagExpression::parseExpression( unsigned int &position )
+{
+  parseTerm( position );
+  skipSpaces( position );
+  while ( position < m_expression.length()  &&  m_expression[ position ] == '|' )
+  {
+    ++position;
+    parseTerm( position );
+    addInstruction( orOperation );
+    skipSpaces( position );
+  }
+}
+
+
+void
+TagExpression::parseTerm( unsigned int &position )
+{
+  parseFactor( position );
+  skipSpaces( position );
+  while ( position < m_expression.length()  &&  m_expression[ position ] == '&' )
+  {
+    ++position;
+    parseFactor( position );
+    addInstruction( andOperation );
+    skipSpaces( position );
+  }
+}
+
+
+void
+TagExpression::parseFactor( unsigned int &position )
+{
+  skipSpaces( position );
+  if ( position >= m_expression.length() )
+    fail( "missing tag" );
+
+  char c = m_expression[ position ];
+  if ( c == '!' )
+  {
+    ++position;
+    parseFactor( position );
+    addInstruction( notOperation );
+  }
+  else if ( c == '(' )
+  {
+    ++position;
+    parseExpression( position );
+    skipSpaces( position );
+    if ( position >= m_expression.length()  ||  m_expression[ position ] != ')' )
+      fail( "missing ')'" );
+    ++position;
+  }
+  else
+  {
+    unsigned int start = position;
+    while ( position < m_expression.length()  &&
+            isTagCharacter( m_expression[ position ] ) )
+      ++position;
+    if ( position == start )
+      fail( "missing tag" );
+    addInstruction( pushTag, m_expression.substr( start, position - start ) );
+  }
+}
+
+
+void
+TagExpression::skipSpaces( unsigned int &position ) const
+{
+  while ( position < m_expression.length()  &&
+          ( m_expression[ position ] == ' '  ||  m_expression[ position ] == '\t' ) )
+    ++position;
+}
+
+
+void
+TagExpression::addInstruction( Operation operation,
+                               const std::string &tag )
+{
+  Instruction instruction;
+  instruction.m_operation = operation;
+  instruction.m_tag = tag;
+  m_program.push_back( instruction );
+}
+
+
+void
+TagExpression::fail( const std::string &message ) const
+{
+  throw std::invalid_argument( "Invalid tag expression <" + m_expression +
+                               ">: " + message + "." );
+}
+
+
+bool
+TagExpression::matches( const TagSet &tags,
+                        const TagDictionary &dictionary ) const
+{
+  CppUnitVector<bool> stack;
+  for ( CppUnitVector<Instruction>::const_iterator it = m_program.begin();
+        it != m_program.end();
+        ++it )
+  {
+    const Instruction &instruction = *it;
+    if ( instruction.m_operation == pushTag )
+    {
+      stack.push_back( tags.contains( dictionary.find( instruction.m_tag ) ) );
+      continue;
+    }
+
+    bool top = stack.back();
+    if ( instruction.m_operation == notOperation )
+    {
+      stack.back() = !top;
+      continue;
+    }
+
+    stack.pop_back();
+    if ( instruction.m_operation == andOperation )
+      stack.back() = stack.back()  &&  top;
+    else
+      stack.back() = stack.back()  ||  top;
+  }
+
+  return stack.back();
+}
+
+
+TagSet
+TagExpression::select( const CppUnitVector<TagSet> &testsByTag,
+                       int testCount,
+                       const TagDictionary &dictionary ) const
+{
+  CppUnitVector<TagSet> stack;
+  for ( CppUnitVector<Instruction>::const_iterator it = m_program.begin();
+        it != m_program.end();
+        ++it )
+  {
+    const Instruction &instruction = *it;
+    if ( instruction.m_operation == pushTag )
+    {
+      int tagIndex = dictionary.find( instruction.m_tag );
+      if ( tagIndex >= 0  &&  tagIndex < int(testsByTag.size()) )
+        stack.push_back( testsByTag[ tagIndex ] );
+      else
+        stack.push_back( TagSet() );
+      continue;
+    }
+
+    if ( instruction.m_operation == notOperation )
+    {
+      stack.back().complement( testCount );
+      continue;
+    }
+
+    TagSet top = stack.back();
+    stack.pop_back();
+    if ( instruction.m_operation == andOperation )
+      stack.back().intersect( top );
+    else
+      stack.back().merge( top );
+  }
+
+  return stack.back();
+}
+
+
+
+TaggedTestIndex::TaggedTestIndex( TagDictionary &dictionary )
+    : m_dictionary( dictionary )
+{
+}
+
+
+TaggedTestIndex::~TaggedTestIndex()
+{
+}
+
+
+void
+TaggedTestIndex::addTest( Test *test )
+{
+  m_roots.push_back( test );
+  addTest( test, TagSet() );
+}
+
+
+void
+TaggedTestIndex::addTest( Test *test,
+                          const TagSet &inheritedTags )
+{
+  TagSet tags( inheritedTags );
+  if ( test->hasProperty( "tags" ) )
+    tags.merge( m_dictionary.parse( test->getProperty( "tags" ) ) );
+
+  int childCount = test->getChildTestCount();
+  if ( childCount > 0 )
+  {
+    for ( int childIndex =0; childIndex < childCount; ++childIndex )
+      addTest( test->getChildTestAt( childIndex ), tags );
+    return;
+  }
+
+  int testIndex = m_tests.size();
+  m_tests.push_back( test );
+  m_tags.push_back( tags );
+
+  if ( int(m_testsByTag.size()) < m_dictionary.getTagCount() )
+    m_testsByTag.resize( m_dictionary.getTagCount() );
+  for ( int tagIndex =0; tagIndex < int(m_testsByTag.size()); ++tagIndex )
+  {
+    if ( tags.contains( tagIndex ) )
+      m_testsByTag[ tagIndex ].insert( testIndex );
+  }
+}
+
+
+int
+TaggedTestIndex::getTestCount() const
+{
+  return m_tests.size();
+}
+
+
+Test *
+TaggedTestIndex::getTestAt( int index ) const
+{
+  return m_tests[ index ];
+}
+
+
+const TagSet &
+TaggedTestIndex::getTagsAt( int index ) const
+{
+  return m_tags[ index ];
+}
+
+
+TagSet
+TaggedTestIndex::select( const TagExpression &expression ) const
+{
+  return expression.select( m_testsByTag, m_tests.size(), m_dictionary );
+}
+
+
+int
+TaggedTestIndex::select( const TagExpression &expression,
+                         TestSelection &selection ) const
+{
+  TagSet selected = select( expression );
+  int testIndex = 0;
+  for ( unsigned int rootIndex =0; rootIndex < m_roots.size(); ++rootIndex )
+    selectTests( m_roots[ rootIndex ], selected, testIndex, false, selection );
+  return selected.count();
+}
+
+
+/// Returns the number of test cases of \a test, as indexed by TaggedTestIndex.
+static int
+countIndexedTestCases( Test *test )
+{
+  int childCount = test->getChildTestCount();
+  if ( childCount == 0 )
+    return 1;
+
+  int count = 0;
+  for ( int childIndex =0; childIndex < childCount; ++childIndex )
+    count += countIndexedTestCases( test->getChildTestAt( childIndex ) );
+  return count;
+}
+
+
+void
+TaggedTestIndex::selectTests( Test *test,
+                              const TagSet &selected,
+                              int &testIndex,
+                              bool isInSelectedTest,
+                              TestSelection &selection ) const
+{
+  // The test cases of a test have consecutive indexes.
+  int testCount = countIndexedTestCases( test );
+  int selectedCount = 0;
+  for ( int index = testIndex; index < testIndex + testCount; ++index )
+  {
+    if ( selected.contains( index ) )
+      ++selectedCount;
+  }
+
+  if ( selectedCount == testCount  ||  selectedCount == 0 )
+  {
+    if ( selectedCount > 0  &&  !isInSelectedTest )
+      selection.addTest( test );
+    else if ( selectedCount == 0  &&  isInSelectedTest )
+      selection.excludeTest( test );
+    testIndex += testCount;
+    return;
+  }
+
+  if ( !isInSelectedTest  &&  !test->canRunChildTestsSeparately() )
+  {
+    selection.addTest( test );
+    isInSelectedTest = true;
+  }
+
+  int childCount = test->getChildTestCount();
+  for ( int childIndex =0; childIndex < childCount; ++childIndex )
+  {
+    selectTests( test->getChildTestAt( childIndex ), selected, testIndex, 
+                 isInSelectedTest, selection );
+  }
+}
+
+
+
+/// Tests excluded by a selection, with all their descendants.
+typedef CppUnitSet<const Test *> ExcludedTests;
+
+
+/*! Result the tests of a TestSelectionFilter are run with: forwards the
+ *  events of the tests that are not excluded to the result of the run, and
+ *  does not call the excluded tests.
+ */
+class TestSelectionResult : public TestResult
+{
+public:
+  TestSelectionResult( TestResult &result,
+                       const ExcludedTests &excludedTests )
+      : m_result( result )
+      , m_excludedTests( excludedTests )
+  {
+  }
+
+  void addListener( TestListener *listener )
+  {
+    m_result.addListener( listener );
+  }
+
+  void removeListener( TestListener *listener )
+  {
+    m_result.removeListener( listener );
+  }
+
+  void reset()
+  {
+    m_result.reset();
+  }
+
+  void stop()
+  {
+    m_result.stop();
+  }
+
+  bool shouldStop() const
+  {
+    return m_result.shouldStop();
+  }
+
+  void startTest( Test *test )
+  {
+    if ( !isExcluded( test ) )
+      m_result.startTest( test );
+  }
+
+  void addError( Test *test, Exception *e )
+  {
+    if ( isExcluded( test ) )
+      delete e;
+    else
+      m_result.addError( test, e );
+  }
+
+  void addFailure( Test *test, Exception *e )
+  {
+    if ( isExcluded( test ) )
+      delete e;
+    else
+      m_result.addFailure( test, e );
+  }
+
+  void endTest( Test *test )
+  {
+    if ( !isExcluded( test ) )
+      m_result.endTest( test );
+  }
+
+  void startSuite( Test *test )
+  {
+    if ( !isExcluded( test ) )
+      m_result.startSuite( test );
+  }
+
+  void endSuite( Test *test )
+  {
+    if ( !isExcluded( test ) )
+      m_result.endSuite( test );
+  }
+
+  bool protect( const Functor &functor,
+                Test *test,
+                const std::string &shortDescription )
+  {
+    if ( isExcluded( test ) )
+      return false;
+    return m_result.protect( functor, test, shortDescription );
+  }
+
+  void pushProtector( Protector *protector )
+  {
+    m_result.pushProtector( protector );
+  }
+
+  void popProtector()
+  {
+    m_result.popProtector();
+  }
+
+  void setProfile( CallbackProfile *profile )
+  {
+    m_result.setProfile( profile );
+  }
+
+private:
+  bool isExcluded( const Test *test ) const
+  {
+    return m_excludedTests.find( test ) != m_excludedTests.end();
+  }
+
+private:
+  TestResult &m_result;
+  const ExcludedTests &m_excludedTests;
+};
+
+
+/*! Test of a TestSelection some descendants of which are excluded. Its only
+ *  child test is the filtered test.
+ */
+class TestSelectionFilter : public Test
+{
+public:
+  TestSelectionFilter( Test *test )
+      : m_test( test )
+      , m_excludedTestCaseCount( 0 )
+  {
+  }
+
+  /// Excludes a descendant of the filtered test.
+  void excludeTest( Test *test )
+  {
+    if ( isExcluded( test ) )
+      return;
+    m_excludedTestCaseCount += test->countTestCases();
+    addExcludedTest( test );
+  }
+
+  bool isExcluded( const Test *test ) const
+  {
+    return m_excludedTests.find( test ) != m_excludedTests.end();
+  }
+
+  void run( TestResult *result )
+  {
+    TestSelectionResult selectionResult( *result, m_excludedTests );
+    m_test->run( &selectionResult );
+  }
+
+  int countTestCases() const
+  {
+    return m_test->countTestCases() - m_excludedTestCaseCount;
+  }
+
+  int getChildTestCount() const
+  {
+    return 1;
+  }
+
+  bool canRunChildTestsSeparately() const
+  {
+    return false;
+  }
+
+  std::string getName() const
+  {
+    return m_test->getName();
+  }
+
+protected:
+  Test *doGetChildTestAt( int ) const
+  {
+    return m_test;
+  }
+
+private:
+  void addExcludedTest( const Test *test )
+  {
+    m_excludedTests.insert( test );
+    for ( int childIndex =0; childIndex < test->getChildTestCount(); ++childIndex )
+      addExcludedTest( test->getChildTestAt( childIndex ) );
+  }
+
+  /// Prevents the use of the copy constructor.
+  TestSelectionFilter( const TestSelectionFilter &other );
+
+  /// Prevents the use of the copy operator.
+  void operator =( const TestSelectionFilter &other );
+
+private:
+  Test *m_test;
+  ExcludedTests m_excludedTests;
+  int m_excludedTestCaseCount;
+};
+
+
+/// Tests if \a test is \a ancestor or one of its descendants.
+static bool
+isSelectedDescendant( const Test *ancestor,
+                      const Test *test )
+{
+  if ( ancestor == test )
+    return true;
+  for ( int childIndex =0; childIndex < ancestor->getChildTestCount(); ++childIndex )
+  {
+    if ( isSelectedDescendant( ancestor->getChildTestAt( childIndex ), test ) )
+      return true;
+  }
+  return false;
+}
+
+
+TestSelection::TestSelection( const std::string &name )
+    : TestComposite( name )
+{
+}
+
+
+TestSelection::~TestSelection()
+{
+  for ( unsigned int index =0; index < m_filters.size(); ++index )
+    delete m_filters[ index ];
+}
+
+
+void
+TestSelection::addTest( Test *test )
+{
+  m_addedTests.push_back( test );
+  m_tests.push_back( test );
+  m_filters.push_back( NULL );
+}
+
+
+void
+TestSelection::excludeTest( Test *test )
+{
+  // The excluded tests usually belong to the last added test.
+  for ( int index = m_addedTests.size() -1; index >= 0; --index )
+  {
+    Test *addedTest = m_addedTests[ index ];
+    if ( addedTest == test  ||  !isSelectedDescendant( addedTest, test ) )
+      continue;
+
+    if ( m_filters[ index ] == NULL )
+    {
+      m_filters[ index ] = new TestSelectionFilter( addedTest );
+      m_tests[ index ] = m_filters[ index ];
+    }
+    m_filters[ index ]->excludeTest( test );
+    return;
+  }
+}
+
+
+bool
+TestSelection::isExcluded( const Test *test ) const
+{
+  for ( unsigned int index =0; index < m_filters.size(); ++index )
+  {
+    if ( m_filters[ index ] != NULL  &&  m_filters[ index ]->isExcluded( test ) )
+      return true;
+  }
+  return false;
+}
+
+
+int
+TestSelection::getChildTestCount() const
+{
+  return m_tests.size();
+}
+
+
+Test *
+TestSelection::doGetChildTestAt( int index ) const
+{
+  return m_tests[ index ];
+}
+
+
+CPPUNIT_NS_END
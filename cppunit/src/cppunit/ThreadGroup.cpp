@@ -0,0 +1,418 @@
+#include <cppunit/AssertionTrap.h>
+#include <cppunit/Exception.h>
+#include <cppunit/portability/CppUnitVector.h>
+#include <cppunit/tools/ThreadGroup.h>
+#include <stdexcept>
+#include <string>
+#include <time.h>
+
+#if defined(CPPUNIT_HAVE_PTHREAD_H)
+#include <errno.h>
+#include <pthread.h>
+#endif
+#if defined(CPPUNIT_HAVE_SYSCONF)  &&  defined(CPPUNIT_HAVE_UNISTD_H)
+#include <unistd.h>
+#endif
+
+
+CPPUNIT_NS_BEGIN
+
+
+/// Time after which ThreadBarrier::wait() gives up, in seconds.
+static const int threadBarrierTimeout = 10;
+
+
+/// State of a thread of a ThreadGroup.
+struct ThreadGroupWorker
+{
+  ThreadGroupWorker()
+      : m_task( NULL )
+      , m_threadIndex( 0 )
+      , m_failed( false )
+      , m_exception( NULL )
+  {
+  }
+
+  /// Runs the task, catching any exception.
+  void run()
+  {
+#if defined(CPPUNIT_NO_EXCEPTIONS)
+    // A failed assertion of the task jumps back here: nothing is thrown.
+    AssertionTrap trap;
+    if ( setjmp( trap.jumpBuffer() ) != 0 )
+    {
+      m_failed = true;
+      m_exception = trap.failure()->clone();
+      return;
+    }
+#endif
+    try
+    {
+      m_task->run( m_threadIndex );
+    }
+    catch ( Exception &e )
+    {
+      m_failed = true;
+      m_exception = e.clone();
+    }
+    catch ( std::exception &e )
+    {
+      m_failed = true;
+      m_message = e.what();
+    }
+    catch ( ... )
+    {
+      m_failed = true;
+      m_message = "unknown exception";
+    }
+  }
+
+  ThreadTask *m_task;
+  int m_threadIndex;
+  bool m_failed;
+  Exception *m_exception;
+  std::string m_message;
+#if defined(CPPUNIT_HAVE_PTHREAD_H)
+  pthread_t m_thread;
+#endif
+};
+
+
+/*! Rethrows the exception that escaped the task of a failed worker: an
+ *  Exception as is, any other exception as a std::runtime_error of the
+ *  specified message. If CPPUNIT_NO_EXCEPTIONS is defined, an Exception is
+ *  raised to the innermost AssertionTrap of the calling thread instead.
+ * \param exception Exception, owned. \c NULL for any other exception.
+ */
+static void
+throwThreadGroupFailure( Exception *exception,
+                         const std::string &message )
+{
+  if ( exception == NULL )
+    throw std::runtime_error( message );
+
+#if defined(CPPUNIT_NO_EXCEPTIONS)
+  AssertionTrap::raise( exception );
+#endif
+  try
+  {
+    exception->throwCopy();
+  }
+  catch ( ... )
+  {
+    delete exception;
+    throw;
+  }
+}
+
+
+#if defined(CPPUNIT_HAVE_PTHREAD_H)
+extern "C" 
+{
+  static void *
+  cppunitThreadGroupEntry( void *worker )
+  {
+    CPPUNIT_STATIC_CAST( ThreadGroupWorker *, worker )->run();
+    return NULL;
+  }
+}
+#endif
+
+
+/*! Runs the workers of ThreadGroup::run().
+ * \return \c true if a task failed. \a exception and \a message are then
+ *         set to the failure of the first one.
+ */
+static bool
+runThreadGroupWorkers( ThreadTask &task, 
+                       int threadCount,
+                       Exception *&exception,
+                       std::string &message )
+{
+  CppUnitVector<ThreadGroupWorker> workers( threadCount > 0 ? threadCount : 0 );
+  for ( int index =0; index < threadCount; ++index )
+  {
+    workers[ index ].m_task = &task;
+    workers[ index ].m_threadIndex = index;
+  }
+
+#if defined(CPPUNIT_HAVE_PTHREAD_H)
+  // The calling thread runs the first worker itself.
+  CppUnitVector<bool> started( threadCount, false );
+  for ( int startIndex =1; startIndex < threadCount; ++startIndex )
+  {
+    started[ startIndex ] = pthread_create( &workers[ startIndex ].m_thread, 
+                                            NULL, 
+                                            cppunitThreadGroupEntry, 
+                                            &workers[ startIndex ] ) == 0;
+  }
+
+  if ( threadCount > 0 )
+    workers[ 0 ].run();
+
+  for ( int joinIndex =1; joinIndex < threadCount; ++joinIndex )
+  {
+    if ( started[ joinIndex ] )
+      pthread_join( workers[ joinIndex ].m_thread, NULL );
+    else    // failed to create the thread
+      workers[ joinIndex ].run();
+  }
+#else
+  for ( int index =0; index < threadCount; ++index )
+    workers[ index ].run();
+#endif
+
+  int failedIndex = -1;
+  for ( int checkIndex = threadCount -1; checkIndex >= 0; --checkIndex )
+  {
+    if ( workers[ checkIndex ].m_failed )
+      failedIndex = checkIndex;
+  }
+  if ( failedIndex < 0 )
+    return false;
+
+  for ( int deleteIndex =0; deleteIndex < threadCount; ++deleteIndex )
+  {
+    if ( deleteIndex != failedIndex )
+      delete workers[ deleteIndex ].m_exception;
+  }
+  exception = workers[ failedIndex ].m_exception;
+  message = workers[ failedIndex ].m_message;
+  return true;
+}
+
+
+void 
+ThreadGroup::run( ThreadTask &task, 
+                  int threadCount )
+{
+  // The workers are destroyed before the failure is raised.
+  Exception *exception = NULL;
+  std::string message;
+  if ( runThreadGroupWorkers( task, threadCount, exception, message ) )
+    throwThreadGroupFailure( exception, message );
+}
+
+
+bool 
+ThreadGroup::isConcurrent()
+{
+#if defined(CPPUNIT_HAVE_PTHREAD_H)
+  return true;
+#else
+  return false;
+#endif
+}
+
+
+int 
+ThreadGroup::processorCount()
+{
+#if defined(CPPUNIT_HAVE_SYSCONF)  &&  defined(_SC_NPROCESSORS_ONLN)
+  long count = sysconf( _SC_NPROCESSORS_ONLN );
+  if ( count > 0 )
+    return int(count);
+#endif
+  return 1;
+}
+
+
+
+/*! Waits for the worker of a BackgroundThread, and deletes it.
+ * \return \c true if its task failed. \a exception and \a message are
+ *         then set to the failure.
+ */
+static bool
+joinBackgroundWorker( void *&backgroundWorker,
+                      Exception *&exception,
+                      std::string &message )
+{
+  if ( backgroundWorker == NULL )
+    return false;
+
+  ThreadGroupWorker *worker = CPPUNIT_STATIC_CAST( ThreadGroupWorker *, 
+                                                   backgroundWorker );
+  backgroundWorker = NULL;
+#if defined(CPPUNIT_HAVE_PTHREAD_H)
+  pthread_join( worker->m_thread, NULL );
+#endif
+  bool failed = worker->m_failed;
+  exception = worker->m_exception;
+  message = worker->m_message;
+  delete worker;
+  return failed;
+}
+
+
+BackgroundThread::BackgroundThread()
+    : m_worker( NULL )
+{
+}
+
+
+BackgroundThread::~BackgroundThread()
+{
+  // The failure of the task is lost.
+  Exception *exception = NULL;
+  std::string message;
+  joinBackgroundWorker( m_worker, exception, message );
+  delete exception;
+}
+
+
+bool 
+BackgroundThread::start( ThreadTask &task )
+{
+  if ( m_worker != NULL )
+    return false;
+
+#if defined(CPPUNIT_HAVE_PTHREAD_H)
+  ThreadGroupWorker *worker = new ThreadGroupWorker();
+  worker->m_task = &task;
+  if ( pthread_create( &worker->m_thread, 
+                       NULL, 
+                       cppunitThreadGroupEntry, 
+                       worker ) != 0 )
+  {
+    delete worker;
+    return false;
+  }
+  m_worker = worker;
+  return true;
+#else
+  return false;
+#endif
+}
+
+
+bool 
+BackgroundThread::isRunning() const
+{
+  return m_worker != NULL;
+}
+
+
+void 
+BackgroundThread::join()
+{
+  Exception *exception = NULL;
+  std::string message;
+  if ( joinBackgroundWorker( m_worker, exception, message ) )
+    throwThreadGroupFailure( exception, message );
+}
+
+
+
+ThreadMutex::ThreadMutex()
+    : m_mutex( NULL )
+{
+#if defined(CPPUNIT_HAVE_PTHREAD_H)
+  pthread_mutex_t *mutex = new pthread_mutex_t;
+  pthread_mutex_init( mutex, NULL );
+  m_mutex = mutex;
+#endif
+}
+
+
+ThreadMutex::~ThreadMutex()
+{
+#if defined(CPPUNIT_HAVE_PTHREAD_H)
+  pthread_mutex_t *mutex = CPPUNIT_STATIC_CAST( pthread_mutex_t *, m_mutex );
+  pthread_mutex_destroy( mutex );
+  delete mutex;
+#endif
+}
+
+
+void 
+ThreadMutex::lock()
+{
+#if defined(CPPUNIT_HAVE_PTHREAD_H)
+  pthread_mutex_lock( CPPUNIT_STATIC_CAST( pthread_mutex_t *, m_mutex ) );
+#endif
+}
+
+
+void 
+ThreadMutex::unlock()
+{
+#if defined(CPPUNIT_HAVE_PTHREAD_H)
+  pthread_mutex_unlock( CPPUNIT_STATIC_CAST( pthread_mutex_t *, m_mutex ) );
+#endif
+}
+
+
+
+ThreadBarrier::ThreadBarrier( int threadCount )
+    : m_threadCount( threadCount )
+    , m_waitingCount( 0 )
+    , m_generation( 0 )
+    , m_mutex( NULL )
+    , m_condition( NULL )
+{
+#if defined(CPPUNIT_HAVE_PTHREAD_H)
+  pthread_mutex_t *mutex = new pthread_mutex_t;
+  pthread_mutex_init( mutex, NULL );
+  m_mutex = mutex;
+  pthread_cond_t *condition = new pthread_cond_t;
+  pthread_cond_init( condition, NULL );
+  m_condition = condition;
+#endif
+}
+
+
+ThreadBarrier::~ThreadBarrier()
+{
+#if defined(CPPUNIT_HAVE_PTHREAD_H)
+  pthread_cond_t *condition = CPPUNIT_STATIC_CAST( pthread_cond_t *, m_condition );
+  pthread_cond_destroy( condition );
+  delete condition;
+  pthread_mutex_t *mutex = CPPUNIT_STATIC_CAST( pthread_mutex_t *, m_mutex );
+  pthread_mutex_destroy( mutex );
+  delete mutex;
+#endif
+}
+
+
+bool 
+ThreadBarrier::wait()
+{
+#if defined(CPPUNIT_HAVE_PTHREAD_H)
+  pthread_mutex_t *mutex = CPPUNIT_STATIC_CAST( pthread_mutex_t *, m_mutex );
+  pthread_cond_t *condition = CPPUNIT_STATIC_CAST( pthread_cond_t *, m_condition );
+  pthread_mutex_lock( mutex );
+
+  unsigned long generation = m_generation;
+  if ( ++m_waitingCount >= m_threadCount )
+  {
+    m_waitingCount = 0;
+    ++m_generation;
+    pthread_cond_broadcast( condition );
+    pthread_mutex_unlock( mutex );
+    return true;
+  }
+
+  struct timespec deadline;
+  deadline.tv_sec = time( NULL ) + threadBarrierTimeout;
+  deadline.tv_nsec = 0;
+  bool released = true;
+  while ( generation == m_generation )
+  {
+    if ( pthread_cond_timedwait( condition, mutex, &deadline ) == ETIMEDOUT  &&
+         generation == m_generation )
+    {
+      --m_waitingCount;
+      released = false;
+      break;
+    }
+  }
+
+  pthread_mutex_unlock( mutex );
+  return released;
+#else
+  return true;
+#endif
+}
+
+
+CPPUNIT_NS_END
@@ -0,0 +1,135 @@
+#include <cppunit/Asserter.h>
+#include <cppunit/Message.h>
+#include <cppunit/extensions/UnorderedAssert.h>
+#include <stdio.h>
+
+
+CPPUNIT_NS_BEGIN
+
+
+size_t
+hashBytes( const void *bytes,
+           size_t size )
+{
+  const unsigned char *data = CPPUNIT_STATIC_CAST( const unsigned char *, bytes );
+  size_t hash = size_t(2166136261U);
+  for ( size_t index = 0; index < size; ++index )
+  {
+    hash ^= data[ index ];
+    hash *= size_t(16777619U);
+  }
+  return hash;
+}
+
+
+UnorderedDifferences::UnorderedDifferences( int maximumShownCount )
+    : m_maximumShownCount( maximumShownCount )
+    , m_missingCount( 0 )
+    , m_unexpectedCount( 0 )
+    , m_shownMissingCount( 0 )
+    , m_shownUnexpectedCount( 0 )
+{
+}
+
+
+UnorderedDifferences::~UnorderedDifferences()
+{
+}
+
+
+bool
+UnorderedDifferences::showsMoreMissing() const
+{
+  return int(m_missing.size()) < m_maximumShownCount;
+}
+
+
+bool
+UnorderedDifferences::showsMoreUnexpected() const
+{
+  return int(m_unexpected.size()) < m_maximumShownCount;
+}
+
+
+void
+UnorderedDifferences::addMissing( int count,
+                                  const std::string &element )
+{
+  m_missingCount += count;
+  if ( showsMoreMissing() )
+  {
+    m_missing.push_back( element );
+    m_shownMissingCount += count;
+  }
+}
+
+
+void
+UnorderedDifferences::addUnexpected( int count,
+                                     const std::string &element )
+{
+  m_unexpectedCount += count;
+  if ( showsMoreUnexpected() )
+  {
+    m_unexpected.push_back( element );
+    m_shownUnexpectedCount += count;
+  }
+}
+
+
+bool
+UnorderedDifferences::isEmpty() const
+{
+  return m_missingCount == 0  &&  m_unexpectedCount == 0;
+}
+
+
+void
+UnorderedDifferences::failIfAny( int expectedCount,
+                                 int actualCount,
+                                 const SourceLine &sourceLine,
+                                 const std::string &message ) const
+{
+  if ( isEmpty() )
+    return;
+
+  char counts[ 64 ];
+  sprintf( counts, "%d elements", expectedCount );
+  Message failure( "unordered equality assertion failed",
+                   Asserter::makeExpected( counts ) );
+  sprintf( counts, "%d elements", actualCount );
+  failure.addDetail( Asserter::makeActual( counts ) );
+  if ( m_missingCount > 0 )
+    failure.addDetail( makeDetail( "Missing", m_missingCount, 
+                                   m_shownMissingCount, m_missing ) );
+  if ( m_unexpectedCount > 0 )
+    failure.addDetail( makeDetail( "Unexpected", m_unexpectedCount,
+                                   m_shownUnexpectedCount, m_unexpected ) );
+  if ( !message.empty() )
+    failure.addDetail( message );
+  Asserter::fail( failure, sourceLine );
+}
+
+
+std::string
+UnorderedDifferences::makeDetail( const std::string &label,
+                                  int count,
+                                  int shownCount,
+                                  const CppUnitVector<std::string> &elements ) const
+{
+  char countText[ 32 ];
+  sprintf( countText, " (%d): ", count );
+  std::string detail( label + countText );
+  for ( unsigned int index = 0; index < elements.size(); ++index )
+  {
+    if ( index > 0 )
+      detail += ", ";
+    detail += elements[ index ];
+  }
+  if ( shownCount < count )
+    detail += ", ...";
+  return detail;
+}
+
+
+CPPUNIT_NS_END
@@ -1,9 +1,11 @@
+#include <cppunit/CallbackProfile.h>
 #include <cppunit/Exception.h>
 #include <cppunit/Test.h>
 #include <cppunit/TestFailure.h>
 #include <cppunit/TestResultCollector.h>
 #include <cppunit/XmlOutputter.h>
 #include <cppunit/XmlOutputterHook.h>
+#include <cppunit/tools/Clock.h>
 #include <cppunit/tools/XmlDocument.h>
 #include <cppunit/tools/XmlElement.h>
 #include <stdlib.h>
@@ -13,12 +15,41 @@
 CPPUNIT_NS_BEGIN
 
 
+/// Times a hook call into the profile, if there is one.
+class HookTimer
+{
+public:
+  HookTimer( CallbackProfile *profile,
+             XmlOutputterHook *hook,
+             const char *event )
+      : m_profile( profile )
+      , m_hook( hook )
+      , m_event( event )
+      , m_startTime( profile != NULL ? Clock::now() : 0 )
+  {
+  }
+
+  ~HookTimer()
+  {
+    if ( m_profile != NULL )
+      m_profile->addHookTime( m_hook, m_event, Clock::now() - m_startTime );
+  }
+
+private:
+  CallbackProfile *m_profile;
+  XmlOutputterHook *m_hook;
+  const char *m_event;
+  double m_startTime;
+};
+
+
 XmlOutputter::XmlOutputter( TestResultCollector *result,
                             OStream &stream,
                             std::string encoding )
   : m_result( result )
   , m_stream( stream )
   , m_xml( new XmlDocument( encoding ) )
+  , m_profile( NULL )
 {
 }
 
@@ -65,6 +96,13 @@ XmlOutputter::setStandalone( bool standalone )
 }
  
 
+void
+XmlOutputter::setProfile( CallbackProfile *profile )
+{
+  m_profile = profile;
+}
+
+
 void
 XmlOutputter::setRootNode()
 {
@@ -72,7 +110,10 @@ XmlOutputter::setRootNode()
   m_xml->setRootElement( rootNode );
 
   for ( Hooks::iterator it = m_hooks.begin(); it != m_hooks.end(); ++it )
+  {
+    HookTimer timer( m_profile, *it, "beginDocument" );
     (*it)->beginDocument( m_xml );
+  }
 
   FailedTests failedTests;
   fillFailedTestsMap( failedTests );
@@ -82,7 +123,10 @@ XmlOutputter::setRootNode()
   addStatistics( rootNode );
 
   for ( Hooks::iterator itEnd = m_hooks.begin(); itEnd != m_hooks.end(); ++itEnd )
+  {
+    HookTimer timer( m_profile, *itEnd, "endDocument" );
     (*itEnd)->endDocument( m_xml );
+  }
 }
 
 
@@ -145,7 +189,10 @@ XmlOutputter::addStatistics( XmlElement *rootNode )
   statisticsElement->addElement( new XmlElement( "Failures", m_result->testFailures() ) );
 
   for ( Hooks::iterator it = m_hooks.begin(); it != m_hooks.end(); ++it )
+  {
+    HookTimer timer( m_profile, *it, "statisticsAdded" );
     (*it)->statisticsAdded( m_xml, statisticsElement );
+  }
 }
 
 
@@ -171,7 +218,10 @@ XmlOutputter::addFailedTest( Test *test,
   testElement->addElement( new XmlElement( "Message", thrownException->what() ) );
 
   for ( Hooks::iterator it = m_hooks.begin(); it != m_hooks.end(); ++it )
+  {
+    HookTimer timer( m_profile, *it, "failTestAdded" );
     (*it)->failTestAdded( m_xml, testElement, test, failure );
+  }
 }
 
 
@@ -198,7 +248,10 @@ XmlOutputter::addSuccessfulTest( Test *test,
   testElement->addElement( new XmlElement( "Name", test->getName() ) );
 
   for ( Hooks::iterator it = m_hooks.begin(); it != m_hooks.end(); ++it )
+  {
+    HookTimer timer( m_profile, *it, "successfulTestAdded" );
     (*it)->successfulTestAdded( m_xml, testElement, test );
+  }
 }
 
 